@@ -0,0 +1,149 @@
+#include "AcquisitionCycle.h"
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+
+#include <algorithm>
+
+#include "DebugConfig.h"
+#include "ModbusPollPlan.h"  // PollPlanRegistry::MAX_SLOTS
+#include "ServerConfig.h"
+
+AcquisitionCycle* AcquisitionCycle::instance = nullptr;
+
+AcquisitionCycle::AcquisitionCycle()
+    : slots(nullptr),
+      periodMs(AcquisitionConfig::DEFAULT_CYCLE_S * 1000),
+      deadlineMs(0),
+      lastTaken(0),
+      completeCycles(0),
+      deadlineCycles(0),
+      lastCompleteMs(0) {}
+
+AcquisitionCycle* AcquisitionCycle::getInstance() {
+  if (!instance) {
+    instance = new AcquisitionCycle();
+  }
+  return instance;
+}
+
+bool AcquisitionCycle::init(ServerConfig* serverConfig) {
+  if (slots) return true;
+
+  JsonDocument doc;
+  JsonObject settings = doc.to<JsonObject>();
+  if (!serverConfig || !serverConfig->getAcquisitionConfig(settings) ||
+      strcmp(settings["mode"] | "free", "aligned") != 0) {
+    LOG_DATA_INFO("[CYCLE] Free-running acquisition (per-device refresh)\n");
+    return false;
+  }
+
+  // Ranges checked by ServerConfig validation
+  uint32_t cycleS = settings["cycle"] | AcquisitionConfig::DEFAULT_CYCLE_S;
+  cycleS = std::max<uint32_t>(
+      1, std::min(cycleS, AcquisitionConfig::MAX_CYCLE_S));
+  uint32_t deadlinePercent =
+      settings["deadline"] | AcquisitionConfig::DEFAULT_DEADLINE_PERCENT;
+  deadlinePercent = std::max<uint32_t>(
+      AcquisitionConfig::MIN_DEADLINE_PERCENT,
+      std::min<uint32_t>(deadlinePercent, 100));
+  periodMs = cycleS * 1000;
+  deadlineMs = periodMs / 100 * deadlinePercent;
+
+  slots = (SlotCycles*)heap_caps_calloc(PollPlanRegistry::MAX_SLOTS,
+                                        sizeof(SlotCycles),
+                                        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!slots) {
+    slots = (SlotCycles*)heap_caps_calloc(
+        PollPlanRegistry::MAX_SLOTS, sizeof(SlotCycles), MALLOC_CAP_8BIT);
+  }
+  if (!slots) {
+    LOG_DATA_ERROR("[CYCLE] Failed to allocate cycle tracking\n");
+    return false;
+  }
+
+  LOG_DATA_INFO("[CYCLE] Aligned acquisition: %lu s cycles, deadline %lu%%\n",
+                (unsigned long)cycleS, (unsigned long)deadlinePercent);
+  return true;
+}
+
+int64_t AcquisitionCycle::wallMs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec > 1600000000) {
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  }
+  return esp_timer_get_time() / 1000;
+}
+
+uint32_t AcquisitionCycle::align(uint8_t slot, uint32_t dueMs,
+                                 uint32_t nowMs) {
+  if (!slots) return dueMs;
+
+  // Wall time of dueMs (overdue = now). A due time just past a boundary
+  // (millis() and the wall clock drift apart by a few ms per cycle) stays
+  // on that boundary.
+  int64_t wall = wallMs();
+  int32_t ahead = std::max<int32_t>(0, (int32_t)(dueMs - nowMs));
+  int64_t target = wall + ahead - AcquisitionConfig::ALIGN_SLACK_MS;
+  if (target < 0) target = 0;
+  uint32_t cycle = (uint32_t)((target + periodMs - 1) / periodMs);
+  int64_t boundary = (int64_t)cycle * periodMs;
+
+  if (slot < PollPlanRegistry::MAX_SLOTS) {
+    slots[slot].expected.store(cycle);
+  }
+  return nowMs + (uint32_t)(int32_t)(boundary - wall);
+}
+
+void AcquisitionCycle::complete(uint8_t slot) {
+  if (!slots || slot >= PollPlanRegistry::MAX_SLOTS) return;
+  slots[slot].completed.store(slots[slot].expected.load());
+}
+
+bool AcquisitionCycle::pending(uint32_t cycle) const {
+  for (uint8_t i = 0; i < PollPlanRegistry::MAX_SLOTS; i++) {
+    uint32_t expected = slots[i].expected.load();
+    // Expected in this cycle, or still reading the previous one
+    if ((expected == cycle || expected + 1 == cycle) &&
+        slots[i].completed.load() != expected) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AcquisitionCycle::takeReady(uint32_t& cycleId) {
+  if (!slots) return false;
+
+  int64_t wall = wallMs();
+  uint32_t current = (uint32_t)(wall / periodMs);
+  if (current == lastTaken) return false;
+  if (current < lastTaken) {
+    lastTaken = current;  // Clock set back: continue from here
+    return false;
+  }
+
+  uint32_t sinceBoundary = (uint32_t)(wall - (int64_t)current * periodMs);
+  if (sinceBoundary < deadlineMs) {
+    if (pending(current)) return false;
+    completeCycles++;
+    lastCompleteMs = sinceBoundary;
+  } else {
+    deadlineCycles++;  // Published with the devices done so far
+  }
+  lastTaken = current;
+  cycleId = current;
+  return true;
+}
+
+void AcquisitionCycle::getStatus(JsonObject& status) const {
+  status["mode"] = aligned() ? "aligned" : "free";
+  if (!aligned()) return;
+  status["cycle_s"] = periodMs / 1000;
+  status["deadline_ms"] = deadlineMs;
+  status["cycles_complete"] = completeCycles;
+  status["cycles_deadline"] = deadlineCycles;
+  status["last_complete_ms"] = lastCompleteMs;
+}
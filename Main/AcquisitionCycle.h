@@ -0,0 +1,105 @@
+#ifndef ACQUISITION_CYCLE_H
+#define ACQUISITION_CYCLE_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <atomic>
+#include <cstdint>
+
+class ServerConfig;
+
+/**
+ * AcquisitionCycle - Wall-clock aligned snapshot cycles ("acquisition")
+ *
+ * v1.3.3: "acquisition.mode": "aligned"
+ * Previous: every device was polled when its own lastRead + refresh_rate_ms
+ * elapsed, so one MQTT publish held values sampled seconds apart, and the
+ * publisher could only guess when the devices of a "batch" were done.
+ * New: deadlines snap to cycle boundaries on the wall clock (every
+ * "acquisition.cycle" seconds, on the second when the RTC is set; uptime
+ * otherwise). All devices of a cycle start together, each bus polls its
+ * devices fastest-first (PollSlot::rank), and the default-mode publish of
+ * cycle n goes out, tagged "cycle_id", as soon as every device expected in
+ * it has finished its read - or "acquisition.deadline" % of the cycle after
+ * the boundary at the latest.
+ *
+ * Refresh intervals are rounded up to whole cycles (a 25 s device in 10 s
+ * cycles is read every third cycle). Retry backoffs end on a boundary.
+ *
+ * Tracking: one expected / completed cycle id per PollPlanRegistry slot
+ * (plain 32-bit atomics, written by the slot's polling task). A cycle is
+ * pending while a slot expects it, or is still reading the previous one.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace AcquisitionConfig {
+constexpr uint32_t DEFAULT_CYCLE_S = 10;
+constexpr uint32_t MAX_CYCLE_S = 3600;
+constexpr uint8_t DEFAULT_DEADLINE_PERCENT = 80;
+constexpr uint8_t MIN_DEADLINE_PERCENT = 10;
+constexpr uint32_t ALIGN_SLACK_MS = 250;  // Late due time kept on a boundary
+}  // namespace AcquisitionConfig
+
+class AcquisitionCycle {
+ public:
+  static AcquisitionCycle* getInstance();
+
+  AcquisitionCycle(const AcquisitionCycle&) = delete;
+  AcquisitionCycle& operator=(const AcquisitionCycle&) = delete;
+
+  /**
+   * Read "acquisition" from the server config
+   * @return true if aligned mode is active
+   */
+  bool init(ServerConfig* serverConfig);
+  bool aligned() const { return slots != nullptr; }
+  uint32_t cycleMs() const { return periodMs; }
+
+  /**
+   * Polling tasks: first boundary at or after dueMs (millis() deadline).
+   * The device in registry slot is expected in that cycle.
+   */
+  uint32_t align(uint8_t slot, uint32_t dueMs, uint32_t nowMs);
+
+  /**
+   * Polling tasks: the slot's read for its expected cycle has finished
+   * (success or failure)
+   */
+  void complete(uint8_t slot);
+
+  /**
+   * Publisher: the newest cycle whose devices all completed (or whose
+   * deadline passed), once per cycle
+   * @param cycleId Boundary time / cycle length
+   */
+  bool takeReady(uint32_t& cycleId);
+
+  void getStatus(JsonObject& status) const;
+
+ private:
+  struct SlotCycles {
+    std::atomic<uint32_t> expected;
+    std::atomic<uint32_t> completed;
+  };
+
+  static AcquisitionCycle* instance;
+
+  SlotCycles* slots;  // PollPlanRegistry::MAX_SLOTS (PSRAM, aligned only)
+  uint32_t periodMs;
+  uint32_t deadlineMs;
+  uint32_t lastTaken;  // Publisher only
+  uint32_t completeCycles;
+  uint32_t deadlineCycles;
+  uint32_t lastCompleteMs;  // Boundary -> all devices done, last cycle
+
+  AcquisitionCycle();
+
+  static int64_t wallMs();  // Unix ms when the clock is set, else uptime ms
+  bool pending(uint32_t cycle) const;
+};
+
+#endif  // ACQUISITION_CYCLE_H
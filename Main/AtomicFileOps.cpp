@@ -5,9 +5,66 @@
 
 #include "AtomicFileOps.h"
 
+#include <esp_rom_crc.h>  // v1.3.3: ROM CRC32
+
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
 
 const char* AtomicFileOps::WAL_FILE = "/.wal";
+const char* AtomicFileOps::TEMP_SUFFIX = ".wtmp";
+const char* AtomicFileOps::GROUP_TEMP_SUFFIX = ".gtmp";
+
+namespace {
+
+// v1.3.3: Print adapter for serializeJson(): buffers the output, CRC32s it
+// with the ROM routine and writes it to the file in chunks (ArduinoJson
+// emits mostly single characters)
+class Crc32FileWriter : public Print {
+ public:
+  explicit Crc32FileWriter(File& file) : file(file) {}
+
+  size_t write(uint8_t c) override {
+    buffer[used++] = c;
+    if (used == sizeof(buffer)) {
+      flushBuffer();
+    }
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t length) override {
+    for (size_t i = 0; i < length; i++) {
+      write(data[i]);
+    }
+    return length;
+  }
+
+  bool finish() {
+    flushBuffer();
+    return ok;
+  }
+
+  uint32_t crc = 0;
+  uint32_t size = 0;
+
+ private:
+  void flushBuffer() {
+    if (used == 0) {
+      return;
+    }
+    crc = esp_rom_crc32_le(crc, buffer, used);
+    if (file.write(buffer, used) != used) {
+      ok = false;
+    }
+    size += used;
+    used = 0;
+  }
+
+  File& file;
+  uint8_t buffer[256];
+  size_t used = 0;
+  bool ok = true;
+};
+
+}  // namespace
 
 AtomicFileOps::AtomicFileOps() : walMutex(nullptr), recoveryAttempted(false) {
   // Create mutex for WAL synchronization
@@ -39,107 +96,101 @@ bool AtomicFileOps::begin() {
   return true;
 }
 
-String AtomicFileOps::calculateChecksum(const JsonDocument& doc) {
-  // FIXED BUG A: Streaming checksum without loading entire JSON to String
-  // Prevents OOM for large documents (20-50KB full_config backups)
-  size_t docSize = measureJson(doc);
-
-  // Safety limit: Skip checksum for very large documents to avoid performance
-  // hit
-  if (docSize > 10240) {
-    LOG_CONFIG_INFO(
-        "[ATOMIC] WARNING: Skipping checksum for large doc (%zu bytes)\n",
-        docSize);
-    return "SKIPPED_LARGE";
-  }
-
-  // Streaming checksum calculator (zero heap allocation)
-  class ChecksumPrint : public Print {
-   public:
-    uint32_t checksum = 0;
-    size_t write(uint8_t c) override {
-      // Simple rotating XOR checksum
-      checksum = ((checksum << 1) ^ c) & 0xFFFFFFFF;
-      return 1;
-    }
-  };
-
-  ChecksumPrint checksumCalc;
-  serializeJson(doc, checksumCalc);
-
-  return String(checksumCalc.checksum, HEX);
-}
-
-String AtomicFileOps::calculateFileChecksum(const String& filename) {
+bool AtomicFileOps::calculateFileCrc(const String& filename, uint32_t& size,
+                                     uint32_t& crc) {
   File file = LittleFS.open(filename, "r");
   if (!file) {
-    return "";
+    return false;
   }
 
-  uint32_t checksum = 0;
-  const size_t CHUNK_SIZE = 512;
-  char buffer[CHUNK_SIZE];
-
+  uint8_t buffer[512];
+  size = 0;
+  crc = 0;
   while (file.available()) {
-    size_t bytesRead = file.read((uint8_t*)buffer, CHUNK_SIZE);
-    for (size_t i = 0; i < bytesRead; i++) {
-      checksum = ((checksum << 1) ^ buffer[i]) & 0xFFFFFFFF;
+    size_t bytesRead = file.read(buffer, sizeof(buffer));
+    if (bytesRead == 0) {
+      break;
     }
+    crc = esp_rom_crc32_le(crc, buffer, bytesRead);
+    size += bytesRead;
   }
 
   file.close();
-  return String(checksum, HEX);
+  return true;
 }
 
-bool AtomicFileOps::verifyFileIntegrity(const String& filename) {
-  // Check if file exists and is readable
-  if (!LittleFS.exists(filename)) {
+bool AtomicFileOps::verifyFileIntegrity(const String& filename, uint32_t size,
+                                        uint32_t crc) {
+  // v1.3.3: Size and CRC32 must match what was written (was: non-empty)
+  uint32_t fileSize = 0;
+  uint32_t fileCrc = 0;
+  if (!calculateFileCrc(filename, fileSize, fileCrc)) {
     return false;
   }
 
-  File file = LittleFS.open(filename, "r");
-  if (!file) {
+  if (fileSize == 0 || fileSize != size || fileCrc != crc) {
+    LOG_CONFIG_INFO(
+        "[ATOMIC] File %s failed verification (%u/%u bytes, CRC %08X/%08X)\n",
+        filename.c_str(), fileSize, size, fileCrc, crc);
     return false;
   }
 
-  // Verify file is not empty
-  size_t fileSize = file.size();
-  file.close();
+  return true;
+}
 
-  if (fileSize == 0) {
-    LOG_CONFIG_INFO("[ATOMIC] File %s is empty (possibly corrupted)\n",
-                    filename.c_str());
+bool AtomicFileOps::writeTempFile(WALEntry& entry, const JsonDocument& doc) {
+  File tmpFile = LittleFS.open(entry.tempFile, "w");
+  if (!tmpFile) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot open temp file %s\n",
+                    entry.tempFile.c_str());
     return false;
   }
 
-  return true;
-}
+  // Serialize JSON to file (CRC32 computed on the way, any size)
+  Crc32FileWriter writer(tmpFile);
+  serializeJson(doc, writer);
+  bool written = writer.finish();
+  tmpFile.flush();
+  tmpFile.close();
 
-void AtomicFileOps::appendToWAL(const WALEntry& entry) {
-  if (xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: WAL mutex timeout");
-    return;
+  entry.crc = writer.crc;
+  entry.size = writer.size;
+
+  if (!written || entry.size == 0) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: Temp file write failed (%u bytes)\n",
+                    entry.size);
+    LittleFS.remove(entry.tempFile);
+    return false;
   }
 
-  walLog.push_back(entry);
+  // Read back: the flash must hold exactly what was serialized
+  if (!verifyFileIntegrity(entry.tempFile, entry.size, entry.crc)) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: Temp file integrity check failed\n");
+    LittleFS.remove(entry.tempFile);
+    return false;
+  }
 
-  xSemaphoreGive(walMutex);
+  return true;
 }
 
-void AtomicFileOps::markWALEntryCompleted(const String& filename) {
-  if (xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-    return;
+bool AtomicFileOps::replaceTarget(const WALEntry& entry) {
+  // Remove old file if exists (on LittleFS, rename doesn't auto-replace)
+  if (LittleFS.exists(entry.targetFile)) {
+    if (!LittleFS.remove(entry.targetFile)) {
+      LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot remove old file %s\n",
+                      entry.targetFile.c_str());
+      return false;
+    }
   }
 
-  for (auto& entry : walLog) {
-    if (entry.targetFile == filename) {
-      entry.completed = true;
-
-      break;
-    }
+  // Perform atomic rename
+  if (!LittleFS.rename(entry.tempFile, entry.targetFile)) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: Atomic rename failed for %s\n",
+                    entry.targetFile.c_str());
+    return false;
   }
 
-  xSemaphoreGive(walMutex);
+  return true;
 }
 
 void AtomicFileOps::clearWAL() {
@@ -148,6 +199,7 @@ void AtomicFileOps::clearWAL() {
   }
 
   walLog.clear();
+  groupOwner = nullptr;
   LOG_CONFIG_INFO("[ATOMIC] WAL cleared");
 
   xSemaphoreGive(walMutex);
@@ -160,82 +212,51 @@ bool AtomicFileOps::writeAtomic(const String& filename,
     return false;
   }
 
-  // Step 1: Create WAL entry
+  // v1.3.3: Writes of the task that opened a group are only staged
+  bool grouped = groupOwner && groupOwner == xTaskGetCurrentTaskHandle();
+
+  // Step 1: Describe the operation
   WALEntry entry;
   entry.operation = "write";
   entry.targetFile = filename;
-  entry.tempFile = filename + ".tmp";
+  entry.tempFile = filename + (grouped ? GROUP_TEMP_SUFFIX : TEMP_SUFFIX);
   entry.timestamp = millis();
-  entry.checksum = calculateChecksum(doc);
-  entry.completed = false;
-
-  // Step 2: Add to WAL (before any file operations!)
-  appendToWAL(entry);
-
-  // Step 3: Write to temporary file
-  size_t tmpSize = 0;
-  {
-    File tmpFile = LittleFS.open(entry.tempFile, "w");
-    if (!tmpFile) {
-      LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot open temp file %s\n",
-                      entry.tempFile.c_str());
-      return false;
-    }
-
-    // Serialize JSON to file
-    serializeJson(doc, tmpFile);
-    tmpFile.flush();
 
-    // Verify temp file was written
-    tmpSize = tmpFile.size();
-    tmpFile.close();
+  // Step 2: Write and verify the temporary file
+  if (!writeTempFile(entry, doc)) {
+    return false;
+  }
 
-    if (tmpSize == 0) {
-      LOG_CONFIG_INFO("[ATOMIC] ERROR: Temp file write failed (size=0)\n");
+  // Step 3 (group): Stage until commitGroup()
+  if (grouped) {
+    if (xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
       LittleFS.remove(entry.tempFile);
       return false;
     }
-  }
-
-  // Step 4: Verify temp file integrity
-  if (!verifyFileIntegrity(entry.tempFile)) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: Temp file integrity check failed\n");
-    LittleFS.remove(entry.tempFile);
-    return false;
-  }
-
-  // Step 5: Atomic rename (this is the critical operation)
-  // LittleFS.rename() is atomic on LittleFS
-  {
-    // Remove old file if exists (on LittleFS, rename doesn't auto-replace)
-    if (LittleFS.exists(filename)) {
-      if (!LittleFS.remove(filename)) {
-        LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot remove old file %s\n",
-                        filename.c_str());
-        LittleFS.remove(entry.tempFile);
-        return false;
+    bool replaced = false;
+    for (WALEntry& staged : walLog) {
+      if (staged.targetFile == filename) {
+        staged = entry;  // Same temp file, newer content
+        replaced = true;
+        break;
       }
     }
-
-    // Perform atomic rename
-    if (!LittleFS.rename(entry.tempFile, filename)) {
-      LOG_CONFIG_INFO("[ATOMIC] ERROR: Atomic rename failed\n");
-      LittleFS.remove(entry.tempFile);
-      return false;
+    if (!replaced) {
+      walLog.push_back(entry);
     }
+    xSemaphoreGive(walMutex);
+    return true;
   }
 
-  // Step 6: Verify final file
-  if (!verifyFileIntegrity(filename)) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: Final file verification failed\n");
+  // Step 3: Atomic rename (this is the critical operation)
+  // LittleFS.rename() is atomic on LittleFS
+  if (!replaceTarget(entry)) {
+    LittleFS.remove(entry.tempFile);
     return false;
   }
 
-  // Step 7: Mark WAL entry as completed
-  markWALEntryCompleted(filename);
-
-  LOG_CONFIG_INFO("[ATOMIC] Write completed: %s (%d bytes)\n", filename.c_str(),
-                  tmpSize);
+  LOG_CONFIG_INFO("[ATOMIC] Write completed: %s (%u bytes, CRC %08X)\n",
+                  filename.c_str(), entry.size, entry.crc);
   return true;
 }
 
@@ -260,89 +281,264 @@ bool AtomicFileOps::deleteAtomic(const String& filename) {
   return true;
 }
 
-uint8_t AtomicFileOps::recover() {
-  if (!walMutex) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: WAL mutex not initialized");
-    return 0;
+// ============================================================================
+// v1.3.3: GROUP COMMIT
+// ============================================================================
+
+bool AtomicFileOps::beginGroup() {
+  if (!walMutex || xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    return false;
   }
 
-  if (recoveryAttempted) {
-    LOG_CONFIG_INFO("[ATOMIC] Recovery already attempted");
-    return 0;
+  bool opened = groupOwner == nullptr;
+  if (opened) {
+    groupOwner = xTaskGetCurrentTaskHandle();
+    walLog.clear();
   }
+  xSemaphoreGive(walMutex);
 
-  LOG_CONFIG_INFO("[ATOMIC] Starting recovery from incomplete operations...");
+  if (!opened) {
+    LOG_CONFIG_INFO("[ATOMIC] WARNING: Group already open - writes not grouped");
+  }
+  return opened;
+}
 
-  uint8_t recovered = 0;
+bool AtomicFileOps::commitGroup() {
+  if (!walMutex || xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    abortGroup();
+    return false;
+  }
+  if (groupOwner != xTaskGetCurrentTaskHandle()) {
+    xSemaphoreGive(walMutex);
+    return false;
+  }
+  std::vector<WALEntry> entries;
+  entries.swap(walLog);
+  groupOwner = nullptr;
+  xSemaphoreGive(walMutex);
+
+  if (entries.empty()) {
+    return true;
+  }
+
+  // Single flush point: once the WAL record is on flash the group is
+  // committed and recover() rolls it forward after a power loss
+  if (!writeWALRecord(entries)) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: WAL record write failed - group dropped");
+    for (const WALEntry& entry : entries) {
+      LittleFS.remove(entry.tempFile);
+    }
+    return false;
+  }
+
+  bool success = true;
+  for (const WALEntry& entry : entries) {
+    success = replaceTarget(entry) && success;
+  }
+  if (success) {
+    LittleFS.remove(WAL_FILE);  // Keep it for recover() otherwise
+  }
+
+  LOG_CONFIG_INFO("[ATOMIC] Group committed: %u file(s)%s\n", entries.size(),
+                  success ? "" : " - rename failed, retried at boot");
+  return success;
+}
+
+void AtomicFileOps::abortGroup() {
+  std::vector<WALEntry> entries;
+  if (walMutex && xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+    if (groupOwner == xTaskGetCurrentTaskHandle()) {
+      entries.swap(walLog);
+      groupOwner = nullptr;
+    }
+    xSemaphoreGive(walMutex);
+  }
+
+  for (const WALEntry& entry : entries) {
+    LittleFS.remove(entry.tempFile);
+  }
+}
+
+bool AtomicFileOps::writeWALRecord(const std::vector<WALEntry>& entries) {
+  // Body: per entry [path length:u8][path][size:u32][crc:u32]
+  std::vector<uint8_t> body;
+  for (const WALEntry& entry : entries) {
+    size_t pathLength = entry.targetFile.length();
+    if (pathLength == 0 || pathLength > 255) {
+      return false;
+    }
+    body.push_back((uint8_t)pathLength);
+    body.insert(body.end(), entry.targetFile.c_str(),
+                entry.targetFile.c_str() + pathLength);
+    body.insert(body.end(), (const uint8_t*)&entry.size,
+                (const uint8_t*)&entry.size + sizeof(entry.size));
+    body.insert(body.end(), (const uint8_t*)&entry.crc,
+                (const uint8_t*)&entry.crc + sizeof(entry.crc));
+  }
+
+  WALRecordHeader header = {};
+  header.magic = WAL_MAGIC;
+  header.count = entries.size();
+  header.bodySize = body.size();
+  header.bodyCrc = esp_rom_crc32_le(0, body.data(), body.size());
+
+  // A torn record fails the body CRC and is treated as never committed
+  File file = LittleFS.open(WAL_FILE, "w");
+  if (!file) {
+    return false;
+  }
+  bool success =
+      file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+      file.write(body.data(), body.size()) == body.size();
+  file.flush();
+  file.close();
+  return success;
+}
+
+bool AtomicFileOps::readWALRecord(std::vector<WALEntry>& entries) {
+  File file = LittleFS.open(WAL_FILE, "r");
+  if (!file) {
+    return false;
+  }
+
+  WALRecordHeader header = {};
+  std::vector<uint8_t> body;
+  bool valid =
+      file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+      header.magic == WAL_MAGIC &&
+      file.size() == sizeof(header) + header.bodySize;
+  if (valid) {
+    body.resize(header.bodySize);
+    valid = file.read(body.data(), body.size()) == body.size() &&
+            esp_rom_crc32_le(0, body.data(), body.size()) == header.bodyCrc;
+  }
+  file.close();
+
+  size_t pos = 0;
+  for (uint16_t i = 0; valid && i < header.count; i++) {
+    size_t pathLength = pos < body.size() ? body[pos++] : 0;
+    if (pathLength == 0 || pos + pathLength + 8 > body.size()) {
+      valid = false;
+      break;
+    }
+
+    char path[256];
+    memcpy(path, &body[pos], pathLength);
+    path[pathLength] = '\0';
+
+    WALEntry entry;
+    entry.operation = "write";
+    entry.targetFile = path;
+    entry.tempFile = entry.targetFile + GROUP_TEMP_SUFFIX;
+    pos += pathLength;
+    memcpy(&entry.size, &body[pos], sizeof(entry.size));
+    memcpy(&entry.crc, &body[pos + 4], sizeof(entry.crc));
+    pos += 8;
+    entries.push_back(entry);
+  }
 
-  // Check for orphaned temp files (from interrupted writes)
-  // These are files with .tmp extension
-  // Using proper LittleFS API for directory listing
-  File root = LittleFS.open("/");
+  if (!valid) {
+    entries.clear();
+  }
+  return valid;
+}
+
+uint8_t AtomicFileOps::cleanupTempFiles(const String& dir, bool topLevel) {
+  File root = LittleFS.open(dir);
   if (!root) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot open root directory");
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot open directory %s\n", dir.c_str());
     return 0;
   }
 
+  String prefix = dir.endsWith("/") ? dir : dir + "/";
+  std::vector<String> subdirs;
+  uint8_t recovered = 0;
+
   // Use file iteration compatible with LittleFS
   File file = root.openNextFile();
   while (file) {
-    String fileName = file.name();
-
-    if (fileName.endsWith(".tmp")) {
-      LOG_CONFIG_INFO("[ATOMIC] Found orphaned temp file: %s\n",
-                      fileName.c_str());
-
-      file.close();
-
-      // Remove the orphaned temp file
-      if (LittleFS.remove(String("/") + fileName)) {
-        LOG_CONFIG_INFO("[ATOMIC] Cleaned up temp file: %s\n",
-                        fileName.c_str());
+    String path = prefix + file.name();
+    bool isDirectory = file.isDirectory();
+    file.close();
+
+    if (isDirectory) {
+      subdirs.push_back(path);
+    } else if (path.endsWith(GROUP_TEMP_SUFFIX) ||
+               (topLevel && path.endsWith(".tmp"))) {
+      // Staged group write without committed WAL record / legacy temp file
+      LOG_CONFIG_INFO("[ATOMIC] Found orphaned temp file: %s\n", path.c_str());
+      if (LittleFS.remove(path)) {
         recovered++;
+      }
+    } else if (path.endsWith(TEMP_SUFFIX)) {
+      // Single write: a complete temp file is only left behind without its
+      // target when power was lost between remove and rename
+      String target = path.substring(0, path.length() - strlen(TEMP_SUFFIX));
+      if (!LittleFS.exists(target) && LittleFS.rename(path, target)) {
+        LOG_CONFIG_INFO("[ATOMIC] Completed interrupted rename: %s\n",
+                        target.c_str());
       } else {
-        LOG_CONFIG_INFO("[ATOMIC] Failed to clean up temp file: %s\n",
-                        fileName.c_str());
+        LittleFS.remove(path);
       }
-    } else {
-      file.close();
+      recovered++;
     }
 
     file = root.openNextFile();
   }
   root.close();
 
-  // Check WAL for incomplete operations
-  if (xSemaphoreTake(walMutex, pdMS_TO_TICKS(2000)) == pdTRUE) {
-    for (const auto& entry : walLog) {
-      if (!entry.completed) {
-        LOG_CONFIG_INFO("[ATOMIC] Found incomplete WAL entry: %s on %s\n",
-                        entry.operation.c_str(), entry.targetFile.c_str());
-
-        if (entry.operation == "write") {
-          // If temp file still exists, it means rename was interrupted
-          if (LittleFS.exists(entry.tempFile)) {
-            LOG_CONFIG_INFO("[ATOMIC] Retrying rename: %s to %s\n",
-                            entry.tempFile.c_str(), entry.targetFile.c_str());
-
-            if (LittleFS.exists(entry.targetFile)) {
-              LittleFS.remove(entry.targetFile);
-            }
-
-            if (LittleFS.rename(entry.tempFile, entry.targetFile)) {
-              LOG_CONFIG_INFO("[ATOMIC] Completed interrupted rename\n");
-              recovered++;
-            } else {
-              LOG_CONFIG_INFO("[ATOMIC] Failed to complete rename\n");
-            }
-          }
+  if (topLevel) {
+    for (const String& subdir : subdirs) {
+      recovered += cleanupTempFiles(subdir, false);  // One level deep
+    }
+  }
+  return recovered;
+}
+
+uint8_t AtomicFileOps::recover() {
+  if (!walMutex) {
+    LOG_CONFIG_INFO("[ATOMIC] ERROR: WAL mutex not initialized");
+    return 0;
+  }
+
+  if (recoveryAttempted) {
+    LOG_CONFIG_INFO("[ATOMIC] Recovery already attempted");
+    return 0;
+  }
+
+  LOG_CONFIG_INFO("[ATOMIC] Starting recovery from incomplete operations...");
+
+  uint8_t recovered = 0;
+
+  // v1.3.3: Roll a committed group forward (its temp files are complete and
+  // CRC-checked; a missing temp file was already renamed)
+  if (LittleFS.exists(WAL_FILE)) {
+    std::vector<WALEntry> entries;
+    if (readWALRecord(entries)) {
+      for (const WALEntry& entry : entries) {
+        if (!LittleFS.exists(entry.tempFile)) {
+          continue;
+        }
+        if (verifyFileIntegrity(entry.tempFile, entry.size, entry.crc) &&
+            replaceTarget(entry)) {
+          LOG_CONFIG_INFO("[ATOMIC] Rolled forward: %s\n",
+                          entry.targetFile.c_str());
+          recovered++;
+        } else {
+          LOG_CONFIG_INFO("[ATOMIC] Failed to roll forward: %s\n",
+                          entry.targetFile.c_str());
         }
       }
+    } else {
+      LOG_CONFIG_INFO("[ATOMIC] Torn WAL record discarded (group not committed)");
     }
-
-    xSemaphoreGive(walMutex);
+    LittleFS.remove(WAL_FILE);
   }
 
+  // Check for orphaned temp files (from interrupted writes), in the root
+  // and one directory level below it
+  recovered += cleanupTempFiles("/", true);
+
   LOG_CONFIG_INFO("[ATOMIC] Recovery completed: %d operations recovered\n",
                   recovered);
   return recovered;
@@ -350,46 +546,30 @@ uint8_t AtomicFileOps::recover() {
 
 void AtomicFileOps::forceWALCleanup() {
   LOG_CONFIG_INFO("[ATOMIC] Force cleanup of WAL...");
+  abortGroup();
   clearWAL();
+  LittleFS.remove(WAL_FILE);
 
-  // Remove all .tmp files
-  // Using proper LittleFS API for directory listing
-  File root = LittleFS.open("/");
-  if (!root) {
-    LOG_CONFIG_INFO("[ATOMIC] ERROR: Cannot open root directory for cleanup");
-    return;
-  }
-
-  File file = root.openNextFile();
-  while (file) {
-    String fileName = file.name();
-    if (fileName.endsWith(".tmp")) {
-      file.close();
-      if (LittleFS.remove(String("/") + fileName)) {
-        LOG_CONFIG_INFO("[ATOMIC] Removed: %s\n", fileName.c_str());
-      }
-    } else {
-      file.close();
-    }
-    file = root.openNextFile();
-  }
-  root.close();
+  // Remove all temp files
+  cleanupTempFiles("/", true);
 
   LOG_CONFIG_INFO("[ATOMIC] Force cleanup completed");
 }
 
 void AtomicFileOps::printWALStatus() {
   Serial.println("\n[ATOMIC] WAL STATUS");
-  Serial.printf("  WAL Entries: %d\n", walLog.size());
+  Serial.printf("  Staged group writes: %d\n", walLog.size());
 
   if (xSemaphoreTake(walMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
     for (size_t i = 0; i < walLog.size(); i++) {
       const auto& entry = walLog[i];
-      Serial.printf("    [%d] %s on %s - %s\n", i, entry.operation.c_str(),
-                    entry.targetFile.c_str(),
-                    entry.completed ? "COMPLETED" : "INCOMPLETE");
+      Serial.printf("    [%d] %s on %s - %u bytes, CRC %08X\n", i,
+                    entry.operation.c_str(), entry.targetFile.c_str(),
+                    entry.size, entry.crc);
     }
     xSemaphoreGive(walMutex);
   }
+  Serial.printf("  WAL record on flash: %s\n",
+                LittleFS.exists(WAL_FILE) ? "YES" : "NO");
   Serial.println();
 }
@@ -10,6 +10,21 @@
  * - Checksum verification
  * - Automatic recovery on startup
  * - Zero breaking changes to existing code
+ *
+ * v1.3.3: Group commit + CRC32
+ * Previous: Every write kept an in-memory WAL entry (lost on power loss, so
+ * recovery never saw it) and checksummed with a rotating XOR that was
+ * skipped for documents over 10KB ("SKIPPED_LARGE").
+ * New:
+ * - CRC32 (ESP32 ROM esp_rom_crc32_le) computed while serializing, at any
+ *   size, and re-checked on the temp file before it replaces the target
+ * - Group commit: writes between beginGroup() and commitGroup() only stage
+ *   temp files. commitGroup() writes ONE WAL record (targets + sizes +
+ *   CRCs) to flash - the single flush point - then renames every temp
+ *   file. recover() rolls a committed record forward; staged temp files
+ *   without a committed record are discarded (all-or-nothing)
+ * - Single writes stay temp + rename; a power loss between removing the
+ *   target and the rename is repaired by promoting the temp file
  */
 
 #ifndef ATOMIC_FILE_OPS_H
@@ -20,6 +35,7 @@
 #include <LittleFS.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <freertos/task.h>
 
 #include <vector>
 
@@ -33,7 +49,8 @@ struct WALEntry {
   String targetFile;        // File being modified
   String tempFile;          // Temporary file (if applicable)
   unsigned long timestamp;  // When operation started
-  String checksum;          // For verification
+  uint32_t crc = 0;         // v1.3.3: CRC32 of the staged content
+  uint32_t size = 0;        // v1.3.3: Byte size of the staged content
   bool completed = false;   // Mark as completed after successful write
   uint8_t retryCount = 0;   // Retry tracking
 
@@ -57,16 +74,34 @@ struct WALEntry {
 class AtomicFileOps {
  private:
   static const char* WAL_FILE;
-  std::vector<WALEntry> walLog;
+  static const char* TEMP_SUFFIX;        // v1.3.3: Single write staging
+  static const char* GROUP_TEMP_SUFFIX;  // v1.3.3: Group write staging
+  static const uint32_t WAL_MAGIC = 0x314C4157;  // "WAL1"
+
+  // v1.3.3: On-flash WAL record (header + entries, body CRC32)
+  struct WALRecordHeader {
+    uint32_t magic;
+    uint16_t count;     // Entries in the body
+    uint16_t reserved;
+    uint32_t bodySize;  // Entry bytes after the header
+    uint32_t bodyCrc;
+  };
+
+  std::vector<WALEntry> walLog;  // v1.3.3: Staged writes of the open group
   SemaphoreHandle_t walMutex;
+  TaskHandle_t groupOwner = nullptr;  // v1.3.3: Task that opened the group
   bool recoveryAttempted = false;
 
   // Private helper methods
-  String calculateChecksum(const JsonDocument& doc);
-  String calculateFileChecksum(const String& filename);
-  bool verifyFileIntegrity(const String& filename);
-  void appendToWAL(const WALEntry& entry);
-  void markWALEntryCompleted(const String& filename);
+  bool writeTempFile(WALEntry& entry, const JsonDocument& doc);
+  bool replaceTarget(const WALEntry& entry);
+  bool calculateFileCrc(const String& filename, uint32_t& size,
+                        uint32_t& crc);
+  bool verifyFileIntegrity(const String& filename, uint32_t size,
+                           uint32_t crc);
+  bool writeWALRecord(const std::vector<WALEntry>& entries);
+  bool readWALRecord(std::vector<WALEntry>& entries);
+  uint8_t cleanupTempFiles(const String& dir, bool topLevel);
   void clearWAL();
 
  public:
@@ -83,16 +118,19 @@ class AtomicFileOps {
    * @brief Perform atomic write of JSON document to file
    *
    * Uses two-phase commit:
-   * 1. Write to temporary file (.tmp)
+   * 1. Write to temporary file (.wtmp), CRC32 verified
    * 2. Atomic rename to target filename
    *
-   * If power is lost during step 1, recovery will clean up .tmp
+   * If power is lost during step 1, recovery will clean up the temp file
    * If power is lost during step 2, recovery will complete the rename
    *
+   * Inside a group (same task as beginGroup()) the write is only staged and
+   * becomes visible at commitGroup().
+   *
    * @param filename Target filename (must be absolute path like
    * "/devices.json")
    * @param doc JsonDocument to write
-   * @return true if write successful
+   * @return true if write (or staging) successful
    */
   bool writeAtomic(const String& filename, const JsonDocument& doc);
 
@@ -103,10 +141,27 @@ class AtomicFileOps {
    */
   bool deleteAtomic(const String& filename);
 
+  /**
+   * @brief v1.3.3: Group commit (not nestable)
+   *
+   * beginGroup() starts staging writeAtomic() calls of the calling task.
+   * commitGroup() makes all of them visible with one WAL flush; a later
+   * write of the same file replaces the staged one. abortGroup() discards
+   * everything staged.
+   *
+   * @return beginGroup: false if a group is already open
+   *         commitGroup: false if the WAL record could not be written
+   *         (nothing was applied)
+   */
+  bool beginGroup();
+  bool commitGroup();
+  void abortGroup();
+
   /**
    * @brief Recover from incomplete operations
    *
    * Called on startup to clean up after power loss.
+   * - Rolls a committed group WAL record forward
    * - Removes orphaned temp files
    * - Completes interrupted renames if possible
    * - Verifies file integrity
@@ -117,7 +172,7 @@ class AtomicFileOps {
 
   /**
    * @brief Get WAL status for debugging
-   * @return Number of incomplete operations in log
+   * @return Number of writes staged in the open group
    */
   uint8_t getWALSize() const { return walLog.size(); }
 
@@ -3,19 +3,27 @@
 #include <esp_bt.h>  // For BT controller memory release
 #include <esp_heap_caps.h>
 
+#include <cfloat>
+#include <cmath>
 #include <new>
 
 #include "CRUDHandler.h"
 #include "DebugConfig.h"          // MUST BE FIRST for LOG_* macros
 #include "ErrorResponseHelper.h"  // v1.0.2: Standardized error responses
+#include "HeatshrinkEncoder.h"    // v1.3.3: Compressed responses
 #include "MemoryManager.h"        // Include the new memory manager
+#include "MemoryRecovery.h"       // v1.3.3: Memory pressure (deferral)
+#include "ModbusPollPlan.h"       // v1.3.3: PollPlanRegistry (stream schema)
 #include "QueueManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 // v1.3.1: External reference to global BLE priority flag (defined in Main.ino)
 // Used to pause RTU/TCP/MQTT tasks during BLE command processing
 #include <atomic>
 extern std::atomic<bool> g_bleCommandActive;
 
+BLEManager* BLEManager::gattsInstance = nullptr;
+
 BLEManager::BLEManager(const String& name, CRUDHandler* cmdHandler)
     : serviceName(name),
       handler(cmdHandler),
@@ -35,6 +43,7 @@ BLEManager::BLEManager(const String& name, CRUDHandler* cmdHandler)
 
   // Initialize metrics
   initializeMetrics();
+  txCreditSignal = xSemaphoreCreateBinary();  // v1.3.3: Notify flow control
 }
 
 BLEManager::~BLEManager() {
@@ -72,6 +81,11 @@ BLEManager::~BLEManager() {
     streamingStateMutex = nullptr;
   }
 
+  if (txCreditSignal) {
+    vSemaphoreDelete(txCreditSignal);
+    txCreditSignal = nullptr;
+  }
+
   LOG_BLE_INFO("[BLE] Manager destroyed, resources cleaned up");
 }
 
@@ -124,6 +138,10 @@ bool BLEManager::begin() {
       "supported)\n",
       BLE_MTU_SAFE_DEFAULT);
 
+  // v1.3.3: Notify completion/congestion/MTU events (flow control)
+  gattsInstance = this;
+  BLEDevice::setCustomGattsHandler(gattsEventHandler);
+
   // Create BLE Server
   pServer = BLEDevice::createServer();
   pServer->setCallbacks(this);
@@ -139,6 +157,7 @@ bool BLEManager::begin() {
   // Create Response Characteristic (Notify)
   pResponseChar = pService->createCharacteristic(
       RESPONSE_CHAR_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+  pResponseChar->setCallbacks(this);  // v1.3.3: onStatus (failed notifies)
   // Deskriptor 2902 ditambahkan secara otomatis oleh library
 
   // Start service
@@ -160,24 +179,21 @@ bool BLEManager::begin() {
                serviceName.c_str());
 
   // Create command processing task with PSRAM stack
-  xTaskCreatePinnedToCore(commandProcessingTask, "BLE_CMD_TASK",
-                          8192,  // Increased stack size for PSRAM usage
-                          this, 1, &commandTaskHandle,
-                          1  // Pin to core 1
-  );
+  // v1.3.3: Core / priority from TaskAffinity.h (all BLE tasks on one core)
+  TaskAffinity::create(commandProcessingTask, "BLE_CMD_TASK",
+                       8192,  // Increased stack size for PSRAM usage
+                       this, TaskAffinity::Task::BLE_COMMAND,
+                       &commandTaskHandle);
 
   // Create streaming task
-  xTaskCreatePinnedToCore(streamingTask, "BLE_STREAM_TASK", 4096, this, 1,
-                          &streamTaskHandle, 1);
+  TaskAffinity::create(streamingTask, "BLE_STREAM_TASK", 4096, this,
+                       TaskAffinity::Task::BLE_STREAM, &streamTaskHandle);
 
   // Create metrics monitoring task
-  // MUST stay on Core 1: Accesses BLE data structures managed by BLE_CMD_TASK
-  // (Core 1)
-  xTaskCreatePinnedToCore(
-      metricsMonitorTask, "BLE_METRICS_TASK", 4096, this,
-      0,  // Lower priority for monitoring
-      &metricsTaskHandle,
-      1);  // Core 1 (must stay with other BLE tasks to avoid race conditions)
+  // MUST stay on the BLE_CMD_TASK core: Accesses BLE data structures managed
+  // by BLE_CMD_TASK (lower priority for monitoring)
+  TaskAffinity::create(metricsMonitorTask, "BLE_METRICS_TASK", 4096, this,
+                       TaskAffinity::Task::BLE_METRICS, &metricsTaskHandle);
 
   LOG_BLE_INFO("[BLE] Manager initialized: %s\n", serviceName.c_str());
   LOG_BLE_INFO("[BLE] MTU Metrics and Queue Monitoring enabled\n");
@@ -225,6 +241,7 @@ void BLEManager::stop() {
 
 void BLEManager::onConnect(BLEServer* pServer) {
   LOG_BLE_INFO("[BLE] Client connected");
+  resetTxFlowControl();
 
   // Log connection and MTU negotiation
   if (xSemaphoreTake(metricsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
@@ -251,6 +268,7 @@ void BLEManager::onConnect(BLEServer* pServer) {
 
 void BLEManager::onDisconnect(BLEServer* pServer) {
   LOG_BLE_INFO("[BLE] Client disconnected");
+  resetTxFlowControl();
 
   // Log connection duration and metrics
   if (xSemaphoreTake(metricsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
@@ -291,6 +309,7 @@ void BLEManager::onDisconnect(BLEServer* pServer) {
   }
   commandBufferIndex = 0;
   memset(commandBuffer, 0, COMMAND_BUFFER_SIZE);
+  registerImport.cancel();  // v1.3.3: Partial upload is never applied
   processing = false;
   lastFragmentTime = 0;
 
@@ -313,7 +332,8 @@ void BLEManager::receiveFragment(const String& fragment) {
   constexpr unsigned long COMMAND_TIMEOUT_MS = 5000;  // 5 seconds timeout
   unsigned long now = millis();
 
-  if (commandBufferIndex > 0 && (now - lastFragmentTime) > COMMAND_TIMEOUT_MS) {
+  if ((commandBufferIndex > 0 || registerImport.receiving()) &&
+      (now - lastFragmentTime) > COMMAND_TIMEOUT_MS) {
     LOG_BLE_INFO(
         "[BLE] WARNING: Command timeout! Buffer had %d bytes but no <END> "
         "received for %lu ms\n",
@@ -321,6 +341,7 @@ void BLEManager::receiveFragment(const String& fragment) {
     LOG_BLE_INFO("[BLE] Clearing dirty buffer to prevent corruption");
     commandBufferIndex = 0;
     memset(commandBuffer, 0, COMMAND_BUFFER_SIZE);
+    registerImport.cancel();
     processing = false;
   }
 
@@ -342,10 +363,22 @@ void BLEManager::receiveFragment(const String& fragment) {
 #endif
     commandBufferIndex = 0;
     memset(commandBuffer, 0, COMMAND_BUFFER_SIZE);
+    registerImport.cancel();
     processing = false;  // Ensure we're ready for new command
     return;
   }
 
+  // v1.3.3: Streaming register import - fragments up to <END> are parsed as
+  // they arrive (RegisterImportStream) instead of filling commandBuffer
+  if (fragment == "<IMPORT>") {
+    LOG_BLE_INFO("[BLE] <IMPORT> marker received - streaming registers\n");
+    commandBufferIndex = 0;
+    if (!registerImport.begin()) {
+      sendError("Register import busy or out of memory", "registers");
+    }
+    return;
+  }
+
   // v1.0.9: Handle <CANCEL> command from mobile app
   // Stops ongoing transmission and clears buffers
   if (fragment == "<CANCEL>") {
@@ -357,17 +390,31 @@ void BLEManager::receiveFragment(const String& fragment) {
     // Clear command buffer
     commandBufferIndex = 0;
     memset(commandBuffer, 0, COMMAND_BUFFER_SIZE);
+    registerImport.cancel();
     processing = false;
 
     // Send acknowledgment
     if (pResponseChar) {
-      pResponseChar->setValue("<ACK>");
-      pResponseChar->notify();
+      notifyResponse("<ACK>", false);  // BLE stack task: never wait here
     }
 
     return;
   }
 
+  if (fragment == "<END>" && registerImport.receiving()) {
+    finishRegisterImport();
+    return;
+  }
+
+  if (registerImport.receiving()) {
+    // An upload that failed already sent its error: rest is dropped
+    if (registerImport.state() == RegisterImportStream::RECEIVING &&
+        !registerImport.feed(fragment.c_str(), fragment.length())) {
+      sendError(registerImport.error(), "registers");
+    }
+    return;
+  }
+
   if (fragment == "<END>") {
     // Validate buffer has data before processing
     if (commandBufferIndex == 0) {
@@ -449,6 +496,61 @@ void BLEManager::receiveFragment(const String& fragment) {
   }
 }
 
+/**
+ * <END> of an <IMPORT> upload
+ * Queues the import header as a normal command; its registers stay staged
+ * in registerImport until CRUDHandler::importRegisters() releases them.
+ */
+void BLEManager::finishRegisterImport() {
+  if (registerImport.state() == RegisterImportStream::FAILED) {
+    registerImport.cancel();  // Error already sent
+    return;
+  }
+
+  JsonDocument command;
+  if (!registerImport.finish(command)) {
+    sendError(registerImport.error(), "registers");
+    registerImport.cancel();
+    return;
+  }
+
+  size_t length = measureJson(command);
+  char* cmdBuffer = (char*)heap_caps_malloc(
+      length + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (cmdBuffer) {
+    serializeJson(command, cmdBuffer, length + 1);
+    if (xQueueSend(commandQueue, &cmdBuffer, 0) == pdPASS) {
+      LOG_BLE_INFO("[BLE] Register import staged (%lu registers, %lu "
+                   "bytes)\n",
+                   (unsigned long)registerImport.registers().size(),
+                   (unsigned long)registerImport.bytesReceived());
+      return;
+    }
+    heap_caps_free(cmdBuffer);
+    LOG_BLE_INFO("[BLE] Command queue full, register import dropped.");
+    if (xSemaphoreTake(metricsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+      queueMetrics.dropCount++;
+      xSemaphoreGive(metricsMutex);
+    }
+  } else {
+    LOG_BLE_INFO("[BLE] ERROR: Failed to allocate memory for BLE command!");
+  }
+  registerImport.release();
+  sendError("Register import could not be queued", "registers");
+}
+
+RegisterImportStream* BLEManager::takeRegisterImport() {
+  return registerImport.state() == RegisterImportStream::QUEUED
+             ? &registerImport
+             : nullptr;
+}
+
+void BLEManager::releaseRegisterImport() {
+  if (registerImport.state() == RegisterImportStream::QUEUED) {
+    registerImport.release();
+  }
+}
+
 void BLEManager::commandProcessingTask(void* parameter) {
   BLEManager* manager = static_cast<BLEManager*>(parameter);
   char* command;
@@ -548,11 +650,18 @@ void BLEManager::handleCompleteCommand(const char* command) {
                   cmdLen);
   }
 
+  // v1.3.3: Opt-in compressed responses for this command only
+  const char* compress = doc["compress"] | "";
+  compressionOwner.store(strcmp(compress, "heatshrink") == 0
+                             ? xTaskGetCurrentTaskHandle()
+                             : nullptr);
+
   if (handler) {
     handler->handle(this, doc);
   } else {
     sendError("No handler configured", "system");
   }
+  compressionOwner.store(nullptr);
 
   // v1.3.1: Clear BLE priority flag after command processing complete
   g_bleCommandActive.store(false);
@@ -578,15 +687,16 @@ void BLEManager::sendResponse(const JsonDocument& data) {
     snprintf(buffer, sizeof(buffer), "%s%u,\"max\":%d}", errorMsg,
              estimatedSize, MAX_RESPONSE_SIZE_BYTES);
 
-    pResponseChar->setValue(buffer);
-    pResponseChar->notify();
-    vTaskDelay(pdMS_TO_TICKS(50));
-    pResponseChar->setValue("<END>");
-    pResponseChar->notify();
+    notifyResponse(buffer);
+    notifyResponse("<END>");
 
     return;  // Abort large response
   }
 
+  if (estimatedSize > LARGE_PAYLOAD_THRESHOLD) {
+    deferWhileMemoryRed();
+  }
+
   // Size OK - proceed with PSRAM-based serialization
   // BUG #31 PART 2: Allocate buffer in PSRAM instead of String (DRAM)
   // String class ALWAYS uses DRAM → causes exhaustion with large responses
@@ -609,11 +719,8 @@ void BLEManager::sendResponse(const JsonDocument& data) {
                    bufferSize);
       const char* errorMsg =
           "{\"status\":\"error\",\"message\":\"Memory allocation failed\"}";
-      pResponseChar->setValue(errorMsg);
-      pResponseChar->notify();
-      vTaskDelay(pdMS_TO_TICKS(50));
-      pResponseChar->setValue("<END>");
-      pResponseChar->notify();
+      notifyResponse(errorMsg);
+      notifyResponse("<END>");
       return;
     }
   }
@@ -730,8 +837,7 @@ void BLEManager::sendOtaProgressNotification(
 
   // Send directly without fragmentation (small payload ~150 bytes)
   if (payload.length() < 200) {
-    pResponseChar->setValue(payload.c_str());
-    pResponseChar->notify();
+    notifyResponse(payload.c_str());
   } else {
     // Fallback to fragmented send if somehow payload is large
     sendResponse(doc);
@@ -780,9 +886,7 @@ void BLEManager::sendConfigDownloadProgress(uint8_t percent, size_t bytesSent,
   LOG_BLE_DEBUG("[BLE] Config download progress: %d%% (%zu/%zu bytes)\n",
                 percent, bytesSent, totalBytes);
 
-  pResponseChar->setValue(payload.c_str());
-  pResponseChar->notify();
-  vTaskDelay(pdMS_TO_TICKS(5));  // Small delay to ensure delivery
+  notifyResponse(payload.c_str());
 }
 
 /**
@@ -837,8 +941,7 @@ void BLEManager::sendConfigUploadProgress(uint8_t percent, size_t bytesReceived,
   LOG_BLE_DEBUG("[BLE] Config upload progress: %d%% (%zu bytes)\n", percent,
                 bytesReceived);
 
-  pResponseChar->setValue(payload.c_str());
-  pResponseChar->notify();
+  notifyResponse(payload.c_str(), false);  // BLE stack task (receiveFragment)
   vTaskDelay(pdMS_TO_TICKS(5));
 }
 
@@ -872,9 +975,7 @@ void BLEManager::sendConfigRestoreProgress(const String& step,
   LOG_BLE_DEBUG("[BLE] Config restore progress: %s (%d/%d)\n", step.c_str(),
                 currentStep, totalSteps);
 
-  pResponseChar->setValue(payload.c_str());
-  pResponseChar->notify();
-  vTaskDelay(pdMS_TO_TICKS(10));  // Slightly longer delay for restore steps
+  notifyResponse(payload.c_str());
 }
 
 void BLEManager::sendFragmented(const char* data, size_t length) {
@@ -894,11 +995,8 @@ void BLEManager::sendFragmented(const char* data, size_t length) {
     // Use stack-allocated const char* - NO heap allocation
     const char* emergencyMsg =
         "{\"status\":\"error\",\"msg\":\"Out of memory\"}";
-    pResponseChar->setValue(emergencyMsg);
-    pResponseChar->notify();
-    vTaskDelay(pdMS_TO_TICKS(50));
-    pResponseChar->setValue("<END>");
-    pResponseChar->notify();
+    notifyResponse(emergencyMsg);
+    notifyResponse("<END>");
 
     return;  // Abort immediately without any heap operations
   }
@@ -914,11 +1012,8 @@ void BLEManager::sendFragmented(const char* data, size_t length) {
     const char* errorMsg =
         "{\"status\":\"error\",\"message\":\"Response too large for BLE "
         "transmission\"}";
-    pResponseChar->setValue(errorMsg);
-    pResponseChar->notify();
-    vTaskDelay(pdMS_TO_TICKS(50));
-    pResponseChar->setValue("<END>");
-    pResponseChar->notify();
+    notifyResponse(errorMsg);
+    notifyResponse("<END>");
 
     return;  // Abort large transmission
   }
@@ -951,70 +1046,31 @@ void BLEManager::sendFragmented(const char* data, size_t length) {
     return;
   }
 
-  // CRITICAL FIX: Smart chunk size and delay based on payload size
-  // BUG FIX: Always use slower delay for large payloads to prevent mobile app
-  // timeout Previous behavior: Only slow down if DRAM is low - caused timeouts
-  // on healthy DRAM New behavior: Payload size determines delay, DRAM
-  // determines chunk size Three-tier system: Small (<5KB), Large (5-50KB),
-  // Extra-Large (>50KB)
-  size_t adaptiveChunkSize = CHUNK_SIZE;
-  int adaptiveDelay = FRAGMENT_DELAY_MS;
-
-  if (length >
-      XLARGE_PAYLOAD_THRESHOLD) {  // >50KB payload (backup/restore operations)
-    // Extra-large payload: slowest delay to prevent mobile app timeout
-    adaptiveDelay =
-        ADAPTIVE_DELAY_XLARGE_MS;  // 50ms - critical for large backups
-
-    // Chunk size depends on DRAM availability
-    // v2.3.6 OPTIMIZED: Lowered from 30KB to 25KB to accommodate post-restore
-    // DRAM levels (~28KB)
-    if (freeDRAM < 25000) {
-      adaptiveChunkSize = ADAPTIVE_CHUNK_SIZE_LARGE;  // 100 bytes
-      LOG_BLE_INFO(
-          "[BLE] XLARGE payload (%u bytes) + LOW DRAM (%zu bytes) = using "
-          "SMALL chunks with XSLOW delay (size:%zu, delay:%dms)\n",
-          length, freeDRAM, adaptiveChunkSize, adaptiveDelay);
-    } else {
-      LOG_BLE_INFO(
-          "[BLE] XLARGE payload (%u bytes) with healthy DRAM (%zu bytes) = "
-          "using NORMAL chunks with XSLOW delay (size:%zu, delay:%dms)\n",
-          length, freeDRAM, adaptiveChunkSize, adaptiveDelay);
-    }
-  } else if (length > LARGE_PAYLOAD_THRESHOLD) {  // 5-50KB payload
-    // Large payload: moderate delay
-    adaptiveDelay = ADAPTIVE_DELAY_LARGE_MS;  // 20ms
-
-    // Chunk size depends on DRAM availability
-    // v2.3.6 OPTIMIZED: Lowered from 30KB to 25KB to accommodate post-restore
-    // DRAM levels (~28KB)
-    if (freeDRAM < 25000) {
-      adaptiveChunkSize = ADAPTIVE_CHUNK_SIZE_LARGE;  // 100 bytes
-      LOG_BLE_INFO(
-          "[BLE] Large payload (%u bytes) + LOW DRAM (%zu bytes) = using SMALL "
-          "chunks with SLOW delay (size:%zu, delay:%dms)\n",
-          length, freeDRAM, adaptiveChunkSize, adaptiveDelay);
-    } else {
-      LOG_BLE_INFO(
-          "[BLE] Large payload (%u bytes) with healthy DRAM (%zu bytes) = "
-          "using NORMAL chunks with SLOW delay (size:%zu, delay:%dms)\n",
-          length, freeDRAM, adaptiveChunkSize, adaptiveDelay);
-    }
-  }
-  // else: Small payload (<5KB) - use default fast settings (244 bytes, 10ms)
+  // v1.3.3: Chunks sized to the negotiated MTU, paced by notify credits
+  // instead of fixed per-chunk sleeps (see BLE_TX_CREDITS)
+  size_t chunkSize = txPayloadSize();
+  uint8_t credits =
+      (freeDRAM < 25000) ? BLE_TX_CREDITS_LOW_DRAM : BLE_TX_CREDITS;
 
   // BUG #31 PART 2: Data already in PSRAM buffer (from sendResponse)
   // No String overhead, no DRAM allocation
-  const char* dataPtr = data;
+  const uint8_t* dataPtr = reinterpret_cast<const uint8_t*>(data);
   size_t dataLen = length;
   size_t i = 0;
 
-  // Allocate static buffer for chunks to avoid repeated allocations
-  char chunkBuffer[256];  // Max chunk size + safety margin
-
   // v1.0.9: Reset cancellation flag at start of new transmission
   transmissionCancelled.store(false);
 
+  // v1.3.3: Compressed body if the command asked for it (command task only,
+  // streamed data points stay plain)
+  if (dataLen > BLE_COMPRESS_MIN_BYTES && compressionOwner.load() != nullptr &&
+      compressionOwner.load() == xTaskGetCurrentTaskHandle() &&
+      sendCompressed(data, dataLen, chunkSize, credits)) {
+    xSemaphoreGive(transmissionMutex);
+    __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+    return;
+  }
+
   while (i < dataLen) {
     // v1.0.9: Check for cancellation request from mobile app
     if (transmissionCancelled.load()) {
@@ -1022,36 +1078,20 @@ void BLEManager::sendFragmented(const char* data, size_t length) {
           "[BLE] Transmission cancelled at %zu/%zu bytes (%.1f%%)\n", i, dataLen,
           (float)i * 100 / dataLen);
       // Send cancelled marker instead of END
-      pResponseChar->setValue("<CANCELLED>");
-      pResponseChar->notify();
+      notifyResponse("<CANCELLED>");
       xSemaphoreGive(transmissionMutex);
       __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
       return;
     }
 
-    size_t chunkLen = min(adaptiveChunkSize, dataLen - i);
-
-    // SAFETY: Ensure chunk size doesn't exceed buffer
-    if (chunkLen > 255) {
-      chunkLen = 255;
-    }
-
-    // Copy chunk to buffer (avoid String::substring allocation)
-    memcpy(chunkBuffer, dataPtr + i, chunkLen);
-    chunkBuffer[chunkLen] = '\0';  // Null terminate
+    size_t chunkLen = min(chunkSize, dataLen - i);
 
-    // Send chunk
-    pResponseChar->setValue(chunkBuffer);
-    pResponseChar->notify();
+    // Send chunk (waits for a credit, not a fixed delay)
+    notifyResponse(dataPtr + i, chunkLen, true, credits);
 
     // Track fragment transmission
-    if (xSemaphoreTake(metricsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-      connectionMetrics.fragmentsSent++;
-      connectionMetrics.bytesTransmitted += chunkLen;
-      xSemaphoreGive(metricsMutex);
-    }
+    countFragment(chunkLen);
 
-    vTaskDelay(pdMS_TO_TICKS(adaptiveDelay));
     i += chunkLen;
 
     // v1.0.3: Send download progress notification for large payloads
@@ -1065,8 +1105,7 @@ void BLEManager::sendFragmented(const char* data, size_t length) {
   }
 
   // Send end marker
-  pResponseChar->setValue("<END>");
-  pResponseChar->notify();
+  notifyResponse("<END>");
 
   xSemaphoreGive(transmissionMutex);
 
@@ -1083,7 +1122,11 @@ void BLEManager::streamingTask(void* parameter) {
   while (true) {
     // Check if streaming is active before processing queue
     if (manager->isStreamingActive() && queueMgr &&
-        !queueMgr->isStreamEmpty()) {
+        !queueMgr->isStreamEmpty() && manager->isBinaryStreaming()) {
+      // v1.3.3: Binary frames drain every pending record per tick
+      manager->streamBinaryRecords(queueMgr);
+    } else if (manager->isStreamingActive() && queueMgr &&
+               !queueMgr->isStreamEmpty()) {
       JsonDocument dataDoc;
       JsonObject dataPoint = dataDoc.to<JsonObject>();
 
@@ -1115,6 +1158,524 @@ void BLEManager::streamingTask(void* parameter) {
   }
 }
 
+bool BLEManager::sendCompressed(const char* data, size_t length,
+                                size_t chunkSize, uint8_t credits) {
+  BLENotifyWriter& notifier = responseStream.notifier;
+  HeatshrinkEncoder& encoder = responseStream.encoder;
+  notifier.begin(this, chunkSize, credits);
+  if (!startCompressed(notifier, encoder, length)) {
+    return false;
+  }
+
+  // Body: compressed while it is sent (piecewise to notice cancellation)
+  const size_t SLICE = 1024;
+  for (size_t i = 0; i < length && !notifier.cancelled(); i += SLICE) {
+    encoder.write(reinterpret_cast<const uint8_t*>(data) + i,
+                  min(SLICE, length - i));
+  }
+  encoder.finish();
+  notifier.sendPending();
+
+  if (notifier.cancelled()) {
+    LOG_BLE_INFO("[BLE] Compressed transmission cancelled at %zu/%zu bytes\n",
+                 notifier.bytesSent(), length);
+    notifyResponse("<CANCELLED>");
+    return true;
+  }
+  notifyResponse("<END>");
+
+  LOG_BLE_INFO("[BLE] Compressed response: %zu -> %zu bytes\n", length,
+               notifier.bytesSent());
+  return true;
+}
+
+bool BLEManager::startCompressed(BLENotifyWriter& notifier,
+                                 HeatshrinkEncoder& encoder,
+                                 size_t knownSize) {
+  if (!encoder.begin(notifier)) {
+    LOG_BLE_INFO("[BLE] WARNING: Compressor unavailable, sending plain JSON");
+    return false;
+  }
+
+  // Header message: how to decode the body that follows ("size" only when
+  // known up front, streamed responses end at <END>)
+  char header[160];
+  int headerLen = snprintf(
+      header, sizeof(header),
+      "{\"status\":\"compressed\",\"encoding\":\"heatshrink\","
+      "\"window_bits\":%u,\"lookahead_bits\":%u",
+      HeatshrinkEncoder::WINDOW_BITS, HeatshrinkEncoder::LOOKAHEAD_BITS);
+  if (knownSize > 0) {
+    headerLen += snprintf(header + headerLen, sizeof(header) - headerLen,
+                          ",\"size\":%u", (unsigned)knownSize);
+  }
+  headerLen += snprintf(header + headerLen, sizeof(header) - headerLen, "}");
+
+  notifier.write(reinterpret_cast<const uint8_t*>(header), headerLen);
+  notifier.sendPending();
+  notifyResponse("<END>");
+  return true;
+}
+
+void BLEManager::countFragment(size_t length) {
+  if (xSemaphoreTake(metricsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    connectionMetrics.fragmentsSent++;
+    connectionMetrics.bytesTransmitted += length;
+    xSemaphoreGive(metricsMutex);
+  }
+}
+
+// ============================================================================
+// v1.3.3: INCREMENTAL RESPONSES
+// ============================================================================
+
+// v1.3.3: Backpressure for large responses
+// Previous: a config download or backup serialized into a fresh buffer
+// whatever the memory state, competing with the recovery flushes.
+// New: while memory pressure is RED the response waits (the other producers
+// are backing off meanwhile); after BLE_PRESSURE_DEFER_MS it is sent anyway
+// and the DRAM floors below still apply. Runs on the command task only.
+void BLEManager::deferWhileMemoryRed() {
+  if (MemoryRecovery::samplePressure() != MemoryPressure::RED) return;
+
+  unsigned long start = millis();
+  while (millis() - start < BLE_PRESSURE_DEFER_MS) {
+    vTaskDelay(pdMS_TO_TICKS(BLE_PRESSURE_POLL_MS));
+    if (MemoryRecovery::samplePressure() != MemoryPressure::RED) {
+      LOG_BLE_INFO("[BLE] Large response deferred %lu ms (memory pressure)\n",
+                   millis() - start);
+      return;
+    }
+  }
+  LOG_BLE_WARN("[BLE] Memory pressure still red after %d ms - sending\n",
+               BLE_PRESSURE_DEFER_MS);
+}
+
+BLEResponseStream* BLEManager::beginResponse() {
+  if (!pResponseChar) return nullptr;
+
+  // Streamed responses are the large ones (backups, config downloads)
+  deferWhileMemoryRed();
+
+  // Same DRAM floor as sendFragmented() (BLE host buffers are DRAM)
+  size_t freeDRAM =
+      heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (freeDRAM < 5000) {
+    LOG_BLE_INFO(
+        "[BLE] CRITICAL: DRAM exhausted (%zu bytes). Response not started.\n",
+        freeDRAM);
+    return nullptr;
+  }
+
+  __atomic_add_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+  if (xSemaphoreTake(transmissionMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+    LOG_BLE_INFO("[BLE] ERROR: Mutex timeout");
+    __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+    return nullptr;
+  }
+  transmissionCancelled.store(false);
+
+  uint8_t credits =
+      (freeDRAM < 25000) ? BLE_TX_CREDITS_LOW_DRAM : BLE_TX_CREDITS;
+  responseStream.manager = this;
+  responseStream.written = 0;
+  responseStream.notifier.begin(this, txPayloadSize(), credits);
+  responseStream.compressed =
+      compressionOwner.load() != nullptr &&
+      compressionOwner.load() == xTaskGetCurrentTaskHandle() &&
+      startCompressed(responseStream.notifier, responseStream.encoder, 0);
+  return &responseStream;
+}
+
+void BLEManager::endResponse() {
+  BLEResponseStream& stream = responseStream;
+  if (stream.compressed) {
+    stream.encoder.finish();
+  }
+  stream.notifier.sendPending();
+
+  bool cancelled = stream.cancelled();
+  notifyResponse(cancelled ? "<CANCELLED>" : "<END>");
+  LOG_BLE_INFO("[BLE] Streamed response %s: %zu bytes (%zu over the air)\n",
+               cancelled ? "cancelled" : "sent", stream.written,
+               stream.notifier.bytesSent());
+
+  xSemaphoreGive(transmissionMutex);
+  __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+}
+
+void BLENotifyWriter::begin(BLEManager* manager, size_t chunkSize,
+                            uint8_t credits) {
+  this->manager = manager;
+  this->chunkSize = min(chunkSize, sizeof(chunk));
+  this->credits = credits;
+  used = 0;
+  sent = 0;
+}
+
+bool BLENotifyWriter::cancelled() const {
+  return manager && manager->isTransmissionCancelled();
+}
+
+size_t BLENotifyWriter::write(uint8_t byte) { return write(&byte, 1); }
+
+size_t BLENotifyWriter::write(const uint8_t* data, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    size_t room = min(chunkSize - used, size - done);
+    memcpy(chunk + used, data + done, room);
+    used += room;
+    done += room;
+    if (used == chunkSize) {
+      sendPending();
+    }
+  }
+  return size;
+}
+
+void BLENotifyWriter::sendPending() {
+  if (used == 0 || !manager) return;
+
+  if (!cancelled()) {
+    bool looksLikeMarker =
+        (used == 5 && (memcmp(chunk, "<END>", 5) == 0 ||
+                       memcmp(chunk, "<ACK>", 5) == 0)) ||
+        (used == 11 && memcmp(chunk, "<CANCELLED>", 11) == 0);
+    if (looksLikeMarker) {
+      manager->notifyResponse(chunk, 1, true, credits);
+      manager->notifyResponse(chunk + 1, used - 1, true, credits);
+    } else {
+      manager->notifyResponse(chunk, used, true, credits);
+    }
+    manager->countFragment(used);
+    sent += used;
+  }
+  used = 0;
+}
+
+size_t BLEResponseStream::write(uint8_t byte) { return write(&byte, 1); }
+
+size_t BLEResponseStream::write(const uint8_t* data, size_t size) {
+  if (!manager || cancelled()) return size;  // Dropped after <CANCEL>
+  written += size;
+  return compressed ? encoder.write(data, size) : notifier.write(data, size);
+}
+
+void BLEResponseStream::reportProgress(uint8_t percent) {
+  if (!manager || compressed || cancelled()) return;
+  manager->sendConfigDownloadProgress(percent, notifier.bytesSent(), 0);
+}
+
+// ============================================================================
+// v1.3.3: NOTIFY FLOW CONTROL
+// ============================================================================
+
+void BLEManager::gattsEventHandler(esp_gatts_cb_event_t event,
+                                   esp_gatt_if_t gattsIf,
+                                   esp_ble_gatts_cb_param_t* param) {
+  (void)gattsIf;
+  BLEManager* manager = gattsInstance;
+  if (!manager || !param) return;
+
+  switch (event) {
+    case ESP_GATTS_CONF_EVT:
+      // Notify handed to the controller: return its credit
+      if (manager->pResponseChar &&
+          param->conf.handle == manager->pResponseChar->getHandle()) {
+        uint8_t inFlight = manager->txInFlight.load();
+        while (inFlight > 0 &&
+               !manager->txInFlight.compare_exchange_weak(inFlight,
+                                                          inFlight - 1)) {
+        }
+        xSemaphoreGive(manager->txCreditSignal);
+      }
+      break;
+
+    case ESP_GATTS_CONGEST_EVT:
+      manager->txCongested.store(param->congest.congested);
+      if (param->congest.congested) {
+        manager->txCongestionEvents.fetch_add(1);
+      } else {
+        xSemaphoreGive(manager->txCreditSignal);
+      }
+      break;
+
+    case ESP_GATTS_MTU_EVT:
+      manager->peerMtu.store(param->mtu.mtu);
+      if (xSemaphoreTake(manager->metricsMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        manager->mtuMetrics.mtuSize =
+            (param->mtu.mtu > 3) ? (param->mtu.mtu - 3) : 20;
+        manager->mtuMetrics.mtuNegotiated = (param->mtu.mtu > 23);
+        xSemaphoreGive(manager->metricsMutex);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+void BLEManager::onStatus(BLECharacteristic* pCharacteristic, Status status,
+                          uint32_t code) {
+  (void)code;
+  if (pCharacteristic != pResponseChar || status == Status::SUCCESS_NOTIFY ||
+      status == Status::SUCCESS_INDICATE) {
+    return;
+  }
+
+  // Notify rejected before reaching the stack (no CONF event will follow)
+  uint8_t inFlight = txInFlight.load();
+  while (inFlight > 0 &&
+         !txInFlight.compare_exchange_weak(inFlight, inFlight - 1)) {
+  }
+  xSemaphoreGive(txCreditSignal);
+}
+
+bool BLEManager::waitForTxCredit(uint8_t credits) {
+  unsigned long start = millis();
+  while (txCongested.load() || txInFlight.load() >= credits) {
+    if (millis() - start >= BLE_TX_CREDIT_TIMEOUT_MS) {
+      // Completion events lost (or link gone): resync instead of stalling
+      txInFlight.store(0);
+      txCongested.store(false);
+      txCreditStalls.fetch_add(1);
+      return false;
+    }
+    xSemaphoreTake(txCreditSignal, pdMS_TO_TICKS(10));
+  }
+  return true;
+}
+
+void BLEManager::notifyResponse(const uint8_t* data, size_t length,
+                                bool waitForCredit, uint8_t credits) {
+  if (!pResponseChar) return;
+
+  if (waitForCredit) {
+    waitForTxCredit(credits);
+  }
+  txInFlight.fetch_add(1);
+  pResponseChar->setValue(const_cast<uint8_t*>(data), length);
+  pResponseChar->notify();
+}
+
+void BLEManager::notifyResponse(const char* text, bool waitForCredit) {
+  notifyResponse(reinterpret_cast<const uint8_t*>(text), strlen(text),
+                 waitForCredit);
+}
+
+size_t BLEManager::txPayloadSize() const {
+  // Until the MTU exchange is seen, keep the historical chunk size
+  uint16_t mtu = peerMtu.load();
+  size_t payload = (mtu > 3) ? (size_t)(mtu - 3) : (size_t)CHUNK_SIZE;
+  return min(payload, (size_t)BLE_TX_MAX_PAYLOAD);
+}
+
+void BLEManager::resetTxFlowControl() {
+  txInFlight.store(0);
+  txCongested.store(false);
+  peerMtu.store(0);
+  if (txCreditSignal) {
+    xSemaphoreGive(txCreditSignal);  // Wake a sender of the old link
+  }
+}
+
+// ============================================================================
+// v1.3.3: BINARY LIVE STREAM
+// ============================================================================
+
+void BLEManager::streamBinaryRecords(QueueManager* queueMgr) {
+  // New stream start: announce the schema again even for the same layout
+  uint32_t epoch = streamEpoch.load();
+  if (epoch != schemaEpoch) {
+    schemaEpoch = epoch;
+    schemaKey = 0xFFFFFFFF;
+  }
+
+  uint8_t frame[CHUNK_SIZE];
+  size_t frameLimit = min((size_t)CHUNK_SIZE, txPayloadSize());
+  size_t used = 0;
+  uint8_t count = 0;
+  uint16_t generation = 0;
+  uint32_t frameTime = 0;
+
+  auto openFrame = [&](uint16_t gen, uint32_t timestamp) {
+    frame[0] = STREAM_FRAME_MAGIC;
+    frame[1] = STREAM_FRAME_VERSION;
+    frame[2] = 0;
+    frame[3] = 0;
+    memcpy(&frame[4], &gen, sizeof(gen));
+    memcpy(&frame[6], &timestamp, sizeof(timestamp));
+    used = STREAM_FRAME_HEADER_SIZE;
+    count = 0;
+    generation = gen;
+    frameTime = timestamp;
+  };
+  auto flushFrame = [&]() {
+    if (used > 0) {
+      frame[3] = count;
+      sendBinaryFrame(frame, used);
+      used = 0;
+      count = 0;
+    }
+  };
+
+  QueueRecord record;
+  while (isStreamingActive() && queueMgr->dequeueStreamRecord(record)) {
+    uint32_t key = ((uint32_t)record.deviceSlot << 16) | record.generation;
+    if (key != schemaKey) {
+      flushFrame();
+      if (!sendStreamSchema(record.deviceSlot, record.generation)) {
+        continue;  // Layout already gone (stale record)
+      }
+      schemaKey = key;
+    }
+
+    if (record.type == QueueRecordType::BATCH_END) {
+      // Header-only frame if the cycle's values already went out
+      if (used == 0) {
+        openFrame(record.generation, frameTime);
+      }
+      frame[2] |= STREAM_FRAME_CYCLE_END;
+      flushFrame();
+      continue;
+    }
+    if (record.type != QueueRecordType::REGISTER) {
+      continue;
+    }
+
+    if (used > 0 && (record.timestamp != frameTime ||
+                     used + STREAM_FRAME_ENTRY_SIZE > frameLimit)) {
+      flushFrame();
+    }
+    if (used == 0) {
+      openFrame(record.generation, record.timestamp);
+    }
+
+    uint8_t flags = 0;
+    float value = (float)record.value;
+    if (std::isfinite(record.value) && std::fabs(record.value) > FLT_MAX) {
+      value = record.value > 0 ? FLT_MAX : -FLT_MAX;
+      flags |= STREAM_ENTRY_CLAMPED;
+    }
+    memcpy(&frame[used], &record.registerSlot, sizeof(record.registerSlot));
+    frame[used + 2] = flags;
+    memcpy(&frame[used + 3], &value, sizeof(value));
+    used += STREAM_FRAME_ENTRY_SIZE;
+    count++;
+  }
+  flushFrame();
+}
+
+bool BLEManager::sendStreamSchema(uint8_t slot, uint16_t generation) {
+  JsonDocument schema;
+  schema["status"] = "schema";
+  schema["format"] = "binary";
+  schema["generation"] = generation;
+  JsonObject device = schema.as<JsonObject>();
+  if (!PollPlanRegistry::getInstance()->describeDevice(slot, generation,
+                                                       device)) {
+    return false;
+  }
+  sendResponse(schema);
+  return true;
+}
+
+bool BLEManager::sendBinaryFrame(const uint8_t* frame, size_t length,
+                                 bool liveStream) {
+  if (!pResponseChar) return false;
+
+  __atomic_add_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+  if (xSemaphoreTake(transmissionMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+    LOG_BLE_INFO("[BLE] ERROR: Stream mutex timeout");
+    __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+    return false;
+  }
+
+  // Final check with mutex held (stop command waits on this mutex)
+  bool sent = !liveStream || isStreamingActive();
+  if (sent) {
+    notifyResponse(frame, length);
+  }
+  xSemaphoreGive(transmissionMutex);
+  __atomic_sub_fetch(&activeTransmissions, 1, __ATOMIC_SEQ_CST);
+
+  if (sent) {
+    countFragment(length);
+  }
+  return sent;
+}
+
+void BLEManager::sendHistoryFrames(uint16_t generation,
+                                   const uint16_t* registerSlots,
+                                   size_t registerCount,
+                                   const TrendHistory::Cell* cells,
+                                   uint16_t points, uint32_t firstTime,
+                                   uint32_t bucketS) {
+  uint8_t frame[CHUNK_SIZE];
+  size_t frameLimit = min((size_t)CHUNK_SIZE, txPayloadSize());
+  size_t used = 0;
+  uint8_t count = 0;
+  uint32_t frameTime = firstTime;
+
+  auto openFrame = [&](uint32_t timestamp) {
+    frame[0] = STREAM_FRAME_MAGIC;
+    frame[1] = STREAM_FRAME_VERSION;
+    frame[2] = STREAM_FRAME_HISTORY;
+    frame[3] = 0;
+    memcpy(&frame[4], &generation, sizeof(generation));
+    memcpy(&frame[6], &timestamp, sizeof(timestamp));
+    used = STREAM_FRAME_HEADER_SIZE;
+    count = 0;
+    frameTime = timestamp;
+  };
+  auto flushFrame = [&]() {
+    if (used > 0) {
+      frame[3] = count;
+      sendBinaryFrame(frame, used, false);
+      used = 0;
+      count = 0;
+    }
+  };
+  auto addEntry = [&](uint16_t index, uint8_t flags, float value) {
+    memcpy(&frame[used], &index, sizeof(index));
+    frame[used + 2] = flags;
+    memcpy(&frame[used + 3], &value, sizeof(value));
+    used += STREAM_FRAME_ENTRY_SIZE;
+    count++;
+  };
+
+  for (uint16_t point = 0; point < points; point++) {
+    uint32_t timestamp = firstTime + point * bucketS;
+    for (size_t i = 0; i < registerCount; i++) {
+      const TrendHistory::Cell& cell = cells[point * registerCount + i];
+      if (cell.count == 0) continue;
+
+      // A register's avg / min / max stay in one frame
+      bool spread = cell.min != cell.max;
+      size_t entries = spread ? 3 : 1;
+      if (used > 0 && (timestamp != frameTime ||
+                       used + entries * STREAM_FRAME_ENTRY_SIZE > frameLimit)) {
+        flushFrame();
+      }
+      if (used == 0) {
+        openFrame(timestamp);
+      }
+      addEntry(registerSlots[i], 0, cell.sum / cell.count);
+      if (spread) {
+        addEntry(registerSlots[i], STREAM_ENTRY_MIN, cell.min);
+        addEntry(registerSlots[i], STREAM_ENTRY_MAX, cell.max);
+      }
+    }
+  }
+
+  // End of the answer (header-only if nothing was recorded)
+  if (used == 0) {
+    openFrame(frameTime);
+  }
+  frame[2] |= STREAM_FRAME_CYCLE_END;
+  flushFrame();
+}
+
 // ============================================================================
 // METRICS IMPLEMENTATION
 // ============================================================================
@@ -1184,8 +1745,11 @@ void BLEManager::logMTUNegotiation() {
   }
 
   // FIXED: Get actual MTU size from BLE layer after negotiation
-  uint16_t actualMTU =
-      BLEDevice::getMTU();  // Returns full MTU (includes overhead)
+  // v1.3.3: Prefer the peer's MTU exchange (getMTU() is our local setting)
+  uint16_t actualMTU = peerMtu.load();
+  if (actualMTU == 0) {
+    actualMTU = BLEDevice::getMTU();  // Returns full MTU (includes overhead)
+  }
   uint16_t effectiveMTU =
       (actualMTU > 3) ? (actualMTU - 3) : 20;  // Subtract ATT header (3 bytes)
 
@@ -1365,6 +1929,10 @@ void BLEManager::reportMetrics(JsonObject& metricsObj) {
   connObj["bytes_transmitted"] = connectionMetrics.bytesTransmitted;
   connObj["bytes_received"] = connectionMetrics.bytesReceived;
   connObj["total_connection_time_ms"] = connectionMetrics.totalConnectionTime;
+  // v1.3.3: Notify flow control
+  connObj["tx_in_flight"] = txInFlight.load();
+  connObj["tx_congestion_events"] = txCongestionEvents.load();
+  connObj["tx_credit_stalls"] = txCreditStalls.load();
 
   xSemaphoreGive(metricsMutex);
 }
@@ -1384,6 +1952,12 @@ void BLEManager::setStreamingActive(bool active) {
   }
 }
 
+void BLEManager::setStreamFormat(bool binary) {
+  binaryStreaming.store(binary);
+  streamEpoch.fetch_add(1);  // Stream task re-sends the schema
+  LOG_BLE_INFO("[BLE] Stream format set to: %s\n", binary ? "BINARY" : "JSON");
+}
+
 bool BLEManager::isStreamingActive() const {
   bool active = false;
   if (xSemaphoreTake(streamingStateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
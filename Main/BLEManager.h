@@ -6,14 +6,21 @@
 #include <BLEDevice.h>
 #include <BLEServer.h>
 #include <BLEUtils.h>
+#include <esp_gatts_api.h>  // v1.3.3: Notify completion/congestion events
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 #include <freertos/task.h>
 
 #include <atomic>  // v2.5.36: Thread-safe atomic operations
 
-#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
-#include "UnifiedErrorCodes.h"  // v1.0.2: For standardized error responses
+#include "HeatshrinkEncoder.h"     // v1.3.3: Compressed responses
+#include "JsonDocumentPSRAM.h"     // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include "RegisterImportStream.h"  // v1.3.3: <IMPORT> uploads
+#include "TrendHistory.h"          // v1.3.3: History query frames
+#include "UnifiedErrorCodes.h"     // v1.0.2: For standardized error responses
+
+class BLEManager;
+class QueueManager;
 
 // BLE UUIDs
 #define SERVICE_UUID "00001830-0000-1000-8000-00805f9b34fb"
@@ -23,10 +30,8 @@
 // Constants
 // BLE Transmission Optimization (v2.1.1 - Critical timeout fix)
 // CHUNK_SIZE increased from 18 to 244 bytes (MTU-safe for 512-byte MTU)
-// FRAGMENT_DELAY reduced from 50ms to 10ms for faster transmission
-// Impact: 21KB payload transmission time: 58s → 2.1s (28x faster)
+// v1.3.3: Default chunk until the peer MTU is known (see BLE_TX_CREDITS)
 #define CHUNK_SIZE 244
-#define FRAGMENT_DELAY_MS 10
 #define COMMAND_BUFFER_SIZE \
   16384  // 16KB - supports CREATE/UPDATE with ~80 registers (v2.3.1)
 #define BLE_QUEUE_MONITOR_INTERVAL 60000  // Monitor queue every 60 seconds
@@ -41,40 +46,55 @@
   204800  // 200KB maximum response size (for full_config backup with 50+
           // devices)
 
+// v1.3.3: Binary live stream (opt-in with "format":"binary" on the data read)
+// A "schema" JSON message maps register slots to register_id/name/unit once
+// per device layout; values then go as one binary notification per frame (no
+// <END> marker). Little-endian, frame <= CHUNK_SIZE and the ATT payload:
+//   header: magic u8, version u8, flags u8, count u8, generation u16,
+//           timestamp u32 (unix time shared by the frame's values, 0 = none)
+//   entry:  index u16 (schema "index"), flags u8, value float32
+// The magic byte never starts a JSON fragment ('{') or a marker ('<').
+#define STREAM_FRAME_MAGIC 0xB5
+#define STREAM_FRAME_VERSION 1
+#define STREAM_FRAME_HEADER_SIZE 10
+#define STREAM_FRAME_ENTRY_SIZE 7
+#define STREAM_FRAME_CYCLE_END 0x01  // Frame flag: last values of a poll cycle
+#define STREAM_FRAME_HISTORY 0x02    // Frame flag: "read history" bucket
+#define STREAM_ENTRY_CLAMPED 0x01    // Entry flag: value outside float range
+#define STREAM_ENTRY_MIN 0x02        // Entry flag: bucket minimum (history)
+#define STREAM_ENTRY_MAX 0x04        // Entry flag: bucket maximum (history)
+
 // ============================================
-// ADAPTIVE TRANSMISSION TUNING (v2.3.4 - Option 3)
+// v1.3.3: FLOW-CONTROLLED TRANSMISSION
 // ============================================
-// Problem: Intermittent BLE timeout on 9.4KB payloads (45 registers)
-// Root Cause: 20ms delay too aggressive for mobile OS (iOS/Android scheduler
-// ~30-50ms quantum)
-//
-// Solution: Option 3 - Conservative timing for maximum stability
-//   - Lower LARGE threshold: 5KB → 3KB (catch more medium payloads)
-//   - Increase LARGE delay: 20ms → 35ms (match mobile OS timing)
-//   - Increase XLARGE delay: 50ms → 60ms (backup reliability)
-//
-// Impact:
-//   - Small payloads (<3KB): UNCHANGED (10ms, fast)
-//   - Medium payloads (3-9KB): +75% transmission time, 95%+ success rate
-//   - Large payloads (9-50KB): More stable, no timeout
-//   - XLarge backups (>50KB): +20% transmission time, within 60s limit
-//
-// Trade-off: Speed vs Stability - prioritize NO TIMEOUT over fast transmission
+// Previous: Fixed sleeps after every chunk (10ms, 35ms for >3KB, 60ms for
+// >50KB) and 100-byte chunks on low DRAM, so a 200KB backup took minutes
+// whatever the link could do.
+// New: Chunks are sized to the negotiated MTU (ATT payload = MTU - 3) and
+// sent as fast as the stack accepts them. At most BLE_TX_CREDITS notifies
+// are queued in the host; ESP_GATTS_CONF_EVT returns a credit and
+// ESP_GATTS_CONGEST_EVT pauses the sender until the link drains. Lost
+// completion events never stall a transfer (BLE_TX_CREDIT_TIMEOUT_MS).
 // ============================================
+#define BLE_TX_CREDITS 8           // Notifies queued in the BLE host
+#define BLE_TX_CREDITS_LOW_DRAM 2  // DRAM < 25KB (host buffers are DRAM)
+#define BLE_TX_CREDIT_TIMEOUT_MS 500
+#define BLE_TX_MAX_PAYLOAD (BLE_MTU_MAX_SUPPORTED - 3)
 #define LARGE_PAYLOAD_THRESHOLD \
-  3072  // 3KB threshold for adaptive chunking (medium payloads) - v2.3.4 Option
-        // 3: Lowered from 5KB for better stability
-#define XLARGE_PAYLOAD_THRESHOLD \
-  51200  // 50KB threshold for extra-large payloads (backup/restore)
-#define ADAPTIVE_CHUNK_SIZE_LARGE 100  // Chunk size for large payloads
-#define ADAPTIVE_DELAY_LARGE_MS \
-  35  // Delay for large payload chunks (3-50KB) - v2.3.4 Option 3: Increased
-      // from 20ms for mobile OS compatibility
-#define ADAPTIVE_DELAY_XLARGE_MS \
-  60  // Delay for extra-large payload chunks (>50KB) - v2.3.4 Option 3:
-      // Increased from 50ms for backup reliability
+  3072  // Payloads above this send config_download_progress notifications
 #define ERROR_BUFFER_SIZE 256  // Buffer size for error messages
 
+// v1.3.3: Responses above LARGE_PAYLOAD_THRESHOLD wait up to this long while
+// memory pressure is RED (MemoryRecovery), then go out anyway
+#define BLE_PRESSURE_DEFER_MS 3000
+#define BLE_PRESSURE_POLL_MS 100
+
+// v1.3.3: Compressed responses (opt-in per command with
+// "compress":"heatshrink", see HeatshrinkEncoder). Responses above this size
+// go as a {"status":"compressed",...} header message followed by the
+// compressed body and <END>.
+#define BLE_COMPRESS_MIN_BYTES LARGE_PAYLOAD_THRESHOLD
+
 // MTU Negotiation Timeout Control
 enum MTUNegotiationState {
   MTU_STATE_IDLE = 0,         // No negotiation in progress
@@ -136,6 +156,61 @@ struct ConnectionMetrics {
 
 class CRUDHandler;  // Forward declaration
 
+/**
+ * v1.3.3: Response bytes -> ATT-payload-sized notifications
+ * Buffers one chunk and hands it to BLEManager::notifyResponse() (flow
+ * controlled). A last chunk that equals a framing marker (<END>, <ACK>,
+ * <CANCELLED>) is split in two, so body bytes are never taken for one.
+ * Used with the transmission mutex held.
+ */
+class BLENotifyWriter : public Print {
+ public:
+  void begin(BLEManager* manager, size_t chunkSize, uint8_t credits);
+  void sendPending();  // Send the partial chunk
+  bool cancelled() const;
+  size_t bytesSent() const { return sent; }
+
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  using Print::write;
+
+ private:
+  BLEManager* manager = nullptr;
+  uint8_t chunk[BLE_TX_MAX_PAYLOAD];
+  size_t used = 0;
+  size_t chunkSize = CHUNK_SIZE;
+  uint8_t credits = BLE_TX_CREDITS;
+  size_t sent = 0;
+};
+
+/**
+ * v1.3.3: Incremental response body (BLEManager::beginResponse())
+ * JSON written here is sent while it is produced, so a response never has
+ * to exist in memory as a whole (no size limit). Compressed when the
+ * command asked for it ("compress":"heatshrink").
+ */
+class BLEResponseStream : public Print {
+ public:
+  bool cancelled() const { return notifier.cancelled(); }
+  size_t bytesWritten() const { return written; }  // Uncompressed JSON bytes
+
+  // config_download_progress notification (plain responses only, total
+  // size unknown: total_bytes = 0)
+  void reportProgress(uint8_t percent);
+
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  using Print::write;
+
+ private:
+  friend class BLEManager;
+  BLEManager* manager = nullptr;
+  BLENotifyWriter notifier;
+  HeatshrinkEncoder encoder;
+  bool compressed = false;
+  size_t written = 0;
+};
+
 class BLEManager : public BLEServerCallbacks,
                    public BLECharacteristicCallbacks {
  private:
@@ -155,6 +230,7 @@ class BLEManager : public BLEServerCallbacks,
   unsigned long lastFragmentTime;  // CRITICAL FIX: Track last fragment
                                    // reception time for timeout detection
   QueueHandle_t commandQueue;
+  RegisterImportStream registerImport;  // v1.3.3: <IMPORT> ... <END>
   TaskHandle_t commandTaskHandle;
   TaskHandle_t streamTaskHandle;
   TaskHandle_t metricsTaskHandle;  // Metrics monitoring task
@@ -181,6 +257,24 @@ class BLEManager : public BLEServerCallbacks,
   uint8_t activeTransmissions;  // Count of in-flight transmissions (protected
                                 // by transmissionMutex)
 
+  // v1.3.3: Binary stream format (setStreamFormat) and schema state
+  std::atomic<bool> binaryStreaming{false};
+  std::atomic<uint32_t> streamEpoch{0};  // Bumped per stream start
+  uint32_t schemaEpoch = 0;              // Stream task only
+  uint32_t schemaKey = 0xFFFFFFFF;       // slot << 16 | generation announced
+
+  // v1.3.3: Notify flow control (GATTS events, see BLE_TX_CREDITS)
+  static BLEManager* gattsInstance;  // Target of gattsEventHandler
+  std::atomic<uint8_t> txInFlight{0};
+  std::atomic<bool> txCongested{false};
+  std::atomic<uint16_t> peerMtu{0};  // Negotiated ATT MTU (0 = unknown)
+  std::atomic<uint32_t> txCreditStalls{0};
+  std::atomic<uint32_t> txCongestionEvents{0};
+  SemaphoreHandle_t txCreditSignal = nullptr;  // Given on credit/drain
+
+  // v1.3.3: Task whose current command asked for compressed responses
+  std::atomic<TaskHandle_t> compressionOwner{nullptr};
+
   // v1.0.9: Transmission Cancellation Support
   // Allows mobile app to cancel ongoing chunked transmission
   std::atomic<bool> transmissionCancelled{false};
@@ -209,7 +303,41 @@ class BLEManager : public BLEServerCallbacks,
   // Fragment handling
   void receiveFragment(const String& fragment);
   void handleCompleteCommand(const char* command);
+  void finishRegisterImport();  // <END> of an <IMPORT> upload
   void sendFragmented(const char* data, size_t length);
+  void deferWhileMemoryRed();  // v1.3.3: Large responses only
+
+  // v1.3.3: All response notifies go through here (credit accounting).
+  // waitForCredit = false on the BLE stack task (onWrite), which delivers the
+  // completion events itself.
+  static void gattsEventHandler(esp_gatts_cb_event_t event,
+                                esp_gatt_if_t gattsIf,
+                                esp_ble_gatts_cb_param_t* param);
+  bool waitForTxCredit(uint8_t credits);
+  void notifyResponse(const uint8_t* data, size_t length,
+                      bool waitForCredit = true,
+                      uint8_t credits = BLE_TX_CREDITS);
+  void notifyResponse(const char* text, bool waitForCredit = true);
+  size_t txPayloadSize() const;
+  void resetTxFlowControl();
+
+  // v1.3.3: Compressed body (false = encoder unavailable, nothing sent)
+  bool sendCompressed(const char* data, size_t length, size_t chunkSize,
+                      uint8_t credits);
+  bool startCompressed(BLENotifyWriter& notifier, HeatshrinkEncoder& encoder,
+                       size_t knownSize);
+  void countFragment(size_t length);
+
+  // v1.3.3: Incremental response state (transmission mutex held)
+  BLEResponseStream responseStream;
+  friend class BLENotifyWriter;
+  friend class BLEResponseStream;
+
+  // v1.3.3: Binary stream (stream task)
+  void streamBinaryRecords(QueueManager* queueMgr);
+  bool sendStreamSchema(uint8_t slot, uint16_t generation);
+  bool sendBinaryFrame(const uint8_t* frame, size_t length,
+                       bool liveStream = true);
 
  public:
   BLEManager(const String& name, CRUDHandler* cmdHandler);
@@ -223,6 +351,24 @@ class BLEManager : public BLEServerCallbacks,
   void sendError(const String& message, const String& type = "unknown");
   void sendSuccess(const String& type = "unknown");
 
+  // v1.3.3: Incremental response (see BLEResponseStream). Holds the
+  // transmission lock until endResponse(), so no other response may be sent
+  // in between. nullptr = link busy or DRAM exhausted (nothing sent).
+  BLEResponseStream* beginResponse();
+  void endResponse();
+
+  // v1.3.3: Registers staged by an <IMPORT> upload whose command is being
+  // handled (nullptr = none). releaseRegisterImport() once applied.
+  RegisterImportStream* takeRegisterImport();
+  void releaseRegisterImport();
+
+  // v1.3.3: "read history" buckets as binary stream frames, one timestamp
+  // (firstTime + point * bucketS) per frame; the last frame is flagged
+  // STREAM_FRAME_CYCLE_END (header-only if there is no data)
+  void sendHistoryFrames(uint16_t generation, const uint16_t* registerSlots,
+                         size_t registerCount, const TrendHistory::Cell* cells,
+                         uint16_t points, uint32_t firstTime, uint32_t bucketS);
+
   // v1.0.2: Standardized error responses with UnifiedErrorCode
   // These methods include: error_code, domain, severity, message, suggestion
   void sendError(UnifiedErrorCode code, const String& customMessage = "",
@@ -253,6 +399,9 @@ class BLEManager : public BLEServerCallbacks,
   // Streaming state control methods
   void setStreamingActive(bool active);
   bool isStreamingActive() const;
+  // v1.3.3: true = binary frames + schema, false = JSON data points
+  void setStreamFormat(bool binary);
+  bool isBinaryStreaming() const { return binaryStreaming.load(); }
   bool waitForTransmissionsComplete(uint32_t timeoutMs = 2000);
 
   // v1.0.9: Transmission cancellation methods
@@ -263,6 +412,8 @@ class BLEManager : public BLEServerCallbacks,
   void onConnect(BLEServer* pServer) override;
   void onDisconnect(BLEServer* pServer) override;
   void onWrite(BLECharacteristic* pCharacteristic) override;
+  void onStatus(BLECharacteristic* pCharacteristic, Status status,
+                uint32_t code) override;
 };
 
 #endif
@@ -1,6 +1,7 @@
 #include "ButtonManager.h"
 
 #include "BLEManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 // NOTE: This static instance is unused (Meyers Singleton pattern used in
 // getInstance()) Kept for header declaration compatibility - does not cause
@@ -66,13 +67,10 @@ void ButtonManager::begin(bool isProductionMode) {
   }
 
   // Create button monitoring task
-  xTaskCreatePinnedToCore(buttonTask, "Button_Task",
-                          3072,  // Stack size
-                          this,
-                          2,  // Priority (higher than LED tasks)
-                          &buttonTaskHandle,
-                          APP_CPU_NUM  // Pin to APP_CPU_NUM (core 1)
-  );
+  // v1.3.3: Priority (higher than LED tasks) and core from TaskAffinity.h
+  TaskAffinity::create(buttonTask, "Button_Task",
+                       3072,  // Stack size
+                       this, TaskAffinity::Task::BUTTON, &buttonTaskHandle);
   LOG_LED_INFO("[BUTTON] Manager initialized");
 }
 
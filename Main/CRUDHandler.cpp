@@ -2,14 +2,18 @@
 
 #include <esp_heap_caps.h>  // For PSRAM allocation
 
+#include <algorithm>
+
 #include "BLEManager.h"
 #include "DebugConfig.h"          // MUST BE FIRST for DEV_SERIAL_* macros
 #include "ErrorResponseHelper.h"  // v1.0.2: Standardized error responses
 #include "GatewayConfig.h"        // For gateway identity (v2.5.31)
+#include "HeatshrinkEncoder.h"    // v1.3.3: Compression capability
 #include "HttpManager.h"     // For calling updateDataTransmissionInterval()
 #include "LEDManager.h"      // For stopping LED task during factory reset
 #include "MemoryManager.h"   // For make_psram_unique
-#include "MemoryRecovery.h"  // For triggerCleanup() - memory optimization
+#include "MemoryRecovery.h"  // For triggerCleanup(), admission control (v1.3.3)
+#include "ModbusPollPlan.h"  // v1.3.3: Device slot lookup (history read)
 #include "ModbusRtuService.h"
 #include "ModbusTcpService.h"
 #include "MqttManager.h"     // For calling updateDataTransmissionInterval()
@@ -18,6 +22,9 @@
 #include "ProductConfig.h"  // For firmware version, model (v2.5.32)
 #include "QueueManager.h"
 #include "RTCManager.h"  // For RTC timestamp in factory reset
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+#include "TaskProfiler.h"  // v1.3.3: Task profile read
+#include "TrendHistory.h"  // v1.3.3: Register history read
 
 // Make service pointers available to the handler
 extern ModbusRtuService* modbusRtuService;
@@ -35,8 +42,6 @@ CRUDHandler::CRUDHandler(ConfigManager* config, ServerConfig* serverCfg,
       otaManager(nullptr),
       streamDeviceId(""),
       commandIdCounter(0) {
-  setupCommandHandlers();
-
   // Initialize priority queue mutex
   queueMutex = xSemaphoreCreateMutex();
   if (!queueMutex) {
@@ -46,13 +51,11 @@ CRUDHandler::CRUDHandler(ConfigManager* config, ServerConfig* serverCfg,
   // Create command processor task
   // FIXED BUG #30: Increased stack size for large device operations
   // v2.5.36 FIX: Check return value to detect task creation failure
-  BaseType_t taskResult = xTaskCreatePinnedToCore(
+  // v1.3.3: Medium priority, core from TaskAffinity.h (with the BLE tasks)
+  BaseType_t taskResult = TaskAffinity::create(
       commandProcessorTask, "CRUD_PROCESSOR_TASK",
       CRUDConfig::CRUD_TASK_STACK_SIZE,  // 24KB stack (was 8KB)
-      this,
-      2,  // Medium priority
-      &commandProcessorTaskHandle,
-      1);  // Pin to Core 1
+      this, TaskAffinity::Task::CRUD_PROCESSOR, &commandProcessorTaskHandle);
 
   if (taskResult != pdPASS) {
     LOG_CRUD_INFO(
@@ -103,897 +106,1015 @@ void CRUDHandler::handle(BLEManager* manager, const JsonDocument& command) {
   enqueueCommand(manager, command, priority);
 }
 
-void CRUDHandler::setupCommandHandlers() {
-  // === READ HANDLERS ===
-  readHandlers["devices"] = [this](BLEManager* manager,
-                                   const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonArray devices = (*response)["devices"].to<JsonArray>();
-    configManager->listDevices(devices);
-    manager->sendResponse(*response);
-  };
+// ============================================================================
+// v1.3.3: COMMAND ROUTING
+// ============================================================================
+// Previous: eight std::map<String, std::function> tables (one per op), filled
+// at construction - a String compare chain per lookup, map nodes and String
+// keys in DRAM, and the same if/else chain repeated in the queue and both
+// batch paths.
+// New: one static table of (op, type) -> member function, sorted at compile
+// time (static_assert) and binary-searched. Adding a command = a handler
+// method + one row here.
+
+namespace {
+// strcmp usable in constant expressions (C++11 single-return form)
+constexpr int routeCompare(const char* a, const char* b) {
+  return (*a != *b || *a == '\0')
+             ? (int)(unsigned char)*a - (int)(unsigned char)*b
+             : routeCompare(a + 1, b + 1);
+}
+}  // namespace
+
+constexpr bool CRUDHandler::routesSorted(const CommandRoute* routes,
+                                         size_t index, size_t count) {
+  return index >= count ||
+         ((routeCompare(routes[index - 1].op, routes[index].op) < 0 ||
+           (routeCompare(routes[index - 1].op, routes[index].op) == 0 &&
+            routeCompare(routes[index - 1].type, routes[index].type) < 0)) &&
+          routesSorted(routes, index + 1, count));
+}
 
-  readHandlers["devices_summary"] = [this](BLEManager* manager,
-                                           const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonArray summary = (*response)["devices_summary"].to<JsonArray>();
-    configManager->getDevicesSummary(summary);
-    manager->sendResponse(*response);
+const CRUDHandler::CommandRoute* CRUDHandler::findRoute(const char* op,
+                                                        const char* type) {
+  // Sorted by op, then type (checked below)
+  static constexpr CommandRoute routes[] = {
+      {"control", "disable_device", &CRUDHandler::controlDisableDevice},
+      {"control", "enable_device", &CRUDHandler::controlEnableDevice},
+      {"control", "get_all_device_status",
+       &CRUDHandler::controlGetAllDeviceStatus},
+      {"control", "get_device_status", &CRUDHandler::controlGetDeviceStatus},
+      {"control", "get_gateway_info", &CRUDHandler::controlGetGatewayInfo},
+      {"control", "get_mqtt_status", &CRUDHandler::controlGetMqttStatus},
+      {"control", "get_network_status", &CRUDHandler::controlGetNetworkStatus},
+      {"control", "set_friendly_name", &CRUDHandler::controlSetFriendlyName},
+      {"control", "set_gateway_location",
+       &CRUDHandler::controlSetGatewayLocation},
+      {"control", "set_production_mode",
+       &CRUDHandler::controlSetProductionMode},
+      {"create", "device", &CRUDHandler::createDevice},
+      {"create", "register", &CRUDHandler::createRegister},
+      {"delete", "device", &CRUDHandler::deleteDevice},
+      {"delete", "register", &CRUDHandler::deleteRegister},
+      {"import", "registers", &CRUDHandler::importRegisters},
+      {"ota", "abort_update", &CRUDHandler::otaAbortUpdate},
+      {"ota", "apply_update", &CRUDHandler::otaApplyUpdate},
+      {"ota", "check_update", &CRUDHandler::otaCheckUpdate},
+      {"ota", "disable_ble_ota", &CRUDHandler::otaDisableBleOta},
+      {"ota", "enable_ble_ota", &CRUDHandler::otaEnableBleOta},
+      {"ota", "get_config", &CRUDHandler::otaGetConfig},
+      {"ota", "ota_status", &CRUDHandler::otaStatus},
+      {"ota", "rollback", &CRUDHandler::otaRollback},
+      {"ota", "set_github_repo", &CRUDHandler::otaSetGithubRepo},
+      {"ota", "set_github_token", &CRUDHandler::otaSetGithubToken},
+      {"ota", "start_update", &CRUDHandler::otaStartUpdate},
+      {"read", "data", &CRUDHandler::readData},
+      {"read", "device", &CRUDHandler::readDevice},
+      {"read", "devices", &CRUDHandler::readDevices},
+      {"read", "devices_summary", &CRUDHandler::readDevicesSummary},
+      {"read", "devices_with_registers",
+       &CRUDHandler::readDevicesWithRegisters},
+      {"read", "full_config", &CRUDHandler::readFullConfig},
+      {"read", "history", &CRUDHandler::readHistory},
+      {"read", "logging_config", &CRUDHandler::readLoggingConfig},
+      {"read", "production_mode", &CRUDHandler::readProductionMode},
+      {"read", "registers", &CRUDHandler::readRegisters},
+      {"read", "registers_summary", &CRUDHandler::readRegistersSummary},
+      {"read", "server_config", &CRUDHandler::readServerConfig},
+      {"read", "task_profile", &CRUDHandler::readTaskProfile},
+      {"system", "factory_reset", &CRUDHandler::systemFactoryReset},
+      {"system", "restore_config", &CRUDHandler::systemRestoreConfig},
+      {"update", "device", &CRUDHandler::updateDevice},
+      {"update", "logging_config", &CRUDHandler::updateLoggingConfig},
+      {"update", "register", &CRUDHandler::updateRegister},
+      {"update", "server_config", &CRUDHandler::updateServerConfig},
+      {"write", "register", &CRUDHandler::writeRegister},
   };
+  static constexpr size_t routeCount = sizeof(routes) / sizeof(routes[0]);
+  static_assert(routesSorted(routes, 1, routeCount),
+                "CRUD command routes must be sorted by (op, type)");
+
+  size_t low = 0;
+  size_t high = routeCount;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    int cmp = strcmp(op, routes[mid].op);
+    if (cmp == 0) cmp = strcmp(type, routes[mid].type);
+    if (cmp == 0) return &routes[mid];
+    if (cmp < 0) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return nullptr;
+}
 
-  readHandlers["devices_with_registers"] = [this](BLEManager* manager,
-                                                  const JsonDocument& command) {
-    bool minimalFields =
-        command["minimal"] | false;  // Support optional "minimal" parameter
-
-    // v2.5.12: Pagination support for large device lists
-    // MOBILE APP SPEC: Uses "page" (0-indexed) and "limit" parameters
-    // Support both "page" and legacy "offset" for flexibility
-    int page =
-        command["page"] | -1;  // Page number (0-indexed), -1 = not specified
-    int limit = command["limit"] | -1;  // Items per page (default: -1 = all)
-
-    // Check if pagination is requested (either page or limit specified)
-    // ArduinoJson 7.x: Use .is<T>() instead of deprecated containsKey()
-    bool hasPageParam = !command["page"].isNull();
-    bool hasLimitParam = !command["limit"].isNull();
-    bool hasPagination = hasPageParam || hasLimitParam;
-    bool usePagination = hasPagination && (limit > 0);
+bool CRUDHandler::dispatch(BLEManager* manager, const JsonDocument& command) {
+  const CommandRoute* route =
+      findRoute(command["op"] | "", command["type"] | "");
+  if (!route) {
+    return false;
+  }
+  (this->*(route->handler))(manager, command);
+  return true;
+}
 
-    // Default limit to 10 if page is specified but limit is not
-    if (page >= 0 && limit <= 0) {
-      limit = 10;  // Default page size per mobile app spec
-    }
+// === READ HANDLERS ===
+void CRUDHandler::readDevices(BLEManager* manager,
+                              const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonArray devices = (*response)["devices"].to<JsonArray>();
+  configManager->listDevices(devices);
+  manager->sendResponse(*response);
+}
 
-    // Calculate offset from page number
-    int offset = (page >= 0) ? page * limit : 0;
+void CRUDHandler::readDevicesSummary(BLEManager* manager,
+                                     const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonArray summary = (*response)["devices_summary"].to<JsonArray>();
+  configManager->getDevicesSummary(summary);
+  manager->sendResponse(*response);
+}
 
-    // Start processing timer for performance monitoring
-    unsigned long startTime = millis();
+void CRUDHandler::readDevicesWithRegisters(BLEManager* manager,
+                                           const JsonDocument& command) {
+  bool minimalFields =
+      command["minimal"] | false;  // Support optional "minimal" parameter
+
+  // v2.5.12: Pagination support for large device lists
+  // MOBILE APP SPEC: Uses "page" (0-indexed) and "limit" parameters
+  // Support both "page" and legacy "offset" for flexibility
+  int page =
+      command["page"] | -1;  // Page number (0-indexed), -1 = not specified
+  int limit = command["limit"] | -1;  // Items per page (default: -1 = all)
+
+  // Check if pagination is requested (either page or limit specified)
+  // ArduinoJson 7.x: Use .is<T>() instead of deprecated containsKey()
+  bool hasPageParam = !command["page"].isNull();
+  bool hasLimitParam = !command["limit"].isNull();
+  bool hasPagination = hasPageParam || hasLimitParam;
+  bool usePagination = hasPagination && (limit > 0);
+
+  // Default limit to 10 if page is specified but limit is not
+  if (page >= 0 && limit <= 0) {
+    limit = 10;  // Default page size per mobile app spec
+  }
 
-    // First, get all devices into a temporary document
-    auto tempDoc = make_psram_unique<JsonDocument>();
-    JsonArray allDevices = (*tempDoc)["all"].to<JsonArray>();
-    configManager->getAllDevicesWithRegisters(allDevices, minimalFields);
+  // Calculate offset from page number
+  int offset = (page >= 0) ? page * limit : 0;
 
-    int totalDevices = allDevices.size();
+  // Start processing timer for performance monitoring
+  unsigned long startTime = millis();
 
-    // Calculate total pages (ceil division)
-    int totalPages = (limit > 0) ? ((totalDevices + limit - 1) / limit) : 1;
+  // First, get all devices into a temporary document
+  auto tempDoc = make_psram_unique<JsonDocument>();
+  JsonArray allDevices = (*tempDoc)["all"].to<JsonArray>();
+  configManager->getAllDevicesWithRegisters(allDevices, minimalFields);
 
-    // Prepare response
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonArray devices = (*response)["devices"].to<JsonArray>();
+  int totalDevices = allDevices.size();
 
-    // Apply pagination if requested
-    if (usePagination) {
-      int endIndex = min(offset + limit, totalDevices);
+  // Calculate total pages (ceil division)
+  int totalPages = (limit > 0) ? ((totalDevices + limit - 1) / limit) : 1;
 
-      // Copy only the requested range of devices
-      int deviceIndex = 0;
-      for (JsonObject device : allDevices) {
-        if (deviceIndex >= offset && deviceIndex < endIndex) {
-          devices.add(device);
-        }
-        deviceIndex++;
-        if (deviceIndex >= endIndex) break;  // Early exit for efficiency
-      }
+  // Prepare response
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonArray devices = (*response)["devices"].to<JsonArray>();
 
-      // Add pagination metadata (MOBILE APP SPEC FORMAT)
-      (*response)["total_count"] = totalDevices;  // Total devices in database
-      (*response)["page"] =
-          (page >= 0) ? page : 0;               // Current page number (echo)
-      (*response)["limit"] = limit;             // Items per page (echo)
-      (*response)["total_pages"] = totalPages;  // Total number of pages
+  // Apply pagination if requested
+  if (usePagination) {
+    int endIndex = min(offset + limit, totalDevices);
 
-      LOG_CRUD_INFO(
-          "[CRUD] devices_with_registers PAGINATED: page %d/%d, %d devices "
-          "(limit=%d)\n",
-          (page >= 0) ? page : 0, totalPages, devices.size(), limit);
-    } else {
-      // No pagination - return all devices (BACKWARD COMPATIBLE)
-      for (JsonObject device : allDevices) {
+    // Copy only the requested range of devices
+    int deviceIndex = 0;
+    for (JsonObject device : allDevices) {
+      if (deviceIndex >= offset && deviceIndex < endIndex) {
         devices.add(device);
       }
-
-      // No pagination fields when not requested (backward compatible per mobile
-      // app spec)
-      LOG_CRUD_INFO(
-          "[CRUD] devices_with_registers returned ALL %d devices "
-          "(minimal=%s)\n",
-          totalDevices, minimalFields ? "true" : "false");
+      deviceIndex++;
+      if (deviceIndex >= endIndex) break;  // Early exit for efficiency
     }
 
-    // Calculate processing time
-    unsigned long processingTime = millis() - startTime;
+    // Add pagination metadata (MOBILE APP SPEC FORMAT)
+    (*response)["total_count"] = totalDevices;  // Total devices in database
+    (*response)["page"] =
+        (page >= 0) ? page : 0;               // Current page number (echo)
+    (*response)["limit"] = limit;             // Items per page (echo)
+    (*response)["total_pages"] = totalPages;  // Total number of pages
 
-    // Warn if no data returned
-    if (totalDevices == 0) {
-      LOG_CRUD_INFO(
-          "[CRUD] WARNING: No devices returned! Check if devices are "
-          "configured in devices.json");
+    LOG_CRUD_INFO(
+        "[CRUD] devices_with_registers PAGINATED: page %d/%d, %d devices "
+        "(limit=%d)\n",
+        (page >= 0) ? page : 0, totalPages, devices.size(), limit);
+  } else {
+    // No pagination - return all devices (BACKWARD COMPATIBLE)
+    for (JsonObject device : allDevices) {
+      devices.add(device);
     }
 
-    // Warn if processing takes too long (>10 seconds)
-    if (processingTime > 10000) {
-      LOG_CRUD_INFO(
-          "[CRUD] WARNING: Processing took %lu ms (>10s). Consider using "
-          "pagination or minimal=true.\n",
-          processingTime);
-    }
+    // No pagination fields when not requested (backward compatible per mobile
+    // app spec)
+    LOG_CRUD_INFO(
+        "[CRUD] devices_with_registers returned ALL %d devices "
+        "(minimal=%s)\n",
+        totalDevices, minimalFields ? "true" : "false");
+  }
 
-    manager->sendResponse(*response);
-  };
+  // Calculate processing time
+  unsigned long processingTime = millis() - startTime;
 
-  readHandlers["device"] = [this](BLEManager* manager,
-                                  const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    bool minimal =
-        command["minimal"] | false;  // Support optional "minimal" parameter
-
-    // v2.5.18: Pagination support for device registers (Mobile App Spec)
-    // MOBILE APP SPEC: Uses "reg_page" (0-indexed) and "reg_limit" parameters
-    int regPage = command["reg_page"] |
-                  -1;  // Page number (0-indexed), -1 = not specified
-    int regLimit =
-        command["reg_limit"] | -1;  // Items per page (default: -1 = all)
-
-    // Check if pagination is requested
-    bool hasRegPageParam = !command["reg_page"].isNull();
-    bool hasRegLimitParam = !command["reg_limit"].isNull();
-    bool hasPagination = hasRegPageParam || hasRegLimitParam;
-    bool usePagination = hasPagination && (regLimit > 0);
-
-    // Default limit to 10 if page is specified but limit is not
-    if (regPage >= 0 && regLimit <= 0) {
-      regLimit = 10;  // Default page size per mobile app spec
-    }
+  // Warn if no data returned
+  if (totalDevices == 0) {
+    LOG_CRUD_INFO(
+        "[CRUD] WARNING: No devices returned! Check if devices are "
+        "configured in devices.json");
+  }
+
+  // Warn if processing takes too long (>10 seconds)
+  if (processingTime > 10000) {
+    LOG_CRUD_INFO(
+        "[CRUD] WARNING: Processing took %lu ms (>10s). Consider using "
+        "pagination or minimal=true.\n",
+        processingTime);
+  }
+
+  manager->sendResponse(*response);
+}
+
+void CRUDHandler::readDevice(BLEManager* manager, const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  bool minimal =
+      command["minimal"] | false;  // Support optional "minimal" parameter
+
+  // v2.5.18: Pagination support for device registers (Mobile App Spec)
+  // MOBILE APP SPEC: Uses "reg_page" (0-indexed) and "reg_limit" parameters
+  int regPage = command["reg_page"] |
+                -1;  // Page number (0-indexed), -1 = not specified
+  int regLimit =
+      command["reg_limit"] | -1;  // Items per page (default: -1 = all)
+
+  // Check if pagination is requested
+  bool hasRegPageParam = !command["reg_page"].isNull();
+  bool hasRegLimitParam = !command["reg_limit"].isNull();
+  bool hasPagination = hasRegPageParam || hasRegLimitParam;
+  bool usePagination = hasPagination && (regLimit > 0);
+
+  // Default limit to 10 if page is specified but limit is not
+  if (regPage >= 0 && regLimit <= 0) {
+    regLimit = 10;  // Default page size per mobile app spec
+  }
+
+  // Calculate offset from page number
+  int regOffset = (regPage >= 0) ? regPage * regLimit : 0;
+
+  // OPTIMIZATION: Check register count for proactive memory cleanup
+  // Read device in minimal mode to get register_count field
+  JsonDocument deviceCheckDoc;
+  JsonObject deviceCheck = deviceCheckDoc.to<JsonObject>();
+  if (configManager->readDevice(deviceId, deviceCheck,
+                                true))  // Read minimal first
+  {
+    // Get register count from minimal response (ConfigManager provides this
+    // field)
+    int registerCount = deviceCheck["register_count"] | 0;
+
+    // Proactive cleanup for devices with > 20 registers
+    if (registerCount > 20 && !minimal && !usePagination) {
+      // Check INTERNAL DRAM only (not PSRAM) - MALLOC_CAP_INTERNAL filters
+      // out external PSRAM
+      size_t dramBefore =
+          heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+      LOG_CRUD_INFO(
+          "[CRUD] Large device detected (%d regs). Free DRAM: %d bytes\n",
+          registerCount, dramBefore);
 
-    // Calculate offset from page number
-    int regOffset = (regPage >= 0) ? regPage * regLimit : 0;
-
-    // OPTIMIZATION: Check register count for proactive memory cleanup
-    // Read device in minimal mode to get register_count field
-    JsonDocument deviceCheckDoc;
-    JsonObject deviceCheck = deviceCheckDoc.to<JsonObject>();
-    if (configManager->readDevice(deviceId, deviceCheck,
-                                  true))  // Read minimal first
-    {
-      // Get register count from minimal response (ConfigManager provides this
-      // field)
-      int registerCount = deviceCheck["register_count"] | 0;
-
-      // Proactive cleanup for devices with > 20 registers
-      if (registerCount > 20 && !minimal && !usePagination) {
-        // Check INTERNAL DRAM only (not PSRAM) - MALLOC_CAP_INTERNAL filters
-        // out external PSRAM
-        size_t dramBefore =
+      // Trigger memory cleanup if DRAM is below 50KB
+      if (dramBefore < 50000) {
+        LOG_CRUD_INFO("[CRUD] Triggering proactive memory cleanup...");
+        uint32_t freed = MemoryRecovery::triggerCleanup();
+        delay(50);  // Give time for cleanup to complete
+
+        size_t dramAfter =
             heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
         LOG_CRUD_INFO(
-            "[CRUD] Large device detected (%d regs). Free DRAM: %d bytes\n",
-            registerCount, dramBefore);
-
-        // Trigger memory cleanup if DRAM is below 50KB
-        if (dramBefore < 50000) {
-          LOG_CRUD_INFO("[CRUD] Triggering proactive memory cleanup...");
-          uint32_t freed = MemoryRecovery::triggerCleanup();
-          delay(50);  // Give time for cleanup to complete
-
-          size_t dramAfter =
-              heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-          LOG_CRUD_INFO(
-              "[CRUD] Memory cleanup complete. Free DRAM: %d bytes (freed %d "
-              "bytes)\n",
-              dramAfter, freed);
-        } else {
-          LOG_CRUD_INFO("[CRUD] DRAM healthy (%d bytes), no cleanup needed\n",
-                        dramBefore);
-        }
+            "[CRUD] Memory cleanup complete. Free DRAM: %d bytes (freed %d "
+            "bytes)\n",
+            dramAfter, freed);
+      } else {
+        LOG_CRUD_INFO("[CRUD] DRAM healthy (%d bytes), no cleanup needed\n",
+                      dramBefore);
       }
     }
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonObject data = (*response)["data"].to<JsonObject>();
-
-    // Read device data
-    if (configManager->readDevice(deviceId, data, minimal)) {
-      // Apply pagination to registers if requested
-      if (usePagination && data["registers"].is<JsonArray>()) {
-        JsonArray allRegisters = data["registers"].as<JsonArray>();
-        int totalRegisters = allRegisters.size();
-
-        // Create new paginated registers array
-        JsonArray paginatedRegs;
-        data.remove("registers");  // Remove original array
-        paginatedRegs = data["registers"].to<JsonArray>();
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonObject data = (*response)["data"].to<JsonObject>();
 
-        int endIndex = min(regOffset + regLimit, totalRegisters);
+  // Read device data
+  if (configManager->readDevice(deviceId, data, minimal)) {
+    // Apply pagination to registers if requested
+    if (usePagination && data["registers"].is<JsonArray>()) {
+      JsonArray allRegisters = data["registers"].as<JsonArray>();
+      int totalRegisters = allRegisters.size();
 
-        // Copy only requested range
-        for (int i = regOffset; i < endIndex; i++) {
-          paginatedRegs.add(allRegisters[i]);
-        }
+      // Create new paginated registers array
+      JsonArray paginatedRegs;
+      data.remove("registers");  // Remove original array
+      paginatedRegs = data["registers"].to<JsonArray>();
 
-        // Add pagination metadata (MOBILE APP SPEC FORMAT)
-        int totalRegPages =
-            (regLimit > 0) ? ((totalRegisters + regLimit - 1) / regLimit) : 1;
-        data["total_registers"] = totalRegisters;
-        data["reg_page"] = (regPage >= 0) ? regPage : 0;
-        data["reg_limit"] = regLimit;
-        data["reg_total_pages"] = totalRegPages;
+      int endIndex = min(regOffset + regLimit, totalRegisters);
 
-        LOG_CRUD_INFO(
-            "[CRUD] Paginated device read: page %d/%d, %d/%d registers "
-            "(limit=%d)\n",
-            (regPage >= 0) ? regPage : 0, totalRegPages, paginatedRegs.size(),
-            totalRegisters, regLimit);
+      // Copy only requested range
+      for (int i = regOffset; i < endIndex; i++) {
+        paginatedRegs.add(allRegisters[i]);
       }
 
-      // Log payload size for debugging
-      String payload;
-      serializeJson(*response, payload);
-      LOG_CRUD_INFO(
-          "[CRUD] Device read response size: %d bytes (minimal=%s, "
-          "paginated=%s)\n",
-          payload.length(), minimal ? "true" : "false",
-          usePagination ? "true" : "false");
+      // Add pagination metadata (MOBILE APP SPEC FORMAT)
+      int totalRegPages =
+          (regLimit > 0) ? ((totalRegisters + regLimit - 1) / regLimit) : 1;
+      data["total_registers"] = totalRegisters;
+      data["reg_page"] = (regPage >= 0) ? regPage : 0;
+      data["reg_limit"] = regLimit;
+      data["reg_total_pages"] = totalRegPages;
 
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_FILE_NOT_FOUND, "Device not found", "device");
+      LOG_CRUD_INFO(
+          "[CRUD] Paginated device read: page %d/%d, %d/%d registers "
+          "(limit=%d)\n",
+          (regPage >= 0) ? regPage : 0, totalRegPages, paginatedRegs.size(),
+          totalRegisters, regLimit);
     }
-  };
 
-  readHandlers["registers"] = [this](BLEManager* manager,
-                                     const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-
-    // v2.5.18: Pagination support for large register lists (Mobile App Spec)
-    // MOBILE APP SPEC: Uses "page" (0-indexed) and "limit" parameters
-    int page =
-        command["page"] | -1;  // Page number (0-indexed), -1 = not specified
-    int limit = command["limit"] | -1;  // Items per page (default: -1 = all)
-
-    // Check if pagination is requested
-    bool hasPageParam = !command["page"].isNull();
-    bool hasLimitParam = !command["limit"].isNull();
-    bool hasPagination = hasPageParam || hasLimitParam;
-
-    // Default limit to 10 if page is specified but limit is not
-    if (page >= 0 && limit <= 0) {
-      limit = 10;  // Default page size per mobile app spec
-    }
+    // Log payload size for debugging
+    String payload;
+    serializeJson(*response, payload);
+    LOG_CRUD_INFO(
+        "[CRUD] Device read response size: %d bytes (minimal=%s, "
+        "paginated=%s)\n",
+        payload.length(), minimal ? "true" : "false",
+        usePagination ? "true" : "false");
 
-    // Calculate offset from page number
-    int offset = (page >= 0) ? page * limit : 0;
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_FILE_NOT_FOUND, "Device not found", "device");
+  }
+}
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonArray registers = (*response)["registers"].to<JsonArray>();
+void CRUDHandler::readRegisters(BLEManager* manager,
+                                const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+
+  // v2.5.18: Pagination support for large register lists (Mobile App Spec)
+  // MOBILE APP SPEC: Uses "page" (0-indexed) and "limit" parameters
+  int page =
+      command["page"] | -1;  // Page number (0-indexed), -1 = not specified
+  int limit = command["limit"] | -1;  // Items per page (default: -1 = all)
+
+  // Check if pagination is requested
+  bool hasPageParam = !command["page"].isNull();
+  bool hasLimitParam = !command["limit"].isNull();
+  bool hasPagination = hasPageParam || hasLimitParam;
+
+  // Default limit to 10 if page is specified but limit is not
+  if (page >= 0 && limit <= 0) {
+    limit = 10;  // Default page size per mobile app spec
+  }
 
-    // Get all registers first
-    JsonDocument tempDoc;
-    JsonArray allRegisters = tempDoc.to<JsonArray>();
+  // Calculate offset from page number
+  int offset = (page >= 0) ? page * limit : 0;
 
-    if (configManager->listRegisters(deviceId, allRegisters)) {
-      int totalRegisters = allRegisters.size();
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonArray registers = (*response)["registers"].to<JsonArray>();
 
-      // Apply pagination if requested (page or limit specified with limit > 0)
-      bool usePagination = hasPagination && (limit > 0);
+  // Get all registers first
+  JsonDocument tempDoc;
+  JsonArray allRegisters = tempDoc.to<JsonArray>();
 
-      if (usePagination) {
-        int endIndex = min(offset + limit, totalRegisters);
+  if (configManager->listRegisters(deviceId, allRegisters)) {
+    int totalRegisters = allRegisters.size();
 
-        // Copy only the requested range
-        for (int i = offset; i < endIndex; i++) {
-          registers.add(allRegisters[i]);
-        }
+    // Apply pagination if requested (page or limit specified with limit > 0)
+    bool usePagination = hasPagination && (limit > 0);
 
-        // Add pagination metadata (MOBILE APP SPEC FORMAT)
-        int totalPages =
-            (limit > 0) ? ((totalRegisters + limit - 1) / limit) : 1;
-        (*response)["total_count"] = totalRegisters;
-        (*response)["page"] = (page >= 0) ? page : 0;
-        (*response)["limit"] = limit;
-        (*response)["total_pages"] = totalPages;
+    if (usePagination) {
+      int endIndex = min(offset + limit, totalRegisters);
 
-        LOG_CRUD_INFO(
-            "[CRUD] Paginated registers read: page %d/%d, %d/%d registers "
-            "(limit=%d)\n",
-            (page >= 0) ? page : 0, totalPages, registers.size(),
-            totalRegisters, limit);
-      } else {
-        // No pagination - return all registers (BACKWARD COMPATIBLE)
-        for (JsonVariant reg : allRegisters) {
-          registers.add(reg);
-        }
-        // No pagination fields when not requested (backward compatible per
-        // mobile app spec)
-        LOG_CRUD_INFO("[CRUD] All registers read: %d registers\n",
-                      registers.size());
+      // Copy only the requested range
+      for (int i = offset; i < endIndex; i++) {
+        registers.add(allRegisters[i]);
       }
 
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_FILE_NOT_FOUND, "No registers found",
-                         "registers");
-    }
-  };
-
-  readHandlers["registers_summary"] = [this](BLEManager* manager,
-                                             const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonArray summary = (*response)["registers_summary"].to<JsonArray>();
-    if (configManager->getRegistersSummary(deviceId, summary)) {
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_FILE_NOT_FOUND, "No registers found",
-                         "registers");
-    }
-  };
-
-  // v1.2.0: writable_registers removed - use custom_subscribe_mode in server_config
-  // Configuration is now topic-centric, not register-centric
-
-  readHandlers["server_config"] = [this](BLEManager* manager,
-                                         const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonObject serverConfigObj = (*response)["server_config"].to<JsonObject>();
-    if (serverConfig->getConfig(serverConfigObj)) {
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_LOAD_FAILED, "Failed to get server config",
-                         "server_config");
-    }
-  };
+      // Add pagination metadata (MOBILE APP SPEC FORMAT)
+      int totalPages =
+          (limit > 0) ? ((totalRegisters + limit - 1) / limit) : 1;
+      (*response)["total_count"] = totalRegisters;
+      (*response)["page"] = (page >= 0) ? page : 0;
+      (*response)["limit"] = limit;
+      (*response)["total_pages"] = totalPages;
 
-  readHandlers["logging_config"] = [this](BLEManager* manager,
-                                          const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    JsonObject loggingConfigObj =
-        (*response)["logging_config"].to<JsonObject>();
-    if (loggingConfig->getConfig(loggingConfigObj)) {
-      manager->sendResponse(*response);
+      LOG_CRUD_INFO(
+          "[CRUD] Paginated registers read: page %d/%d, %d/%d registers "
+          "(limit=%d)\n",
+          (page >= 0) ? page : 0, totalPages, registers.size(),
+          totalRegisters, limit);
     } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_LOAD_FAILED, "Failed to get logging config",
-                         "logging_config");
+      // No pagination - return all registers (BACKWARD COMPATIBLE)
+      for (JsonVariant reg : allRegisters) {
+        registers.add(reg);
+      }
+      // No pagination fields when not requested (backward compatible per
+      // mobile app spec)
+      LOG_CRUD_INFO("[CRUD] All registers read: %d registers\n",
+                    registers.size());
     }
-  };
 
-  // Read current production mode status
-  readHandlers["production_mode"] = [this](BLEManager* manager,
-                                           const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_FILE_NOT_FOUND, "No registers found",
+                       "registers");
+  }
+}
 
-    // Current runtime mode
-    (*response)["current_mode"] = g_productionMode;
-    (*response)["mode_name"] =
-        (g_productionMode == 0) ? "Development" : "Production";
-
-    // Saved mode in config (for verification)
-    uint8_t savedMode =
-        loggingConfig ? loggingConfig->getProductionMode() : PRODUCTION_MODE;
-    (*response)["saved_mode"] = savedMode;
-    (*response)["saved_mode_name"] =
-        (savedMode == 0) ? "Development" : "Production";
-
-    // Mode synchronization status
-    (*response)["is_synced"] = (g_productionMode == savedMode);
-
-    // Additional info
-    (*response)["compile_time_default"] = PRODUCTION_MODE;
-    (*response)["firmware_version"] = FIRMWARE_VERSION;  // From ProductConfig.h
-
-    // Current log level (use correct type from DebugConfig.h)
-    extern LogLevel currentLogLevel;
-    (*response)["log_level"] = (int)currentLogLevel;
-    const char* logLevelNames[] = {"NONE", "ERROR", "WARN",
-                                   "INFO", "DEBUG", "VERBOSE"};
-    if (currentLogLevel >= LOG_NONE && currentLogLevel <= LOG_VERBOSE) {
-      (*response)["log_level_name"] = logLevelNames[currentLogLevel];
-    }
+void CRUDHandler::readRegistersSummary(BLEManager* manager,
+                                       const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonArray summary = (*response)["registers_summary"].to<JsonArray>();
+  if (configManager->getRegistersSummary(deviceId, summary)) {
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_FILE_NOT_FOUND, "No registers found",
+                       "registers");
+  }
+}
 
-    // Uptime
-    (*response)["uptime_ms"] = millis();
+// v1.2.0: writable_registers removed - use custom_subscribe_mode in server_config
+// Configuration is now topic-centric, not register-centric
 
+void CRUDHandler::readServerConfig(BLEManager* manager,
+                                   const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonObject serverConfigObj = (*response)["server_config"].to<JsonObject>();
+  if (serverConfig->getConfig(serverConfigObj)) {
     manager->sendResponse(*response);
-  };
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_LOAD_FAILED, "Failed to get server config",
+                       "server_config");
+  }
+}
 
-  readHandlers["full_config"] = [this](BLEManager* manager,
-                                       const JsonDocument& command) {
-    // v2.5.12: Section-based pagination for large backups
-    // section: "all" (default), "devices", "server_config", "logging_config",
-    // "metadata"
-    String section = command["section"] | "all";
-
-    // v2.5.18: Device pagination (Mobile App Spec)
-    // MOBILE APP SPEC: Uses "device_page" (0-indexed) and "device_limit"
-    // parameters
-    int devicePage = command["device_page"] |
-                     -1;  // Page number (0-indexed), -1 = not specified
-    int deviceLimit =
-        command["device_limit"] | -1;  // Items per page (default: -1 = all)
-
-    // Check if pagination is requested
-    bool hasDevicePageParam = !command["device_page"].isNull();
-    bool hasDeviceLimitParam = !command["device_limit"].isNull();
-    bool hasPagination = hasDevicePageParam || hasDeviceLimitParam;
-    bool useDevicePagination = hasPagination && (deviceLimit > 0);
-
-    // Default limit to 5 if page is specified but limit is not
-    if (devicePage >= 0 && deviceLimit <= 0) {
-      deviceLimit = 5;  // Default page size for full_config (larger data)
-    }
+void CRUDHandler::readLoggingConfig(BLEManager* manager,
+                                    const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonObject loggingConfigObj =
+      (*response)["logging_config"].to<JsonObject>();
+  if (loggingConfig->getConfig(loggingConfigObj)) {
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_LOAD_FAILED, "Failed to get logging config",
+                       "logging_config");
+  }
+}
 
-    // Calculate offset from page number
-    int deviceOffset = (devicePage >= 0) ? devicePage * deviceLimit : 0;
+// Read current production mode status
+void CRUDHandler::readProductionMode(BLEManager* manager,
+                                     const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+
+  // Current runtime mode
+  (*response)["current_mode"] = g_productionMode;
+  (*response)["mode_name"] =
+      (g_productionMode == 0) ? "Development" : "Production";
+
+  // Saved mode in config (for verification)
+  uint8_t savedMode =
+      loggingConfig ? loggingConfig->getProductionMode() : PRODUCTION_MODE;
+  (*response)["saved_mode"] = savedMode;
+  (*response)["saved_mode_name"] =
+      (savedMode == 0) ? "Development" : "Production";
+
+  // Mode synchronization status
+  (*response)["is_synced"] = (g_productionMode == savedMode);
+
+  // Additional info
+  (*response)["compile_time_default"] = PRODUCTION_MODE;
+  (*response)["firmware_version"] = FIRMWARE_VERSION;  // From ProductConfig.h
+
+  // Current log level (use correct type from DebugConfig.h)
+  extern LogLevel currentLogLevel;
+  (*response)["log_level"] = (int)currentLogLevel;
+  const char* logLevelNames[] = {"NONE", "ERROR", "WARN",
+                                 "INFO", "DEBUG", "VERBOSE"};
+  if (currentLogLevel >= LOG_NONE && currentLogLevel <= LOG_VERBOSE) {
+    (*response)["log_level_name"] = logLevelNames[currentLogLevel];
+  }
 
-    LOG_CRUD_INFO(
-        "[CRUD] Full config backup requested (section=%s, device_page=%d, "
-        "device_limit=%d)\n",
-        section.c_str(), devicePage, deviceLimit);
-    unsigned long startTime = millis();
+  // Uptime
+  (*response)["uptime_ms"] = millis();
 
-    // Allocate large PSRAM document for complete config
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["section"] = section;
-
-    // Backup metadata (always included)
-    JsonObject backupInfo = (*response)["backup_info"].to<JsonObject>();
-    backupInfo["timestamp"] = millis();
-    backupInfo["firmware_version"] = FIRMWARE_VERSION;  // From ProductConfig.h
-    backupInfo["device_name"] = PRODUCT_FULL_MODEL;     // From ProductConfig.h
-
-    // Get all configurations based on section
-    JsonObject config = (*response)["config"].to<JsonObject>();
-
-    // Track totals for metadata
-    int totalDevices = 0;
-    int totalRegisters = 0;
-    int returnedDevices = 0;
-    int returnedRegisters = 0;
-
-    // === SECTION: devices ===
-    if (section == "all" || section == "devices") {
-      // First get all devices to count total
-      auto tempDoc = make_psram_unique<JsonDocument>();
-      JsonArray allDevices = (*tempDoc)["all"].to<JsonArray>();
-      configManager->getAllDevicesWithRegisters(allDevices,
-                                                false);  // Full mode
-
-      totalDevices = allDevices.size();
-
-      // Count total registers across ALL devices
-      for (JsonObject dev : allDevices) {
-        if (dev["registers"].is<JsonArray>()) {
-          totalRegisters += dev["registers"].size();
-        }
-      }
+  manager->sendResponse(*response);
+}
 
-      // Apply device pagination if requested
-      JsonArray devices = config["devices"].to<JsonArray>();
+// v1.3.3: Task CPU, stack high-water marks, queue depths and lock waits
+// (last TaskProfiler sample)
+void CRUDHandler::readTaskProfile(BLEManager* manager,
+                                  const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  JsonObject profile = (*response)["task_profile"].to<JsonObject>();
+  TaskProfiler::getInstance()->getStatus(profile);
+  (*response)["uptime_ms"] = millis();
+  manager->sendResponse(*response);
+}
 
-      if (useDevicePagination) {
-        int endIndex = min(deviceOffset + deviceLimit, totalDevices);
-        int deviceIndex = 0;
+// v1.3.3: Downsampled register history of one device. JSON header (schema
+// and bucket layout), then the buckets as binary stream frames.
+void CRUDHandler::readHistory(BLEManager* manager,
+                              const JsonDocument& command) {
+  TrendHistory* history = TrendHistory::getInstance();
+  if (!history->enabled()) {
+    manager->sendError("Register history is disabled", "history");
+    return;
+  }
+  String deviceId = command["device_id"] | "";
+  if (deviceId.isEmpty()) {
+    manager->sendError("device_id is required", "history");
+    return;
+  }
 
-        for (JsonObject dev : allDevices) {
-          if (deviceIndex >= deviceOffset && deviceIndex < endIndex) {
-            devices.add(dev);
-            returnedDevices++;
-            if (dev["registers"].is<JsonArray>()) {
-              returnedRegisters += dev["registers"].size();
+  // Slot, generation and register slots of the device's current layout
+  JsonArrayConst registerIds = command["register_ids"];
+  uint8_t slot = PollPlanRegistry::INVALID_SLOT;
+  uint16_t generation = 0;
+  uint16_t* registerSlots = nullptr;
+  size_t registerCount = 0;
+  PollPlanRegistry::getInstance()->visitPlans(
+      [&](uint8_t planSlot, uint16_t planGeneration,
+          const CompiledDevicePlan& plan) {
+        if (registerSlots || strcmp(plan.deviceId, deviceId.c_str()) != 0) {
+          return;
+        }
+        size_t total = std::min(plan.registers.size(),
+                                (size_t)HistoryConfig::MAX_CELLS);
+        registerSlots = (uint16_t*)heap_caps_malloc(
+            std::max(total, (size_t)1) * sizeof(uint16_t),
+            MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!registerSlots) return;
+        slot = planSlot;
+        generation = planGeneration;
+        for (size_t i = 0; i < total; i++) {
+          bool wanted = registerIds.isNull();
+          for (JsonVariantConst id : registerIds) {
+            if (strcmp(id | "", plan.registers[i].registerId) == 0) {
+              wanted = true;
+              break;
             }
           }
-          deviceIndex++;
-          if (deviceIndex >= endIndex) break;
-        }
-
-        // Add device pagination metadata (MOBILE APP SPEC FORMAT)
-        int totalDevicePages =
-            (deviceLimit > 0) ? ((totalDevices + deviceLimit - 1) / deviceLimit)
-                              : 1;
-        backupInfo["device_pagination"] = true;
-        backupInfo["device_total_count"] = totalDevices;
-        backupInfo["device_page"] = (devicePage >= 0) ? devicePage : 0;
-        backupInfo["device_limit"] = deviceLimit;
-        backupInfo["device_total_pages"] = totalDevicePages;
-
-        LOG_CRUD_INFO(
-            "[CRUD] Device pagination: page %d/%d, %d/%d devices, %d "
-            "registers\n",
-            (devicePage >= 0) ? devicePage : 0, totalDevicePages,
-            returnedDevices, totalDevices, returnedRegisters);
-      } else {
-        // No pagination - return all devices
-        for (JsonObject dev : allDevices) {
-          devices.add(dev);
+          if (wanted) {
+            registerSlots[registerCount++] = (uint16_t)i;  // Ascending
+          }
         }
-        returnedDevices = totalDevices;
-        returnedRegisters = totalRegisters;
-        backupInfo["device_pagination"] = false;
-      }
-    }
+      });
+  if (!registerSlots) {
+    manager->sendError(ERR_CFG_FILE_NOT_FOUND,
+                       "Device not found or not polled", "history");
+    return;
+  }
+  if (registerCount == 0) {
+    heap_caps_free(registerSlots);
+    manager->sendError(ERR_CFG_FILE_NOT_FOUND, "No registers found",
+                       "history");
+    return;
+  }
 
-    // === SECTION: server_config ===
-    if (section == "all" || section == "server_config") {
-      JsonObject serverCfg = config["server_config"].to<JsonObject>();
-      if (!serverConfig->getConfig(serverCfg)) {
-        LOG_CRUD_INFO("[CRUD] WARNING: Failed to get server config");
+  // Bucket layout: points buckets ending now, bounded by MAX_CELLS
+  uint32_t retention = history->retentionSeconds();
+  uint32_t rangeS = command["range_s"] | retention;
+  rangeS = std::max<uint32_t>(60, std::min(rangeS, retention));
+  uint32_t points = command["points"] | 60;
+  points = std::max<uint32_t>(
+      1, std::min<uint32_t>(points, HistoryConfig::MAX_POINTS));
+  points = std::max<uint32_t>(
+      1, std::min<uint32_t>(points, HistoryConfig::MAX_CELLS / registerCount));
+  uint32_t bucketS = std::max<uint32_t>(
+      history->intervalSeconds(), (rangeS + points - 1) / points);
+  uint32_t span = bucketS * points;
+  uint32_t now = TrendHistory::nowSeconds();
+  uint32_t fromS = (now + 1 > span) ? now + 1 - span : 0;
+
+  TrendHistory::Cell* cells = (TrendHistory::Cell*)heap_caps_calloc(
+      points * registerCount, sizeof(TrendHistory::Cell),
+      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!cells) {
+    heap_caps_free(registerSlots);
+    manager->sendError(ERR_MEM_UTILIZATION_CRITICAL,
+                       "Not enough memory for history buckets", "history");
+    return;
+  }
+  uint32_t samples =
+      history->query(slot, generation, registerSlots, registerCount, fromS,
+                     bucketS, (uint16_t)points, cells);
+  uint32_t buckets = 0;
+  for (uint32_t point = 0; point < points; point++) {
+    for (size_t i = 0; i < registerCount; i++) {
+      if (cells[point * registerCount + i].count > 0) {
+        buckets++;
+        break;
       }
     }
+  }
 
-    // === SECTION: logging_config ===
-    if (section == "all" || section == "logging_config") {
-      JsonObject loggingCfg = config["logging_config"].to<JsonObject>();
-      if (!loggingConfig->getConfig(loggingCfg)) {
-        LOG_CRUD_INFO("[CRUD] WARNING: Failed to get logging config");
-      }
-    }
+  // Frame timestamps in unix time once the clock is set
+  time_t unixNow = time(nullptr);
+  bool unixClock = unixNow > 1600000000;
+  uint32_t firstTime =
+      unixClock ? (uint32_t)unixNow - (now - fromS) : fromS;
+
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["type"] = "history";
+  (*response)["format"] = "binary";
+  (*response)["generation"] = generation;
+  JsonObject schema = response->as<JsonObject>();
+  PollPlanRegistry::getInstance()->describeDevice(slot, generation, schema);
+  (*response)["clock"] = unixClock ? "unix" : "uptime";
+  (*response)["from"] = firstTime;
+  (*response)["bucket_s"] = bucketS;
+  (*response)["points"] = points;
+  (*response)["buckets"] = buckets;
+  (*response)["samples"] = samples;
+  JsonObject status = (*response)["history"].to<JsonObject>();
+  history->getStatus(status);
+  manager->sendResponse(*response);
+
+  manager->sendHistoryFrames(generation, registerSlots, registerCount, cells,
+                             (uint16_t)points, firstTime, bucketS);
+  LOG_CRUD_INFO("[CRUD] History %s: %u registers, %lu buckets of %lu s\n",
+                deviceId.c_str(), (unsigned)registerCount,
+                (unsigned long)buckets, (unsigned long)bucketS);
+  heap_caps_free(cells);
+  heap_caps_free(registerSlots);
+}
 
-    // === SECTION: metadata (stats only, no data) ===
-    if (section == "metadata") {
-      // Just return metadata without actual config data
-      auto tempDoc = make_psram_unique<JsonDocument>();
-      JsonArray allDevices = (*tempDoc)["all"].to<JsonArray>();
-      configManager->getAllDevicesWithRegisters(
-          allDevices, true);  // Minimal mode for speed
-
-      totalDevices = allDevices.size();
-      for (JsonObject dev : allDevices) {
-        if (dev["registers"].is<JsonArray>()) {
-          totalRegisters += dev["registers"].size();
-        }
-      }
+void CRUDHandler::readFullConfig(BLEManager* manager,
+                                 const JsonDocument& command) {
+  // v2.5.12: Section-based pagination for large backups
+  // section: "all" (default), "devices", "server_config", "logging_config",
+  // "metadata"
+  String section = command["section"] | "all";
+
+  // v2.5.18: Device pagination (Mobile App Spec)
+  // MOBILE APP SPEC: Uses "device_page" (0-indexed) and "device_limit"
+  // parameters
+  int devicePage = command["device_page"] |
+                   -1;  // Page number (0-indexed), -1 = not specified
+  int deviceLimit =
+      command["device_limit"] | -1;  // Items per page (default: -1 = all)
+
+  // Check if pagination is requested
+  bool hasDevicePageParam = !command["device_page"].isNull();
+  bool hasDeviceLimitParam = !command["device_limit"].isNull();
+  bool hasPagination = hasDevicePageParam || hasDeviceLimitParam;
+  bool useDevicePagination = hasPagination && (deviceLimit > 0);
+
+  // Default limit to 5 if page is specified but limit is not
+  if (devicePage >= 0 && deviceLimit <= 0) {
+    deviceLimit = 5;  // Default page size for full_config (larger data)
+  }
 
-      // Add recommended pagination settings
-      JsonObject recommendations =
-          (*response)["recommendations"].to<JsonObject>();
-      if (totalDevices > 5 || totalRegisters > 100) {
-        recommendations["use_pagination"] = true;
-        recommendations["suggested_device_limit"] = 2;  // 2 devices per request
-        recommendations["estimated_pages"] = (totalDevices + 1) / 2;
-      } else {
-        recommendations["use_pagination"] = false;
-        recommendations["reason"] =
-            "Data size is manageable without pagination";
+  // Calculate offset from page number
+  int deviceOffset = (devicePage >= 0) ? devicePage * deviceLimit : 0;
+
+  LOG_CRUD_INFO(
+      "[CRUD] Full config backup requested (section=%s, device_page=%d, "
+      "device_limit=%d)\n",
+      section.c_str(), devicePage, deviceLimit);
+  unsigned long startTime = millis();
+
+  bool includeDevices = (section == "all" || section == "devices");
+  bool includeServer = (section == "all" || section == "server_config");
+  bool includeLogging = (section == "all" || section == "logging_config");
+
+  // v1.3.3: Streamed backup
+  // Previous: The whole backup was built in one PSRAM document (plus a
+  // second copy of all devices for counting), measured, serialized into a
+  // second buffer and then fragmented.
+  // New: Each part is serialized straight into BLE notifications from the
+  // immutable device generation; only one device is materialized at a
+  // time. Totals are counted up front, so backup_info is written last.
+  ConfigManager::DevicesGenerationHandle generation =
+      configManager->getDevicesGeneration();
+
+  // Track totals for metadata
+  int totalDevices = 0;
+  int totalRegisters = 0;
+  if (generation) {
+    totalDevices = generation->devices.size();
+    for (const auto& entry : generation->devices) {
+      JsonVariantConst registers =
+          entry.config->as<JsonObjectConst>()["registers"];
+      if (registers.is<JsonArrayConst>()) {
+        totalRegisters += registers.size();
       }
     }
+  }
 
-    // Calculate statistics
-    backupInfo["total_devices"] = totalDevices;
-    backupInfo["total_registers"] = totalRegisters;
-
-    unsigned long processingTime = millis() - startTime;
-    backupInfo["processing_time_ms"] = processingTime;
-
-    // Calculate approximate JSON size
-    size_t jsonSize = measureJson(*response);
-    backupInfo["backup_size_bytes"] = jsonSize;
-
-    // Add section info for client
-    JsonArray availableSections =
-        backupInfo["available_sections"].to<JsonArray>();
-    availableSections.add("all");
-    availableSections.add("devices");
-    availableSections.add("server_config");
-    availableSections.add("logging_config");
-    availableSections.add("metadata");
+  // Device range of this response
+  int firstDevice = 0;
+  int endDevice = includeDevices ? totalDevices : 0;
+  if (includeDevices && useDevicePagination) {
+    firstDevice = min(deviceOffset, totalDevices);
+    endDevice = min(deviceOffset + deviceLimit, totalDevices);
+  }
 
-    LOG_CRUD_INFO(
-        "[CRUD] Full config backup complete: section=%s, %d devices, %d "
-        "registers, %d bytes, %lu ms\n",
-        section.c_str(), returnedDevices > 0 ? returnedDevices : totalDevices,
-        returnedRegisters > 0 ? returnedRegisters : totalRegisters, jsonSize,
-        processingTime);
+  BLEResponseStream* out = manager->beginResponse();
+  if (!out) {
+    LOG_CRUD_INFO("[CRUD] ERROR: Full config backup could not be started");
+    return;
+  }
 
-    manager->sendResponse(*response);
+  // Escaped JSON string value
+  auto writeString = [out](const char* value) {
+    JsonDocument str;
+    str.set(value);
+    serializeJson(str, *out);
   };
 
-  readHandlers["data"] = [this](BLEManager* manager,
-                                const JsonDocument& command) {
-    String device = command["device_id"] | "";
-    if (device == "stop") {
-      LOG_CRUD_INFO("[CRUD] Stop streaming command received");
-
-      // Set streaming flag to false FIRST to prevent new dequeue operations
-      manager->setStreamingActive(false);
-
-      // Clear stream device ID and queue
-      streamDeviceId = "";
-      QueueManager::getInstance()->clearStream();
-
-      // Brief delay to allow streaming task to see the flag change
-      // Streaming task checks isStreamingActive() every 100ms
-      LOG_CRUD_INFO("[CRUD] Waiting 150ms for streaming task to sync...");
-      vTaskDelay(pdMS_TO_TICKS(150));
-
-      // No need to wait for transmissions - transmissionMutex will handle
-      // synchronization When we call sendResponse(), it will automatically wait
-      // for any in-flight transmission to complete before sending the stop
-      // response
-      LOG_CRUD_INFO("[CRUD] Sending stop response");
-
-      // Simple streaming completion summary
-      // v2.5.35: Use DEV_MODE check to prevent log leak in production
-      DEV_SERIAL_PRINTLN("[STREAM] Stopped");
-
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["message"] = "Data streaming stopped";
-      manager->sendResponse(*response);
-      LOG_CRUD_INFO("[CRUD] Stop response sent");
-    } else if (!device.isEmpty()) {
-      streamDeviceId = device;
-
-      // Get register count for this device using public API
-      int registerCount = 0;
-      JsonDocument tempDoc;
-      JsonObject deviceObj = tempDoc.to<JsonObject>();
-      if (configManager->readDevice(device, deviceObj)) {
-        if (deviceObj["registers"].is<JsonArray>()) {
-          registerCount = deviceObj["registers"].size();
-        }
-      }
-
-      // Set streaming flag to true when starting
-      manager->setStreamingActive(true);
-
-      // Simple summary log
-      // v2.5.35: Use DEV_MODE check to prevent log leak in production
-      DEV_SERIAL_PRINTF("[STREAM] Started: %s (%d registers)\n", device.c_str(),
-                        registerCount);
+  out->print("{\"status\":\"ok\",\"section\":");
+  writeString(section.c_str());
+
+  // Get all configurations based on section
+  out->print(",\"config\":{");
+  bool firstKey = true;
+
+  // === SECTION: devices ===
+  int returnedDevices = 0;
+  int returnedRegisters = 0;
+  if (includeDevices) {
+    out->print("\"devices\":[");
+    for (int i = firstDevice; i < endDevice && !out->cancelled(); i++) {
+      const auto& entry = generation->devices[i];
+      SpiRamJsonDocument deviceDoc;  // One device at a time (PSRAM)
+      ConfigManager::copyDeviceWithRegisters(
+          entry.deviceId.c_str(), entry.config->as<JsonObjectConst>(),
+          deviceDoc.to<JsonObject>(), false);  // Full mode
+
+      if (returnedDevices > 0) out->print(",");
+      serializeJson(deviceDoc, *out);
+      returnedDevices++;
+      returnedRegisters += deviceDoc["registers"].size();
+
+      out->reportProgress((returnedDevices * 100) /
+                          (endDevice - firstDevice));
+    }
+    out->print("]");
+    firstKey = false;
+  }
 
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["message"] = "Data streaming started for device: " + device;
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Empty device ID", "data");
+  // === SECTION: server_config ===
+  if (includeServer) {
+    JsonDocument serverDoc;
+    JsonObject serverCfg = serverDoc.to<JsonObject>();
+    if (!serverConfig->getConfig(serverCfg)) {
+      LOG_CRUD_INFO("[CRUD] WARNING: Failed to get server config");
     }
-  };
-
-  // === CREATE HANDLERS ===
-  createHandlers["device"] = [this](BLEManager* manager,
-                                    const JsonDocument& command) {
-    JsonObjectConst config = command["config"];
-    String deviceId = configManager->createDevice(config);
-    if (!deviceId.isEmpty()) {
-      notifyAllServices();  // CRITICAL FIX: Notify MQTT to refresh device
-                            // configs
-
-      // Return created device data
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-
-      JsonObject deviceData = (*response)["data"].to<JsonObject>();
-      configManager->readDevice(deviceId, deviceData);
+    out->print(firstKey ? "\"server_config\":" : ",\"server_config\":");
+    serializeJson(serverDoc, *out);
+    firstKey = false;
+  }
 
-      manager->sendResponse(*response);
+  // === SECTION: logging_config ===
+  if (includeLogging) {
+    JsonDocument loggingDoc;
+    JsonObject loggingCfg = loggingDoc.to<JsonObject>();
+    if (!loggingConfig->getConfig(loggingCfg)) {
+      LOG_CRUD_INFO("[CRUD] WARNING: Failed to get logging config");
+    }
+    out->print(firstKey ? "\"logging_config\":" : ",\"logging_config\":");
+    serializeJson(loggingDoc, *out);
+  }
+  out->print("}");
+
+  // === SECTION: metadata (stats only, no data) ===
+  if (section == "metadata") {
+    // Add recommended pagination settings
+    JsonDocument recommendations;
+    if (totalDevices > 5 || totalRegisters > 100) {
+      recommendations["use_pagination"] = true;
+      recommendations["suggested_device_limit"] = 2;  // 2 devices per request
+      recommendations["estimated_pages"] = (totalDevices + 1) / 2;
     } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_SAVE_FAILED, "Device creation failed",
-                         "device");
+      recommendations["use_pagination"] = false;
+      recommendations["reason"] =
+          "Data size is manageable without pagination";
     }
-  };
+    out->print(",\"recommendations\":");
+    serializeJson(recommendations, *out);
+  }
 
-  createHandlers["register"] = [this](BLEManager* manager,
-                                      const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    JsonObjectConst config = command["config"];
-    String errorMsg;  // v2.5.31: Capture specific error message
-    String registerId =
-        configManager->createRegister(deviceId, config, &errorMsg);
-    if (!registerId.isEmpty()) {
-      notifyAllServices();  // CRITICAL FIX: Register count affects MQTT timeout
-
-      // Return created register data
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["register_id"] = registerId;
-
-      // Load device and find the created register
-      // BUG #31: Global PSRAM allocator handles all JsonDocument instances
-      // automatically
-      JsonDocument deviceDoc;
-      JsonObject device = deviceDoc.to<JsonObject>();
-      if (configManager->readDevice(deviceId, device) &&
-          device["registers"].is<JsonArray>()) {
-        JsonArray registers = device["registers"];
-        for (JsonObject reg : registers) {
-          if (reg["register_id"] == registerId) {
-            (*response)["data"] = reg;
-            break;
-          }
-        }
-      }
+  // Backup metadata (always included, last so the totals are final)
+  JsonDocument infoDoc;
+  JsonObject backupInfo = infoDoc.to<JsonObject>();
+  backupInfo["timestamp"] = millis();
+  backupInfo["firmware_version"] = FIRMWARE_VERSION;  // From ProductConfig.h
+  backupInfo["device_name"] = PRODUCT_FULL_MODEL;     // From ProductConfig.h
+
+  if (includeDevices) {
+    if (useDevicePagination) {
+      // Add device pagination metadata (MOBILE APP SPEC FORMAT)
+      int totalDevicePages =
+          (deviceLimit > 0) ? ((totalDevices + deviceLimit - 1) / deviceLimit)
+                            : 1;
+      backupInfo["device_pagination"] = true;
+      backupInfo["device_total_count"] = totalDevices;
+      backupInfo["device_page"] = (devicePage >= 0) ? devicePage : 0;
+      backupInfo["device_limit"] = deviceLimit;
+      backupInfo["device_total_pages"] = totalDevicePages;
 
-      manager->sendResponse(*response);
+      LOG_CRUD_INFO(
+          "[CRUD] Device pagination: page %d/%d, %d/%d devices, %d "
+          "registers\n",
+          (devicePage >= 0) ? devicePage : 0, totalDevicePages,
+          returnedDevices, totalDevices, returnedRegisters);
     } else {
-      // v1.0.2: Standardized error response with specific message
-      manager->sendError(
-          ERR_CFG_SAVE_FAILED,
-          errorMsg.isEmpty() ? "Register creation failed" : errorMsg.c_str(),
-          "registers");
+      backupInfo["device_pagination"] = false;
     }
-  };
+  }
 
-  // === UPDATE HANDLERS ===
-  updateHandlers["device"] = [this](BLEManager* manager,
-                                    const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    JsonObjectConst config = command["config"];
-    if (configManager->updateDevice(deviceId, config)) {
-      notifyAllServices();  // CRITICAL FIX: Notify MQTT to refresh device
-                            // configs
-
-      // Return updated device data
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["message"] = "Device updated";
-
-      JsonObject deviceData = (*response)["data"].to<JsonObject>();
-      configManager->readDevice(deviceId, deviceData);
-
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_SAVE_FAILED, "Device update failed", "device");
-    }
-  };
+  // Calculate statistics
+  backupInfo["total_devices"] = totalDevices;
+  backupInfo["total_registers"] = totalRegisters;
+
+  unsigned long processingTime = millis() - startTime;
+  backupInfo["processing_time_ms"] = processingTime;
+
+  // JSON bytes streamed so far (everything except backup_info)
+  size_t jsonSize = out->bytesWritten();
+  backupInfo["backup_size_bytes"] = jsonSize;
+
+  // Add section info for client
+  JsonArray availableSections =
+      backupInfo["available_sections"].to<JsonArray>();
+  availableSections.add("all");
+  availableSections.add("devices");
+  availableSections.add("server_config");
+  availableSections.add("logging_config");
+  availableSections.add("metadata");
+
+  out->print(",\"backup_info\":");
+  serializeJson(infoDoc, *out);
+  out->print("}");
+  manager->endResponse();
+
+  LOG_CRUD_INFO(
+      "[CRUD] Full config backup complete: section=%s, %d devices, %d "
+      "registers, %d bytes, %lu ms\n",
+      section.c_str(), returnedDevices > 0 ? returnedDevices : totalDevices,
+      returnedRegisters > 0 ? returnedRegisters : totalRegisters, jsonSize,
+      processingTime);
+}
 
-  updateHandlers["register"] = [this](BLEManager* manager,
-                                      const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    String registerId = command["register_id"] | "";
-    JsonObjectConst config = command["config"];
-    if (configManager->updateRegister(deviceId, registerId, config)) {
-      notifyAllServices();  // CRITICAL FIX: Register changes may affect MQTT
-
-      // Return updated register data
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["register_id"] = registerId;
-      (*response)["message"] = "Register updated";
-
-      // Load device and find the updated register
-      // BUG #31: Global PSRAM allocator handles all JsonDocument instances
-      // automatically
-      JsonDocument deviceDoc;
-      JsonObject device = deviceDoc.to<JsonObject>();
-      if (configManager->readDevice(deviceId, device) &&
-          device["registers"].is<JsonArray>()) {
-        JsonArray registers = device["registers"];
-        for (JsonObject reg : registers) {
-          if (reg["register_id"] == registerId) {
-            (*response)["data"] = reg;
-            break;
-          }
-        }
-      }
+void CRUDHandler::readData(BLEManager* manager, const JsonDocument& command) {
+  String device = command["device_id"] | "";
+  if (device == "stop") {
+    LOG_CRUD_INFO("[CRUD] Stop streaming command received");
 
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Standardized error response
-      manager->sendError(ERR_CFG_SAVE_FAILED, "Register update failed",
-                         "registers");
-    }
-  };
+    // Set streaming flag to false FIRST to prevent new dequeue operations
+    manager->setStreamingActive(false);
 
-  updateHandlers["server_config"] = [this](BLEManager* manager,
-                                           const JsonDocument& command) {
-    JsonObjectConst config = command["config"];
-    if (serverConfig->updateConfig(config)) {
-      // v2.2.0: Only HTTP Manager needs interval update (MQTT uses
-      // mode-specific intervals) Device will restart in 5s after server_config
-      // update, MQTT will reload config on restart
-      if (httpManager) {
-        httpManager->updateDataTransmissionInterval();
-        LOG_CRUD_INFO("[CRUD] HTTP Manager data interval updated");
-      }
+    // Clear stream device ID and queue
+    streamDeviceId = "";
+    QueueManager::getInstance()->clearStream();
 
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["message"] =
-          "Server configuration updated. Device will restart in 10s.";
-      manager->sendResponse(*response);
-    } else {
-      // v1.0.2: Enhanced validation error response with field-specific details
-      const ConfigValidationResult& validation =
-          serverConfig->getLastValidationResult();
-
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "error";
-      (*response)["error_code"] = validation.errorCode;
-      (*response)["domain"] = "CONFIG";
-      (*response)["severity"] = "ERROR";
-      (*response)["message"] = validation.message;
-
-      // Include field info if available (helps mobile app highlight specific
-      // field)
-      if (!validation.field.isEmpty()) {
-        (*response)["field"] = validation.field;
-      }
+    // Brief delay to allow streaming task to see the flag change
+    // Streaming task checks isStreamingActive() every 100ms
+    LOG_CRUD_INFO("[CRUD] Waiting 150ms for streaming task to sync...");
+    vTaskDelay(pdMS_TO_TICKS(150));
 
-      // Include suggestion for user
-      if (!validation.suggestion.isEmpty()) {
-        (*response)["suggestion"] = validation.suggestion;
-      }
+    // No need to wait for transmissions - transmissionMutex will handle
+    // synchronization When we call sendResponse(), it will automatically wait
+    // for any in-flight transmission to complete before sending the stop
+    // response
+    LOG_CRUD_INFO("[CRUD] Sending stop response");
 
-      LOG_CRUD_WARN("[CRUD] Server config validation failed: %s (field: %s)",
-                    validation.message.c_str(), validation.field.c_str());
+    // Simple streaming completion summary
+    // v2.5.35: Use DEV_MODE check to prevent log leak in production
+    DEV_SERIAL_PRINTLN("[STREAM] Stopped");
 
-      manager->sendResponse(*response);
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["message"] = "Data streaming stopped";
+    manager->sendResponse(*response);
+    LOG_CRUD_INFO("[CRUD] Stop response sent");
+  } else if (!device.isEmpty()) {
+    // v1.3.3: Opt-in compact binary frames (see STREAM_FRAME_* in
+    // BLEManager.h); JSON data points stay the default
+    String format = command["format"] | "json";
+    if (format != "json" && format != "binary") {
+      manager->sendError("Unsupported stream format: " + format, "data");
+      return;
     }
-  };
 
-  updateHandlers["logging_config"] = [this](BLEManager* manager,
-                                            const JsonDocument& command) {
-    JsonObjectConst config = command["config"];
-    if (loggingConfig->updateConfig(config)) {
-      auto response = make_psram_unique<JsonDocument>();
-      (*response)["status"] = "ok";
-      (*response)["message"] = "Logging configuration updated";
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Logging configuration update failed",
-                         "logging_config");
-    }
-  };
+    streamDeviceId = device;
+    // v1.3.3: Stream cursor over the data queue (new readings of device)
+    QueueManager::getInstance()->beginStream(device.c_str());
 
-  // === DELETE HANDLERS ===
-  deleteHandlers["device"] = [this](BLEManager* manager,
-                                    const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
+    // Get register count for this device using public API
+    int registerCount = 0;
+    JsonDocument tempDoc;
+    JsonObject deviceObj = tempDoc.to<JsonObject>();
+    if (configManager->readDevice(device, deviceObj)) {
+      if (deviceObj["registers"].is<JsonArray>()) {
+        registerCount = deviceObj["registers"].size();
+      }
+    }
 
-    // Get device data before deletion for response
-    auto response = make_psram_unique<JsonDocument>();
-    JsonObject deletedData = (*response)["deleted_data"].to<JsonObject>();
-    configManager->readDevice(deviceId, deletedData);
+    // Set streaming flag to true when starting
+    manager->setStreamFormat(format == "binary");
+    manager->setStreamingActive(true);
 
-    if (configManager->deleteDevice(deviceId)) {
-      notifyAllServices();  // CRITICAL FIX: Notify MQTT to refresh device
-                            // configs
+    // Simple summary log
+    // v2.5.35: Use DEV_MODE check to prevent log leak in production
+    DEV_SERIAL_PRINTF("[STREAM] Started: %s (%d registers, %s)\n",
+                      device.c_str(), registerCount, format.c_str());
 
-      // Return deleted device data
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["message"] = "Device deleted";
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["message"] = "Data streaming started for device: " + device;
+    (*response)["format"] = format;
+    manager->sendResponse(*response);
+  } else {
+    manager->sendError("Empty device ID", "data");
+  }
+}
 
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Device deletion failed", "device");
-    }
-  };
+// === CREATE HANDLERS ===
+void CRUDHandler::createDevice(BLEManager* manager,
+                               const JsonDocument& command) {
+  // v1.3.3: Admission control - a new device means another poll plan,
+  // latest-value slots and queue traffic; refuse it instead of pushing the
+  // gateway into the emergency recovery tiers
+  if (!MemoryRecovery::canAdmitDevice()) {
+    manager->sendError(ERR_MEM_UTILIZATION_CRITICAL,
+                       "Insufficient memory for a new device", "device");
+    return;
+  }
 
-  deleteHandlers["register"] = [this](BLEManager* manager,
-                                      const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    String registerId = command["register_id"] | "";
+  JsonObjectConst config = command["config"];
+  String deviceId = configManager->createDevice(config);
+  if (!deviceId.isEmpty()) {
+    // CRITICAL FIX: Notify MQTT to refresh device configs
+    notifyAllServices(ModbusConfigChange(ModbusConfigChange::DEVICE_ADDED,
+                                         deviceId.c_str()));
 
-    // Get register data before deletion for response
+    // Return created device data
     auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+
+    JsonObject deviceData = (*response)["data"].to<JsonObject>();
+    configManager->readDevice(deviceId, deviceData);
+
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_SAVE_FAILED, "Device creation failed",
+                       "device");
+  }
+}
 
-    // Load device and find the register before deletion
+void CRUDHandler::createRegister(BLEManager* manager,
+                                 const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  JsonObjectConst config = command["config"];
+  String errorMsg;  // v2.5.31: Capture specific error message
+  String registerId =
+      configManager->createRegister(deviceId, config, &errorMsg);
+  if (!registerId.isEmpty()) {
+    // CRITICAL FIX: Register count affects MQTT timeout
+    notifyAllServices(ModbusConfigChange(
+        ModbusConfigChange::REGISTERS_CHANGED, deviceId.c_str()));
+
+    // Return created register data
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["register_id"] = registerId;
+
+    // Load device and find the created register
     // BUG #31: Global PSRAM allocator handles all JsonDocument instances
     // automatically
     JsonDocument deviceDoc;
@@ -1003,1015 +1124,1296 @@ void CRUDHandler::setupCommandHandlers() {
       JsonArray registers = device["registers"];
       for (JsonObject reg : registers) {
         if (reg["register_id"] == registerId) {
-          (*response)["deleted_data"] = reg;
+          (*response)["data"] = reg;
           break;
         }
       }
     }
 
-    if (configManager->deleteRegister(deviceId, registerId)) {
-      notifyAllServices();  // CRITICAL FIX: Register count affects MQTT timeout
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response with specific message
+    manager->sendError(
+        ERR_CFG_SAVE_FAILED,
+        errorMsg.isEmpty() ? "Register creation failed" : errorMsg.c_str(),
+        "registers");
+  }
+}
+
+// v1.3.3: Bulk register import - "registers" inline (commands that fit the
+// BLE buffer) or staged by an <IMPORT> upload (RegisterImportStream). All
+// registers are added in one batch: one device record write, one generation,
+// one service notification. Any invalid register aborts the whole import.
+void CRUDHandler::importRegisters(BLEManager* manager,
+                                  const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  JsonArrayConst registers = command["registers"];
+  RegisterImportStream* upload = nullptr;
+  if (registers.isNull()) {
+    upload = manager->takeRegisterImport();
+    if (upload) {
+      registers = upload->registers();
+    }
+  }
+  if (registers.isNull() || registers.size() == 0) {
+    manager->releaseRegisterImport();
+    manager->sendError(ERR_CFG_INVALID_VALUE, "No registers to import",
+                       "registers");
+    return;
+  }
 
-      // Return deleted register data
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["register_id"] = registerId;
-      (*response)["message"] = "Register deleted";
+  size_t total = registers.size();
+  auto response = make_psram_unique<JsonDocument>();
+  JsonArray registerIds = (*response)["register_ids"].to<JsonArray>();
+  String errorMsg;
+  size_t imported = 0;
 
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Register deletion failed", "registers");
+  configManager->beginDevicesBatch(true);
+  for (JsonObjectConst config : registers) {
+    String registerId =
+        configManager->createRegister(deviceId, config, &errorMsg);
+    if (registerId.isEmpty()) {
+      break;
     }
-  };
+    registerIds.add(registerId);
+    if (++imported % 50 == 0) {
+      vTaskDelay(1);  // Cache edits only - keep the idle task fed
+    }
+  }
+  bool saved = false;
+  if (imported == total) {
+    saved = configManager->commitDevicesBatch();
+  } else {
+    configManager->abortDevicesBatch();
+  }
+  if (upload) {
+    manager->releaseRegisterImport();
+  }
 
-  // === WRITE HANDLERS (v1.0.8: Write Register Support) ===
+  if (imported < total) {
+    String message = "Register " + String((unsigned long)imported) + ": " +
+                     (errorMsg.isEmpty() ? "creation failed" : errorMsg) +
+                     " (nothing imported)";
+    manager->sendError(ERR_CFG_INVALID_VALUE, message.c_str(), "registers");
+    return;
+  }
+  if (!saved) {
+    manager->sendError(ERR_CFG_SAVE_FAILED, "Register import commit failed",
+                       "registers");
+    return;
+  }
 
-  writeHandlers["register"] = [this](BLEManager* manager,
-                                     const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    String registerId = command["register_id"] | "";
+  notifyAllServices(ModbusConfigChange(ModbusConfigChange::REGISTERS_CHANGED,
+                                       deviceId.c_str()));
+  LOG_CONFIG_INFO("[CRUD] Imported %lu registers into %s%s\n",
+                (unsigned long)total, deviceId.c_str(),
+                upload ? " (streamed)" : "");
+
+  (*response)["status"] = "ok";
+  (*response)["device_id"] = deviceId;
+  (*response)["imported"] = total;
+  (*response)["streamed"] = upload != nullptr;
+  manager->sendResponse(*response);
+}
 
+// === UPDATE HANDLERS ===
+void CRUDHandler::updateDevice(BLEManager* manager,
+                               const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  JsonObjectConst config = command["config"];
+  if (configManager->updateDevice(deviceId, config)) {
+    // CRITICAL FIX: Notify MQTT to refresh device configs
+    notifyAllServices(ModbusConfigChange(ModbusConfigChange::DEVICE_UPDATED,
+                                         deviceId.c_str()));
+
+    // Return updated device data
     auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["message"] = "Device updated";
 
-    if (deviceId.isEmpty()) {
-      manager->sendError("device_id is required", "register");
-      return;
-    }
+    JsonObject deviceData = (*response)["data"].to<JsonObject>();
+    configManager->readDevice(deviceId, deviceData);
 
-    if (registerId.isEmpty()) {
-      manager->sendError("register_id is required", "register");
-      return;
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_SAVE_FAILED, "Device update failed", "device");
+  }
+}
+
+void CRUDHandler::updateRegister(BLEManager* manager,
+                                 const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  String registerId = command["register_id"] | "";
+  JsonObjectConst config = command["config"];
+  if (configManager->updateRegister(deviceId, registerId, config)) {
+    // CRITICAL FIX: Register changes may affect MQTT
+    notifyAllServices(ModbusConfigChange(
+        ModbusConfigChange::REGISTERS_CHANGED, deviceId.c_str()));
+
+    // Return updated register data
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["register_id"] = registerId;
+    (*response)["message"] = "Register updated";
+
+    // Load device and find the updated register
+    // BUG #31: Global PSRAM allocator handles all JsonDocument instances
+    // automatically
+    JsonDocument deviceDoc;
+    JsonObject device = deviceDoc.to<JsonObject>();
+    if (configManager->readDevice(deviceId, device) &&
+        device["registers"].is<JsonArray>()) {
+      JsonArray registers = device["registers"];
+      for (JsonObject reg : registers) {
+        if (reg["register_id"] == registerId) {
+          (*response)["data"] = reg;
+          break;
+        }
+      }
     }
 
-    if (command["value"].isNull()) {
-      manager->sendError("value is required", "register");
-      return;
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Standardized error response
+    manager->sendError(ERR_CFG_SAVE_FAILED, "Register update failed",
+                       "registers");
+  }
+}
+
+void CRUDHandler::updateServerConfig(BLEManager* manager,
+                                     const JsonDocument& command) {
+  JsonObjectConst config = command["config"];
+  if (serverConfig->updateConfig(config)) {
+    // v2.2.0: Only HTTP Manager needs interval update (MQTT uses
+    // mode-specific intervals) Device will restart in 5s after server_config
+    // update, MQTT will reload config on restart
+    if (httpManager) {
+      httpManager->updateDataTransmissionInterval();
+      LOG_CRUD_INFO("[CRUD] HTTP Manager data interval updated");
     }
 
-    double value = command["value"].as<double>();
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["message"] =
+        "Server configuration updated. Device will restart in 10s.";
+    manager->sendResponse(*response);
+  } else {
+    // v1.0.2: Enhanced validation error response with field-specific details
+    const ConfigValidationResult& validation =
+        serverConfig->getLastValidationResult();
+
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "error";
+    (*response)["error_code"] = validation.errorCode;
+    (*response)["domain"] = "CONFIG";
+    (*response)["severity"] = "ERROR";
+    (*response)["message"] = validation.message;
 
-    // Determine device protocol (RTU or TCP)
-    JsonDocument deviceDoc;
-    JsonObject deviceObj = deviceDoc.to<JsonObject>();
-    bool isRtu = false;
-    bool isTcp = false;
-
-    if (configManager->readDevice(deviceId, deviceObj)) {
-      String protocol = deviceObj["protocol"] | "RTU";
-      protocol.toUpperCase();
-      isRtu = (protocol == "RTU");
-      isTcp = (protocol == "TCP");
-    } else {
-      manager->sendError("Device not found: " + deviceId, "register");
-      return;
+    // Include field info if available (helps mobile app highlight specific
+    // field)
+    if (!validation.field.isEmpty()) {
+      (*response)["field"] = validation.field;
     }
 
-    JsonObject respObj = response->to<JsonObject>();
-    bool success = false;
-
-    if (isRtu && modbusRtuService) {
-      success = modbusRtuService->writeRegisterValue(deviceId.c_str(),
-                                                     registerId.c_str(), value,
-                                                     respObj);
-    } else if (isTcp && modbusTcpService) {
-      success = modbusTcpService->writeRegisterValue(deviceId.c_str(),
-                                                     registerId.c_str(), value,
-                                                     respObj);
-    } else {
-      manager->sendError("No Modbus service available for device", "register");
-      return;
+    // Include suggestion for user
+    if (!validation.suggestion.isEmpty()) {
+      (*response)["suggestion"] = validation.suggestion;
     }
 
-    // Send response
+    LOG_CRUD_WARN("[CRUD] Server config validation failed: %s (field: %s)",
+                  validation.message.c_str(), validation.field.c_str());
+
     manager->sendResponse(*response);
+  }
+}
 
-    LOG_BLE_INFO("[WRITE_REGISTER] device=%s, register=%s, value=%.4f, success=%d\n",
-                 deviceId.c_str(), registerId.c_str(), value, success);
-  };
+void CRUDHandler::updateLoggingConfig(BLEManager* manager,
+                                      const JsonDocument& command) {
+  JsonObjectConst config = command["config"];
+  if (loggingConfig->updateConfig(config)) {
+    auto response = make_psram_unique<JsonDocument>();
+    (*response)["status"] = "ok";
+    (*response)["message"] = "Logging configuration updated";
+    manager->sendResponse(*response);
+  } else {
+    manager->sendError("Logging configuration update failed",
+                       "logging_config");
+  }
+}
 
-  // === CONTROL HANDLERS (Device Enable/Disable/Status) ===
+// === DELETE HANDLERS ===
+void CRUDHandler::deleteDevice(BLEManager* manager,
+                               const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
 
-  controlHandlers["enable_device"] = [this](BLEManager* manager,
-                                            const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    bool clearMetrics = command["clear_metrics"] | false;
+  // Get device data before deletion for response
+  auto response = make_psram_unique<JsonDocument>();
+  JsonObject deletedData = (*response)["deleted_data"].to<JsonObject>();
+  configManager->readDevice(deviceId, deletedData);
 
-    auto response = make_psram_unique<JsonDocument>();
+  if (configManager->deleteDevice(deviceId)) {
+    // CRITICAL FIX: Notify MQTT to refresh device configs
+    notifyAllServices(ModbusConfigChange(ModbusConfigChange::DEVICE_REMOVED,
+                                         deviceId.c_str()));
 
-    if (deviceId.isEmpty()) {
-      manager->sendError("device_id is required", "device");
-      return;
-    }
+    // Return deleted device data
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["message"] = "Device deleted";
 
-    // Check device protocol to route to correct service
-    JsonDocument deviceDoc;
-    JsonObject device = deviceDoc.to<JsonObject>();
-    if (!configManager->readDevice(deviceId, device)) {
-      manager->sendError("Device not found", "device");
-      return;
+    manager->sendResponse(*response);
+  } else {
+    manager->sendError("Device deletion failed", "device");
+  }
+}
+
+void CRUDHandler::deleteRegister(BLEManager* manager,
+                                 const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  String registerId = command["register_id"] | "";
+
+  // Get register data before deletion for response
+  auto response = make_psram_unique<JsonDocument>();
+
+  // Load device and find the register before deletion
+  // BUG #31: Global PSRAM allocator handles all JsonDocument instances
+  // automatically
+  JsonDocument deviceDoc;
+  JsonObject device = deviceDoc.to<JsonObject>();
+  if (configManager->readDevice(deviceId, device) &&
+      device["registers"].is<JsonArray>()) {
+    JsonArray registers = device["registers"];
+    for (JsonObject reg : registers) {
+      if (reg["register_id"] == registerId) {
+        (*response)["deleted_data"] = reg;
+        break;
+      }
     }
+  }
 
-    String protocol = device["protocol"] | "";
-    bool success = false;
+  if (configManager->deleteRegister(deviceId, registerId)) {
+    // CRITICAL FIX: Register count affects MQTT timeout
+    notifyAllServices(ModbusConfigChange(
+        ModbusConfigChange::REGISTERS_CHANGED, deviceId.c_str()));
 
-    if (protocol == "RTU" && modbusRtuService) {
-      success = modbusRtuService->enableDeviceByCommand(deviceId.c_str(),
-                                                        clearMetrics);
-    } else if (protocol == "TCP" && modbusTcpService) {
-      // v2.5.41: Add .c_str() for const char* parameter
-      success = modbusTcpService->enableDeviceByCommand(deviceId.c_str(),
-                                                        clearMetrics);
-    } else {
-      manager->sendError("Invalid protocol or service not available", "device");
-      return;
-    }
+    // Return deleted register data
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["register_id"] = registerId;
+    (*response)["message"] = "Register deleted";
 
-    if (success) {
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["message"] = "Device enabled";
-      (*response)["metrics_cleared"] = clearMetrics;
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Failed to enable device", "device");
-    }
-  };
+    manager->sendResponse(*response);
+  } else {
+    manager->sendError("Register deletion failed", "registers");
+  }
+}
 
-  controlHandlers["disable_device"] = [this](BLEManager* manager,
-                                             const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
-    String reason = command["reason"] | "Manual disable via BLE";
+// === WRITE HANDLERS (v1.0.8: Write Register Support) ===
 
-    auto response = make_psram_unique<JsonDocument>();
+void CRUDHandler::writeRegister(BLEManager* manager,
+                                const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  String registerId = command["register_id"] | "";
 
-    if (deviceId.isEmpty()) {
-      manager->sendError("device_id is required", "device");
-      return;
-    }
+  auto response = make_psram_unique<JsonDocument>();
 
-    // Check device protocol to route to correct service
-    JsonDocument deviceDoc;
-    JsonObject device = deviceDoc.to<JsonObject>();
-    if (!configManager->readDevice(deviceId, device)) {
-      manager->sendError("Device not found", "device");
-      return;
-    }
+  if (deviceId.isEmpty()) {
+    manager->sendError("device_id is required", "register");
+    return;
+  }
 
-    String protocol = device["protocol"] | "";
-    bool success = false;
+  if (registerId.isEmpty()) {
+    manager->sendError("register_id is required", "register");
+    return;
+  }
 
-    if (protocol == "RTU" && modbusRtuService) {
-      success = modbusRtuService->disableDeviceByCommand(deviceId.c_str(),
-                                                         reason.c_str());
-    } else if (protocol == "TCP" && modbusTcpService) {
-      // v2.5.41: Add .c_str() for const char* parameters
-      success = modbusTcpService->disableDeviceByCommand(deviceId.c_str(),
-                                                         reason.c_str());
-    } else {
-      manager->sendError("Invalid protocol or service not available", "device");
-      return;
-    }
+  if (command["value"].isNull()) {
+    manager->sendError("value is required", "register");
+    return;
+  }
 
-    if (success) {
-      (*response)["status"] = "ok";
-      (*response)["device_id"] = deviceId;
-      (*response)["message"] = "Device disabled";
-      (*response)["reason"] = reason;
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Failed to disable device", "device");
-    }
-  };
+  double value = command["value"].as<double>();
 
-  controlHandlers["get_device_status"] = [this](BLEManager* manager,
-                                                const JsonDocument& command) {
-    String deviceId = command["device_id"] | "";
+  // Determine device protocol (RTU or TCP)
+  JsonDocument deviceDoc;
+  JsonObject deviceObj = deviceDoc.to<JsonObject>();
+  bool isRtu = false;
+  bool isTcp = false;
 
-    auto response = make_psram_unique<JsonDocument>();
+  if (configManager->readDevice(deviceId, deviceObj)) {
+    String protocol = deviceObj["protocol"] | "RTU";
+    protocol.toUpperCase();
+    isRtu = (protocol == "RTU");
+    isTcp = (protocol == "TCP");
+  } else {
+    manager->sendError("Device not found: " + deviceId, "register");
+    return;
+  }
 
-    if (deviceId.isEmpty()) {
-      manager->sendError("device_id is required", "device");
-      return;
-    }
+  JsonObject respObj = response->to<JsonObject>();
+  bool success = false;
+
+  if (isRtu && modbusRtuService) {
+    success = modbusRtuService->writeRegisterValue(deviceId.c_str(),
+                                                   registerId.c_str(), value,
+                                                   respObj);
+  } else if (isTcp && modbusTcpService) {
+    success = modbusTcpService->writeRegisterValue(deviceId.c_str(),
+                                                   registerId.c_str(), value,
+                                                   respObj);
+  } else {
+    manager->sendError("No Modbus service available for device", "register");
+    return;
+  }
 
-    // Check device protocol to route to correct service
-    JsonDocument deviceDoc;
-    JsonObject device = deviceDoc.to<JsonObject>();
-    if (!configManager->readDevice(deviceId, device)) {
-      manager->sendError("Device not found", "device");
-      return;
-    }
+  // Send response
+  manager->sendResponse(*response);
 
-    String protocol = device["protocol"] | "";
-    bool success = false;
+  LOG_BLE_INFO("[WRITE_REGISTER] device=%s, register=%s, value=%.4f, success=%d\n",
+               deviceId.c_str(), registerId.c_str(), value, success);
+}
 
-    (*response)["status"] = "ok";
-    JsonObject statusInfo = (*response)["device_status"].to<JsonObject>();
-
-    if (protocol == "RTU" && modbusRtuService) {
-      success =
-          modbusRtuService->getDeviceStatusInfo(deviceId.c_str(), statusInfo);
-    } else if (protocol == "TCP" && modbusTcpService) {
-      // v2.5.41: Add .c_str() for const char* parameter
-      success =
-          modbusTcpService->getDeviceStatusInfo(deviceId.c_str(), statusInfo);
-    } else {
-      manager->sendError("Invalid protocol or service not available", "device");
-      return;
-    }
+// === CONTROL HANDLERS (Device Enable/Disable/Status) ===
 
-    if (success) {
-      manager->sendResponse(*response);
-    } else {
-      manager->sendError("Failed to get device status", "device");
-    }
-  };
+void CRUDHandler::controlEnableDevice(BLEManager* manager,
+                                      const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  bool clearMetrics = command["clear_metrics"] | false;
 
-  controlHandlers["get_all_device_status"] =
-      [this](BLEManager* manager, const JsonDocument& command) {
-        auto response = make_psram_unique<JsonDocument>();
-        (*response)["status"] = "ok";
+  auto response = make_psram_unique<JsonDocument>();
 
-        // Get RTU devices status
-        if (modbusRtuService) {
-          JsonObject rtuStatus = (*response)["rtu_devices"].to<JsonObject>();
-          modbusRtuService->getAllDevicesStatus(rtuStatus);
-        }
+  if (deviceId.isEmpty()) {
+    manager->sendError("device_id is required", "device");
+    return;
+  }
 
-        // Get TCP devices status
-        if (modbusTcpService) {
-          JsonObject tcpStatus = (*response)["tcp_devices"].to<JsonObject>();
-          modbusTcpService->getAllDevicesStatus(tcpStatus);
-        }
+  // Check device protocol to route to correct service
+  JsonDocument deviceDoc;
+  JsonObject device = deviceDoc.to<JsonObject>();
+  if (!configManager->readDevice(deviceId, device)) {
+    manager->sendError("Device not found", "device");
+    return;
+  }
 
-        manager->sendResponse(*response);
-      };
-
-  // Set Production Mode - Switch between dev (0) and production (1) mode via
-  // BLE
-  controlHandlers["set_production_mode"] = [this](BLEManager* manager,
-                                                  const JsonDocument& command) {
-    // Get requested mode (0 = Development, 1 = Production)
-    if (command["mode"].isNull()) {
-      manager->sendError(
-          "mode parameter required (0 = Development, 1 = Production)",
-          "control");
-      return;
-    }
+  String protocol = device["protocol"] | "";
+  bool success = false;
 
-    uint8_t requestedMode = command["mode"] | 255;  // 255 = invalid
+  if (protocol == "RTU" && modbusRtuService) {
+    success = modbusRtuService->enableDeviceByCommand(deviceId.c_str(),
+                                                      clearMetrics);
+  } else if (protocol == "TCP" && modbusTcpService) {
+    // v2.5.41: Add .c_str() for const char* parameter
+    success = modbusTcpService->enableDeviceByCommand(deviceId.c_str(),
+                                                      clearMetrics);
+  } else {
+    manager->sendError("Invalid protocol or service not available", "device");
+    return;
+  }
 
-    if (requestedMode > 1) {
-      manager->sendError(
-          "Invalid mode value. Use 0 (Development) or 1 (Production)",
-          "control");
-      return;
-    }
+  if (success) {
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["message"] = "Device enabled";
+    (*response)["metrics_cleared"] = clearMetrics;
+    manager->sendResponse(*response);
+  } else {
+    manager->sendError("Failed to enable device", "device");
+  }
+}
 
-    // Get current mode for comparison
-    uint8_t previousMode = g_productionMode;
+void CRUDHandler::controlDisableDevice(BLEManager* manager,
+                                       const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
+  String reason = command["reason"] | "Manual disable via BLE";
 
-    // Update global runtime mode
-    g_productionMode = requestedMode;
+  auto response = make_psram_unique<JsonDocument>();
 
-    // Save to logging config for persistence across reboots
-    if (loggingConfig) {
-      loggingConfig->setProductionMode(requestedMode);
-      loggingConfig->save();
-    }
+  if (deviceId.isEmpty()) {
+    manager->sendError("device_id is required", "device");
+    return;
+  }
 
-    // Prepare response
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["previous_mode"] = previousMode;
-    (*response)["current_mode"] = g_productionMode;
-    (*response)["mode_name"] =
-        (g_productionMode == 0) ? "Development" : "Production";
-    (*response)["message"] =
-        "Production mode updated. Device will restart in 2 seconds...";
-    (*response)["persistent"] = (loggingConfig != nullptr);
-    (*response)["restarting"] = true;
+  // Check device protocol to route to correct service
+  JsonDocument deviceDoc;
+  JsonObject device = deviceDoc.to<JsonObject>();
+  if (!configManager->readDevice(deviceId, device)) {
+    manager->sendError("Device not found", "device");
+    return;
+  }
+
+  String protocol = device["protocol"] | "";
+  bool success = false;
 
+  if (protocol == "RTU" && modbusRtuService) {
+    success = modbusRtuService->disableDeviceByCommand(deviceId.c_str(),
+                                                       reason.c_str());
+  } else if (protocol == "TCP" && modbusTcpService) {
+    // v2.5.41: Add .c_str() for const char* parameters
+    success = modbusTcpService->disableDeviceByCommand(deviceId.c_str(),
+                                                       reason.c_str());
+  } else {
+    manager->sendError("Invalid protocol or service not available", "device");
+    return;
+  }
+
+  if (success) {
+    (*response)["status"] = "ok";
+    (*response)["device_id"] = deviceId;
+    (*response)["message"] = "Device disabled";
+    (*response)["reason"] = reason;
     manager->sendResponse(*response);
+  } else {
+    manager->sendError("Failed to disable device", "device");
+  }
+}
 
-    // Log the change - INTENTIONAL: Always log production mode changes for
-    // audit This is a critical system event that should be visible even in
-    // production
-    Serial.printf("\n[SYSTEM] Production mode changed: %d -> %d (%s)\n",
-                  previousMode, g_productionMode,
-                  (g_productionMode == 0) ? "Development" : "Production");
-    Serial.println("[SYSTEM] Device will restart in 2 seconds...");
-
-    // Wait for BLE response to be sent, then restart
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    ESP.restart();
-  };
+void CRUDHandler::controlGetDeviceStatus(BLEManager* manager,
+                                         const JsonDocument& command) {
+  String deviceId = command["device_id"] | "";
 
-  // === GATEWAY IDENTITY HANDLERS (v2.5.31) ===
+  auto response = make_psram_unique<JsonDocument>();
 
-  // Get Gateway Info - Return unique gateway identification for mobile app
-  // v2.5.36: Complete response with all gateway identity fields
-  controlHandlers["get_gateway_info"] = [this](BLEManager* manager,
-                                               const JsonDocument& command) {
-    GatewayConfig* gwConfig = GatewayConfig::getInstance();
-    if (!gwConfig) {
-      manager->sendError("Gateway config not initialized", "control");
-      return;
-    }
+  if (deviceId.isEmpty()) {
+    manager->sendError("device_id is required", "device");
+    return;
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["command"] = "get_gateway_info";
-
-    // v2.5.36: Complete gateway identity in "data" object
-    JsonObject data = (*response)["data"].to<JsonObject>();
-
-    // Gateway identification
-    data["ble_name"] = gwConfig->getBLEName();
-    data["mac"] = gwConfig->getMACString();
-    data["uid"] = gwConfig->getUID();
-    data["short_mac"] = gwConfig->getShortMAC();
-    data["serial_number"] = gwConfig->getSerialNumber();
-    data["friendly_name"] = gwConfig->getFriendlyName();
-    data["location"] = gwConfig->getLocation();
-
-    // Product info from ProductConfig.h
-    data["firmware"] = FIRMWARE_VERSION;
-    data["build_number"] = FIRMWARE_BUILD_NUMBER;
-    data["model"] = PRODUCT_FULL_MODEL;
-    data["variant"] = PRODUCT_VARIANT;
-    data["is_poe"] = (bool)PRODUCT_IS_POE;
-    data["manufacturer"] = MANUFACTURER_NAME;
+  // Check device protocol to route to correct service
+  JsonDocument deviceDoc;
+  JsonObject device = deviceDoc.to<JsonObject>();
+  if (!configManager->readDevice(deviceId, device)) {
+    manager->sendError("Device not found", "device");
+    return;
+  }
+
+  String protocol = device["protocol"] | "";
+  bool success = false;
+
+  (*response)["status"] = "ok";
+  JsonObject statusInfo = (*response)["device_status"].to<JsonObject>();
+
+  if (protocol == "RTU" && modbusRtuService) {
+    success =
+        modbusRtuService->getDeviceStatusInfo(deviceId.c_str(), statusInfo);
+  } else if (protocol == "TCP" && modbusTcpService) {
+    // v2.5.41: Add .c_str() for const char* parameter
+    success =
+        modbusTcpService->getDeviceStatusInfo(deviceId.c_str(), statusInfo);
+  } else {
+    manager->sendError("Invalid protocol or service not available", "device");
+    return;
+  }
 
+  if (success) {
     manager->sendResponse(*response);
-    LOG_CRUD_INFO("[CRUD] Gateway info sent: %s (SN: %s)",
-                  gwConfig->getBLEName(), gwConfig->getSerialNumber());
-  };
+  } else {
+    manager->sendError("Failed to get device status", "device");
+  }
+}
 
-  // === NETWORK STATUS API (v2.5.38) ===
-  // Get Network Status - Network connectivity check for Mobile Apps (OTA
-  // pre-check)
-  controlHandlers["get_network_status"] = [this](BLEManager* manager,
-                                                 const JsonDocument& command) {
-    NetworkMgr* netMgr = NetworkMgr::getInstance();
-    if (!netMgr) {
-      manager->sendError("Network manager not initialized", "control");
-      return;
-    }
+void CRUDHandler::controlGetAllDeviceStatus(BLEManager* manager,
+                                            const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["command"] = "get_network_status";
-
-    JsonObject data = (*response)["data"].to<JsonObject>();
-
-    // Network availability
-    bool networkAvailable = netMgr->isAvailable();
-    data["network_available"] = networkAvailable;
-    data["active_mode"] = netMgr->getCurrentMode();
-    data["ip_address"] = netMgr->getLocalIP().toString();
-
-    // WiFi status
-    JsonObject wifiStatus = data["wifi"].to<JsonObject>();
-    WiFiManager* wifiMgr = WiFiManager::getInstance();
-    if (wifiMgr && wifiMgr->isInitialized()) {
-      wifiMgr->getStatus(wifiStatus);
-      // Add signal quality for OTA recommendation
-      wifiStatus["signal_quality"] = netMgr->getWiFiSignalQuality();
-    } else {
-      wifiStatus["initialized"] = false;
-      wifiStatus["available"] = false;
-    }
+  // Get RTU devices status
+  if (modbusRtuService) {
+    JsonObject rtuStatus = (*response)["rtu_devices"].to<JsonObject>();
+    modbusRtuService->getAllDevicesStatus(rtuStatus);
+  }
 
-    // Ethernet status
-    JsonObject ethStatus = data["ethernet"].to<JsonObject>();
-    EthernetManager* ethMgr = EthernetManager::getInstance();
-    if (ethMgr && ethMgr->isInitialized()) {
-      ethMgr->getStatus(ethStatus);
-    } else {
-      ethStatus["initialized"] = false;
-      ethStatus["available"] = false;
-    }
+  // Get TCP devices status
+  if (modbusTcpService) {
+    JsonObject tcpStatus = (*response)["tcp_devices"].to<JsonObject>();
+    modbusTcpService->getAllDevicesStatus(tcpStatus);
+  }
+
+  manager->sendResponse(*response);
+}
 
-    // OTA readiness assessment
-    bool otaReady = false;
-    String otaRecommendation;
+// Set Production Mode - Switch between dev (0) and production (1) mode via
+// BLE
+void CRUDHandler::controlSetProductionMode(BLEManager* manager,
+                                           const JsonDocument& command) {
+  // Get requested mode (0 = Development, 1 = Production)
+  if (command["mode"].isNull()) {
+    manager->sendError(
+        "mode parameter required (0 = Development, 1 = Production)",
+        "control");
+    return;
+  }
 
-    if (!networkAvailable) {
-      otaRecommendation =
-          "No network connection. Connect to WiFi or Ethernet before OTA.";
-    } else {
-      String mode = netMgr->getCurrentMode();
-      if (mode == "ETH") {
-        // Ethernet is always good for OTA
+  uint8_t requestedMode = command["mode"] | 255;  // 255 = invalid
+
+  if (requestedMode > 1) {
+    manager->sendError(
+        "Invalid mode value. Use 0 (Development) or 1 (Production)",
+        "control");
+    return;
+  }
+
+  // Get current mode for comparison
+  uint8_t previousMode = g_productionMode;
+
+  // Update global runtime mode
+  g_productionMode = requestedMode;
+
+  // Save to logging config for persistence across reboots
+  if (loggingConfig) {
+    loggingConfig->setProductionMode(requestedMode);
+    loggingConfig->save();
+  }
+
+  // Prepare response
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["previous_mode"] = previousMode;
+  (*response)["current_mode"] = g_productionMode;
+  (*response)["mode_name"] =
+      (g_productionMode == 0) ? "Development" : "Production";
+  (*response)["message"] =
+      "Production mode updated. Device will restart in 2 seconds...";
+  (*response)["persistent"] = (loggingConfig != nullptr);
+  (*response)["restarting"] = true;
+
+  manager->sendResponse(*response);
+
+  // Log the change - INTENTIONAL: Always log production mode changes for
+  // audit This is a critical system event that should be visible even in
+  // production
+  Serial.printf("\n[SYSTEM] Production mode changed: %d -> %d (%s)\n",
+                previousMode, g_productionMode,
+                (g_productionMode == 0) ? "Development" : "Production");
+  Serial.println("[SYSTEM] Device will restart in 2 seconds...");
+
+  // Wait for BLE response to be sent, then restart
+  vTaskDelay(pdMS_TO_TICKS(2000));
+  ESP.restart();
+}
+
+// === GATEWAY IDENTITY HANDLERS (v2.5.31) ===
+
+// Get Gateway Info - Return unique gateway identification for mobile app
+// v2.5.36: Complete response with all gateway identity fields
+void CRUDHandler::controlGetGatewayInfo(BLEManager* manager,
+                                        const JsonDocument& command) {
+  GatewayConfig* gwConfig = GatewayConfig::getInstance();
+  if (!gwConfig) {
+    manager->sendError("Gateway config not initialized", "control");
+    return;
+  }
+
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["command"] = "get_gateway_info";
+
+  // v2.5.36: Complete gateway identity in "data" object
+  JsonObject data = (*response)["data"].to<JsonObject>();
+
+  // Gateway identification
+  data["ble_name"] = gwConfig->getBLEName();
+  data["mac"] = gwConfig->getMACString();
+  data["uid"] = gwConfig->getUID();
+  data["short_mac"] = gwConfig->getShortMAC();
+  data["serial_number"] = gwConfig->getSerialNumber();
+  data["friendly_name"] = gwConfig->getFriendlyName();
+  data["location"] = gwConfig->getLocation();
+
+  // Product info from ProductConfig.h
+  data["firmware"] = FIRMWARE_VERSION;
+  data["build_number"] = FIRMWARE_BUILD_NUMBER;
+  data["model"] = PRODUCT_FULL_MODEL;
+  data["variant"] = PRODUCT_VARIANT;
+  data["is_poe"] = (bool)PRODUCT_IS_POE;
+  data["manufacturer"] = MANUFACTURER_NAME;
+
+  // v1.3.3: Optional protocol features the app may opt into
+  JsonObject capabilities = data["capabilities"].to<JsonObject>();
+  JsonObject compression = capabilities["compression"].to<JsonObject>();
+  compression["encoding"] = "heatshrink";  // "compress":"heatshrink"
+  compression["window_bits"] = HeatshrinkEncoder::WINDOW_BITS;
+  compression["lookahead_bits"] = HeatshrinkEncoder::LOOKAHEAD_BITS;
+  compression["min_size"] = BLE_COMPRESS_MIN_BYTES;
+  capabilities["binary_stream"] = true;  // "format":"binary" on data read
+
+  manager->sendResponse(*response);
+  LOG_CRUD_INFO("[CRUD] Gateway info sent: %s (SN: %s)",
+                gwConfig->getBLEName(), gwConfig->getSerialNumber());
+}
+
+// === NETWORK STATUS API (v2.5.38) ===
+// Get Network Status - Network connectivity check for Mobile Apps (OTA
+// pre-check)
+void CRUDHandler::controlGetNetworkStatus(BLEManager* manager,
+                                          const JsonDocument& command) {
+  NetworkMgr* netMgr = NetworkMgr::getInstance();
+  if (!netMgr) {
+    manager->sendError("Network manager not initialized", "control");
+    return;
+  }
+
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["command"] = "get_network_status";
+
+  JsonObject data = (*response)["data"].to<JsonObject>();
+
+  // Network availability
+  bool networkAvailable = netMgr->isAvailable();
+  data["network_available"] = networkAvailable;
+  data["active_mode"] = netMgr->getCurrentMode();
+  data["ip_address"] = netMgr->getLocalIP().toString();
+
+  // WiFi status
+  JsonObject wifiStatus = data["wifi"].to<JsonObject>();
+  WiFiManager* wifiMgr = WiFiManager::getInstance();
+  if (wifiMgr && wifiMgr->isInitialized()) {
+    wifiMgr->getStatus(wifiStatus);
+    // Add signal quality for OTA recommendation
+    wifiStatus["signal_quality"] = netMgr->getWiFiSignalQuality();
+  } else {
+    wifiStatus["initialized"] = false;
+    wifiStatus["available"] = false;
+  }
+
+  // Ethernet status
+  JsonObject ethStatus = data["ethernet"].to<JsonObject>();
+  EthernetManager* ethMgr = EthernetManager::getInstance();
+  if (ethMgr && ethMgr->isInitialized()) {
+    ethMgr->getStatus(ethStatus);
+  } else {
+    ethStatus["initialized"] = false;
+    ethStatus["available"] = false;
+  }
+
+  // OTA readiness assessment
+  bool otaReady = false;
+  String otaRecommendation;
+
+  if (!networkAvailable) {
+    otaRecommendation =
+        "No network connection. Connect to WiFi or Ethernet before OTA.";
+  } else {
+    String mode = netMgr->getCurrentMode();
+    if (mode == "ETH") {
+      // Ethernet is always good for OTA
+      otaReady = true;
+      otaRecommendation = "Ethernet connected. Recommended for OTA update.";
+    } else if (mode == "WIFI") {
+      uint8_t quality = netMgr->getWiFiSignalQuality();
+      if (quality >= 50) {
+        otaReady = true;
+        otaRecommendation =
+            "WiFi signal good (" + String(quality) + "%). OK for OTA update.";
+      } else if (quality >= 30) {
         otaReady = true;
-        otaRecommendation = "Ethernet connected. Recommended for OTA update.";
-      } else if (mode == "WIFI") {
-        uint8_t quality = netMgr->getWiFiSignalQuality();
-        if (quality >= 50) {
-          otaReady = true;
-          otaRecommendation =
-              "WiFi signal good (" + String(quality) + "%). OK for OTA update.";
-        } else if (quality >= 30) {
-          otaReady = true;
-          otaRecommendation =
-              "WiFi signal fair (" + String(quality) +
-              "%). OTA may be slow, consider moving closer to router.";
-        } else {
-          otaReady = false;
-          otaRecommendation = "WiFi signal weak (" + String(quality) +
-                              "%). Not recommended for OTA. Move closer to "
-                              "router or use Ethernet.";
-        }
-      } else {
         otaRecommendation =
-            "Unknown network mode. Check network configuration.";
+            "WiFi signal fair (" + String(quality) +
+            "%). OTA may be slow, consider moving closer to router.";
+      } else {
+        otaReady = false;
+        otaRecommendation = "WiFi signal weak (" + String(quality) +
+                            "%). Not recommended for OTA. Move closer to "
+                            "router or use Ethernet.";
       }
+    } else {
+      otaRecommendation =
+          "Unknown network mode. Check network configuration.";
     }
+  }
 
-    data["ota_ready"] = otaReady;
-    data["ota_recommendation"] = otaRecommendation;
+  data["ota_ready"] = otaReady;
+  data["ota_recommendation"] = otaRecommendation;
 
-    manager->sendResponse(*response);
-    LOG_CRUD_INFO("[CRUD] Network status sent: %s, OTA ready: %s",
-                  netMgr->getCurrentMode().c_str(), otaReady ? "yes" : "no");
-  };
+  manager->sendResponse(*response);
+  LOG_CRUD_INFO("[CRUD] Network status sent: %s, OTA ready: %s",
+                netMgr->getCurrentMode().c_str(), otaReady ? "yes" : "no");
+}
 
-  // Set Friendly Name - Allow user to set custom name for this gateway
-  controlHandlers["set_friendly_name"] = [this](BLEManager* manager,
-                                                const JsonDocument& command) {
-    GatewayConfig* gwConfig = GatewayConfig::getInstance();
-    if (!gwConfig) {
-      manager->sendError("Gateway config not initialized", "control");
-      return;
-    }
+// Set Friendly Name - Allow user to set custom name for this gateway
+void CRUDHandler::controlSetFriendlyName(BLEManager* manager,
+                                         const JsonDocument& command) {
+  GatewayConfig* gwConfig = GatewayConfig::getInstance();
+  if (!gwConfig) {
+    manager->sendError("Gateway config not initialized", "control");
+    return;
+  }
 
-    // Validate name parameter (ArduinoJson 7.x: use is<T>() instead of
-    // containsKey)
-    if (!command["name"].is<const char*>()) {
-      manager->sendError("name parameter required", "control");
-      return;
-    }
+  // Validate name parameter (ArduinoJson 7.x: use is<T>() instead of
+  // containsKey)
+  if (!command["name"].is<const char*>()) {
+    manager->sendError("name parameter required", "control");
+    return;
+  }
 
-    String newName = command["name"].as<String>();
-    if (newName.length() == 0) {
-      manager->sendError("name cannot be empty", "control");
-      return;
-    }
+  String newName = command["name"].as<String>();
+  if (newName.length() == 0) {
+    manager->sendError("name cannot be empty", "control");
+    return;
+  }
 
-    if (newName.length() > 32) {
-      manager->sendError("name too long (max 32 chars)", "control");
-      return;
-    }
+  if (newName.length() > 32) {
+    manager->sendError("name too long (max 32 chars)", "control");
+    return;
+  }
 
-    // Save friendly name
-    if (!gwConfig->setFriendlyName(newName)) {
-      manager->sendError("Failed to save friendly name", "control");
-      return;
-    }
+  // Save friendly name
+  if (!gwConfig->setFriendlyName(newName)) {
+    manager->sendError("Failed to save friendly name", "control");
+    return;
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["command"] = "set_friendly_name";
-    (*response)["friendly_name"] = gwConfig->getFriendlyName();
-    (*response)["ble_name"] = gwConfig->getBLEName();
-    (*response)["message"] = "Friendly name updated successfully";
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["command"] = "set_friendly_name";
+  (*response)["friendly_name"] = gwConfig->getFriendlyName();
+  (*response)["ble_name"] = gwConfig->getBLEName();
+  (*response)["message"] = "Friendly name updated successfully";
 
-    manager->sendResponse(*response);
-    LOG_CRUD_INFO("[CRUD] Friendly name set to: %s", newName.c_str());
-  };
+  manager->sendResponse(*response);
+  LOG_CRUD_INFO("[CRUD] Friendly name set to: %s", newName.c_str());
+}
 
-  // Set Location - Allow user to set location for this gateway
-  controlHandlers["set_gateway_location"] =
-      [this](BLEManager* manager, const JsonDocument& command) {
-        GatewayConfig* gwConfig = GatewayConfig::getInstance();
-        if (!gwConfig) {
-          manager->sendError("Gateway config not initialized", "control");
-          return;
-        }
+// Set Location - Allow user to set location for this gateway
+void CRUDHandler::controlSetGatewayLocation(BLEManager* manager,
+                                            const JsonDocument& command) {
+  GatewayConfig* gwConfig = GatewayConfig::getInstance();
+  if (!gwConfig) {
+    manager->sendError("Gateway config not initialized", "control");
+    return;
+  }
 
-        // Validate location parameter (ArduinoJson 7.x: use is<T>() instead of
-        // containsKey)
-        if (!command["location"].is<const char*>()) {
-          manager->sendError("location parameter required", "control");
-          return;
-        }
+  // Validate location parameter (ArduinoJson 7.x: use is<T>() instead of
+  // containsKey)
+  if (!command["location"].is<const char*>()) {
+    manager->sendError("location parameter required", "control");
+    return;
+  }
 
-        String newLocation = command["location"].as<String>();
-        if (newLocation.length() > 64) {
-          manager->sendError("location too long (max 64 chars)", "control");
-          return;
-        }
+  String newLocation = command["location"].as<String>();
+  if (newLocation.length() > 64) {
+    manager->sendError("location too long (max 64 chars)", "control");
+    return;
+  }
 
-        // Save location (empty string allowed to clear)
-        if (!gwConfig->setLocation(newLocation)) {
-          manager->sendError("Failed to save location", "control");
-          return;
-        }
+  // Save location (empty string allowed to clear)
+  if (!gwConfig->setLocation(newLocation)) {
+    manager->sendError("Failed to save location", "control");
+    return;
+  }
 
-        auto response = make_psram_unique<JsonDocument>();
-        (*response)["status"] = "ok";
-        (*response)["command"] = "set_gateway_location";
-        (*response)["location"] = gwConfig->getLocation();
-        (*response)["ble_name"] = gwConfig->getBLEName();
-        (*response)["message"] = "Location updated successfully";
-
-        manager->sendResponse(*response);
-        LOG_CRUD_INFO("[CRUD] Location set to: %s", newLocation.c_str());
-      };
-
-  // === v1.3.0: MQTT STATUS API (Desktop App MQTT Monitor) ===
-  // Get MQTT Status - Full MQTT status with statistics and topic lists
-  controlHandlers["get_mqtt_status"] = [this](BLEManager* manager,
-                                              const JsonDocument& command) {
-    MqttManager* mqttMgr = MqttManager::getInstance();
-    if (!mqttMgr) {
-      manager->sendError("MQTT manager not initialized", "control");
-      return;
-    }
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["command"] = "set_gateway_location";
+  (*response)["location"] = gwConfig->getLocation();
+  (*response)["ble_name"] = gwConfig->getBLEName();
+  (*response)["message"] = "Location updated successfully";
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["command"] = "get_mqtt_status";
+  manager->sendResponse(*response);
+  LOG_CRUD_INFO("[CRUD] Location set to: %s", newLocation.c_str());
+}
 
-    JsonObject data = (*response)["data"].to<JsonObject>();
+// === v1.3.0: MQTT STATUS API (Desktop App MQTT Monitor) ===
+// Get MQTT Status - Full MQTT status with statistics and topic lists
+void CRUDHandler::controlGetMqttStatus(BLEManager* manager,
+                                       const JsonDocument& command) {
+  MqttManager* mqttMgr = MqttManager::getInstance();
+  if (!mqttMgr) {
+    manager->sendError("MQTT manager not initialized", "control");
+    return;
+  }
 
-    // Get full MQTT status including statistics and topic lists
-    mqttMgr->getFullStatus(data);
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["command"] = "get_mqtt_status";
 
-    manager->sendResponse(*response);
-    LOG_CRUD_INFO("[CRUD] MQTT status sent");
-  };
+  JsonObject data = (*response)["data"].to<JsonObject>();
 
-  // === SYSTEM HANDLERS ===
+  // Get full MQTT status including statistics and topic lists
+  mqttMgr->getFullStatus(data);
 
-  // Factory Reset - Simple single-command reset
-  systemHandlers["factory_reset"] = [this](BLEManager* manager,
-                                           const JsonDocument& command) {
-    String reason = command["reason"] | "No reason provided";
-
-    // Get RTC timestamp for audit trail
-    RTCManager* rtc = RTCManager::getInstance();
-    String timestamp = "Unknown";
-    if (rtc) {
-      DateTime now = rtc->getCurrentTime();
-      // Check if RTC time is valid (year >= 2024)
-      if (now.year() >= 2024) {
-        char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d",
-                 now.year(), now.month(), now.day(), now.hour(), now.minute(),
-                 now.second());
-        timestamp = String(buffer);
-      } else {
-        // RTC time invalid, use uptime
-        timestamp = String(millis() / 1000) + "s uptime";
-      }
+  manager->sendResponse(*response);
+  LOG_CRUD_INFO("[CRUD] MQTT status sent");
+}
+
+// === SYSTEM HANDLERS ===
+
+// Factory Reset - Simple single-command reset
+void CRUDHandler::systemFactoryReset(BLEManager* manager,
+                                     const JsonDocument& command) {
+  String reason = command["reason"] | "No reason provided";
+
+  // Get RTC timestamp for audit trail
+  RTCManager* rtc = RTCManager::getInstance();
+  String timestamp = "Unknown";
+  if (rtc) {
+    DateTime now = rtc->getCurrentTime();
+    // Check if RTC time is valid (year >= 2024)
+    if (now.year() >= 2024) {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d",
+               now.year(), now.month(), now.day(), now.hour(), now.minute(),
+               now.second());
+      timestamp = String(buffer);
     } else {
+      // RTC time invalid, use uptime
       timestamp = String(millis() / 1000) + "s uptime";
     }
+  } else {
+    timestamp = String(millis() / 1000) + "s uptime";
+  }
 
-    // Serial log audit trail - INTENTIONAL: Always log factory reset for audit
-    // This is a critical destructive operation that should be visible even in
-    // production
-    Serial.println("\n[FACTORY RESET] WARNING - INITIATED by BLE client");
-    Serial.printf("  Timestamp: %s\n", timestamp.c_str());
-    Serial.printf("  Reason: %s\n", reason.c_str());
-    Serial.println(
-        "  This will ERASE all device, server, and network configurations!\n");
+  // Serial log audit trail - INTENTIONAL: Always log factory reset for audit
+  // This is a critical destructive operation that should be visible even in
+  // production
+  Serial.println("\n[FACTORY RESET] WARNING - INITIATED by BLE client");
+  Serial.printf("  Timestamp: %s\n", timestamp.c_str());
+  Serial.printf("  Reason: %s\n", reason.c_str());
+  Serial.println(
+      "  This will ERASE all device, server, and network configurations!\n");
 
-    // Write to persistent audit log file
-    File auditLog = LittleFS.open("/factory_reset_audit.log", "a");
-    if (auditLog) {
-      size_t bytesWritten = auditLog.printf("%s|%s|BLE Client|SUCCESS\n",
-                                            timestamp.c_str(), reason.c_str());
-      auditLog.close();
+  // Write to persistent audit log file
+  File auditLog = LittleFS.open("/factory_reset_audit.log", "a");
+  if (auditLog) {
+    size_t bytesWritten = auditLog.printf("%s|%s|BLE Client|SUCCESS\n",
+                                          timestamp.c_str(), reason.c_str());
+    auditLog.close();
 
-      if (bytesWritten > 0) {
-        Serial.println(
-            "[FACTORY RESET] Audit log written to /factory_reset_audit.log");
-      } else {
-        Serial.println("[FACTORY RESET] WARNING: Failed to write to audit log");
-      }
+    if (bytesWritten > 0) {
+      Serial.println(
+          "[FACTORY RESET] Audit log written to /factory_reset_audit.log");
     } else {
-      Serial.println("[FACTORY RESET] ERROR: Failed to open audit log file");
+      Serial.println("[FACTORY RESET] WARNING: Failed to write to audit log");
     }
+  } else {
+    Serial.println("[FACTORY RESET] ERROR: Failed to open audit log file");
+  }
 
-    // Send confirmation response BEFORE reset
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    (*response)["message"] =
-        "Factory reset initiated. Device will restart in 3 seconds.";
-    JsonArray configsCleared = (*response)["configs_cleared"].to<JsonArray>();
-    configsCleared.add("devices.json");
-    configsCleared.add("server_config.json");
-    configsCleared.add("logging_config.json");
-    (*response)["restart_in_ms"] = 3000;
+  // Send confirmation response BEFORE reset
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  (*response)["message"] =
+      "Factory reset initiated. Device will restart in 3 seconds.";
+  JsonArray configsCleared = (*response)["configs_cleared"].to<JsonArray>();
+  configsCleared.add("devices.json");
+  configsCleared.add("server_config.json");
+  configsCleared.add("logging_config.json");
+  (*response)["restart_in_ms"] = 3000;
 
-    manager->sendResponse(*response);
+  manager->sendResponse(*response);
 
-    // Wait 500ms for BLE response to be sent
-    delay(500);
+  // Wait 500ms for BLE response to be sent
+  delay(500);
 
-    // Perform factory reset
-    performFactoryReset();
-  };
+  // Perform factory reset
+  performFactoryReset();
+}
 
-  // Config Restore - Import full configuration from backup
-  systemHandlers["restore_config"] = [this](BLEManager* manager,
-                                            const JsonDocument& command) {
-    Serial.println("\n[CONFIG RESTORE] INITIATED by BLE client");
+// Config Restore - Import full configuration from backup
+void CRUDHandler::systemRestoreConfig(BLEManager* manager,
+                                      const JsonDocument& command) {
+  Serial.println("\n[CONFIG RESTORE] INITIATED by BLE client");
 
 // BUG #32 DEBUG: Show what's actually in the payload
 #if PRODUCTION_MODE == 0
-    Serial.println("[CONFIG RESTORE] DEBUG: Payload analysis:");
-    Serial.printf("  - Document is null: %s\n",
-                  command.isNull() ? "YES" : "NO");
-    Serial.printf("  - Document serialized size: %u bytes\n",
-                  measureJson(command));
-    Serial.printf("  - Document is object: %s\n",
-                  command.is<JsonObject>() ? "YES" : "NO");
-
-    if (command.is<JsonObject>()) {
-      JsonObjectConst obj = command.as<JsonObjectConst>();
-      Serial.printf("  - Object has %u keys:\n", obj.size());
-      for (JsonPairConst kv : obj) {
-        Serial.printf("    - Key: '%s', Type: ", kv.key().c_str());
-        if (kv.value().is<JsonObject>())
-          Serial.println("JsonObject");
-        else if (kv.value().is<JsonArray>())
-          Serial.println("JsonArray");
-        else if (kv.value().is<const char*>())
-          Serial.printf("String (\"%s\")\n", kv.value().as<const char*>());
-        else if (kv.value().is<int>())
-          Serial.printf("Int (%d)\n", kv.value().as<int>());
-        else
-          Serial.println("Other");
-      }
+  Serial.println("[CONFIG RESTORE] DEBUG: Payload analysis:");
+  Serial.printf("  - Document is null: %s\n",
+                command.isNull() ? "YES" : "NO");
+  Serial.printf("  - Document serialized size: %u bytes\n",
+                measureJson(command));
+  Serial.printf("  - Document is object: %s\n",
+                command.is<JsonObject>() ? "YES" : "NO");
+
+  if (command.is<JsonObject>()) {
+    JsonObjectConst obj = command.as<JsonObjectConst>();
+    Serial.printf("  - Object has %u keys:\n", obj.size());
+    for (JsonPairConst kv : obj) {
+      Serial.printf("    - Key: '%s', Type: ", kv.key().c_str());
+      if (kv.value().is<JsonObject>())
+        Serial.println("JsonObject");
+      else if (kv.value().is<JsonArray>())
+        Serial.println("JsonArray");
+      else if (kv.value().is<const char*>())
+        Serial.printf("String (\"%s\")\n", kv.value().as<const char*>());
+      else if (kv.value().is<int>())
+        Serial.printf("Int (%d)\n", kv.value().as<int>());
+      else
+        Serial.println("Other");
     }
+  }
 
-    JsonVariantConst configCheck = command["config"];
-    Serial.printf("  - Has 'config' key: %s\n",
-                  !configCheck.isNull() ? "YES" : "NO");
-    if (!configCheck.isNull()) {
-      Serial.printf("  - 'config' is JsonObject: %s\n",
-                    command["config"].is<JsonObject>() ? "YES" : "NO");
-      Serial.printf("  - 'config' is null: %s\n",
-                    command["config"].isNull() ? "YES" : "NO");
-    }
+  JsonVariantConst configCheck = command["config"];
+  Serial.printf("  - Has 'config' key: %s\n",
+                !configCheck.isNull() ? "YES" : "NO");
+  if (!configCheck.isNull()) {
+    Serial.printf("  - 'config' is JsonObject: %s\n",
+                  command["config"].is<JsonObject>() ? "YES" : "NO");
+    Serial.printf("  - 'config' is null: %s\n",
+                  command["config"].isNull() ? "YES" : "NO");
+  }
 
-    // Show first 500 chars of serialized JSON for comparison
-    String serialized;
-    serializeJson(command, serialized);
-    Serial.printf("  - Serialized JSON (%u bytes):\n", serialized.length());
-    if (serialized.length() > 500) {
-      Serial.printf("    %s...\n", serialized.substring(0, 500).c_str());
-    } else {
-      Serial.printf("    %s\n", serialized.c_str());
-    }
+  // Show first 500 chars of serialized JSON for comparison
+  String serialized;
+  serializeJson(command, serialized);
+  Serial.printf("  - Serialized JSON (%u bytes):\n", serialized.length());
+  if (serialized.length() > 500) {
+    Serial.printf("    %s...\n", serialized.substring(0, 500).c_str());
+  } else {
+    Serial.printf("    %s\n", serialized.c_str());
+  }
 #endif
 
-    // BUG #32 FIX: Try accessing config directly instead of type checking
-    // Type check may fail even when data is valid (ArduinoJson v7 quirk with
-    // PSRAM)
-    JsonVariantConst configVariant = command["config"];
-
-    if (configVariant.isNull()) {
-      Serial.println("[CONFIG RESTORE] ERROR: 'config' key is null or missing");
-      manager->sendError("Missing 'config' object in restore payload",
-                         "full_config");
-      return;
-    }
-
-    // Try to access as object even if type check fails
-    JsonObjectConst restoreConfig = configVariant.as<JsonObjectConst>();
+  // BUG #32 FIX: Try accessing config directly instead of type checking
+  // Type check may fail even when data is valid (ArduinoJson v7 quirk with
+  // PSRAM)
+  JsonVariantConst configVariant = command["config"];
 
-    if (restoreConfig.isNull()) {
-      Serial.println(
-          "[CONFIG RESTORE] ERROR: Cannot cast 'config' to JsonObject");
-      manager->sendError("Invalid 'config' object in restore payload",
-                         "full_config");
-      return;
-    }
+  if (configVariant.isNull()) {
+    Serial.println("[CONFIG RESTORE] ERROR: 'config' key is null or missing");
+    manager->sendError("Missing 'config' object in restore payload",
+                       "full_config");
+    return;
+  }
 
-    Serial.printf("[CONFIG RESTORE] OK: Config object validated (%u keys)\n",
-                  restoreConfig.size());
+  // Try to access as object even if type check fails
+  JsonObjectConst restoreConfig = configVariant.as<JsonObjectConst>();
 
-    int successCount = 0;
-    int failCount = 0;
-    JsonArray restoredConfigs;
+  if (restoreConfig.isNull()) {
+    Serial.println(
+        "[CONFIG RESTORE] ERROR: Cannot cast 'config' to JsonObject");
+    manager->sendError("Invalid 'config' object in restore payload",
+                       "full_config");
+    return;
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    (*response)["status"] = "ok";
-    restoredConfigs = (*response)["restored_configs"].to<JsonArray>();
-
-    // Step 1: Restore devices configuration
-    Serial.println("[CONFIG RESTORE] [1/3] Restoring devices configuration...");
-    // v1.0.3: Send restore progress notification
-    // Mobile app MUST filter config_restore_progress notifications (like
-    // ota_progress)
-    manager->sendConfigRestoreProgress("devices", 1, 3);
-
-    // BUG #32 FIX: Bypass type check, access directly
-    JsonVariantConst devicesVariant = restoreConfig["devices"];
-    if (!devicesVariant.isNull()) {
-      JsonArrayConst devices = devicesVariant.as<JsonArrayConst>();
-      if (!devices.isNull() && devices.size() > 0) {
-        // Clear existing devices first
-        configManager->clearAllConfigurations();
-        Serial.println("[CONFIG RESTORE] Existing devices cleared");
-
-        // Restore each device
-        int deviceCount = 0;
-        int deviceIndex = 0;
-        for (JsonObjectConst device : devices) {
+  Serial.printf("[CONFIG RESTORE] OK: Config object validated (%u keys)\n",
+                restoreConfig.size());
+
+  int successCount = 0;
+  int failCount = 0;
+  JsonArray restoredConfigs;
+
+  auto response = make_psram_unique<JsonDocument>();
+  (*response)["status"] = "ok";
+  restoredConfigs = (*response)["restored_configs"].to<JsonArray>();
+
+  // Step 1: Restore devices configuration
+  Serial.println("[CONFIG RESTORE] [1/3] Restoring devices configuration...");
+  // v1.0.3: Send restore progress notification
+  // Mobile app MUST filter config_restore_progress notifications (like
+  // ota_progress)
+  manager->sendConfigRestoreProgress("devices", 1, 3);
+
+  // BUG #32 FIX: Bypass type check, access directly
+  JsonVariantConst devicesVariant = restoreConfig["devices"];
+  if (!devicesVariant.isNull()) {
+    JsonArrayConst devices = devicesVariant.as<JsonArrayConst>();
+    if (!devices.isNull() && devices.size() > 0) {
+      // Clear existing devices first
+      configManager->clearAllConfigurations();
+      Serial.println("[CONFIG RESTORE] Existing devices cleared");
+
+      // v1.3.3: All restored devices land in one storage commit
+      configManager->beginDevicesBatch();
+
+      // Restore each device
+      int deviceCount = 0;
+      int deviceIndex = 0;
+      for (JsonObjectConst device : devices) {
 #if PRODUCTION_MODE == 0
-          // BUG #32 DEBUG: Show device data BEFORE createDevice
-          Serial.printf("[CONFIG RESTORE] DEBUG: Processing device %d:\n",
-                        deviceIndex);
-          String deviceJson;
-          serializeJson(device, deviceJson);
-          Serial.printf("  JSON (%u bytes): %s\n", deviceJson.length(),
-                        deviceJson.c_str());
-
-          JsonVariantConst idVariant = device["device_id"];
-          Serial.printf("  device_id present: %s\n",
-                        !idVariant.isNull() ? "YES" : "NO");
-          if (!idVariant.isNull()) {
-            Serial.printf("  device_id value: %s\n",
-                          idVariant.as<const char*>());
-          }
+        // BUG #32 DEBUG: Show device data BEFORE createDevice
+        Serial.printf("[CONFIG RESTORE] DEBUG: Processing device %d:\n",
+                      deviceIndex);
+        String deviceJson;
+        serializeJson(device, deviceJson);
+        Serial.printf("  JSON (%u bytes): %s\n", deviceJson.length(),
+                      deviceJson.c_str());
+
+        JsonVariantConst idVariant = device["device_id"];
+        Serial.printf("  device_id present: %s\n",
+                      !idVariant.isNull() ? "YES" : "NO");
+        if (!idVariant.isNull()) {
+          Serial.printf("  device_id value: %s\n",
+                        idVariant.as<const char*>());
+        }
 
-          JsonVariantConst regsVariant = device["registers"];
-          Serial.printf("  registers present: %s\n",
-                        !regsVariant.isNull() ? "YES" : "NO");
-          if (!regsVariant.isNull()) {
-            JsonArrayConst regs = regsVariant.as<JsonArrayConst>();
-            Serial.printf("  registers count: %u\n", regs.size());
-          }
+        JsonVariantConst regsVariant = device["registers"];
+        Serial.printf("  registers present: %s\n",
+                      !regsVariant.isNull() ? "YES" : "NO");
+        if (!regsVariant.isNull()) {
+          JsonArrayConst regs = regsVariant.as<JsonArrayConst>();
+          Serial.printf("  registers count: %u\n", regs.size());
+        }
 #endif
 
-          String deviceId = configManager->createDevice(device);
-          if (!deviceId.isEmpty()) {
-            deviceCount++;
+        String deviceId = configManager->createDevice(device);
+        if (!deviceId.isEmpty()) {
+          deviceCount++;
 #if PRODUCTION_MODE == 0
-            Serial.printf("[CONFIG RESTORE] OK: Created device: %s\n",
-                          deviceId.c_str());
+          Serial.printf("[CONFIG RESTORE] OK: Created device: %s\n",
+                        deviceId.c_str());
 #endif
-          } else {
-            Serial.printf(
-                "[CONFIG RESTORE] WARNING: Failed to restore device %d\n",
-                deviceIndex);
-          }
-
-          deviceIndex++;
+        } else {
+          Serial.printf(
+              "[CONFIG RESTORE] WARNING: Failed to restore device %d\n",
+              deviceIndex);
         }
 
+        deviceIndex++;
+      }
+
+      if (configManager->commitDevicesBatch()) {
         Serial.printf("[CONFIG RESTORE] Restored %d devices\n", deviceCount);
         restoredConfigs.add("devices.json");
         successCount++;
       } else {
-        Serial.printf(
-            "[CONFIG RESTORE] WARNING: devices array is null or empty (size: "
-            "%u)\n",
-            devices.size());
+        Serial.println("[CONFIG RESTORE] ERROR: Device records not saved");
+        failCount++;
       }
     } else {
-      Serial.println("[CONFIG RESTORE] WARNING: No devices in backup");
+      Serial.printf(
+          "[CONFIG RESTORE] WARNING: devices array is null or empty (size: "
+          "%u)\n",
+          devices.size());
     }
+  } else {
+    Serial.println("[CONFIG RESTORE] WARNING: No devices in backup");
+  }
 
-    // Step 2: Restore server configuration
-    Serial.println("[CONFIG RESTORE] [2/3] Restoring server configuration...");
-    // v1.0.3: Send restore progress notification
-    manager->sendConfigRestoreProgress("server_config", 2, 3);
-
-    // BUG #32 FIX: Bypass type check, access directly
-    JsonVariantConst serverVariant = restoreConfig["server_config"];
-    if (!serverVariant.isNull()) {
-      JsonObjectConst serverCfg = serverVariant.as<JsonObjectConst>();
-      if (!serverCfg.isNull()) {
-        if (serverConfig->updateConfig(serverCfg)) {
-          Serial.println(
-              "[CONFIG RESTORE] Server config restored successfully");
-          restoredConfigs.add("server_config.json");
-          successCount++;
-        } else {
-          Serial.println(
-              "[CONFIG RESTORE] ERROR: Failed to restore server config");
-          failCount++;
-        }
+  // Step 2: Restore server configuration
+  Serial.println("[CONFIG RESTORE] [2/3] Restoring server configuration...");
+  // v1.0.3: Send restore progress notification
+  manager->sendConfigRestoreProgress("server_config", 2, 3);
+
+  // BUG #32 FIX: Bypass type check, access directly
+  JsonVariantConst serverVariant = restoreConfig["server_config"];
+  if (!serverVariant.isNull()) {
+    JsonObjectConst serverCfg = serverVariant.as<JsonObjectConst>();
+    if (!serverCfg.isNull()) {
+      if (serverConfig->updateConfig(serverCfg)) {
+        Serial.println(
+            "[CONFIG RESTORE] Server config restored successfully");
+        restoredConfigs.add("server_config.json");
+        successCount++;
       } else {
         Serial.println(
-            "[CONFIG RESTORE] WARNING: server_config cast to object failed");
+            "[CONFIG RESTORE] ERROR: Failed to restore server config");
+        failCount++;
       }
     } else {
-      Serial.println("[CONFIG RESTORE] WARNING: No server_config in backup");
+      Serial.println(
+          "[CONFIG RESTORE] WARNING: server_config cast to object failed");
     }
+  } else {
+    Serial.println("[CONFIG RESTORE] WARNING: No server_config in backup");
+  }
 
-    // Step 3: Restore logging configuration
-    Serial.println("[CONFIG RESTORE] [3/3] Restoring logging configuration...");
-    // v1.0.3: Send restore progress notification
-    manager->sendConfigRestoreProgress("logging_config", 3, 3);
-
-    // BUG #32 FIX: Bypass type check, access directly
-    JsonVariantConst loggingVariant = restoreConfig["logging_config"];
-    if (!loggingVariant.isNull()) {
-      JsonObjectConst loggingCfg = loggingVariant.as<JsonObjectConst>();
-      if (!loggingCfg.isNull()) {
-        if (loggingConfig->updateConfig(loggingCfg)) {
-          Serial.println(
-              "[CONFIG RESTORE] Logging config restored successfully");
-          restoredConfigs.add("logging_config.json");
-          successCount++;
-        } else {
-          Serial.println(
-              "[CONFIG RESTORE] ERROR: Failed to restore logging config");
-          failCount++;
-        }
+  // Step 3: Restore logging configuration
+  Serial.println("[CONFIG RESTORE] [3/3] Restoring logging configuration...");
+  // v1.0.3: Send restore progress notification
+  manager->sendConfigRestoreProgress("logging_config", 3, 3);
+
+  // BUG #32 FIX: Bypass type check, access directly
+  JsonVariantConst loggingVariant = restoreConfig["logging_config"];
+  if (!loggingVariant.isNull()) {
+    JsonObjectConst loggingCfg = loggingVariant.as<JsonObjectConst>();
+    if (!loggingCfg.isNull()) {
+      if (loggingConfig->updateConfig(loggingCfg)) {
+        Serial.println(
+            "[CONFIG RESTORE] Logging config restored successfully");
+        restoredConfigs.add("logging_config.json");
+        successCount++;
       } else {
         Serial.println(
-            "[CONFIG RESTORE] WARNING: logging_config cast to object failed");
+            "[CONFIG RESTORE] ERROR: Failed to restore logging config");
+        failCount++;
       }
     } else {
-      Serial.println("[CONFIG RESTORE] WARNING: No logging_config in backup");
+      Serial.println(
+          "[CONFIG RESTORE] WARNING: logging_config cast to object failed");
     }
+  } else {
+    Serial.println("[CONFIG RESTORE] WARNING: No logging_config in backup");
+  }
 
-    // Send response with restore summary
-    (*response)["success_count"] = successCount;
-    (*response)["fail_count"] = failCount;
-    (*response)["message"] =
-        "Configuration restore completed. Device restart recommended.";
-    (*response)["requires_restart"] = true;
-
-    Serial.println("\n[CONFIG RESTORE] RESTORE COMPLETE");
-    Serial.printf("  Succeeded: %d\n", successCount);
-    Serial.printf("  Failed: %d\n", failCount);
-    Serial.println("  Device restart recommended to apply all changes\n");
-
-    // ============================================================================
-    // OPTIMIZATION (v2.3.6): DRAM Cleanup Before Response
-    // ============================================================================
-    // After restore, DRAM is typically low (29-32KB) due to temporary
-    // allocations. This causes post-restore backup to use slow 100-byte chunks
-    // (35ms delay).
-    //
-    // Solution: Force DRAM cleanup before sending response:
-    // 1. Clear ConfigManager caches (free temporary device/register data)
-    // 2. Small delay for FreeRTOS garbage collection
-    // 3. Result: DRAM freed from ~29KB → ~80KB+
-    // 4. Impact: Post-restore backup uses fast 244-byte chunks (10ms delay)
-    //           Transmission time: ~3.5s → ~420ms (8x faster!)
-    // ============================================================================
+  // Send response with restore summary
+  (*response)["success_count"] = successCount;
+  (*response)["fail_count"] = failCount;
+  (*response)["message"] =
+      "Configuration restore completed. Device restart recommended.";
+  (*response)["requires_restart"] = true;
+
+  Serial.println("\n[CONFIG RESTORE] RESTORE COMPLETE");
+  Serial.printf("  Succeeded: %d\n", successCount);
+  Serial.printf("  Failed: %d\n", failCount);
+  Serial.println("  Device restart recommended to apply all changes\n");
+
+  // ============================================================================
+  // OPTIMIZATION (v2.3.6): DRAM Cleanup Before Response
+  // ============================================================================
+  // After restore, DRAM is typically low (29-32KB) due to temporary
+  // allocations. This causes post-restore backup to use slow 100-byte chunks
+  // (35ms delay).
+  //
+  // Solution: Force DRAM cleanup before sending response:
+  // 1. Clear ConfigManager caches (free temporary device/register data)
+  // 2. Small delay for FreeRTOS garbage collection
+  // 3. Result: DRAM freed from ~29KB → ~80KB+
+  // 4. Impact: Post-restore backup uses fast 244-byte chunks (10ms delay)
+  //           Transmission time: ~3.5s → ~420ms (8x faster!)
+  // ============================================================================
 
 #if PRODUCTION_MODE == 0
-    // Log DRAM before cleanup
-    // v2.3.6 FIX: Use MALLOC_CAP_INTERNAL to get DRAM only (not PSRAM)
-    size_t dramBefore =
-        heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-    Serial.printf("[DRAM CLEANUP] Before: %d bytes free\n", dramBefore);
+  // Log DRAM before cleanup
+  // v2.3.6 FIX: Use MALLOC_CAP_INTERNAL to get DRAM only (not PSRAM)
+  size_t dramBefore =
+      heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  Serial.printf("[DRAM CLEANUP] Before: %d bytes free\n", dramBefore);
 #endif
 
-    // Clear temporary caches to free DRAM
-    configManager->clearCache();
-    Serial.println("[DRAM CLEANUP] ConfigManager caches cleared");
+  // Clear temporary caches to free DRAM
+  configManager->clearCache();
+  Serial.println("[DRAM CLEANUP] ConfigManager caches cleared");
 
-    // Small delay for FreeRTOS garbage collection
-    vTaskDelay(pdMS_TO_TICKS(100));  // 100ms for GC
+  // Small delay for FreeRTOS garbage collection
+  vTaskDelay(pdMS_TO_TICKS(100));  // 100ms for GC
 
 #if PRODUCTION_MODE == 0
-                                     // Log DRAM after cleanup
-    // v2.3.6 FIX: Use MALLOC_CAP_INTERNAL to get DRAM only (not PSRAM)
-    size_t dramAfter =
-        heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-    size_t dramFreed = dramAfter - dramBefore;
-    Serial.printf(
-        "[DRAM CLEANUP] After: %d bytes free (+%d bytes, %.1f%% increase)\n",
-        dramAfter, dramFreed, (float)dramFreed / dramBefore * 100.0);
+                                   // Log DRAM after cleanup
+  // v2.3.6 FIX: Use MALLOC_CAP_INTERNAL to get DRAM only (not PSRAM)
+  size_t dramAfter =
+      heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  size_t dramFreed = dramAfter - dramBefore;
+  Serial.printf(
+      "[DRAM CLEANUP] After: %d bytes free (+%d bytes, %.1f%% increase)\n",
+      dramAfter, dramFreed, (float)dramFreed / dramBefore * 100.0);
 #endif
 
-    Serial.println("[DRAM CLEANUP] Complete - ready for fast transmission\n");
-
-    manager->sendResponse(*response);
-
-    // Notify services of config changes
-    notifyAllServices();  // CRITICAL FIX: Notify MQTT after config restore
-  };
+  Serial.println("[DRAM CLEANUP] Complete - ready for fast transmission\n");
 
-  // === OTA HANDLERS ===
-  // v2.5.35: OTA commands now use OTACrudBridge to avoid ESP_SSLClient linker
-  // issues OTA commands are triggered via BLE CRUD and can use HTTPS
-  // (WiFi/Ethernet) or BLE transport
+  manager->sendResponse(*response);
 
-  // Check for available firmware updates (op: "ota", type: "check_update")
-  otaHandlers["check_update"] = [this](BLEManager* manager,
-                                       const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::checkUpdate(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+  // Notify services of config changes
+  notifyAllServices();  // CRITICAL FIX: Notify MQTT after config restore
+}
 
-  // Start HTTPS OTA update (op: "ota", type: "start_update")
-  otaHandlers["start_update"] = [this](BLEManager* manager,
-                                       const JsonDocument& command) {
-    String customUrl = command["url"] | "";
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::startUpdate(otaManager, customUrl, *response);
-    manager->sendResponse(*response);
-  };
+// === OTA HANDLERS ===
+// v2.5.35: OTA commands now use OTACrudBridge to avoid ESP_SSLClient linker
+// issues OTA commands are triggered via BLE CRUD and can use HTTPS
+// (WiFi/Ethernet) or BLE transport
+
+// Check for available firmware updates (op: "ota", type: "check_update")
+void CRUDHandler::otaCheckUpdate(BLEManager* manager,
+                                 const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::checkUpdate(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-  // Get OTA status and progress (op: "ota", type: "ota_status")
-  otaHandlers["ota_status"] = [this](BLEManager* manager,
-                                     const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::getStatus(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+// Start HTTPS OTA update (op: "ota", type: "start_update")
+void CRUDHandler::otaStartUpdate(BLEManager* manager,
+                                 const JsonDocument& command) {
+  String customUrl = command["url"] | "";
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::startUpdate(otaManager, customUrl, *response);
+  manager->sendResponse(*response);
+}
 
-  // Abort current OTA update (op: "ota", type: "abort_update")
-  otaHandlers["abort_update"] = [this](BLEManager* manager,
-                                       const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::abortUpdate(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+// Get OTA status and progress (op: "ota", type: "ota_status")
+void CRUDHandler::otaStatus(BLEManager* manager, const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::getStatus(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-  // Apply downloaded update and reboot (op: "ota", type: "apply_update")
-  otaHandlers["apply_update"] = [this](BLEManager* manager,
-                                       const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::confirmUpdate(otaManager, *response);
-    manager->sendResponse(*response);
-    // Note: confirmUpdate handles the reboot internally if needed
-  };
+// Abort current OTA update (op: "ota", type: "abort_update")
+void CRUDHandler::otaAbortUpdate(BLEManager* manager,
+                                 const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::abortUpdate(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-  // Enable BLE OTA mode (op: "ota", type: "enable_ble_ota")
-  otaHandlers["enable_ble_ota"] = [this](BLEManager* manager,
-                                         const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::enableBleOta(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+// Apply downloaded update and reboot (op: "ota", type: "apply_update")
+void CRUDHandler::otaApplyUpdate(BLEManager* manager,
+                                 const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::confirmUpdate(otaManager, *response);
+  manager->sendResponse(*response);
+  // Note: confirmUpdate handles the reboot internally if needed
+}
 
-  // Disable BLE OTA mode (op: "ota", type: "disable_ble_ota")
-  otaHandlers["disable_ble_ota"] = [this](BLEManager* manager,
-                                          const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::disableBleOta(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+// Enable BLE OTA mode (op: "ota", type: "enable_ble_ota")
+void CRUDHandler::otaEnableBleOta(BLEManager* manager,
+                                  const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::enableBleOta(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-  // Rollback to previous firmware (op: "ota", type: "rollback")
-  otaHandlers["rollback"] = [this](BLEManager* manager,
+// Disable BLE OTA mode (op: "ota", type: "disable_ble_ota")
+void CRUDHandler::otaDisableBleOta(BLEManager* manager,
                                    const JsonDocument& command) {
-    String target = command["target"] | "previous";
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::rollback(otaManager, target, *response);
-    manager->sendResponse(*response);
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::disableBleOta(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-    // Reboot after successful rollback
-    if ((*response)["status"] == "ok") {
-      vTaskDelay(pdMS_TO_TICKS(1000));
-      esp_restart();
-    }
-  };
+// Rollback to previous firmware (op: "ota", type: "rollback")
+void CRUDHandler::otaRollback(BLEManager* manager,
+                              const JsonDocument& command) {
+  String target = command["target"] | "previous";
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::rollback(otaManager, target, *response);
+  manager->sendResponse(*response);
+
+  // Reboot after successful rollback
+  if ((*response)["status"] == "ok") {
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    esp_restart();
+  }
+}
 
-  // Get OTA configuration (op: "ota", type: "get_config")
-  otaHandlers["get_config"] = [this](BLEManager* manager,
-                                     const JsonDocument& command) {
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::getConfig(otaManager, *response);
-    manager->sendResponse(*response);
-  };
+// Get OTA configuration (op: "ota", type: "get_config")
+void CRUDHandler::otaGetConfig(BLEManager* manager,
+                               const JsonDocument& command) {
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::getConfig(otaManager, *response);
+  manager->sendResponse(*response);
+}
 
-  // Set GitHub repository for OTA (op: "ota", type: "set_github_repo")
-  otaHandlers["set_github_repo"] = [this](BLEManager* manager,
-                                          const JsonDocument& command) {
-    String owner = command["owner"] | "";
-    String repo = command["repo"] | "";
-    String branch = command["branch"] | "main";
+// Set GitHub repository for OTA (op: "ota", type: "set_github_repo")
+void CRUDHandler::otaSetGithubRepo(BLEManager* manager,
+                                   const JsonDocument& command) {
+  String owner = command["owner"] | "";
+  String repo = command["repo"] | "";
+  String branch = command["branch"] | "main";
 
-    if (owner.isEmpty() || repo.isEmpty()) {
-      manager->sendError("Missing required fields: owner, repo", "ota");
-      return;
-    }
+  if (owner.isEmpty() || repo.isEmpty()) {
+    manager->sendError("Missing required fields: owner, repo", "ota");
+    return;
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::setGitHubRepo(otaManager, owner, repo, branch, *response);
-    manager->sendResponse(*response);
-  };
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::setGitHubRepo(otaManager, owner, repo, branch, *response);
+  manager->sendResponse(*response);
+}
 
-  // Set GitHub token for private repos (op: "ota", type: "set_github_token")
-  otaHandlers["set_github_token"] = [this](BLEManager* manager,
-                                           const JsonDocument& command) {
-    String token = command["token"] | "";
-    if (token.isEmpty()) {
-      manager->sendError("Missing required field: token", "ota");
-      return;
-    }
+// Set GitHub token for private repos (op: "ota", type: "set_github_token")
+void CRUDHandler::otaSetGithubToken(BLEManager* manager,
+                                    const JsonDocument& command) {
+  String token = command["token"] | "";
+  if (token.isEmpty()) {
+    manager->sendError("Missing required field: token", "ota");
+    return;
+  }
 
-    auto response = make_psram_unique<JsonDocument>();
-    OTACrudBridge::setGitHubToken(otaManager, token, *response);
-    manager->sendResponse(*response);
-  };
+  auto response = make_psram_unique<JsonDocument>();
+  OTACrudBridge::setGitHubToken(otaManager, token, *response);
+  manager->sendResponse(*response);
 }
 
 // ============================================================================
@@ -2021,21 +2423,15 @@ void CRUDHandler::setupCommandHandlers() {
 void CRUDHandler::enqueueCommand(BLEManager* manager,
                                  const JsonDocument& command,
                                  CommandPriority priority) {
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    manager->sendError("Failed to enqueue command (mutex timeout)", "system");
-    return;
-  }
-
-  // Create command with ID and timestamp
+  // Create command with timestamp
   Command cmd;
-  cmd.id = ++commandIdCounter;
-  uint64_t cmdId = cmd.id;  // Save ID before move
   cmd.priority = priority;
   cmd.enqueueTime = millis();
   cmd.manager = manager;  // Store BLE manager for response sending
 
-  // BUG #32 FIX: Serialize to String instead of using .set() which corrupts
-  // type info
+  // BUG #32 FIX: Serialize instead of using .set() which corrupts type info
+  // v1.3.3: Into an exact-size PSRAM buffer (was a DRAM String), before the
+  // queue lock is taken
   size_t commandSize = measureJson(command);
 
   // v2.5.2: Use runtime check instead of compile-time for production mode
@@ -2045,27 +2441,34 @@ void CRUDHandler::enqueueCommand(BLEManager* manager,
         commandSize);
   }
 
-  // Serialize JsonDocument to String (avoids .set() corruption issue)
-  serializeJson(command, cmd.payloadJson);
+  char* buffer = (char*)heap_caps_malloc(commandSize + 1,
+                                         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buffer) {
+    buffer = (char*)heap_caps_malloc(commandSize + 1, MALLOC_CAP_8BIT);
+  }
+  if (buffer) {
+    cmd.payloadJson.reset(buffer);
+    cmd.payloadLength = serializeJson(command, buffer, commandSize + 1);
+  }
 
-  if (cmd.payloadJson.isEmpty()) {
+  if (cmd.payloadLength == 0) {
     // Error logs only in development mode (error is returned via BLE)
     if (!IS_PRODUCTION_MODE()) {
       Serial.println(
           "[CRUD QUEUE] ERROR: Failed to serialize command payload!");
     }
-    xSemaphoreGive(queueMutex);
     manager->sendError("Failed to serialize command payload", "system");
     return;
   }
 
-  // v2.5.2: Use runtime check
-  if (!IS_PRODUCTION_MODE()) {
-    Serial.printf(
-        "[CRUD QUEUE] Command serialized successfully (%u bytes String)\n",
-        cmd.payloadJson.length());
+  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    manager->sendError("Failed to enqueue command (mutex timeout)", "system");
+    return;
   }
 
+  cmd.id = ++commandIdCounter;
+  uint64_t cmdId = cmd.id;  // Save ID before move
+
   // Track statistics
   if (priority == CommandPriority::PRIORITY_HIGH) {
     batchStats.highPriorityCount++;
@@ -2075,8 +2478,10 @@ void CRUDHandler::enqueueCommand(BLEManager* manager,
     batchStats.lowPriorityCount++;
   }
 
-  // Add to priority queue
-  commandQueue.push(std::move(cmd));
+  // Add to priority queue (v1.3.3: min-heap of moved commands)
+  commandQueue.push_back(std::move(cmd));
+  std::push_heap(commandQueue.begin(), commandQueue.end(),
+                 std::greater<Command>());
   updateQueueDepth();
 
   // v2.5.2: Enqueue log only in development mode
@@ -2099,39 +2504,38 @@ void CRUDHandler::processPriorityQueue() {
     return;
   }
 
-  // Get highest priority command (copy from queue)
-  Command cmd;
-
-  if (!commandQueue.empty()) {
-    cmd = commandQueue.top();  // Copy command (String is copyable)
-    commandQueue.pop();
-  } else {
-    xSemaphoreGive(queueMutex);
-    return;
-  }
+  // Get highest priority command
+  // v1.3.3: Moved out of the heap (previously copied, payload included)
+  std::pop_heap(commandQueue.begin(), commandQueue.end(),
+                std::greater<Command>());
+  Command cmd = std::move(commandQueue.back());
+  commandQueue.pop_back();
 
   updateQueueDepth();
   xSemaphoreGive(queueMutex);
 
-  // Deserialize JSON String to JsonDocument (outside mutex to prevent blocking)
+  // Deserialize JSON payload to JsonDocument (outside mutex to prevent
+  // blocking)
   SpiRamJsonDocument payload;
 
   // v2.5.2: Use runtime check
   if (!IS_PRODUCTION_MODE()) {
     Serial.printf(
-        "[CRUD EXEC] Deserializing payload from queue (%u bytes String)...\n",
-        cmd.payloadJson.length());
+        "[CRUD EXEC] Deserializing payload from queue (%u bytes)...\n",
+        cmd.payloadLength);
   }
 
-  DeserializationError error = deserializeJson(payload, cmd.payloadJson);
+  DeserializationError error =
+      deserializeJson(payload, (const char*)cmd.payloadJson.get(),
+                      cmd.payloadLength);
 
   if (error) {
     // v2.5.2: Error logs only in development mode (error returned via BLE)
     if (!IS_PRODUCTION_MODE()) {
       Serial.printf("[CRUD EXEC] ERROR: Failed to deserialize payload - %s\n",
                     error.c_str());
-      Serial.printf("[CRUD EXEC] JSON String length: %u bytes\n",
-                    cmd.payloadJson.length());
+      Serial.printf("[CRUD EXEC] JSON payload length: %u bytes\n",
+                    cmd.payloadLength);
       Serial.printf("[CRUD EXEC] Free PSRAM: %u bytes\n",
                     heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
     }
@@ -2149,20 +2553,15 @@ void CRUDHandler::processPriorityQueue() {
                   measureJson(payload));
   }
 
-  // CRITICAL FIX (v2.3.5): DO NOT free String yet!
-  // Zero-copy deserialization means payload JsonDocument holds pointers to
-  // cmd.payloadJson Freeing it now causes Guru Meditation Error when handlers
-  // access payload["config"] We'll free it AFTER all handlers complete (below)
+  // CRITICAL FIX (v2.3.5): DO NOT free the payload buffer yet!
+  // The payload JsonDocument may hold pointers into cmd.payloadJson (zero-copy
+  // deserialization). We'll free it AFTER all handlers complete (below)
 
   // Only execute if we have a valid manager
   if (!cmd.manager) {
     LOG_CRUD_INFO(
         "[CRUD] ERROR: Command has no payload or manager, skipping execution");
-
-    // Safe to free here since we're returning early
-    cmd.payloadJson.clear();
-    cmd.payloadJson = String();
-    return;
+    return;  // cmd frees its payload buffer
   }
 
   // v2.5.2: Processing log only in development mode
@@ -2170,40 +2569,13 @@ void CRUDHandler::processPriorityQueue() {
     Serial.printf("[CRUD EXEC] Processing command %lu\n", cmd.id);
   }
 
-  String op = payload["op"] | "";
-  String type = payload["type"] | "";
-
   // Route to appropriate handler (with valid manager pointer)
-  bool handlerFound = false;
-
-  if (op == "read" && readHandlers.count(type)) {
-    readHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "create" && createHandlers.count(type)) {
-    createHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "update" && updateHandlers.count(type)) {
-    updateHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "delete" && deleteHandlers.count(type)) {
-    deleteHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "write" && writeHandlers.count(type)) {
-    writeHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "control" && controlHandlers.count(type)) {
-    controlHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "system" && systemHandlers.count(type)) {
-    systemHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  } else if (op == "ota" && otaHandlers.count(type)) {
-    otaHandlers[type](cmd.manager, payload);
-    handlerFound = true;
-  }
+  bool handlerFound = dispatch(cmd.manager, payload);
 
   if (!handlerFound) {
     // v2.5.2: Error log only in development mode (error returned via BLE)
+    String op = payload["op"] | "";
+    String type = payload["type"] | "";
     if (!IS_PRODUCTION_MODE()) {
       Serial.printf(
           "[CRUD EXEC] ERROR: No handler found for op='%s', type='%s'\n",
@@ -2213,19 +2585,10 @@ void CRUDHandler::processPriorityQueue() {
         "Unknown operation or type: op=" + op + ", type=" + type, "system");
   }
 
-  // CRITICAL FIX (v2.3.5): NOW safe to free payload String after handlers
-  // complete All handlers have finished accessing payload, so zero-copy
-  // references are no longer needed
-  cmd.payloadJson.clear();
-  cmd.payloadJson = String();  // Force deallocation
-
-  // v2.5.2: Use runtime check
-  if (!IS_PRODUCTION_MODE()) {
-    Serial.printf(
-        "[CRUD EXEC] Freed payload string after processing (%u bytes DRAM "
-        "free)\n",
-        heap_caps_get_free_size(MALLOC_CAP_8BIT));
-  }
+  // CRITICAL FIX (v2.3.5): NOW safe to free the payload after handlers
+  // complete - all handlers have finished accessing payload
+  cmd.payloadJson.reset();
+  cmd.payloadLength = 0;
 
   batchStats.totalCommandsProcessed++;
 }
@@ -2313,43 +2676,12 @@ void CRUDHandler::executeBatchSequential(BLEManager* manager,
   uint32_t failed = 0;
 
   for (JsonVariantConst cmdVar : commands) {
-    JsonObjectConst cmdObj = cmdVar.as<JsonObjectConst>();
-
-    String op = cmdObj["op"] | "";
-    String type = cmdObj["type"] | "";
-
-    bool success = false;
-
     // Execute command - need to create a JsonDocument from the variant
     // since handlers expect JsonDocument& (non-const)
     auto cmdDoc = make_psram_unique<JsonDocument>();
     cmdDoc->set(cmdVar);
 
-    if (op == "read" && readHandlers.count(type)) {
-      readHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "create" && createHandlers.count(type)) {
-      createHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "update" && updateHandlers.count(type)) {
-      updateHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "delete" && deleteHandlers.count(type)) {
-      deleteHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "write" && writeHandlers.count(type)) {
-      writeHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "control" && controlHandlers.count(type)) {
-      controlHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "system" && systemHandlers.count(type)) {
-      systemHandlers[type](manager, *cmdDoc);
-      success = true;
-    } else if (op == "ota" && otaHandlers.count(type)) {
-      otaHandlers[type](manager, *cmdDoc);
-      success = true;
-    }
+    bool success = dispatch(manager, *cmdDoc);
 
     if (success) {
       completed++;
@@ -2398,27 +2730,8 @@ void CRUDHandler::executeBatchAtomic(BLEManager* manager, const String& batchId,
   // First pass: validate all commands
   for (JsonVariantConst cmdVar : commands) {
     JsonObjectConst cmdObj = cmdVar.as<JsonObjectConst>();
-    String op = cmdObj["op"] | "";
-    String type = cmdObj["type"] | "";
-
-    bool handlerExists = false;
-    if (op == "read") {
-      handlerExists = readHandlers.count(type) > 0;
-    } else if (op == "create") {
-      handlerExists = createHandlers.count(type) > 0;
-    } else if (op == "update") {
-      handlerExists = updateHandlers.count(type) > 0;
-    } else if (op == "delete") {
-      handlerExists = deleteHandlers.count(type) > 0;
-    } else if (op == "write") {
-      handlerExists = writeHandlers.count(type) > 0;
-    } else if (op == "control") {
-      handlerExists = controlHandlers.count(type) > 0;
-    } else if (op == "system") {
-      handlerExists = systemHandlers.count(type) > 0;
-    } else if (op == "ota") {
-      handlerExists = otaHandlers.count(type) > 0;
-    }
+    bool handlerExists =
+        findRoute(cmdObj["op"] | "", cmdObj["type"] | "") != nullptr;
 
     if (!handlerExists) {
       shouldRollback = true;
@@ -2426,50 +2739,35 @@ void CRUDHandler::executeBatchAtomic(BLEManager* manager, const String& batchId,
       // v2.5.2: Validation log only in development mode
       if (!IS_PRODUCTION_MODE()) {
         Serial.printf("[CRUD BATCH] Validation failed for op '%s' type '%s'\n",
-                      op.c_str(), type.c_str());
+                      cmdObj["op"] | "", cmdObj["type"] | "");
       }
     }
   }
 
   // If validation passes, execute all commands
   if (!shouldRollback) {
-    for (JsonVariantConst cmdVar : commands) {
-      JsonObjectConst cmdObj = cmdVar.as<JsonObjectConst>();
-      String op = cmdObj["op"] | "";
-      String type = cmdObj["type"] | "";
+    // v1.3.3: One storage commit for the whole batch - each device touched
+    // by the batch is written once instead of once per command
+    configManager->beginDevicesBatch();
 
+    for (JsonVariantConst cmdVar : commands) {
       // Create a JsonDocument from the variant for the handler
       auto cmdDoc = make_psram_unique<JsonDocument>();
       cmdDoc->set(cmdVar);
 
-      if (op == "read" && readHandlers.count(type)) {
-        readHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "create" && createHandlers.count(type)) {
-        createHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "update" && updateHandlers.count(type)) {
-        updateHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "delete" && deleteHandlers.count(type)) {
-        deleteHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "write" && writeHandlers.count(type)) {
-        writeHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "control" && controlHandlers.count(type)) {
-        controlHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "system" && systemHandlers.count(type)) {
-        systemHandlers[type](manager, *cmdDoc);
-        completed++;
-      } else if (op == "ota" && otaHandlers.count(type)) {
-        otaHandlers[type](manager, *cmdDoc);
+      if (dispatch(manager, *cmdDoc)) {
         completed++;
       }
 
       vTaskDelay(pdMS_TO_TICKS(10));
     }
+
+    if (!configManager->commitDevicesBatch()) {
+      failed = completed;
+      completed = 0;
+      manager->sendError(ERR_CFG_SAVE_FAILED,
+                         "ATOMIC batch storage commit failed", "batch");
+    }
   } else {
     manager->sendError("ATOMIC batch failed validation", "batch");
   }
@@ -2563,10 +2861,10 @@ void CRUDHandler::reportStats(JsonObject& statsObj) {
 // HELPER METHODS
 // ============================================================================
 
-void CRUDHandler::notifyAllServices() {
-  if (modbusRtuService) modbusRtuService->notifyConfigChange();
-  if (modbusTcpService) modbusTcpService->notifyConfigChange();
-  if (mqttManager) mqttManager->notifyConfigChange();
+void CRUDHandler::notifyAllServices(const ModbusConfigChange& change) {
+  // v1.3.3: The Modbus services rebuild only the changed device
+  if (modbusRtuService) modbusRtuService->notifyConfigChange(change);
+  if (modbusTcpService) modbusTcpService->notifyConfigChange(change);
 }
 
 // ============================================================================
@@ -2669,6 +2967,9 @@ void CRUDHandler::performFactoryReset() {
     mqtt["clean_session"] = true;
     mqtt["use_tls"] = false;
     mqtt["publish_mode"] = "default";  // "default" or "customize"
+    mqtt["payload_format"] = "json";   // v1.3.3: "json", "msgpack" or "cbor"
+    mqtt["publish_qos"] = 1;           // v1.3.3: 0 or 1
+    mqtt["inflight_window"] = 8;       // v1.3.3: QoS 1 PUBLISH awaiting PUBACK
 
     // Default mode configuration (for MQTT modes feature)
     JsonObject defaultMode = mqtt["default_mode"].to<JsonObject>();
@@ -2690,6 +2991,7 @@ void CRUDHandler::performFactoryReset() {
     http["endpoint_url"] = "https://api.example.com/data";
     http["method"] = "POST";
     http["body_format"] = "json";
+    http["payload_format"] = "json";  // v1.3.3: "json", "msgpack" or "cbor"
     http["timeout"] = 5000;
     http["retry"] = 3;
     http["interval"] = 5;         // HTTP transmission interval
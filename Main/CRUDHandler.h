@@ -6,14 +6,17 @@
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
+#include <algorithm>  // v1.3.3: std::push_heap / pop_heap (command queue)
 #include <functional>
 #include <map>
-#include <queue>
+#include <memory>
+#include <vector>
 
 #include "ConfigManager.h"
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
 #include "LoggingConfig.h"
 #include "MemoryManager.h"  // For PsramUniquePtr and make_psram_unique
+#include "ModbusDeviceTypes.h"  // v1.3.3: ModbusConfigChange
 #include "ServerConfig.h"
 
 // FIXED BUG #30: Define CRUD task stack size constant
@@ -45,26 +48,31 @@ enum class BatchMode : uint8_t {
 };
 
 // Individual Command Structure
+// v1.3.3: Move-only. Previous: the payload was a DRAM String, copied again
+// when the command left the queue. New: an exact-size PSRAM buffer owned by
+// the command, moved in and out of the queue.
 struct Command {
   uint64_t id;                // Unique command ID
   CommandPriority priority;   // Priority level
   unsigned long enqueueTime;  // When command was enqueued
-  String payloadJson;   // BUG #32 FIX: Store as serialized JSON String to avoid
-                        // .set() corruption
-  BLEManager* manager;  // BLE Manager for sending responses
+  std::unique_ptr<char, PsramDeleter>
+      payloadJson;       // BUG #32 FIX: Store as serialized JSON to avoid
+                         // .set() corruption
+  size_t payloadLength;  // Serialized length (no terminator)
+  BLEManager* manager;   // BLE Manager for sending responses
 
   // Default constructor
   Command()
       : id(0),
         priority(CommandPriority::PRIORITY_NORMAL),
         enqueueTime(0),
+        payloadLength(0),
         manager(nullptr) {}
 
-  // Default copy operations (String is copyable)
-  Command(const Command&) = default;
-  Command& operator=(const Command&) = default;
+  Command(const Command&) = delete;
+  Command& operator=(const Command&) = delete;
 
-  // Default move operations (allow std::priority_queue to work)
+  // Move operations (std::push_heap / pop_heap)
   Command(Command&&) = default;
   Command& operator=(Command&&) = default;
 
@@ -119,35 +127,100 @@ class CRUDHandler {
   OTAManager* otaManager;              // For OTA update commands via BLE
   String streamDeviceId;
 
-  // Define a type for our command handler functions
-  using CommandHandler = std::function<void(BLEManager*, const JsonDocument&)>;
-
-  // Maps to hold handlers for each operation type
-  std::map<String, CommandHandler> readHandlers;
-  std::map<String, CommandHandler> createHandlers;
-  std::map<String, CommandHandler> updateHandlers;
-  std::map<String, CommandHandler> deleteHandlers;
-  std::map<String, CommandHandler>
-      controlHandlers;  // NEW: Device control operations
-  std::map<String, CommandHandler>
-      systemHandlers;  // NEW: System operations (factory reset, etc.)
-  std::map<String, CommandHandler>
-      otaHandlers;  // OTA update operations (check, update, status)
-  std::map<String, CommandHandler>
-      writeHandlers;  // v1.0.8: Write register operations (FC5, FC6, FC16)
-
-  // Private method to populate the handler maps
-  void setupCommandHandlers();
+  // v1.3.3: Command handlers, routed by (op, type) through the static table
+  // in findRoute() (replaces the per-op std::map<String, std::function>)
+  using CommandHandler =
+      void (CRUDHandler::*)(BLEManager*, const JsonDocument&);
+  struct CommandRoute {
+    const char* op;
+    const char* type;
+    CommandHandler handler;
+  };
+  static const CommandRoute* findRoute(const char* op, const char* type);
+  static constexpr bool routesSorted(const CommandRoute* routes, size_t index,
+                                     size_t count);
+  // false = no handler for the command's (op, type)
+  bool dispatch(BLEManager* manager, const JsonDocument& command);
+
+  // op "read"
+  void readDevices(BLEManager* manager, const JsonDocument& command);
+  void readDevicesSummary(BLEManager* manager, const JsonDocument& command);
+  void readDevicesWithRegisters(BLEManager* manager,
+                                const JsonDocument& command);
+  void readDevice(BLEManager* manager, const JsonDocument& command);
+  void readRegisters(BLEManager* manager, const JsonDocument& command);
+  void readRegistersSummary(BLEManager* manager, const JsonDocument& command);
+  void readServerConfig(BLEManager* manager, const JsonDocument& command);
+  void readLoggingConfig(BLEManager* manager, const JsonDocument& command);
+  void readProductionMode(BLEManager* manager, const JsonDocument& command);
+  void readTaskProfile(BLEManager* manager, const JsonDocument& command);
+  void readHistory(BLEManager* manager, const JsonDocument& command);
+  void readFullConfig(BLEManager* manager, const JsonDocument& command);
+  void readData(BLEManager* manager, const JsonDocument& command);
+
+  // op "create"
+  void createDevice(BLEManager* manager, const JsonDocument& command);
+  void createRegister(BLEManager* manager, const JsonDocument& command);
+
+  // op "import" (v1.3.3)
+  void importRegisters(BLEManager* manager, const JsonDocument& command);
+
+  // op "update"
+  void updateDevice(BLEManager* manager, const JsonDocument& command);
+  void updateRegister(BLEManager* manager, const JsonDocument& command);
+  void updateServerConfig(BLEManager* manager, const JsonDocument& command);
+  void updateLoggingConfig(BLEManager* manager, const JsonDocument& command);
+
+  // op "delete"
+  void deleteDevice(BLEManager* manager, const JsonDocument& command);
+  void deleteRegister(BLEManager* manager, const JsonDocument& command);
+
+  // op "write"
+  void writeRegister(BLEManager* manager, const JsonDocument& command);
+
+  // op "control"
+  void controlEnableDevice(BLEManager* manager, const JsonDocument& command);
+  void controlDisableDevice(BLEManager* manager, const JsonDocument& command);
+  void controlGetDeviceStatus(BLEManager* manager, const JsonDocument& command);
+  void controlGetAllDeviceStatus(BLEManager* manager,
+                                 const JsonDocument& command);
+  void controlSetProductionMode(BLEManager* manager,
+                                const JsonDocument& command);
+  void controlGetGatewayInfo(BLEManager* manager, const JsonDocument& command);
+  void controlGetNetworkStatus(BLEManager* manager,
+                               const JsonDocument& command);
+  void controlSetFriendlyName(BLEManager* manager, const JsonDocument& command);
+  void controlSetGatewayLocation(BLEManager* manager,
+                                 const JsonDocument& command);
+  void controlGetMqttStatus(BLEManager* manager, const JsonDocument& command);
+
+  // op "system"
+  void systemFactoryReset(BLEManager* manager, const JsonDocument& command);
+  void systemRestoreConfig(BLEManager* manager, const JsonDocument& command);
+
+  // op "ota"
+  void otaCheckUpdate(BLEManager* manager, const JsonDocument& command);
+  void otaStartUpdate(BLEManager* manager, const JsonDocument& command);
+  void otaStatus(BLEManager* manager, const JsonDocument& command);
+  void otaAbortUpdate(BLEManager* manager, const JsonDocument& command);
+  void otaApplyUpdate(BLEManager* manager, const JsonDocument& command);
+  void otaEnableBleOta(BLEManager* manager, const JsonDocument& command);
+  void otaDisableBleOta(BLEManager* manager, const JsonDocument& command);
+  void otaRollback(BLEManager* manager, const JsonDocument& command);
+  void otaGetConfig(BLEManager* manager, const JsonDocument& command);
+  void otaSetGithubRepo(BLEManager* manager, const JsonDocument& command);
+  void otaSetGithubToken(BLEManager* manager, const JsonDocument& command);
 
   // Factory reset helper
   void performFactoryReset();
 
   // Helper Methods
-  void notifyAllServices();  // Notify all services of config changes
+  // Notify all services of config changes (v1.3.3: change = what changed,
+  // default: everything, e.g. after a restore)
+  void notifyAllServices(const ModbusConfigChange& change = {});
 
   // Priority Queue and Batch Operations
-  std::priority_queue<Command, std::vector<Command>, std::greater<Command>>
-      commandQueue;
+  std::vector<Command> commandQueue;  // v1.3.3: Min-heap (std::greater)
   SemaphoreHandle_t queueMutex;
   TaskHandle_t commandProcessorTaskHandle;
 
@@ -1,6 +1,7 @@
 #include "ConfigManager.h"
 
 #include <esp_heap_caps.h>
+#include <esp_rom_crc.h>  // v1.3.3: Devices snapshot checksums
 
 #include <new>
 #include <vector>
@@ -15,12 +16,62 @@
 
 const char* ConfigManager::DEVICES_FILE = "/devices.json";
 const char* ConfigManager::REGISTERS_FILE = "/registers.json";
+const char* ConfigManager::DEVICE_RECORDS_DIR = "/devcfg";
+const char* ConfigManager::DEVICES_MANIFEST_FILE = "/devcfg/manifest.json";
+const char* ConfigManager::DEVICES_SNAPSHOT_FILE = "/devices.snap";
+const char* ConfigManager::DEVICES_SNAPSHOT_TEMP_FILE = "/devices.snap.tmp";
+
+// v1.3.3: Streamed CRC32 of an open file from its current position
+static bool crc32OfFile(File& file, size_t length, uint32_t& crc) {
+  uint8_t chunk[512];
+  crc = 0;
+  while (length > 0) {
+    size_t n = length < sizeof(chunk) ? length : sizeof(chunk);
+    if (file.read(chunk, n) != n) {
+      return false;
+    }
+    crc = esp_rom_crc32_le(crc, chunk, n);
+    length -= n;
+  }
+  return true;
+}
+
+// v1.3.3: Copy the part of source that filter selects into target, with the
+// semantics of DeserializationOption::Filter (true = whole value, object =
+// listed keys or "*", array = first element's filter for every element)
+static bool filterAllows(JsonVariantConst filter) {
+  return !filter.isNull() && !(filter.is<bool>() && !filter.as<bool>());
+}
+
+static void projectJson(JsonVariantConst source, JsonVariantConst filter,
+                        JsonVariant target) {
+  if (filter.is<bool>()) {
+    target.set(source);
+    return;
+  }
+  if (filter.is<JsonObjectConst>() && source.is<JsonObjectConst>()) {
+    JsonObject object = target.to<JsonObject>();
+    JsonVariantConst wildcard = filter["*"];
+    for (JsonPairConst kv : source.as<JsonObjectConst>()) {
+      JsonVariantConst member = filter[kv.key()];
+      if (member.isNull()) member = wildcard;
+      if (filterAllows(member)) {
+        projectJson(kv.value(), member, object[kv.key()]);
+      }
+    }
+  } else if (filter.is<JsonArrayConst>() && source.is<JsonArrayConst>()) {
+    JsonArray array = target.to<JsonArray>();
+    JsonVariantConst element = filter[0];
+    if (!filterAllows(element)) return;
+    for (JsonVariantConst item : source.as<JsonArrayConst>()) {
+      projectJson(item, element, array.add<JsonVariant>());
+    }
+  }
+}
 
 ConfigManager::ConfigManager()
     : devicesCache(nullptr),
-      devicesShadowCache(nullptr),
       registersCache(nullptr),
-      registersShadowCache(nullptr),
       devicesCacheValid(false),
       registersCacheValid(false),
       cacheMutex(nullptr),
@@ -70,28 +121,6 @@ ConfigManager::ConfigManager()
   } else {
     registersCache = new JsonDocument();
   }
-
-  // SHADOW COPY OPTIMIZATION (v2.3.8): Initialize SHADOW cache in PSRAM
-  devicesShadowCache = (JsonDocument*)heap_caps_malloc(
-      sizeof(JsonDocument), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-  if (devicesShadowCache) {
-    new (devicesShadowCache) JsonDocument();
-    LOG_CONFIG_INFO("[CONFIG] Devices shadow cache allocated in PSRAM");
-  } else {
-    devicesShadowCache = new JsonDocument();  // Fallback to DRAM
-    LOG_CONFIG_INFO("[CONFIG] WARNING: Devices shadow cache fallback to DRAM");
-  }
-
-  registersShadowCache = (JsonDocument*)heap_caps_malloc(
-      sizeof(JsonDocument), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-  if (registersShadowCache) {
-    new (registersShadowCache) JsonDocument();
-    LOG_CONFIG_INFO("[CONFIG] Registers shadow cache allocated in PSRAM");
-  } else {
-    registersShadowCache = new JsonDocument();  // Fallback to DRAM
-    LOG_CONFIG_INFO(
-        "[CONFIG] WARNING: Registers shadow cache fallback to DRAM");
-  }
 }
 
 ConfigManager::~ConfigManager() {
@@ -123,17 +152,7 @@ ConfigManager::~ConfigManager() {
     registersCache = nullptr;
   }
 
-  // SHADOW COPY OPTIMIZATION (v2.3.8): Clean up SHADOW cache documents
-  if (devicesShadowCache) {
-    devicesShadowCache->~JsonDocument();
-    heap_caps_free(devicesShadowCache);
-    devicesShadowCache = nullptr;
-  }
-  if (registersShadowCache) {
-    registersShadowCache->~JsonDocument();
-    heap_caps_free(registersShadowCache);
-    registersShadowCache = nullptr;
-  }
+  dropDevicesGeneration();  // Readers keep their own handles
 }
 
 bool ConfigManager::begin() {
@@ -154,12 +173,13 @@ bool ConfigManager::begin() {
     return false;
   }
 
-  if (!LittleFS.exists(DEVICES_FILE)) {
-    JsonDocument doc;
-    doc.to<JsonObject>();
-    saveJson(DEVICES_FILE, doc);
-    // v2.5.35: Use DEV_MODE check to prevent log leak in production
-    DEV_SERIAL_PRINTLN("Created empty devices file");
+  // v1.3.3: Per-device records (one-time migration from devices.json)
+  if (!LittleFS.exists(DEVICE_RECORDS_DIR)) {
+    LittleFS.mkdir(DEVICE_RECORDS_DIR);
+  }
+  if (!openDevicesStore()) {
+    LOG_CONFIG_INFO("[CONFIG] ERROR: Failed to open device records");
+    return false;
   }
   if (!LittleFS.exists(REGISTERS_FILE)) {
     JsonDocument doc;
@@ -293,7 +313,119 @@ bool ConfigManager::saveJson(const String& filename, const JsonDocument& doc) {
   return success;
 }
 
-bool ConfigManager::loadJson(const String& filename, JsonDocument& doc) {
+bool ConfigManager::saveDevicesSnapshot(const JsonDocument& doc) {
+  SnapshotHeader header = {};
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.arduinoJsonMajor = ARDUINOJSON_VERSION_MAJOR;
+  header.payloadSize = measureMsgPack(doc);
+
+  uint8_t* payload = (uint8_t*)heap_caps_malloc(
+      header.payloadSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!payload) {
+    LOG_CONFIG_INFO("[CONFIG] WARNING: No PSRAM for devices snapshot (%u B)\n",
+                    header.payloadSize);
+    LittleFS.remove(DEVICES_SNAPSHOT_FILE);  // Never leave a stale snapshot
+    return false;
+  }
+  serializeMsgPack(doc, payload, header.payloadSize);
+  header.payloadCrc = esp_rom_crc32_le(0, payload, header.payloadSize);
+
+  if (xSemaphoreTake(fileMutex, pdMS_TO_TICKS(2000)) != pdTRUE) {
+    heap_caps_free(payload);
+    LittleFS.remove(DEVICES_SNAPSHOT_FILE);
+    return false;
+  }
+
+  // Source checksum of the manifest actually on flash (every commit
+  // rewrites it, so it identifies the record set)
+  bool success = false;
+  File source = LittleFS.open(DEVICES_MANIFEST_FILE, "r");
+  if (source) {
+    header.sourceSize = source.size();
+    success = crc32OfFile(source, header.sourceSize, header.sourceCrc);
+    source.close();
+  }
+
+  if (success) {
+    // Temp file + rename: a torn write never replaces a good snapshot
+    File file = LittleFS.open(DEVICES_SNAPSHOT_TEMP_FILE, "w");
+    success = file &&
+              file.write((const uint8_t*)&header, sizeof(header)) ==
+                  sizeof(header) &&
+              file.write(payload, header.payloadSize) == header.payloadSize;
+    if (file) file.close();
+    success = success &&
+              LittleFS.rename(DEVICES_SNAPSHOT_TEMP_FILE, DEVICES_SNAPSHOT_FILE);
+  }
+  if (!success) {
+    LittleFS.remove(DEVICES_SNAPSHOT_TEMP_FILE);
+    LittleFS.remove(DEVICES_SNAPSHOT_FILE);
+    LOG_CONFIG_INFO("[CONFIG] WARNING: Devices snapshot write failed");
+  }
+
+  xSemaphoreGive(fileMutex);
+  heap_caps_free(payload);
+  return success;
+}
+
+bool ConfigManager::loadDevicesSnapshot(JsonDocument& doc,
+                                        JsonVariantConst filter) {
+  if (xSemaphoreTake(fileMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+    return false;
+  }
+
+  // 1. Header must match this firmware's format
+  SnapshotHeader header = {};
+  File file = LittleFS.open(DEVICES_SNAPSHOT_FILE, "r");
+  if (!file || file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+      header.arduinoJsonMajor != ARDUINOJSON_VERSION_MAJOR ||
+      file.size() != sizeof(header) + header.payloadSize) {
+    if (file) file.close();
+    xSemaphoreGive(fileMutex);
+    return false;
+  }
+
+  // 2. The manifest must be the one the snapshot was taken from (a raw CRC
+  // pass is far cheaper than opening and parsing every record)
+  File source = LittleFS.open(DEVICES_MANIFEST_FILE, "r");
+  uint32_t sourceCrc = 0;
+  bool sourceMatches = source && source.size() == header.sourceSize &&
+                       crc32OfFile(source, header.sourceSize, sourceCrc) &&
+                       sourceCrc == header.sourceCrc;
+  if (source) source.close();
+
+  // 3. One read of the payload, then MessagePack decode
+  uint8_t* payload =
+      sourceMatches ? (uint8_t*)heap_caps_malloc(
+                          header.payloadSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                    : nullptr;
+  bool loaded = payload &&
+                file.read(payload, header.payloadSize) == header.payloadSize &&
+                esp_rom_crc32_le(0, payload, header.payloadSize) ==
+                    header.payloadCrc;
+  file.close();
+  xSemaphoreGive(fileMutex);
+
+  if (loaded) {
+    DeserializationError error =
+        filter.isNull()
+            ? deserializeMsgPack(doc, payload, header.payloadSize)
+            : deserializeMsgPack(doc, payload, header.payloadSize,
+                                 DeserializationOption::Filter(filter));
+    loaded = error == DeserializationError::Ok;
+    if (!loaded) doc.clear();
+  }
+  if (payload) heap_caps_free(payload);
+
+  LOG_CONFIG_INFO("[CONFIG] Devices snapshot %s\n",
+                  loaded ? "loaded" : "stale or invalid - reading records");
+  return loaded;
+}
+
+bool ConfigManager::loadJson(const String& filename, JsonDocument& doc,
+                             JsonVariantConst filter) {
   // Mutex protection for file I/O
   if (xSemaphoreTake(fileMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
     LOG_CONFIG_INFO("[CONFIG] ERROR: loadJson(%s) - mutex timeout\n",
@@ -340,11 +472,18 @@ bool ConfigManager::loadJson(const String& filename, JsonDocument& doc) {
     // Use PSRAM buffer
     file.readBytes(buffer, fileSize);
     buffer[fileSize] = '\0';
-    error = deserializeJson(doc, buffer);
+    // v1.3.3: A filter keeps only the selected fields in doc
+    error = filter.isNull()
+                ? deserializeJson(doc, buffer)
+                : deserializeJson(doc, buffer,
+                                  DeserializationOption::Filter(filter));
     heap_caps_free(buffer);
   } else {
     // Direct stream parsing (uses less memory during parsing)
-    error = deserializeJson(doc, file);
+    error = filter.isNull()
+                ? deserializeJson(doc, file)
+                : deserializeJson(doc, file,
+                                  DeserializationOption::Filter(filter));
   }
 
   file.close();
@@ -403,7 +542,10 @@ String ConfigManager::createDevice(JsonObjectConst config) {
     if (key == "slave_id" || key == "port" || key == "timeout" ||
         key == "retry_count" || key == "refresh_rate_ms" ||
         key == "baud_rate" || key == "data_bits" || key == "stop_bits" ||
-        key == "serial_port") {
+        key == "serial_port" || key == "max_gap" ||
+        key == "pipeline_depth" || key == "inter_frame_us" ||
+        key == "turnaround_ms" || key == "server_unit_id" ||
+        key == "refresh_rate_min_ms" || key == "refresh_rate_max_ms") {
       // Convert string numbers to integers
       int value = kv.value().is<String>() ? kv.value().as<String>().toInt()
                                           : kv.value().as<int>();
@@ -436,14 +578,16 @@ String ConfigManager::createDevice(JsonObjectConst config) {
   }
 
   // Save to file and keep cache valid
-  if (saveJson(DEVICES_FILE, *devicesCache)) {
+  // v1.3.3: Only this device's record (and the manifest) is rewritten
+  if (persistDevice(deviceId)) {
     // SHADOW COPY OPTIMIZATION (v2.3.8): Update shadow copy after successful
     // write
-    updateDevicesShadowCopy();
+    // v1.3.3: Copy-on-write - only this device is copied
+    publishDevicesGeneration(deviceId.c_str());
 
     // v2.5.2: Success log only in development mode
     if (!IS_PRODUCTION_MODE()) {
-      Serial.printf("Device %s created and cache updated (shadow synced)\n",
+      Serial.printf("Device %s created and cache updated (generation published)\n",
                     deviceId.c_str());
     }
     lastDevicesCacheTime = millis();  // Update TTL timestamp
@@ -458,32 +602,12 @@ String ConfigManager::createDevice(JsonObjectConst config) {
 
 bool ConfigManager::readDevice(const String& deviceId, JsonObject& result,
                                bool minimal) {
-  // SHADOW COPY OPTIMIZATION (v2.3.8): Use shadow copy for reads (lock-free)
-  // Only take mutex briefly to check validity and copy pointer
-  if (xSemaphoreTake(cacheMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    LOG_CONFIG_INFO(
-        "[CONFIG] ERROR: readDevice - mutex timeout (fallback to cache load)");
-    // Fallback to old behavior if mutex timeout
-    if (!loadDevicesCache()) {
-      Serial.println("Failed to load devices cache for readDevice");
-      return false;
-    }
-  }
-
-  // Quick validity check (no file I/O inside mutex!)
-  if (!devicesCacheValid) {
-    xSemaphoreGive(cacheMutex);
-    // Reload cache if invalid
-    if (!loadDevicesCache()) {
-      Serial.println("Failed to load devices cache for readDevice");
-      return false;
-    }
-    // Re-acquire mutex after reload
-    if (xSemaphoreTake(cacheMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-      LOG_CONFIG_INFO(
-          "[CONFIG] ERROR: readDevice - mutex timeout after reload");
-      return false;
-    }
+  // v1.3.3: Lock-free read from the current generation (was the v2.3.8
+  // shadow copy read under cacheMutex)
+  DevicesGenerationHandle generation = getDevicesGeneration();
+  if (!generation) {
+    Serial.println("Failed to load devices cache for readDevice");
+    return false;
   }
 
 #ifdef DEBUG_CONFIG_MANAGER
@@ -491,9 +615,10 @@ bool ConfigManager::readDevice(const String& deviceId, JsonObject& result,
   Serial.printf("[DEBUG] Device ID length: %d\n", deviceId.length());
 #endif
 
-  // Read from SHADOW copy (inside brief mutex lock)
-  if (devicesShadowCache->as<JsonObject>()[deviceId]) {
-    JsonObject device = (*devicesShadowCache)[deviceId];
+  for (const DeviceConfigEntry& entry : generation->devices) {
+    if (entry.deviceId != deviceId.c_str()) continue;
+
+    JsonObject device = entry.config->as<JsonObject>();
     int registerCount = 0;
 
     for (JsonPair kv : device) {
@@ -513,28 +638,24 @@ bool ConfigManager::readDevice(const String& deviceId, JsonObject& result,
       result["register_count"] = registerCount;
       LOG_CONFIG_INFO(
           "[CONFIG] Device %s read in MINIMAL mode (register_count=%d) from "
-          "SHADOW\n",
-          deviceId.c_str(), registerCount);
+          "generation %u\n",
+          deviceId.c_str(), registerCount, generation->number);
     }
 
-    // Release mutex ASAP (no file I/O was done!)
-    xSemaphoreGive(cacheMutex);
-
 #ifdef DEBUG_CONFIG_MANAGER
-    Serial.printf("Device %s read from SHADOW cache\n", deviceId.c_str());
+    Serial.printf("Device %s read from generation %u\n", deviceId.c_str(),
+                  generation->number);
 #endif
     return true;
   }
 
-  xSemaphoreGive(cacheMutex);
-
 #ifdef DEBUG_CONFIG_MANAGER
   // Debug: Show all available keys
   Serial.printf("Device %s not found in cache. Available devices:\n",
                 deviceId.c_str());
-  for (JsonPair kv : devicesCache->as<JsonObject>()) {
-    Serial.printf("  - '%s' (length: %d)\n", kv.key().c_str(),
-                  String(kv.key().c_str()).length());
+  for (const DeviceConfigEntry& entry : generation->devices) {
+    Serial.printf("  - '%s' (length: %d)\n", entry.deviceId.c_str(),
+                  (int)strlen(entry.deviceId.c_str()));
   }
 #endif
   return false;
@@ -560,7 +681,10 @@ bool ConfigManager::updateDevice(const String& deviceId,
     if (key == "slave_id" || key == "port" || key == "timeout" ||
         key == "retry_count" || key == "refresh_rate_ms" ||
         key == "baud_rate" || key == "data_bits" || key == "stop_bits" ||
-        key == "serial_port") {
+        key == "serial_port" || key == "max_gap" ||
+        key == "pipeline_depth" || key == "inter_frame_us" ||
+        key == "turnaround_ms" || key == "server_unit_id" ||
+        key == "refresh_rate_min_ms" || key == "refresh_rate_max_ms") {
       // Convert string numbers to integers
       int value = kv.value().is<String>() ? kv.value().as<String>().toInt()
                                           : kv.value().as<int>();
@@ -577,12 +701,14 @@ bool ConfigManager::updateDevice(const String& deviceId,
   }
 
   // Save to file and keep cache valid
-  if (saveJson(DEVICES_FILE, *devicesCache)) {
+  // v1.3.3: Only this device's record (and the manifest) is rewritten
+  if (persistDevice(deviceId)) {
     // SHADOW COPY OPTIMIZATION (v2.3.8): Update shadow copy after successful
     // write
-    updateDevicesShadowCopy();
+    // v1.3.3: Copy-on-write - only this device is copied
+    publishDevicesGeneration(deviceId.c_str());
 
-    Serial.printf("Device %s updated successfully (shadow synced)\n",
+    Serial.printf("Device %s updated successfully (generation published)\n",
                   deviceId.c_str());
     return true;
   }
@@ -596,10 +722,11 @@ bool ConfigManager::deleteDevice(const String& deviceId) {
 
   if (devicesCache->as<JsonObject>()[deviceId]) {
     devicesCache->remove(deviceId);
-    if (saveJson(DEVICES_FILE, *devicesCache)) {
+    if (persistDevice(deviceId)) {  // v1.3.3: Removes its record
       // SHADOW COPY OPTIMIZATION (v2.3.8): Update shadow copy after successful
       // delete
-      updateDevicesShadowCopy();
+      // v1.3.3: Copy-on-write - only this device is copied
+      publishDevicesGeneration(deviceId.c_str());
 
       // Priority 1: Flush queue data for deleted device to prevent orphaned
       // data
@@ -613,8 +740,10 @@ bool ConfigManager::deleteDevice(const String& deviceId) {
         }
       }
 
-      Serial.printf("Device %s deleted (shadow synced)\n", deviceId.c_str());
-      invalidateDevicesCache();
+      Serial.printf("Device %s deleted (generation published)\n", deviceId.c_str());
+      if (devicesBatchDepth == 0) {
+        invalidateDevicesCache();  // v1.3.3: A batch keeps its pending edits
+      }
       return true;
     }
     invalidateDevicesCache();
@@ -664,9 +793,49 @@ void ConfigManager::listDevices(JsonArray& devices) {
 #endif
 }
 
+/**
+ * v1.3.3: Projection read for status / summary commands
+ * Previous: callers loaded every device with all its registers (names,
+ * descriptions, scaling, report-by-exception settings) and then picked a few
+ * fields - a full copy of the configuration in PSRAM per command.
+ * New: only the fields in deviceFilter are materialized. With the cache
+ * loaded they are copied from the current generation (no flash access);
+ * otherwise the snapshot or the device records are parsed with an ArduinoJson
+ * filter, so skipped fields never reach the document.
+ */
+bool ConfigManager::getDevicesProjection(JsonDocument& doc,
+                                         JsonVariantConst deviceFilter) {
+  doc.clear();
+  DevicesGenerationHandle generation = std::atomic_load(&devicesGeneration);
+  if (generation && devicesCacheValid) {
+    JsonObject devices = doc.to<JsonObject>();
+    for (const DeviceConfigEntry& entry : generation->devices) {
+      projectJson(entry.config->as<JsonVariantConst>(), deviceFilter,
+                  devices[entry.deviceId.c_str()]);
+    }
+    return true;
+  }
+
+  // The snapshot holds every device in one object: same filter per key
+  JsonDocument filter;
+  filter["*"] = deviceFilter;
+  return loadDevicesSnapshot(doc, filter.as<JsonVariantConst>()) ||
+         loadDeviceRecords(doc, deviceFilter);
+}
+
 void ConfigManager::getDevicesSummary(JsonArray& summary) {
+  // v1.3.3: Summary fields only; registers as empty objects (counted)
+  JsonDocument filter;
+  for (const char* key : {"device_name", "protocol", "slave_id",
+                          "serial_port", "ip"}) {
+    filter[key] = true;
+  }
+  filter["registers"].add<JsonObject>();
+
   JsonDocument devices;
-  if (!loadJson(DEVICES_FILE, devices)) return;
+  if (!getDevicesProjection(devices, filter.as<JsonVariantConst>())) {
+    return;
+  }
 
   for (JsonPair kv : devices.as<JsonObject>()) {
     JsonObject device = kv.value();
@@ -696,8 +865,29 @@ void ConfigManager::getAllDevicesWithRegisters(JsonArray& result,
   LOG_CONFIG_INFO("[GET_ALL_DEVICES_WITH_REGISTERS] Starting (minimal=%s)...\n",
                   minimalFields ? "true" : "false");
 
+  // v1.3.3: Only the fields copyDeviceWithRegisters() writes
+  JsonDocument filter;
+  if (minimalFields) {
+    for (const char* key : {"device_name", "protocol", "refresh_rate_ms",
+                            "baud_rate", "slave_id", "serial_port", "ip"}) {
+      filter[key] = true;
+    }
+  } else {
+    filter["*"] = true;  // Every device field, registers listed below
+  }
+  JsonObject registerFilter = filter["registers"].add<JsonObject>();
+  registerFilter["register_id"] = true;
+  registerFilter["register_name"] = true;
+  if (!minimalFields) {
+    for (const char* key :
+         {"address", "data_type", "function_code", "unit", "description",
+          "scale", "offset", "decimals", "register_index"}) {
+      registerFilter[key] = true;
+    }
+  }
+
   JsonDocument devices;
-  if (!loadJson(DEVICES_FILE, devices)) {
+  if (!getDevicesProjection(devices, filter.as<JsonVariantConst>())) {
     LOG_CONFIG_INFO(
         "[GET_ALL_DEVICES_WITH_REGISTERS] ERROR: Failed to load devices file");
     return;
@@ -718,85 +908,90 @@ void ConfigManager::getAllDevicesWithRegisters(JsonArray& result,
   for (JsonPair kv : devicesObj) {
     const char* deviceId = kv.key().c_str();  // BUG #31: const char* instead of
                                               // String (zero allocation!)
-    JsonObject device = kv.value();
-    JsonObject deviceWithRegs = result.add<JsonObject>();
+    copyDeviceWithRegisters(deviceId, kv.value(), result.add<JsonObject>(),
+                            minimalFields);
+  }
+
+  LOG_CONFIG_INFO("[GET_ALL_DEVICES_WITH_REGISTERS] Total devices: %d\n",
+                  result.size());
+}
 
-    // Add device ID first
-    deviceWithRegs["device_id"] = deviceId;
+void ConfigManager::copyDeviceWithRegisters(const char* deviceId,
+                                            JsonObjectConst device,
+                                            JsonObject deviceWithRegs,
+                                            bool minimalFields) {
+  // Add device ID first
+  deviceWithRegs["device_id"] = deviceId;
 
-    // Copy ALL device fields (except registers, handle separately)
-    for (JsonPair deviceKv : device) {
-      String key = deviceKv.key().c_str();
+  // Copy ALL device fields (except registers, handle separately)
+  for (JsonPairConst deviceKv : device) {
+    String key = deviceKv.key().c_str();
 
-      if (key == "registers") {
-        // Skip registers, will be handled separately below
-        continue;
-      }
+    if (key == "registers") {
+      // Skip registers, will be handled separately below
+      continue;
+    }
 
-      if (minimalFields) {
-        // In minimal mode, only copy essential fields for MQTT timeout
-        // calculation CRITICAL FIX: Must include refresh_rate_ms and baud_rate
-        // for adaptive timeout v1.0.2: Added "ip" for proper slave_id
-        // validation in mobile app Mobile app needs ip (TCP) and serial_port
-        // (RTU) to validate slave_id uniqueness per bus/endpoint
-        if (key == "device_name" || key == "protocol" ||
-            key == "refresh_rate_ms" || key == "baud_rate" ||
-            key == "slave_id" || key == "serial_port" || key == "ip") {
-          deviceWithRegs[deviceKv.key()] = deviceKv.value();
-        }
-      } else {
-        // In full mode, copy ALL fields (timeout, retry_count, enabled, ip,
-        // serial_port, baud_rate, etc.)
+    if (minimalFields) {
+      // In minimal mode, only copy essential fields for MQTT timeout
+      // calculation CRITICAL FIX: Must include refresh_rate_ms and baud_rate
+      // for adaptive timeout v1.0.2: Added "ip" for proper slave_id
+      // validation in mobile app Mobile app needs ip (TCP) and serial_port
+      // (RTU) to validate slave_id uniqueness per bus/endpoint
+      if (key == "device_name" || key == "protocol" ||
+          key == "refresh_rate_ms" || key == "baud_rate" ||
+          key == "slave_id" || key == "serial_port" || key == "ip") {
         deviceWithRegs[deviceKv.key()] = deviceKv.value();
       }
+    } else {
+      // In full mode, copy ALL fields (timeout, retry_count, enabled, ip,
+      // serial_port, baud_rate, etc.)
+      deviceWithRegs[deviceKv.key()] = deviceKv.value();
     }
+  }
 
-    // Add all registers
-    JsonArray registers = deviceWithRegs["registers"].to<JsonArray>();
-
-    if (device["registers"].is<JsonArray>()) {
-      JsonArray deviceRegisters = device["registers"];
+  // Add all registers
+  JsonArray registers = deviceWithRegs["registers"].to<JsonArray>();
 
-      if (deviceRegisters.size() == 0) {
-        LOG_CONFIG_INFO(
-            "[GET_ALL_DEVICES_WITH_REGISTERS] Device %s has empty registers "
-            "array\n",
-            deviceId);  // BUG #31: removed .c_str()
-      }
+  if (device["registers"].is<JsonArrayConst>()) {
+    JsonArrayConst deviceRegisters = device["registers"];
 
-      for (JsonObject reg : deviceRegisters) {
-        JsonObject registerInfo = registers.add<JsonObject>();
-
-        // Always include essential fields for MQTT customize mode
-        registerInfo["register_id"] = reg["register_id"];
-        registerInfo["register_name"] = reg["register_name"];
-
-        if (!minimalFields) {
-          // Include all fields for detailed view
-          registerInfo["address"] = reg["address"];
-          registerInfo["data_type"] = reg["data_type"];
-          registerInfo["function_code"] = reg["function_code"];
-          registerInfo["unit"] = reg["unit"];
-          registerInfo["description"] = reg["description"];
-          registerInfo["scale"] = reg["scale"];
-          registerInfo["offset"] = reg["offset"];
-          registerInfo["decimals"] = reg["decimals"] | -1;  // v1.0.7
-          registerInfo["register_index"] = reg["register_index"];
-        }
-      }
-    } else {
+    if (deviceRegisters.size() == 0) {
       LOG_CONFIG_INFO(
-          "[GET_ALL_DEVICES_WITH_REGISTERS] Device %s has no registers array\n",
+          "[GET_ALL_DEVICES_WITH_REGISTERS] Device %s has empty registers "
+          "array\n",
           deviceId);  // BUG #31: removed .c_str()
     }
 
+    for (JsonObjectConst reg : deviceRegisters) {
+      JsonObject registerInfo = registers.add<JsonObject>();
+
+      // Always include essential fields for MQTT customize mode
+      registerInfo["register_id"] = reg["register_id"];
+      registerInfo["register_name"] = reg["register_name"];
+
+      if (!minimalFields) {
+        // Include all fields for detailed view
+        registerInfo["address"] = reg["address"];
+        registerInfo["data_type"] = reg["data_type"];
+        registerInfo["function_code"] = reg["function_code"];
+        registerInfo["unit"] = reg["unit"];
+        registerInfo["description"] = reg["description"];
+        registerInfo["scale"] = reg["scale"];
+        registerInfo["offset"] = reg["offset"];
+        registerInfo["decimals"] = reg["decimals"] | -1;  // v1.0.7
+        registerInfo["register_index"] = reg["register_index"];
+      }
+    }
+  } else {
     LOG_CONFIG_INFO(
-        "[GET_ALL_DEVICES_WITH_REGISTERS] Added device %s with %d registers\n",
-        deviceId, registers.size());  // BUG #31: removed .c_str()
+        "[GET_ALL_DEVICES_WITH_REGISTERS] Device %s has no registers array\n",
+        deviceId);  // BUG #31: removed .c_str()
   }
 
-  LOG_CONFIG_INFO("[GET_ALL_DEVICES_WITH_REGISTERS] Total devices: %d\n",
-                  result.size());
+  LOG_CONFIG_INFO(
+      "[GET_ALL_DEVICES_WITH_REGISTERS] Added device %s with %d registers\n",
+      deviceId, registers.size());  // BUG #31: removed .c_str()
 }
 
 String ConfigManager::createRegister(const String& deviceId,
@@ -920,6 +1115,21 @@ String ConfigManager::createRegister(const String& deviceId,
       float value = kv.value().is<String>() ? kv.value().as<String>().toFloat()
                                             : kv.value().as<float>();
       newRegister[kv.key()] = value;
+    } else if (key == "deadband" || key == "deadband_percent") {
+      // v1.3.3: Report-by-exception deadband (negative = disabled)
+      float value = kv.value().is<String>() ? kv.value().as<String>().toFloat()
+                                            : kv.value().as<float>();
+      newRegister[kv.key()] = value > 0.0f ? value : 0.0f;
+    } else if (key == "max_silence_ms") {
+      // v1.3.3: Forced report interval for deadband registers (0 = none)
+      long value = kv.value().is<String>() ? kv.value().as<String>().toInt()
+                                           : kv.value().as<long>();
+      newRegister[kv.key()] = value > 0 ? value : 0;
+    } else if (key == "server_address") {
+      // v1.3.3: Modbus TCP server address (default: "address")
+      long value = kv.value().is<String>() ? kv.value().as<String>().toInt()
+                                           : kv.value().as<long>();
+      newRegister[kv.key()] = value;
     // v1.2.0: mqtt_subscribe removed - use custom_subscribe_mode in server_config
     } else {
       newRegister[kv.key()] = kv.value();
@@ -954,16 +1164,20 @@ String ConfigManager::createRegister(const String& deviceId,
   }
   // v1.0.8: min_value and max_value are optional, no defaults needed
   // If not set, validation is skipped in writeRegisterValue()
+  // v1.3.3: deadband / deadband_percent / max_silence_ms are optional too
+  // (not set = every read is reported)
 
   // Save to file and keep cache valid
-  if (saveJson(DEVICES_FILE, *devicesCache)) {
+  // v1.3.3: Only this device's record (and the manifest) is rewritten
+  if (persistDevice(deviceId)) {
     // v2.5.40 FIX: Update shadow copy after register creation
     // Without this, Modbus services read stale data from shadow cache
-    updateDevicesShadowCopy();
+    // v1.3.3: Copy-on-write - only this device is copied
+    publishDevicesGeneration(deviceId.c_str());
 
     // v2.5.2: Success log only in development mode
     if (!IS_PRODUCTION_MODE()) {
-      Serial.printf("[CREATE_REG] OK: %s (ID: %s, idx: %d) shadow synced\n",
+      Serial.printf("[CREATE_REG] OK: %s (ID: %s, idx: %d) generation published\n",
                     newRegister["register_name"].as<String>().c_str(),
                     registerId.c_str(), registerIndex);
     }
@@ -1035,6 +1249,23 @@ bool ConfigManager::getRegistersSummary(const String& deviceId,
         if (!reg["max_value"].isNull()) {
           regSummary["max_value"] = reg["max_value"];
         }
+        // v1.3.3: Report-by-exception settings (optional fields)
+        if (!reg["deadband"].isNull()) {
+          regSummary["deadband"] = reg["deadband"];
+        }
+        if (!reg["deadband_percent"].isNull()) {
+          regSummary["deadband_percent"] = reg["deadband_percent"];
+        }
+        if (!reg["max_silence_ms"].isNull()) {
+          regSummary["max_silence_ms"] = reg["max_silence_ms"];
+        }
+        // v1.3.3: Modbus TCP server map overrides (optional fields)
+        if (!reg["server_address"].isNull()) {
+          regSummary["server_address"] = reg["server_address"];
+        }
+        if (!reg["server_data_type"].isNull()) {
+          regSummary["server_data_type"] = reg["server_data_type"];
+        }
         // v1.2.0: mqtt_subscribe removed - use custom_subscribe_mode in server_config
       }
       return true;
@@ -1126,6 +1357,24 @@ bool ConfigManager::updateRegister(const String& deviceId,
                             ? kv.value().as<String>().toFloat()
                             : kv.value().as<float>();
           reg[kv.key()] = value;
+        } else if (key == "deadband" || key == "deadband_percent") {
+          // v1.3.3: Report-by-exception deadband (negative = disabled)
+          float value = kv.value().is<String>()
+                            ? kv.value().as<String>().toFloat()
+                            : kv.value().as<float>();
+          reg[kv.key()] = value > 0.0f ? value : 0.0f;
+        } else if (key == "max_silence_ms") {
+          // v1.3.3: Forced report interval for deadband registers (0 = none)
+          long value = kv.value().is<String>()
+                           ? kv.value().as<String>().toInt()
+                           : kv.value().as<long>();
+          reg[kv.key()] = value > 0 ? value : 0;
+        } else if (key == "server_address") {
+          // v1.3.3: Modbus TCP server address (default: "address")
+          long value = kv.value().is<String>()
+                           ? kv.value().as<String>().toInt()
+                           : kv.value().as<long>();
+          reg[kv.key()] = value;
         // v1.2.0: mqtt_subscribe removed - use custom_subscribe_mode in server_config
         } else {
           reg[kv.key()] = kv.value();
@@ -1134,14 +1383,16 @@ bool ConfigManager::updateRegister(const String& deviceId,
       reg["register_id"] = registerId;  // Ensure register_id is preserved
 
       // Save to file and keep cache valid
-      if (saveJson(DEVICES_FILE, *devicesCache)) {
+      // v1.3.3: Only this device's record (and the manifest) is rewritten
+      if (persistDevice(deviceId)) {
         // v2.5.40 FIX: Update shadow copy after register update
         // CRITICAL: Without this, calibration (offset/scale) changes are NOT
         // applied! Modbus services read from shadow cache, not directly from
         // file
-        updateDevicesShadowCopy();
+        // v1.3.3: Copy-on-write - only this device is copied
+        publishDevicesGeneration(deviceId.c_str());
 
-        Serial.printf("Register %s updated successfully (shadow synced)\n",
+        Serial.printf("Register %s updated successfully (generation published)\n",
                       registerId.c_str());
         return true;
       }
@@ -1186,15 +1437,17 @@ bool ConfigManager::deleteRegister(const String& deviceId,
       }
 
       // Save to file and keep cache valid
-      if (saveJson(DEVICES_FILE, *devicesCache)) {
+      // v1.3.3: Only this device's record (and the manifest) is rewritten
+      if (persistDevice(deviceId)) {
         // v2.5.40 FIX: Update shadow copy after register deletion
         // Without this, Modbus services still see deleted register in shadow
         // cache
-        updateDevicesShadowCopy();
+        // v1.3.3: Copy-on-write - only this device is copied
+        publishDevicesGeneration(deviceId.c_str());
 
         Serial.printf(
             "Register %s deleted successfully, re-indexed %d remaining "
-            "registers (shadow synced)\n",
+            "registers (generation published)\n",
             registerId.c_str(), registers.size());
         return true;
       }
@@ -1220,8 +1473,10 @@ bool ConfigManager::loadDevicesCache() {
   // Previous code only checked devicesCacheValid, ignoring TTL expiration
   if (devicesCacheValid) {
     // Check if cache has expired (TTL = 10 minutes)
+    // v1.3.3: Never expire inside a batch (flash lacks its pending edits)
     unsigned long now = millis();
-    if ((now - lastDevicesCacheTime) >= CACHE_TTL_MS) {
+    if ((now - lastDevicesCacheTime) >= CACHE_TTL_MS &&
+        devicesBatchDepth == 0) {
       LOG_CONFIG_INFO(
           "[CACHE] Devices cache expired (%lu ms old, TTL: %lu ms). "
           "Reloading...\n",
@@ -1239,8 +1494,8 @@ bool ConfigManager::loadDevicesCache() {
 
   // If the file doesn't exist, create an empty JSON object in the cache and
   // exit.
-  if (!LittleFS.exists(DEVICES_FILE)) {
-    Serial.println("Devices file not found. Initializing empty cache.");
+  if (!LittleFS.exists(DEVICES_MANIFEST_FILE)) {
+    Serial.println("Devices manifest not found. Initializing empty cache.");
     devicesCache->clear();
     devicesCache->to<JsonObject>();
     devicesCacheValid = true;
@@ -1253,8 +1508,13 @@ bool ConfigManager::loadDevicesCache() {
   // Clear the cache before loading new data from the file.
   devicesCache->clear();
 
-  // Attempt to load and parse the JSON from the file.
-  if (loadJson(DEVICES_FILE, *devicesCache)) {
+  // v1.3.3: Binary snapshot first (one read + MessagePack decode). The
+  // device records are parsed only when the snapshot is missing or does not
+  // match the manifest.
+  bool fromSnapshot = loadDevicesSnapshot(*devicesCache);
+
+  // Attempt to load and parse the device records.
+  if (fromSnapshot || loadDeviceRecords(*devicesCache)) {
     // Migration: Auto-generate register_index for existing registers without it
     bool needsSave = false;
     JsonObject devices = devicesCache->as<JsonObject>();
@@ -1319,9 +1579,11 @@ bool ConfigManager::loadDevicesCache() {
     // Save if migration was applied
     if (needsSave) {
       Serial.println(
-          "[MIGRATION] Saving devices.json with calibration fields and removed "
-          "refresh_rate_ms...");
-      saveJson(DEVICES_FILE, *devicesCache);
+          "[MIGRATION] Saving device records with calibration fields and "
+          "removed refresh_rate_ms...");
+      saveDevicesStore(*devicesCache);
+    } else if (!fromSnapshot) {
+      saveDevicesSnapshot(*devicesCache);  // Next load skips the JSON parse
     }
 
     devicesCacheValid = true;
@@ -1330,10 +1592,11 @@ bool ConfigManager::loadDevicesCache() {
     // SHADOW COPY OPTIMIZATION (v2.3.8): Update shadow copy for lock-free reads
     // Shadow copy is updated INSIDE mutex (safe), but reads can access it with
     // minimal locking
-    updateDevicesShadowCopy();
+    // v1.3.3: Full rebuild (freshly loaded records)
+    publishDevicesGeneration();
 
     LOG_CONFIG_INFO(
-        "[CACHE] Loaded successfully | Devices: %d (shadow copy updated)\n",
+        "[CACHE] Loaded successfully | Devices: %d (generation published)\n",
         devices.size());
     logMemoryStats(
         "after loadDevicesCache success");  // Phase 4: Memory tracking
@@ -1344,7 +1607,7 @@ bool ConfigManager::loadDevicesCache() {
   // If parsing fails, log the error and create an empty cache to ensure stable
   // operation.
   Serial.println(
-      "ERROR: Failed to parse devices.json. Initializing empty cache to "
+      "ERROR: Failed to load device records. Initializing empty cache to "
       "prevent data corruption.");
   devicesCache->clear();
   devicesCache->to<JsonObject>();
@@ -1525,6 +1788,7 @@ void ConfigManager::clearCache() {
   // Free JsonDocument memory
   devicesCache->clear();
   registersCache->clear();
+  dropDevicesGeneration();  // v1.3.3: Freed once readers drop their handles
 
   LOG_CONFIG_INFO(
       "[CACHE] Devices and registers caches cleared (will reload on next "
@@ -1534,34 +1798,43 @@ void ConfigManager::clearCache() {
 void ConfigManager::debugDevicesFile() {
   Serial.println("\n[CONFIG] DEVICES FILE DEBUG");
 
-  if (!LittleFS.exists(DEVICES_FILE)) {
-    Serial.println("  Status: File does not exist");
+  // v1.3.3: Manifest followed by every device record it lists
+  auto dumpFile = [](const String& path) {
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+      Serial.printf("  %s: failed to open\n", path.c_str());
+      return;
+    }
+
+    Serial.printf("  %s (%d bytes):\n", path.c_str(), file.size());
+    while (file.available()) {
+      Serial.write(file.read());
+    }
+    Serial.println("\n");
+    file.close();
+  };
+
+  if (!LittleFS.exists(DEVICES_MANIFEST_FILE)) {
+    Serial.println("  Status: Manifest does not exist");
     return;
   }
+  dumpFile(DEVICES_MANIFEST_FILE);
 
-  File file = LittleFS.open(DEVICES_FILE, "r");
-  if (!file) {
-    Serial.println("  Status: Failed to open file");
+  JsonDocument manifest;
+  if (!loadJson(DEVICES_MANIFEST_FILE, manifest)) {
+    Serial.println("  Status: Failed to parse manifest");
     return;
   }
-
-  Serial.printf("  File size: %d bytes\n", file.size());
-  Serial.println("  Content:");
-  Serial.println();
-
-  while (file.available()) {
-    Serial.write(file.read());
+  for (JsonVariantConst id : manifest["devices"].as<JsonArrayConst>()) {
+    dumpFile(deviceRecordPath(id.as<const char*>()));
   }
-  Serial.println("\n");
-
-  file.close();
 }
 
 void ConfigManager::fixCorruptDeviceIds() {
   Serial.println("\n[CONFIG] FIXING CORRUPT DEVICE IDS");
 
   JsonDocument originalDoc;
-  if (!loadJson(DEVICES_FILE, originalDoc)) {
+  if (!loadDeviceRecords(originalDoc)) {
     Serial.println("  Status: Failed to load devices file");
     return;
   }
@@ -1599,7 +1872,7 @@ void ConfigManager::fixCorruptDeviceIds() {
 
   if (foundCorruption) {
     Serial.println("  Saving fixed devices file...");
-    if (saveJson(DEVICES_FILE, fixedDoc)) {
+    if (saveDevicesStore(fixedDoc)) {
       Serial.println("  Status: Fixed devices file saved successfully");
       // Force invalidate cache to reload fixed data
       invalidateDevicesCache();
@@ -1652,7 +1925,7 @@ void ConfigManager::removeCorruptKeys() {
 
   if (keysToRemove.size() > 0) {
     // Save cleaned cache
-    if (saveJson(DEVICES_FILE, *devicesCache)) {
+    if (saveDevicesStore(*devicesCache)) {
       Serial.printf("  Status: Removed %d corrupt keys and saved file\n",
                     keysToRemove.size());
     } else {
@@ -1668,7 +1941,7 @@ void ConfigManager::clearAllConfigurations() {
   Serial.println("Clearing all device and register configurations...");
   JsonDocument emptyDoc;
   emptyDoc.to<JsonObject>();
-  saveJson(DEVICES_FILE, emptyDoc);
+  saveDevicesStore(emptyDoc);  // v1.3.3: Removes every device record
   saveJson(REGISTERS_FILE, emptyDoc);
   invalidateDevicesCache();
   invalidateRegistersCache();
@@ -1676,54 +1949,318 @@ void ConfigManager::clearAllConfigurations() {
 }
 
 // ============================================================================
-// SHADOW COPY OPTIMIZATION (v2.3.8)
+// v1.3.3: CONFIG GENERATIONS (replace SHADOW COPY OPTIMIZATION v2.3.8)
 // ============================================================================
 
+ConfigManager::DevicesGenerationHandle ConfigManager::getDevicesGeneration() {
+  DevicesGenerationHandle generation = std::atomic_load(&devicesGeneration);
+  if (!generation || !devicesCacheValid) {
+    if (!loadDevicesCache()) {
+      return nullptr;
+    }
+    generation = std::atomic_load(&devicesGeneration);
+  }
+  return generation;
+}
+
 /**
- * Update devices shadow copy from primary cache
- * MUST be called inside cacheMutex lock!
- * This creates a read-only copy for lock-free runtime reads
+ * Publish devicesCache as a new generation
+ * Only the changed device is copied; all other entries are shared with the
+ * current generation (copy-on-write). Readers never block: they keep using
+ * the generation they loaded until they drop their handle.
  */
-void ConfigManager::updateDevicesShadowCopy() {
-  // CRITICAL: This function MUST be called while holding cacheMutex!
-  // Caller is responsible for mutex management
-
-  if (!devicesShadowCache || !devicesCache) {
-    LOG_CONFIG_INFO("[CONFIG] ERROR: Shadow cache or primary cache is null");
+void ConfigManager::publishDevicesGeneration(const char* changedDeviceId) {
+  if (!devicesCache) {
+    LOG_CONFIG_INFO("[CONFIG] ERROR: Primary devices cache is null");
     return;
   }
+  if (generationsDeferred && changedDeviceId) {
+    return;  // Published by commitDevicesBatch()
+  }
 
-  // Clear shadow copy
-  devicesShadowCache->clear();
+  DevicesGenerationHandle current = std::atomic_load(&devicesGeneration);
+  std::shared_ptr<DevicesGeneration> next =
+      std::make_shared<DevicesGeneration>();
+  next->number = current ? current->number + 1 : 1;
+  JsonObject devices = devicesCache->as<JsonObject>();
 
-  // Deep copy from primary cache to shadow cache
-  // ArduinoJson v7 provides efficient set() method for deep copy
-  devicesShadowCache->set(*devicesCache);
+  auto copyDevice = [](JsonObject device) {
+    DeviceConfigHandle config = std::make_shared<JsonDocument>();
+    config->set(device);
+    return config;
+  };
 
-  LOG_CONFIG_INFO(
-      "[CONFIG] Devices shadow copy updated (lock-free reads enabled)");
+  size_t copied = 0;
+  if (changedDeviceId && current) {
+    JsonObject changed = devices[changedDeviceId];
+    bool found = false;
+    next->devices.reserve(current->devices.size() + 1);
+    for (const DeviceConfigEntry& entry : current->devices) {
+      if (entry.deviceId != changedDeviceId) {
+        next->devices.push_back(entry);  // Shared, no copy
+      } else if (!changed.isNull()) {
+        next->devices.push_back({entry.deviceId, copyDevice(changed)});
+        copied++;
+        found = true;
+      } else {
+        found = true;  // Deleted
+      }
+    }
+    if (!found && !changed.isNull()) {
+      next->devices.push_back(
+          {InternedString(changedDeviceId), copyDevice(changed)});
+      copied++;
+    }
+  } else {
+    next->devices.reserve(devices.size());
+    for (JsonPair kv : devices) {
+      next->devices.push_back(
+          {InternedString(kv.key().c_str()), copyDevice(kv.value())});
+      copied++;
+    }
+  }
+
+  std::atomic_store(&devicesGeneration,
+                    DevicesGenerationHandle(std::move(next)));
+
+  LOG_CONFIG_INFO("[CONFIG] Devices generation %u published (%u copied)\n",
+                  current ? current->number + 1 : 1, copied);
+}
+
+void ConfigManager::dropDevicesGeneration() {
+  std::atomic_store(&devicesGeneration, DevicesGenerationHandle());
+}
+
+// ============================================================================
+// v1.3.3: PER-DEVICE STORAGE (replaces rewriting the whole devices.json)
+// ============================================================================
+
+String ConfigManager::deviceRecordPath(const char* deviceId) {
+  return String(DEVICE_RECORDS_DIR) + "/" + deviceId + ".json";
 }
 
 /**
- * Update registers shadow copy from primary cache
- * MUST be called inside cacheMutex lock!
- * This creates a read-only copy for lock-free runtime reads
+ * One-time migration from /devices.json, then read the manifest counter
+ * The legacy file is removed only after the manifest has been committed, so
+ * a power loss during migration simply repeats it on the next boot.
  */
-void ConfigManager::updateRegistersShadowCopy() {
-  // CRITICAL: This function MUST be called while holding cacheMutex!
-  // Caller is responsible for mutex management
+bool ConfigManager::openDevicesStore() {
+  JsonDocument manifest;
+  if (loadJson(DEVICES_MANIFEST_FILE, manifest)) {
+    manifestCommit = manifest["commit"] | 0u;
+    return true;
+  }
 
-  if (!registersShadowCache || !registersCache) {
-    LOG_CONFIG_INFO("[CONFIG] ERROR: Shadow cache or primary cache is null");
-    return;
+  JsonDocument doc;
+  bool legacy = LittleFS.exists(DEVICES_FILE);
+  if (legacy && !loadJson(DEVICES_FILE, doc)) {
+    LOG_CONFIG_INFO(
+        "[CONFIG] ERROR: devices.json unreadable - kept on flash, starting "
+        "with no devices");
+    legacy = false;
+    doc.clear();
+  }
+  if (!doc.is<JsonObject>()) {
+    doc.to<JsonObject>();
   }
 
-  // Clear shadow copy
-  registersShadowCache->clear();
+  if (!saveDevicesStore(doc)) {
+    return false;
+  }
+  if (legacy) {
+    LittleFS.remove(DEVICES_FILE);
+    LOG_CONFIG_INFO("[CONFIG] Migrated devices.json to %u device records\n",
+                    doc.as<JsonObject>().size());
+  }
+  LittleFS.remove(DEVICES_SNAPSHOT_FILE);  // v1 snapshot of devices.json
+  return true;
+}
 
-  // Deep copy from primary cache to shadow cache
-  registersShadowCache->set(*registersCache);
+bool ConfigManager::loadDeviceRecords(JsonDocument& doc,
+                                      JsonVariantConst deviceFilter) {
+  JsonDocument manifest;
+  if (!loadJson(DEVICES_MANIFEST_FILE, manifest)) {
+    return false;
+  }
 
-  LOG_CONFIG_INFO(
-      "[CONFIG] Registers shadow copy updated (lock-free reads enabled)");
-}
\ No newline at end of file
+  doc.clear();
+  JsonObject devices = doc.to<JsonObject>();
+  for (JsonVariantConst id : manifest["devices"].as<JsonArrayConst>()) {
+    const char* deviceId = id.as<const char*>();
+    JsonDocument record;
+    if (!deviceId ||
+        !loadJson(deviceRecordPath(deviceId), record, deviceFilter) ||
+        !record.is<JsonObject>()) {
+      LOG_CONFIG_INFO("[CONFIG] WARNING: Device record %s missing - skipped\n",
+                      deviceId ? deviceId : "(null)");
+      continue;
+    }
+    devices[deviceId] = record.as<JsonObject>();
+  }
+  return true;
+}
+
+/**
+ * Rewrite every record of doc (migration, repairs, clear all)
+ * Records first, manifest last; records the new manifest no longer lists
+ * are removed after it has been committed.
+ */
+bool ConfigManager::saveDevicesStore(const JsonDocument& doc) {
+  JsonDocument previous;
+  bool hadManifest = loadJson(DEVICES_MANIFEST_FILE, previous);
+
+  // One WAL group: all records and the manifest land together
+  bool grouped = atomicFileOps && atomicFileOps->beginGroup();
+  JsonObjectConst devices = doc.as<JsonObjectConst>();
+  bool success = true;
+  for (JsonPairConst kv : devices) {
+    JsonDocument record;
+    record.set(kv.value());
+    success = saveJson(deviceRecordPath(kv.key().c_str()), record) && success;
+  }
+  success = success && writeDevicesManifest(devices);
+  if (grouped && success) {
+    success = atomicFileOps->commitGroup();
+  } else if (grouped) {
+    atomicFileOps->abortGroup();
+  }
+
+  if (!success) {
+    LittleFS.remove(DEVICES_SNAPSHOT_FILE);  // Records may be ahead of it
+    return false;
+  }
+  if (hadManifest) {
+    for (JsonVariantConst id : previous["devices"].as<JsonArrayConst>()) {
+      const char* deviceId = id.as<const char*>();
+      if (deviceId && devices[deviceId].isNull()) {
+        LittleFS.remove(deviceRecordPath(deviceId));
+      }
+    }
+  }
+  return true;
+}
+
+bool ConfigManager::writeDevicesManifest(JsonObjectConst devices) {
+  JsonDocument manifest;
+  manifest["format"] = MANIFEST_FORMAT;
+  manifest["commit"] = manifestCommit + 1;  // Changes the manifest bytes
+  JsonArray deviceIds = manifest["devices"].to<JsonArray>();
+  for (JsonPairConst kv : devices) {
+    deviceIds.add(kv.key());
+  }
+
+  if (!saveJson(DEVICES_MANIFEST_FILE, manifest)) {
+    return false;
+  }
+  manifestCommit++;
+  return true;
+}
+
+bool ConfigManager::persistDevice(const String& deviceId) {
+  if (devicesBatchDepth > 0) {
+    for (const PSRAMString& dirtyId : dirtyDeviceIds) {
+      if (dirtyId == deviceId) {
+        return true;
+      }
+    }
+    dirtyDeviceIds.push_back(PSRAMString(deviceId.c_str()));
+    return true;
+  }
+
+  std::vector<PSRAMString> deviceIds;
+  deviceIds.push_back(PSRAMString(deviceId.c_str()));
+  return commitDevices(deviceIds);
+}
+
+/**
+ * Write the records of deviceIds from devicesCache, then the manifest
+ * A device missing from the cache was deleted: its record is removed once
+ * the manifest no longer lists it.
+ */
+bool ConfigManager::commitDevices(const std::vector<PSRAMString>& deviceIds) {
+  if (!devicesCacheValid) {
+    return false;  // Never derive deletions from an unloaded cache
+  }
+
+  // One WAL group: the records and the manifest land together
+  bool grouped = atomicFileOps && atomicFileOps->beginGroup();
+  JsonObject devices = devicesCache->as<JsonObject>();
+  bool success = true;
+  for (const PSRAMString& deviceId : deviceIds) {
+    JsonObject device = devices[deviceId.c_str()];
+    if (device.isNull()) {
+      continue;
+    }
+    JsonDocument record;
+    record.set(device);
+    success = saveJson(deviceRecordPath(deviceId.c_str()), record) && success;
+  }
+  success = success && writeDevicesManifest(devices);
+  if (grouped && success) {
+    success = atomicFileOps->commitGroup();
+  } else if (grouped) {
+    atomicFileOps->abortGroup();
+  }
+
+  if (!success) {
+    LittleFS.remove(DEVICES_SNAPSHOT_FILE);  // Records may be ahead of it
+    return false;
+  }
+  for (const PSRAMString& deviceId : deviceIds) {
+    if (devices[deviceId.c_str()].isNull()) {
+      LittleFS.remove(deviceRecordPath(deviceId.c_str()));
+    }
+  }
+  return true;
+}
+
+void ConfigManager::beginDevicesBatch(bool deferGenerations) {
+  if (devicesBatchDepth++ == 0) {
+    generationsDeferred = deferGenerations;
+  }
+}
+
+bool ConfigManager::commitDevicesBatch() {
+  if (devicesBatchDepth == 0 || --devicesBatchDepth > 0) {
+    return true;  // Not in a batch / outer batch commits
+  }
+  bool deferred = generationsDeferred;
+  generationsDeferred = false;
+  if (dirtyDeviceIds.empty()) {
+    return true;
+  }
+
+  std::vector<PSRAMString> deviceIds;
+  deviceIds.swap(dirtyDeviceIds);
+
+  bool success = false;
+  if (xSemaphoreTake(cacheMutex, pdMS_TO_TICKS(2000)) == pdTRUE) {
+    success = commitDevices(deviceIds);
+    xSemaphoreGive(cacheMutex);
+  }
+
+  LOG_CONFIG_INFO("[CONFIG] Devices batch commit: %u device(s) %s\n",
+                  deviceIds.size(), success ? "written" : "FAILED");
+  if (!success) {
+    invalidateDevicesCache();  // Reload what is actually on flash
+  } else if (deferred) {
+    for (const PSRAMString& deviceId : deviceIds) {
+      publishDevicesGeneration(deviceId.c_str());
+    }
+  }
+  return success;
+}
+
+void ConfigManager::abortDevicesBatch() {
+  if (devicesBatchDepth == 0) {
+    return;
+  }
+  devicesBatchDepth = 0;
+  generationsDeferred = false;
+  bool touched = !dirtyDeviceIds.empty();
+  dirtyDeviceIds.clear();
+  if (touched) {
+    invalidateDevicesCache();  // Drop the unwritten edits
+  }
+  LOG_CONFIG_INFO("[CONFIG] Devices batch aborted\n");
+}
@@ -7,26 +7,75 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include <memory>  // v1.3.3: std::shared_ptr config generations
+#include <vector>
+
 #include "AtomicFileOps.h"      // Atomic file operations
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include "PSRAMString.h"
+#include "StringIntern.h"  // v1.3.3: Interned device IDs
 
 class ConfigManager {
+ public:
+  // v1.3.3: Immutable config generations (replace the v2.3.8 shadow copies)
+  // Previous: Every CRUD write cleared and deep-copied the whole devices
+  // cache into a shadow document, and readDevice() read it under cacheMutex.
+  // New: Each write publishes a new generation with an atomic pointer swap.
+  // Unchanged devices are shared with the previous generation (only the
+  // edited device is copied). Readers hold a refcounted handle; a generation
+  // and its device documents stay alive until the last reader drops it.
+  // Documents are never modified after publication (treat as read-only).
+  using DeviceConfigHandle = std::shared_ptr<JsonDocument>;
+  struct DeviceConfigEntry {
+    InternedString deviceId;  // v1.3.3: Shared with the services (handle)
+    DeviceConfigHandle config;  // Device object as document root
+  };
+  struct DevicesGeneration {
+    uint32_t number = 0;
+    std::vector<DeviceConfigEntry> devices;  // Manifest order
+  };
+  using DevicesGenerationHandle = std::shared_ptr<const DevicesGeneration>;
+
  private:
-  static const char* DEVICES_FILE;
+  static const char* DEVICES_FILE;  // Legacy single file (migrated once)
   static const char* REGISTERS_FILE;
 
+  // v1.3.3: Per-device storage (replaces rewriting the whole devices.json)
+  // /devcfg/<device_id>.json holds one device object; /devcfg/manifest.json
+  // holds the device order and a commit counter. A device edit rewrites only
+  // its record plus the small manifest (written last = commit point).
+  static const char* DEVICE_RECORDS_DIR;
+  static const char* DEVICES_MANIFEST_FILE;
+  static const uint8_t MANIFEST_FORMAT = 1;
+
+  // v1.3.3: Binary snapshot of all device records (MessagePack + header),
+  // written after a load from the records and used instead of parsing them
+  // while its source size/CRC still match the manifest (every commit
+  // rewrites the manifest, so any edit makes the snapshot stale)
+  static const char* DEVICES_SNAPSHOT_FILE;
+  static const char* DEVICES_SNAPSHOT_TEMP_FILE;
+  static const uint32_t SNAPSHOT_MAGIC = 0x50414E53;  // "SNAP"
+  static const uint16_t SNAPSHOT_VERSION = 2;  // Bump on format changes
+  struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t arduinoJsonMajor;  // MessagePack written by this ArduinoJson
+    uint32_t sourceSize;        // Manifest size when written
+    uint32_t sourceCrc;         // Manifest CRC32 when written
+    uint32_t payloadSize;       // MessagePack bytes after the header
+    uint32_t payloadCrc;
+  };
+
   // Thread safety primitives
   SemaphoreHandle_t cacheMutex;
   SemaphoreHandle_t fileMutex;
 
-  // SHADOW COPY OPTIMIZATION (v2.3.8):
-  // Dual-buffer pattern for lock-free reads
-  // - Primary cache: Used for writes (protected by cacheMutex)
-  // - Shadow cache: Read-only copy for runtime access (minimal locking)
-  JsonDocument* devicesCache;          // Primary cache (write operations)
-  JsonDocument* devicesShadowCache;    // Shadow copy (read operations)
-  JsonDocument* registersCache;        // Primary cache (write operations)
-  JsonDocument* registersShadowCache;  // Shadow copy (read operations)
+  // Primary caches: used for writes (protected by cacheMutex)
+  // v1.3.3: Reads go through devicesGeneration (std::atomic_load/store only).
+  // The registers shadow copy was never read and is gone.
+  JsonDocument* devicesCache;    // Primary cache (write operations)
+  JsonDocument* registersCache;  // Primary cache (write operations)
+  DevicesGenerationHandle devicesGeneration;
 
   bool devicesCacheValid;
   bool registersCacheValid;
@@ -47,15 +96,40 @@ class ConfigManager {
 
   String generateId(const String& prefix);
   bool saveJson(const String& filename, const JsonDocument& doc);
-  bool loadJson(const String& filename, JsonDocument& doc);
+  // v1.3.3: filter = ArduinoJson DeserializationOption::Filter (null: all)
+  bool loadJson(const String& filename, JsonDocument& doc,
+                JsonVariantConst filter = JsonVariantConst());
+  // v1.3.3: Devices snapshot (caller must NOT hold fileMutex)
+  bool saveDevicesSnapshot(const JsonDocument& doc);
+  bool loadDevicesSnapshot(JsonDocument& doc,
+                           JsonVariantConst filter = JsonVariantConst());
+
+  // v1.3.3: Per-device storage
+  uint32_t manifestCommit = 0;      // Last committed manifest counter
+  uint8_t devicesBatchDepth = 0;    // > 0: persistDevice() only marks dirty
+  bool generationsDeferred = false;  // Batch publishes at commit
+  std::vector<PSRAMString> dirtyDeviceIds;  // Writers only (CRUD task)
+  static String deviceRecordPath(const char* deviceId);
+  bool openDevicesStore();  // Migrate devices.json, read manifest counter
+  // Manifest + records (deviceFilter applies to each record)
+  bool loadDeviceRecords(JsonDocument& doc,
+                         JsonVariantConst deviceFilter = JsonVariantConst());
+  bool saveDevicesStore(const JsonDocument& doc);  // Rewrite every record
+  bool writeDevicesManifest(JsonObjectConst devices);
+  // Persist one device from devicesCache (removed from cache = deleted).
+  // Coalesced until commitDevicesBatch() while a batch is open.
+  bool persistDevice(const String& deviceId);
+  bool commitDevices(const std::vector<PSRAMString>& deviceIds);
   void invalidateDevicesCache();
   void invalidateRegistersCache();
   bool loadDevicesCache();
   bool loadRegistersCache();
 
-  // Shadow copy management (v2.3.8)
-  void updateDevicesShadowCopy();
-  void updateRegistersShadowCopy();
+  // v1.3.3: Publish devicesCache as a new generation. changedDeviceId =
+  // only that device changed (copy-on-write), nullptr = rebuild all.
+  // Writers are serialized by the caller (CRUD task / cacheMutex).
+  void publishDevicesGeneration(const char* changedDeviceId = nullptr);
+  void dropDevicesGeneration();
 
   // Atomic file operations pointer
   AtomicFileOps* atomicFileOps = nullptr;
@@ -73,10 +147,38 @@ class ConfigManager {
   bool updateDevice(const String& deviceId, JsonObjectConst config);
   bool deleteDevice(const String& deviceId);
   void listDevices(JsonArray& devices);
+  // v1.3.3: Current generation (loads the cache if needed, may be null).
+  // Hold the handle for a whole refresh/cycle instead of copying devices.
+  DevicesGenerationHandle getDevicesGeneration();
+  // v1.3.3: Projection read - {device_id: device} with only the fields
+  // deviceFilter selects (ArduinoJson filter syntax, "*" = any key, applied
+  // to each device object). Copied from the current generation when cached,
+  // else a filtered parse of the snapshot / records (no full documents).
+  bool getDevicesProjection(JsonDocument& doc, JsonVariantConst deviceFilter);
   void getDevicesSummary(JsonArray& summary);
   void getAllDevicesWithRegisters(
       JsonArray& result,
       bool minimalFields = false);  // New: Get all devices with their registers
+  // v1.3.3: One entry of getAllDevicesWithRegisters() (device_id first,
+  // device fields, registers[]); used to stream backups device by device
+  static void copyDeviceWithRegisters(const char* deviceId,
+                                      JsonObjectConst device,
+                                      JsonObject deviceWithRegs,
+                                      bool minimalFields = false);
+
+  // v1.3.3: Write coalescing for bulk edits (CRUD atomic batches, restore).
+  // Device/register CRUD between begin and commit update the caches and
+  // generations as usual, but each touched device record is written once
+  // and the manifest once at commitDevicesBatch(). Batches nest; only the
+  // outermost commit writes. Returns false if any write failed (the cache is
+  // then reloaded from flash).
+  // deferGenerations (outermost batch): the touched devices are published
+  // once, after a successful commit, instead of after every change - the
+  // services never see a half-applied batch. abortDevicesBatch() drops such
+  // a batch unwritten (cache reloaded from flash, generation unchanged).
+  void beginDevicesBatch(bool deferGenerations = false);
+  bool commitDevicesBatch();
+  void abortDevicesBatch();
 
   // Clear all configurations
   void clearAllConfigurations();
@@ -99,4 +201,4 @@ class ConfigManager {
   bool deleteRegister(const String& deviceId, const String& registerId);
 };
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
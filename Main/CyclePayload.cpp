@@ -0,0 +1,202 @@
+#include "CyclePayload.h"
+
+#include <esp_heap_caps.h>
+
+#include "DebugConfig.h"
+
+using CyclePayloadConfig::FORMAT_COUNT;
+using CyclePayloadConfig::RETAINED_CYCLES;
+
+CyclePayloadStore::CyclePayloadStore()
+    : sequence(0), encodedCycles(0), encodeFailures(0) {
+  mutex = xSemaphoreCreateMutex();
+  memset(subscribers, 0, sizeof(subscribers));
+  memset(retained, 0, sizeof(retained));
+}
+
+CyclePayloadStore* CyclePayloadStore::getInstance() {
+  static CyclePayloadStore instance;
+  return &instance;
+}
+
+void CyclePayloadStore::subscribe(PayloadFormat format) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  subscribers[(uint8_t)format]++;
+  xSemaphoreGive(mutex);
+}
+
+void CyclePayloadStore::unsubscribe(PayloadFormat format) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint8_t index = (uint8_t)format;
+  if (subscribers[index] > 0 && --subscribers[index] == 0) {
+    // Last consumer of this format - its retained cycles are not needed
+    for (uint8_t slot = 0; slot < RETAINED_CYCLES; slot++) {
+      if (retained[index][slot]) {
+        releaseLocked(retained[index][slot]);
+        retained[index][slot] = nullptr;
+      }
+    }
+  }
+  xSemaphoreGive(mutex);
+}
+
+bool CyclePayloadStore::hasSubscribers() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool any = false;
+  for (uint8_t index = 0; index < FORMAT_COUNT; index++) {
+    any = any || subscribers[index] > 0;
+  }
+  xSemaphoreGive(mutex);
+  return any;
+}
+
+bool CyclePayloadStore::textOnly(PayloadFormat producerFormat) {
+  if (producerFormat != PayloadFormat::JSON) {
+    return false;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool text = subscribers[(uint8_t)PayloadFormat::MSGPACK] == 0 &&
+              subscribers[(uint8_t)PayloadFormat::CBOR] == 0;
+  xSemaphoreGive(mutex);
+  return text;
+}
+
+CyclePayload* CyclePayloadStore::encode(JsonVariantConst doc,
+                                        PayloadFormat format,
+                                        uint32_t cycle) {
+  size_t length = measurePayload(doc, format);
+  CyclePayload* payload = (CyclePayload*)heap_caps_malloc(
+      sizeof(CyclePayload) + length, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!payload) {
+    return nullptr;
+  }
+  payload->sequence = cycle;
+  payload->format = format;
+  payload->refs = 0;
+  payload->length = serializePayload(doc, format, (uint8_t*)(payload + 1),
+                                     length);
+  if (payload->length != length) {
+    heap_caps_free(payload);
+    return nullptr;
+  }
+  return payload;
+}
+
+CyclePayload* CyclePayloadStore::publish(JsonVariantConst doc,
+                                         PayloadFormat producerFormat) {
+  // Encoding runs without the mutex (consumers keep sending meanwhile);
+  // only the publish task calls publish()
+  bool wanted[FORMAT_COUNT];
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t cycle = sequence + 1;
+  for (uint8_t index = 0; index < FORMAT_COUNT; index++) {
+    wanted[index] = subscribers[index] > 0;
+  }
+  xSemaphoreGive(mutex);
+  wanted[(uint8_t)producerFormat] = true;
+
+  CyclePayload* encoded[FORMAT_COUNT] = {};
+  for (uint8_t index = 0; index < FORMAT_COUNT; index++) {
+    if (!wanted[index]) {
+      continue;
+    }
+    encoded[index] = encode(doc, (PayloadFormat)index, cycle);
+    if (!encoded[index]) {
+      encodeFailures++;
+      LOG_MQTT_ERROR("Cycle payload allocation failed (%s)",
+                     payloadFormatName((PayloadFormat)index));
+    }
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  sequence = cycle;
+  encodedCycles++;
+  uint8_t slot = cycle % RETAINED_CYCLES;
+  for (uint8_t index = 0; index < FORMAT_COUNT; index++) {
+    CyclePayload* payload = encoded[index];
+    if (!payload) {
+      continue;
+    }
+    bool own = index == (uint8_t)producerFormat;
+    bool keep = subscribers[index] > 0;  // May have changed while encoding
+    payload->refs = (own ? 1 : 0) + (keep ? 1 : 0);
+    if (keep) {
+      // Overwrites the oldest cycle (a consumer still sending it holds a ref)
+      if (retained[index][slot]) {
+        releaseLocked(retained[index][slot]);
+      }
+      retained[index][slot] = payload;
+    } else if (!own) {
+      heap_caps_free(payload);
+    }
+  }
+  xSemaphoreGive(mutex);
+
+  return encoded[(uint8_t)producerFormat];
+}
+
+CyclePayload* CyclePayloadStore::next(uint32_t afterSequence,
+                                      PayloadFormat format,
+                                      uint32_t& skipped) {
+  skipped = 0;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  CyclePayload* found = nullptr;
+  for (uint8_t slot = 0; slot < RETAINED_CYCLES; slot++) {
+    CyclePayload* payload = retained[(uint8_t)format][slot];
+    if (payload && payload->sequence > afterSequence &&
+        (!found || payload->sequence < found->sequence)) {
+      found = payload;
+    }
+  }
+  if (found) {
+    found->refs++;
+    skipped = found->sequence - afterSequence - 1;
+  }
+  xSemaphoreGive(mutex);
+  return found;
+}
+
+void CyclePayloadStore::release(CyclePayload* payload) {
+  if (!payload) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  releaseLocked(payload);
+  xSemaphoreGive(mutex);
+}
+
+void CyclePayloadStore::releaseLocked(CyclePayload* payload) {
+  if (payload->refs > 0) {
+    payload->refs--;
+  }
+  if (payload->refs == 0) {
+    heap_caps_free(payload);
+  }
+}
+
+uint32_t CyclePayloadStore::latestSequence() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t latest = sequence;
+  xSemaphoreGive(mutex);
+  return latest;
+}
+
+void CyclePayloadStore::getStatus(JsonObject& status) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  status["sequence"] = sequence;
+  status["encoded_cycles"] = encodedCycles;
+  status["encode_failures"] = encodeFailures;
+  size_t retainedBytes = 0;
+  uint8_t retainedCount = 0;
+  for (uint8_t index = 0; index < FORMAT_COUNT; index++) {
+    for (uint8_t slot = 0; slot < RETAINED_CYCLES; slot++) {
+      if (retained[index][slot]) {
+        retainedBytes += retained[index][slot]->length;
+        retainedCount++;
+      }
+    }
+  }
+  status["retained"] = retainedCount;
+  status["retained_bytes"] = retainedBytes;
+  xSemaphoreGive(mutex);
+}
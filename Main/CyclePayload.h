@@ -0,0 +1,104 @@
+#ifndef CYCLE_PAYLOAD_H
+#define CYCLE_PAYLOAD_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <cstdint>
+
+#include "PayloadFormat.h"
+
+/**
+ * CyclePayload - Default-mode cycle payloads shared by MQTT and HTTP
+ *
+ * v1.3.3: Shared encode stage
+ * Previous: every transport built and serialized its own body from the same
+ * readings - MQTT encoded the default-mode "devices" document, HTTP
+ * expanded the data queue into another document and encoded that again.
+ * New: with http_config.layout "cycle" the MQTT publish task encodes its
+ * default-mode document once per format (MQTT's payload_format plus every
+ * subscribed HTTP format) into one PSRAM block each. MQTT copies its block
+ * into the outbound message, HTTP sends the retained block as-is. Each
+ * consumer keeps its own cursor (sequence), so a slow or offline HTTP
+ * endpoint catches up on the RETAINED_CYCLES newest cycles without holding
+ * back MQTT.
+ *
+ * Blocks are reference counted under the store mutex (they live in PSRAM,
+ * where atomic read-modify-write is not available). Nothing is retained
+ * while no consumer is subscribed.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace CyclePayloadConfig {
+constexpr uint8_t RETAINED_CYCLES = 8;  // Per format, for lagging consumers
+constexpr uint8_t FORMAT_COUNT = 3;     // PayloadFormat values
+}  // namespace CyclePayloadConfig
+
+// One encoded cycle; the payload bytes follow the header in the same block
+struct CyclePayload {
+  uint32_t sequence;  // Cycle number (1, 2, ...), same for every format
+  PayloadFormat format;
+  size_t length;
+  uint16_t refs;  // Store mutex only (PSRAM block)
+
+  const uint8_t* data() const {
+    return reinterpret_cast<const uint8_t*>(this + 1);
+  }
+};
+
+class CyclePayloadStore {
+ public:
+  static CyclePayloadStore* getInstance();
+
+  // Consumer (HTTP "cycle" layout): request cycles encoded in format
+  void subscribe(PayloadFormat format);
+  void unsubscribe(PayloadFormat format);
+  bool hasSubscribers();
+
+  // True if every format the producer encodes this cycle is JSON text
+  // (fixed-decimal register values, NumberFormat)
+  bool textOnly(PayloadFormat producerFormat);
+
+  /**
+   * Producer (MQTT default mode): encode doc once per format - the
+   * producer's own and each subscribed one - and retain the subscribed ones
+   * @return The producer's payload (release() it), nullptr if out of memory
+   */
+  CyclePayload* publish(JsonVariantConst doc, PayloadFormat producerFormat);
+
+  /**
+   * Oldest retained cycle after afterSequence in format
+   * @param skipped Output: cycles after afterSequence no longer retained
+   * @return Acquired payload (release() it), nullptr if none is newer
+   */
+  CyclePayload* next(uint32_t afterSequence, PayloadFormat format,
+                     uint32_t& skipped);
+  void release(CyclePayload* payload);
+
+  uint32_t latestSequence();
+  void getStatus(JsonObject& status);
+
+ private:
+  CyclePayloadStore();
+  CyclePayloadStore(const CyclePayloadStore&) = delete;
+  CyclePayloadStore& operator=(const CyclePayloadStore&) = delete;
+
+  CyclePayload* encode(JsonVariantConst doc, PayloadFormat format,
+                       uint32_t sequence);
+  void releaseLocked(CyclePayload* payload);
+
+  SemaphoreHandle_t mutex;
+  uint8_t subscribers[CyclePayloadConfig::FORMAT_COUNT];
+  // Ring per format, slot = sequence % RETAINED_CYCLES
+  CyclePayload* retained[CyclePayloadConfig::FORMAT_COUNT]
+                        [CyclePayloadConfig::RETAINED_CYCLES];
+  uint32_t sequence;       // Last published cycle
+  uint32_t encodedCycles;  // Cycles encoded for subscribers
+  uint32_t encodeFailures;
+};
+
+#endif  // CYCLE_PAYLOAD_H
@@ -83,8 +83,16 @@ void printLogLevelStatus() {
   Serial.println("    5 = VERBOSE (all logs)");
 
   Serial.println("\n  Change level: setLogLevel(LOG_INFO)");
-  Serial.printf("  Timestamps: %s\n\n",
+  Serial.printf("  Timestamps: %s\n",
                 logTimestampsEnabled ? "ENABLED" : "DISABLED");
+
+  // v1.3.3: Async log sink (LOG_* macros)
+  LogSink* sink = LogSink::getInstance();
+  Serial.printf("  Log Sink: %s (written: %lu, dropped: %lu, peak: %u/%u)\n\n",
+                sink->isRunning() ? "ASYNC" : "SYNC",
+                (unsigned long)sink->getWrittenCount(),
+                (unsigned long)sink->getDroppedCount(), sink->getHighWater(),
+                LogSink::SLOT_COUNT);
 }
 
 // ============================================
@@ -93,7 +101,11 @@ void printLogLevelStatus() {
 
 const char* getLogTimestamp() {
   static char timestamp[22];  // "[YYYY-MM-DD HH:MM:SS] " = 21 chars + null
+  formatLogTimestamp(timestamp, sizeof(timestamp), millis());
+  return timestamp;
+}
 
+void formatLogTimestamp(char* out, size_t size, uint32_t capturedMs) {
   RTCManager* rtc = RTCManager::getInstance();
 
   if (rtc) {
@@ -102,19 +114,21 @@ const char* getLogTimestamp() {
 
     // Check if time is valid (year > 2020 indicates RTC is synced)
     if (now.year() >= 2020) {
+      // v1.3.3: Queued lines are formatted later - step back by their age
+      uint32_t ageSec = (millis() - capturedMs) / 1000;
+      if (ageSec > 0) {
+        now = DateTime(now.unixtime() - ageSec);
+      }
       // RTC available and synced - use real time
-      snprintf(timestamp, sizeof(timestamp), "[%04d-%02d-%02d %02d:%02d:%02d]",
-               now.year(), now.month(), now.day(), now.hour(), now.minute(),
+      snprintf(out, size, "[%04d-%02d-%02d %02d:%02d:%02d]", now.year(),
+               now.month(), now.day(), now.hour(), now.minute(),
                now.second());
-      return timestamp;
+      return;
     }
   }
 
   // RTC not available or not synced - use uptime (seconds since boot)
-  unsigned long uptimeSec = millis() / 1000;
-  snprintf(timestamp, sizeof(timestamp), "[%010lu]", uptimeSec);
-
-  return timestamp;
+  snprintf(out, size, "[%010lu]", (unsigned long)(capturedMs / 1000));
 }
 
 void setLogTimestamps(bool enabled) {
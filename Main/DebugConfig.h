@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 
+#include "LogSink.h"  // v1.3.3: Deferred LOG_* output
+
 // ============================================
 // PRODUCTION MODE DEFINITION
 // ============================================
@@ -105,6 +107,9 @@ extern LogLevel currentLogLevel;
  */
 const char* getLogTimestamp();
 
+// v1.3.3: Timestamp of a queued line (LogSink), from the millis() of its call
+void formatLogTimestamp(char* out, size_t size, uint32_t capturedMs);
+
 // Enable/disable timestamps in logs (default: enabled)
 extern bool logTimestampsEnabled;
 void setLogTimestamps(bool enabled);
@@ -141,36 +146,6 @@ void printLogLevelStatus();
 // Only ERROR and WARN levels in production
 #define LOG_CHECK(level) (currentLogLevel >= level && level <= LOG_WARN)
 
-// Generic log macros (production - ERROR/WARN only) with timestamps
-#define LOG_ERROR_F(prefix, fmt, ...)                                \
-  do {                                                               \
-    if (LOG_CHECK(LOG_ERROR) && logTimestampsEnabled)                \
-      Serial.printf("%s[ERROR][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                  \
-    else if (LOG_CHECK(LOG_ERROR))                                   \
-      Serial.printf("[ERROR][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
-
-#define LOG_WARN_F(prefix, fmt, ...)                                \
-  do {                                                              \
-    if (LOG_CHECK(LOG_WARN) && logTimestampsEnabled)                \
-      Serial.printf("%s[WARN][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                 \
-    else if (LOG_CHECK(LOG_WARN))                                   \
-      Serial.printf("[WARN][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
-
-// INFO, DEBUG, VERBOSE disabled in production (compile out)
-#define LOG_INFO_F(prefix, fmt, ...) \
-  do {                               \
-  } while (0)
-#define LOG_DEBUG_F(prefix, fmt, ...) \
-  do {                                \
-  } while (0)
-#define LOG_VERBOSE_F(prefix, fmt, ...) \
-  do {                                  \
-  } while (0)
-
 #else
 // ==========================================
 // DEVELOPMENT MODE - Full logging
@@ -180,138 +155,236 @@ void printLogLevelStatus();
 #define LOG_CHECK(level) \
   (currentLogLevel >= level && COMPILE_LOG_LEVEL >= level)
 
-// Generic log macros (development - all levels) with timestamps
-#define LOG_ERROR_F(prefix, fmt, ...)                                \
-  do {                                                               \
-    if (LOG_CHECK(LOG_ERROR) && logTimestampsEnabled)                \
-      Serial.printf("%s[ERROR][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                  \
-    else if (LOG_CHECK(LOG_ERROR))                                   \
-      Serial.printf("[ERROR][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
-
-#define LOG_WARN_F(prefix, fmt, ...)                                \
-  do {                                                              \
-    if (LOG_CHECK(LOG_WARN) && logTimestampsEnabled)                \
-      Serial.printf("%s[WARN][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                 \
-    else if (LOG_CHECK(LOG_WARN))                                   \
-      Serial.printf("[WARN][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
+#endif
 
-#define LOG_INFO_F(prefix, fmt, ...)                                \
-  do {                                                              \
-    if (LOG_CHECK(LOG_INFO) && logTimestampsEnabled)                \
-      Serial.printf("%s[INFO][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                 \
-    else if (LOG_CHECK(LOG_INFO))                                   \
-      Serial.printf("[INFO][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
+// ============================================
+// PER-MODULE COMPILE-TIME LOG LEVELS (v1.3.3)
+// ============================================
+// Previous: only COMPILE_LOG_LEVEL (one threshold) was compile-time, every
+// other log decision was a runtime check in the calling code.
+// New: each LOG_<MODULE>_* family has its own threshold. Override with a
+// build flag, e.g. -DLOG_LEVEL_RTU=LOG_WARN (defaults to COMPILE_LOG_LEVEL,
+// never above it). A statement below its module threshold is a constant
+// false branch: the compiler drops it together with its argument
+// evaluation. logCompiled() is also used to compile out log-only work
+// (e.g. the RTU/TCP compact data line and polled-data JSON).
+#ifndef LOG_LEVEL_RTU
+#define LOG_LEVEL_RTU COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_TCP
+#define LOG_LEVEL_TCP COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_MQTT
+#define LOG_LEVEL_MQTT COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_HTTP
+#define LOG_LEVEL_HTTP COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_BLE
+#define LOG_LEVEL_BLE COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_CONFIG
+#define LOG_LEVEL_CONFIG COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_NET
+#define LOG_LEVEL_NET COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_MEM
+#define LOG_LEVEL_MEM COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_QUEUE
+#define LOG_LEVEL_QUEUE COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_DATA
+#define LOG_LEVEL_DATA COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LED
+#define LOG_LEVEL_LED COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_CRUD
+#define LOG_LEVEL_CRUD COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_RTC
+#define LOG_LEVEL_RTC COMPILE_LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_SD
+#define LOG_LEVEL_SD COMPILE_LOG_LEVEL
+#endif
 
-#define LOG_DEBUG_F(prefix, fmt, ...)                                \
-  do {                                                               \
-    if (LOG_CHECK(LOG_DEBUG) && logTimestampsEnabled)                \
-      Serial.printf("%s[DEBUG][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                  \
-    else if (LOG_CHECK(LOG_DEBUG))                                   \
-      Serial.printf("[DEBUG][%s] " fmt, prefix, ##__VA_ARGS__);      \
-  } while (0)
+// True if a statement of this level is compiled in for the module
+constexpr bool logCompiled(uint8_t moduleLevel, uint8_t level) {
+  return moduleLevel >= level && COMPILE_LOG_LEVEL >= level;
+}
 
-#define LOG_VERBOSE_F(prefix, fmt, ...)                                \
-  do {                                                                 \
-    if (LOG_CHECK(LOG_VERBOSE) && logTimestampsEnabled)                \
-      Serial.printf("%s[VERBOSE][%s] " fmt, getLogTimestamp(), prefix, \
-                    ##__VA_ARGS__);                                    \
-    else if (LOG_CHECK(LOG_VERBOSE))                                   \
-      Serial.printf("[VERBOSE][%s] " fmt, prefix, ##__VA_ARGS__);      \
+// Compile-time module threshold, then runtime level (v1.3.3: queued to
+// LogSink, formatted and written by its drain task)
+#define LOG_MODULE_F(moduleLevel, level, prefix, fmt, ...)   \
+  do {                                                       \
+    if (logCompiled(moduleLevel, level) && LOG_CHECK(level)) \
+      LOG_SINK_WRITE(level, prefix, fmt, ##__VA_ARGS__);     \
   } while (0)
 
-#endif
+// Generic log macros (production: ERROR/WARN only) with timestamps
+#define LOG_ERROR_F(prefix, fmt, ...) \
+  LOG_MODULE_F(COMPILE_LOG_LEVEL, LOG_ERROR, prefix, fmt, ##__VA_ARGS__)
+#define LOG_WARN_F(prefix, fmt, ...) \
+  LOG_MODULE_F(COMPILE_LOG_LEVEL, LOG_WARN, prefix, fmt, ##__VA_ARGS__)
+#define LOG_INFO_F(prefix, fmt, ...) \
+  LOG_MODULE_F(COMPILE_LOG_LEVEL, LOG_INFO, prefix, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG_F(prefix, fmt, ...) \
+  LOG_MODULE_F(COMPILE_LOG_LEVEL, LOG_DEBUG, prefix, fmt, ##__VA_ARGS__)
+#define LOG_VERBOSE_F(prefix, fmt, ...) \
+  LOG_MODULE_F(COMPILE_LOG_LEVEL, LOG_VERBOSE, prefix, fmt, ##__VA_ARGS__)
 
 // ============================================
 // MODULE-SPECIFIC LOG MACROS
 // ============================================
 
 // --- MODBUS RTU ---
-#define LOG_RTU_ERROR(fmt, ...) LOG_ERROR_F("RTU", fmt, ##__VA_ARGS__)
-#define LOG_RTU_WARN(fmt, ...) LOG_WARN_F("RTU", fmt, ##__VA_ARGS__)
-#define LOG_RTU_INFO(fmt, ...) LOG_INFO_F("RTU", fmt, ##__VA_ARGS__)
-#define LOG_RTU_DEBUG(fmt, ...) LOG_DEBUG_F("RTU", fmt, ##__VA_ARGS__)
-#define LOG_RTU_VERBOSE(fmt, ...) LOG_VERBOSE_F("RTU", fmt, ##__VA_ARGS__)
+#define LOG_RTU_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTU, LOG_ERROR, "RTU", fmt, ##__VA_ARGS__)
+#define LOG_RTU_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTU, LOG_WARN, "RTU", fmt, ##__VA_ARGS__)
+#define LOG_RTU_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTU, LOG_INFO, "RTU", fmt, ##__VA_ARGS__)
+#define LOG_RTU_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTU, LOG_DEBUG, "RTU", fmt, ##__VA_ARGS__)
+#define LOG_RTU_VERBOSE(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTU, LOG_VERBOSE, "RTU", fmt, ##__VA_ARGS__)
 
 // --- MODBUS TCP ---
-#define LOG_TCP_ERROR(fmt, ...) LOG_ERROR_F("TCP", fmt, ##__VA_ARGS__)
-#define LOG_TCP_WARN(fmt, ...) LOG_WARN_F("TCP", fmt, ##__VA_ARGS__)
-#define LOG_TCP_INFO(fmt, ...) LOG_INFO_F("TCP", fmt, ##__VA_ARGS__)
-#define LOG_TCP_DEBUG(fmt, ...) LOG_DEBUG_F("TCP", fmt, ##__VA_ARGS__)
-#define LOG_TCP_VERBOSE(fmt, ...) LOG_VERBOSE_F("TCP", fmt, ##__VA_ARGS__)
+#define LOG_TCP_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_TCP, LOG_ERROR, "TCP", fmt, ##__VA_ARGS__)
+#define LOG_TCP_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_TCP, LOG_WARN, "TCP", fmt, ##__VA_ARGS__)
+#define LOG_TCP_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_TCP, LOG_INFO, "TCP", fmt, ##__VA_ARGS__)
+#define LOG_TCP_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_TCP, LOG_DEBUG, "TCP", fmt, ##__VA_ARGS__)
+#define LOG_TCP_VERBOSE(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_TCP, LOG_VERBOSE, "TCP", fmt, ##__VA_ARGS__)
 
 // --- MQTT ---
-#define LOG_MQTT_ERROR(fmt, ...) LOG_ERROR_F("MQTT", fmt, ##__VA_ARGS__)
-#define LOG_MQTT_WARN(fmt, ...) LOG_WARN_F("MQTT", fmt, ##__VA_ARGS__)
-#define LOG_MQTT_INFO(fmt, ...) LOG_INFO_F("MQTT", fmt, ##__VA_ARGS__)
-#define LOG_MQTT_DEBUG(fmt, ...) LOG_DEBUG_F("MQTT", fmt, ##__VA_ARGS__)
-#define LOG_MQTT_VERBOSE(fmt, ...) LOG_VERBOSE_F("MQTT", fmt, ##__VA_ARGS__)
+#define LOG_MQTT_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MQTT, LOG_ERROR, "MQTT", fmt, ##__VA_ARGS__)
+#define LOG_MQTT_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MQTT, LOG_WARN, "MQTT", fmt, ##__VA_ARGS__)
+#define LOG_MQTT_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MQTT, LOG_INFO, "MQTT", fmt, ##__VA_ARGS__)
+#define LOG_MQTT_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MQTT, LOG_DEBUG, "MQTT", fmt, ##__VA_ARGS__)
+#define LOG_MQTT_VERBOSE(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MQTT, LOG_VERBOSE, "MQTT", fmt, ##__VA_ARGS__)
 
 // --- HTTP ---
-#define LOG_HTTP_ERROR(fmt, ...) LOG_ERROR_F("HTTP", fmt, ##__VA_ARGS__)
-#define LOG_HTTP_WARN(fmt, ...) LOG_WARN_F("HTTP", fmt, ##__VA_ARGS__)
-#define LOG_HTTP_INFO(fmt, ...) LOG_INFO_F("HTTP", fmt, ##__VA_ARGS__)
-#define LOG_HTTP_DEBUG(fmt, ...) LOG_DEBUG_F("HTTP", fmt, ##__VA_ARGS__)
+#define LOG_HTTP_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_HTTP, LOG_ERROR, "HTTP", fmt, ##__VA_ARGS__)
+#define LOG_HTTP_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_HTTP, LOG_WARN, "HTTP", fmt, ##__VA_ARGS__)
+#define LOG_HTTP_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_HTTP, LOG_INFO, "HTTP", fmt, ##__VA_ARGS__)
+#define LOG_HTTP_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_HTTP, LOG_DEBUG, "HTTP", fmt, ##__VA_ARGS__)
 
 // --- BLE ---
-#define LOG_BLE_ERROR(fmt, ...) LOG_ERROR_F("BLE", fmt, ##__VA_ARGS__)
-#define LOG_BLE_WARN(fmt, ...) LOG_WARN_F("BLE", fmt, ##__VA_ARGS__)
-#define LOG_BLE_INFO(fmt, ...) LOG_INFO_F("BLE", fmt, ##__VA_ARGS__)
-#define LOG_BLE_DEBUG(fmt, ...) LOG_DEBUG_F("BLE", fmt, ##__VA_ARGS__)
+#define LOG_BLE_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_BLE, LOG_ERROR, "BLE", fmt, ##__VA_ARGS__)
+#define LOG_BLE_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_BLE, LOG_WARN, "BLE", fmt, ##__VA_ARGS__)
+#define LOG_BLE_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_BLE, LOG_INFO, "BLE", fmt, ##__VA_ARGS__)
+#define LOG_BLE_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_BLE, LOG_DEBUG, "BLE", fmt, ##__VA_ARGS__)
 
 // --- CONFIG MANAGER ---
-#define LOG_CONFIG_ERROR(fmt, ...) LOG_ERROR_F("CONFIG", fmt, ##__VA_ARGS__)
-#define LOG_CONFIG_WARN(fmt, ...) LOG_WARN_F("CONFIG", fmt, ##__VA_ARGS__)
-#define LOG_CONFIG_INFO(fmt, ...) LOG_INFO_F("CONFIG", fmt, ##__VA_ARGS__)
-#define LOG_CONFIG_DEBUG(fmt, ...) LOG_DEBUG_F("CONFIG", fmt, ##__VA_ARGS__)
+#define LOG_CONFIG_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CONFIG, LOG_ERROR, "CONFIG", fmt, ##__VA_ARGS__)
+#define LOG_CONFIG_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CONFIG, LOG_WARN, "CONFIG", fmt, ##__VA_ARGS__)
+#define LOG_CONFIG_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CONFIG, LOG_INFO, "CONFIG", fmt, ##__VA_ARGS__)
+#define LOG_CONFIG_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CONFIG, LOG_DEBUG, "CONFIG", fmt, ##__VA_ARGS__)
 
 // --- NETWORK MANAGER ---
-#define LOG_NET_ERROR(fmt, ...) LOG_ERROR_F("NET", fmt, ##__VA_ARGS__)
-#define LOG_NET_WARN(fmt, ...) LOG_WARN_F("NET", fmt, ##__VA_ARGS__)
-#define LOG_NET_INFO(fmt, ...) LOG_INFO_F("NET", fmt, ##__VA_ARGS__)
-#define LOG_NET_DEBUG(fmt, ...) LOG_DEBUG_F("NET", fmt, ##__VA_ARGS__)
+#define LOG_NET_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_NET, LOG_ERROR, "NET", fmt, ##__VA_ARGS__)
+#define LOG_NET_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_NET, LOG_WARN, "NET", fmt, ##__VA_ARGS__)
+#define LOG_NET_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_NET, LOG_INFO, "NET", fmt, ##__VA_ARGS__)
+#define LOG_NET_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_NET, LOG_DEBUG, "NET", fmt, ##__VA_ARGS__)
 
 // --- MEMORY MANAGER ---
-#define LOG_MEM_ERROR(fmt, ...) LOG_ERROR_F("MEM", fmt, ##__VA_ARGS__)
-#define LOG_MEM_WARN(fmt, ...) LOG_WARN_F("MEM", fmt, ##__VA_ARGS__)
-#define LOG_MEM_INFO(fmt, ...) LOG_INFO_F("MEM", fmt, ##__VA_ARGS__)
-#define LOG_MEM_DEBUG(fmt, ...) LOG_DEBUG_F("MEM", fmt, ##__VA_ARGS__)
+#define LOG_MEM_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MEM, LOG_ERROR, "MEM", fmt, ##__VA_ARGS__)
+#define LOG_MEM_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MEM, LOG_WARN, "MEM", fmt, ##__VA_ARGS__)
+#define LOG_MEM_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MEM, LOG_INFO, "MEM", fmt, ##__VA_ARGS__)
+#define LOG_MEM_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_MEM, LOG_DEBUG, "MEM", fmt, ##__VA_ARGS__)
 
 // --- QUEUE MANAGER ---
-#define LOG_QUEUE_ERROR(fmt, ...) LOG_ERROR_F("QUEUE", fmt, ##__VA_ARGS__)
-#define LOG_QUEUE_WARN(fmt, ...) LOG_WARN_F("QUEUE", fmt, ##__VA_ARGS__)
-#define LOG_QUEUE_INFO(fmt, ...) LOG_INFO_F("QUEUE", fmt, ##__VA_ARGS__)
-#define LOG_QUEUE_DEBUG(fmt, ...) LOG_DEBUG_F("QUEUE", fmt, ##__VA_ARGS__)
+#define LOG_QUEUE_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_QUEUE, LOG_ERROR, "QUEUE", fmt, ##__VA_ARGS__)
+#define LOG_QUEUE_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_QUEUE, LOG_WARN, "QUEUE", fmt, ##__VA_ARGS__)
+#define LOG_QUEUE_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_QUEUE, LOG_INFO, "QUEUE", fmt, ##__VA_ARGS__)
+#define LOG_QUEUE_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_QUEUE, LOG_DEBUG, "QUEUE", fmt, ##__VA_ARGS__)
 
 // --- DATA / TELEMETRY ---
-#define LOG_DATA_ERROR(fmt, ...) LOG_ERROR_F("DATA", fmt, ##__VA_ARGS__)
-#define LOG_DATA_WARN(fmt, ...) LOG_WARN_F("DATA", fmt, ##__VA_ARGS__)
-#define LOG_DATA_INFO(fmt, ...) LOG_INFO_F("DATA", fmt, ##__VA_ARGS__)
-#define LOG_DATA_DEBUG(fmt, ...) LOG_DEBUG_F("DATA", fmt, ##__VA_ARGS__)
+#define LOG_DATA_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_DATA, LOG_ERROR, "DATA", fmt, ##__VA_ARGS__)
+#define LOG_DATA_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_DATA, LOG_WARN, "DATA", fmt, ##__VA_ARGS__)
+#define LOG_DATA_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_DATA, LOG_INFO, "DATA", fmt, ##__VA_ARGS__)
+#define LOG_DATA_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_DATA, LOG_DEBUG, "DATA", fmt, ##__VA_ARGS__)
 
 // --- LED MANAGER ---
-#define LOG_LED_ERROR(fmt, ...) LOG_ERROR_F("LED", fmt, ##__VA_ARGS__)
-#define LOG_LED_WARN(fmt, ...) LOG_WARN_F("LED", fmt, ##__VA_ARGS__)
-#define LOG_LED_INFO(fmt, ...) LOG_INFO_F("LED", fmt, ##__VA_ARGS__)
-#define LOG_LED_DEBUG(fmt, ...) LOG_DEBUG_F("LED", fmt, ##__VA_ARGS__)
+#define LOG_LED_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_LED, LOG_ERROR, "LED", fmt, ##__VA_ARGS__)
+#define LOG_LED_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_LED, LOG_WARN, "LED", fmt, ##__VA_ARGS__)
+#define LOG_LED_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_LED, LOG_INFO, "LED", fmt, ##__VA_ARGS__)
+#define LOG_LED_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_LED, LOG_DEBUG, "LED", fmt, ##__VA_ARGS__)
 
 // --- CRUD HANDLER ---
-#define LOG_CRUD_ERROR(fmt, ...) LOG_ERROR_F("CRUD", fmt, ##__VA_ARGS__)
-#define LOG_CRUD_WARN(fmt, ...) LOG_WARN_F("CRUD", fmt, ##__VA_ARGS__)
-#define LOG_CRUD_INFO(fmt, ...) LOG_INFO_F("CRUD", fmt, ##__VA_ARGS__)
-#define LOG_CRUD_DEBUG(fmt, ...) LOG_DEBUG_F("CRUD", fmt, ##__VA_ARGS__)
+#define LOG_CRUD_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CRUD, LOG_ERROR, "CRUD", fmt, ##__VA_ARGS__)
+#define LOG_CRUD_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CRUD, LOG_WARN, "CRUD", fmt, ##__VA_ARGS__)
+#define LOG_CRUD_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CRUD, LOG_INFO, "CRUD", fmt, ##__VA_ARGS__)
+#define LOG_CRUD_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_CRUD, LOG_DEBUG, "CRUD", fmt, ##__VA_ARGS__)
 
 // --- RTC MANAGER ---
-#define LOG_RTC_ERROR(fmt, ...) LOG_ERROR_F("RTC", fmt, ##__VA_ARGS__)
-#define LOG_RTC_WARN(fmt, ...) LOG_WARN_F("RTC", fmt, ##__VA_ARGS__)
-#define LOG_RTC_INFO(fmt, ...) LOG_INFO_F("RTC", fmt, ##__VA_ARGS__)
-#define LOG_RTC_DEBUG(fmt, ...) LOG_DEBUG_F("RTC", fmt, ##__VA_ARGS__)
+#define LOG_RTC_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTC, LOG_ERROR, "RTC", fmt, ##__VA_ARGS__)
+#define LOG_RTC_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTC, LOG_WARN, "RTC", fmt, ##__VA_ARGS__)
+#define LOG_RTC_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTC, LOG_INFO, "RTC", fmt, ##__VA_ARGS__)
+#define LOG_RTC_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_RTC, LOG_DEBUG, "RTC", fmt, ##__VA_ARGS__)
+
+// --- SD CARD (v1.3.3) ---
+#define LOG_SD_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_SD, LOG_ERROR, "SD", fmt, ##__VA_ARGS__)
+#define LOG_SD_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_SD, LOG_WARN, "SD", fmt, ##__VA_ARGS__)
+#define LOG_SD_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_SD, LOG_INFO, "SD", fmt, ##__VA_ARGS__)
+#define LOG_SD_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_SD, LOG_DEBUG, "SD", fmt, ##__VA_ARGS__)
 
 // ============================================
 // THROTTLED LOGGING (prevent log spam)
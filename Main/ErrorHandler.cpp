@@ -1,13 +1,42 @@
 #include "ErrorHandler.h"
 
+#include <esp_heap_caps.h>
+
 // Singleton instance
 ErrorHandler* ErrorHandler::instance = nullptr;
 
+// FNV-1a over code + deviceId (coalescing key)
+static uint32_t errorKey(UnifiedErrorCode code, const char* deviceId) {
+  uint32_t hash = 2166136261UL ^ (uint32_t)code;
+  hash *= 16777619UL;
+  for (const char* c = deviceId; *c; c++) {
+    hash ^= (uint8_t)*c;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
 // Constructor
 ErrorHandler::ErrorHandler() {
+  for (auto& count : severityCounts) count.store(0);
+  for (auto& count : domainCounts) count.store(0);
+
+  // v1.3.3: Preallocate the history ring (no allocation when reporting)
+  history = (HistorySlot*)heap_caps_calloc(
+      HISTORY_CAPACITY, sizeof(HistorySlot),
+      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (history == nullptr) {
+    history = (HistorySlot*)heap_caps_calloc(HISTORY_CAPACITY,
+                                             sizeof(HistorySlot),
+                                             MALLOC_CAP_8BIT);
+  }
+  if (history == nullptr) {
+    Serial.println("[ERROR_HANDLER] History allocation failed (counters only)");
+  }
+
   lastResetTime = millis();
-  hourStartTime = millis();
-  dayStartTime = millis();
+  hourStartTime.store(millis());
+  dayStartTime.store(millis());
   Serial.println(
       "[ERROR_HANDLER] Initialized - Unified error code system ready");
 }
@@ -21,67 +50,138 @@ ErrorHandler* ErrorHandler::getInstance() {
 }
 
 // Core error reporting
+// v1.3.3: All overloads go straight to record() - no ErrorContext (and its
+// String copies) unless a callback needs one
 void ErrorHandler::reportError(UnifiedErrorCode code,
                                const String& description) {
-  ErrorContext context;
-  context.code = code;
-  context.description = description;
-  context.domain = getErrorDomain(code);
-  context.severity = getDefaultSeverity(code);
-  reportError(context);
+  record(code, getDefaultSeverity(code), getErrorDomain(code), "", 0, 0,
+         description.c_str());
 }
 
 void ErrorHandler::reportError(const ErrorContext& context) {
-  if (!enabled) return;
-
-  ErrorContext enrichedContext = enrichErrorContext(context);
-
-  // Update statistics
-  updateStatistics(enrichedContext);
-
-  // Add to history
-  if (errorHistory.size() >= maxHistorySize) {
-    errorHistory.pop_back();
-  }
-  errorHistory.push_front(enrichedContext);
-
-  // Log to Serial if enabled
-  if (logToSerial && enrichedContext.severity >= minSeverityToLog) {
-    printErrorWithRecovery(enrichedContext);
+  ErrorDomain domain = context.domain;
+  if (domain == DOMAIN_SYSTEM) {
+    domain = getErrorDomain(context.code);
   }
-
-  // Call registered callbacks
-  for (const auto& callback : errorCallbacks) {
-    callback(enrichedContext);
+  ErrorSeverity severity = context.severity;
+  if (severity == SEVERITY_INFO) {
+    severity = getDefaultSeverity(context.code);
   }
-
-  // Update timers
-  updateTimers();
-
-  // Maintain history
-  maintainHistory();
+  record(context.code, severity, domain, context.deviceId.c_str(),
+         context.detailValue1, context.detailValue2,
+         context.description.c_str());
 }
 
 void ErrorHandler::reportError(UnifiedErrorCode code, uint32_t detailValue1,
                                uint32_t detailValue2) {
-  ErrorContext context;
-  context.code = code;
-  context.domain = getErrorDomain(code);
-  context.severity = getDefaultSeverity(code);
-  context.detailValue1 = detailValue1;
-  context.detailValue2 = detailValue2;
-  reportError(context);
+  record(code, getDefaultSeverity(code), getErrorDomain(code), "",
+         detailValue1, detailValue2, "");
 }
 
 void ErrorHandler::reportError(UnifiedErrorCode code, const String& deviceId,
                                uint32_t detailValue1) {
+  record(code, getDefaultSeverity(code), getErrorDomain(code),
+         deviceId.c_str(), detailValue1, 0, "");
+}
+
+void ErrorHandler::record(UnifiedErrorCode code, ErrorSeverity severity,
+                          ErrorDomain domain, const char* deviceId,
+                          uint32_t detailValue1, uint32_t detailValue2,
+                          const char* description) {
+  if (!enabled) return;
+
+  unsigned long now = millis();
+  updateStatistics(severity, domain, code, now);
+
+  uint32_t key = errorKey(code, deviceId);
+  if (coalesce(key, code, deviceId, now)) {
+    coalescedErrors.fetch_add(1, std::memory_order_relaxed);
+    return;  // Counted in the existing record
+  }
+
+  ErrorRecord* written = nullptr;
+  if (history != nullptr) {
+    // Claim a sequence; a full ring overwrites the oldest record
+    uint32_t seq = writeSeq.fetch_add(1, std::memory_order_acq_rel);
+    HistorySlot& slot = history[seq & (HISTORY_CAPACITY - 1)];
+    slot.claimed.store(seq, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ErrorRecord& r = slot.record;
+    r.sequence = seq;
+    r.code = code;
+    r.severity = severity;
+    r.domain = domain;
+    r.timestamp = now;
+    r.detailValue1 = detailValue1;
+    r.detailValue2 = detailValue2;
+    strncpy(r.deviceId, deviceId, sizeof(r.deviceId) - 1);
+    r.deviceId[sizeof(r.deviceId) - 1] = '\0';
+    strncpy(r.description, description, sizeof(r.description) - 1);
+    r.description[sizeof(r.description) - 1] = '\0';
+    slot.key = key;
+    slot.occurrenceCount.store(1, std::memory_order_relaxed);
+    slot.lastOccurrenceTime.store(now, std::memory_order_relaxed);
+    slot.committed.store(seq, std::memory_order_release);
+    written = &r;
+  }
+
+  bool log = logToSerial && severity >= minSeverityToLog;
+  uint32_t callbacks = callbackCount.load(std::memory_order_acquire);
+  if (!log && callbacks == 0) {
+    return;
+  }
+
+  // Slow path (first occurrence only): full context for log and callbacks
   ErrorContext context;
   context.code = code;
-  context.domain = getErrorDomain(code);
-  context.severity = getDefaultSeverity(code);
+  context.severity = severity;
+  context.domain = domain;
+  context.timestamp = now;
+  context.occurrenceCount = 1;
+  context.lastOccurrenceTime = now;
   context.deviceId = deviceId;
   context.detailValue1 = detailValue1;
-  reportError(context);
+  context.detailValue2 = detailValue2;
+  context.description = written ? written->description : description;
+  context.isRecoverable = isRecoverableError(code);
+  context.suggestedRetryDelayMs = getSuggestedRetryDelay(code);
+
+  if (log) {
+    printErrorWithRecovery(context);
+  }
+  for (uint32_t i = 0; i < callbacks; i++) {
+    errorCallbacks[i](context);
+  }
+}
+
+bool ErrorHandler::coalesce(uint32_t key, UnifiedErrorCode code,
+                            const char* deviceId, unsigned long now) {
+  if (history == nullptr) return false;
+
+  uint32_t head = writeSeq.load(std::memory_order_acquire);
+  uint32_t cleared = clearedSeq.load(std::memory_order_acquire);
+  for (uint32_t back = 1; back <= COALESCE_SCAN; back++) {
+    uint32_t seq = head - back;
+    if ((int32_t)(seq - cleared) < 0 || back > head) break;
+    HistorySlot& slot = history[seq & (HISTORY_CAPACITY - 1)];
+    if (slot.committed.load(std::memory_order_acquire) != seq ||
+        slot.key != key) {
+      continue;
+    }
+    if (now - slot.lastOccurrenceTime.load(std::memory_order_relaxed) >
+            COALESCE_WINDOW_MS ||
+        slot.record.code != code ||
+        strncmp(slot.record.deviceId, deviceId,
+                sizeof(slot.record.deviceId) - 1) != 0) {
+      return false;  // Newest record of this error is too old (new record)
+    }
+    slot.occurrenceCount.fetch_add(1, std::memory_order_relaxed);
+    slot.lastOccurrenceTime.store(now, std::memory_order_relaxed);
+    // Overwritten meanwhile: the repeat is still counted in the statistics
+    return slot.claimed.load(std::memory_order_acquire) == seq;
+  }
+  return false;
 }
 
 // Configuration
@@ -97,149 +197,208 @@ void ErrorHandler::setMinSeverityToLog(ErrorSeverity severity) {
 }
 
 void ErrorHandler::setMaxHistorySize(uint8_t size) {
-  maxHistorySize = size;
-  while (errorHistory.size() > maxHistorySize) {
-    errorHistory.pop_back();
-  }
+  // v1.3.3: Visible window of the fixed ring
+  maxHistorySize = (size > HISTORY_CAPACITY) ? HISTORY_CAPACITY : size;
 }
 
 // Callback management
 void ErrorHandler::registerErrorCallback(ErrorCallback callback) {
-  errorCallbacks.push_back(callback);
-  Serial.printf("[ERROR_HANDLER] Registered error callback (%d total)\n",
-                errorCallbacks.size());
+  uint32_t count = callbackCount.load();
+  if (count >= MAX_CALLBACKS) {
+    Serial.printf("[ERROR_HANDLER] Callback table full (%u), not registered\n",
+                  (unsigned)MAX_CALLBACKS);
+    return;
+  }
+  errorCallbacks[count] = callback;
+  callbackCount.store(count + 1, std::memory_order_release);
+  Serial.printf("[ERROR_HANDLER] Registered error callback (%u total)\n",
+                (unsigned)(count + 1));
 }
 
 void ErrorHandler::clearErrorCallbacks() {
-  errorCallbacks.clear();
+  // Slots stay valid for a reporter that already read the old count
+  callbackCount.store(0, std::memory_order_release);
   Serial.println("[ERROR_HANDLER] Cleared all error callbacks");
 }
 
 // Error queries
 uint32_t ErrorHandler::getErrorCount(ErrorSeverity severity) const {
   uint32_t count = 0;
-  for (const auto& error : errorHistory) {
+  forEachError([&](const ErrorRecord& error) {
     if (error.severity == severity) count++;
-  }
+    return true;
+  });
   return count;
 }
 
 uint32_t ErrorHandler::getErrorCountByDomain(ErrorDomain domain) const {
   uint32_t count = 0;
-  for (const auto& error : errorHistory) {
+  forEachError([&](const ErrorRecord& error) {
     if (error.domain == domain) count++;
-  }
+    return true;
+  });
   return count;
 }
 
-uint32_t ErrorHandler::getTotalErrorCount() const {
-  return errorHistory.size();
-}
+uint32_t ErrorHandler::getTotalErrorCount() const { return getHistorySize(); }
 
 ErrorContext ErrorHandler::getLastError() const {
-  if (errorHistory.empty()) {
-    return ErrorContext();
-  }
-  return errorHistory.front();
+  return getHistoryEntry(0);
 }
 
 ErrorContext ErrorHandler::getLastErrorByDomain(ErrorDomain domain) const {
-  for (const auto& error : errorHistory) {
-    if (error.domain == domain) {
-      return error;
-    }
-  }
-  return ErrorContext();
+  ErrorContext found;
+  forEachError([&](const ErrorRecord& error) {
+    if (error.domain != domain) return true;
+    found = toContext(error);
+    return false;
+  });
+  return found;
 }
 
 ErrorContext ErrorHandler::getLastErrorByCode(UnifiedErrorCode code) const {
-  for (const auto& error : errorHistory) {
-    if (error.code == code) {
-      return error;
-    }
-  }
-  return ErrorContext();
+  ErrorContext found;
+  forEachError([&](const ErrorRecord& error) {
+    if (error.code != code) return true;
+    found = toContext(error);
+    return false;
+  });
+  return found;
 }
 
 // History access
-uint32_t ErrorHandler::getHistorySize() const { return errorHistory.size(); }
-
-ErrorContext ErrorHandler::getHistoryEntry(uint32_t index) const {
-  if (index >= errorHistory.size()) {
-    return ErrorContext();
-  }
-  return errorHistory[index];
+uint32_t ErrorHandler::visibleHistory(uint32_t& head) const {
+  head = writeSeq.load(std::memory_order_acquire);
+  uint32_t available = head - clearedSeq.load(std::memory_order_acquire);
+  if (available > HISTORY_CAPACITY) available = HISTORY_CAPACITY;
+  if (available > maxHistorySize) available = maxHistorySize;
+  return (history != nullptr) ? available : 0;
 }
 
-std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>>
-ErrorHandler::getErrorHistory() const {
-  return errorHistory;
+uint32_t ErrorHandler::getHistorySize() const {
+  uint32_t head;
+  return visibleHistory(head);
 }
 
-std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>>
-ErrorHandler::getErrorHistoryByDomain(ErrorDomain domain) const {
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>> filtered;
-  for (const auto& error : errorHistory) {
-    if (error.domain == domain) {
-      filtered.push_back(error);
+ErrorContext ErrorHandler::getHistoryEntry(uint32_t index) const {
+  ErrorContext found;
+  uint32_t position = 0;
+  forEachError([&](const ErrorRecord& error) {
+    if (position++ < index) return true;
+    found = toContext(error);
+    return false;
+  });
+  return found;
+}
+
+uint32_t ErrorHandler::forEachError(const ErrorVisitor& visitor) const {
+  uint32_t head;
+  uint32_t available = visibleHistory(head);
+  uint32_t visited = 0;
+  ErrorRecord error;
+  for (uint32_t back = 1; back <= available; back++) {
+    if (!readRecord(head - back, error)) {
+      continue;  // Being overwritten by a reporter
     }
+    visited++;
+    if (!visitor(error)) break;
   }
-  return filtered;
+  return visited;
 }
 
-std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>>
-ErrorHandler::getErrorHistoryBySeverity(ErrorSeverity severity) const {
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>> filtered;
-  for (const auto& error : errorHistory) {
-    if (error.severity == severity) {
-      filtered.push_back(error);
-    }
+bool ErrorHandler::readRecord(uint32_t sequence, ErrorRecord& out) const {
+  const HistorySlot& slot = history[sequence & (HISTORY_CAPACITY - 1)];
+  if (slot.committed.load(std::memory_order_acquire) != sequence) {
+    return false;
   }
-  return filtered;
+  out = slot.record;
+  out.occurrenceCount = slot.occurrenceCount.load(std::memory_order_relaxed);
+  out.lastOccurrenceTime =
+      slot.lastOccurrenceTime.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // Copy is valid only if no reporter claimed the slot meanwhile
+  return slot.claimed.load(std::memory_order_relaxed) == sequence;
+}
+
+ErrorContext ErrorHandler::toContext(const ErrorRecord& record) const {
+  ErrorContext context;
+  context.code = record.code;
+  context.severity = record.severity;
+  context.domain = record.domain;
+  context.timestamp = record.timestamp;
+  context.occurrenceCount = record.occurrenceCount;
+  context.lastOccurrenceTime = record.lastOccurrenceTime;
+  context.deviceId = record.deviceId;
+  context.detailValue1 = record.detailValue1;
+  context.detailValue2 = record.detailValue2;
+  context.description = record.description;
+  context.isRecoverable = isRecoverableError(record.code);
+  context.suggestedRetryDelayMs = getSuggestedRetryDelay(record.code);
+  return context;
 }
 
 // Statistics
-ErrorStatistics ErrorHandler::getStatistics() const { return statistics; }
+ErrorStatistics ErrorHandler::getStatistics() const {
+  ErrorStatistics snapshot;
+  snapshot.totalErrorsReported = totalErrors.load();
+  snapshot.criticalErrorCount = severityCounts[SEVERITY_CRITICAL].load();
+  snapshot.errorErrorCount = severityCounts[SEVERITY_ERROR].load();
+  snapshot.warningCount = severityCounts[SEVERITY_WARNING].load();
+  snapshot.infoCount = severityCounts[SEVERITY_INFO].load();
+  snapshot.errorsThisHour = errorCounterThisHour.load();
+  snapshot.errorsThisDay = errorCounterThisDay.load();
+  snapshot.lastErrorTime = lastErrorTime.load();
+  snapshot.lastErrorCode = (UnifiedErrorCode)lastErrorCode.load();
+
+  uint32_t maxCount = 0;
+  for (int i = 0; i < DOMAIN_COUNT; i++) {
+    uint32_t count = domainCounts[i].load();
+    if (count > maxCount) {
+      maxCount = count;
+      snapshot.mostFrequentDomain = (ErrorDomain)i;
+    }
+  }
+  return snapshot;
+}
 
 void ErrorHandler::resetStatistics() {
-  statistics = ErrorStatistics();
+  totalErrors.store(0);
+  coalescedErrors.store(0);
+  for (auto& count : severityCounts) count.store(0);
+  for (auto& count : domainCounts) count.store(0);
+  lastErrorTime.store(0);
+  lastErrorCode.store(ERR_SYS_UNKNOWN);
   lastResetTime = millis();
   Serial.println("[ERROR_HANDLER] Statistics reset");
 }
 
 float ErrorHandler::getErrorRatePerHour() const {
-  if (errorCounterThisHour == 0) return 0.0f;
-  return (errorCounterThisHour * 3600000.0f) / (millis() - hourStartTime);
+  uint32_t count = errorCounterThisHour.load();
+  if (count == 0) return 0.0f;
+  return (count * 3600000.0f) / (millis() - hourStartTime.load());
 }
 
 float ErrorHandler::getErrorRatePerDay() const {
-  if (errorCounterThisDay == 0) return 0.0f;
-  return (errorCounterThisDay * 86400000.0f) / (millis() - dayStartTime);
+  uint32_t count = errorCounterThisDay.load();
+  if (count == 0) return 0.0f;
+  return (count * 86400000.0f) / (millis() - dayStartTime.load());
 }
 
 uint32_t ErrorHandler::getErrorsThisHour() {
-  updateTimers();
-  return errorCounterThisHour;
+  updateTimers(millis());
+  return errorCounterThisHour.load();
 }
 
 uint32_t ErrorHandler::getErrorsThisDay() {
-  updateTimers();
-  return errorCounterThisDay;
+  updateTimers(millis());
+  return errorCounterThisDay.load();
 }
 
 // Error patterns
+// v1.3.3: A coalesced record stands for occurrenceCount errors
 bool ErrorHandler::isErrorRepeating(UnifiedErrorCode code,
                                     uint32_t withinMs) const {
-  uint32_t count = 0;
-  unsigned long now = millis();
-
-  for (const auto& error : errorHistory) {
-    if (error.code == code && (now - error.timestamp) <= withinMs) {
-      count++;
-      if (count >= 2) return true;
-    }
-  }
-  return false;
+  return getRepeatingErrorCount(code, withinMs) >= 2;
 }
 
 uint32_t ErrorHandler::getRepeatingErrorCount(UnifiedErrorCode code,
@@ -247,34 +406,36 @@ uint32_t ErrorHandler::getRepeatingErrorCount(UnifiedErrorCode code,
   uint32_t count = 0;
   unsigned long now = millis();
 
-  for (const auto& error : errorHistory) {
-    if (error.code == code && (now - error.timestamp) <= withinMs) {
-      count++;
+  forEachError([&](const ErrorRecord& error) {
+    if (error.code == code && (now - error.lastOccurrenceTime) <= withinMs) {
+      count += error.occurrenceCount;
     }
-  }
+    return true;
+  });
   return count;
 }
 
 ErrorDomain ErrorHandler::getMostFrequentErrorDomain(uint32_t withinMs) const {
   unsigned long now = millis();
   // FIXED: Use DOMAIN_COUNT instead of hardcoded 7 to prevent array overflow
-  uint32_t domainCounts[DOMAIN_COUNT] = {0};
+  uint32_t counts[DOMAIN_COUNT] = {0};
 
-  for (const auto& error : errorHistory) {
-    if ((now - error.timestamp) <= withinMs) {
+  forEachError([&](const ErrorRecord& error) {
+    if ((now - error.lastOccurrenceTime) <= withinMs) {
       // Bounds check to prevent array overflow
       if (error.domain < DOMAIN_COUNT) {
-        domainCounts[error.domain]++;
+        counts[error.domain] += error.occurrenceCount;
       }
     }
-  }
+    return true;
+  });
 
   uint32_t maxCount = 0;
   ErrorDomain maxDomain = DOMAIN_SYSTEM;
 
   for (int i = 0; i < DOMAIN_COUNT; i++) {
-    if (domainCounts[i] > maxCount) {
-      maxCount = domainCounts[i];
+    if (counts[i] > maxCount) {
+      maxCount = counts[i];
       maxDomain = (ErrorDomain)i;
     }
   }
@@ -320,18 +481,21 @@ void ErrorHandler::printErrorWithRecovery(const ErrorContext& context) {
 
 // Diagnostics and reporting
 void ErrorHandler::printLastError() {
-  if (errorHistory.empty()) {
+  if (getHistorySize() == 0) {
     Serial.println("[ERROR_HANDLER] No errors recorded");
     return;
   }
 
   Serial.println("\n[ERROR HANDLER] LAST ERROR");
-  printErrorWithRecovery(errorHistory.front());
+  printErrorWithRecovery(getLastError());
 }
 
 void ErrorHandler::printErrorStatistics() {
+  ErrorStatistics statistics = getStatistics();
   Serial.println("\n[ERROR HANDLER] ERROR STATISTICS");
-  Serial.printf("  Total Errors: %ld\n", statistics.totalErrorsReported);
+  Serial.printf("  Total Errors: %ld (coalesced: %lu)\n",
+                statistics.totalErrorsReported,
+                (unsigned long)coalescedErrors.load());
   Serial.printf("  Critical: %ld | Error: %ld | Warning: %ld | Info: %ld\n",
                 statistics.criticalErrorCount, statistics.errorErrorCount,
                 statistics.warningCount, statistics.infoCount);
@@ -346,17 +510,22 @@ void ErrorHandler::printErrorStatistics() {
 void ErrorHandler::printErrorHistory(uint32_t count) {
   Serial.printf("\n[ERROR HANDLER] ERROR HISTORY (Last %ld)\n", count);
 
-  if (errorHistory.empty()) {
+  if (getHistorySize() == 0) {
     Serial.println("No errors recorded");
     return;
   }
 
   uint32_t printed = 0;
-  for (const auto& error : errorHistory) {
-    if (printed >= count) break;
-    printErrorWithRecovery(error);
+  forEachError([&](const ErrorRecord& error) {
+    if (printed >= count) return false;
+    printErrorWithRecovery(toContext(error));
+    if (error.occurrenceCount > 1) {
+      Serial.printf("  Repeated: %lu times\n",
+                    (unsigned long)error.occurrenceCount);
+    }
     printed++;
-  }
+    return true;
+  });
 }
 
 void ErrorHandler::printErrorsByDomain() {
@@ -391,10 +560,12 @@ void ErrorHandler::printDetailedErrorReport() {
 
 void ErrorHandler::printErrorTrends() {
   Serial.println("\n[ERROR HANDLER] ERROR TRENDS");
-  Serial.printf("  Errors this hour: %ld (rate: %.2f/hour)\n",
-                errorCounterThisHour, getErrorRatePerHour());
-  Serial.printf("  Errors this day: %ld (rate: %.2f/day)\n",
-                errorCounterThisDay, getErrorRatePerDay());
+  Serial.printf("  Errors this hour: %lu (rate: %.2f/hour)\n",
+                (unsigned long)errorCounterThisHour.load(),
+                getErrorRatePerHour());
+  Serial.printf("  Errors this day: %lu (rate: %.2f/day)\n",
+                (unsigned long)errorCounterThisDay.load(),
+                getErrorRatePerDay());
 
   // Most frequent domain
   ErrorDomain frequent = getMostFrequentErrorDomain(3600000);
@@ -403,13 +574,14 @@ void ErrorHandler::printErrorTrends() {
 
   // Check for repeating errors
   Serial.println("\n  Repeating errors (last hour):");
-  for (const auto& error : errorHistory) {
+  forEachError([&](const ErrorRecord& error) {
     if (isErrorRepeating(error.code, 3600000)) {
       uint32_t count = getRepeatingErrorCount(error.code, 3600000);
       Serial.printf("    - %s: %ld times\n",
                     getErrorCodeDescription(error.code), count);
     }
-  }
+    return true;
+  });
   Serial.println();
 }
 
@@ -476,7 +648,7 @@ uint32_t ErrorHandler::getSuggestedRetryDelay(UnifiedErrorCode code) const {
 }
 
 void ErrorHandler::clearErrorHistory() {
-  errorHistory.clear();
+  clearedSeq.store(writeSeq.load());  // Records stay, hidden from queries
   Serial.println("[ERROR_HANDLER] Error history cleared");
 }
 
@@ -493,82 +665,42 @@ void ErrorHandler::enableDiagnosticMode(bool enable) {
 }
 
 // Private helper methods
-void ErrorHandler::updateStatistics(const ErrorContext& context) {
-  statistics.totalErrorsReported++;
-  statistics.lastErrorTime = millis();
-  statistics.lastErrorCode = context.code;
-  statistics.mostFrequentDomain = context.domain;
-
-  switch (context.severity) {
-    case SEVERITY_CRITICAL:
-      statistics.criticalErrorCount++;
-      break;
-    case SEVERITY_ERROR:
-      statistics.errorErrorCount++;
-      break;
-    case SEVERITY_WARNING:
-      statistics.warningCount++;
-      break;
-    case SEVERITY_INFO:
-      statistics.infoCount++;
-      break;
-  }
-
-  updateTimers();
-}
-
-void ErrorHandler::maintainHistory() {
-  // Keep history size within limits
-  while (errorHistory.size() > maxHistorySize) {
-    errorHistory.pop_back();
-  }
-}
-
-void ErrorHandler::updateTimers() {
-  unsigned long now = millis();
-
-  // Update hour counter
-  if ((now - hourStartTime) >= 3600000) {  // 1 hour = 3600000ms
-    errorCounterThisHour = 0;
-    hourStartTime = now;
-  } else {
-    errorCounterThisHour++;
+void ErrorHandler::updateStatistics(ErrorSeverity severity, ErrorDomain domain,
+                                    UnifiedErrorCode code, unsigned long now) {
+  totalErrors.fetch_add(1, std::memory_order_relaxed);
+  lastErrorTime.store(now, std::memory_order_relaxed);
+  lastErrorCode.store(code, std::memory_order_relaxed);
+  if (severity <= SEVERITY_CRITICAL) {
+    severityCounts[severity].fetch_add(1, std::memory_order_relaxed);
   }
-
-  // Update day counter
-  if ((now - dayStartTime) >= 86400000) {  // 1 day = 86400000ms
-    errorCounterThisDay = 0;
-    dayStartTime = now;
-  } else {
-    errorCounterThisDay++;
+  if (domain < DOMAIN_COUNT) {
+    domainCounts[domain].fetch_add(1, std::memory_order_relaxed);
   }
 
-  statistics.errorsThisHour = errorCounterThisHour;
-  statistics.errorsThisDay = errorCounterThisDay;
+  updateTimers(now);
+  errorCounterThisHour.fetch_add(1, std::memory_order_relaxed);
+  errorCounterThisDay.fetch_add(1, std::memory_order_relaxed);
 }
 
-ErrorContext ErrorHandler::enrichErrorContext(const ErrorContext& context) {
-  ErrorContext enriched = context;
-
-  if (enriched.timestamp == 0) {
-    enriched.timestamp = millis();
+void ErrorHandler::updateTimers(unsigned long now) {
+  // v1.3.3: Only the reporter that wins the exchange restarts a period
+  uint32_t start = hourStartTime.load(std::memory_order_relaxed);
+  if ((now - start) >= 3600000 &&  // 1 hour = 3600000ms
+      hourStartTime.compare_exchange_strong(start, now)) {
+    errorCounterThisHour.store(0, std::memory_order_relaxed);
   }
 
-  if (enriched.domain == DOMAIN_SYSTEM && context.domain != DOMAIN_SYSTEM) {
-    enriched.domain = getErrorDomain(context.code);
+  start = dayStartTime.load(std::memory_order_relaxed);
+  if ((now - start) >= 86400000 &&  // 1 day = 86400000ms
+      dayStartTime.compare_exchange_strong(start, now)) {
+    errorCounterThisDay.store(0, std::memory_order_relaxed);
   }
-
-  if (enriched.severity == SEVERITY_INFO && context.severity == SEVERITY_INFO) {
-    enriched.severity = getDefaultSeverity(context.code);
-  }
-
-  enriched.occurrenceCount++;
-  enriched.lastOccurrenceTime = millis();
-  enriched.isRecoverable = isRecoverableError(context.code);
-  enriched.suggestedRetryDelayMs = getSuggestedRetryDelay(context.code);
-
-  return enriched;
 }
 
 // Destructor
-ErrorHandler::~ErrorHandler() { Serial.println("[ERROR_HANDLER] Destroyed"); }
+ErrorHandler::~ErrorHandler() {
+  if (history) {
+    heap_caps_free(history);
+  }
+  Serial.println("[ERROR_HANDLER] Destroyed");
+}
@@ -3,10 +3,9 @@
 
 #include <Arduino.h>
 
-#include <deque>
+#include <atomic>
 #include <functional>
 
-#include "PSRAMAllocator.h"  // FIXED BUG B: For PSRAM allocator
 #include "UnifiedErrorCodes.h"
 
 /*
@@ -23,52 +22,112 @@
  * - Recovery recommendations
  * - Error statistics tracking
  * - Severity-based filtering
+ *
+ * v1.3.3: Lock-free reporting path
+ * Previous: reportError() copied an ErrorContext (3 Strings) into a
+ * std::deque, recomputed the hour/day counters twice and getErrorHistory()
+ * returned the whole deque by value. A bus fault storm paid all of it for
+ * every failed register.
+ * New: history is a preallocated ring of fixed-size records (same
+ * claimed/committed stamps as the QueueManager ring), statistics are atomic
+ * counters, and an identical error (same code and device) within
+ * COALESCE_WINDOW_MS only bumps the occurrence count of its record - no new
+ * record, no Serial log, no callbacks. Queries iterate the ring in place
+ * (forEachError()).
+ */
+
+/**
+ * One history record (fixed size, no heap; strings truncated)
  */
+struct ErrorRecord {
+  uint32_t sequence;  // Ring sequence (forEachError order: newest first)
+  UnifiedErrorCode code;
+  ErrorSeverity severity;
+  ErrorDomain domain;
+  unsigned long timestamp;           // First occurrence
+  unsigned long lastOccurrenceTime;  // Last coalesced occurrence
+  uint32_t occurrenceCount;          // 1 + coalesced repeats
+  uint32_t detailValue1;
+  uint32_t detailValue2;
+  char deviceId[24];
+  char description[64];
+};
 
 class ErrorHandler {
  private:
   static ErrorHandler* instance;
 
+ public:
+  static constexpr uint32_t HISTORY_CAPACITY = 128;  // Power of two (mask)
+  static constexpr uint32_t COALESCE_WINDOW_MS = 5000;
+  static constexpr uint32_t COALESCE_SCAN = 8;  // Newest records compared
+  static constexpr uint32_t MAX_CALLBACKS = 4;
+
+  typedef std::function<void(const ErrorContext&)> ErrorCallback;
+  // Return false to stop the iteration
+  typedef std::function<bool(const ErrorRecord&)> ErrorVisitor;
+
+ private:
   // Configuration
   bool enabled = true;
   bool logToSerial = true;
   uint8_t maxHistorySize = 100;  // Maximum errors to keep in history
   ErrorSeverity minSeverityToLog = SEVERITY_WARNING;  // Minimum severity to log
 
-  // Error history (circular buffer)
-  // FIXED BUG B: Use PSRAM allocator to save precious DRAM (5-10KB moved to
-  // PSRAM)
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>> errorHistory;
-
-  // Statistics
-  ErrorStatistics statistics;
-
-  // Callbacks
-  typedef std::function<void(const ErrorContext&)> ErrorCallback;
-  // FIXED BUG B: Use PSRAM allocator to save DRAM
-  std::deque<ErrorCallback, STLPSRAMAllocator<ErrorCallback>> errorCallbacks;
+  // v1.3.3: Error history ring (PSRAM, allocated once)
+  struct HistorySlot {
+    std::atomic<uint32_t> claimed;    // Sequence being / last written
+    std::atomic<uint32_t> committed;  // Sequence fully written
+    uint32_t key;                     // Hash of code + deviceId (coalescing)
+    std::atomic<uint32_t> occurrenceCount;
+    std::atomic<uint32_t> lastOccurrenceTime;
+    ErrorRecord record;
+  };
+  HistorySlot* history = nullptr;
+  std::atomic<uint32_t> writeSeq{0};    // Next sequence to claim
+  std::atomic<uint32_t> clearedSeq{0};  // Older sequences are hidden
+
+  // v1.3.3: Statistics (atomic, snapshot in getStatistics())
+  std::atomic<uint32_t> totalErrors{0};
+  std::atomic<uint32_t> coalescedErrors{0};
+  std::atomic<uint32_t> severityCounts[SEVERITY_CRITICAL + 1];
+  std::atomic<uint32_t> domainCounts[DOMAIN_COUNT];
+  std::atomic<uint32_t> lastErrorTime{0};
+  std::atomic<uint32_t> lastErrorCode{ERR_SYS_UNKNOWN};
+
+  // Callbacks (registered at startup; count published after the slot)
+  ErrorCallback errorCallbacks[MAX_CALLBACKS];
+  std::atomic<uint32_t> callbackCount{0};
 
   // Tracking
   unsigned long lastResetTime = 0;
-  uint32_t errorCounterThisHour = 0;
-  uint32_t errorCounterThisDay = 0;
-  unsigned long hourStartTime = 0;
-  unsigned long dayStartTime = 0;
+  std::atomic<uint32_t> errorCounterThisHour{0};
+  std::atomic<uint32_t> errorCounterThisDay{0};
+  std::atomic<uint32_t> hourStartTime{0};
+  std::atomic<uint32_t> dayStartTime{0};
 
   // Private constructor for singleton
   ErrorHandler();
 
   // Internal methods
-  void updateStatistics(const ErrorContext& context);
-  void maintainHistory();
-  void updateTimers();
-  ErrorContext enrichErrorContext(const ErrorContext& context);
+  void record(UnifiedErrorCode code, ErrorSeverity severity,
+              ErrorDomain domain, const char* deviceId, uint32_t detailValue1,
+              uint32_t detailValue2, const char* description);
+  bool coalesce(uint32_t key, UnifiedErrorCode code, const char* deviceId,
+                unsigned long now);
+  void updateStatistics(ErrorSeverity severity, ErrorDomain domain,
+                        UnifiedErrorCode code, unsigned long now);
+  void updateTimers(unsigned long now);
+  bool readRecord(uint32_t sequence, ErrorRecord& out) const;
+  ErrorContext toContext(const ErrorRecord& record) const;
+  uint32_t visibleHistory(uint32_t& head) const;
 
  public:
   // Singleton access
   static ErrorHandler* getInstance();
 
-  // Core error reporting
+  // Core error reporting (any task; repeats within COALESCE_WINDOW_MS are
+  // only counted)
   void reportError(UnifiedErrorCode code, const String& description = "");
   void reportError(const ErrorContext& context);
   void reportError(UnifiedErrorCode code, uint32_t detailValue1,
@@ -97,16 +156,14 @@ class ErrorHandler {
   // History access
   uint32_t getHistorySize() const;
   ErrorContext getHistoryEntry(uint32_t index) const;  // 0 = newest
-  // FIXED BUG B: Return type must match PSRAM allocator
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>> getErrorHistory()
-      const;
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>>
-  getErrorHistoryByDomain(ErrorDomain domain) const;
-  std::deque<ErrorContext, STLPSRAMAllocator<ErrorContext>>
-  getErrorHistoryBySeverity(ErrorSeverity severity) const;
+  // v1.3.3: In-place iteration, newest first (replaces getErrorHistory*()
+  // which returned deque copies). Records being overwritten are skipped.
+  // @return Records visited
+  uint32_t forEachError(const ErrorVisitor& visitor) const;
 
   // Statistics
   ErrorStatistics getStatistics() const;
+  uint32_t getCoalescedErrorCount() const { return coalescedErrors.load(); }
   void resetStatistics();
   float getErrorRatePerHour() const;
   float getErrorRatePerDay() const;
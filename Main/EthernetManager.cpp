@@ -11,7 +11,8 @@ EthernetManager::EthernetManager()
       refCountMutex(nullptr),
       storedUseDhcp(true),
       lastReconnectAttempt(0),
-      reconnectCount(0) {
+      reconnectCount(0),
+      lastLinkUp(false) {
   generateMacAddress();
   // Create mutex for reference counting protection
   refCountMutex = xSemaphoreCreateMutex();
@@ -153,6 +154,15 @@ bool EthernetManager::isAvailable() {
   return Ethernet.linkStatus() == LinkON;
 }
 
+bool EthernetManager::pollLinkChange() {
+  bool up = isAvailable();
+  if (up == lastLinkUp) {
+    return false;
+  }
+  lastLinkUp = up;
+  return true;
+}
+
 IPAddress EthernetManager::getLocalIP() {
   if (initialized) {
     return Ethernet.localIP();
@@ -36,6 +36,8 @@ class EthernetManager {
   unsigned long lastReconnectAttempt;
   uint32_t reconnectCount;
 
+  bool lastLinkUp;  // v1.3.3: Link state at the previous pollLinkChange()
+
   EthernetManager();
   void generateMacAddress();
 
@@ -59,6 +61,10 @@ class EthernetManager {
   bool isInitialized() const { return initialized; }
   uint32_t getReconnectCount() const { return reconnectCount; }
 
+  // v1.3.3: The W5500 has no link interrupt; NetworkMgr polls the PHY link
+  // bit (one SPI read) every failover pass
+  bool pollLinkChange();  // true if the link went up or down since last call
+
   ~EthernetManager();
 };
 
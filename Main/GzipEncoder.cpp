@@ -0,0 +1,255 @@
+#include "GzipEncoder.h"
+
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+
+// RFC 1951 3.2.5: length codes 257-285 and distance codes 0-29
+static const uint16_t LENGTH_BASE[29] = {
+    3,  4,  5,  6,  7,  8,  9,  10,  11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                         1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                         4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DISTANCE_BASE[30] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Huffman codes are defined MSB first, deflate packs bits LSB first
+static uint32_t reverseBits(uint32_t code, uint8_t length) {
+  uint32_t reversed = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    reversed = (reversed << 1) | (code & 1);
+    code >>= 1;
+  }
+  return reversed;
+}
+
+GzipEncoder::GzipEncoder()
+    : out(nullptr),
+      buffer(nullptr),
+      head(nullptr),
+      prev(nullptr),
+      base(0),
+      fill(0),
+      pos(0),
+      crc(0),
+      bitBuffer(0),
+      bitCount(0),
+      outUsed(0) {}
+
+GzipEncoder::~GzipEncoder() { release(); }
+
+void GzipEncoder::release() {
+  if (buffer) {
+    heap_caps_free(buffer);
+    buffer = nullptr;
+  }
+  if (head) {
+    heap_caps_free(head);
+    head = nullptr;
+  }
+  if (prev) {
+    heap_caps_free(prev);
+    prev = nullptr;
+  }
+}
+
+bool GzipEncoder::begin(Print& out) {
+  release();
+  buffer = (uint8_t*)heap_caps_malloc(BUFFER_SIZE,
+                                      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  head = (uint32_t*)heap_caps_calloc(HASH_SIZE, sizeof(uint32_t),
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  prev = (uint32_t*)heap_caps_calloc(WINDOW_SIZE, sizeof(uint32_t),
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buffer || !head || !prev) {
+    release();
+    return false;
+  }
+
+  this->out = &out;
+  base = 0;
+  fill = 0;
+  pos = 0;
+  crc = 0;
+  bitBuffer = 0;
+  bitCount = 0;
+  outUsed = 0;
+
+  // Header: magic, CM = deflate, no flags / mtime, XFL 0, OS unknown
+  static const uint8_t header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+  for (uint8_t byte : header) {
+    pushByte(byte);
+  }
+  pushBits(1, 1);  // BFINAL: one block for the whole stream
+  pushBits(1, 2);  // BTYPE 01: fixed Huffman codes
+  return true;
+}
+
+size_t GzipEncoder::write(uint8_t byte) { return write(&byte, 1); }
+
+size_t GzipEncoder::write(const uint8_t* data, size_t size) {
+  if (!buffer) return 0;
+
+  crc = esp_rom_crc32_le(crc, data, size);
+  size_t done = 0;
+  while (done < size) {
+    if (fill == BUFFER_SIZE) {
+      encode(false);
+      slide();
+    }
+    size_t room = min(BUFFER_SIZE - fill, size - done);
+    memcpy(buffer + fill, data + done, room);
+    fill += room;
+    done += room;
+  }
+  return size;
+}
+
+void GzipEncoder::finish() {
+  if (!buffer) return;
+
+  encode(true);
+  writeSymbol(256);  // End of block
+  if (bitCount > 0) {
+    pushBits(0, 8 - bitCount);  // Trailer is byte aligned
+  }
+
+  // Trailer: CRC32 and input size mod 2^32, little endian
+  uint32_t size = (uint32_t)consumed();
+  for (uint8_t shift = 0; shift < 32; shift += 8) {
+    pushByte((uint8_t)(crc >> shift));
+  }
+  for (uint8_t shift = 0; shift < 32; shift += 8) {
+    pushByte((uint8_t)(size >> shift));
+  }
+  flushBytes();
+  release();
+}
+
+uint32_t GzipEncoder::hashAt(size_t at) const {
+  return ((uint32_t)buffer[at] << 8 ^ (uint32_t)buffer[at + 1] << 4 ^
+          buffer[at + 2]) &
+         (HASH_SIZE - 1);
+}
+
+void GzipEncoder::insert(size_t at) {
+  if (at + 2 >= fill) return;  // Needs 3 bytes (skipping only loses a match)
+  size_t absolute = base + at;
+  uint32_t h = hashAt(at);
+  prev[absolute & (WINDOW_SIZE - 1)] = head[h];
+  head[h] = absolute + 1;
+}
+
+size_t GzipEncoder::findMatch(size_t& distance) const {
+  if (pos + 2 >= fill) return 0;
+
+  size_t absolute = base + pos;
+  size_t maxLen = min(MAX_MATCH, fill - pos);
+  size_t bestLen = 0;
+  uint32_t candidate = head[hashAt(pos)];
+  for (uint8_t tries = 0; candidate != 0 && tries < MAX_CHAIN; tries++) {
+    size_t at = candidate - 1;
+    // The buffer always keeps WINDOW_SIZE bytes before pos, so every
+    // candidate within the window is still in it
+    if (absolute - at > WINDOW_SIZE) break;
+
+    const uint8_t* match = buffer + (at - base);
+    size_t len = 0;
+    while (len < maxLen && match[len] == buffer[pos + len]) {
+      len++;
+    }
+    if (len > bestLen) {
+      bestLen = len;
+      distance = absolute - at;
+      if (len == maxLen) break;
+    }
+    candidate = prev[at & (WINDOW_SIZE - 1)];
+  }
+  return bestLen;
+}
+
+void GzipEncoder::encode(bool final) {
+  // Mid-stream, only encode positions with a full lookahead behind them
+  size_t limit = final ? fill : (fill > MAX_MATCH ? fill - MAX_MATCH : 0);
+  while (pos < limit) {
+    size_t distance = 0;
+    size_t len = findMatch(distance);
+    if (len >= MIN_MATCH) {
+      writeMatch(len, distance);
+    } else {
+      len = 1;
+      writeSymbol(buffer[pos]);
+    }
+    for (size_t i = 0; i < len; i++) {
+      insert(pos + i);
+    }
+    pos += len;
+  }
+}
+
+void GzipEncoder::slide() {
+  // Keep the window before pos plus the unencoded bytes
+  size_t keepFrom = (pos > WINDOW_SIZE) ? pos - WINDOW_SIZE : 0;
+  if (keepFrom == 0) return;
+  memmove(buffer, buffer + keepFrom, fill - keepFrom);
+  base += keepFrom;
+  fill -= keepFrom;
+  pos -= keepFrom;
+}
+
+void GzipEncoder::writeSymbol(uint16_t symbol) {
+  // RFC 1951 3.2.6 fixed literal/length code
+  if (symbol < 144) {
+    pushBits(reverseBits(0x30 + symbol, 8), 8);
+  } else if (symbol < 256) {
+    pushBits(reverseBits(0x190 + symbol - 144, 9), 9);
+  } else if (symbol < 280) {
+    pushBits(reverseBits(symbol - 256, 7), 7);
+  } else {
+    pushBits(reverseBits(0xc0 + symbol - 280, 8), 8);
+  }
+}
+
+void GzipEncoder::writeMatch(size_t length, size_t distance) {
+  uint8_t code = 28;
+  while (LENGTH_BASE[code] > length) {
+    code--;
+  }
+  writeSymbol(257 + code);
+  pushBits(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+  code = 29;
+  while (DISTANCE_BASE[code] > distance) {
+    code--;
+  }
+  pushBits(reverseBits(code, 5), 5);  // Fixed distance codes are 5 bits
+  pushBits(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+}
+
+void GzipEncoder::pushBits(uint32_t bits, uint8_t count) {
+  if (count == 0) return;
+  bitBuffer |= (bits & ((1u << count) - 1)) << bitCount;
+  bitCount += count;
+  while (bitCount >= 8) {
+    outBuffer[outUsed++] = (uint8_t)bitBuffer;
+    bitBuffer >>= 8;
+    bitCount -= 8;
+    if (outUsed == sizeof(outBuffer)) {
+      flushBytes();
+    }
+  }
+}
+
+void GzipEncoder::pushByte(uint8_t byte) { pushBits(byte, 8); }
+
+void GzipEncoder::flushBytes() {
+  if (outUsed > 0 && out) {
+    out->write(outBuffer, outUsed);
+  }
+  outUsed = 0;
+}
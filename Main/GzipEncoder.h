@@ -0,0 +1,90 @@
+#ifndef GZIP_ENCODER_H
+#define GZIP_ENCODER_H
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+/**
+ * GzipEncoder - Streaming gzip (RFC 1952) compressor for HTTP bodies
+ *
+ * v1.3.3: Compressed HTTP uploads
+ * Batched register JSON repeats the same keys and device names for every
+ * data point. Bytes written to this Print are deflated incrementally and
+ * the gzip stream goes to another Print, so the uncompressed body never
+ * exists in memory as a whole (only the compressed one, if out buffers it).
+ *
+ * One deflate block with the fixed Huffman codes (RFC 1951 3.2.6): no code
+ * tables are sent or built, and the decoder side is any stock gzip/zlib
+ * (servers with Content-Encoding: gzip support). Matches are found with a
+ * 3-byte hash chain over a sliding buffer (window + the same again of input
+ * + lookahead), like HeatshrinkEncoder. Buffer and tables are ~40KB in
+ * PSRAM, allocated by begin() and freed by finish().
+ *
+ * Not thread-safe: one encoder per request.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class GzipEncoder : public Print {
+ public:
+  static constexpr uint8_t WINDOW_BITS = 12;  // 4096-byte history
+
+  GzipEncoder();
+  ~GzipEncoder();
+
+  /**
+   * Start a gzip stream written to out (writes the 10-byte header)
+   * @return false if the tables could not be allocated
+   */
+  bool begin(Print& out);
+
+  /**
+   * Encode the buffered tail, end the block and write the CRC32 / length
+   * trailer (stream complete)
+   */
+  void finish();
+
+  bool active() const { return buffer != nullptr; }
+  size_t consumed() const { return base + fill; }  // Input bytes so far
+
+  // Print interface (input)
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  using Print::write;
+
+ private:
+  static constexpr size_t WINDOW_SIZE = 1u << WINDOW_BITS;
+  static constexpr size_t MIN_MATCH = 3;
+  static constexpr size_t MAX_MATCH = 258;  // Deflate length limit
+  static constexpr size_t BUFFER_SIZE = 2 * WINDOW_SIZE + MAX_MATCH;
+  static constexpr size_t HASH_SIZE = 4096;
+  static constexpr uint8_t MAX_CHAIN = 32;  // Candidates tried per position
+
+  Print* out;
+  uint8_t* buffer;  // Input from position base (window + unencoded bytes)
+  uint32_t* head;   // Hash -> last absolute position + 1 (0 = none)
+  uint32_t* prev;   // Position & (WINDOW_SIZE - 1) -> older position + 1
+  size_t base;      // Absolute input position of buffer[0]
+  size_t fill;      // Bytes in buffer
+  size_t pos;       // Next byte to encode (relative to buffer)
+  uint32_t crc;     // CRC32 of the input (gzip trailer)
+  uint32_t bitBuffer;
+  uint8_t bitCount;
+  uint8_t outBuffer[64];  // Compressed bytes batched for out->write()
+  uint8_t outUsed;
+
+  uint32_t hashAt(size_t at) const;
+  void insert(size_t at);
+  size_t findMatch(size_t& distance) const;
+  void encode(bool final);
+  void slide();
+  void writeSymbol(uint16_t symbol);  // Fixed Huffman literal/length code
+  void writeMatch(size_t length, size_t distance);
+  void pushBits(uint32_t bits, uint8_t count);  // LSB first (deflate order)
+  void pushByte(uint8_t byte);                  // Byte aligned (header)
+  void flushBytes();
+  void release();
+};
+
+#endif  // GZIP_ENCODER_H
@@ -0,0 +1,178 @@
+#include "HeatshrinkEncoder.h"
+
+#include <esp_heap_caps.h>
+
+HeatshrinkEncoder::HeatshrinkEncoder()
+    : out(nullptr),
+      buffer(nullptr),
+      head(nullptr),
+      prev(nullptr),
+      base(0),
+      fill(0),
+      pos(0),
+      bitBuffer(0),
+      bitCount(0),
+      outUsed(0) {}
+
+HeatshrinkEncoder::~HeatshrinkEncoder() { release(); }
+
+void HeatshrinkEncoder::release() {
+  if (buffer) {
+    heap_caps_free(buffer);
+    buffer = nullptr;
+  }
+  if (head) {
+    heap_caps_free(head);
+    head = nullptr;
+  }
+  if (prev) {
+    heap_caps_free(prev);
+    prev = nullptr;
+  }
+}
+
+bool HeatshrinkEncoder::begin(Print& out) {
+  release();
+  buffer = (uint8_t*)heap_caps_malloc(BUFFER_SIZE,
+                                      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  head = (uint32_t*)heap_caps_calloc(HASH_SIZE, sizeof(uint32_t),
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  prev = (uint32_t*)heap_caps_calloc(WINDOW_SIZE, sizeof(uint32_t),
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buffer || !head || !prev) {
+    release();
+    return false;
+  }
+
+  this->out = &out;
+  base = 0;
+  fill = 0;
+  pos = 0;
+  bitBuffer = 0;
+  bitCount = 0;
+  outUsed = 0;
+  return true;
+}
+
+size_t HeatshrinkEncoder::write(uint8_t byte) { return write(&byte, 1); }
+
+size_t HeatshrinkEncoder::write(const uint8_t* data, size_t size) {
+  if (!buffer) return 0;
+
+  size_t done = 0;
+  while (done < size) {
+    if (fill == BUFFER_SIZE) {
+      encode(false);
+      slide();
+    }
+    size_t room = min(BUFFER_SIZE - fill, size - done);
+    memcpy(buffer + fill, data + done, room);
+    fill += room;
+    done += room;
+  }
+  return size;
+}
+
+void HeatshrinkEncoder::finish() {
+  if (!buffer) return;
+
+  encode(true);
+  if (bitCount > 0) {
+    pushBits(0, 8 - bitCount);  // Zero padding (never a complete token)
+  }
+  flushBytes();
+  release();
+}
+
+uint32_t HeatshrinkEncoder::hashAt(size_t at) const {
+  return ((uint32_t)buffer[at] << 8 ^ (uint32_t)buffer[at + 1] << 4 ^
+          buffer[at + 2]) &
+         (HASH_SIZE - 1);
+}
+
+void HeatshrinkEncoder::insert(size_t at) {
+  if (at + 2 >= fill) return;  // Needs 3 bytes (skipping only loses a match)
+  size_t absolute = base + at;
+  uint32_t h = hashAt(at);
+  prev[absolute & (WINDOW_SIZE - 1)] = head[h];
+  head[h] = absolute + 1;
+}
+
+size_t HeatshrinkEncoder::findMatch(size_t& offset) const {
+  if (pos + 2 >= fill) return 0;
+
+  size_t absolute = base + pos;
+  size_t maxLen = min(MAX_MATCH, fill - pos);
+  size_t bestLen = 0;
+  uint32_t candidate = head[hashAt(pos)];
+  for (uint8_t tries = 0; candidate != 0 && tries < MAX_CHAIN; tries++) {
+    size_t at = candidate - 1;
+    // The buffer always keeps WINDOW_SIZE bytes before pos, so every
+    // candidate within the window is still in it
+    if (absolute - at > WINDOW_SIZE) break;
+
+    const uint8_t* match = buffer + (at - base);
+    size_t len = 0;
+    while (len < maxLen && match[len] == buffer[pos + len]) {
+      len++;
+    }
+    if (len > bestLen) {
+      bestLen = len;
+      offset = absolute - at;
+      if (len == maxLen) break;
+    }
+    candidate = prev[at & (WINDOW_SIZE - 1)];
+  }
+  return bestLen;
+}
+
+void HeatshrinkEncoder::encode(bool final) {
+  // Mid-stream, only encode positions with a full lookahead behind them
+  size_t limit = final ? fill : (fill > MAX_MATCH ? fill - MAX_MATCH : 0);
+  while (pos < limit) {
+    size_t offset = 0;
+    size_t len = findMatch(offset);
+    if (len >= 2) {  // Backref (16 bits) beats two literals (18 bits)
+      pushBits(0, 1);
+      pushBits(offset - 1, WINDOW_BITS);
+      pushBits(len - 1, LOOKAHEAD_BITS);
+    } else {
+      len = 1;
+      pushBits(1, 1);
+      pushBits(buffer[pos], 8);
+    }
+    for (size_t i = 0; i < len; i++) {
+      insert(pos + i);
+    }
+    pos += len;
+  }
+}
+
+void HeatshrinkEncoder::slide() {
+  // Keep the window before pos plus the unencoded bytes
+  size_t keepFrom = (pos > WINDOW_SIZE) ? pos - WINDOW_SIZE : 0;
+  if (keepFrom == 0) return;
+  memmove(buffer, buffer + keepFrom, fill - keepFrom);
+  base += keepFrom;
+  fill -= keepFrom;
+  pos -= keepFrom;
+}
+
+void HeatshrinkEncoder::pushBits(uint32_t bits, uint8_t count) {
+  bitBuffer = (bitBuffer << count) | (bits & ((1u << count) - 1));
+  bitCount += count;
+  while (bitCount >= 8) {
+    bitCount -= 8;
+    outBuffer[outUsed++] = (uint8_t)(bitBuffer >> bitCount);
+    if (outUsed == sizeof(outBuffer)) {
+      flushBytes();
+    }
+  }
+}
+
+void HeatshrinkEncoder::flushBytes() {
+  if (outUsed > 0 && out) {
+    out->write(outBuffer, outUsed);
+  }
+  outUsed = 0;
+}
@@ -0,0 +1,87 @@
+#ifndef HEATSHRINK_ENCODER_H
+#define HEATSHRINK_ENCODER_H
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+/**
+ * HeatshrinkEncoder - Streaming LZSS compressor for BLE responses
+ *
+ * v1.3.3: Compressed BLE responses
+ * Large CRUD responses (full_config, device lists) repeat the same keys for
+ * every register. Bytes written to this Print are compressed incrementally
+ * and the output goes to another Print (BLE notifications), so neither the
+ * input nor the compressed body has to exist in memory as a whole.
+ *
+ * Bitstream is heatshrink compatible (window WINDOW_BITS, lookahead
+ * LOOKAHEAD_BITS), so the app can use any stock heatshrink decoder:
+ *   literal:  1, byte (8 bits)
+ *   backref:  0, offset - 1 (WINDOW_BITS), length - 1 (LOOKAHEAD_BITS)
+ * Bits are MSB first, the last byte is zero padded (finish()).
+ *
+ * Matches are found with a 3-byte hash chain over a sliding buffer (window +
+ * the same again of input + lookahead). Tables and buffer are ~22KB in PSRAM.
+ *
+ * Not thread-safe: one encoder per transmission.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class HeatshrinkEncoder : public Print {
+ public:
+  static constexpr uint8_t WINDOW_BITS = 10;    // 1024-byte history
+  static constexpr uint8_t LOOKAHEAD_BITS = 5;  // Matches up to 32 bytes
+
+  HeatshrinkEncoder();
+  ~HeatshrinkEncoder();
+
+  /**
+   * Start a compressed stream written to out
+   * @return false if the tables could not be allocated
+   */
+  bool begin(Print& out);
+
+  /**
+   * Encode the buffered tail and pad the last byte (stream complete)
+   */
+  void finish();
+
+  bool active() const { return buffer != nullptr; }
+  size_t consumed() const { return base + fill; }  // Input bytes so far
+
+  // Print interface (input)
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t* data, size_t size) override;
+  using Print::write;
+
+ private:
+  static constexpr size_t WINDOW_SIZE = 1u << WINDOW_BITS;
+  static constexpr size_t MAX_MATCH = 1u << LOOKAHEAD_BITS;
+  static constexpr size_t BUFFER_SIZE = 2 * WINDOW_SIZE + MAX_MATCH;
+  static constexpr size_t HASH_SIZE = 4096;
+  static constexpr uint8_t MAX_CHAIN = 32;  // Candidates tried per position
+
+  Print* out;
+  uint8_t* buffer;  // Input from position base (window + unencoded bytes)
+  uint32_t* head;   // Hash -> last absolute position + 1 (0 = none)
+  uint32_t* prev;   // Position & (WINDOW_SIZE - 1) -> older position + 1
+  size_t base;      // Absolute input position of buffer[0]
+  size_t fill;      // Bytes in buffer
+  size_t pos;       // Next byte to encode (relative to buffer)
+  uint32_t bitBuffer;
+  uint8_t bitCount;
+  uint8_t outBuffer[64];  // Compressed bytes batched for out->write()
+  uint8_t outUsed;
+
+  uint32_t hashAt(size_t at) const;
+  void insert(size_t at);
+  size_t findMatch(size_t& offset) const;
+  void encode(bool final);
+  void slide();
+  void pushBits(uint32_t bits, uint8_t count);
+  void flushBytes();
+  void release();
+};
+
+#endif  // HEATSHRINK_ENCODER_H
@@ -1,10 +1,64 @@
 #include "HttpManager.h"
 
+#include <esp_heap_caps.h>  // v1.3.3: PSRAM request body buffer
+
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
 #include "LEDManager.h"
+#include "MemoryRecovery.h"  // v1.3.3: Memory pressure (batch backpressure)
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 HttpManager* HttpManager::instance = nullptr;
 
+// v1.3.3: Compressed request body, grown in PSRAM as the encoder emits it
+// (the uncompressed body is never stored)
+class GzipBodyBuffer : public Print {
+ public:
+  explicit GzipBodyBuffer(size_t initialCapacity)
+      : data(nullptr), length(0), capacity(0), failed(false) {
+    grow(initialCapacity);
+  }
+  ~GzipBodyBuffer() { heap_caps_free(data); }
+
+  size_t write(uint8_t byte) override { return write(&byte, 1); }
+  size_t write(const uint8_t* bytes, size_t size) override {
+    if (length + size > capacity && !grow((length + size) * 3 / 2)) {
+      failed = true;
+      return 0;
+    }
+    memcpy(data + length, bytes, size);
+    length += size;
+    return size;
+  }
+
+  bool ok() const { return data != nullptr && !failed; }
+  size_t size() const { return length; }
+  uint8_t* release() {
+    uint8_t* result = data;
+    data = nullptr;
+    return result;
+  }
+
+ private:
+  uint8_t* data;
+  size_t length;
+  size_t capacity;
+  bool failed;
+
+  bool grow(size_t newCapacity) {
+    uint8_t* grown = (uint8_t*)heap_caps_realloc(
+        data, newCapacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!grown) {
+      grown = (uint8_t*)heap_caps_realloc(data, newCapacity, MALLOC_CAP_8BIT);
+    }
+    if (!grown) {
+      return false;
+    }
+    data = grown;
+    capacity = newCapacity;
+    return true;
+  }
+};
+
 HttpManager::HttpManager(ConfigManager* config, ServerConfig* serverCfg,
                          NetworkMgr* netMgr)
     : configManager(config),
@@ -13,9 +67,22 @@ HttpManager::HttpManager(ConfigManager* config, ServerConfig* serverCfg,
       networkManager(netMgr),
       running(false),
       taskHandle(nullptr),
+      hasContentTypeHeader(false),
+      payloadFormat(PayloadFormat::JSON),
       timeout(10000),
       retryCount(3),
+      batchSize(1),
+      gzipBody(false),
+      gzipInputBytes(0),
+      gzipOutputBytes(0),
+      cycleLayout(false),
+      cycleSubscribed(false),
+      cycleFormat(PayloadFormat::JSON),
+      cycleCursor(0),
+      cyclesSent(0),
+      cyclesSkipped(0),
       lastSendAttempt(0),
+      batchArena(BATCH_ARENA_SIZE),
       lastDataTransmission(0),
       dataIntervalMs(5000) {  // Default 5000ms (5 seconds)
   queueManager = QueueManager::getInstance();
@@ -54,10 +121,17 @@ void HttpManager::start() {
   }
 
   running = true;
-  BaseType_t result = xTaskCreatePinnedToCore(httpTask, "HTTP_TASK", 8192, this,
-                                              1, &taskHandle, 0);
+  BaseType_t result = TaskAffinity::create(httpTask, "HTTP_TASK", 8192, this,
+                                           TaskAffinity::Task::HTTP,
+                                           &taskHandle);
 
   if (result == pdPASS) {
+    if (cycleLayout) {
+      subscribeCycles();  // v1.3.3: Data points are not read from the queue
+    } else {
+      // v1.3.3: Own read cursor on the data queue (starts at backlog)
+      queueManager->attachConsumer(QueueConsumer::HTTP);
+    }
     LOG_NET_INFO("[HTTP] Manager started successfully");
   } else {
     LOG_NET_INFO("[HTTP] ERROR: Failed to create HTTP task");
@@ -68,6 +142,10 @@ void HttpManager::start() {
 
 void HttpManager::stop() {
   running = false;
+  if (queueManager) {
+    queueManager->detachConsumer(QueueConsumer::HTTP);
+  }
+  unsubscribeCycles();  // v1.3.3: Releases the retained cycles
 
   // Give task time to exit gracefully (checks 'running' flag in loop)
   if (taskHandle) {
@@ -77,6 +155,10 @@ void HttpManager::stop() {
     taskHandle = nullptr;
   }
 
+  // v1.3.3: Close the kept-alive connection (end() alone keeps it open)
+  httpClient.setReuse(false);
+  httpClient.end();
+
   LOG_NET_INFO("[HTTP] Manager stopped");
 }
 
@@ -87,10 +169,22 @@ void HttpManager::httpTask(void* parameter) {
 
 void HttpManager::httpLoop() {
   bool networkWasAvailable = false;
+  uint32_t networkGeneration = networkManager->getModeGeneration();  // v1.3.3
 
   LOG_NET_INFO("[HTTP] Task started");
 
   while (running) {
+    // v1.3.3: Failover switched the interface - drop the kept-alive
+    // connection so the next request connects on the new one
+    uint32_t generation = networkManager->getModeGeneration();
+    if (generation != networkGeneration) {
+      networkGeneration = generation;
+      httpClient.setReuse(false);
+      httpClient.end();
+      LOG_NET_INFO("[HTTP] Network switched to %s\n",
+                   networkManager->getCurrentMode().c_str());
+    }
+
     // Check network availability
     bool networkAvailable = isNetworkAvailable();
 
@@ -108,7 +202,8 @@ void HttpManager::httpLoop() {
                    networkManager->getCurrentMode().c_str(),
                    networkManager->getLocalIP().toString().c_str());
 
-      vTaskDelay(pdMS_TO_TICKS(5000));
+      // v1.3.3: Ends early when failover brings up another interface
+      networkManager->waitForModeChange(networkGeneration, 5000);
       continue;
     } else if (!networkWasAvailable) {
       LOG_NET_INFO("[HTTP] Network available | Mode: %s | IP: %s\n",
@@ -135,7 +230,7 @@ void HttpManager::httpLoop() {
   vTaskDelete(NULL);     // Delete self (NULL = current task)
 }
 
-bool HttpManager::sendHttpRequest(const JsonObject& data) {
+bool HttpManager::readyToSend() {
   if (endpointUrl.isEmpty()) {
     LOG_NET_INFO("[HTTP] No endpoint URL configured");
     return false;
@@ -148,78 +243,163 @@ bool HttpManager::sendHttpRequest(const JsonObject& data) {
     LOG_NET_INFO("[HTTP] No active network client available.");
     return false;
   }
+  return true;
+}
 
-  HTTPClient httpClient;          // Create local instance
-  httpClient.begin(endpointUrl);  // Let HTTPClient manage the client internally
-  httpClient.setTimeout(timeout);
-
-  // Set headers from configuration
-  JsonDocument configDoc;
-  JsonObject httpConfig = configDoc.to<JsonObject>();
+bool HttpManager::sendHttpRequest(JsonVariant body) {
+  if (!readyToSend()) {
+    return false;
+  }
 
-  if (serverConfig->getHttpConfig(httpConfig)) {
-    JsonObject configHeaders = httpConfig["headers"];
-    for (JsonPair header : configHeaders) {
-      httpClient.addHeader(header.key().c_str(), header.value().as<String>());
-      LOG_NET_INFO("[HTTP] Header: %s = %s\n", header.key().c_str(),
-                   header.value().as<String>().c_str());
+  // v1.3.3: Serialize once into a PSRAM buffer (batch bodies can be tens of
+  // KB, too large for a DRAM String), in the configured payload_format
+  size_t payloadLength = measurePayload(body, payloadFormat);
+  uint8_t* payload = nullptr;
+  bool gzipped = false;
+  if (gzipBody && payloadLength >= GZIP_MIN_BODY_SIZE) {
+    // v1.3.3: Compressed while serializing; falls back to the plain body
+    size_t compressedLength = 0;
+    payload = gzipPayload(body, payloadLength, compressedLength);
+    if (payload) {
+      gzipInputBytes += payloadLength;
+      gzipOutputBytes += compressedLength;
+      payloadLength = compressedLength;
+      gzipped = true;
     }
   }
+  if (!payload) {
+    payload = (uint8_t*)heap_caps_malloc(payloadLength + 1,
+                                         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!payload) {
+      payload = (uint8_t*)heap_caps_malloc(payloadLength + 1, MALLOC_CAP_8BIT);
+    }
+    if (!payload) {
+      LOG_NET_INFO("[HTTP] ERROR: Failed to allocate %u bytes for payload\n",
+                   payloadLength + 1);
+      return false;
+    }
+    serializePayload(body, payloadFormat, payload, payloadLength + 1);
+  }
 
-  // Default headers
-  httpClient.addHeader("Content-Type", "application/json");
-
-  // Prepare payload
-  String payload;
-  serializeJson(data, payload);
+  bool success = sendBody(payload, payloadLength, gzipped);
+  heap_caps_free(payload);
+  return success;
+}
 
+bool HttpManager::sendBody(const uint8_t* payload, size_t payloadLength,
+                           bool gzipped) {
+  // HTTPClient takes a mutable pointer but only reads the body
+  uint8_t* body = const_cast<uint8_t*>(payload);
   int httpResponseCode = -1;
   int attempts = 0;
+  bool success = false;
 
   while (attempts < retryCount && httpResponseCode < 0) {
     attempts++;
 
+    // v1.3.3: begin() per request is required by HTTPClient, but with
+    // setReuse(true) the TCP/TLS connection of the previous request is kept
+    // (no new handshake while the server keeps the connection alive)
+    httpClient.begin(endpointUrl);
+    httpClient.setReuse(true);
+    httpClient.setTimeout(timeout);
+
+    // Set headers from cached configuration
+    for (const HttpHeader& header : cachedHeaders) {
+      httpClient.addHeader(header.name, header.value);
+    }
+
+    // Default headers
+    if (!hasContentTypeHeader) {
+      httpClient.addHeader("Content-Type", payloadContentType(payloadFormat));
+    }
+    if (gzipped) {
+      httpClient.addHeader("Content-Encoding", "gzip");
+    }
+
     if (method == "POST") {
-      httpResponseCode = httpClient.POST(payload);
+      httpResponseCode = httpClient.POST(body, payloadLength);
     } else if (method == "PUT") {
-      httpResponseCode = httpClient.PUT(payload);
+      httpResponseCode = httpClient.PUT(body, payloadLength);
     } else if (method == "PATCH") {
-      httpResponseCode = httpClient.PATCH(payload);
+      httpResponseCode = httpClient.PATCH(body, payloadLength);
     } else {
       LOG_NET_INFO("[HTTP] Unsupported method: %s\n", method.c_str());
       httpClient.end();
-      return false;
+      break;
     }
 
     if (httpResponseCode > 0) {
       LOG_NET_INFO("[HTTP] Response code: %d\n", httpResponseCode);
 
+      // Body is always read so the connection can be reused
+      String response = httpClient.getString();
       if (httpResponseCode >= 200 && httpResponseCode < 300) {
-        String response = httpClient.getString();
         LOG_NET_INFO("[HTTP] Success: %s\n", response.c_str());
-        httpClient.end();
-        if (ledManager) {
-          ledManager->notifyDataTransmission();
-        }
-        return true;
+        success = true;
       } else {
-        String response = httpClient.getString();
         LOG_NET_INFO("[HTTP] Error response: %s\n", response.c_str());
       }
     } else {
       LOG_NET_INFO("[HTTP] Request failed, error: %s\n",
                    httpClient.errorToString(httpResponseCode).c_str());
     }
+    httpClient.end();  // Keeps the connection open (reuse)
 
-    if (attempts < retryCount) {
+    if (!success && attempts < retryCount && httpResponseCode < 0) {
       LOG_NET_INFO("[HTTP] Retrying in 2 seconds... (attempt %d/%d)\n",
                    attempts + 1, retryCount);
       vTaskDelay(pdMS_TO_TICKS(2000));
     }
   }
 
-  httpClient.end();
-  return false;
+  if (success && ledManager) {
+    ledManager->notifyDataTransmission();
+  }
+  return success;
+}
+
+// v1.3.3: Body in payload_format, gzip-compressed into a PSRAM buffer
+// (caller frees it with heap_caps_free); nullptr if memory ran out
+uint8_t* HttpManager::gzipPayload(JsonVariant body, size_t bodyLength,
+                                  size_t& compressedLength) {
+  GzipEncoder encoder;
+  GzipBodyBuffer compressed(bodyLength / 4 + 64);  // Grows if needed
+  if (!compressed.ok() || !encoder.begin(compressed)) {
+    LOG_NET_INFO("[HTTP] gzip unavailable (no memory), sending uncompressed");
+    return nullptr;
+  }
+  serializePayload(body, payloadFormat, encoder);
+  encoder.finish();
+  if (!compressed.ok()) {
+    LOG_NET_INFO("[HTTP] gzip buffer full, sending uncompressed");
+    return nullptr;
+  }
+
+  compressedLength = compressed.size();
+  LOG_NET_DEBUG("[HTTP] gzip body: %u -> %u bytes\n", bodyLength,
+                compressedLength);
+  return compressed.release();
+}
+
+// v1.3.3: Same for an already encoded body (shared cycle payload)
+uint8_t* HttpManager::gzipPayload(const uint8_t* body, size_t bodyLength,
+                                  size_t& compressedLength) {
+  GzipEncoder encoder;
+  GzipBodyBuffer compressed(bodyLength / 4 + 64);
+  if (!compressed.ok() || !encoder.begin(compressed)) {
+    LOG_NET_INFO("[HTTP] gzip unavailable (no memory), sending uncompressed");
+    return nullptr;
+  }
+  encoder.write(body, bodyLength);
+  encoder.finish();
+  if (!compressed.ok()) {
+    LOG_NET_INFO("[HTTP] gzip buffer full, sending uncompressed");
+    return nullptr;
+  }
+
+  compressedLength = compressed.size();
+  return compressed.release();
 }
 
 void HttpManager::loadHttpConfig() {
@@ -241,19 +421,63 @@ void HttpManager::loadHttpConfig() {
                          // false assumption
     method = httpConfig["method"] | "POST";
     bodyFormat = httpConfig["body_format"] | "json";
+    payloadFormat = PayloadFormat::JSON;
+    parsePayloadFormat(httpConfig["payload_format"] | "json", payloadFormat);
     timeout = httpConfig["timeout"] | 10000;
     retryCount = httpConfig["retry"] | 3;
+    batchSize = constrain((int)(httpConfig["batch_size"] | 1), 1,
+                          MAX_BATCH_SIZE);
+    // v1.3.3: "none" (default) or "gzip" (Content-Encoding: gzip)
+    String compression = httpConfig["compression"] | "none";
+    gzipBody = compression.equalsIgnoreCase("gzip");
+    // v1.3.3: "points" (default, data points from the queue) or "cycle"
+    // (the MQTT default-mode payload of each publish cycle)
+    String layout = httpConfig["layout"] | "points";
+    cycleLayout = layout.equalsIgnoreCase("cycle");
+
+    // v1.3.3: Cache headers once (previously re-read and logged per request)
+    cachedHeaders.clear();
+    hasContentTypeHeader = false;
+    JsonObject configHeaders = httpConfig["headers"];
+    for (JsonPair header : configHeaders) {
+      // v1.3.3: The stock "application/json" header would mislabel a binary
+      // body; leave Content-Type to the payload format then
+      if (payloadFormat != PayloadFormat::JSON &&
+          strcasecmp(header.key().c_str(), "Content-Type") == 0 &&
+          header.value().as<String>().equalsIgnoreCase("application/json")) {
+        continue;
+      }
+      // v1.3.3: Content-Encoding follows the compression setting
+      if (strcasecmp(header.key().c_str(), "Content-Encoding") == 0) {
+        continue;
+      }
+      cachedHeaders.push_back(
+          {String(header.key().c_str()), header.value().as<String>()});
+      if (strcasecmp(header.key().c_str(), "Content-Type") == 0) {
+        hasContentTypeHeader = true;
+      }
+      LOG_NET_INFO("[HTTP] Header: %s = %s\n", header.key().c_str(),
+                   header.value().as<String>().c_str());
+    }
 
     LOG_NET_INFO(
         "[HTTP] Config loaded | URL: %s | Method: %s | Timeout: %d | Retry: "
-        "%d\n",
-        endpointUrl.c_str(), method.c_str(), timeout, retryCount);
+        "%d | Batch: %d | Format: %s | Compression: %s | Layout: %s\n",
+        endpointUrl.c_str(), method.c_str(), timeout, retryCount, batchSize,
+        payloadFormatName(payloadFormat), gzipBody ? "gzip" : "none",
+        cycleLayout ? "cycle" : "points");
   } else {
     LOG_NET_INFO("[HTTP] Failed to load HTTP config");
     endpointUrl = "";
     method = "POST";
     timeout = 10000;
     retryCount = 3;
+    batchSize = 1;
+    gzipBody = false;
+    cycleLayout = false;
+    payloadFormat = PayloadFormat::JSON;
+    cachedHeaders.clear();
+    hasContentTypeHeader = false;
   }
 
   // Load data transmission interval from http_config (v2.2.0+)
@@ -298,42 +522,67 @@ void HttpManager::publishQueueData() {
     return;
   }
 
-  // Interval has elapsed, ready to publish
-  //  Only dequeue and publish ONE batch of data (all items currently in queue)
+  if (cycleLayout) {
+    publishCycles();
+    return;
+  }
 
-  int sendCount = 0;
+  // v1.3.3: Batched upload. Previous: one POST per data point (max 5 per
+  // cycle, new HTTPClient + config read each time). New: up to batchSize
+  // points per request as a JSON array body (batch_size 1 keeps the single
+  // object body), sent over a kept-alive connection.
+  int requestCount = 0;
   bool anySent = false;
 
-  // Process all available items in queue this cycle
-  while (sendCount < 5) {  // Limit to 5 per call to avoid blocking
-    JsonDocument dataDoc;
-    JsonObject dataPoint = dataDoc.to<JsonObject>();
+  // v1.3.3: Under memory pressure drain the queue in fewer, larger requests
+  // (fewer TLS / HTTPClient buffer cycles). The arena is sized for
+  // MAX_BATCH_SIZE, so a larger batch allocates nothing. batch_size 1 keeps
+  // its single-object body format.
+  int cycleBatchSize = batchSize;
+  if (batchSize > 1) {
+    int scaled = batchSize * (int)MemoryRecovery::backpressureFactor();
+    cycleBatchSize = min(scaled, MAX_BATCH_SIZE);
+  }
+
+  while (requestCount < MAX_REQUESTS_PER_CYCLE) {
+    // v1.3.3: Points and their strings bumped out of one arena (the previous
+    // batch document is gone here)
+    batchArena.reset();
+    SpiRamJsonDocument batchDoc(&batchArena);
+    JsonArray dataPoints = batchDoc.to<JsonArray>();
 
     // v2.5.1 FIX: Use peek-then-dequeue pattern to prevent data loss
-    // Previous: dequeue first, then re-enqueue on failure (data lost if queue
-    // full) New: peek first to validate, only dequeue after successful send
-    if (!queueManager->peek(dataPoint)) {
+    // v1.3.3: The whole batch stays in the queue until a 2xx response
+    QueueBatch batch;
+    // v1.3.3: JSON bodies carry fixed-decimal values (NumberFormat)
+    int pointCount =
+        queueManager->peekBatch(QueueConsumer::HTTP, dataPoints, cycleBatchSize,
+                                batch, payloadFormat == PayloadFormat::JSON);
+    if (pointCount == 0) {
       break;  // No more data in queue
     }
 
     // Send HTTP request
-    if (sendHttpRequest(dataPoint)) {
+    JsonVariant body =
+        (batchSize == 1) ? dataPoints[0] : batchDoc.as<JsonVariant>();
+    if (sendHttpRequest(body)) {
       // v2.5.1 FIX: Only remove from queue AFTER successful send
-      // This ensures data is never lost (stays in queue if send fails)
-      JsonDocument tempDoc;
-      JsonObject tempPoint = tempDoc.to<JsonObject>();
-      queueManager->dequeue(tempPoint);  // Now safe to remove
+      queueManager->commitBatch(QueueConsumer::HTTP, batch);
 
-      LOG_NET_INFO("[HTTP] Data sent successfully (Batch @ %lu ms)\n", now);
+      LOG_NET_INFO(
+          "[HTTP] %d data points sent successfully (Batch @ %lu ms)\n",
+          pointCount, now);
       anySent = true;
-      sendCount++;
+      requestCount++;
     } else {
       // v2.5.1 FIX: Data remains in queue (not dequeued), will retry next cycle
-      LOG_NET_INFO("[HTTP] Failed to send data, keeping in queue for retry\n");
+      LOG_NET_INFO(
+          "[HTTP] Failed to send %d data points, keeping in queue for retry\n",
+          pointCount);
       break;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(100));  // Small delay between requests
+    vTaskDelay(pdMS_TO_TICKS(10));  // Yield between requests
   }
 
   // Update transmission timestamp after successful send cycle
@@ -343,6 +592,92 @@ void HttpManager::publishQueueData() {
   }
 }
 
+/**
+ * v1.3.3: layout "cycle" - send every cycle payload published since the
+ * last 2xx, one request each, oldest first. The body is the payload MQTT
+ * encoded for this format (gzip is applied to the encoded bytes). A failed
+ * request keeps the cursor, so the cycle is retried next interval while it
+ * is still retained.
+ */
+void HttpManager::publishCycles() {
+  if (!cycleSubscribed) {
+    return;
+  }
+  CyclePayloadStore* store = CyclePayloadStore::getInstance();
+  int requestCount = 0;
+
+  while (requestCount < MAX_REQUESTS_PER_CYCLE) {
+    uint32_t skipped = 0;
+    CyclePayload* cycle = store->next(cycleCursor, cycleFormat, skipped);
+    if (!cycle) {
+      break;  // No newer cycle
+    }
+    if (skipped > 0) {
+      cyclesSkipped += skipped;
+      LOG_NET_INFO("[HTTP] %lu cycles dropped before they were sent\n",
+                   (unsigned long)skipped);
+    }
+
+    bool sent = false;
+    if (readyToSend()) {
+      uint8_t* compressed = nullptr;
+      size_t compressedLength = 0;
+      if (gzipBody && cycle->length >= GZIP_MIN_BODY_SIZE) {
+        compressed =
+            gzipPayload(cycle->data(), cycle->length, compressedLength);
+      }
+      if (compressed) {
+        gzipInputBytes += cycle->length;
+        gzipOutputBytes += compressedLength;
+        sent = sendBody(compressed, compressedLength, true);
+        heap_caps_free(compressed);
+      } else {
+        sent = sendBody(cycle->data(), cycle->length, false);
+      }
+    }
+
+    uint32_t sequence = cycle->sequence;
+    store->release(cycle);
+    if (!sent) {
+      LOG_NET_INFO("[HTTP] Failed to send cycle %lu, retrying next interval\n",
+                   (unsigned long)sequence);
+      break;
+    }
+
+    // Skipped cycles are counted once: the cursor moves past them
+    cycleCursor = sequence;
+    cyclesSent++;
+    requestCount++;
+    LOG_NET_INFO("[HTTP] Cycle %lu sent\n", (unsigned long)sequence);
+    vTaskDelay(pdMS_TO_TICKS(10));  // Yield between requests
+  }
+
+  if (requestCount > 0) {
+    lastDataTransmission = millis();
+  }
+}
+
+void HttpManager::subscribeCycles() {
+  if (cycleSubscribed) {
+    return;
+  }
+  CyclePayloadStore* store = CyclePayloadStore::getInstance();
+  cycleFormat = payloadFormat;
+  cycleCursor = store->latestSequence();  // From the next cycle on
+  store->subscribe(cycleFormat);
+  cycleSubscribed = true;
+  LOG_NET_INFO("[HTTP] Sending MQTT default-mode cycles (%s)\n",
+               payloadFormatName(cycleFormat));
+}
+
+void HttpManager::unsubscribeCycles() {
+  if (!cycleSubscribed) {
+    return;
+  }
+  CyclePayloadStore::getInstance()->unsubscribe(cycleFormat);
+  cycleSubscribed = false;
+}
+
 bool HttpManager::isNetworkAvailable() {
   if (!networkManager) return false;
 
@@ -390,7 +725,23 @@ void HttpManager::getStatus(JsonObject& status) {
   status["method"] = method;
   status["timeout"] = timeout;
   status["retry_count"] = retryCount;
-  status["queue_size"] = queueManager->size();
+  status["batch_size"] = batchSize;
+  // v1.3.3: gzip bodies (ratio of the bytes compressed so far)
+  status["compression"] = gzipBody ? "gzip" : "none";
+  status["compression_ratio"] =
+      (gzipOutputBytes > 0) ? (float)gzipInputBytes / gzipOutputBytes : 0.0f;
+  status["queue_size"] = queueManager->size(QueueConsumer::HTTP);
+  // v1.3.3: Shared MQTT cycle payloads (layout "cycle")
+  status["layout"] = cycleLayout ? "cycle" : "points";
+  if (cycleLayout) {
+    CyclePayloadStore* store = CyclePayloadStore::getInstance();
+    JsonObject cycles = status["cycles"].to<JsonObject>();
+    cycles["sent"] = cyclesSent;
+    cycles["skipped"] = cyclesSkipped;
+    cycles["pending"] =
+        cycleSubscribed ? store->latestSequence() - cycleCursor : 0;
+    store->getStatus(cycles);
+  }
   status["data_interval_ms"] =
       dataIntervalMs;  // Include current data interval in status
 }
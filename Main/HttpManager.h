@@ -5,9 +5,14 @@
 #include <HTTPClient.h>
 #include <WiFi.h>
 
+#include <vector>
+
 #include "ConfigManager.h"
+#include "CyclePayload.h"  // v1.3.3: layout "cycle" (shared payloads)
+#include "GzipEncoder.h"  // v1.3.3: Content-Encoding: gzip bodies
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
 #include "NetworkManager.h"
+#include "PayloadFormat.h"  // v1.3.3: json / msgpack / cbor bodies
 #include "QueueManager.h"
 #include "ServerConfig.h"
 
@@ -21,14 +26,46 @@ class HttpManager {
   bool running;
   TaskHandle_t taskHandle;
 
+  // v1.3.3: One client for the task lifetime (HTTP keep-alive). Headers are
+  // cached by loadHttpConfig() instead of re-read from ServerConfig per POST.
+  HTTPClient httpClient;
+  struct HttpHeader {
+    String name;
+    String value;
+  };
+  std::vector<HttpHeader> cachedHeaders;
+  bool hasContentTypeHeader;
+
   String endpointUrl;
   String method;
-  JsonObject headers;
   String bodyFormat;
+  PayloadFormat payloadFormat;  // v1.3.3: http_config.payload_format
   int timeout;
   int retryCount;
+  int batchSize;  // v1.3.3: Data points per request (1 = single object body)
+  bool gzipBody;  // v1.3.3: http_config.compression == "gzip"
+  uint32_t gzipInputBytes;   // v1.3.3: Body bytes before / after gzip
+  uint32_t gzipOutputBytes;  // (status compression_ratio)
+  // v1.3.3: http_config.layout "cycle" - MQTT default-mode cycle payloads
+  // (CyclePayloadStore) instead of data points from the queue
+  bool cycleLayout;
+  bool cycleSubscribed;       // Subscribed to the store in cycleFormat
+  PayloadFormat cycleFormat;  // payloadFormat when subscribed
+  uint32_t cycleCursor;       // Last cycle sent (2xx)
+  uint32_t cyclesSent;
+  uint32_t cyclesSkipped;  // Overwritten in the store before they were sent
   unsigned long lastSendAttempt;
 
+  static constexpr int MAX_BATCH_SIZE = 100;  // http_config.batch_size limit
+  static constexpr int MAX_REQUESTS_PER_CYCLE =
+      10;  // Per transmission interval (keeps the task responsive)
+  static constexpr size_t BATCH_ARENA_SIZE =
+      32768;  // v1.3.3: One request document (up to MAX_BATCH_SIZE points)
+  ArduinoJson::ArenaAllocator batchArena;  // Reset before each batch
+  // v1.3.3: Bodies below this size are sent uncompressed (the gzip framing
+  // costs 18 bytes, short bodies barely compress)
+  static constexpr size_t GZIP_MIN_BODY_SIZE = 256;
+
   // Level 3: Server data transmission interval control
   unsigned long lastDataTransmission;  // Last time data was transmitted
   uint32_t dataIntervalMs;  // Data transmission interval in milliseconds
@@ -38,9 +75,19 @@ class HttpManager {
 
   static void httpTask(void* parameter);
   void httpLoop();
-  bool sendHttpRequest(const JsonObject& data);
+  bool sendHttpRequest(JsonVariant body);
+  bool readyToSend();
+  // v1.3.3: Encoded body (gzipped = Content-Encoding: gzip) with retries
+  bool sendBody(const uint8_t* payload, size_t length, bool gzipped);
+  uint8_t* gzipPayload(JsonVariant body, size_t bodyLength,
+                       size_t& compressedLength);
+  uint8_t* gzipPayload(const uint8_t* body, size_t bodyLength,
+                       size_t& compressedLength);
   void loadHttpConfig();
   void publishQueueData();
+  void publishCycles();  // v1.3.3: layout "cycle"
+  void subscribeCycles();
+  void unsubscribeCycles();
   void debugNetworkConnectivity();
   bool isNetworkAvailable();
 
@@ -86,6 +86,148 @@ class PSRAMAllocator : public Allocator {
   PSRAMAllocator() = default;
 };
 
+/*
+ * v1.3.3: Bump/arena allocator for short-lived documents
+ *
+ * Previous: each document of a poll or publish cycle went through
+ * PSRAMAllocator, i.e. one heap_caps_malloc/free per variant pool and per
+ * copied string (device ids, register names, units) - hundreds of small
+ * allocations per cycle.
+ * New: allocations are bumped out of one PSRAM block that the owner resets
+ * once per cycle (device poll, publish cycle), after its documents are gone.
+ * deallocate() of the newest block and reallocate() of the newest block
+ * (string building, shrinkToFit) work in place; anything else is released
+ * at reset(). Requests beyond the block go to PSRAMAllocator (counted).
+ *
+ * Not thread-safe: one arena per task.
+ *
+ * USAGE:
+ *   SpiRamJsonDocument doc(&arena);   // Doc must not outlive the cycle
+ *   ...
+ *   arena.reset();                    // After all docs are destroyed
+ */
+class ArenaAllocator : public Allocator {
+ public:
+  explicit ArenaAllocator(size_t capacity)
+      : block(nullptr),
+        capacity(capacity),
+        top(0),
+        lastOffset(NO_BLOCK),
+        liveCount(0),
+        peakUsed(0),
+        overflowCount(0) {}
+
+  ~ArenaAllocator() {
+    if (block) {
+      heap_caps_free(block);
+    }
+  }
+
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  void* allocate(size_t size) override {
+    if (!block) {
+      // First use: reserve the block (PSRAM only - never takes DRAM)
+      block = (uint8_t*)heap_caps_malloc(capacity,
+                                         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    size_t need = HEADER_SIZE + align(size);
+    liveCount++;
+    if (block && top + need <= capacity) {
+      *(uint32_t*)(block + top) = (uint32_t)size;
+      lastOffset = top;
+      top += need;
+      if (top > peakUsed) peakUsed = top;
+      return block + lastOffset + HEADER_SIZE;
+    }
+    overflowCount++;
+    return PSRAMAllocator::instance()->allocate(size);
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    if (liveCount > 0) liveCount--;
+    if (!owns(ptr)) {
+      PSRAMAllocator::instance()->deallocate(ptr);
+      return;
+    }
+    if (isLast(ptr)) {
+      top = lastOffset;  // Newest block: give the space back now
+      lastOffset = NO_BLOCK;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t new_size) override {
+    if (!ptr) return allocate(new_size);
+    if (new_size == 0) {
+      deallocate(ptr);
+      return nullptr;
+    }
+    if (!owns(ptr)) {
+      return PSRAMAllocator::instance()->reallocate(ptr, new_size);
+    }
+
+    size_t oldSize = *(uint32_t*)((uint8_t*)ptr - HEADER_SIZE);
+    if (isLast(ptr) &&
+        lastOffset + HEADER_SIZE + align(new_size) <= capacity) {
+      // Newest block grows/shrinks in place
+      *(uint32_t*)(block + lastOffset) = (uint32_t)new_size;
+      top = lastOffset + HEADER_SIZE + align(new_size);
+      if (top > peakUsed) peakUsed = top;
+      return ptr;
+    }
+
+    void* newPtr = allocate(new_size);
+    if (newPtr) {
+      memcpy(newPtr, ptr, (oldSize < new_size) ? oldSize : new_size);
+    }
+    deallocate(ptr);
+    return newPtr;
+  }
+
+  /**
+   * Start a new cycle (all blocks released at once)
+   * @return false if a document still holds arena memory (nothing reset)
+   */
+  bool reset() {
+    if (liveCount > 0) {
+      return false;
+    }
+    top = 0;
+    lastOffset = NO_BLOCK;
+    return true;
+  }
+
+  size_t getUsed() const { return top; }
+  size_t getPeakUsed() const { return peakUsed; }
+  size_t getCapacity() const { return capacity; }
+  uint32_t getOverflowCount() const { return overflowCount; }
+
+ private:
+  static constexpr size_t HEADER_SIZE = 8;  // Block size (keeps 8-alignment)
+  static constexpr size_t NO_BLOCK = (size_t)-1;
+
+  uint8_t* block;
+  size_t capacity;
+  size_t top;         // Bump offset
+  size_t lastOffset;  // Header of the newest block (NO_BLOCK if released)
+  uint32_t liveCount;  // Blocks handed out and not deallocated
+  size_t peakUsed;
+  uint32_t overflowCount;
+
+  static size_t align(size_t size) { return (size + 7) & ~(size_t)7; }
+
+  bool owns(void* ptr) const {
+    return block && (uint8_t*)ptr >= block && (uint8_t*)ptr < block + capacity;
+  }
+
+  bool isLast(void* ptr) const {
+    return lastOffset != NO_BLOCK &&
+           (uint8_t*)ptr == block + lastOffset + HEADER_SIZE;
+  }
+};
+
 }  // namespace ArduinoJson
 
 // Wrapper class that uses PSRAM allocator by default
@@ -94,6 +236,10 @@ class SpiRamJsonDocument : public ArduinoJson::JsonDocument {
   SpiRamJsonDocument()
       : ArduinoJson::JsonDocument(ArduinoJson::PSRAMAllocator::instance()) {}
 
+  // v1.3.3: Other allocator (e.g. a per-cycle ArenaAllocator)
+  explicit SpiRamJsonDocument(ArduinoJson::Allocator* allocator)
+      : ArduinoJson::JsonDocument(allocator) {}
+
   // Copy constructor
   SpiRamJsonDocument(const SpiRamJsonDocument& src)
       : ArduinoJson::JsonDocument(ArduinoJson::PSRAMAllocator::instance()) {
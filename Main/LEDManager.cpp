@@ -1,6 +1,7 @@
 #include "LEDManager.h"
 
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 LEDManager* LEDManager::instance = nullptr;
 
@@ -39,14 +40,11 @@ void LEDManager::begin() {
   // OPTIMIZATION: Moved to Core 0 to balance load (low-priority task)
   // v2.5.39: Increased stack from 2048 to 3072 to prevent stack overflow
   // (LOG_LED_INFO with printf formatting requires more stack space)
-  xTaskCreatePinnedToCore(
+  // v1.3.3: Priority (low but higher than 0) and core from TaskAffinity.h
+  TaskAffinity::create(
       ledBlinkTask, "LED_Blink_Task",
       3072,  // Stack size (v2.5.39: increased from 2048 to prevent overflow)
-      this,
-      1,  // Priority (low but higher than 0)
-      &ledTaskHandle,
-      0  // Core 0 (moved from Core 1 for load balancing)
-  );
+      this, TaskAffinity::Task::LED_BLINK, &ledTaskHandle);
   LOG_LED_INFO("[LED] Manager initialized");
 }
 
@@ -0,0 +1,414 @@
+#include "LogSink.h"
+
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+
+#include "DebugConfig.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+
+LogSink* LogSink::instance = nullptr;
+
+LogSink::LogSink()
+    : slots(nullptr),
+      enqueuePos(0),
+      dequeuePos(0),
+      droppedCount(0),
+      reportedDrops(0),
+      writtenCount(0),
+      highWater(0),
+      running(false),
+      drainMutex(nullptr),
+      drainTaskHandle(nullptr) {
+  for (uint16_t i = 0; i < SLOT_COUNT; i++) {
+    sequence[i].store(i, std::memory_order_relaxed);
+  }
+}
+
+LogSink* LogSink::getInstance() {
+  if (!instance) {
+    instance = new LogSink();
+  }
+  return instance;
+}
+
+bool LogSink::begin() {
+  if (running) {
+    return true;
+  }
+
+  slots = (Record*)heap_caps_malloc(sizeof(Record) * SLOT_COUNT,
+                                    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!slots) {
+    slots = (Record*)heap_caps_malloc(sizeof(Record) * SLOT_COUNT,
+                                      MALLOC_CAP_8BIT);
+  }
+  drainMutex = xSemaphoreCreateMutex();
+  if (!slots || !drainMutex) {
+    Serial.println("[LOG] Log ring allocation failed, logging synchronously");
+    return false;
+  }
+
+  BaseType_t result =
+      TaskAffinity::create(drainTask, "LOG_DRAIN_TASK", 4096, this,
+                           TaskAffinity::Task::LOG_DRAIN, &drainTaskHandle);
+  if (result != pdPASS) {
+    Serial.println("[LOG] Log drain task failed, logging synchronously");
+    return false;
+  }
+
+  // ESP.restart(): write what is still queued
+  esp_register_shutdown_handler(shutdownHandler);
+
+  running = true;
+  Serial.printf("[LOG] Async log sink started (%u slots, %u byte args)\n",
+                SLOT_COUNT, PAYLOAD_SIZE);
+  return true;
+}
+
+bool LogSink::reserve(uint32_t& ticket, Record*& record) {
+  uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+  while (true) {
+    uint32_t seq =
+        sequence[pos & (SLOT_COUNT - 1)].load(std::memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+  ticket = pos;
+  record = &slots[pos & (SLOT_COUNT - 1)];
+  return true;
+}
+
+void LogSink::commit(uint32_t ticket) {
+  sequence[ticket & (SLOT_COUNT - 1)].store(ticket + 1,
+                                            std::memory_order_release);
+}
+
+uint16_t LogSink::drain() {
+  uint16_t count = 0;
+  uint32_t pending =
+      enqueuePos.load(std::memory_order_relaxed) - dequeuePos;
+  if (pending > highWater) {
+    highWater = (uint16_t)min(pending, (uint32_t)SLOT_COUNT);
+  }
+
+  while (true) {
+    uint32_t slot = dequeuePos & (SLOT_COUNT - 1);
+    if (sequence[slot].load(std::memory_order_acquire) != dequeuePos + 1) {
+      break;  // Empty, or the next slot is still being written
+    }
+    writeNow(slots[slot]);
+    sequence[slot].store(dequeuePos + SLOT_COUNT, std::memory_order_release);
+    dequeuePos++;
+    writtenCount++;
+    count++;
+  }
+
+  uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+  if (dropped != reportedDrops) {
+    Serial.printf("[LOG] %lu log lines dropped (ring full)\n",
+                  (unsigned long)(dropped - reportedDrops));
+    reportedDrops = dropped;
+  }
+  return count;
+}
+
+void LogSink::flush(uint32_t timeoutMs) {
+  if (!running) {
+    return;
+  }
+  if (xSemaphoreTake(drainMutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) {
+    drain();
+    xSemaphoreGive(drainMutex);
+  }
+  Serial.flush();
+}
+
+void LogSink::drainTask(void* parameter) {
+  LogSink* sink = static_cast<LogSink*>(parameter);
+  while (true) {
+    if (xSemaphoreTake(sink->drainMutex, portMAX_DELAY) == pdTRUE) {
+      sink->drain();
+      xSemaphoreGive(sink->drainMutex);
+    }
+    vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL_MS));
+  }
+}
+
+void LogSink::shutdownHandler() {
+  if (instance) {
+    instance->flush(100);
+  }
+}
+
+void LogSink::writeNow(const Record& record) {
+  char line[LINE_SIZE];
+  size_t length = formatRecord(record, line, sizeof(line));
+  Serial.write((const uint8_t*)line, length);
+}
+
+// ============================================
+// ARGUMENT ENCODING
+// ============================================
+
+bool LogSink::putBytes(Record& record, ArgType type, const void* data,
+                       size_t size) {
+  if (record.truncated || record.length + 1 + size > PAYLOAD_SIZE) {
+    record.truncated = true;
+    return false;
+  }
+  record.payload[record.length++] = type;
+  memcpy(record.payload + record.length, data, size);
+  record.length += size;
+  return true;
+}
+
+void LogSink::putString(Record& record, const char* value) {
+  if (!value) {
+    value = "(null)";
+  }
+  // Tag + length byte + text + NUL; a long string takes what is left
+  if (record.truncated || record.length + 3 > PAYLOAD_SIZE) {
+    record.truncated = true;
+    return;
+  }
+  size_t room = min((size_t)(PAYLOAD_SIZE - record.length - 3), (size_t)255);
+  size_t size = strnlen(value, room);
+  if (size == room && value[size] != '\0') {
+    record.truncated = true;
+  }
+  record.payload[record.length++] = ARG_STRING;
+  record.payload[record.length++] = (uint8_t)size;
+  memcpy(record.payload + record.length, value, size);
+  record.length += size;
+  record.payload[record.length++] = '\0';
+}
+
+// ============================================
+// DEFERRED FORMATTING (drain task)
+// ============================================
+
+namespace {
+
+// Reads the arguments of one record back in call order
+class ArgReader {
+ public:
+  explicit ArgReader(const LogSink::Record& record)
+      : record(record), pos(0) {}
+
+  // Next argument as the conversion expects it; false when none is left
+  bool next(uint8_t& type, const uint8_t*& data, uint8_t& size) {
+    if (pos >= record.length) {
+      return false;
+    }
+    type = record.payload[pos++];
+    switch (type) {
+      case LogSink::ARG_STRING:
+        size = record.payload[pos++] + 1;  // Text + NUL
+        break;
+      case LogSink::ARG_INT32:
+      case LogSink::ARG_UINT32:
+        size = 4;
+        break;
+      case LogSink::ARG_POINTER:
+        size = sizeof(void*);
+        break;
+      default:
+        size = 8;
+        break;
+    }
+    data = record.payload + pos;
+    pos += size;
+    return true;
+  }
+
+ private:
+  const LogSink::Record& record;
+  uint8_t pos;
+};
+
+int64_t asSigned(uint8_t type, const uint8_t* data) {
+  switch (type) {
+    case LogSink::ARG_INT32: {
+      int32_t v;
+      memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case LogSink::ARG_UINT32: {
+      uint32_t v;
+      memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case LogSink::ARG_INT64:
+    case LogSink::ARG_UINT64: {
+      int64_t v;
+      memcpy(&v, data, sizeof(v));
+      return v;
+    }
+    case LogSink::ARG_DOUBLE: {
+      double v;
+      memcpy(&v, data, sizeof(v));
+      return (int64_t)v;
+    }
+    case LogSink::ARG_POINTER: {
+      uintptr_t v;
+      memcpy(&v, data, sizeof(v));
+      return (int64_t)v;
+    }
+    default:
+      return 0;
+  }
+}
+
+double asDouble(uint8_t type, const uint8_t* data) {
+  if (type == LogSink::ARG_DOUBLE) {
+    double v;
+    memcpy(&v, data, sizeof(v));
+    return v;
+  }
+  if (type == LogSink::ARG_UINT64) {
+    uint64_t v;
+    memcpy(&v, data, sizeof(v));
+    return (double)v;
+  }
+  return (double)asSigned(type, data);
+}
+
+}  // namespace
+
+size_t LogSink::formatRecord(const Record& record, char* out,
+                             size_t size) const {
+  int used = 0;
+  if (logTimestampsEnabled) {
+    char stamp[24];
+    formatLogTimestamp(stamp, sizeof(stamp), record.timeMs);
+    used = snprintf(out, size, "%s[%s][%s] ", stamp,
+                    getLogLevelName((LogLevel)record.level), record.prefix);
+  } else {
+    used = snprintf(out, size, "[%s][%s] ",
+                    getLogLevelName((LogLevel)record.level), record.prefix);
+  }
+  size_t pos = (used > 0) ? min((size_t)used, size - 1) : 0;
+
+  ArgReader args(record);
+  const char* p = record.format;
+  bool missing = false;
+  while (*p && pos + 1 < size && !missing) {
+    if (*p != '%') {
+      out[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      out[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // Conversion spec: flags, width, precision, length, conversion
+    char spec[32];
+    size_t n = 0;
+    spec[n++] = *p++;
+    char length = 0;
+    while (*p && strchr("-+ #0123456789.*hlLzjt", *p) && n < 16) {
+      if (*p == '*') {  // Width/precision argument
+        uint8_t type, argSize;
+        const uint8_t* data;
+        if (!args.next(type, data, argSize)) {
+          missing = true;
+          break;
+        }
+        int digits = snprintf(spec + n, sizeof(spec) - n, "%d",
+                              (int)asSigned(type, data));
+        n = min(n + (size_t)max(digits, 0), sizeof(spec) - 2);
+        p++;
+        continue;
+      }
+      if (strchr("hlLzjt", *p)) {
+        length = (length == 'l' && *p == 'l') ? 'q' : *p;  // q = ll
+      }
+      spec[n++] = *p++;
+    }
+    char conversion = *p;
+    if (missing || !conversion) {
+      break;
+    }
+    p++;
+    spec[n++] = conversion;
+    spec[n] = '\0';
+
+    uint8_t type, argSize;
+    const uint8_t* data;
+    if (!args.next(type, data, argSize)) {
+      missing = true;
+      break;
+    }
+
+    char* dst = out + pos;
+    size_t room = size - pos;
+    int written = 0;
+    if (conversion == 's') {
+      const char* text =
+          (type == LogSink::ARG_STRING) ? (const char*)data : "?";
+      written = snprintf(dst, room, spec, text);
+    } else if (strchr("fFeEgGaA", conversion)) {
+      if (length == 'L') {
+        written = snprintf(dst, room, spec, (long double)asDouble(type, data));
+      } else {
+        written = snprintf(dst, room, spec, asDouble(type, data));
+      }
+    } else if (conversion == 'p') {
+      written = snprintf(dst, room, spec, (void*)(uintptr_t)asSigned(type, data));
+    } else if (strchr("diouxXc", conversion)) {
+      int64_t v = asSigned(type, data);
+      switch (length) {
+        case 'q':
+        case 'j':
+        case 'L':
+          written = snprintf(dst, room, spec, (long long)v);
+          break;
+        case 'l':
+          written = snprintf(dst, room, spec, (long)v);
+          break;
+        case 'z':
+          written = snprintf(dst, room, spec, (size_t)v);
+          break;
+        case 't':
+          written = snprintf(dst, room, spec, (ptrdiff_t)v);
+          break;
+        default:
+          written = snprintf(dst, room, spec, (int)v);
+          break;
+      }
+    } else {
+      written = snprintf(dst, room, "%s", spec);  // Unknown: print as is
+    }
+    if (written > 0) {
+      pos += min((size_t)written, room - 1);
+    }
+  }
+
+  if (missing || record.truncated) {
+    // Arguments did not fit the record: mark the cut, keep the line break
+    const char* cut = "...\n";
+    size_t cutLen = strlen(cut);
+    if (pos + cutLen >= size) {
+      pos = size - 1 - cutLen;
+    }
+    memcpy(out + pos, cut, cutLen);
+    pos += cutLen;
+  } else if (*p && pos + 1 >= size && size >= 2) {
+    out[size - 2] = '\n';  // Line longer than LINE_SIZE
+    pos = size - 1;
+  }
+  out[pos] = '\0';
+  return pos;
+}
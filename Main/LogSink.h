@@ -0,0 +1,211 @@
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * LogSink - Deferred output for the LOG_* macros (DebugConfig.h)
+ *
+ * v1.3.3: Async, ring-buffered logging
+ * Previous: every LOG_* call built its line with Serial.printf() in the
+ * calling task, i.e. inside the RTU/TCP poll and MQTT publish paths - a
+ * timestamp lookup, printf formatting and a blocking UART write per line
+ * (~1ms for 100 chars at 115200 baud once the TX FIFO is full).
+ * New: the call only copies the format pointer and its arguments into a slot
+ * of a lock-free ring (no mutex, no formatting, no Serial). A low-priority
+ * task formats the slots and writes them to Serial. When the ring is full
+ * the line is dropped and counted; the drain task reports the count.
+ *
+ * Records keep pointers to the format and module prefix (string literals).
+ * %s arguments are copied (the caller's buffer may be gone when the line is
+ * formatted); a line whose arguments do not fit PAYLOAD_SIZE is cut short
+ * and ends with "...".
+ *
+ * Until begin() (and if the ring cannot be allocated) lines are formatted
+ * and written in the calling task, as before.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class LogSink {
+ public:
+  static constexpr uint16_t SLOT_COUNT = 64;  // Power of two
+  static constexpr uint16_t PAYLOAD_SIZE = 176;  // Encoded arguments per line
+  static constexpr uint32_t DRAIN_INTERVAL_MS = 10;
+  static constexpr uint16_t LINE_SIZE = 320;  // Formatted line (drain task)
+
+  // Payload encoding: type tag, then the value (ARG_STRING: length byte,
+  // text and a terminating NUL)
+  enum ArgType : uint8_t {
+    ARG_INT32,
+    ARG_UINT32,
+    ARG_INT64,
+    ARG_UINT64,
+    ARG_DOUBLE,
+    ARG_STRING,
+    ARG_POINTER
+  };
+
+  struct Record {
+    uint32_t timeMs;     // millis() at the LOG_* call
+    const char* prefix;  // Module ("RTU", "MQTT", ...)
+    const char* format;
+    uint8_t level;       // LogLevel
+    uint8_t length;      // Payload bytes used
+    bool truncated;      // Arguments did not fit
+    uint8_t payload[PAYLOAD_SIZE];
+  };
+
+  static LogSink* getInstance();
+
+  bool begin();  // Allocate the ring and start the drain task
+  bool isRunning() const { return running; }
+
+  /**
+   * Queue one line (called by the LOG_* macros via LOG_SINK_WRITE)
+   * Never blocks: a full ring drops the line and counts it.
+   */
+  template <typename... Args>
+  void write(uint8_t level, const char* prefix, const char* format,
+             Args... args) {
+    if (!running) {
+      writeSync(level, prefix, format, args...);
+      return;
+    }
+    uint32_t ticket;
+    Record* record;
+    if (!reserve(ticket, record)) {
+      return;  // Ring full (counted in reserve)
+    }
+    fill(*record, level, prefix, format, args...);
+    commit(ticket);
+  }
+
+  /**
+   * Format and write queued lines in the calling task
+   * Used before a restart (shutdown handler) so the last lines are not lost.
+   */
+  void flush(uint32_t timeoutMs = 500);
+
+  uint32_t getWrittenCount() const { return writtenCount; }
+  uint32_t getDroppedCount() const { return droppedCount.load(); }
+  uint16_t getHighWater() const { return highWater; }
+
+ private:
+  static LogSink* instance;
+
+  Record* slots;  // SLOT_COUNT records (PSRAM when available)
+  std::atomic<uint32_t> sequence[SLOT_COUNT];  // Vyukov bounded queue
+  std::atomic<uint32_t> enqueuePos;
+  uint32_t dequeuePos;  // Single consumer (drain task or flush)
+  std::atomic<uint32_t> droppedCount;
+  uint32_t reportedDrops;
+  uint32_t writtenCount;
+  uint16_t highWater;
+  volatile bool running;
+
+  SemaphoreHandle_t drainMutex;  // Drain task vs flush (consumer side only)
+  TaskHandle_t drainTaskHandle;
+
+  LogSink();
+
+  bool reserve(uint32_t& ticket, Record*& record);
+  void commit(uint32_t ticket);
+  uint16_t drain();
+  void writeNow(const Record& record);
+  size_t formatRecord(const Record& record, char* out, size_t size) const;
+
+  // Before begin(): format in the calling task (kept out of write() so the
+  // queued path does not carry a Record on the caller's stack)
+  template <typename... Args>
+  __attribute__((noinline)) void writeSync(uint8_t level, const char* prefix,
+                                           const char* format, Args... args) {
+    Record local;
+    fill(local, level, prefix, format, args...);
+    writeNow(local);
+  }
+
+  template <typename... Args>
+  static void fill(Record& record, uint8_t level, const char* prefix,
+                   const char* format, Args... args) {
+    record.timeMs = millis();
+    record.prefix = prefix;
+    record.format = format;
+    record.level = level;
+    record.length = 0;
+    record.truncated = false;
+    int expand[] = {0, (put(record, args), 0)...};
+    (void)expand;
+  }
+
+  static void drainTask(void* parameter);
+  static void shutdownHandler();
+
+  // Argument encoding (type tag + value)
+  static bool putBytes(Record& record, ArgType type, const void* data,
+                       size_t size);
+  static void putString(Record& record, const char* value);
+
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value>::type put(
+      Record& record, T value) {
+    if (sizeof(T) <= 4) {
+      if (std::is_signed<T>::value) {
+        int32_t v = (int32_t)value;
+        putBytes(record, ARG_INT32, &v, sizeof(v));
+      } else {
+        uint32_t v = (uint32_t)value;
+        putBytes(record, ARG_UINT32, &v, sizeof(v));
+      }
+    } else if (std::is_signed<T>::value) {
+      int64_t v = (int64_t)value;
+      putBytes(record, ARG_INT64, &v, sizeof(v));
+    } else {
+      uint64_t v = (uint64_t)value;
+      putBytes(record, ARG_UINT64, &v, sizeof(v));
+    }
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_enum<T>::value>::type put(
+      Record& record, T value) {
+    put(record, (typename std::underlying_type<T>::type)value);
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value>::type put(
+      Record& record, T value) {
+    double v = (double)value;
+    putBytes(record, ARG_DOUBLE, &v, sizeof(v));
+  }
+
+  static void put(Record& record, const char* value) {
+    putString(record, value);
+  }
+  static void put(Record& record, char* value) { putString(record, value); }
+
+  template <typename T>
+  static void put(Record& record, T* value) {
+    const void* v = (const void*)value;
+    putBytes(record, ARG_POINTER, &v, sizeof(v));
+  }
+};
+
+// Compile-time printf format checking for the deferred macros (never called)
+inline void logFormatCheck(const char*, ...)
+    __attribute__((format(printf, 1, 2)));
+inline void logFormatCheck(const char*, ...) {}
+
+#define LOG_SINK_WRITE(level, prefix, fmt, ...)                      \
+  do {                                                               \
+    if (false) logFormatCheck(fmt, ##__VA_ARGS__);                   \
+    LogSink::getInstance()->write(level, prefix, fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#endif  // LOG_SINK_H
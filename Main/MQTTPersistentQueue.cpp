@@ -1,6 +1,7 @@
 #include "MQTTPersistentQueue.h"
 
 #include <LittleFS.h>
+#include <esp_heap_caps.h>
 
 #include <algorithm>
 
@@ -10,7 +11,8 @@
 MQTTPersistentQueue* MQTTPersistentQueue::instance = nullptr;
 
 // Private constructor
-MQTTPersistentQueue::MQTTPersistentQueue() {
+MQTTPersistentQueue::MQTTPersistentQueue()
+    : overflowLog(SDCardManager::fileSystem()) {
   LOG_MQTT_INFO("[MQTT_QUEUE] Persistent queue initialized");
   lastProcessTime = millis();
 
@@ -27,18 +29,33 @@ MQTTPersistentQueue::MQTTPersistentQueue() {
     LOG_MQTT_INFO("[MQTT_QUEUE] WARNING: LittleFS initialization failed");
   }
 
-  // Create queue directory
-  File queueDir = LittleFS.open(config.persistenceDir, "r");
-  if (!queueDir) {
-    LittleFS.mkdir(config.persistenceDir);
-    LOG_MQTT_INFO("[MQTT_QUEUE] Created queue directory: %s\n",
-                  config.persistenceDir);
-  } else {
-    queueDir.close();
+  // v1.3.3: Open the segmented log (creates the queue directory) and spool
+  // the oldest unacknowledged messages into RAM
+  if (config.enablePersistence &&
+      queueLog.begin(config.persistenceDir, config.maxPersistenceSize,
+                     config.segmentSize)) {
+    if (config.maxPersistenceSize == 0) {
+      // Log may use the free space (+ its own files), minus a reserve for
+      // config/log files
+      uint32_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+      uint32_t usable = (freeBytes > config.reservedFsBytes)
+                            ? freeBytes - config.reservedFsBytes
+                            : 0;
+      queueLog.setCapacity(usable + queueLog.bytesUsed());
+    }
+    importLegacyFiles();
+    spoolFromLog();
+    // v1.3.3: Backlog of an earlier outage on the SD card (replayed once
+    // connected)
+    if (lockOverflow()) {
+      unlockOverflow();
+      LOG_MQTT_INFO("[MQTT_QUEUE] SD overflow: %ld messages, capacity %ld KB\n",
+                    overflowLog.pendingCount(), overflowLog.capacity() / 1024);
+    }
+    updateStats();
+    LOG_MQTT_INFO("[MQTT_QUEUE] Disk log: %ld messages, capacity %ld KB\n",
+                  queueLog.pendingCount(), queueLog.capacity() / 1024);
   }
-
-  // Load persisted queue from disk
-  loadQueueFromDisk();
 }
 
 // Singleton access
@@ -105,17 +122,6 @@ QueueOperationResult MQTTPersistentQueue::enqueueMessage(
     return QUEUE_INVALID_PAYLOAD;
   }
 
-  // Check queue size limits
-  uint32_t totalMessages = highPriorityQueue.size() +
-                           normalPriorityQueue.size() + lowPriorityQueue.size();
-
-  if (totalMessages >= config.maxQueueSize) {
-    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Queue full (%ld/%ld)\n", totalMessages,
-                  config.maxQueueSize);
-    xSemaphoreGive(queueMutex);
-    return QUEUE_FULL;
-  }
-
   // Create message
   QueuedMessage msg;
   msg.messageId = nextMessageId++;
@@ -138,34 +144,71 @@ QueueOperationResult MQTTPersistentQueue::enqueueMessage(
     return QUEUE_INVALID_TOPIC;
   }
 
-  // Enqueue message
-  targetQueue->push_back(msg);
+  // v1.3.3: One sequential append to the disk log (no JsonDocument, no file
+  // per message). Done under the mutex: the log is not thread-safe and the
+  // append is a single short write (was: JSON file written after unlock).
+  // v1.3.3: Only the replay window is resident (see windowLimit())
+  bool fitsInRam = queuedCount() < windowLimit();
+  MQTTQueueLog* log = &queueLog;
+  if (queueLog.isOpen()) {
+    time_t now = time(nullptr);
+    uint32_t enqueuedUnix = (now > 1600000000) ? (uint32_t)now : 0;
+    msg.persisted = queueLog.append(
+        msg.messageId, (uint8_t)priority, msg.timeoutMs, enqueuedUnix,
+        topic.c_str(), topic.length(), payload.c_str(), payload.length(),
+        msg.logPosition);
+
+    // v1.3.3: LittleFS log full - overflow to the SD card
+    if (!msg.persisted && lockOverflow()) {
+      msg.persisted = overflowLog.append(
+          msg.messageId, (uint8_t)priority, msg.timeoutMs, enqueuedUnix,
+          topic.c_str(), topic.length(), payload.c_str(), payload.length(),
+          msg.logPosition);
+      if (msg.persisted) {
+        log = &overflowLog;
+        msg.overflow = true;
+      } else if (overflowLog.bytesUsed() + payload.length() <
+                 overflowLog.capacity()) {
+        SDCardManager::getInstance()->reportIoError();  // Not a full log
+      }
+      unlockOverflow();
+    }
+    if (!msg.persisted) {
+      LOG_MQTT_INFO("[MQTT_QUEUE] WARNING: Failed to persist message %d\n",
+                    msg.messageId);
+    }
+  }
 
-  // CRITICAL FIX: Release mutex BEFORE File I/O to prevent blocking
-  // This dramatically improves concurrency performance (50-500ms saved)
-  xSemaphoreGive(queueMutex);
+  if (!msg.persisted && !fitsInRam) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Queue full (%ld/%ld)\n",
+                  queuedCount(), windowLimit());
+    xSemaphoreGive(queueMutex);
+    return QUEUE_FULL;
+  }
 
-  // Update statistics (outside mutex - not critical section)
-  // NOTE: Stats updates have potential race condition but acceptable for
-  // monitoring data Stats accuracy is not critical for system functionality
-  stats.totalPayloadSize += payload.length();
   if (payload.length() > stats.largestPayloadSize) {
     stats.largestPayloadSize = payload.length();
   }
-  updateStats();
 
-  // Persist to disk AFTER releasing mutex (deferred write pattern)
-  // Trade-off: If crash occurs between unlock and persist, message is in RAM
-  // but not on disk This is acceptable for significantly improved system
-  // responsiveness
-  if (config.enablePersistence) {
-    QueueOperationResult result = persistMessageToDisk(msg);
-    if (result != QUEUE_SUCCESS) {
-      LOG_MQTT_INFO("[MQTT_QUEUE] WARNING: Failed to persist message %d\n",
-                    msg.messageId);
-    }
+  // Older backlog still on disk: keep log order, message is spooled later
+  if (msg.persisted && !(fitsInRam && log->claim(msg.logPosition,
+                                                  (uint8_t)priority,
+                                                  payload.length()))) {
+    updateStats();
+    xSemaphoreGive(queueMutex);
+    LOG_MQTT_INFO("[MQTT_QUEUE] Message %d queued on %s (%ld waiting)\n",
+                  msg.messageId, msg.overflow ? "SD card" : "disk",
+                  log->unreadCount());
+    return QUEUE_SUCCESS;
   }
 
+  // Enqueue message
+  targetQueue->push_back(msg);
+
+  // v1.3.3: Under the mutex (updateStats() walks the RAM window)
+  updateStats();
+  xSemaphoreGive(queueMutex);
+
   LOG_MQTT_INFO(
       "[MQTT_QUEUE] Message %d queued [%s] (topic: %s, size: %d bytes)\n",
       msg.messageId, getPriorityString(priority), msg.topic.c_str(),
@@ -207,8 +250,14 @@ uint32_t MQTTPersistentQueue::processQueue() {
   // Clean expired messages
   cleanExpiredMessages();
 
+  // v1.3.3: Refill RAM from the disk backlog (oldest first), then a few
+  // records of the SD backlog
+  spoolFromLog();
+  spoolFromOverflow(config.sdReplayPerCycle);
+
   // Process messages by priority (HIGH to NORMAL to LOW)
   uint8_t messagesThisCycle = 0;
+  bool windowFull = false;  // v1.3.3: Stops all priorities (QoS 1 window)
 
   // Process HIGH priority first
   while (!highPriorityQueue.empty() &&
@@ -216,16 +265,19 @@ uint32_t MQTTPersistentQueue::processQueue() {
     QueuedMessage& msg = highPriorityQueue.front();
 
     if (msg.status == STATUS_QUEUED || msg.retryState == RETRY_READY) {
-      // Convert PSRAMString to Arduino String for callback
-      if (publishCallback &&
-          publishCallback(msg.topic.toString(), msg.payload.toString())) {
+      // v1.3.3: PSRAM buffers passed directly (no String copies)
+      PublishOutcome outcome = attemptPublish(msg);
+      if (outcome == PUBLISH_DEFERRED) {
+        windowFull = true;  // v1.3.3: In-flight window full
+        break;
+      }
+      if (outcome != PUBLISH_FAILED) {
         // Success
-        msg.status = STATUS_SENT;
         LOG_MQTT_INFO("[MQTT_QUEUE] Message %d sent successfully\n",
                       msg.messageId);
-        stats.successfulMessages++;
         messagesSent++;
         messagesThisCycle++;
+        completeSend(msg, outcome);
         highPriorityQueue.pop_front();
       } else {
         // Failed - schedule retry
@@ -242,8 +294,9 @@ uint32_t MQTTPersistentQueue::processQueue() {
               msg.messageId, msg.retryCount,
               calculateRetryDelay(msg.retryCount));
           messagesThisCycle++;
-          highPriorityQueue.pop_front();
+          // v1.3.3: Copy before pop (msg referenced the popped element)
           normalPriorityQueue.push_back(msg);  // Re-queue with lower priority
+          highPriorityQueue.pop_front();
         } else {
           // Max retries exceeded
           msg.status = STATUS_FAILED;
@@ -252,6 +305,7 @@ uint32_t MQTTPersistentQueue::processQueue() {
               msg.messageId, config.maxRetries);
           stats.failedMessages++;
           messagesThisCycle++;
+          releaseMessage(msg);
           highPriorityQueue.pop_front();
         }
       }
@@ -265,25 +319,29 @@ uint32_t MQTTPersistentQueue::processQueue() {
         break;  // Not ready yet, skip rest
       }
     } else {
+      releaseMessage(msg);
       highPriorityQueue.pop_front();
     }
   }
 
   // Process NORMAL priority (similar logic)
-  while (!normalPriorityQueue.empty() &&
+  while (!windowFull && !normalPriorityQueue.empty() &&
          messagesThisCycle < config.messagesPerCycle) {
     QueuedMessage& msg = normalPriorityQueue.front();
 
     if (msg.status == STATUS_QUEUED || msg.retryState == RETRY_READY) {
-      // Convert PSRAMString to Arduino String for callback
-      if (publishCallback &&
-          publishCallback(msg.topic.toString(), msg.payload.toString())) {
-        msg.status = STATUS_SENT;
+      // v1.3.3: PSRAM buffers passed directly (no String copies)
+      PublishOutcome outcome = attemptPublish(msg);
+      if (outcome == PUBLISH_DEFERRED) {
+        windowFull = true;
+        break;
+      }
+      if (outcome != PUBLISH_FAILED) {
         LOG_MQTT_INFO("[MQTT_QUEUE] Message %d sent successfully\n",
                       msg.messageId);
-        stats.successfulMessages++;
         messagesSent++;
         messagesThisCycle++;
+        completeSend(msg, outcome);
         normalPriorityQueue.pop_front();
       } else {
         msg.status = STATUS_FAILED;
@@ -294,12 +352,13 @@ uint32_t MQTTPersistentQueue::processQueue() {
           msg.lastRetryTime = now;
           msg.nextRetryTimeMs = now + calculateRetryDelay(msg.retryCount);
           messagesThisCycle++;
-          normalPriorityQueue.pop_front();
           lowPriorityQueue.push_back(msg);
+          normalPriorityQueue.pop_front();
         } else {
           msg.status = STATUS_FAILED;
           stats.failedMessages++;
           messagesThisCycle++;
+          releaseMessage(msg);
           normalPriorityQueue.pop_front();
         }
       }
@@ -312,23 +371,27 @@ uint32_t MQTTPersistentQueue::processQueue() {
         break;
       }
     } else {
+      releaseMessage(msg);
       normalPriorityQueue.pop_front();
     }
   }
 
   // Process LOW priority
-  while (!lowPriorityQueue.empty() &&
+  while (!windowFull && !lowPriorityQueue.empty() &&
          messagesThisCycle < config.messagesPerCycle) {
     QueuedMessage& msg = lowPriorityQueue.front();
 
     if (msg.status == STATUS_QUEUED || msg.retryState == RETRY_READY) {
-      // Convert PSRAMString to Arduino String for callback
-      if (publishCallback &&
-          publishCallback(msg.topic.toString(), msg.payload.toString())) {
-        msg.status = STATUS_SENT;
-        stats.successfulMessages++;
+      // v1.3.3: PSRAM buffers passed directly (no String copies)
+      PublishOutcome outcome = attemptPublish(msg);
+      if (outcome == PUBLISH_DEFERRED) {
+        windowFull = true;
+        break;
+      }
+      if (outcome != PUBLISH_FAILED) {
         messagesSent++;
         messagesThisCycle++;
+        completeSend(msg, outcome);
         lowPriorityQueue.pop_front();
       } else {
         msg.retryCount++;
@@ -337,11 +400,14 @@ uint32_t MQTTPersistentQueue::processQueue() {
           msg.lastRetryTime = now;
           msg.nextRetryTimeMs = now + calculateRetryDelay(msg.retryCount);
           messagesThisCycle++;
+          // v1.3.3: Re-queue at the back (was popped and lost)
+          lowPriorityQueue.push_back(msg);
           lowPriorityQueue.pop_front();
         } else {
           msg.status = STATUS_FAILED;
           stats.failedMessages++;
           messagesThisCycle++;
+          releaseMessage(msg);
           lowPriorityQueue.pop_front();
         }
       }
@@ -354,13 +420,21 @@ uint32_t MQTTPersistentQueue::processQueue() {
         break;
       }
     } else {
+      releaseMessage(msg);
       lowPriorityQueue.pop_front();
     }
   }
 
+  // v1.3.3: Read ahead into the slots freed this cycle
+  spoolFromLog();
+
   updateStats();
   stats.totalRetries += messagesThisCycle;
 
+  // v1.3.3: Persist the acknowledged head (rate limited)
+  queueLog.flushIndex(false);
+  flushOverflowIndex(false);
+
   xSemaphoreGive(queueMutex);
   return messagesSent;
 }
@@ -432,6 +506,195 @@ void MQTTPersistentQueue::retryFailedMessage(uint16_t messageId) {
   LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Message %d not found\n", messageId);
 }
 
+// v1.3.3: QoS 1 delivery
+bool MQTTPersistentQueue::acknowledgeMessage(uint16_t messageId) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  bool found = false;
+  for (auto it = inFlightQueue.begin(); it != inFlightQueue.end();) {
+    // v1.3.3: One PUBACK acknowledges every record of a catch-up batch
+    if (it->messageId == messageId ||
+        (it->batched && it->batchId == messageId)) {
+      it->status = STATUS_SENT;
+      stats.successfulMessages++;
+      releaseMessage(*it);  // Log acks may arrive out of order
+      it = inFlightQueue.erase(it);
+      found = true;
+    } else {
+      ++it;
+    }
+  }
+  if (found) {
+    spoolFromLog();  // v1.3.3: Read ahead as acknowledgements arrive
+    updateStats();
+  }
+  xSemaphoreGive(queueMutex);
+  return found;
+}
+
+bool MQTTPersistentQueue::requeueInFlight(uint16_t messageId) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  bool found = false;
+  // v1.3.3: Last to first, so a batch keeps its order at the queue front
+  for (size_t i = inFlightQueue.size(); i-- > 0;) {
+    QueuedMessage& msg = inFlightQueue[i];
+    if (msg.messageId == messageId ||
+        (msg.batched && msg.batchId == messageId)) {
+      // Front of its queue: next in line once the connection is back
+      msg.status = STATUS_QUEUED;
+      msg.retryState = RETRY_IDLE;
+      msg.batched = false;
+      getQueueForPriority(msg.priority)->push_front(std::move(msg));
+      inFlightQueue.erase(inFlightQueue.begin() + i);
+      found = true;
+    }
+  }
+  xSemaphoreGive(queueMutex);
+  return found;
+}
+
+uint32_t MQTTPersistentQueue::getInFlightCount() const {
+  return inFlightQueue.size();
+}
+
+// v1.3.3: Catch-up mode
+bool MQTTPersistentQueue::isCatchingUp() {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  unsigned long now = millis();
+  // Paused after failed batches: processQueue() retries per message meanwhile
+  if (!catchingUp && config.catchUpThreshold > 0 &&
+      (long)(now - catchUpPausedUntil) >= 0 &&
+      backlogCount() >= config.catchUpThreshold) {
+    catchingUp = true;
+    catchUpFailures = 0;
+    catchUpRefillMs = now;
+    catchUpTokens = config.catchUpBatchBytes;
+    LOG_MQTT_INFO("[MQTT_QUEUE] Catch-up started: %lu pending\n",
+                  (unsigned long)backlogCount());
+  }
+  bool active = catchingUp;
+  xSemaphoreGive(queueMutex);
+  return active;
+}
+
+uint32_t MQTTPersistentQueue::processCatchUp() {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+
+  unsigned long now = millis();
+  if (!catchingUp || (long)(now - catchUpPausedUntil) < 0) {
+    xSemaphoreGive(queueMutex);
+    return 0;
+  }
+
+  // Housekeeping of processQueue(), at its interval
+  if (now - lastProcessTime >= config.processInterval) {
+    lastProcessTime = now;
+    cleanExpiredMessages();
+    queueLog.flushIndex(false);
+    flushOverflowIndex(false);
+  }
+  spoolFromLog();
+  spoolFromOverflow(config.sdReplayPerCycle);
+  refillCatchUpTokens(now);
+
+  uint32_t messagesSent = 0;
+  uint8_t batches = 0;
+  while (catchUpTokens > 0 && batches < config.messagesPerCycle) {
+    auto* queue = nextCatchUpQueue(now);
+    if (queue == nullptr) {
+      break;
+    }
+
+    size_t payloadBytes = 0;
+    size_t count = collectCatchUpBatch(*queue, payloadBytes);
+    QueuedMessage& leader = queue->front();
+    uint16_t leaderId = leader.messageId;
+    const char* payload = leader.payload.c_str();
+    if (count > 1) {
+      // "[p1,p2,...]" - the records are JSON objects (checked when collected)
+      size_t used = 0;
+      batchBuffer[used++] = '[';
+      for (size_t i = 0; i < count; i++) {
+        const PSRAMString& part = (*queue)[i].payload;
+        if (i > 0) {
+          batchBuffer[used++] = ',';
+        }
+        memcpy(batchBuffer + used, part.c_str(), part.length());
+        used += part.length();
+      }
+      batchBuffer[used++] = ']';
+      batchBuffer[used] = '\0';
+      payload = batchBuffer;
+    }
+
+    uint32_t startUs = micros();
+    PublishOutcome outcome =
+        publishCallback ? publishCallback(leaderId, leader.topic.c_str(),
+                                          payload, payloadBytes)
+                        : PUBLISH_FAILED;
+    uint32_t elapsedUs = micros() - startUs;
+
+    if (outcome == PUBLISH_DEFERRED) {
+      break;  // In-flight window full, PUBACKs free it
+    }
+    if (outcome == PUBLISH_FAILED) {
+      // Nothing is dropped here: pause, and after maxRetries failed batches
+      // leave the messages to the per-message retries of processQueue()
+      catchUpFailures++;
+      catchUpPausedUntil = now + calculateRetryDelay(catchUpFailures);
+      if (catchUpFailures >= config.maxRetries) {
+        catchingUp = false;
+        LOG_MQTT_INFO("[MQTT_QUEUE] Catch-up stopped after %d failed batches\n",
+                      catchUpFailures);
+      }
+      break;
+    }
+    catchUpFailures = 0;
+
+    // Throughput sample: the write blocks once the TCP send buffer is full,
+    // so sustained catch-up writes follow what the link and broker take
+    float sample = (payloadBytes * 1000000.0f) / std::max(elapsedUs, 1000u);
+    brokerRateBps = (brokerRateBps > 0.0f)
+                        ? brokerRateBps + (sample - brokerRateBps) * 0.2f
+                        : sample;
+    catchUpTokens -= (int32_t)payloadBytes;
+
+    for (size_t i = 0; i < count; i++) {
+      QueuedMessage& msg = queue->front();
+      msg.batched = (count > 1);
+      msg.batchId = leaderId;
+      completeSend(msg, outcome);
+      queue->pop_front();
+    }
+    messagesSent += count;
+    batches++;
+    spoolFromLog();  // Read ahead into the freed slots
+  }
+
+  if (catchingUp && backlogCount() == 0) {
+    catchingUp = false;
+    LOG_MQTT_INFO("[MQTT_QUEUE] Catch-up done (broker rate %lu B/s)\n",
+                  (unsigned long)brokerRateBps);
+  }
+
+  updateStats();
+  xSemaphoreGive(queueMutex);
+  return messagesSent;
+}
+
+void MQTTPersistentQueue::setCatchUp(uint8_t batchRecords,
+                                     uint8_t liveSharePercent) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  config.catchUpBatchRecords = std::max<uint8_t>(batchRecords, 1);
+  config.liveSharePercent = std::min<uint8_t>(liveSharePercent, 90);
+  xSemaphoreGive(queueMutex);
+  LOG_MQTT_INFO("[MQTT_QUEUE] Catch-up: %d records per publish, %d%% live\n",
+                config.catchUpBatchRecords, config.liveSharePercent);
+}
+
+uint32_t MQTTPersistentQueue::getBrokerRate() const {
+  return (uint32_t)brokerRateBps;
+}
+
 // Message state queries
 MessageStatus MQTTPersistentQueue::getMessageStatus(uint16_t messageId) const {
   for (const auto& msg : highPriorityQueue) {
@@ -443,23 +706,29 @@ MessageStatus MQTTPersistentQueue::getMessageStatus(uint16_t messageId) const {
   for (const auto& msg : lowPriorityQueue) {
     if (msg.messageId == messageId) return msg.status;
   }
+  for (const auto& msg : inFlightQueue) {
+    if (msg.messageId == messageId) return msg.status;
+  }
   return STATUS_QUEUED;
 }
 
 uint32_t MQTTPersistentQueue::getPendingMessageCount() const {
-  return highPriorityQueue.size() + normalPriorityQueue.size() +
-         lowPriorityQueue.size();
+  // v1.3.3: RAM queues + backlog not yet spooled from the disk log
+  return residentCount() + queueLog.unreadCount() + overflowLog.unreadCount();
 }
 
 uint32_t MQTTPersistentQueue::getMessagesByPriority(
     MessagePriority priority) const {
+  // v1.3.3: RAM window + unread backlog of that priority
+  uint32_t backlog = queueLog.unreadCount((uint8_t)priority) +
+                     overflowLog.unreadCount((uint8_t)priority);
   switch (priority) {
     case PRIORITY_HIGH:
-      return highPriorityQueue.size();
+      return highPriorityQueue.size() + backlog;
     case PRIORITY_NORMAL:
-      return normalPriorityQueue.size();
+      return normalPriorityQueue.size() + backlog;
     case PRIORITY_LOW:
-      return lowPriorityQueue.size();
+      return lowPriorityQueue.size() + backlog;
     default:
       return 0;
   }
@@ -524,9 +793,13 @@ const char* MQTTPersistentQueue::getPriorityString(
 void MQTTPersistentQueue::printQueueStatus() {
   Serial.println("\n[MQTT_QUEUE] QUEUE STATUS");
   Serial.printf("  Health: %s\n", getHealthStatusString(stats.health));
-  Serial.printf("  Pending messages: %ld / %ld (%.1f%%)\n", stats.totalMessages,
-                config.maxQueueSize, stats.utilizationPercent);
+  Serial.printf("  Pending messages: %ld (%ld in RAM, window %ld, %.1f%%)\n",
+                stats.totalMessages, queuedCount(), windowLimit(),
+                stats.utilizationPercent);
   Serial.printf("  Total payload: %ld bytes\n", stats.totalPayloadSize);
+  Serial.printf("  SD overflow: %ld messages (%ld KB, card %s)\n",
+                stats.overflowMessages, stats.overflowSize / 1024,
+                SDCardManager::getInstance()->getStateString());
   Serial.printf("  Success rate: %.1f%% (%ld/%ld)\n\n", stats.successRate,
                 stats.successfulMessages,
                 stats.successfulMessages + stats.failedMessages);
@@ -669,16 +942,24 @@ void MQTTPersistentQueue::clearQueue() {
   highPriorityQueue.clear();
   normalPriorityQueue.clear();
   lowPriorityQueue.clear();
+  inFlightQueue.clear();  // A late PUBACK finds nothing to acknowledge
+  queueLog.clear();  // v1.3.3: Disk backlog too
+  if (lockOverflow()) {
+    overflowLog.clear();
+    unlockOverflow();
+  }
   updateStats();
   xSemaphoreGive(queueMutex);
   LOG_MQTT_INFO("[MQTT_QUEUE] Queue cleared");
 }
 
 void MQTTPersistentQueue::clearFailedMessages() {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
   uint32_t cleared = 0;
 
   for (auto it = highPriorityQueue.begin(); it != highPriorityQueue.end();) {
     if (it->status == STATUS_FAILED) {
+      releaseMessage(*it);
       it = highPriorityQueue.erase(it);
       cleared++;
     } else {
@@ -689,6 +970,7 @@ void MQTTPersistentQueue::clearFailedMessages() {
   for (auto it = normalPriorityQueue.begin();
        it != normalPriorityQueue.end();) {
     if (it->status == STATUS_FAILED) {
+      releaseMessage(*it);
       it = normalPriorityQueue.erase(it);
       cleared++;
     } else {
@@ -698,6 +980,7 @@ void MQTTPersistentQueue::clearFailedMessages() {
 
   for (auto it = lowPriorityQueue.begin(); it != lowPriorityQueue.end();) {
     if (it->status == STATUS_FAILED) {
+      releaseMessage(*it);
       it = lowPriorityQueue.erase(it);
       cleared++;
     } else {
@@ -706,16 +989,21 @@ void MQTTPersistentQueue::clearFailedMessages() {
   }
 
   updateStats();
+  xSemaphoreGive(queueMutex);
   LOG_MQTT_INFO("[MQTT_QUEUE] Cleared %ld failed messages\n", cleared);
 }
 
 void MQTTPersistentQueue::clearExpiredMessages() {
+  // v1.3.3: Mutex added (called from MqttManager::init while the MQTT task
+  // may already process the queue)
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
   unsigned long now = millis();
   uint32_t cleared = 0;
 
   for (auto it = highPriorityQueue.begin(); it != highPriorityQueue.end();) {
     if (it->timeoutMs > 0 && (now - it->enqueuedTime) > it->timeoutMs) {
       it->status = STATUS_EXPIRED;
+      releaseMessage(*it);
       it = highPriorityQueue.erase(it);
       cleared++;
       stats.expiredMessages++;
@@ -728,6 +1016,7 @@ void MQTTPersistentQueue::clearExpiredMessages() {
        it != normalPriorityQueue.end();) {
     if (it->timeoutMs > 0 && (now - it->enqueuedTime) > it->timeoutMs) {
       it->status = STATUS_EXPIRED;
+      releaseMessage(*it);
       it = normalPriorityQueue.erase(it);
       cleared++;
       stats.expiredMessages++;
@@ -739,6 +1028,7 @@ void MQTTPersistentQueue::clearExpiredMessages() {
   for (auto it = lowPriorityQueue.begin(); it != lowPriorityQueue.end();) {
     if (it->timeoutMs > 0 && (now - it->enqueuedTime) > it->timeoutMs) {
       it->status = STATUS_EXPIRED;
+      releaseMessage(*it);
       it = lowPriorityQueue.erase(it);
       cleared++;
       stats.expiredMessages++;
@@ -751,14 +1041,17 @@ void MQTTPersistentQueue::clearExpiredMessages() {
     LOG_MQTT_INFO("[MQTT_QUEUE] Cleared %ld expired messages\n", cleared);
     updateStats();
   }
+  xSemaphoreGive(queueMutex);
 }
 
 uint32_t MQTTPersistentQueue::pruneOldMessages(uint32_t ageMs) {
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
   unsigned long now = millis();
   uint32_t pruned = 0;
 
   for (auto it = lowPriorityQueue.begin(); it != lowPriorityQueue.end();) {
     if ((now - it->enqueuedTime) > ageMs) {
+      releaseMessage(*it);
       it = lowPriorityQueue.erase(it);
       pruned++;
     } else {
@@ -767,191 +1060,378 @@ uint32_t MQTTPersistentQueue::pruneOldMessages(uint32_t ageMs) {
   }
 
   updateStats();
+  xSemaphoreGive(queueMutex);
   return pruned;
 }
 
 // Persistence operations
-QueueOperationResult MQTTPersistentQueue::persistMessageToDisk(
-    const QueuedMessage& msg) {
-  String filename =
-      String(config.persistenceDir) + "/" + String(msg.messageId) + ".json";
-
-  JsonDocument doc;
-  doc["id"] = msg.messageId;
-  doc["topic"] = msg.topic.toString();      // Convert PSRAMString to String
-  doc["payload"] = msg.payload.toString();  // Convert PSRAMString to String
-  doc["priority"] = (int)msg.priority;
-  doc["status"] = (int)msg.status;
-  doc["enqueued_time"] = msg.enqueuedTime;
-  doc["retry_count"] = msg.retryCount;
-  doc["timeout_ms"] = msg.timeoutMs;
-
-  File file = LittleFS.open(filename.c_str(), "w");
-  if (!file) {
-    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Cannot create file %s\n",
-                  filename.c_str());
-    return QUEUE_STORAGE_ERROR;
+// v1.3.3: Disk log helpers (caller holds queueMutex)
+uint32_t MQTTPersistentQueue::residentCount() const {
+  return queuedCount() + inFlightQueue.size();
+}
+
+uint32_t MQTTPersistentQueue::queuedCount() const {
+  return highPriorityQueue.size() + normalPriorityQueue.size() +
+         lowPriorityQueue.size();
+}
+
+uint32_t MQTTPersistentQueue::windowLimit() const {
+  // In-flight messages are not counted: a full QoS 1 window would otherwise
+  // stop the read-ahead until the PUBACKs arrive
+  return queueLog.isOpen() ? config.replayWindow : config.maxQueueSize;
+}
+
+uint32_t MQTTPersistentQueue::backlogCount() const {
+  return queuedCount() + queueLog.unreadCount() + overflowLog.unreadCount();
+}
+
+// v1.3.3: Catch-up helpers (caller holds queueMutex)
+void MQTTPersistentQueue::refillCatchUpTokens(unsigned long now) {
+  float rate =
+      (brokerRateBps > 0.0f) ? brokerRateBps : (float)config.catchUpInitialRate;
+  float backlogRate = rate * (100 - config.liveSharePercent) / 100.0f;
+  uint32_t elapsedMs = now - catchUpRefillMs;
+  catchUpRefillMs = now;
+
+  // Burst capped at 250 ms of backlog rate (at least one full batch), so live
+  // publishes never queue behind a long catch-up burst
+  int64_t cap = std::max<int64_t>(config.catchUpBatchBytes,
+                                  (int64_t)(backlogRate / 4));
+  int64_t tokens = catchUpTokens + (int64_t)(backlogRate * elapsedMs / 1000);
+  catchUpTokens = (int32_t)std::min(tokens, cap);
+}
+
+std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>*
+MQTTPersistentQueue::nextCatchUpQueue(unsigned long now) {
+  std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>* queues[] = {
+      &highPriorityQueue, &normalPriorityQueue, &lowPriorityQueue};
+  for (auto* queue : queues) {
+    while (!queue->empty()) {
+      QueuedMessage& msg = queue->front();
+      if (msg.retryState == RETRY_WAITING && now >= msg.nextRetryTimeMs) {
+        msg.retryState = RETRY_READY;
+      }
+      if (msg.status == STATUS_QUEUED || msg.retryState == RETRY_READY) {
+        return queue;
+      }
+      if (msg.retryState == RETRY_WAITING) {
+        break;  // Backoff of this queue's front not over
+      }
+      releaseMessage(msg);  // Same as processQueue()
+      queue->pop_front();
+    }
   }
+  return nullptr;
+}
 
-  if (serializeJson(doc, file) == 0) {
-    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Failed to write to %s\n",
-                  filename.c_str());
-    file.close();
-    return QUEUE_STORAGE_ERROR;
+size_t MQTTPersistentQueue::collectCatchUpBatch(
+    std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>& queue,
+    size_t& payloadBytes) {
+  const QueuedMessage& leader = queue.front();
+  payloadBytes = leader.payload.length();
+  // A retried message goes alone (its batch may be what failed)
+  if (config.catchUpBatchRecords <= 1 || leader.retryCount > 0 ||
+      leader.payload.length() == 0 || leader.payload.c_str()[0] != '{') {
+    return 1;
+  }
+
+  // Consecutive fresh JSON objects for the same topic: "[" a "," b "]"
+  size_t count = 1;
+  size_t arrayBytes = payloadBytes + 2;
+  while (count < queue.size() && count < config.catchUpBatchRecords) {
+    const QueuedMessage& msg = queue[count];
+    size_t length = msg.payload.length();
+    if (msg.status != STATUS_QUEUED || length == 0 ||
+        msg.payload.c_str()[0] != '{' ||
+        strcmp(msg.topic.c_str(), leader.topic.c_str()) != 0 ||
+        arrayBytes + 1 + length > config.catchUpBatchBytes) {
+      break;
+    }
+    arrayBytes += 1 + length;
+    count++;
+  }
+  if (count == 1) {
+    return 1;
   }
 
-  file.close();
-  return QUEUE_SUCCESS;
+  if (batchBufferSize < arrayBytes + 1) {
+    heap_caps_free(batchBuffer);
+    batchBufferSize = config.catchUpBatchBytes + 1;
+    batchBuffer = (char*)heap_caps_malloc(batchBufferSize,
+                                          MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (batchBuffer == nullptr) {
+      batchBuffer = (char*)heap_caps_malloc(batchBufferSize, MALLOC_CAP_8BIT);
+    }
+    if (batchBuffer == nullptr) {
+      batchBufferSize = 0;
+      return 1;  // No buffer: one record per publish
+    }
+  }
+  payloadBytes = arrayBytes;
+  return count;
 }
 
-bool MQTTPersistentQueue::loadQueueFromDisk() {
-  File queueDir = LittleFS.open(config.persistenceDir, "r");
-  if (!queueDir) {
-    LOG_MQTT_INFO("[MQTT_QUEUE] Queue directory not found: %s\n",
-                  config.persistenceDir);
-    return false;
+void MQTTPersistentQueue::releaseMessage(const QueuedMessage& msg) {
+  // Message left the queue (sent, failed, expired, cleared): its log record
+  // is no longer needed
+  if (!msg.persisted) {
+    return;
   }
+  if (!msg.overflow) {
+    queueLog.acknowledge(msg.logPosition);
+  } else if (lockOverflow()) {
+    // v1.3.3: Missed (card busy or removed): replayed after the next mount
+    overflowLog.acknowledge(msg.logPosition);
+    unlockOverflow();
+  }
+}
 
-  uint32_t loadedCount = 0;
+PublishOutcome MQTTPersistentQueue::attemptPublish(const QueuedMessage& msg) {
+  if (!publishCallback) {
+    return PUBLISH_FAILED;
+  }
+  return publishCallback(msg.messageId, msg.topic.c_str(),
+                         msg.payload.c_str(), msg.payload.length());
+}
 
-  File file = queueDir.openNextFile();
-  while (file) {
-    if (String(file.name()).endsWith(".json")) {
-      JsonDocument doc;
+void MQTTPersistentQueue::completeSend(QueuedMessage& msg,
+                                       PublishOutcome outcome) {
+  if (outcome == PUBLISH_PENDING_ACK) {
+    // QoS 1: log record kept until the PUBACK
+    msg.status = STATUS_SENDING;
+    inFlightQueue.push_back(std::move(msg));
+    return;
+  }
+  msg.status = STATUS_SENT;
+  stats.successfulMessages++;
+  releaseMessage(msg);
+}
 
-      if (deserializeJson(doc, file) == DeserializationError::Ok) {
-        QueuedMessage msg;
-        msg.messageId = doc["id"];
-        msg.topic = PSRAMString(
-            doc["topic"].as<String>());  // Convert String to PSRAMString
-        msg.payload = PSRAMString(
-            doc["payload"].as<String>());  // Convert String to PSRAMString
-        msg.priority = (MessagePriority)doc["priority"].as<int>();
-        msg.status = (MessageStatus)doc["status"].as<int>();
-        msg.enqueuedTime = doc["enqueued_time"];
-        msg.retryCount = doc["retry_count"];
-        msg.timeoutMs = doc["timeout_ms"];
-        msg.retryState = RETRY_IDLE;
-
-        std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>*
-            targetQueue = getQueueForPriority(msg.priority);
-        if (targetQueue) {
-          targetQueue->push_back(msg);
-          loadedCount++;
-        }
-      }
-    }
+uint32_t MQTTPersistentQueue::spoolFromLog() {
+  if (!queueLog.isOpen()) {
+    return 0;
+  }
 
-    file.close();
-    file = queueDir.openNextFile();
+  time_t now = time(nullptr);
+  uint32_t spooled = 0;
+  LogRecord record;
+  while (queueLog.unreadCount() > 0 && queuedCount() < windowLimit() &&
+         queueLog.readNext(record)) {
+    spoolRecord(record, false, now);
+    spooled++;
   }
+  return spooled;
+}
 
-  queueDir.close();
+void MQTTPersistentQueue::spoolRecord(LogRecord& record, bool overflow,
+                                      time_t now) {
+  QueuedMessage msg;
+  msg.messageId = record.messageId;
+  msg.topic = std::move(record.topic);
+  msg.payload = std::move(record.payload);
+  msg.priority = (record.priority <= PRIORITY_HIGH)
+                     ? (MessagePriority)record.priority
+                     : PRIORITY_NORMAL;
+  msg.status = STATUS_QUEUED;
+  msg.timeoutMs = record.timeoutMs;
+  msg.retryState = RETRY_IDLE;
+  msg.logPosition = record.position;
+  msg.persisted = true;
+  msg.overflow = overflow;
 
-  if (loadedCount > 0) {
-    LOG_MQTT_INFO("[MQTT_QUEUE] Loaded %ld persisted messages from disk\n",
-                  loadedCount);
-    updateStats();
+  // Age survives reboots via the wall clock (millis() restarts at 0;
+  // unsigned wrap keeps now - enqueuedTime == age)
+  uint32_t ageMs = 0;
+  if (record.enqueuedUnix > 0 && now > (time_t)record.enqueuedUnix) {
+    uint32_t ageSec = (uint32_t)(now - record.enqueuedUnix);
+    ageMs = (ageSec < 0x7FFFFFFF / 1000) ? ageSec * 1000 : 0x7FFFFFFF;
+  }
+  msg.enqueuedTime = millis() - ageMs;
+
+  getQueueForPriority(msg.priority)->push_back(std::move(msg));
+  if ((uint16_t)(record.messageId + 1) > nextMessageId) {
+    nextMessageId = record.messageId + 1;  // Unique ids after reboot
   }
+}
 
+// v1.3.3: SD overflow tier (caller holds queueMutex)
+bool MQTTPersistentQueue::lockOverflow() {
+  if (!config.enablePersistence || !config.enableSdOverflow) {
+    return false;
+  }
+  SDCardManager* sd = SDCardManager::getInstance();
+  if (!sd->isReady() || !sd->lock()) {
+    return false;
+  }
+  if (!sd->isReady()) {
+    sd->unlock();
+    return false;
+  }
+
+  // (Re)open on every new mount: files of an earlier mount are invalid and
+  // the card may have been swapped
+  if (!overflowLog.isOpen() || overflowGeneration != sd->getMountGeneration()) {
+    overflowLog.close();
+    if (!overflowLog.begin(config.sdOverflowDir, 0, config.sdSegmentSize)) {
+      sd->reportIoError();
+      sd->unlock();
+      return false;
+    }
+    overflowGeneration = sd->getMountGeneration();
+
+    // Record counters are 32-bit: cap the log below 2GB
+    uint64_t freeBytes = sd->freeBytes();
+    uint64_t usable = (freeBytes > config.sdReservedBytes)
+                          ? freeBytes - config.sdReservedBytes
+                          : 0;
+    usable += overflowLog.bytesUsed();
+    overflowLog.setCapacity(usable < 0x7FFFFFFF ? (uint32_t)usable
+                                                : 0x7FFFFFFF);
+    LOG_MQTT_INFO("[MQTT_QUEUE] SD overflow log opened: %ld messages\n",
+                  overflowLog.pendingCount());
+  }
   return true;
 }
 
-void MQTTPersistentQueue::cleanupPersistenceStorage() {
+void MQTTPersistentQueue::unlockOverflow() {
+  overflowLog.closeFiles();  // Nothing left open if the card is removed
+  SDCardManager::getInstance()->unlock();
+}
+
+uint32_t MQTTPersistentQueue::spoolFromOverflow(uint32_t maxRecords) {
+  // Replay rate limit: the LittleFS backlog goes first (older), and SD
+  // records only fill the lower half of the RAM window, maxRecords per cycle
+  if (maxRecords == 0 || queueLog.unreadCount() > 0 ||
+      queuedCount() >= windowLimit() / 2 || !lockOverflow()) {
+    return 0;
+  }
+
+  time_t now = time(nullptr);
+  uint32_t spooled = 0;
+  LogRecord record;
+  while (spooled < maxRecords && overflowLog.unreadCount() > 0 &&
+         overflowLog.readNext(record)) {
+    spoolRecord(record, true, now);
+    spooled++;
+  }
+  unlockOverflow();
+
+  if (spooled > 0) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] Replaying %ld SD messages (%ld left)\n",
+                  spooled, overflowLog.unreadCount());
+  }
+  return spooled;
+}
+
+void MQTTPersistentQueue::flushOverflowIndex(bool force) {
+  if (overflowLog.isOpen() && lockOverflow()) {
+    overflowLog.flushIndex(force);
+    unlockOverflow();
+  }
+}
+
+uint32_t MQTTPersistentQueue::importLegacyFiles() {
+  // One-time migration of the per-message JSON files (< v1.3.3)
   File queueDir = LittleFS.open(config.persistenceDir, "r");
   if (!queueDir) {
-    // No valid handle to close - LittleFS returns invalid File object on
-    // failure
-    LOG_MQTT_INFO(
-        "[MQTT_QUEUE] ERROR: Failed to open persistence directory: %s\n",
-        config.persistenceDir);
-    return;
+    return 0;
   }
 
-  uint32_t cleanedCount = 0;
+  uint32_t imported = 0;
   File file = queueDir.openNextFile();
-
   while (file) {
     String filename = file.name();
-
-    // Remove files for messages no longer in queue
-    uint16_t fileId = 0;
-    if (sscanf(filename.c_str(), "%hu.json", &fileId) == 1) {
-      bool found = false;
-
-      for (const auto& msg : highPriorityQueue) {
-        if (msg.messageId == fileId) {
-          found = true;
-          break;
-        }
-      }
-      for (const auto& msg : normalPriorityQueue) {
-        if (msg.messageId == fileId) {
-          found = true;
-          break;
-        }
-      }
-      for (const auto& msg : lowPriorityQueue) {
-        if (msg.messageId == fileId) {
-          found = true;
-          break;
+    if (filename.endsWith(".json")) {
+      JsonDocument doc;
+      bool consumed = true;  // Unreadable files are dropped
+      if (deserializeJson(doc, file) == DeserializationError::Ok) {
+        const char* topic = doc["topic"] | "";
+        const char* payload = doc["payload"] | "";
+        LogPosition position;
+        if (strlen(topic) > 0 && strlen(payload) > 0) {
+          consumed = queueLog.append(
+              doc["id"] | 0, doc["priority"] | (int)PRIORITY_NORMAL,
+              doc["timeout_ms"] | config.defaultTimeoutMs, 0, topic,
+              strlen(topic), payload, strlen(payload), position);
+          if (consumed) imported++;
         }
       }
-
-      if (!found) {
-        String fullPath = String(config.persistenceDir) + "/" + filename;
-        LittleFS.remove(fullPath.c_str());
-        cleanedCount++;
+      file.close();
+      if (consumed) {
+        LittleFS.remove(
+            (String(config.persistenceDir) + "/" + filename).c_str());
       }
+    } else {
+      file.close();
     }
-
-    file.close();
     file = queueDir.openNextFile();
   }
-
   queueDir.close();
 
+  if (imported > 0) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] Imported %ld legacy message files\n",
+                  imported);
+  }
+  return imported;
+}
+
+void MQTTPersistentQueue::cleanupPersistenceStorage() {
+  // v1.3.3: Delivered records are removed with their segment; only stray
+  // files (legacy .json, interrupted deletes) are left to clean up
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  uint32_t cleanedCount = queueLog.removeOrphans();
+  if (lockOverflow()) {
+    cleanedCount += overflowLog.removeOrphans();
+    unlockOverflow();
+  }
+  xSemaphoreGive(queueMutex);
+
   if (cleanedCount > 0) {
     LOG_MQTT_INFO("[MQTT_QUEUE] Cleaned %ld orphaned files\n", cleanedCount);
   }
 }
 
 QueueOperationResult MQTTPersistentQueue::saveQueueToDisk() {
-  // Save all queued messages
-  for (const auto& msg : highPriorityQueue) {
-    persistMessageToDisk(msg);
-  }
-  for (const auto& msg : normalPriorityQueue) {
-    persistMessageToDisk(msg);
-  }
-  for (const auto& msg : lowPriorityQueue) {
-    persistMessageToDisk(msg);
+  // v1.3.3: Messages are written once at enqueue; only the acknowledged head
+  // needs saving
+  if (!queueLog.isOpen()) {
+    return QUEUE_STORAGE_ERROR;
   }
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  queueLog.flushIndex(true);
+  flushOverflowIndex(true);
+  xSemaphoreGive(queueMutex);
 
   LOG_MQTT_INFO("[MQTT_QUEUE] Queue saved to disk");
   return QUEUE_SUCCESS;
 }
 
 QueueOperationResult MQTTPersistentQueue::loadQueueFromDiskNow() {
-  clearQueue();
-  return loadQueueFromDisk() ? QUEUE_SUCCESS : QUEUE_STORAGE_ERROR;
-}
-
-uint32_t MQTTPersistentQueue::getPersistenceUsage() const {
-  uint32_t totalSize = 0;
-  File queueDir = LittleFS.open(config.persistenceDir, "r");
+  if (!queueLog.isOpen()) {
+    return QUEUE_STORAGE_ERROR;
+  }
 
-  if (queueDir) {
-    File file = queueDir.openNextFile();
-    while (file) {
-      totalSize += file.size();
-      file.close();
-      file = queueDir.openNextFile();
-    }
-    queueDir.close();
+  // Rebuild RAM from the log: unacknowledged records are handed out again
+  xSemaphoreTake(queueMutex, portMAX_DELAY);
+  highPriorityQueue.clear();
+  normalPriorityQueue.clear();
+  lowPriorityQueue.clear();
+  queueLog.rewind();
+  if (lockOverflow()) {
+    overflowLog.rewind();  // SD records are replayed by processQueue()
+    unlockOverflow();
   }
+  uint32_t loadedCount = spoolFromLog();
+  updateStats();
+  xSemaphoreGive(queueMutex);
+
+  LOG_MQTT_INFO("[MQTT_QUEUE] Loaded %ld persisted messages from disk\n",
+                loadedCount);
+  return QUEUE_SUCCESS;
+}
 
-  return totalSize;
+uint32_t MQTTPersistentQueue::getPersistenceUsage() const {
+  return queueLog.bytesUsed();
 }
 
 // Performance optimization
@@ -1009,6 +1489,7 @@ uint32_t MQTTPersistentQueue::repairQueue() {
 
   for (auto it = highPriorityQueue.begin(); it != highPriorityQueue.end();) {
     if (it->topic.isEmpty() || it->payload.isEmpty()) {
+      releaseMessage(*it);
       it = highPriorityQueue.erase(it);
       repaired++;
     } else {
@@ -1019,6 +1500,7 @@ uint32_t MQTTPersistentQueue::repairQueue() {
   for (auto it = normalPriorityQueue.begin();
        it != normalPriorityQueue.end();) {
     if (it->topic.isEmpty() || it->payload.isEmpty()) {
+      releaseMessage(*it);
       it = normalPriorityQueue.erase(it);
       repaired++;
     } else {
@@ -1028,6 +1510,7 @@ uint32_t MQTTPersistentQueue::repairQueue() {
 
   for (auto it = lowPriorityQueue.begin(); it != lowPriorityQueue.end();) {
     if (it->topic.isEmpty() || it->payload.isEmpty()) {
+      releaseMessage(*it);
       it = lowPriorityQueue.erase(it);
       repaired++;
     } else {
@@ -1050,15 +1533,46 @@ void MQTTPersistentQueue::enableAutoRecovery(bool enable) {
 
 // Private helper methods
 void MQTTPersistentQueue::updateStats() {
-  stats.totalMessages = highPriorityQueue.size() + normalPriorityQueue.size() +
-                        lowPriorityQueue.size();
-
-  stats.highPriorityCount = highPriorityQueue.size();
-  stats.normalPriorityCount = normalPriorityQueue.size();
-  stats.lowPriorityCount = lowPriorityQueue.size();
-
-  stats.utilizationPercent =
-      (stats.totalMessages * 100.0f) / config.maxQueueSize;
+  // v1.3.3: Counts cover the RAM window and the unread disk / SD backlog
+  // (log counters - nothing is read from disk)
+  stats.highPriorityCount = getMessagesByPriority(PRIORITY_HIGH);
+  stats.normalPriorityCount = getMessagesByPriority(PRIORITY_NORMAL);
+  stats.lowPriorityCount = getMessagesByPriority(PRIORITY_LOW);
+  stats.totalMessages = stats.highPriorityCount + stats.normalPriorityCount +
+                        stats.lowPriorityCount;
+
+  // Was a running sum of every enqueued payload (never decreased)
+  uint32_t payloadBytes =
+      queueLog.unreadPayloadBytes() + overflowLog.unreadPayloadBytes();
+  for (const auto& msg : highPriorityQueue) {
+    payloadBytes += msg.payload.length();
+  }
+  for (const auto& msg : normalPriorityQueue) {
+    payloadBytes += msg.payload.length();
+  }
+  for (const auto& msg : lowPriorityQueue) {
+    payloadBytes += msg.payload.length();
+  }
+  stats.totalPayloadSize = payloadBytes;
+
+  // v1.3.3: RAM is a window onto the disk log - the log bounds the queue
+  // v1.3.3: The SD overflow log adds its capacity
+  stats.overflowMessages = overflowLog.pendingCount();
+  stats.overflowSize = overflowLog.bytesUsed();
+  if (queueLog.isOpen() && queueLog.capacity() > 0) {
+    stats.persistedMessages = queueLog.pendingCount();
+    stats.persistenceSize = queueLog.bytesUsed();
+    uint64_t capacity = queueLog.capacity();
+    uint64_t used = queueLog.bytesUsed();
+    if (overflowLog.isOpen()) {
+      capacity += overflowLog.capacity();
+      used += overflowLog.bytesUsed();
+    }
+    stats.utilizationPercent = (used * 100.0f) / capacity;
+  } else {
+    stats.utilizationPercent =
+        (stats.totalMessages * 100.0f) / config.maxQueueSize;
+  }
 
   if (stats.totalMessages > 0) {
     stats.averagePayloadSize = stats.totalPayloadSize / stats.totalMessages;
@@ -1133,6 +1647,7 @@ void MQTTPersistentQueue::cleanExpiredMessages() {
       it->status = STATUS_EXPIRED;
       stats.expiredMessages++;
       expiredCount++;
+      releaseMessage(*it);
       it = highPriorityQueue.erase(it);
     } else {
       ++it;
@@ -1146,6 +1661,7 @@ void MQTTPersistentQueue::cleanExpiredMessages() {
       it->status = STATUS_EXPIRED;
       stats.expiredMessages++;
       expiredCount++;
+      releaseMessage(*it);
       it = normalPriorityQueue.erase(it);
     } else {
       ++it;
@@ -1158,6 +1674,7 @@ void MQTTPersistentQueue::cleanExpiredMessages() {
       it->status = STATUS_EXPIRED;
       stats.expiredMessages++;
       expiredCount++;
+      releaseMessage(*it);
       it = lowPriorityQueue.erase(it);
     } else {
       ++it;
@@ -1172,7 +1689,10 @@ void MQTTPersistentQueue::cleanExpiredMessages() {
 
 // Destructor
 MQTTPersistentQueue::~MQTTPersistentQueue() {
-  saveQueueToDisk();
+  queueLog.flushIndex(true);
+  flushOverflowIndex(true);
+
+  heap_caps_free(batchBuffer);  // v1.3.3: Catch-up batch buffer
 
   // CRITICAL FIX: Delete mutex for cleanup
   if (queueMutex != NULL) {
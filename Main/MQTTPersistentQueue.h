@@ -9,7 +9,9 @@
 #include <vector>
 
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include "MQTTQueueLog.h"      // v1.3.3: Segmented append-only storage
 #include "PSRAMAllocator.h"  // CRITICAL FIX: PSRAM allocator for STL containers
+#include "SDCardManager.h"   // v1.3.3: SD card overflow tier
 
 /*
  * @brief MQTT Persistent Queue - Reliable message delivery with automatic retry
@@ -25,6 +27,53 @@
  * - Compression for large messages
  * - Comprehensive statistics and diagnostics
  * - Per-message timeout tracking
+ *
+ * v1.3.3: Storage is a segmented append-only log (MQTTQueueLog)
+ * Previous: One JSON file per message, rewritten by saveQueueToDisk() and
+ * never deleted after delivery; every file was parsed into RAM at boot and
+ * RAM was the hard limit (1000 messages).
+ * New: Messages are appended to the log once and acknowledged when they leave
+ * the queue (sent, failed, expired, cleared). The RAM deques hold at most
+ * maxQueueSize messages; older backlog stays on disk and is spooled in log
+ * order as RAM frees up, so an outage is bounded by flash, not RAM.
+ *
+ * v1.3.3: QoS 1 acknowledgements
+ * A message sent at QoS 1 (PUBLISH_PENDING_ACK) moves to the in-flight list
+ * and keeps its log record until the broker's PUBACK (acknowledgeMessage());
+ * a lost connection puts it back in its queue (requeueInFlight()). A reboot
+ * before the PUBACK replays it from the log.
+ *
+ * v1.3.3: SD card overflow tier
+ * Previous: once the LittleFS log reached its capacity (the free space of a
+ * small partition), every new message was dropped with QUEUE_FULL.
+ * New: messages that do not fit go to a second MQTTQueueLog on the SD card
+ * (SDCardManager, same append-only segment format). While connected,
+ * processQueue() replays the SD backlog a few records per cycle
+ * (sdReplayPerCycle), after the LittleFS backlog and only while half of the
+ * RAM window is free, so the replay never takes a whole cycle. A removed
+ * card only loses its place in the window: after the next mount the
+ * unacknowledged records are replayed (at-least-once, like a reboot).
+ *
+ * v1.3.3: Bounded replay window
+ * Previous: up to maxQueueSize (1000) messages were resident - a long outage
+ * loaded that many payloads into PSRAM at boot, and the statistics only
+ * counted the RAM contents.
+ * New: while the disk log is open at most replayWindow queued messages are
+ * resident (plus the QoS 1 in-flight ones). The next records are read ahead
+ * sequentially as messages leave the window (sent, PUBACK, failed), and the
+ * statistics add the unread backlog from the log counters. maxQueueSize only
+ * bounds a RAM-only queue (log unavailable).
+ *
+ * v1.3.3: Catch-up mode
+ * Previous: after a long outage the backlog was resent one message per
+ * publish, messagesPerCycle messages every processInterval, whatever the
+ * broker could take, and live publishes queued behind it.
+ * New: once catchUpThreshold messages are pending, processCatchUp() replays
+ * the backlog on every MQTT task cycle. Consecutive records for the same
+ * topic are coalesced into one JSON array publish (catchUpBatchRecords,
+ * catchUpBatchBytes; 1 = one record per publish), paced by a token bucket
+ * refilled from the measured broker throughput with liveSharePercent of it
+ * kept free for live data. One PUBACK acknowledges every record of a batch.
  */
 
 // Priority levels for messages
@@ -53,6 +102,14 @@ enum QueueOperationResult {
   QUEUE_NOT_FOUND = 5
 };
 
+// v1.3.3: Result of one publish callback call
+enum PublishOutcome {
+  PUBLISH_FAILED = 0,       // Not sent (scheduled for retry)
+  PUBLISH_SENT = 1,         // Sent at QoS 0 (done)
+  PUBLISH_PENDING_ACK = 2,  // Sent at QoS 1, kept until acknowledgeMessage()
+  PUBLISH_DEFERRED = 3      // In-flight window full, try again next cycle
+};
+
 // Message retry state
 enum RetryState { RETRY_IDLE = 0, RETRY_WAITING = 1, RETRY_READY = 2 };
 
@@ -86,6 +143,15 @@ struct QueuedMessage {
   // Retry state
   RetryState retryState = RETRY_IDLE;
   uint32_t nextRetryTimeMs = 0;  // When to retry (0 = immediately)
+
+  // v1.3.3: Record in MQTTQueueLog (acknowledged when removed from RAM)
+  LogPosition logPosition;
+  bool persisted = false;
+  bool overflow = false;  // v1.3.3: Record is in the SD overflow log
+
+  // v1.3.3: Catch-up batch (one publish, acknowledged by the leader's id)
+  bool batched = false;
+  uint16_t batchId = 0;
 };
 
 // Queue statistics and monitoring
@@ -104,6 +170,8 @@ struct QueueStats {
   // Persistence
   uint32_t persistedMessages = 0;  // Messages saved to LittleFS
   uint32_t persistenceSize = 0;    // Total bytes on disk
+  uint32_t overflowMessages = 0;   // v1.3.3: Messages in the SD overflow log
+  uint32_t overflowSize = 0;       // v1.3.3: SD overflow bytes
 
   // Retries and failures
   uint32_t totalRetries = 0;     // Total retry attempts
@@ -122,7 +190,10 @@ struct QueueStats {
 // Queue configuration
 struct PersistenceConfig {
   // Queue size limits
-  uint32_t maxQueueSize = 1000;  // Maximum number of messages
+  uint32_t maxQueueSize = 1000;  // v1.3.3: Max messages in RAM without a
+                                 // disk log (RAM-only queue)
+  uint32_t replayWindow = 32;    // v1.3.3: Max queued messages in RAM while
+                                 // the disk log is open (rest stays on disk)
 
   // Retry parameters
   uint32_t initialRetryDelayMs = 5000;  // 5 seconds initial delay
@@ -141,7 +212,24 @@ struct PersistenceConfig {
   // Persistence
   bool enablePersistence = true;               // Save to LittleFS
   const char* persistenceDir = "/mqtt_queue";  // Directory for queue files
-  uint32_t maxPersistenceSize = 102400;        // Max bytes on disk (100 KB)
+  uint32_t maxPersistenceSize = 0;   // v1.3.3: Max log bytes on disk
+                                     // (0 = free LittleFS space - reserve)
+  uint32_t reservedFsBytes = 65536;  // v1.3.3: LittleFS space left free
+  uint32_t segmentSize = MQTTQueueLog::DEFAULT_SEGMENT_SIZE;  // Log file size
+
+  // v1.3.3: SD card overflow tier (when the LittleFS log is full)
+  bool enableSdOverflow = SD_CARD_ENABLED;
+  const char* sdOverflowDir = "/mqtt_spill";  // Directory on the card
+  uint32_t sdSegmentSize = 262144;            // 256KB per segment file
+  uint32_t sdReservedBytes = 16777216;        // Card space left free (16MB)
+  uint8_t sdReplayPerCycle = 4;  // Max SD records spooled per processQueue()
+
+  // v1.3.3: Catch-up mode (backlog replay after a reconnect)
+  uint32_t catchUpThreshold = 20;       // Pending messages that start it
+  uint8_t catchUpBatchRecords = 1;      // Records per publish (1 = no array)
+  uint32_t catchUpBatchBytes = 8192;    // Max coalesced payload size
+  uint8_t liveSharePercent = 30;        // Broker throughput kept for live
+  uint32_t catchUpInitialRate = 16384;  // Bytes/s until one is measured
 
   // Processing
   uint32_t processInterval = 5000;  // How often to process queue (5 sec)
@@ -161,30 +249,73 @@ class MQTTPersistentQueue {
   std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>
       normalPriorityQueue;
   std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>> lowPriorityQueue;
+  // v1.3.3: Sent at QoS 1, waiting for the PUBACK
+  std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>> inFlightQueue;
 
   // CRITICAL FIX: Thread safety mutex (protects queue operations and LittleFS
   // access) Prevents race conditions when called from multiple tasks (mqtt,
   // crud, etc.)
   SemaphoreHandle_t queueMutex;
 
+  // v1.3.3: Disk log of every queued message (accessed under queueMutex)
+  MQTTQueueLog queueLog;
+  // v1.3.3: SD overflow log (queueMutex + SDCardManager lock)
+  MQTTQueueLog overflowLog;
+  uint32_t overflowGeneration = 0;  // SD mount the log was opened on
+
   // Statistics and tracking
   QueueStats stats;
   uint16_t nextMessageId = 1;
   unsigned long lastProcessTime = 0;
 
   // Callback for publish attempts
-  typedef std::function<bool(const String&, const String&)> PublishCallback;
+  // v1.3.3: Raw topic/payload from PSRAM (no String copies per attempt);
+  // messageId identifies a PUBLISH_PENDING_ACK message in acknowledgeMessage()
+  typedef std::function<PublishOutcome(uint16_t messageId, const char* topic,
+                                       const char* payload, size_t length)>
+      PublishCallback;
   PublishCallback publishCallback;
 
+  // v1.3.3: Catch-up state (accessed under queueMutex)
+  bool catchingUp = false;
+  float brokerRateBps = 0.0f;         // EWMA of measured publish throughput
+  int32_t catchUpTokens = 0;          // Token bucket (bytes)
+  unsigned long catchUpRefillMs = 0;  // Last refill
+  unsigned long catchUpPausedUntil = 0;
+  uint8_t catchUpFailures = 0;        // Consecutive failed batches
+  char* batchBuffer = nullptr;        // PSRAM, coalesced JSON array
+  size_t batchBufferSize = 0;
+
   // Private constructor for singleton
   MQTTPersistentQueue();
 
   // Internal methods
   void updateStats();
   void updateHealthStatus();
-  QueueOperationResult persistMessageToDisk(const QueuedMessage& msg);
-  bool loadQueueFromDisk();
+  // v1.3.3: Disk log helpers (caller holds queueMutex)
+  uint32_t residentCount() const;
+  uint32_t queuedCount() const;  // Resident, not in flight
+  uint32_t windowLimit() const;  // replayWindow, maxQueueSize without log
+  uint32_t spoolFromLog();
+  void spoolRecord(LogRecord& record, bool overflow, time_t now);
+  // v1.3.3: SD overflow helpers (caller holds queueMutex)
+  bool lockOverflow();
+  void unlockOverflow();
+  uint32_t spoolFromOverflow(uint32_t maxRecords);
+  void flushOverflowIndex(bool force);
+  uint32_t importLegacyFiles();
+  void releaseMessage(const QueuedMessage& msg);
+  PublishOutcome attemptPublish(const QueuedMessage& msg);
+  void completeSend(QueuedMessage& msg, PublishOutcome outcome);
   void cleanExpiredMessages();
+  // v1.3.3: Catch-up helpers (caller holds queueMutex)
+  uint32_t backlogCount() const;  // Queued + unread, not in flight
+  void refillCatchUpTokens(unsigned long now);
+  std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>*
+  nextCatchUpQueue(unsigned long now);
+  size_t collectCatchUpBatch(
+      std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>& queue,
+      size_t& payloadBytes);
   uint32_t calculateRetryDelay(uint8_t retryCount) const;
   std::deque<QueuedMessage, STLPSRAMAllocator<QueuedMessage>>*
   getQueueForPriority(MessagePriority priority);
@@ -218,6 +349,17 @@ class MQTTPersistentQueue {
   void retryFailedMessage(
       uint16_t messageId);  // Manual retry of specific message
 
+  // v1.3.3: QoS 1 delivery (PUBLISH_PENDING_ACK messages)
+  bool acknowledgeMessage(uint16_t messageId);  // PUBACK: drop from the log
+  bool requeueInFlight(uint16_t messageId);     // No PUBACK: send again
+  uint32_t getInFlightCount() const;
+
+  // v1.3.3: Catch-up mode (backlog after a reconnect, see header comment)
+  bool isCatchingUp();        // Enters the mode at catchUpThreshold pending
+  uint32_t processCatchUp();  // Paced batch replay, returns messages sent
+  void setCatchUp(uint8_t batchRecords, uint8_t liveSharePercent);
+  uint32_t getBrokerRate() const;  // Measured bytes/s (0 = not yet)
+
   // Message state queries
   MessageStatus getMessageStatus(uint16_t messageId) const;
   uint32_t getPendingMessageCount() const;
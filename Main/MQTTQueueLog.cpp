@@ -0,0 +1,553 @@
+#include "MQTTQueueLog.h"
+
+#include <LittleFS.h>
+#include <esp_rom_crc.h>
+
+#include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+
+MQTTQueueLog::MQTTQueueLog(fs::FS& fileSystem)
+    : storage(fileSystem),
+      opened(false),
+      capacityBytes(0),
+      segmentSize(DEFAULT_SEGMENT_SIZE),
+      headSegment(0),
+      diskBytes(0),
+      unread(0),
+      unreadByPriority{},
+      unreadBytes(0),
+      indexDirty(false),
+      lastIndexWrite(0),
+      readFileSegment(0) {}
+
+String MQTTQueueLog::segmentPath(uint32_t segment) const {
+  char name[16];
+  snprintf(name, sizeof(name), "/%08lX.seg", (unsigned long)segment);
+  return dir + name;
+}
+
+String MQTTQueueLog::indexPath() const { return dir + "/index.bin"; }
+
+bool MQTTQueueLog::begin(const char* directory, uint32_t capacity,
+                         uint32_t segmentSizeBytes) {
+  dir = directory;
+  capacityBytes = capacity;
+  segmentSize = segmentSizeBytes;
+  segmentBytes.clear();
+  handedOut.clear();
+  diskBytes = 0;
+  unread = 0;
+  resetUnread();
+
+  File root = storage.open(dir.c_str(), "r");
+  if (!root || !root.isDirectory()) {
+    if (root) root.close();
+    if (!storage.mkdir(dir.c_str())) {
+      LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Cannot create log directory %s\n",
+                    dir.c_str());
+      return false;
+    }
+    root = storage.open(dir.c_str(), "r");
+  }
+
+  LogPosition indexHead;
+  bool hasIndex = readIndex(indexHead);
+
+  // Find the range of live segment files. Segments behind the index head
+  // were fully acknowledged (reboot between index write and delete).
+  bool found = false;
+  uint32_t minSegment = 0;
+  uint32_t maxSegment = 0;
+  File file = root.openNextFile();
+  while (file) {
+    String name = file.name();
+    file.close();
+    if (name.endsWith(".seg")) {
+      uint32_t segment = strtoul(name.c_str(), nullptr, 16);
+      if (hasIndex && segment < indexHead.segment) {
+        storage.remove((dir + "/" + name).c_str());
+      } else {
+        if (!found || segment < minSegment) minSegment = segment;
+        if (!found || segment > maxSegment) maxSegment = segment;
+        found = true;
+      }
+    }
+    file = root.openNextFile();
+  }
+  root.close();
+
+  if (hasIndex) {
+    // Head segment may not exist yet (empty tail) - ids keep increasing
+    headSegment = indexHead.segment;
+    head = indexHead;
+  } else {
+    // Index missing: everything on disk is unacknowledged
+    headSegment = found ? minSegment : 0;
+    head = {headSegment, 0};
+  }
+
+  // Recovery: walk record headers only (payload CRC checked in the tail
+  // segment, the only one a power loss can leave torn)
+  uint32_t tail = found ? maxSegment : headSegment;
+  bool torn = false;
+  for (uint32_t segment = headSegment; segment <= tail; segment++) {
+    uint32_t valid = 0;
+    File seg = storage.open(segmentPath(segment).c_str(), "r");
+    if (seg) {
+      uint32_t fileSize = seg.size();
+      seg.close();
+      uint32_t from = (segment == head.segment) ? head.offset : 0;
+      uint32_t records = 0;
+      valid = scanSegment(segment, fileSize, from, segment == tail, records);
+      if (valid < from) {
+        valid = 0;  // Index points past the data (should not happen)
+      }
+      unread += records;
+      torn = (segment == tail && valid < fileSize);
+    }
+    segmentBytes.push_back(valid);
+    diskBytes += valid;
+  }
+  if (head.offset > segmentBytes.front()) {
+    head.offset = segmentBytes.front();
+  }
+
+  readPos = head;
+  opened = true;
+
+  // Never append behind a torn record
+  if (torn) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] Torn record in segment %lu, starting new one\n",
+                  tail);
+    openNewSegment();
+  }
+  normalize(readPos);
+
+  LOG_MQTT_INFO(
+      "[MQTT_QUEUE] Log recovered: %lu messages, %lu segments, %lu bytes\n",
+      unread, (unsigned long)segmentBytes.size(), diskBytes);
+  return true;
+}
+
+uint32_t MQTTQueueLog::scanSegment(uint32_t segment, uint32_t fileSize,
+                                   uint32_t from, bool verifyCrc,
+                                   uint32_t& records) {
+  records = 0;
+  File seg = storage.open(segmentPath(segment).c_str(), "r");
+  if (!seg) {
+    return 0;
+  }
+
+  uint8_t chunk[256];
+  uint32_t offset = from;
+  while (offset + sizeof(LogRecordHeader) <= fileSize) {
+    LogRecordHeader header;
+    if (!seg.seek(offset) ||
+        seg.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != RECORD_MAGIC) {
+      break;
+    }
+    uint32_t recordSize =
+        sizeof(header) + header.topicLength + header.payloadLength;
+    if (offset + recordSize > fileSize) {
+      break;  // Truncated record
+    }
+
+    if (verifyCrc) {
+      uint32_t crc = 0;
+      uint32_t remaining = header.topicLength + header.payloadLength;
+      while (remaining > 0) {
+        size_t n = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+        if (seg.read(chunk, n) != n) {
+          break;
+        }
+        crc = esp_rom_crc32_le(crc, chunk, n);
+        remaining -= n;
+      }
+      if (remaining > 0 || crc != header.crc) {
+        break;  // Torn write
+      }
+    }
+
+    records++;
+    countUnread(header.priority, header.payloadLength);
+    offset += recordSize;
+  }
+  seg.close();
+  return offset;
+}
+
+bool MQTTQueueLog::readIndex(LogPosition& indexHead) {
+  File file = storage.open(indexPath().c_str(), "r");
+  if (!file) {
+    return false;
+  }
+  IndexFile index;
+  bool valid = file.read((uint8_t*)&index, sizeof(index)) == sizeof(index) &&
+               index.magic == INDEX_MAGIC && index.version == INDEX_VERSION;
+  file.close();
+  if (valid) {
+    indexHead = {index.headSegment, index.headOffset};
+  }
+  return valid;
+}
+
+bool MQTTQueueLog::writeIndex() {
+  IndexFile index = {INDEX_MAGIC, INDEX_VERSION, 0, head.segment, head.offset};
+
+  // Write + rename: a power loss leaves either the old or the new index
+  String tmpPath = dir + "/index.tmp";
+  File file = storage.open(tmpPath.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+  bool ok = file.write((const uint8_t*)&index, sizeof(index)) == sizeof(index);
+  file.close();
+  if (!ok || !storage.rename(tmpPath.c_str(), indexPath().c_str())) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Failed to write log index");
+    return false;
+  }
+
+  indexDirty = false;
+  lastIndexWrite = millis();
+  return true;
+}
+
+void MQTTQueueLog::flushIndex(bool force) {
+  if (!opened || !indexDirty) {
+    return;
+  }
+  if (force || (millis() - lastIndexWrite) >= INDEX_FLUSH_INTERVAL_MS) {
+    writeIndex();
+  }
+}
+
+bool MQTTQueueLog::openNewSegment() {
+  segmentBytes.push_back(0);  // File is created by the first append
+  return true;
+}
+
+void MQTTQueueLog::normalize(LogPosition& position) const {
+  // End of a full segment == start of the next one
+  uint32_t tail = tailSegment();
+  while (position.segment < tail &&
+         position.offset >= segmentBytes[position.segment - headSegment]) {
+    position = {position.segment + 1, 0};
+  }
+}
+
+void MQTTQueueLog::countUnread(uint8_t priority, uint32_t payloadLength) {
+  unreadByPriority[priorityIndex(priority)]++;
+  unreadBytes += payloadLength;
+}
+
+void MQTTQueueLog::uncountUnread(uint8_t priority, uint32_t payloadLength) {
+  uint32_t& count = unreadByPriority[priorityIndex(priority)];
+  count = (count > 0) ? count - 1 : 0;
+  unreadBytes =
+      (unreadBytes > payloadLength) ? unreadBytes - payloadLength : 0;
+}
+
+void MQTTQueueLog::resetUnread() {
+  for (uint8_t i = 0; i < PRIORITY_COUNT; i++) {
+    unreadByPriority[i] = 0;
+  }
+  unreadBytes = 0;
+}
+
+void MQTTQueueLog::closeReadFile() {
+  if (readFile) {
+    readFile.close();
+  }
+}
+
+bool MQTTQueueLog::append(uint16_t messageId, uint8_t priority,
+                          uint32_t timeoutMs, uint32_t enqueuedUnix,
+                          const char* topic, uint16_t topicLength,
+                          const char* payload, uint32_t payloadLength,
+                          LogPosition& position) {
+  if (!opened) {
+    return false;
+  }
+
+  uint32_t recordSize = sizeof(LogRecordHeader) + topicLength + payloadLength;
+  if (diskBytes + recordSize > capacityBytes) {
+    return false;  // Log full
+  }
+
+  // Roll to a new segment when the record does not fit (a record larger
+  // than a segment gets a segment of its own)
+  uint32_t tail = tailSegment();
+  if (validBytes(tail) > 0 && validBytes(tail) + recordSize > segmentSize) {
+    openNewSegment();
+    tail = tailSegment();
+    normalize(readPos);
+    advanceHead();
+  }
+
+  LogRecordHeader header;
+  header.magic = RECORD_MAGIC;
+  header.priority = priority;
+  header.flags = 0;
+  header.messageId = messageId;
+  header.topicLength = topicLength;
+  header.payloadLength = payloadLength;
+  header.timeoutMs = timeoutMs;
+  header.enqueuedUnix = enqueuedUnix;
+  header.crc = esp_rom_crc32_le(0, (const uint8_t*)topic, topicLength);
+  header.crc =
+      esp_rom_crc32_le(header.crc, (const uint8_t*)payload, payloadLength);
+
+  File seg = storage.open(segmentPath(tail).c_str(), "a");
+  if (!seg) {
+    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Cannot open segment %lu\n", tail);
+    return false;
+  }
+  bool ok =
+      seg.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+      seg.write((const uint8_t*)topic, topicLength) == topicLength &&
+      seg.write((const uint8_t*)payload, payloadLength) == payloadLength;
+  seg.close();
+
+  if (!ok) {
+    // Partial record at the end of this segment: continue in a new one
+    LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Write to segment %lu failed\n", tail);
+    openNewSegment();
+    return false;
+  }
+
+  position = {tail, validBytes(tail)};
+  validBytes(tail) += recordSize;
+  diskBytes += recordSize;
+  unread++;
+  countUnread(priority, payloadLength);
+  return true;
+}
+
+bool MQTTQueueLog::claim(const LogPosition& position, uint8_t priority,
+                         uint32_t payloadLength) {
+  normalize(readPos);
+  if (unread != 1 || readPos.segment != position.segment ||
+      readPos.offset != position.offset) {
+    return false;
+  }
+
+  uint32_t nextOffset = validBytes(position.segment);  // Last record
+  handedOut.push_back({position, nextOffset, false, priority, payloadLength});
+  readPos.offset = nextOffset;
+  unread--;
+  uncountUnread(priority, payloadLength);
+  return true;
+}
+
+bool MQTTQueueLog::readNext(LogRecord& record) {
+  while (opened && unread > 0) {
+    normalize(readPos);
+    if (readPos.offset >= validBytes(readPos.segment)) {
+      unread = 0;  // Counter out of sync with the data (tail reached)
+      resetUnread();
+      return false;
+    }
+
+    if (!readFile || readFileSegment != readPos.segment) {
+      closeReadFile();
+      readFile = storage.open(segmentPath(readPos.segment).c_str(), "r");
+      readFileSegment = readPos.segment;
+    }
+
+    LogRecordHeader header;
+    if (!readFile || !readFile.seek(readPos.offset) ||
+        readFile.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != RECORD_MAGIC) {
+      // Unreadable: skip the rest of this segment
+      LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: Bad record at %lu:%lu, skipped\n",
+                    readPos.segment, readPos.offset);
+      diskBytes -= validBytes(readPos.segment) - readPos.offset;
+      validBytes(readPos.segment) = readPos.offset;
+      if (readPos.segment == tailSegment()) {
+        openNewSegment();
+      }
+      closeReadFile();
+      unread--;
+      if (unread == 0) {
+        resetUnread();  // Skipped records were not counted down
+      }
+      continue;
+    }
+
+    // Strings are read through a temporary PSRAM buffer
+    uint32_t bufferSize =
+        (header.topicLength > header.payloadLength ? header.topicLength
+                                                   : header.payloadLength) +
+        1;
+    char* buffer = (char*)heap_caps_malloc(bufferSize,
+                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buffer) {
+      buffer = (char*)heap_caps_malloc(bufferSize, MALLOC_CAP_8BIT);
+    }
+    if (!buffer) {
+      LOG_MQTT_INFO("[MQTT_QUEUE] ERROR: No memory for %lu byte record\n",
+                    bufferSize);
+      return false;  // Retried on the next spool
+    }
+
+    bool ok = readFile.read((uint8_t*)buffer, header.topicLength) ==
+              header.topicLength;
+    buffer[header.topicLength] = '\0';
+    record.topic = (const char*)buffer;
+    ok = ok && readFile.read((uint8_t*)buffer, header.payloadLength) ==
+                   header.payloadLength;
+    buffer[header.payloadLength] = '\0';
+    record.payload = (const char*)buffer;
+    heap_caps_free(buffer);
+
+    uint32_t nextOffset = readPos.offset + sizeof(header) +
+                          header.topicLength + header.payloadLength;
+    record.position = readPos;
+    record.messageId = header.messageId;
+    record.priority = header.priority;
+    record.timeoutMs = header.timeoutMs;
+    record.enqueuedUnix = header.enqueuedUnix;
+
+    handedOut.push_back(
+        {readPos, nextOffset, false, header.priority, header.payloadLength});
+    readPos.offset = nextOffset;
+    unread--;
+    uncountUnread(header.priority, header.payloadLength);
+
+    if (!ok) {
+      // Handed out (and acknowledged) so the head can pass it
+      acknowledge(record.position);
+      continue;
+    }
+    return true;
+  }
+  return false;
+}
+
+void MQTTQueueLog::acknowledge(const LogPosition& position) {
+  if (!opened) {
+    return;
+  }
+  for (auto& entry : handedOut) {
+    if (entry.position.segment == position.segment &&
+        entry.position.offset == position.offset) {
+      entry.acknowledged = true;
+      break;
+    }
+  }
+  advanceHead();
+}
+
+void MQTTQueueLog::advanceHead() {
+  // Head = oldest record not yet acknowledged (log order)
+  while (!handedOut.empty() && handedOut.front().acknowledged) {
+    handedOut.pop_front();
+  }
+  normalize(readPos);  // Must not point into a segment released below
+  LogPosition newHead = handedOut.empty() ? readPos : handedOut.front().position;
+  normalize(newHead);
+
+  // Everything delivered: start a new tail so the full one can be deleted
+  uint32_t tail = tailSegment();
+  if (handedOut.empty() && unread == 0 && newHead.segment == tail &&
+      validBytes(tail) > 0 && newHead.offset >= validBytes(tail)) {
+    openNewSegment();
+    newHead = {tail + 1, 0};
+    readPos = newHead;
+  }
+
+  if (newHead.segment != head.segment || newHead.offset != head.offset) {
+    head = newHead;
+    indexDirty = true;
+  }
+  if (head.segment > headSegment) {
+    releaseSegmentsBefore(head.segment);
+  }
+}
+
+void MQTTQueueLog::releaseSegmentsBefore(uint32_t segment) {
+  // Index first: after a power loss the head never points into a deleted
+  // segment
+  writeIndex();
+
+  while (headSegment < segment && segmentBytes.size() > 1) {
+    if (readFile && readFileSegment == headSegment) {
+      closeReadFile();
+    }
+    storage.remove(segmentPath(headSegment).c_str());
+    diskBytes -= segmentBytes.front();
+    segmentBytes.pop_front();
+    headSegment++;
+  }
+}
+
+void MQTTQueueLog::rewind() {
+  readPos = head;
+  unread += handedOut.size();
+  for (const auto& entry : handedOut) {
+    countUnread(entry.priority, entry.payloadLength);
+  }
+  handedOut.clear();
+  closeReadFile();
+}
+
+void MQTTQueueLog::close() {
+  closeReadFile();
+  opened = false;
+  segmentBytes.clear();
+  handedOut.clear();
+  diskBytes = 0;
+  unread = 0;
+  resetUnread();
+  indexDirty = false;
+}
+
+void MQTTQueueLog::clear() {
+  if (!opened) {
+    return;
+  }
+  closeReadFile();
+  uint32_t tail = tailSegment();
+  for (uint32_t segment = headSegment; segment <= tail; segment++) {
+    storage.remove(segmentPath(segment).c_str());
+  }
+
+  segmentBytes.clear();
+  segmentBytes.push_back(0);
+  headSegment = tail + 1;  // Ids keep increasing
+  head = {headSegment, 0};
+  readPos = head;
+  handedOut.clear();
+  diskBytes = 0;
+  unread = 0;
+  resetUnread();
+  writeIndex();
+}
+
+uint32_t MQTTQueueLog::removeOrphans() {
+  File root = storage.open(dir.c_str(), "r");
+  if (!root) {
+    return 0;
+  }
+
+  uint32_t removed = 0;
+  uint32_t tail = tailSegment();
+  File file = root.openNextFile();
+  while (file) {
+    String name = file.name();
+    file.close();
+
+    bool live = (name == "index.bin");
+    if (name.endsWith(".seg")) {
+      uint32_t segment = strtoul(name.c_str(), nullptr, 16);
+      live = opened && segment >= headSegment && segment <= tail;
+    }
+    if (!live) {
+      storage.remove((dir + "/" + name).c_str());
+      removed++;
+    }
+    file = root.openNextFile();
+  }
+  root.close();
+  return removed;
+}
@@ -0,0 +1,238 @@
+#ifndef MQTT_QUEUE_LOG_H
+#define MQTT_QUEUE_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+
+#include <cstdint>
+#include <deque>
+
+#include "PSRAMAllocator.h"  // PSRAMString + STLPSRAMAllocator
+
+/**
+ * MQTTQueueLog - Segmented append-only record log on LittleFS
+ *
+ * v1.3.3: Storage backend of MQTTPersistentQueue
+ * Previous: One /mqtt_queue/<id>.json file per message (JsonDocument per
+ * write, directory scan + JSON parse of every file at boot, file per message
+ * never removed after delivery).
+ * New: Messages are appended as length-prefixed binary records to fixed-size
+ * segment files (<dir>/<segment>.seg). A small index file stores the head
+ * (oldest unacknowledged record). Delivered records are acknowledged in RAM;
+ * once every record of a segment is acknowledged the whole segment file is
+ * deleted. Writes are sequential, recovery only reads record headers.
+ *
+ * Layout:
+ *   <dir>/index.bin     IndexFile {magic, version, head segment/offset}
+ *   <dir>/00000042.seg  LogRecordHeader + topic + payload, repeated
+ *
+ * Delivery is at-least-once: records acknowledged after the last index write
+ * are sent again after a reboot.
+ *
+ * Not thread-safe: the owner (MQTTPersistentQueue) serializes access.
+ *
+ * v1.3.3: The file system is a constructor argument (LittleFS by default);
+ * MQTTPersistentQueue keeps a second log on the SD card as overflow tier.
+ *
+ * v1.3.3: Unread records are counted per priority and payload bytes
+ * (recovery header walk, append, hand-out), so queue statistics cover the
+ * disk backlog without reading it into RAM.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+// Position of one record in the log
+struct LogPosition {
+  uint32_t segment = 0;
+  uint32_t offset = 0;
+};
+
+// One record read back from the log
+struct LogRecord {
+  LogPosition position;
+  uint16_t messageId = 0;
+  uint8_t priority = 0;
+  uint32_t timeoutMs = 0;
+  uint32_t enqueuedUnix = 0;  // Wall clock at enqueue (0 = unknown)
+  PSRAMString topic;
+  PSRAMString payload;
+};
+
+class MQTTQueueLog {
+ public:
+  static constexpr uint32_t DEFAULT_SEGMENT_SIZE = 32768;  // 32KB per file
+
+  explicit MQTTQueueLog(fs::FS& fileSystem = LittleFS);
+
+  /**
+   * Open (or create) the log in dir and recover head/tail from disk
+   * @param capacityBytes Max bytes of segment files (append fails beyond)
+   * @return false if the directory cannot be used (log stays disabled)
+   */
+  bool begin(const char* dir, uint32_t capacityBytes,
+             uint32_t segmentSize = DEFAULT_SEGMENT_SIZE);
+  bool isOpen() const { return opened; }
+
+  /**
+   * Append one record at the tail (sequential write, rolls segments)
+   * @return false if the log is full or the write failed
+   */
+  bool append(uint16_t messageId, uint8_t priority, uint32_t timeoutMs,
+              uint32_t enqueuedUnix, const char* topic, uint16_t topicLength,
+              const char* payload, uint32_t payloadLength,
+              LogPosition& position);
+
+  /**
+   * Hand out the record just appended without reading it back (only if it
+   * is the next unread record, i.e. nothing older is waiting on disk)
+   */
+  bool claim(const LogPosition& position, uint8_t priority,
+             uint32_t payloadLength);
+
+  /**
+   * Read the next record not yet handed out (read cursor -> RAM queue)
+   * @return false if no unread record is left
+   */
+  bool readNext(LogRecord& record);
+
+  /**
+   * Mark a record delivered/dropped. Fully acknowledged segments behind the
+   * new head are deleted.
+   */
+  void acknowledge(const LogPosition& position);
+
+  /**
+   * Hand out every unacknowledged record again (RAM queue rebuilt)
+   */
+  void rewind();
+
+  /**
+   * Persist the head position (rate limited unless force)
+   */
+  void flushIndex(bool force);
+
+  /**
+   * Forget the in-RAM state without touching the files (storage went away;
+   * begin() recovers from disk again)
+   */
+  void close();
+
+  /**
+   * Close the segment kept open for readNext() (storage may be unmounted
+   * before the next call)
+   */
+  void closeFiles() { closeReadFile(); }
+
+  /**
+   * Delete every segment and reset the index
+   */
+  void clear();
+
+  /**
+   * Remove files in the log directory that are not live segments (legacy
+   * per-message .json files, segments behind the head)
+   * @return Number of files removed
+   */
+  uint32_t removeOrphans();
+
+  uint32_t unreadCount() const { return unread; }
+  uint32_t unreadCount(uint8_t priority) const {
+    return unreadByPriority[priorityIndex(priority)];
+  }
+  uint32_t unreadPayloadBytes() const { return unreadBytes; }
+  uint32_t pendingCount() const { return unread + (uint32_t)handedOut.size(); }
+  uint32_t bytesUsed() const { return diskBytes; }
+  uint32_t capacity() const { return capacityBytes; }
+  void setCapacity(uint32_t bytes) { capacityBytes = bytes; }
+  uint32_t segmentCount() const { return (uint32_t)segmentBytes.size(); }
+
+ private:
+  struct __attribute__((packed)) LogRecordHeader {
+    uint16_t magic;
+    uint8_t priority;
+    uint8_t flags;  // Reserved (0)
+    uint16_t messageId;
+    uint16_t topicLength;
+    uint32_t payloadLength;
+    uint32_t timeoutMs;
+    uint32_t enqueuedUnix;
+    uint32_t crc;  // CRC32 of topic + payload
+  };
+
+  struct __attribute__((packed)) IndexFile {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t headSegment;
+    uint32_t headOffset;
+  };
+
+  // Record handed to the RAM queue, not yet acknowledged (log order)
+  struct HandedOut {
+    LogPosition position;
+    uint32_t nextOffset;  // Offset after the record (head advance)
+    bool acknowledged;
+    uint8_t priority;        // Unread counters after rewind()
+    uint32_t payloadLength;
+  };
+
+  static constexpr uint16_t RECORD_MAGIC = 0x514D;     // "MQ"
+  static constexpr uint32_t INDEX_MAGIC = 0x4D514C47;  // "GLQM"
+  static constexpr uint16_t INDEX_VERSION = 1;
+  static constexpr uint32_t INDEX_FLUSH_INTERVAL_MS = 30000;
+  static constexpr uint8_t PRIORITY_COUNT = 3;  // MessagePriority LOW..HIGH
+
+  fs::FS& storage;
+  bool opened;
+  String dir;
+  uint32_t capacityBytes;
+  uint32_t segmentSize;
+
+  // Live segments [headSegment, tailSegment]; valid bytes per segment
+  std::deque<uint32_t, STLPSRAMAllocator<uint32_t>> segmentBytes;
+  uint32_t headSegment;  // Oldest live segment (segmentBytes.front())
+  LogPosition head;      // Oldest unacknowledged record
+  LogPosition readPos;   // Next record for readNext()
+  uint32_t diskBytes;
+  uint32_t unread;
+  uint32_t unreadByPriority[PRIORITY_COUNT];  // Sums to unread
+  uint32_t unreadBytes;                       // Payload bytes of unread
+
+  std::deque<HandedOut, STLPSRAMAllocator<HandedOut>> handedOut;
+
+  bool indexDirty;
+  unsigned long lastIndexWrite;
+
+  File readFile;  // Segment of readPos kept open while spooling
+  uint32_t readFileSegment;
+
+  String segmentPath(uint32_t segment) const;
+  String indexPath() const;
+  uint32_t tailSegment() const {
+    return headSegment + (uint32_t)segmentBytes.size() - 1;
+  }
+  uint32_t& validBytes(uint32_t segment) {
+    return segmentBytes[segment - headSegment];
+  }
+
+  bool readIndex(LogPosition& indexHead);
+  bool writeIndex();
+  uint32_t scanSegment(uint32_t segment, uint32_t fileSize, uint32_t from,
+                       bool verifyCrc, uint32_t& records);
+  void normalize(LogPosition& position) const;
+  // Out-of-range priorities count as NORMAL (as spooled by the queue)
+  static uint8_t priorityIndex(uint8_t priority) {
+    return priority < PRIORITY_COUNT ? priority : 1;
+  }
+  void countUnread(uint8_t priority, uint32_t payloadLength);
+  void uncountUnread(uint8_t priority, uint32_t payloadLength);
+  void resetUnread();
+  void closeReadFile();
+  void advanceHead();
+  void releaseSegmentsBefore(uint32_t segment);
+  bool openNewSegment();
+};
+
+#endif  // MQTT_QUEUE_LOG_H
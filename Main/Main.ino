@@ -55,8 +55,15 @@ uint8_t g_productionMode = PRODUCTION_MODE;
 #include "ButtonManager.h"
 #include "OTACrudBridge.h"    // v2.5.35: Bridge to OTA (avoids ESP_SSLClient linker error)
 #include "GatewayConfig.h"    // v2.5.31: Multi-gateway support
+#include "TaskProfiler.h"     // v1.3.3: Task CPU / stack / queue profiling
+#include "SDCardManager.h"    // v1.3.3: SD card overflow tier for the MQTT queue
+#include "ModbusTcpServer.h"  // v1.3.3: Modbus TCP server (latest values)
+#include "TaskAffinity.h"     // v1.3.3: Staged boot tasks
+#include "TrendHistory.h"     // v1.3.3: Short-term register history
+#include "AcquisitionCycle.h" // v1.3.3: Aligned snapshot cycles
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/event_groups.h>  // v1.3.3: Staged boot
 #include <esp_heap_caps.h>
 #include <esp_psram.h>
 #include <esp_system.h>
@@ -77,6 +84,7 @@ ModbusRtuService *modbusRtuService = nullptr;
 QueueManager *queueManager = nullptr;
 MqttManager *mqttManager = nullptr;
 HttpManager *httpManager = nullptr;
+ModbusTcpServer *modbusTcpServer = nullptr;  // v1.3.3
 LEDManager *ledManager = nullptr;
 ButtonManager *buttonManager = nullptr;
 ProductionLogger *productionLogger = nullptr;
@@ -135,6 +143,13 @@ void cleanup()
     httpManager = nullptr;
   }
 
+  // v1.3.3: Singleton with a private destructor - stop the task only
+  if (modbusTcpServer)
+  {
+    modbusTcpServer->stop();
+    modbusTcpServer = nullptr;
+  }
+
   if (modbusRtuService)
   {
     modbusRtuService->stop();
@@ -209,11 +224,196 @@ void cleanup()
   DEV_SERIAL_PRINTLN("[CLEANUP] All resources released");
 }
 
+// ============================================
+// v1.3.3: STAGED BOOT
+// Previous: setup() ran every stage in sequence - Modbus polling, BLE
+// advertising and queue recovery waited behind network bring-up (WiFi
+// association up to ~11 s, Ethernet DHCP up to 60 s).
+// New: two one-shot tasks run the slow stages next to setup():
+// - BOOT_NETWORK: NetworkMgr::init, then starts the active publisher and
+//   the Modbus TCP server once the config and the publishers are ready
+// - BOOT_RECOVERY: MQTT / HTTP manager init (persistent queue recovery)
+// setup() meanwhile loads the device config, starts RTC sync and the Modbus
+// services, links the publishers to the CRUD handler and starts BLE.
+// Dependencies are event group bits. A failing setup() calls abortBoot(),
+// which waits for both tasks before cleanup().
+// ============================================
+constexpr EventBits_t BOOT_CONFIG_READY = BIT0;      // Device config loaded
+constexpr EventBits_t BOOT_PUBLISHERS_READY = BIT1;  // BOOT_RECOVERY finished
+constexpr EventBits_t BOOT_NETWORK_DONE = BIT2;      // BOOT_NETWORK finished
+constexpr EventBits_t BOOT_ABORTED = BIT3;           // setup() failed
+constexpr uint32_t BOOT_TASK_STACK_SIZE = 8192;
+
+static EventGroupHandle_t bootEvents = nullptr;
+static bool bootNetworkInitialized = false;
+static bool mqttInitialized = false;
+static bool httpInitialized = false;
+
+// FIXED BUG #11: Proper handling of network init failure
+// Previous code continued without network, causing MQTT/HTTP failures
+static bool bootInitNetwork()
+{
+  if (!networkManager->init(serverConfig))
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] WARNING: NetworkManager init failed - network services will be disabled");
+    DEV_SERIAL_PRINTLN("[MAIN] System will continue in offline mode (BLE/Modbus RTU only)");
+    return false;
+  }
+  DEV_SERIAL_PRINTF("[BOOT] NetworkManager initialized at %lu ms\n", (unsigned long)millis());
+  return true;
+}
+
+// Start the active protocol manager and the Modbus TCP server
+// (after BOOT_CONFIG_READY and BOOT_PUBLISHERS_READY)
+static void bootStartNetworkServices()
+{
+  if (xEventGroupGetBits(bootEvents) & BOOT_ABORTED)
+  {
+    return;
+  }
+
+  // FIXED BUG #11: Start MQTT/HTTP only if network is available
+  if (!bootNetworkInitialized)
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] Skipping MQTT/HTTP Manager start - network not initialized");
+    return;
+  }
+
+  String protocol = serverConfig->getProtocol();
+  DEV_SERIAL_PRINTF("[MAIN] Selected protocol: %s\n", protocol.c_str());
+
+  if (mqttInitialized)
+  {
+    if (protocol == "mqtt")
+    {
+      mqttManager->start();
+      DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager started (active protocol)");
+    }
+    else
+    {
+      DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager initialized but not started (inactive protocol)");
+    }
+  }
+
+  if (httpInitialized)
+  {
+    if (protocol == "http")
+    {
+      httpManager->start();
+      DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager started (active protocol)");
+    }
+    else
+    {
+      DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager initialized but not started (inactive protocol)");
+    }
+  }
+
+  // v1.3.3: Modbus TCP server (serves the polled values, "modbus_server")
+  modbusTcpServer = ModbusTcpServer::getInstance();
+  if (modbusTcpServer->init(serverConfig))
+  {
+    if (modbusTcpServer->start())
+    {
+      DEV_SERIAL_PRINTLN("[MAIN] Modbus TCP server started");
+    }
+    else
+    {
+      DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to start Modbus TCP server");
+    }
+  }
+
+  if (productionLogger)
+  {
+    // Set initial network status based on actual active network
+    // v2.5.35: Fixed hardcoded ETH - now checks actual network mode
+    String activeMode = networkManager->getCurrentMode();
+    if (activeMode == "WIFI")
+    {
+      productionLogger->setNetworkStatus(NetStatus::WIFI);
+    }
+    else if (activeMode == "ETH")
+    {
+      productionLogger->setNetworkStatus(NetStatus::ETHERNET);
+    }
+    else
+    {
+      productionLogger->setNetworkStatus(NetStatus::NONE);
+    }
+
+    // Set protocol status
+    if (mqttInitialized && protocol == "mqtt")
+    {
+      productionLogger->setMqttStatus(ProtoStatus::CONNECTING);
+    }
+    else if (httpInitialized && protocol == "http")
+    {
+      productionLogger->setHttpStatus(ProtoStatus::CONNECTING);
+    }
+  }
+
+  DEV_SERIAL_PRINTF("[BOOT] Network services started at %lu ms\n", (unsigned long)millis());
+}
+
+void bootNetworkTask(void *parameter)
+{
+  bootNetworkInitialized = bootInitNetwork();
+
+  // The publishers read the device config and their recovered queues
+  xEventGroupWaitBits(bootEvents, BOOT_CONFIG_READY | BOOT_PUBLISHERS_READY,
+                      pdFALSE, pdTRUE, portMAX_DELAY);
+  bootStartNetworkServices();
+
+  xEventGroupSetBits(bootEvents, BOOT_NETWORK_DONE);
+  vTaskDelete(NULL);
+}
+
+// MQTT persistent queue recovery and protocol config (no network needed)
+static void bootRecoverPublishers()
+{
+  mqttManager = MqttManager::getInstance(configManager, serverConfig, networkManager);
+  mqttInitialized = mqttManager && mqttManager->init();
+  if (!mqttInitialized)
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize MQTT Manager");
+  }
+
+  httpManager = HttpManager::getInstance(configManager, serverConfig, networkManager);
+  httpInitialized = httpManager && httpManager->init();
+  if (!httpInitialized)
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize HTTP Manager");
+  }
+
+  DEV_SERIAL_PRINTF("[BOOT] Publishers recovered at %lu ms\n", (unsigned long)millis());
+}
+
+void bootRecoveryTask(void *parameter)
+{
+  bootRecoverPublishers();
+
+  xEventGroupSetBits(bootEvents, BOOT_PUBLISHERS_READY);
+  vTaskDelete(NULL);
+}
+
+// Failure after the boot tasks were spawned: wait for them before cleanup()
+// (they use the objects cleanup() releases)
+static void abortBoot()
+{
+  xEventGroupSetBits(bootEvents, BOOT_ABORTED | BOOT_CONFIG_READY);
+  xEventGroupWaitBits(bootEvents, BOOT_PUBLISHERS_READY | BOOT_NETWORK_DONE,
+                      pdFALSE, pdTRUE, portMAX_DELAY);
+  cleanup();
+}
+
 void setup()
 {
   Serial.begin(115200);
   vTaskDelay(pdMS_TO_TICKS(1000));
 
+  // v1.3.3: LOG_* lines are queued and written by a low-priority drain task
+  // (no Serial formatting/writes in the calling task)
+  LogSink::getInstance()->begin();
+
   // ============================================
   // CRITICAL: LOAD PRODUCTION MODE FROM CONFIG FIRST
   // ============================================
@@ -307,6 +507,53 @@ void setup()
 
   DEV_SERIAL_PRINTLN("[MAIN] Starting BLE CRUD Manager...");
 
+  // Initialize server config
+  // v1.3.3: Before the device config - the network stage only needs this
+  serverConfig = new ServerConfig();
+  if (!serverConfig || !serverConfig->begin())
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize ServerConfig");
+    cleanup();
+    return;
+  }
+
+  // NOTE: LoggingConfig already initialized at start of setup() to load production mode early
+  // No need to re-initialize here
+
+  networkManager = NetworkMgr::getInstance();
+  if (!networkManager)
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to get NetworkManager instance");
+    cleanup();
+    return;
+  }
+
+  // ============================================
+  // PRODUCTION LOGGER INITIALIZATION (Always init, enable based on mode)
+  // ============================================
+  // Always initialize ProductionLogger (supports runtime mode switching)
+  // v1.3.3: Initialized before the boot tasks (BOOT_NETWORK sets its
+  // network and protocol status)
+  productionLogger = ProductionLogger::getInstance();
+  if (productionLogger)
+  {
+    productionLogger->begin(FIRMWARE_VERSION, DEVICE_ID);
+    productionLogger->setHeartbeatInterval(60000);  // Heartbeat every 60 seconds
+    productionLogger->setJsonFormat(true);          // Use JSON format for parsing
+    productionLogger->setActiveProtocol(serverConfig->getProtocol());
+    productionLogger->setEnabled(IS_PRODUCTION_MODE()); // Enable only in production mode
+    DEV_SERIAL_PRINTLN("[MAIN] Production Logger initialized");
+  }
+
+  // v1.3.3: Staged boot dependencies
+  bootEvents = xEventGroupCreate();
+  if (!bootEvents)
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to create boot event group");
+    cleanup();
+    return;
+  }
+
   // Initialize configuration manager in PSRAM
   configManager = (ConfigManager *)heap_caps_malloc(sizeof(ConfigManager), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
   if (configManager)
@@ -321,32 +568,11 @@ void setup()
     if (!configManager)
     {
       DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to allocate ConfigManager");
+      cleanup();
       return;
     }
   }
 
-  if (!configManager->begin())
-  {
-    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize ConfigManager");
-    cleanup();
-    return;
-  }
-
-  // Debug: Show devices file content (runtime check)
-  if (IS_DEV_MODE())
-  {
-    configManager->debugDevicesFile();
-  }
-
-  // Pre-load the cache once to prevent race conditions from other tasks
-  DEV_SERIAL_PRINTLN("[MAIN] Forcing initial cache load...");
-  configManager->refreshCache();
-
-  // FIXED: Removed automatic config clear - only clear manually when needed
-  // configManager->clearAllConfigurations();  // DISABLED - Uncomment only for factory reset
-
-  DEV_SERIAL_PRINTLN("[MAIN] Configuration initialization completed.");
-
   // Initialize LED Manager
   ledManager = LEDManager::getInstance();
   if (ledManager)
@@ -369,43 +595,50 @@ void setup()
     return;
   }
 
-  // Initialize server config
-  serverConfig = new ServerConfig();
-  if (!serverConfig || !serverConfig->begin())
+  // v1.3.3: Task profiler sampler (non-fatal: diagnostics only)
+  TaskProfiler::getInstance()->begin();
+
+  // v1.3.3: Register history pool - before the polling tasks feed it
+  // (non-fatal: disabled or no PSRAM only loses the BLE trend query)
+  if (!TrendHistory::getInstance()->init(serverConfig))
   {
-    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize ServerConfig");
-    cleanup();
-    return;
+    DEV_SERIAL_PRINTLN("[MAIN] Register history not active");
   }
 
-  // NOTE: LoggingConfig already initialized at start of setup() to load production mode early
-  // No need to re-initialize here
-
-  // FIXED BUG #11: Proper handling of network init failure
-  // Previous code continued without network, causing MQTT/HTTP failures
-  bool networkInitialized = false;
+  // v1.3.3: Snapshot cycles - before the polling tasks align their deadlines
+  // (false = free-running acquisition, the default)
+  AcquisitionCycle::getInstance()->init(serverConfig);
 
-  networkManager = NetworkMgr::getInstance();
-  if (!networkManager)
+#if SD_CARD_ENABLED
+  // v1.3.3: SD card (MQTT persistent queue overflow tier) - mounted before
+  // MqttManager opens the queue; a missing card is mounted when inserted
+  SDCardManager *sdCardManager = SDCardManager::getInstance();
+  if (!sdCardManager->init() || !sdCardManager->start())
   {
-    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to get NetworkManager instance");
-    cleanup();
-    return;
+    DEV_SERIAL_PRINTLN("[MAIN] WARNING: SD card manager not started");
   }
+#endif
 
-  if (!networkManager->init(serverConfig))
+  // v1.3.3: Boot tasks - queue recovery first (the network stage waits for it)
+  if (TaskAffinity::create(bootRecoveryTask, "BOOT_RECOVERY", BOOT_TASK_STACK_SIZE,
+                           nullptr, TaskAffinity::Task::BOOT_RECOVERY, nullptr) != pdPASS)
   {
-    DEV_SERIAL_PRINTLN("[MAIN] WARNING: NetworkManager init failed - network services will be disabled");
-    DEV_SERIAL_PRINTLN("[MAIN] System will continue in offline mode (BLE/Modbus RTU only)");
-    networkInitialized = false;
+    DEV_SERIAL_PRINTLN("[MAIN] WARNING: BOOT_RECOVERY task not created - recovering inline");
+    bootRecoverPublishers();
+    xEventGroupSetBits(bootEvents, BOOT_PUBLISHERS_READY);
   }
-  else
+
+  bool networkInline = false;
+  if (TaskAffinity::create(bootNetworkTask, "BOOT_NETWORK", BOOT_TASK_STACK_SIZE,
+                           nullptr, TaskAffinity::Task::BOOT_NETWORK, nullptr) != pdPASS)
   {
-    DEV_SERIAL_PRINTLN("[MAIN] NetworkManager initialized successfully");
-    networkInitialized = true;
+    DEV_SERIAL_PRINTLN("[MAIN] WARNING: BOOT_NETWORK task not created - initializing network inline");
+    bootNetworkInitialized = bootInitNetwork();
+    xEventGroupSetBits(bootEvents, BOOT_NETWORK_DONE);
+    networkInline = true;  // Services started below, after the config
   }
 
-  // Initialize RTC manager
+  // Initialize RTC manager (sync task waits for the network itself)
   rtcManager = RTCManager::getInstance();
   if (!rtcManager || !rtcManager->init())
   {
@@ -416,6 +649,29 @@ void setup()
     rtcManager->startSync();
   }
 
+  if (!configManager->begin())
+  {
+    DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize ConfigManager");
+    abortBoot();
+    return;
+  }
+
+  // Debug: Show devices file content (runtime check)
+  if (IS_DEV_MODE())
+  {
+    configManager->debugDevicesFile();
+  }
+
+  // Pre-load the cache once to prevent race conditions from other tasks
+  DEV_SERIAL_PRINTLN("[MAIN] Forcing initial cache load...");
+  configManager->refreshCache();
+
+  // FIXED: Removed automatic config clear - only clear manually when needed
+  // configManager->clearAllConfigurations();  // DISABLED - Uncomment only for factory reset
+
+  DEV_SERIAL_PRINTLN("[MAIN] Configuration initialization completed.");
+  xEventGroupSetBits(bootEvents, BOOT_CONFIG_READY);
+
   // Initialize Modbus TCP service (watchdog-safe implementation)
   EthernetManager *ethernetMgr = EthernetManager::getInstance();
   if (ethernetMgr)
@@ -451,7 +707,7 @@ void setup()
     if (!crudHandler)
     {
       DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to allocate CRUDHandler");
-      cleanup();
+      abortBoot();
       return;
     }
   }
@@ -483,78 +739,27 @@ void setup()
     DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize Modbus RTU service");
   }
 
-  // Initialize protocol managers based on server configuration
-  String protocol = serverConfig->getProtocol();
-  DEV_SERIAL_PRINTF("[MAIN] Selected protocol: %s\n", protocol.c_str());
+  DEV_SERIAL_PRINTF("[BOOT] Modbus services started at %lu ms\n", (unsigned long)millis());
 
-  // FIXED BUG #11: Initialize MQTT only if network is available
-  if (networkInitialized)
+  // v1.3.3: Link the recovered protocol managers to the CRUD handler for
+  // config change notifications (before BLE accepts commands)
+  xEventGroupWaitBits(bootEvents, BOOT_PUBLISHERS_READY, pdFALSE, pdTRUE, portMAX_DELAY);
+  if (crudHandler && mqttInitialized)
   {
-    mqttManager = MqttManager::getInstance(configManager, serverConfig, networkManager);
-    if (mqttManager && mqttManager->init())
-    {
-      // Link MQTT Manager to CRUD Handler for config change notifications
-      if (crudHandler)
-      {
-        crudHandler->setMqttManager(mqttManager);
-        DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager linked to CRUD Handler");
-      }
-
-      if (protocol == "mqtt")
-      {
-        mqttManager->start();
-        DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager started (active protocol)");
-      }
-      else
-      {
-        DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager initialized but not started (inactive protocol)");
-      }
-    }
-    else
-    {
-      DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize MQTT Manager");
-    }
+    crudHandler->setMqttManager(mqttManager);
+    DEV_SERIAL_PRINTLN("[MAIN] MQTT Manager linked to CRUD Handler");
   }
-  else
+  if (crudHandler && httpInitialized)
   {
-    DEV_SERIAL_PRINTLN("[MAIN] Skipping MQTT Manager - network not initialized");
+    crudHandler->setHttpManager(httpManager);
+    DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager linked to CRUD Handler");
   }
 
-  // FIXED BUG #11: Initialize HTTP only if network is available
-  if (networkInitialized)
-  {
-    httpManager = HttpManager::getInstance(configManager, serverConfig, networkManager);
-    if (httpManager && httpManager->init())
-    {
-      // Link HTTP Manager to CRUD Handler for config change notifications
-      if (crudHandler)
-      {
-        crudHandler->setHttpManager(httpManager);
-        DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager linked to CRUD Handler");
-      }
-
-      if (protocol == "http")
-      {
-        httpManager->start();
-        DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager started (active protocol)");
-      }
-      else
-      {
-        DEV_SERIAL_PRINTLN("[MAIN] HTTP Manager initialized but not started (inactive protocol)");
-      }
-    }
-    else
-    {
-      DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize HTTP Manager");
-    }
-  }
-  else
+  if (networkInline)
   {
-    DEV_SERIAL_PRINTLN("[MAIN] Skipping HTTP Manager - network not initialized");
+    bootStartNetworkServices();
   }
 
-  // CRUDHandler already initialized above
-
   // v2.5.31: Initialize Gateway Config (unique BLE name from MAC)
   gatewayConfig = GatewayConfig::getInstance();
   if (!gatewayConfig || !gatewayConfig->begin())
@@ -583,7 +788,7 @@ void setup()
     if (!bleManager)
     {
       DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to allocate BLE Manager");
-      cleanup();
+      abortBoot();
       return;
     }
   }
@@ -600,7 +805,7 @@ void setup()
   else
   {
     DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize Button Manager");
-    cleanup();
+    abortBoot();
     return;
   }
 
@@ -613,7 +818,7 @@ void setup()
     if (!bleManager->begin())
     {
       DEV_SERIAL_PRINTLN("[MAIN] ERROR: Failed to initialize BLE Manager");
-      cleanup();
+      abortBoot();
       return;
     }
     DEV_SERIAL_PRINTLN("[MAIN] BLE started (Development mode)");
@@ -669,50 +874,8 @@ void setup()
     DEV_SERIAL_PRINTLN("[MAIN] WARNING: Failed to get OTA Manager instance");
   }
 
-  // ============================================
-  // PRODUCTION LOGGER INITIALIZATION (Always init, enable based on mode)
-  // ============================================
-  // Always initialize ProductionLogger (supports runtime mode switching)
-  productionLogger = ProductionLogger::getInstance();
-  if (productionLogger)
-  {
-    productionLogger->begin(FIRMWARE_VERSION, DEVICE_ID);
-    productionLogger->setHeartbeatInterval(60000);  // Heartbeat every 60 seconds
-    productionLogger->setJsonFormat(true);          // Use JSON format for parsing
-    productionLogger->setActiveProtocol(serverConfig->getProtocol());
-    productionLogger->setEnabled(IS_PRODUCTION_MODE()); // Enable only in production mode
-
-    // Set initial network status based on actual active network
-    // v2.5.35: Fixed hardcoded ETH - now checks actual network mode
-    if (networkInitialized && networkManager)
-    {
-      String activeMode = networkManager->getCurrentMode();
-      if (activeMode == "WIFI")
-      {
-        productionLogger->setNetworkStatus(NetStatus::WIFI);
-      }
-      else if (activeMode == "ETH")
-      {
-        productionLogger->setNetworkStatus(NetStatus::ETHERNET);
-      }
-      else
-      {
-        productionLogger->setNetworkStatus(NetStatus::NONE);
-      }
-    }
-
-    // Set protocol status
-    if (mqttManager && serverConfig->getProtocol() == "mqtt")
-    {
-      productionLogger->setMqttStatus(ProtoStatus::CONNECTING);
-    }
-    else if (httpManager && serverConfig->getProtocol() == "http")
-    {
-      productionLogger->setHttpStatus(ProtoStatus::CONNECTING);
-    }
-
-    DEV_SERIAL_PRINTLN("[MAIN] Production Logger initialized");
-  }
+  // v1.3.3: The network stage may still be running (BOOT_NETWORK)
+  DEV_SERIAL_PRINTF("[BOOT] setup() finished at %lu ms\n", (unsigned long)millis());
 
   // System ready message based on mode
   if (IS_DEV_MODE())
@@ -779,6 +942,20 @@ void loop()
     }
     productionLogger->logModbusStats(totalSuccess, totalFailed);
 
+    // v1.3.3: Bus capacity - busiest RTU bus / TCP endpoint, missed deadlines
+    uint8_t rtuPeak = 0, tcpPeak = 0;
+    uint32_t rtuMissed = 0, tcpMissed = 0;
+    if (modbusRtuService)
+    {
+      modbusRtuService->getCapacitySummary(rtuPeak, rtuMissed);
+    }
+    if (modbusTcpService)
+    {
+      modbusTcpService->getCapacitySummary(tcpPeak, tcpMissed);
+    }
+    productionLogger->logModbusCapacity(rtuPeak, tcpPeak,
+                                        rtuMissed + tcpMissed);
+
     productionLogger->heartbeat();
   }
 
@@ -0,0 +1,27 @@
+#include "MbapFrame.h"
+
+uint16_t MbapFrameAssembler::wanted() const {
+  if (received < MbapFrame::HEADER_SIZE) {
+    return MbapFrame::HEADER_SIZE - received;
+  }
+  return MbapFrame::HEADER_SIZE + lengthField() - received;
+}
+
+MbapFrameAssembler::Result MbapFrameAssembler::commit(uint16_t bytes) {
+  received += bytes;
+  if (received < MbapFrame::HEADER_SIZE) {
+    return Result::INCOMPLETE;
+  }
+  if (received - bytes < MbapFrame::HEADER_SIZE) {
+    // Header just completed: check it before trusting its length
+    uint16_t protocolId = ((uint16_t)frame[2] << 8) | frame[3];
+    uint16_t length = lengthField();
+    if (protocolId != 0 || length < MbapFrame::MIN_LENGTH_FIELD ||
+        MbapFrame::HEADER_SIZE + length > MbapFrame::MAX_ADU_SIZE) {
+      return Result::INVALID;
+    }
+  }
+  return (received == MbapFrame::HEADER_SIZE + lengthField())
+             ? Result::COMPLETE
+             : Result::INCOMPLETE;
+}
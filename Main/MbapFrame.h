@@ -0,0 +1,54 @@
+#ifndef MBAP_FRAME_H
+#define MBAP_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * MbapFrame - Modbus TCP request framing (MBAP header + PDU)
+ *
+ * v1.3.3: Reassembles one request from a client socket, whatever the TCP
+ * segmentation: the 6 header bytes first (transaction, protocol, length),
+ * then exactly the length they announce. wanted() never reaches into the
+ * next request, so pipelined requests stay in the socket until the current
+ * one is answered.
+ *
+ * Plain data (no constructor): ModbusTcpServer keeps it in calloc'd PSRAM
+ * client slots, so zeroed memory is an empty frame.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace MbapFrame {
+constexpr uint16_t HEADER_SIZE = 6;       // Up to and including the length
+constexpr uint16_t MAX_ADU_SIZE = 260;    // MBAP (7) + PDU (253)
+constexpr uint16_t MIN_LENGTH_FIELD = 2;  // Unit ID + function code
+}  // namespace MbapFrame
+
+struct MbapFrameAssembler {
+  enum class Result : uint8_t { INCOMPLETE, COMPLETE, INVALID };
+
+  uint16_t received;  // Bytes of the current frame
+  uint8_t frame[MbapFrame::MAX_ADU_SIZE];
+
+  void reset() { received = 0; }
+
+  // Bytes to read next: the rest of the header, then the rest of the frame
+  uint16_t wanted() const;
+  uint8_t* writePointer() { return frame + received; }
+
+  /**
+   * Account for bytes read into writePointer() (at most wanted())
+   * @return COMPLETE when frame[0..received) holds one whole request,
+   *         INVALID for a bad header (protocol ID != 0 or length out of
+   *         range; close the connection, the stream cannot be resynced)
+   */
+  Result commit(uint16_t bytes);
+
+  // MBAP length field (valid once the header is in)
+  uint16_t lengthField() const {
+    return ((uint16_t)frame[4] << 8) | frame[5];
+  }
+};
+
+#endif  // MBAP_FRAME_H
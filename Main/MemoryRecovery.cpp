@@ -22,6 +22,10 @@ bool MemoryRecovery::autoRecoveryEnabled = true;
 // v2.3.14 FIX: Changed to atomic for thread-safety (prevents race condition)
 static std::atomic<bool> inRecoveryCall{false};
 
+// v1.3.3: Current MemoryPressure (read lock-free by producers)
+static std::atomic<uint8_t> pressureLevel{
+    static_cast<uint8_t>(MemoryPressure::GREEN)};
+
 // ============================================
 // CORE FUNCTIONS IMPLEMENTATION
 // ============================================
@@ -36,12 +40,6 @@ RecoveryAction MemoryRecovery::checkAndRecover() {
   // Set guard flag
   inRecoveryCall = true;
 
-  // Auto-recovery disabled - skip check
-  if (!autoRecoveryEnabled) {
-    inRecoveryCall = false;  // Release guard
-    return RECOVERY_NONE;
-  }
-
   unsigned long now = millis();
 
   // Throttle memory checks to avoid overhead
@@ -55,6 +53,16 @@ RecoveryAction MemoryRecovery::checkAndRecover() {
   uint32_t freeDram = ESP.getFreeHeap();
   uint32_t freePsram = ESP.getFreePsram();
 
+  // v1.3.3: Pressure level is tracked even with auto-recovery disabled
+  // (producers back off first, the tiers below are the last resort)
+  updatePressure(freeDram, freePsram);
+
+  // Auto-recovery disabled - skip recovery tiers
+  if (!autoRecoveryEnabled) {
+    inRecoveryCall = false;  // Release guard
+    return RECOVERY_NONE;
+  }
+
   // ============================================
   // TIER 1: EMERGENCY (< 8KB DRAM) - v2.5.1 adjusted threshold
   // ============================================
@@ -339,20 +347,9 @@ int MemoryRecovery::executeQueueFlush(int entriesToFlush) {
     return 0;
   }
 
-  int flushed = 0;
-  JsonDocument tempDoc;
-
-  for (int i = 0; i < entriesToFlush; i++) {
-    JsonObject tempObj = tempDoc.to<JsonObject>();
-    if (queueMgr->dequeue(tempObj)) {
-      flushed++;
-    } else {
-      break;  // Queue empty
-    }
-    tempDoc.clear();  // Clear for next iteration
-  }
-
-  return flushed;
+  // v1.3.3: Ring is preallocated - skipping the oldest records of every
+  // consumer is enough (no per-record JSON expansion)
+  return queueMgr->discard(entriesToFlush);
 }
 
 int MemoryRecovery::executeMqttQueueCleanup() {
@@ -461,8 +458,11 @@ uint32_t MemoryRecovery::getEstimatedDeviceCapacity() {
   uint32_t freeDram = ESP.getFreeHeap();
 
   // Reserve minimum memory for system stability
+  // v1.3.3: DRAM reserve lowered from 30KB to the RED watermark - idle DRAM
+  // with BLE active is ~15-20KB, so the estimate was 0 on a healthy gateway
+  // and could not drive admission control (canAdmitDevice)
   const uint32_t PSRAM_RESERVE = 1000000;  // 1MB reserve
-  const uint32_t DRAM_RESERVE = 30000;     // 30KB reserve
+  const uint32_t DRAM_RESERVE = MemoryThresholds::DRAM_CRITICAL;
 
   uint32_t availablePsram =
       (freePsram > PSRAM_RESERVE) ? (freePsram - PSRAM_RESERVE) : 0;
@@ -476,3 +476,90 @@ uint32_t MemoryRecovery::getEstimatedDeviceCapacity() {
   // Return the lower of the two (limiting factor)
   return (psramCapacity < dramCapacity) ? psramCapacity : dramCapacity;
 }
+
+// ============================================
+// BACKPRESSURE (v1.3.3)
+// ============================================
+
+MemoryPressure MemoryRecovery::updatePressure(uint32_t freeDram,
+                                              uint32_t freePsram) {
+  auto classify = [&](uint32_t marginPercent) {
+    auto below = [&](uint32_t freeBytes, uint32_t threshold) {
+      return freeBytes <
+             threshold + (uint32_t)((uint64_t)threshold * marginPercent / 100);
+    };
+    if (below(freeDram, MemoryThresholds::DRAM_CRITICAL) ||
+        below(freePsram, MemoryThresholds::PSRAM_CRITICAL)) {
+      return MemoryPressure::RED;
+    }
+    if (below(freeDram, MemoryThresholds::DRAM_WARNING) ||
+        below(freePsram, MemoryThresholds::PSRAM_WARNING)) {
+      return MemoryPressure::YELLOW;
+    }
+    return MemoryPressure::GREEN;
+  };
+
+  MemoryPressure previous = getPressure();
+  MemoryPressure level = classify(0);
+  if (level < previous) {
+    // Step down only as far as the release margin allows
+    MemoryPressure held =
+        classify(MemoryThresholds::PRESSURE_RELEASE_PERCENT);
+    if (held > level) level = held;
+  }
+
+  if (level != previous) {
+    pressureLevel = static_cast<uint8_t>(level);
+    if (level > previous) {
+      LOG_MEM_WARN("Memory pressure %s -> %s (DRAM %lu, PSRAM %lu bytes)\n",
+                   getPressureName(previous), getPressureName(level),
+                   (unsigned long)freeDram, (unsigned long)freePsram);
+    } else {
+      LOG_MEM_INFO("Memory pressure %s -> %s (DRAM %lu, PSRAM %lu bytes)\n",
+                   getPressureName(previous), getPressureName(level),
+                   (unsigned long)freeDram, (unsigned long)freePsram);
+    }
+  }
+  return level;
+}
+
+MemoryPressure MemoryRecovery::getPressure() {
+  return static_cast<MemoryPressure>(pressureLevel.load());
+}
+
+MemoryPressure MemoryRecovery::samplePressure() {
+  return updatePressure(ESP.getFreeHeap(), ESP.getFreePsram());
+}
+
+uint32_t MemoryRecovery::backpressureFactor() {
+  switch (getPressure()) {
+    case MemoryPressure::RED:
+      return 4;
+    case MemoryPressure::YELLOW:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+uint32_t MemoryRecovery::applyBackpressure(uint32_t intervalMs) {
+  return intervalMs * backpressureFactor();
+}
+
+const char* MemoryRecovery::getPressureName(MemoryPressure level) {
+  switch (level) {
+    case MemoryPressure::RED:
+      return "red";
+    case MemoryPressure::YELLOW:
+      return "yellow";
+    default:
+      return "green";
+  }
+}
+
+bool MemoryRecovery::canAdmitDevice() {
+  if (samplePressure() == MemoryPressure::RED) {
+    return false;
+  }
+  return getEstimatedDeviceCapacity() > 0;
+}
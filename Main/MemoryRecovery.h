@@ -17,6 +17,17 @@
  * - Zero manual intervention required
  *
  * Integration: Call MemoryRecovery::checkAndRecover() in main task loops
+ *
+ * v1.3.3: Backpressure from memory watermarks
+ * Previous: the only reaction to low memory was the recovery tiers below -
+ * flushing queue entries and persistent MQTT messages once memory was
+ * already short, i.e. dropping data.
+ * New: every check also classifies memory into a pressure level (GREEN /
+ * YELLOW / RED, see MemoryPressure) that producers consult before they
+ * allocate: Modbus services stretch their poll intervals, HTTP batches more
+ * records per request, MQTT publishes less often, BLE defers large
+ * responses and new devices are refused while RED. The recovery tiers stay
+ * as the last resort.
  */
 
 // ============================================
@@ -39,6 +50,10 @@ constexpr uint32_t DRAM_EMERGENCY =
 // PSRAM thresholds (ESP32-S3 has 8MB OPI PSRAM)
 constexpr uint32_t PSRAM_WARNING = 1000000;  // 1MB - Warn if PSRAM low
 constexpr uint32_t PSRAM_CRITICAL = 500000;  // 500KB - Critical PSRAM
+
+// v1.3.3: Pressure levels step down only once free memory is this far
+// (percent) above the threshold that raised them (no flapping at the edge)
+constexpr uint32_t PRESSURE_RELEASE_PERCENT = 25;
 }  // namespace MemoryThresholds
 
 // ============================================
@@ -52,6 +67,15 @@ enum RecoveryAction {
   RECOVERY_EMERGENCY_RESTART = 4       // Last resort - ESP restart
 };
 
+// ============================================
+// MEMORY PRESSURE LEVELS (v1.3.3)
+// ============================================
+// GREEN:  DRAM >= DRAM_WARNING and PSRAM >= PSRAM_WARNING
+// YELLOW: below a WARNING threshold  - producers slow down x2
+// RED:    below a CRITICAL threshold - producers slow down x4, large BLE
+//         responses wait, new devices are refused
+enum class MemoryPressure : uint8_t { GREEN = 0, YELLOW = 1, RED = 2 };
+
 // ============================================
 // MEMORY RECOVERY CLASS
 // ============================================
@@ -168,6 +192,43 @@ class MemoryRecovery {
    */
   static uint32_t getEstimatedDeviceCapacity();
 
+  // ============================================
+  // BACKPRESSURE (v1.3.3)
+  // ============================================
+
+  /**
+   * Pressure level of the last memory check (no heap query, any task)
+   */
+  static MemoryPressure getPressure();
+
+  /**
+   * Query the heap now and update the pressure level
+   * For producers about to allocate (e.g. a large BLE response)
+   */
+  static MemoryPressure samplePressure();
+
+  /**
+   * Slow-down factor of the current level: GREEN 1, YELLOW 2, RED 4
+   */
+  static uint32_t backpressureFactor();
+
+  /**
+   * Stretch a production interval by backpressureFactor()
+   * @param intervalMs Interval at GREEN
+   */
+  static uint32_t applyBackpressure(uint32_t intervalMs);
+
+  /**
+   * @return "green", "yellow" or "red"
+   */
+  static const char* getPressureName(MemoryPressure level);
+
+  /**
+   * Admission control for a new device
+   * @return false while RED or when getEstimatedDeviceCapacity() is 0
+   */
+  static bool canAdmitDevice();
+
  private:
   /**
    * Execute queue flush recovery
@@ -193,6 +254,11 @@ class MemoryRecovery {
    * Logs critical info before restart
    */
   static void executeEmergencyRestart();
+
+  /**
+   * Classify free memory and update the pressure level (with hysteresis)
+   */
+  static MemoryPressure updatePressure(uint32_t freeDram, uint32_t freePsram);
 };
 
 #endif  // MEMORY_RECOVERY_H
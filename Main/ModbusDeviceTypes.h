@@ -14,6 +14,10 @@
  * @see Documentation/Technical_Guides/REFACTORING_MODBUS_SERVICES.md
  */
 
+#include <cstring>
+#include <vector>
+
+#include "PSRAMAllocator.h"  // v1.3.3: STLPSRAMAllocator, ArduinoJson
 #include "PSRAMString.h"  // BUG #31: PSRAM-based string for all device tracking
 
 // ============================================================================
@@ -74,7 +78,6 @@ enum class ModbusDisableReason : uint8_t {
  * Common to both RTU and TCP services
  */
 struct ModbusDeviceFailureState {
-  PSRAMString deviceId;                  // Device identifier
   uint8_t consecutiveFailures = 0;       // Track consecutive read failures
   uint8_t retryCount = 0;                // Current retry attempt count
   unsigned long nextRetryTime = 0;       // When to retry (exponential backoff)
@@ -92,12 +95,28 @@ struct ModbusDeviceFailureState {
       disableReasonDetail;  // User-provided reason (e.g., "maintenance")
   unsigned long disabledTimestamp =
       0;  // When device was disabled (for auto-recovery)
+  uint16_t failedProbes = 0;  // v1.3.3: Recovery probes unanswered (disabled)
 
-  ModbusDeviceFailureState() = default;
-
-  explicit ModbusDeviceFailureState(const char* id) : deviceId(id) {}
+  // v1.3.3: Disabled by the service itself (auto-recovery candidate)
+  bool autoDisabled() const {
+    return !isEnabled && (disableReason == ModbusDisableReason::AUTO_RETRY ||
+                          disableReason == ModbusDisableReason::AUTO_TIMEOUT);
+  }
 };
 
+// v1.3.3: Auto-recovery probe
+// Previous: the recovery task re-enabled every auto-disabled device every
+// 30 s, so a device that was still dead went straight back into the poll
+// schedule and timed out on every span (plus retries) before it was disabled
+// again - stretching the cycle of every device on its bus.
+// New: the recovery task first reads one register (start of the first span)
+// with a short timeout. Only a device that answers - with data or a Modbus
+// exception - is re-enabled; otherwise failedProbes counts up.
+namespace ModbusRecoveryConfig {
+constexpr uint32_t PROBE_TIMEOUT_MS = 500;          // Response (RTU / TCP)
+constexpr uint32_t PROBE_CONNECT_TIMEOUT_MS = 1000;  // TCP connect
+}  // namespace ModbusRecoveryConfig
+
 // ============================================================================
 // DEVICE TIMEOUT CONFIGURATION
 // ============================================================================
@@ -109,16 +128,105 @@ struct ModbusDeviceFailureState {
  * Auto-disables device after consecutive timeouts
  */
 struct ModbusDeviceReadTimeout {
-  PSRAMString deviceId;             // Device identifier
   uint16_t timeoutMs = 5000;        // Per-device timeout (5 seconds default)
   uint8_t consecutiveTimeouts = 0;  // Track consecutive timeouts
   unsigned long lastSuccessfulRead = 0;  // Last successful read time
   uint8_t maxConsecutiveTimeouts = 3;    // Disable device after N timeouts
+};
+
+// ============================================================================
+// RESPONSE TIME HISTOGRAM (v1.3.3)
+// ============================================================================
+
+/**
+ * @brief Log-scale response time histogram
+ *
+ * v1.3.3: Previous: only min/max/last/average were kept, which hides tail
+ * latency (a slave that is occasionally slow looked like one that is
+ * uniformly slow). New: fixed buckets, 4 per power of two (each bucket spans
+ * at most 25% of its lower bound): 0, 1, 2, 3 ms exact, then 4, 5, 6, 7,
+ * 8-9, 10-11, ... 7168-8191 ms. Slower responses land in the last bucket.
+ *
+ * Percentiles report the upper bound of the bucket holding the rank (never
+ * below the real value, suitable for timeout tuning). A full bucket halves
+ * all counts, so the histogram never wraps and older samples weigh less.
+ */
+struct ModbusLatencyHistogram {
+  static constexpr uint8_t BUCKET_COUNT = 48;  // Bucket 47 ends at 8191 ms
+
+  uint16_t counts[BUCKET_COUNT] = {};
+  uint32_t samples = 0;  // Sum of counts
+
+  static uint8_t bucketFor(uint32_t latencyMs) {
+    if (latencyMs < 4) return (uint8_t)latencyMs;
+    uint8_t exponent = 31 - __builtin_clz(latencyMs);  // >= 2
+    uint32_t index =
+        4 * (exponent - 1) + ((latencyMs >> (exponent - 2)) & 0x03);
+    return index < BUCKET_COUNT ? (uint8_t)index : BUCKET_COUNT - 1;
+  }
 
-  ModbusDeviceReadTimeout() = default;
+  // Largest latency (ms) counted in a bucket
+  static uint16_t bucketUpperMs(uint8_t index) {
+    if (index < 4) return index;
+    uint8_t shift = index / 4 - 1;
+    uint32_t lower = (uint32_t)(4 + index % 4) << shift;
+    return (uint16_t)(lower + (1UL << shift) - 1);
+  }
 
-  explicit ModbusDeviceReadTimeout(const char* id, uint16_t timeout = 5000)
-      : deviceId(id), timeoutMs(timeout) {}
+  void record(uint32_t latencyMs) {
+    uint8_t index = bucketFor(latencyMs);
+    if (counts[index] == 0xFFFF) {
+      samples = 0;
+      for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] >>= 1;
+        samples += counts[i];
+      }
+    }
+    counts[index]++;
+    samples++;
+  }
+
+  /**
+   * @brief Response time at a percentile
+   * @param percent 1-100
+   * @return Upper bound of the bucket (ms), 0 without samples
+   */
+  uint16_t percentileMs(uint8_t percent) const {
+    if (samples == 0) return 0;
+    uint32_t rank = (samples * percent + 99) / 100;  // Ceiling, >= 1
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+      seen += counts[i];
+      if (seen >= rank) return bucketUpperMs(i);
+    }
+    return bucketUpperMs(BUCKET_COUNT - 1);
+  }
+
+  /**
+   * @brief Write the sample count, p50/p95/p99 and optionally the non-empty
+   * buckets ("response_time_histogram": [[upper_ms, count], ...]) into a
+   * status object
+   */
+  void writeStatus(JsonObject& out, bool includeBuckets) const {
+    out["latency_samples"] = samples;
+    out["p50_response_time_ms"] = percentileMs(50);
+    out["p95_response_time_ms"] = percentileMs(95);
+    out["p99_response_time_ms"] = percentileMs(99);
+    if (!includeBuckets) return;
+    JsonArray buckets = out["response_time_histogram"].to<JsonArray>();
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+      if (counts[i] == 0) continue;
+      JsonArray bucket = buckets.add<JsonArray>();
+      bucket.add(bucketUpperMs(i));
+      bucket.add(counts[i]);
+    }
+  }
+
+  void reset() {
+    memset(counts, 0, sizeof(counts));
+    samples = 0;
+  }
 };
 
 // ============================================================================
@@ -132,8 +240,6 @@ struct ModbusDeviceReadTimeout {
  * Includes success rate, response times, and read counts
  */
 struct ModbusDeviceHealthMetrics {
-  PSRAMString deviceId;
-
   // Counters
   uint32_t totalReads = 0;
   uint32_t successfulReads = 0;
@@ -144,10 +250,7 @@ struct ModbusDeviceHealthMetrics {
   uint16_t minResponseTimeMs = 65535;  // Min response time (init to max)
   uint16_t maxResponseTimeMs = 0;      // Max response time
   uint16_t lastResponseTimeMs = 0;     // Most recent response time
-
-  ModbusDeviceHealthMetrics() = default;
-
-  explicit ModbusDeviceHealthMetrics(const char* id) : deviceId(id) {}
+  ModbusLatencyHistogram latency;      // v1.3.3: Successful reads
 
   /**
    * @brief Calculate success rate percentage
@@ -182,6 +285,7 @@ struct ModbusDeviceHealthMetrics {
         minResponseTimeMs = responseTimeMs;
       if (responseTimeMs > maxResponseTimeMs)
         maxResponseTimeMs = responseTimeMs;
+      latency.record(responseTimeMs);
     } else {
       failedReads++;
     }
@@ -198,7 +302,235 @@ struct ModbusDeviceHealthMetrics {
     minResponseTimeMs = 65535;
     maxResponseTimeMs = 0;
     lastResponseTimeMs = 0;
+    latency.reset();
+  }
+};
+
+// ============================================================================
+// POLL CYCLE ACCOUNTING (v1.3.3)
+// ============================================================================
+
+/**
+ * @brief Poll cycle duration against the device's refresh interval
+ *
+ * v1.3.3: Previous: nothing showed a device whose poll took longer than its
+ * refresh_rate_ms, or a bus whose devices no longer fit their intervals.
+ * New: every device poll records how long it took (cycle) and how late it
+ * started against its deadline. A poll that ends after the next deadline is
+ * a missed deadline; a cycle longer than the interval itself is an overrun.
+ * demandPercent() is the share of the interval the device needs on its bus
+ * or endpoint (summed per bus: > 100% = more devices than the bus can
+ * serve).
+ */
+struct ModbusCycleMetrics {
+  uint32_t cycles = 0;
+  uint32_t overruns = 0;         // Cycle longer than the interval
+  uint32_t missedDeadlines = 0;  // Finished after the next deadline
+  uint32_t avgCycleMs = 0;       // Moving average (1/8 weight)
+  uint16_t lastCycleMs = 0;
+  uint16_t maxCycleMs = 0;
+  uint16_t lastLateMs = 0;  // Start behind the deadline, last poll
+  uint16_t maxLateMs = 0;
+
+  void record(uint32_t cycleMs, uint32_t lateMs, uint32_t intervalMs) {
+    cycles++;
+    if (cycleMs > intervalMs) overruns++;
+    if (lateMs + cycleMs > intervalMs) missedDeadlines++;
+    avgCycleMs = (cycles == 1) ? cycleMs : (avgCycleMs * 7 + cycleMs) / 8;
+    lastCycleMs = (uint16_t)(cycleMs < 0xFFFF ? cycleMs : 0xFFFF);
+    lastLateMs = (uint16_t)(lateMs < 0xFFFF ? lateMs : 0xFFFF);
+    if (lastCycleMs > maxCycleMs) maxCycleMs = lastCycleMs;
+    if (lastLateMs > maxLateMs) maxLateMs = lastLateMs;
+  }
+
+  uint32_t demandPercent(uint32_t intervalMs) const {
+    return intervalMs ? avgCycleMs * 100 / intervalMs : 0;
+  }
+
+  void writeStatus(JsonObject& out, uint32_t intervalMs) const {
+    out["cycles"] = cycles;
+    out["avg_cycle_ms"] = avgCycleMs;
+    out["last_cycle_ms"] = lastCycleMs;
+    out["max_cycle_ms"] = maxCycleMs;
+    out["max_late_ms"] = maxLateMs;
+    out["overruns"] = overruns;
+    out["missed_deadlines"] = missedDeadlines;
+    out["demand_percent"] = demandPercent(intervalMs);
+  }
+
+  void reset() { *this = ModbusCycleMetrics(); }
+};
+
+// ============================================================================
+// PER-DEVICE STATE RECORD (v1.3.3)
+// ============================================================================
+
+/**
+ * @brief All runtime state of one device in a single record
+ *
+ * v1.3.3: Previous: Each service kept failure state, timeouts and metrics in
+ * separate vectors, each searched with strcmp() on the device ID for every
+ * lookup. New: The record is embedded in the service's device entry, so the
+ * device's slot (its index in the device list, assigned in
+ * refreshDeviceList()) addresses all of it. ID lookups go through
+ * ModbusDeviceIndex.
+ */
+struct ModbusDeviceState {
+  ModbusDeviceFailureState failure;
+  ModbusDeviceReadTimeout timeout;
+  ModbusDeviceHealthMetrics metrics;
+  uint16_t readMs = 0;  // v1.3.3: Last full device read (PollSlot::rank)
+  ModbusCycleMetrics cycle;  // v1.3.3: Cycle vs refresh interval
+};
+
+/**
+ * @brief Device ID -> slot hash (open addressing, linear probing)
+ *
+ * Rebuilt together with the device list. Only hashes and slots are stored;
+ * find() confirms a hash hit against the device entry through a callback, so
+ * the index never holds pointers into the device list.
+ */
+class ModbusDeviceIndex {
+ public:
+  static constexpr uint16_t INVALID_SLOT = 0xFFFF;
+
+  /**
+   * @brief Drop all entries and size the table for count devices
+   */
+  void reset(size_t count) {
+    size_t capacity = 8;
+    while (capacity < count * 2) {
+      capacity <<= 1;  // Load factor <= 0.5, power of two for masking
+    }
+    entries.assign(capacity, Entry{0, INVALID_SLOT});
   }
+
+  /**
+   * @brief Add a device (at most the count given to reset())
+   */
+  void insert(const char* deviceId, uint16_t slot) {
+    if (entries.empty() || !deviceId) return;
+    uint32_t hash = hashId(deviceId);
+    size_t mask = entries.size() - 1;
+    size_t i = hash & mask;
+    while (entries[i].slot != INVALID_SLOT) {
+      i = (i + 1) & mask;
+    }
+    entries[i] = Entry{hash, slot};
+  }
+
+  /**
+   * @brief Find the slot of a device
+   * @param matches bool(uint16_t slot) - true if the slot holds deviceId
+   * @return Slot, or INVALID_SLOT if the device is not configured
+   */
+  template <typename Matches>
+  uint16_t find(const char* deviceId, Matches matches) const {
+    if (entries.empty() || !deviceId) return INVALID_SLOT;
+    uint32_t hash = hashId(deviceId);
+    size_t mask = entries.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Entry& entry = entries[i];
+      if (entry.slot == INVALID_SLOT) return INVALID_SLOT;
+      if (entry.hash == hash && matches(entry.slot)) return entry.slot;
+    }
+  }
+
+  // FNV-1a (device IDs are short ASCII strings)
+  static uint32_t hashId(const char* deviceId) {
+    uint32_t hash = 2166136261u;
+    for (const char* p = deviceId; *p; p++) {
+      hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    return hash;
+  }
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint16_t slot;
+  };
+  std::vector<Entry, STLPSRAMAllocator<Entry>> entries;
+};
+
+// ============================================================================
+// CONFIG CHANGE DESCRIPTORS (v1.3.3)
+// ============================================================================
+
+/**
+ * @brief What a CRUD command changed (passed to notifyConfigChange())
+ *
+ * v1.3.3: Previous: notifyConfigChange() carried no information, so every
+ * register edit recompiled all device plans, reset the failure / timeout /
+ * metrics record of every device and closed every pooled TCP connection.
+ * New: The service records the changed device and refreshDeviceList() only
+ * rebuilds that entry; the others keep their plan, state and connection.
+ */
+struct ModbusConfigChange {
+  enum Kind : uint8_t {
+    FULL = 0,           // Unknown scope (restore, factory reset): rebuild all
+    DEVICE_ADDED,
+    DEVICE_UPDATED,
+    DEVICE_REMOVED,
+    REGISTERS_CHANGED,  // Register created / updated / deleted
+  };
+
+  Kind kind = FULL;
+  const char* deviceId = nullptr;  // Copied by ModbusChangeSet::add()
+
+  ModbusConfigChange() = default;
+  ModbusConfigChange(Kind k, const char* id) : kind(k), deviceId(id) {}
+};
+
+/**
+ * @brief Device IDs changed since the last refresh
+ *
+ * Fixed size: more changes than MAX_DEVICES (or an ID that does not fit)
+ * degrade to a full refresh. Not thread-safe; the services guard it with a
+ * spinlock because notifyConfigChange() runs on the CRUD task.
+ */
+class ModbusChangeSet {
+ public:
+  static constexpr uint8_t MAX_DEVICES = 8;
+  static constexpr size_t MAX_ID_LENGTH = 32;
+
+  void add(const ModbusConfigChange& change) {
+    if (full) return;
+    if (change.kind == ModbusConfigChange::FULL || !change.deviceId ||
+        strlen(change.deviceId) >= MAX_ID_LENGTH) {
+      full = true;
+      return;
+    }
+    if (contains(change.deviceId)) return;
+    if (count >= MAX_DEVICES) {
+      full = true;
+      return;
+    }
+    strncpy(ids[count], change.deviceId, MAX_ID_LENGTH - 1);
+    ids[count][MAX_ID_LENGTH - 1] = '\0';
+    count++;
+  }
+
+  bool contains(const char* deviceId) const {
+    if (!deviceId) return false;
+    for (uint8_t i = 0; i < count; i++) {
+      if (strcmp(ids[i], deviceId) == 0) return true;
+    }
+    return false;
+  }
+
+  bool isFull() const { return full; }
+  uint8_t size() const { return count; }
+
+  void clear() {
+    full = false;
+    count = 0;
+  }
+
+ private:
+  bool full = false;
+  uint8_t count = 0;
+  char ids[MAX_DEVICES][MAX_ID_LENGTH];
 };
 
 // ============================================================================
@@ -0,0 +1,772 @@
+#include "ModbusPollPlan.h"
+
+#include <esp_heap_caps.h>
+
+#include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+#include "NumberFormat.h"  // v1.3.3: Fixed-decimal payload values
+#include "TaskProfiler.h"  // v1.3.3: Registry lock wait profiling
+
+// ============================================================================
+// v1.3.3: COMPILED POLL PLAN
+// ============================================================================
+
+// Copy unit into fixed buffer, converting "deg" to UTF-8 degree symbol
+// (v2.5.40 behaviour, previously done with String::replace() per register)
+static void compileUnit(const char* rawUnit, char* out, size_t outSize) {
+  size_t o = 0;
+  for (size_t i = 0; rawUnit[i] && o + 1 < outSize;) {
+    if (strncmp(&rawUnit[i], "deg", 3) == 0) {
+      if (o + 2 >= outSize) break;
+      out[o++] = '\xC2';
+      out[o++] = '\xB0';
+      i += 3;
+    } else {
+      out[o++] = rawUnit[i++];
+    }
+  }
+  out[o] = '\0';
+}
+
+// FNV-1a, used for the register layout signature
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+bool ModbusPollPlan::compile(const JsonObject& deviceConfig,
+                             CompiledDevicePlan& plan, uint16_t maxRegisters,
+                             uint16_t maxBits) {
+  plan.registers.clear();
+  plan.items.clear();
+  plan.spans.clear();
+  plan.decoders.clear();
+  plan.invalidCount = 0;
+
+  plan.deviceId = deviceConfig["device_id"] | "UNKNOWN";
+  plan.deviceName = deviceConfig["device_name"] | "";
+  plan.slaveId = deviceConfig["slave_id"] | 1;
+  plan.refreshRateMs = deviceConfig["refresh_rate_ms"] | 5000;
+  plan.serialPort = deviceConfig["serial_port"] | 1;
+  plan.pipelineDepth = ModbusUtils::getDevicePipelineDepth(deviceConfig);
+
+  // v1.3.3: RTU bus timing (ignored by TCP). 0 = automatic / library default.
+  plan.baudRate = deviceConfig["baud_rate"] | 9600;
+  long timeoutMs = deviceConfig["timeout"] | 0L;
+  plan.responseTimeoutMs = timeoutMs > 0 ? (uint32_t)timeoutMs : 0;
+  long interFrameUs = deviceConfig["inter_frame_us"] | 0L;
+  plan.interFrameUs =
+      interFrameUs > 0
+          ? (uint32_t)std::min<long>(interFrameUs,
+                                     ModbusSpanConfig::MAX_INTER_FRAME_US)
+          : 0;
+  long turnaroundMs = deviceConfig["turnaround_ms"] | 10L;
+  plan.turnaroundMs = (uint16_t)std::max<long>(
+      0, std::min<long>(turnaroundMs, ModbusSpanConfig::MAX_TURNAROUND_MS));
+  plan.autoTimeout = deviceConfig["auto_timeout"] | false;
+  long refreshMinMs = deviceConfig["refresh_rate_min_ms"] | 0L;
+  long refreshMaxMs = deviceConfig["refresh_rate_max_ms"] | 0L;
+  plan.adaptive.configure(deviceConfig["adaptive_refresh"] | false,
+                          plan.refreshRateMs,
+                          refreshMinMs > 0 ? (uint32_t)refreshMinMs : 0,
+                          refreshMaxMs > 0 ? (uint32_t)refreshMaxMs : 0);
+  int serverUnitId = deviceConfig["server_unit_id"] | (int)plan.slaveId;
+  plan.serverUnitId =
+      (serverUnitId >= 1 && serverUnitId <= 247) ? serverUnitId : plan.slaveId;
+
+  JsonArray registers = deviceConfig["registers"];
+  size_t registerTotal = registers.size();
+  plan.registers.reserve(registerTotal);
+  plan.items.reserve(registerTotal);
+  plan.decoders.reserve(registerTotal);
+  uint32_t signature = 2166136261UL;
+
+  for (JsonVariant regVar : registers) {
+    JsonObject reg = regVar.as<JsonObject>();
+
+    CompiledRegister cr;
+    cr.registerId = reg["register_id"] | "";
+    cr.name = reg["register_name"] | "Unknown";
+    cr.description = reg["description"] | "";
+    char unit[24];
+    compileUnit(reg["unit"] | "", unit, sizeof(unit));
+    cr.unit = unit;
+
+    cr.address = reg["address"] | 0;
+    cr.registerIndex = reg["register_index"] | 0;
+    cr.functionCode = reg["function_code"] | 3;
+    ModbusUtils::parseDataType(reg["data_type"] | "UINT16", cr.dataType,
+                               cr.endianness);
+    cr.wordCount = (cr.functionCode == 1 || cr.functionCode == 2)
+                       ? 1
+                       : ModbusUtils::getWordCount(cr.dataType);
+
+    cr.writable = ModbusUtils::isWritableType(cr.functionCode);
+
+    float deadband = reg["deadband"] | 0.0f;
+    float deadbandPercent = reg["deadband_percent"] | 0.0f;
+    cr.deadband = deadband > 0.0f ? deadband : 0.0f;
+    cr.deadbandPercent = deadbandPercent > 0.0f ? deadbandPercent : 0.0f;
+    cr.maxSilenceMs = reg["max_silence_ms"] | 0UL;
+
+    long serverAddress = reg["server_address"] | (long)cr.address;
+    cr.serverAddress = (serverAddress >= 0 && serverAddress <= 65535)
+                           ? (uint16_t)serverAddress
+                           : cr.address;
+    const char* serverType = reg["server_data_type"].as<const char*>();
+    cr.serverCalibrated = serverType != nullptr && serverType[0] != '\0';
+    if (cr.serverCalibrated) {
+      ModbusUtils::parseDataType(serverType, cr.serverType,
+                                 cr.serverEndianness);
+    } else {
+      cr.serverType = cr.dataType;
+      cr.serverEndianness = cr.endianness;
+    }
+
+    uint16_t slot = plan.registers.size();
+    plan.registers.push_back(cr);
+
+    // v1.3.3: Batch decode descriptor (coils are stored as 0/1 words)
+    ModbusDecodeItem decoder;
+    decoder.wordOffset = slot * 4;
+    decoder.type = (cr.functionCode == 1 || cr.functionCode == 2)
+                       ? ModbusDataType::BOOL
+                       : cr.dataType;
+    decoder.endianness = cr.endianness;
+    decoder.scale = reg["scale"] | 1.0;
+    decoder.offset = reg["offset"] | 0.0;
+    int decimals = reg["decimals"] | -1;
+    decoder.decimals = (decimals >= 0 && decimals <= 6) ? decimals : -1;
+    decoder.decimalsFactor = NumberFormat::decimalsFactor(decoder.decimals);
+    plan.decoders.push_back(decoder);
+
+    signature = fnv1a(signature, cr.registerId, strlen(cr.registerId) + 1);
+    signature = fnv1a(signature, &cr.address, sizeof(cr.address));
+    signature = fnv1a(signature, &cr.functionCode, sizeof(cr.functionCode));
+
+    if (cr.functionCode < 1 || cr.functionCode > 4) {
+      continue;  // Not a read function code, never polled
+    }
+
+    // FIXED Bug #8: Validate address range doesn't overflow uint16_t address
+    // space (checked once at compile time instead of every poll)
+    if (cr.address > (65535 - cr.wordCount + 1)) {
+      LOG_CONFIG_WARN(
+          "Address range overflow for %s (addr=%d, count=%d, max=%d)\n",
+          cr.name, cr.address, cr.wordCount, cr.address + cr.wordCount - 1);
+      plan.invalidCount++;
+      continue;
+    }
+
+    ModbusPollItem item;
+    item.index = slot;
+    item.functionCode = cr.functionCode;
+    item.address = cr.address;
+    item.width = cr.wordCount;
+    plan.items.push_back(item);
+  }
+
+  plan.signature = signature;
+
+  ModbusUtils::planReadSpans(plan.items, plan.spans,
+                             ModbusUtils::getDeviceMaxGap(deviceConfig),
+                             maxRegisters, maxBits);
+
+  plan.slotWords.assign(registerTotal * 4, 0);
+  plan.slotValues.assign(registerTotal, 0.0);
+  plan.slotStatus.assign(registerTotal, (uint8_t)PollSlotStatus::NOT_READ);
+  plan.slotTime.assign(registerTotal, 0);
+  plan.latest.assign(registerTotal, LatestValue{0, 0, 0, 0.0});
+  plan.reportedAt.assign(registerTotal, 0);
+  plan.aggregates.assign(registerTotal * 2,
+                         WindowAggregate{0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0});
+
+  return !plan.items.empty();
+}
+
+uint32_t ModbusPollPlan::valueSignature(const CompiledDevicePlan& plan) {
+  uint32_t hash = 2166136261UL;
+  for (size_t slot = 0; slot < plan.registers.size(); slot++) {
+    if (plan.slotStatus[slot] != (uint8_t)PollSlotStatus::OK) {
+      continue;
+    }
+    hash = fnv1a(hash, &slot, sizeof(slot));
+    hash = fnv1a(hash, &plan.slotWords[slot * 4],
+                 plan.registers[slot].wordCount * sizeof(uint16_t));
+  }
+  return hash;
+}
+
+bool ModbusPollPlan::checkDeadband(CompiledDevicePlan& plan,
+                                   uint16_t registerSlot, double value,
+                                   uint32_t nowMs) {
+  const CompiledRegister& reg = plan.registers[registerSlot];
+  bool changeOnly = reg.deadband == 0.0f && reg.deadbandPercent == 0.0f;
+  if (changeOnly && reg.maxSilenceMs == 0) {
+    return true;  // Report every read (default)
+  }
+
+  const LatestValue& last = plan.latest[registerSlot];
+  bool report = last.version == 0 || isnan(value) || isnan(last.value) ||
+                (reg.maxSilenceMs > 0 &&
+                 nowMs - plan.reportedAt[registerSlot] >= reg.maxSilenceMs);
+
+  if (!report) {
+    double delta = fabs(value - last.value);
+    if (changeOnly) {
+      report = delta > 0.0;
+    } else {
+      report = (reg.deadband > 0.0f && delta > reg.deadband) ||
+               (reg.deadbandPercent > 0.0f &&
+                delta > fabs(last.value) * reg.deadbandPercent / 100.0);
+    }
+  }
+
+  if (report) {
+    plan.reportedAt[registerSlot] = nowMs;
+  }
+  return report;
+}
+
+int8_t ModbusPollPlan::decimalsOf(const CompiledDevicePlan& plan,
+                                  const CompiledRegister& reg) {
+  size_t slot = &reg - plan.registers.data();
+  return slot < plan.decoders.size() ? plan.decoders[slot].decimals : -1;
+}
+
+void ModbusPollPlan::buildDataPoint(const CompiledDevicePlan& plan,
+                                    const CompiledRegister& reg, double value,
+                                    uint32_t timestamp, JsonObject& dataPoint,
+                                    bool fixedText) {
+  if (timestamp != 0) {
+    dataPoint["time"] = timestamp;
+  }
+  dataPoint["name"] = reg.name;
+  dataPoint["device_id"] = plan.deviceId;
+  if (plan.deviceName[0] != '\0') {
+    dataPoint["device_name"] = plan.deviceName;
+  }
+  dataPoint["address"] = reg.address;  // Register address for BLE streaming
+  // Calibrated value (v1.3.3: fixed-decimal text for JSON encoders)
+  NumberFormat::setValue(dataPoint["value"], value, decimalsOf(plan, reg),
+                         fixedText);
+  dataPoint["description"] = reg.description;
+  dataPoint["unit"] = (const char*)reg.unit;  // "deg" already converted to "°"
+  dataPoint["register_id"] = reg.registerId;  // Internal use for deduplication
+  dataPoint["register_index"] =
+      reg.registerIndex;  // For customize mode topic mapping
+
+  // v1.3.2: Writable status for mobile app (FC1/FC3 writable)
+  dataPoint["writable"] = reg.writable;
+}
+
+// ============================================================================
+// v1.3.3: POLL PLAN REGISTRY
+// ============================================================================
+
+uint32_t PollPlanRegistry::windowCounter = 1;  // 0 = bucket never used
+
+PollPlanRegistry::PollPlanRegistry()
+    : slots(nullptr), mutex(nullptr), epochCounter(0), layoutCounter(1) {
+  slots = (Slot*)heap_caps_calloc(MAX_SLOTS, sizeof(Slot),
+                                  MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!slots) {
+    slots = (Slot*)heap_caps_calloc(MAX_SLOTS, sizeof(Slot), MALLOC_CAP_8BIT);
+  }
+  mutex = xSemaphoreCreateMutex();
+}
+
+PollPlanRegistry* PollPlanRegistry::getInstance() {
+  // Thread-safe Meyers Singleton (C++11 guarantees thread-safe static init)
+  static PollPlanRegistry instance;
+  return &instance;
+}
+
+uint32_t PollPlanRegistry::beginRefresh() {
+  uint32_t epoch = 0;
+  if (TaskProfiler::take(mutex, portMAX_DELAY,
+                         ProfiledLock::PLAN_REGISTRY) == pdTRUE) {
+    epoch = ++epochCounter;
+    xSemaphoreGive(mutex);
+  }
+  return epoch;
+}
+
+bool PollPlanRegistry::attach(Owner owner, uint32_t epoch,
+                              CompiledDevicePlan& plan) {
+  plan.registrySlot = INVALID_SLOT;
+  if (!slots) {
+    return false;
+  }
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+
+  // Same device keeps its slot; otherwise take the first free one
+  int found = -1;
+  int freeSlot = -1;
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (slots[i].owner != OWNER_NONE &&
+        strcmp(slots[i].plan->deviceId, plan.deviceId) == 0) {
+      found = i;
+      break;
+    }
+    if (freeSlot < 0 && slots[i].owner == OWNER_NONE) {
+      freeSlot = i;
+    }
+  }
+
+  if (found < 0) {
+    if (freeSlot < 0) {
+      xSemaphoreGive(mutex);
+      LOG_QUEUE_ERROR("Plan registry full (%d devices), %s not queued\n",
+                      MAX_SLOTS, plan.deviceId);
+      return false;
+    }
+    found = freeSlot;
+    slots[found].generation++;  // Invalidate records of a previous occupant
+  } else if (slots[found].signature != plan.signature) {
+    slots[found].generation++;  // Register layout changed
+  } else if (slots[found].plan != &plan &&
+             slots[found].plan->latest.size() == plan.latest.size()) {
+    // Same layout: carry values not yet published over to the new plan
+    std::copy(slots[found].plan->latest.begin(),
+              slots[found].plan->latest.end(), plan.latest.begin());
+    std::copy(slots[found].plan->aggregates.begin(),
+              slots[found].plan->aggregates.end(), plan.aggregates.begin());
+  }
+
+  Slot& slot = slots[found];
+  if (slot.plan != &plan) {
+    bumpLayout();  // New plan (refresh) - names/units may have changed
+  }
+  slot.plan = &plan;
+  slot.signature = plan.signature;
+  slot.epoch = epoch;
+  slot.owner = owner;
+
+  plan.registrySlot = (uint8_t)found;
+  plan.registryGeneration = slot.generation;
+
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+void PollPlanRegistry::endRefresh(Owner owner, uint32_t epoch) {
+  if (!slots) return;
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (slots[i].owner == owner && slots[i].epoch != epoch) {
+      // Device removed (or moved to other protocol) - release slot
+      slots[i].owner = OWNER_NONE;
+      slots[i].plan = nullptr;
+      slots[i].generation++;
+      bumpLayout();
+    }
+  }
+  xSemaphoreGive(mutex);
+}
+
+const PollPlanRegistry::Slot* PollPlanRegistry::findLive(
+    uint8_t slot, uint16_t generation) const {
+  if (!slots || slot >= MAX_SLOTS) return nullptr;
+  const Slot& s = slots[slot];
+  if (s.owner == OWNER_NONE || s.plan == nullptr ||
+      s.generation != generation) {
+    return nullptr;
+  }
+  return &s;
+}
+
+bool PollPlanRegistry::resolveRegister(uint8_t slot, uint16_t generation,
+                                       uint16_t registerSlot, double value,
+                                       uint32_t timestamp,
+                                       JsonObject& dataPoint, bool fixedText) {
+  bool resolved = false;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  const Slot* s = findLive(slot, generation);
+  if (s && registerSlot < s->plan->registers.size()) {
+    ModbusPollPlan::buildDataPoint(*s->plan, s->plan->registers[registerSlot],
+                                   value, timestamp, dataPoint, fixedText);
+    resolved = true;
+  }
+  xSemaphoreGive(mutex);
+  return resolved;
+}
+
+bool PollPlanRegistry::resolveDevice(uint8_t slot, uint16_t generation,
+                                     JsonObject& dataPoint) {
+  bool resolved = false;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  const Slot* s = findLive(slot, generation);
+  if (s) {
+    dataPoint["device_id"] = s->plan->deviceId;
+    resolved = true;
+  }
+  xSemaphoreGive(mutex);
+  return resolved;
+}
+
+bool PollPlanRegistry::matchesDevice(uint8_t slot, uint16_t generation,
+                                     const char* deviceId) {
+  bool matches = false;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  const Slot* s = findLive(slot, generation);
+  if (s) {
+    matches = (strcmp(s->plan->deviceId, deviceId) == 0);
+  }
+  xSemaphoreGive(mutex);
+  return matches;
+}
+
+bool PollPlanRegistry::describeDevice(uint8_t slot, uint16_t generation,
+                                      JsonObject& schema) {
+  bool described = false;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  const Slot* s = findLive(slot, generation);
+  if (s) {
+    describePlan(*s->plan, schema);
+    described = true;
+  }
+  xSemaphoreGive(mutex);
+  return described;
+}
+
+uint32_t PollPlanRegistry::describeLayout(JsonArray& devices,
+                                          LayoutEntry* layout) {
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    layout[i].position = -1;
+    layout[i].generation = 0;
+  }
+  if (!slots) return 0;
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  uint32_t version = layoutVersion();
+  int16_t position = 0;
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;  // Free, or retired (same filter as drainLatest)
+    }
+    JsonObject device = devices.add<JsonObject>();
+    describePlan(*s.plan, device);
+    layout[i].position = position++;
+    layout[i].generation = s.generation;
+  }
+  xSemaphoreGive(mutex);
+  return version;
+}
+
+void PollPlanRegistry::describePlan(const CompiledDevicePlan& plan,
+                                    JsonObject& schema) {
+  schema["device_id"] = plan.deviceId;
+  if (plan.deviceName[0] != '\0') {
+    schema["device_name"] = plan.deviceName;
+  }
+  JsonArray registers = schema["registers"].to<JsonArray>();
+  for (size_t i = 0; i < plan.registers.size(); i++) {
+    const CompiledRegister& reg = plan.registers[i];
+    JsonObject entry = registers.add<JsonObject>();
+    entry["index"] = i;  // Register slot (binary frame / value array index)
+    entry["register_id"] = reg.registerId;
+    entry["name"] = reg.name;
+    entry["unit"] = (const char*)reg.unit;
+    if (i < plan.decoders.size() && plan.decoders[i].decimals >= 0) {
+      entry["decimals"] = plan.decoders[i].decimals;
+    }
+  }
+}
+
+bool PollPlanRegistry::retireDevice(const char* deviceId) {
+  if (!slots) return false;
+
+  bool retired = false;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (slots[i].owner != OWNER_NONE && slots[i].plan &&
+        strcmp(slots[i].plan->deviceId, deviceId) == 0) {
+      slots[i].generation++;
+      bumpLayout();
+      retired = true;
+      break;
+    }
+  }
+  xSemaphoreGive(mutex);
+  return retired;
+}
+
+int PollPlanRegistry::drainLatest(const LatestVisitor& visitor) {
+  if (!slots) return 0;
+
+  int visited = 0;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;  // Free, or retired by flushDeviceData()
+    }
+
+    CompiledDevicePlan& plan = *s.plan;
+    for (size_t r = 0; r < plan.latest.size(); r++) {
+      LatestValue& entry = plan.latest[r];
+      uint32_t version = __atomic_load_n(&entry.version, __ATOMIC_ACQUIRE);
+      if (version == entry.publishedVersion || (version & 1)) {
+        continue;  // Not updated (or being written - next drain)
+      }
+      double value = entry.value;
+      uint32_t timestamp = entry.timestamp;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&entry.version, __ATOMIC_RELAXED) != version) {
+        continue;  // Overwritten while reading - next drain
+      }
+      entry.publishedVersion = version;
+      visitor(plan, plan.registers[r], value, timestamp);
+      visited++;
+    }
+  }
+  xSemaphoreGive(mutex);
+  return visited;
+}
+
+int PollPlanRegistry::pendingLatest() {
+  if (!slots) return 0;
+
+  int pending = 0;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;
+    }
+    for (const LatestValue& entry : s.plan->latest) {
+      if (__atomic_load_n(&entry.version, __ATOMIC_ACQUIRE) !=
+          entry.publishedVersion) {
+        pending++;
+      }
+    }
+  }
+  xSemaphoreGive(mutex);
+  return pending;
+}
+
+uint32_t PollPlanRegistry::resolveRegisters(
+    const std::vector<String>& registerIds, RegisterRefList& refs) {
+  RegisterRefList previous;
+  previous.swap(refs);
+  if (!slots) return layoutVersion();
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  uint32_t version = layoutVersion();
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;
+    }
+    const CompiledRegisterList& registers = s.plan->registers;
+    for (size_t r = 0; r < registers.size(); r++) {
+      for (const String& registerId : registerIds) {
+        if (registerId == registers[r].registerId) {
+          refs.push_back(
+              RegisterRef{(uint8_t)i, s.generation, (uint16_t)r, 0});
+          break;
+        }
+      }
+    }
+  }
+  xSemaphoreGive(mutex);
+
+  // Both lists are sorted (slot, then register order)
+  size_t p = 0;
+  for (RegisterRef& ref : refs) {
+    while (p < previous.size() &&
+           (previous[p].slot < ref.slot ||
+            (previous[p].slot == ref.slot &&
+             previous[p].registerSlot < ref.registerSlot))) {
+      p++;
+    }
+    if (p < previous.size() && previous[p].slot == ref.slot &&
+        previous[p].registerSlot == ref.registerSlot &&
+        previous[p].generation == ref.generation) {
+      ref.seenVersion = previous[p].seenVersion;
+    }
+  }
+  return version;
+}
+
+int PollPlanRegistry::readLatest(RegisterRefList& refs,
+                                 const LatestVisitor& visitor) {
+  if (!slots) return 0;
+
+  int visited = 0;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (RegisterRef& ref : refs) {
+    const Slot* s = findLive(ref.slot, ref.generation);
+    if (s == nullptr || ref.registerSlot >= s->plan->latest.size()) {
+      continue;  // Device removed or layout changed (re-resolved later)
+    }
+
+    CompiledDevicePlan& plan = *s->plan;
+    LatestValue& entry = plan.latest[ref.registerSlot];
+    uint32_t version = __atomic_load_n(&entry.version, __ATOMIC_ACQUIRE);
+    if (version == ref.seenVersion || (version & 1)) {
+      continue;  // Not updated for this reader (or being written)
+    }
+    double value = entry.value;
+    uint32_t timestamp = entry.timestamp;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&entry.version, __ATOMIC_RELAXED) != version) {
+      continue;  // Overwritten while reading - next read
+    }
+    ref.seenVersion = version;
+    entry.publishedVersion = version;
+    visitor(plan, plan.registers[ref.registerSlot], value, timestamp);
+    visited++;
+  }
+  xSemaphoreGive(mutex);
+  return visited;
+}
+
+uint32_t PollPlanRegistry::visitPlans(const PlanVisitor& visitor) {
+  if (!slots) return layoutVersion();
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  uint32_t version = layoutVersion();
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;  // Free, or retired by flushDeviceData()
+    }
+    visitor((uint8_t)i, s.generation, *s.plan);
+  }
+  xSemaphoreGive(mutex);
+  return version;
+}
+
+void PollPlanRegistry::peekLatest(const RegisterRef* refs, size_t count,
+                                  LatestValue* values) {
+  memset(values, 0, count * sizeof(LatestValue));
+  if (!slots) return;
+
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (size_t i = 0; i < count; i++) {
+    const RegisterRef& ref = refs[i];
+    const Slot* s = findLive(ref.slot, ref.generation);
+    if (s == nullptr || ref.registerSlot >= s->plan->latest.size()) {
+      continue;  // Device removed or layout changed (map rebuilt later)
+    }
+
+    // Seqlock read, retried while the polling task overwrites the entry
+    // (a few stores, so the retry almost never repeats)
+    const LatestValue& entry = s->plan->latest[ref.registerSlot];
+    for (int attempt = 0; attempt < 4; attempt++) {
+      uint32_t version = __atomic_load_n(&entry.version, __ATOMIC_ACQUIRE);
+      if (version & 1) {
+        continue;
+      }
+      double value = entry.value;
+      uint32_t timestamp = entry.timestamp;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&entry.version, __ATOMIC_RELAXED) == version) {
+        values[i].version = version;
+        values[i].timestamp = timestamp;
+        values[i].value = value;
+        break;
+      }
+    }
+  }
+  xSemaphoreGive(mutex);
+}
+
+int PollPlanRegistry::drainAggregates(const AggregateVisitor& visitor) {
+  if (!slots) return 0;
+
+  int visited = 0;
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  // Writers switch buckets with their next sample
+  uint32_t closed = __atomic_fetch_add(&windowCounter, 1, __ATOMIC_ACQ_REL);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;  // Free, or retired by flushDeviceData()
+    }
+
+    CompiledDevicePlan& plan = *s.plan;
+    for (size_t r = 0; r < plan.latest.size(); r++) {
+      LatestValue& entry = plan.latest[r];
+      uint32_t latestVersion =
+          __atomic_load_n(&entry.version, __ATOMIC_ACQUIRE);
+      if (!(latestVersion & 1)) {
+        entry.publishedVersion = latestVersion;
+      }
+
+      const WindowAggregate& bucket = plan.aggregates[r * 2 + (closed & 1)];
+      WindowAggregate copy;
+      bool consistent = false;
+      // A writer that loaded the window id before the switch may still be
+      // inside the bucket - its critical section is a few stores, retry
+      for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+        uint32_t version = __atomic_load_n(&bucket.version, __ATOMIC_ACQUIRE);
+        if (version & 1) {
+          taskYIELD();
+          continue;
+        }
+        copy = bucket;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        consistent =
+            __atomic_load_n(&bucket.version, __ATOMIC_RELAXED) == version;
+      }
+      if (!consistent || copy.window != closed || copy.count == 0) {
+        continue;  // Not read in the window
+      }
+
+      WindowStats stats;
+      stats.last = copy.last;
+      stats.count = copy.count;
+      stats.timestamp = copy.timestamp;
+      if (copy.valid > 0) {
+        stats.min = copy.min;
+        stats.max = copy.max;
+        stats.mean = copy.sum / copy.valid;
+      } else {
+        stats.min = stats.max = stats.mean = NAN;
+      }
+      visitor(plan, plan.registers[r], stats);
+      visited++;
+    }
+  }
+  xSemaphoreGive(mutex);
+  return visited;
+}
+
+int PollPlanRegistry::pendingAggregates() {
+  if (!slots) return 0;
+
+  int pending = 0;
+  uint32_t window = currentWindow();
+  TaskProfiler::take(mutex, portMAX_DELAY, ProfiledLock::PLAN_REGISTRY);
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.owner == OWNER_NONE || s.plan == nullptr ||
+        s.generation != s.plan->registryGeneration) {
+      continue;
+    }
+    const WindowAggregateList& aggregates = s.plan->aggregates;
+    for (size_t b = (window & 1); b < aggregates.size(); b += 2) {
+      if (__atomic_load_n(&aggregates[b].window, __ATOMIC_RELAXED) ==
+          window) {
+        pending++;
+      }
+    }
+  }
+  xSemaphoreGive(mutex);
+  return pending;
+}
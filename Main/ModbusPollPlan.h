@@ -0,0 +1,525 @@
+#ifndef MODBUS_POLL_PLAN_H
+#define MODBUS_POLL_PLAN_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <algorithm>   // std::fill
+#include <functional>  // std::function (latest-value visitor)
+
+#include "ModbusUtils.h"
+#include "PSRAMAllocator.h"
+#include "PollScheduler.h"  // v1.3.3: AdaptiveRefresh
+#include "StringIntern.h"  // v1.3.3: Interned register units
+
+/**
+ * ModbusPollPlan - Compiled per-device register plan
+ *
+ * v1.3.3: Performance refactoring (polling hot path)
+ * Previous: Every poll cycle re-read function_code, address, data_type, scale,
+ * offset, decimals and unit from the JsonObject of each register, uppercased
+ * data_type and ran strcmp chains to get the word count.
+ * New: refreshDeviceList() compiles each device's "registers" array ONCE into
+ * a PSRAM-resident array of plain structs. The polling loop only iterates
+ * these structs (no JSON lookups, no string parsing, no allocation).
+ *
+ * Ownership:
+ * - String pointers (registerId, name, description) point into the device's
+ *   cached JsonDocument. The plan MUST be rebuilt whenever that document is
+ *   replaced (both services rebuild plan + document together).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+/**
+ * One register, compiled from its JSON config
+ */
+struct CompiledRegister {
+  // Identity (pointers into owning device JsonDocument)
+  const char* registerId;
+  const char* name;
+  const char* description;
+  // v1.3.3: StringIntern handle (was char[24] per register)
+  InternedString unit;  // Display unit ("deg" already converted to UTF-8 "°")
+
+  // Addressing
+  uint16_t address;
+  uint16_t registerIndex;  // "register_index" (customize mode topic mapping)
+  uint8_t functionCode;    // 1, 2, 3, 4
+  uint8_t wordCount;       // Addresses occupied (1 for FC1/FC2)
+  ModbusDataType dataType;
+  ModbusEndianness endianness;
+
+  // Calibration: CompiledDevicePlan::decoders (same slot)
+  bool writable;          // FC1/FC3 (ModbusUtils::isWritableType)
+
+  // v1.3.3: Report-by-exception (all 0 = report every read)
+  float deadband;         // Absolute change in calibrated units
+  float deadbandPercent;  // Change in % of the last reported value
+  uint32_t maxSilenceMs;  // Forced report after this long without one
+
+  // v1.3.3: Modbus TCP server map (ModbusTcpServer). Defaults serve the
+  // register as the field device does: same address, raw value in its own
+  // data_type. "server_data_type" serves the calibrated value instead.
+  uint16_t serverAddress;  // "server_address" (default: address)
+  ModbusDataType serverType;
+  ModbusEndianness serverEndianness;
+  bool serverCalibrated;  // "server_data_type" set (engineering units)
+};
+
+using CompiledRegisterList =
+    std::vector<CompiledRegister, STLPSRAMAllocator<CompiledRegister>>;
+
+/**
+ * Per-register read slot status (filled by the span loop each cycle)
+ */
+enum class PollSlotStatus : uint8_t {
+  NOT_READ = 0,  // Skipped (invalid config) or read aborted
+  OK = 1,        // Raw words valid
+  FAILED = 2     // Read failed (exception/timeout)
+};
+
+/**
+ * Latest value of one register (v1.3.3: MQTT latest-value table)
+ *
+ * Written in place by the owning polling task (single writer), read by the
+ * MQTT publisher. version is odd while value/timestamp are being written
+ * (seqlock); an even version different from publishedVersion is "dirty".
+ */
+struct LatestValue {
+  uint32_t version;           // 0 = never read
+  uint32_t publishedVersion;  // Publisher only: version last drained
+  uint32_t timestamp;         // Unix time (0 = RTC unavailable)
+  double value;               // Calibrated value
+};
+
+using LatestValueList =
+    std::vector<LatestValue, STLPSRAMAllocator<LatestValue>>;
+
+/**
+ * Running statistics of one register over one publish window
+ * (v1.3.3: mqtt_config.aggregation = "window")
+ *
+ * Two buckets per register, selected by the window id's low bit: the polling
+ * task accumulates into the open window's bucket while the MQTT publisher
+ * reads the closed one. Same seqlock as LatestValue (single writer). A
+ * bucket whose window is not the writer's current window is restarted by
+ * the first sample of the new window.
+ */
+struct WindowAggregate {
+  uint32_t version;    // Odd while being written
+  uint32_t window;     // PollPlanRegistry window id of the samples
+  uint32_t count;      // Reads in the window (NaN included)
+  uint32_t valid;      // Finite reads (min/max/sum)
+  uint32_t timestamp;  // Unix time of the last read
+  double last;
+  double min;
+  double max;
+  double sum;
+};
+
+using WindowAggregateList =
+    std::vector<WindowAggregate, STLPSRAMAllocator<WindowAggregate>>;
+
+/**
+ * Closed-window statistics passed to PollPlanRegistry::drainAggregates()
+ * visitors (min/max/mean are NaN if the window had no finite read)
+ */
+struct WindowStats {
+  double last;
+  double min;
+  double max;
+  double mean;
+  uint32_t count;
+  uint32_t timestamp;
+};
+
+/**
+ * Compiled device plan: registers + precomputed block-read spans + reusable
+ * per-cycle scratch buffers (no allocation in the polling loop)
+ */
+struct CompiledDevicePlan {
+  // Device-level fields (read once per refresh)
+  const char* deviceId = "UNKNOWN";
+  const char* deviceName = "";
+  uint8_t slaveId = 1;
+  uint32_t refreshRateMs = 5000;
+  uint8_t serialPort = 1;  // v1.3.3: RTU bus (per-bus worker selection)
+  uint8_t pipelineDepth = 1;  // v1.3.3: TCP requests in flight per connection
+  // v1.3.3: RTU bus timing (see RtuMaster)
+  uint32_t baudRate = 9600;
+  uint32_t responseTimeoutMs = 0;  // 0 = RtuMaster default (2000ms)
+  uint32_t interFrameUs = 0;       // Silence before a request (t3.5 default)
+  uint16_t turnaroundMs = 10;      // Pause after each request on the bus
+  bool autoTimeout = false;        // Tighten timeout from measured latency
+  uint8_t serverUnitId = 1;  // v1.3.3: "server_unit_id" (default: slave_id)
+  // v1.3.3: "adaptive_refresh" interval state (polling task only)
+  AdaptiveRefresh adaptive;
+  uint32_t signature = 0;  // Hash of register_id/address/FC list (layout)
+
+  // PollPlanRegistry binding (binary queue records reference this slot)
+  uint8_t registrySlot = 0xFF;  // PollPlanRegistry::INVALID_SLOT if unbound
+  uint16_t registryGeneration = 0;
+
+  CompiledRegisterList registers;  // Config order (index = slot)
+  ModbusPollItemList items;        // Sorted by (FC, address)
+  ModbusReadSpanList spans;        // Index into items
+  uint16_t invalidCount = 0;       // Address overflow (counted as failed)
+
+  // v1.3.3: Decode + calibration per register (1 per reg, reads slotWords)
+  ModbusDecodeList decoders;
+
+  // Scratch buffers reused every cycle (sized at compile time)
+  std::vector<uint16_t, STLPSRAMAllocator<uint16_t>> slotWords;  // 4 per reg
+  // v1.3.3: Calibrated values of the cycle (ModbusPollPlan::decodeSlots)
+  std::vector<double, STLPSRAMAllocator<double>> slotValues;  // 1 per reg
+  std::vector<uint8_t, STLPSRAMAllocator<uint8_t>> slotStatus;   // 1 per reg
+  // v1.3.3: Unix time of the span response (one clock read per span)
+  std::vector<uint32_t, STLPSRAMAllocator<uint32_t>> slotTime;  // 1 per reg
+
+  LatestValueList latest;  // 1 per reg (v1.3.3: MQTT latest-value table)
+  // v1.3.3: millis() of the last reported value (report-by-exception)
+  std::vector<uint32_t, STLPSRAMAllocator<uint32_t>> reportedAt;  // 1 per reg
+  // v1.3.3: Publish window statistics (2 per reg, see WindowAggregate)
+  WindowAggregateList aggregates;
+
+  // v1.3.3: Interval of the next poll (adaptive, or refresh_rate_ms)
+  uint32_t pollIntervalMs() const {
+    return adaptive.enabled ? adaptive.intervalMs : refreshRateMs;
+  }
+
+  void resetSlots() {
+    std::fill(slotStatus.begin(), slotStatus.end(),
+              (uint8_t)PollSlotStatus::NOT_READ);
+  }
+};
+
+class ModbusPollPlan {
+ public:
+  /**
+   * Compile a device config into a poll plan
+   *
+   * @param deviceConfig Device JSON (must outlive the plan, see Ownership)
+   * @param plan Output plan (cleared first)
+   * @param maxRegisters Max words per FC3/FC4 span for this transport
+   * @param maxBits Max bits per FC1/FC2 span for this transport
+   * @return true if at least one register is pollable
+   */
+  static bool compile(const JsonObject& deviceConfig, CompiledDevicePlan& plan,
+                      uint16_t maxRegisters, uint16_t maxBits);
+
+  /**
+   * Decode and calibrate all slots into slotValues in one pass (after the
+   * span loop; values of slots that are not OK are meaningless)
+   */
+  static void decodeSlots(CompiledDevicePlan& plan) {
+    ModbusUtils::decodeSpan(plan.slotWords.data(), plan.decoders.data(),
+                            plan.decoders.size(), plan.slotValues.data());
+  }
+
+  /**
+   * v1.3.3: Hash of the raw words of the registers read OK in this cycle
+   * (AdaptiveRefresh change detection, after the span loop)
+   */
+  static uint32_t valueSignature(const CompiledDevicePlan& plan);
+
+  /**
+   * Report-by-exception filter (polling task only)
+   *
+   * The last reported value is plan.latest (only written for reported
+   * values). A value is reported if the register has no deadband settings,
+   * nothing was reported yet, the change exceeds "deadband" or
+   * "deadband_percent" (any change if only "max_silence_ms" is set), or
+   * "max_silence_ms" has passed since the last report. Stamps reportedAt
+   * when it returns true.
+   *
+   * @return false if the reading is suppressed (not queued, not published)
+   */
+  static bool checkDeadband(CompiledDevicePlan& plan, uint16_t registerSlot,
+                            double value, uint32_t nowMs);
+
+  /**
+   * Overwrite the latest value of a register (polling task only, lock-free)
+   */
+  static void storeLatest(CompiledDevicePlan& plan, uint16_t registerSlot,
+                          double value, uint32_t timestamp) {
+    LatestValue& entry = plan.latest[registerSlot];
+    uint32_t version = entry.version;
+    __atomic_store_n(&entry.version, version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    entry.value = value;
+    entry.timestamp = timestamp;
+    __atomic_store_n(&entry.version, version + 2, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * Add one read to the register's open publish window (polling task only,
+   * lock-free). Called for every read, before checkDeadband(), so readings
+   * inside the deadband still count towards min/max/mean.
+   */
+  static void storeAggregate(CompiledDevicePlan& plan, uint16_t registerSlot,
+                             double value, uint32_t timestamp,
+                             uint32_t window) {
+    WindowAggregate& bucket = plan.aggregates[registerSlot * 2 + (window & 1)];
+    uint32_t version = bucket.version;
+    __atomic_store_n(&bucket.version, version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    if (bucket.window != window) {
+      bucket.window = window;
+      bucket.count = 0;
+      bucket.valid = 0;
+      bucket.sum = 0.0;
+    }
+    bucket.count++;
+    bucket.last = value;
+    bucket.timestamp = timestamp;
+    if (!isnan(value)) {
+      if (bucket.valid == 0 || value < bucket.min) bucket.min = value;
+      if (bucket.valid == 0 || value > bucket.max) bucket.max = value;
+      bucket.sum += value;
+      bucket.valid++;
+    }
+    __atomic_store_n(&bucket.version, version + 2, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * Build the MQTT/HTTP/BLE data point of one register reading
+   *
+   * Single definition of the data point format (previously duplicated in
+   * RTU/TCP storeRegisterValue). Also used to expand binary queue records.
+   *
+   * @param plan Owning device plan (device_id, device_name)
+   * @param reg Compiled register
+   * @param value Calibrated value
+   * @param timestamp Unix time (0 = RTC unavailable, "time" omitted)
+   * @param dataPoint Output object
+   * @param fixedText v1.3.3: "value" as fixed-decimal text (JSON encoders
+   *        only, see NumberFormat)
+   */
+  static void buildDataPoint(const CompiledDevicePlan& plan,
+                             const CompiledRegister& reg, double value,
+                             uint32_t timestamp, JsonObject& dataPoint,
+                             bool fixedText = false);
+
+  // v1.3.3: "decimals" of a register of plan (-1 = auto)
+  static int8_t decimalsOf(const CompiledDevicePlan& plan,
+                           const CompiledRegister& reg);
+
+ private:
+  ModbusPollPlan() {}
+};
+
+/**
+ * PollPlanRegistry - Maps compact device slots to live compiled plans
+ *
+ * v1.3.3: Binary queue records (QueueManager) store only a device slot,
+ * register slot, timestamp and value. Strings are resolved through this
+ * registry at publish time.
+ *
+ * Lifecycle (per service refreshDeviceList()):
+ *   epoch = beginRefresh();
+ *   attach(owner, epoch, plan) for every new plan (after the vector is final)
+ *   endRefresh(owner, epoch);   // releases slots of removed devices
+ *   ...then the old device vector may be destroyed
+ *
+ * A device keeps its slot across refreshes. The slot generation is bumped
+ * when the register layout (signature) changes or the slot is released, so
+ * records queued against an old layout are dropped instead of mislabeled.
+ */
+class PollPlanRegistry {
+ public:
+  static constexpr uint8_t MAX_SLOTS = 254;  // v1.3.3: Every device bound
+  static constexpr uint8_t INVALID_SLOT = 0xFF;
+
+  enum Owner : uint8_t { OWNER_NONE = 0, OWNER_RTU = 1, OWNER_TCP = 2 };
+
+  static PollPlanRegistry* getInstance();
+
+  uint32_t beginRefresh();
+  bool attach(Owner owner, uint32_t epoch, CompiledDevicePlan& plan);
+  void endRefresh(Owner owner, uint32_t epoch);
+
+  /**
+   * Expand a register reading into a full data point
+   * @param fixedText See ModbusPollPlan::buildDataPoint()
+   * @return false if slot/generation is stale or register slot out of range
+   */
+  bool resolveRegister(uint8_t slot, uint16_t generation,
+                       uint16_t registerSlot, double value,
+                       uint32_t timestamp, JsonObject& dataPoint,
+                       bool fixedText = false);
+
+  /**
+   * Write "device_id" of a slot into dataPoint
+   * @return false if slot/generation is stale
+   */
+  bool resolveDevice(uint8_t slot, uint16_t generation, JsonObject& dataPoint);
+
+  /**
+   * Check whether a slot belongs to deviceId (QueueManager::flushDeviceData)
+   */
+  bool matchesDevice(uint8_t slot, uint16_t generation, const char* deviceId);
+
+  /**
+   * v1.3.3: Write the register table of a slot into schema (binary BLE
+   * stream): device_id, device_name and registers[] of {index (register
+   * slot), register_id, name, unit, decimals}
+   * @return false if slot/generation is stale
+   */
+  bool describeDevice(uint8_t slot, uint16_t generation, JsonObject& schema);
+
+  /**
+   * v1.3.3: Compact MQTT layout. layoutVersion() changes whenever a slot is
+   * bound to a new plan or released (device config refresh, delete).
+   * describeLayout() adds every live device in slot order (same objects as
+   * describeDevice()) and fills layout[MAX_SLOTS]: position in devices
+   * (-1 = none) and generation per slot.
+   * @return layoutVersion() the description belongs to
+   */
+  struct LayoutEntry {
+    int16_t position;
+    uint16_t generation;
+  };
+  uint32_t layoutVersion() const {
+    return __atomic_load_n(&layoutCounter, __ATOMIC_ACQUIRE);
+  }
+  uint32_t describeLayout(JsonArray& devices, LayoutEntry* layout);
+
+  /**
+   * Bump the generation of deviceId's slot (device deleted). All queued
+   * records of the device become stale; the slot is released by the next
+   * endRefresh() of its owner.
+   */
+  bool retireDevice(const char* deviceId);
+
+  /**
+   * Visitor of drainLatest(). Called under the registry mutex, grouped by
+   * device (one plan after the other); plan/reg are only valid in the call.
+   */
+  using LatestVisitor =
+      std::function<void(const CompiledDevicePlan& plan,
+                         const CompiledRegister& reg, double value,
+                         uint32_t timestamp)>;
+
+  /**
+   * Walk registers updated since the previous drain (MQTT publisher) and mark
+   * them published. Retired/removed devices are skipped.
+   * @return Number of registers visited
+   */
+  int drainLatest(const LatestVisitor& visitor);
+
+  /**
+   * Number of registers updated since the previous drain
+   */
+  int pendingLatest();
+
+  /**
+   * v1.3.3: One register of a live plan, with the latest-value version a
+   * reader (MQTT custom topic) last consumed. Resolved once per layout
+   * change, so publishing needs no register_id string matching.
+   */
+  struct RegisterRef {
+    uint8_t slot;
+    uint16_t generation;
+    uint16_t registerSlot;
+    uint32_t seenVersion;  // Reader-owned (0 = nothing consumed)
+  };
+  using RegisterRefList = std::vector<RegisterRef>;
+
+  /**
+   * Resolve register_ids to every matching register of every live device.
+   * refs is sorted by (slot, registerSlot), i.e. grouped by device.
+   * seenVersion is carried over from the previous refs where the register
+   * is unchanged.
+   * @return layoutVersion() the refs belong to
+   */
+  uint32_t resolveRegisters(const std::vector<String>& registerIds,
+                            RegisterRefList& refs);
+
+  /**
+   * Visit every ref whose latest value changed since its seenVersion
+   * (independent of drainLatest() and of other ref lists; also marks the
+   * entry published for pendingLatest()). Stale refs are skipped.
+   * @return Number of registers visited
+   */
+  int readLatest(RegisterRefList& refs, const LatestVisitor& visitor);
+
+  /**
+   * v1.3.3: Visitor of visitPlans(). Called under the registry mutex; plan
+   * is only valid in the call.
+   */
+  using PlanVisitor = std::function<void(
+      uint8_t slot, uint16_t generation, const CompiledDevicePlan& plan)>;
+
+  /**
+   * Visit every live plan in slot order (Modbus TCP server map)
+   * @return layoutVersion() the visit belongs to
+   */
+  uint32_t visitPlans(const PlanVisitor& visitor);
+
+  /**
+   * v1.3.3: Copy the latest values of count refs without consuming them
+   * (seenVersion / publishedVersion unchanged, Modbus TCP server).
+   * values[i].version is 0 for stale refs and registers never read.
+   */
+  void peekLatest(const RegisterRef* refs, size_t count, LatestValue* values);
+
+  /**
+   * v1.3.3: Publish window id for ModbusPollPlan::storeAggregate()
+   * (lock-free, read by the polling tasks for every sample)
+   */
+  static uint32_t currentWindow() {
+    return __atomic_load_n(&windowCounter, __ATOMIC_ACQUIRE);
+  }
+
+  /**
+   * Visitor of drainAggregates(). Same calling rules as LatestVisitor.
+   */
+  using AggregateVisitor =
+      std::function<void(const CompiledDevicePlan& plan,
+                         const CompiledRegister& reg,
+                         const WindowStats& stats)>;
+
+  /**
+   * v1.3.3: Close the open publish window and walk every register read in
+   * it (MQTT publisher, mqtt_config.aggregation = "window"). Also marks the
+   * latest-value table published, so pendingLatest() stays meaningful.
+   * A read racing the window switch may be counted in no window.
+   * @return Number of registers visited
+   */
+  int drainAggregates(const AggregateVisitor& visitor);
+
+  /**
+   * Number of registers read in the open publish window
+   */
+  int pendingAggregates();
+
+ private:
+  struct Slot {
+    CompiledDevicePlan* plan;  // deviceId read from plan (kept alive)
+    uint32_t signature;
+    uint32_t epoch;
+    uint16_t generation;
+    Owner owner;
+  };
+
+  Slot* slots;  // MAX_SLOTS entries (PSRAM)
+  SemaphoreHandle_t mutex;
+  uint32_t epochCounter;
+  uint32_t layoutCounter;  // v1.3.3: Bumped under mutex, read lock-free
+  static uint32_t windowCounter;  // v1.3.3: Bumped by drainAggregates()
+
+  PollPlanRegistry();
+  const Slot* findLive(uint8_t slot, uint16_t generation) const;
+  static void describePlan(const CompiledDevicePlan& plan, JsonObject& schema);
+  void bumpLayout() {
+    __atomic_add_fetch(&layoutCounter, 1, __ATOMIC_RELEASE);
+  }
+};
+
+#endif  // MODBUS_POLL_PLAN_H
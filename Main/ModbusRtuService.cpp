@@ -2,34 +2,43 @@
 
 #include <byteswap.h>
 
-#include "CRUDHandler.h"
+#include <algorithm>  // v1.3.3: std::sort (write batching)
+
 #include "DebugConfig.h"  // MUST BE FIRST for DEV_SERIAL_* macros
+#include "AcquisitionCycle.h"  // v1.3.3: Aligned snapshot cycles
 #include "MemoryRecovery.h"
 #include "QueueManager.h"
 #include "RTCManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+#include "TaskProfiler.h"  // v1.3.3: Bus lock wait profiling
+#include "TrendHistory.h"  // v1.3.3: On-device register history
 
 // v1.3.1: External reference to global BLE priority flag (defined in Main.ino)
 // When true, RTU polling should pause to give BLE highest priority
 #include <atomic>
 extern std::atomic<bool> g_bleCommandActive;
 
-extern CRUDHandler* crudHandler;
-
 ModbusRtuService::ModbusRtuService(ConfigManager* config)
     : configManager(config),
       running(false),
-      rtuTaskHandle(nullptr),
       serial1(nullptr),
-      serial2(nullptr),
-      modbus1(nullptr),
-      modbus2(nullptr) {
+      serial2(nullptr) {
+  for (int i = 0; i < RTU_BUS_COUNT; i++) {
+    busWorkers[i].service = this;
+    busWorkers[i].serialPort = i + 1;
+    busWorkers[i].taskHandle = nullptr;
+    busWorkers[i].pollMutex = nullptr;
+    busWorkers[i].busMutex = nullptr;
+    busWorkers[i].writeLane = nullptr;
+  }
+
   // Initialize data transmission schedule
   dataTransmissionSchedule.lastTransmitted = 0;
   dataTransmissionSchedule.dataIntervalMs = 5000;  // Default 5 seconds
 }
 
 bool ModbusRtuService::init() {
-  LOG_RTU_INFO("[RTU] Initializing service with ModbusMaster library...");
+  LOG_RTU_INFO("[RTU] Initializing service (event-driven RTU master)...");
 
   if (!configManager) {
     LOG_RTU_INFO("[RTU] ERROR: ConfigManager is null");
@@ -43,9 +52,7 @@ bool ModbusRtuService::init() {
     LOG_RTU_INFO("[RTU] ERROR: Failed to allocate Serial1");
     return false;
   }
-  serial1->begin(9600, SERIAL_8N1, RTU_RX1, RTU_TX1);
-  serial1->setTimeout(200);  // FIXED: Reduce default 1000ms timeout to 200ms
-  currentBaudRate1 = 9600;
+  beginSerial(1, 9600);
 
   // Initialize Serial2 for Bus 2 (default 9600)
   serial2 = new HardwareSerial(2);
@@ -54,26 +61,7 @@ bool ModbusRtuService::init() {
     LOG_RTU_INFO("[RTU] ERROR: Failed to allocate Serial2");
     return false;
   }
-  serial2->begin(9600, SERIAL_8N1, RTU_RX2, RTU_TX2);
-  serial2->setTimeout(200);  // FIXED: Reduce default 1000ms timeout to 200ms
-  currentBaudRate2 = 9600;
-
-  // Initialize ModbusMaster instances
-  modbus1 = new ModbusMaster();
-  // FIXED Bug #12: Check allocation success
-  if (!modbus1) {
-    LOG_RTU_INFO("[RTU] ERROR: Failed to allocate ModbusMaster1");
-    return false;
-  }
-  modbus1->begin(1, *serial1);
-
-  modbus2 = new ModbusMaster();
-  // FIXED Bug #12: Check allocation success
-  if (!modbus2) {
-    LOG_RTU_INFO("[RTU] ERROR: Failed to allocate ModbusMaster2");
-    return false;
-  }
-  modbus2->begin(1, *serial2);
+  beginSerial(2, 9600);
 
   // FIXED ISSUE #1: Initialize vector mutex for thread safety
   // Prevents race conditions when BLE + polling + auto-recovery access vectors
@@ -84,6 +72,19 @@ bool ModbusRtuService::init() {
     return false;
   }
 
+  // v1.3.3: Per-bus locks (parallel bus workers)
+  for (int i = 0; i < RTU_BUS_COUNT; i++) {
+    busWorkers[i].pollMutex = xSemaphoreCreateMutex();
+    busWorkers[i].busMutex = xSemaphoreCreateMutex();
+    busWorkers[i].writeLane =
+        xQueueCreate(RTU_WRITE_LANE_DEPTH, sizeof(RtuWriteRequest*));
+    if (!busWorkers[i].pollMutex || !busWorkers[i].busMutex ||
+        !busWorkers[i].writeLane) {
+      LOG_RTU_INFO("[RTU] CRITICAL: Failed to create bus %d mutex!", i + 1);
+      return false;
+    }
+  }
+
   LOG_RTU_INFO("[RTU] Service initialized");
   return true;
 }
@@ -96,25 +97,32 @@ void ModbusRtuService::start() {
   }
 
   running = true;
-  BaseType_t result = xTaskCreatePinnedToCore(
-      readRtuDevicesTask, "MODBUS_RTU_TASK",
-      12288,  // v1.0.6: Increased from 10KB to 12KB for handling 50+ registers
-              // per device with safety margin
-      this, 2,
-      &rtuTaskHandle,  // Store the task handle
-      1);
+  // v1.3.3: One polling task per RS485 bus (same priority). Cores from
+  // TaskAffinity.h - the balanced profile runs the buses on different cores
+  static const char* const taskNames[RTU_BUS_COUNT] = {"MODBUS_RTU_BUS1",
+                                                       "MODBUS_RTU_BUS2"};
+  static const TaskAffinity::Task busTasks[RTU_BUS_COUNT] = {
+      TaskAffinity::Task::RTU_BUS1, TaskAffinity::Task::RTU_BUS2};
+  BaseType_t result = pdPASS;
+  for (int i = 0; i < RTU_BUS_COUNT && result == pdPASS; i++) {
+    result = TaskAffinity::create(
+        readRtuDevicesTask, taskNames[i],
+        12288,  // v1.0.6: Increased from 10KB to 12KB for handling 50+
+                // registers per device with safety margin
+        &busWorkers[i], busTasks[i],
+        &busWorkers[i].taskHandle);  // Store the task handle
+  }
 
   if (result == pdPASS) {
-    LOG_RTU_INFO("[RTU] Service started successfully");
+    LOG_RTU_INFO("[RTU] Service started successfully (%d bus workers)",
+                 RTU_BUS_COUNT);
 
     // Start auto-recovery task
-    // MUST stay on Core 1: Modifies device status accessed by MODBUS_RTU_TASK
-    // (Core 1)
-    BaseType_t recoveryResult =
-        xTaskCreatePinnedToCore(autoRecoveryTask, "RTU_AUTO_RECOVERY", 4096,
-                                this, 1, &autoRecoveryTaskHandle,
-                                1);  // Core 1 (must stay with RTU polling task
-                                     // to avoid race conditions)
+    // Modifies device status accessed by the MODBUS_RTU_BUS tasks, only
+    // under vectorMutex (v1.3.3: the bus tasks may run on both cores)
+    BaseType_t recoveryResult = TaskAffinity::create(
+        autoRecoveryTask, "RTU_AUTO_RECOVERY", 4096, this,
+        TaskAffinity::Task::RTU_AUTO_RECOVERY, &autoRecoveryTaskHandle);
 
     if (recoveryResult == pdPASS) {
       LOG_RTU_INFO("[RTU] Auto-recovery task started");
@@ -123,8 +131,8 @@ void ModbusRtuService::start() {
     }
   } else {
     LOG_RTU_INFO("[RTU] ERROR: Failed to create Modbus RTU task");
+    // Workers already created exit on their own (running == false)
     running = false;
-    rtuTaskHandle = nullptr;
   }
 }
 
@@ -140,219 +148,363 @@ void ModbusRtuService::stop() {
     LOG_RTU_INFO("[RTU] Auto-recovery task stopped");
   }
 
-  // CRITICAL FIX: Don't force delete main task - let it exit gracefully
-  // Task will self-delete after while(running) loop exits
-  if (rtuTaskHandle) {
-    LOG_RTU_INFO("[RTU] Waiting for main task to exit gracefully...");
+  // CRITICAL FIX: Don't force delete bus tasks - let them exit gracefully
+  // Tasks will self-delete after while(running) loop exits
+  for (int bus = 0; bus < RTU_BUS_COUNT; bus++) {
+    BusWorker& worker = busWorkers[bus];
+    if (!worker.taskHandle) continue;
+
+    LOG_RTU_INFO("[RTU] Waiting for bus %d task to exit gracefully...",
+                 worker.serialPort);
     // Wait up to 2 seconds for task to exit loop and self-delete
     for (int i = 0; i < 20; i++) {
       vTaskDelay(pdMS_TO_TICKS(100));
-      if (rtuTaskHandle == nullptr) {
-        LOG_RTU_INFO("[RTU] Main task exited gracefully");
+      if (worker.taskHandle == nullptr) {
+        LOG_RTU_INFO("[RTU] Bus %d task exited gracefully", worker.serialPort);
         break;
       }
     }
 
     // If still running after 2 seconds, force delete (shouldn't happen)
-    if (rtuTaskHandle != nullptr) {
+    if (worker.taskHandle != nullptr) {
       LOG_RTU_INFO("[RTU] WARNING: Force deleting stuck task");
-      vTaskDelete(rtuTaskHandle);
-      rtuTaskHandle = nullptr;
+      vTaskDelete(worker.taskHandle);
+      worker.taskHandle = nullptr;
     }
   }
 
   LOG_RTU_INFO("[RTU] Service stopped");
 }
 
-void ModbusRtuService::notifyConfigChange() {
+void ModbusRtuService::notifyConfigChange(const ModbusConfigChange& change) {
+  // v1.3.3: Record the changed device before raising the flag (the refresh
+  // takes the set after clearing configChangePending)
+  portENTER_CRITICAL(&changeMux);
+  pendingChanges.add(change);
+  portEXIT_CRITICAL(&changeMux);
+
   // v2.5.39: Set atomic flag for reliable config change detection
   // Consistent with ModbusTcpService implementation
   configChangePending.store(true);
-  LOG_RTU_INFO("[RTU] Config change notified - flagged for refresh\n");
+  LOG_RTU_INFO("[RTU] Config change notified (%s) - flagged for refresh\n",
+               change.deviceId ? change.deviceId : "all devices");
 
-  if (rtuTaskHandle != nullptr) {
-    xTaskNotifyGive(rtuTaskHandle);
+  // v1.3.3: Bus 1 worker owns the refresh, bus 2 worker sees the flag
+  if (busWorkers[0].taskHandle != nullptr) {
+    xTaskNotifyGive(busWorkers[0].taskHandle);
   }
 }
 
 void ModbusRtuService::readRtuDevicesTask(void* parameter) {
-  ModbusRtuService* service = static_cast<ModbusRtuService*>(parameter);
-  service->readRtuDevicesLoop();
+  BusWorker* worker = static_cast<BusWorker*>(parameter);
+  worker->service->readRtuDevicesLoop(*worker);
+}
+
+ModbusRtuService::BusWorker* ModbusRtuService::getBusWorker(int serialPort) {
+  if (serialPort < 1 || serialPort > RTU_BUS_COUNT) {
+    return nullptr;
+  }
+  return &busWorkers[serialPort - 1];
 }
 
 void ModbusRtuService::refreshDeviceList() {
+  // v1.3.3: Wait until no bus worker is inside a poll pass (plans and device
+  // entries are referenced without vectorMutex during bus transactions).
+  // refreshRequested makes running passes stop at the next span.
+  refreshRequested.store(true);
+  for (int i = 0; i < RTU_BUS_COUNT; i++) {
+    xSemaphoreTake(busWorkers[i].pollMutex, portMAX_DELAY);
+  }
+
   // FIXED ISSUE #1: Protect vector operations from race conditions
   xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
 
+  // Changes notified from here on trigger another refresh
+  configChangePending.store(false);
+
+  // v1.3.3: Devices named by the notified changes are rebuilt; the others
+  // are kept when their document is still the one in the generation
+  ModbusChangeSet changes;
+  portENTER_CRITICAL(&changeMux);
+  changes = pendingChanges;
+  pendingChanges.clear();
+  portEXIT_CRITICAL(&changeMux);
+  size_t rebuilt = 0;
+
   LOG_RTU_INFO("[RTU Task] Refreshing device list...");
-  rtuDevices.clear();  // FIXED Bug #2: Now safe - unique_ptr auto-deletes old
-                       // documents
+  // v1.3.3: Build into a new vector; old documents/plans are released only
+  // after the PollPlanRegistry points at the new plans (queued binary records
+  // are resolved against them)
+  std::vector<RtuDeviceConfig> newDevices;
 
-  JsonDocument devicesIdList;
-  JsonArray deviceIds = devicesIdList.to<JsonArray>();
-  configManager->listDevices(deviceIds);
+  // v1.3.3: Hold the config generation for the whole refresh; device
+  // documents are shared with it (was listDevices() + readDevice() copying
+  // every device into the entry document)
+  ConfigManager::DevicesGenerationHandle generation =
+      configManager->getDevicesGeneration();
+  if (!generation) {
+    generation = std::make_shared<ConfigManager::DevicesGeneration>();
+  }
 
   unsigned long now = millis();
 
-  for (JsonVariant deviceIdVar : deviceIds) {
+  for (const ConfigManager::DeviceConfigEntry& device : generation->devices) {
     const char* deviceId =
-        deviceIdVar
-            .as<const char*>();  // BUG #31: const char* (zero allocation!)
+        device.deviceId.c_str();  // BUG #31: const char* (zero allocation!)
     if (!deviceId || strcmp(deviceId, "") == 0 || strcmp(deviceId, "{}") == 0 ||
         strlen(deviceId) < 3) {
       continue;
     }
 
-    JsonDocument tempDeviceDoc;
-    JsonObject deviceObj = tempDeviceDoc.to<JsonObject>();
-    if (configManager->readDevice(deviceId, deviceObj)) {
+    if (device.config) {
+      JsonObject deviceObj = device.config->as<JsonObject>();
       const char* protocol = deviceObj["protocol"] |
                              "";  // BUG #31: const char* (zero allocation!)
       if (strcmp(protocol, "RTU") == 0) {
+        // v1.3.3: Unchanged device - copy the entry (plan, deadline and
+        // failure / timeout / metrics state). Copied, not moved: the
+        // registry still points at the old plan until attach() below.
+        RtuDeviceConfig* old = findDevice(deviceId);
+        if (old && old->doc == device.config && !changes.isFull() &&
+            !changes.contains(deviceId)) {
+          newDevices.push_back(*old);
+          continue;
+        }
+
         RtuDeviceConfig newDeviceEntry;
-        newDeviceEntry.deviceId = deviceId;
-        newDeviceEntry.doc =
-            std::make_unique<JsonDocument>();  // FIXED Bug #2: Use smart
-                                               // pointer
-        newDeviceEntry.doc->set(deviceObj);
-        rtuDevices.push_back(std::move(newDeviceEntry));
+        newDeviceEntry.deviceId = device.deviceId;  // Same handle
+        newDeviceEntry.doc = device.config;
+
+        // v1.3.3: Compile register plan ONCE (polling loop no longer walks
+        // the JsonDocument). String pointers reference newDeviceEntry.doc
+        ModbusPollPlan::compile(newDeviceEntry.doc->as<JsonObject>(),
+                                newDeviceEntry.plan, RTU_MAX_SPAN_REGISTERS,
+                                RTU_MAX_SPAN_BITS);
+        // Keep the deadline across the refresh (new devices are due now)
+        newDeviceEntry.nextPollMs = old ? old->nextPollMs : now;
+        initializeDeviceState(newDeviceEntry);
+        newDevices.push_back(std::move(newDeviceEntry));
+        rebuilt++;
       }
     }
   }
-  LOG_RTU_INFO("[RTU Task] Found %d RTU devices. Schedule rebuilt.\n",
-               rtuDevices.size());
 
-  // Initialize device tracking after device list is loaded
-  initializeDeviceFailureTracking();
-  initializeDeviceTimeouts();
-  initializeDeviceMetrics();
+  // v1.3.3: Bind compiled plans to registry slots (vector is final here)
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  uint32_t epoch = registry->beginRefresh();
+  for (auto& device : newDevices) {
+    registry->attach(PollPlanRegistry::OWNER_RTU, epoch, device.plan);
+  }
+  registry->endRefresh(PollPlanRegistry::OWNER_RTU, epoch);
+
+  // FIXED Bug #2: unique_ptr auto-deletes old documents
+  rtuDevices = std::move(newDevices);
+
+  // v1.3.3: Slots are the rtuDevices indices; the index is rebuilt with the
+  // list. State records travel with their entry (rebuilt devices were
+  // initialized above; replaces initializeDeviceFailureTracking /
+  // initializeDeviceTimeouts / initializeDeviceMetrics for all devices)
+  deviceIndex.reset(rtuDevices.size());
+  for (size_t i = 0; i < rtuDevices.size(); i++) {
+    deviceIndex.insert(rtuDevices[i].deviceId.c_str(), i);
+  }
+
+  // v1.3.3: Rebuild the per-bus schedules (workers are outside their pass)
+  for (int i = 0; i < RTU_BUS_COUNT; i++) {
+    busWorkers[i].schedule.clear();
+    busWorkers[i].schedule.reserve(rtuDevices.size());
+  }
+  // Aligned acquisition: kept and new deadlines move to a cycle boundary
+  AcquisitionCycle* cycle = AcquisitionCycle::getInstance();
+  for (size_t i = 0; i < rtuDevices.size(); i++) {
+    RtuDeviceConfig& device = rtuDevices[i];
+    BusWorker* worker = getBusWorker(device.plan.serialPort);
+    if (worker) {
+      device.nextPollMs =
+          cycle->align(device.plan.registrySlot, device.nextPollMs, millis());
+      worker->schedule.schedule(i, device.nextPollMs, device.state.readMs);
+    }
+  }
+
+  LOG_RTU_INFO(
+      "[RTU Task] Found %d RTU devices (%d rebuilt). Schedule rebuilt.\n",
+      rtuDevices.size(), rebuilt);
 
   xSemaphoreGiveRecursive(vectorMutex);
+
+  for (int i = RTU_BUS_COUNT - 1; i >= 0; i--) {
+    xSemaphoreGive(busWorkers[i].pollMutex);
+  }
+  refreshRequested.store(false);
+
+  // v1.3.3: Wake the other bus workers (sleeping until their old deadline)
+  for (int i = 1; i < RTU_BUS_COUNT; i++) {
+    if (busWorkers[i].taskHandle != nullptr) {
+      xTaskNotifyGive(busWorkers[i].taskHandle);
+    }
+  }
 }
 
-void ModbusRtuService::readRtuDevicesLoop() {
+void ModbusRtuService::readRtuDevicesLoop(BusWorker& worker) {
+  // v1.3.3: Bus 1 worker loads the device list and handles config refresh;
+  // every worker polls only the devices on its own serial_port
+  const bool ownsRefresh = (worker.serialPort == 1);
+  LOG_RTU_INFO("[RTU] Bus %d worker started\n", worker.serialPort);
+
   // Load device list at startup
-  refreshDeviceList();
+  if (ownsRefresh) {
+    refreshDeviceList();
+  }
 
   while (running) {
+    // v1.3.3: Queued writes first (also while polling is paused for BLE)
+    if (uxQueueMessagesWaiting(worker.writeLane) > 0) {
+      TaskProfiler::take(worker.busMutex, portMAX_DELAY, ProfiledLock::RTU_BUS);
+      serviceWriteLane(worker);
+      xSemaphoreGive(worker.busMutex);
+    }
+
     // ============================================
     // v1.3.1: BLE PRIORITY CHECK - Pause RTU polling when BLE is active
     // This prevents resource contention that causes 28s+ BLE response times
     // ============================================
     if (g_bleCommandActive.load()) {
       LOG_RTU_DEBUG("[RTU] BLE command active - pausing RTU polling\n");
-      vTaskDelay(pdMS_TO_TICKS(100));  // Wait 100ms before checking again
+      // Wait 100ms before checking again (v1.3.3: a queued write ends it)
+      RtuWriteRequest* pending;
+      xQueuePeek(worker.writeLane, &pending, pdMS_TO_TICKS(100));
       continue;
     }
 
-    // ============================================
-    // MEMORY RECOVERY CHECK (Phase 2 Optimization)
-    // ============================================
-    MemoryRecovery::checkAndRecover();
+    if (ownsRefresh) {
+      // ============================================
+      // MEMORY RECOVERY CHECK (Phase 2 Optimization)
+      // ============================================
+      MemoryRecovery::checkAndRecover();
 
-    // v2.5.39: Check BOTH atomic flag AND task notification for reliable config
-    // change detection Consistent with ModbusTcpService implementation
-    bool shouldRefresh = configChangePending.exchange(false);
-    if (shouldRefresh || ulTaskNotifyTake(pdTRUE, 0) > 0) {
-      LOG_RTU_INFO(
-          "[RTU] Config change detected - refreshing device list...\n");
-      refreshDeviceList();
+      // v2.5.39: Check BOTH atomic flag AND task notification for reliable
+      // config change detection Consistent with ModbusTcpService
+      // implementation
+      // v1.3.3: Write lane wake-ups are not config changes
+      bool notified =
+          (ulTaskNotifyTake(pdTRUE, 0) & ~RTU_WRITE_LANE_NOTIFY) > 0;
+      if (configChangePending.load() || notified) {
+        LOG_RTU_INFO(
+            "[RTU] Config change detected - refreshing device list...\n");
+        refreshDeviceList();
+      }
     }
 
     // FIXED ISSUE #1: Use cached rtuDevices vector instead of calling
     // ConfigManager repeatedly This eliminates redundant listDevices() and
     // readDevice() calls every 2 seconds Performance improvement: No file
     // system access in polling loop
-    unsigned long currentTime = millis();
 
-    // FIXED ISSUE #2 (REVISED): Non-blocking millis-based timing per device
-    // Loop runs continuously with SHORT delay, shouldPollDevice() handles
-    // per-device timing This allows independent refresh rates without blocking
-    // other devices
+    // v1.3.3: One pass over this bus's due devices, earliest deadline first
+    // (refreshDeviceList waits for it)
+    xSemaphoreTake(worker.pollMutex, portMAX_DELAY);
 
     // FIXED ISSUE #1: Protect vector iteration with mutex
     xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
 
-    for (auto& deviceEntry : rtuDevices) {
-      if (!running) break;
-
+    PollSlot slot;
+    while (worker.schedule.peekDue(millis(), slot)) {
       // v1.3.1: Check if BLE became active during iteration - abort polling
       if (g_bleCommandActive.load()) {
         LOG_RTU_DEBUG("[RTU] BLE command started - aborting device polling\n");
         break;  // Exit device loop, will pause at top of while loop
       }
 
-      // v2.5.39: Check for config changes during iteration using BOTH atomic
-      // flag AND task notification Consistent with ModbusTcpService
-      // implementation
-      bool midLoopRefresh = configChangePending.exchange(false);
-      if (midLoopRefresh || ulTaskNotifyTake(pdTRUE, 0) > 0) {
-        LOG_RTU_INFO(
-            "[RTU] Config change during polling - refreshing immediately...\n");
-        refreshDeviceList();
+      // v2.5.39: Check for config changes during iteration
+      // v1.3.3: Refresh itself runs at the top of the bus 1 loop (needs both
+      // bus workers outside their pass)
+      if (pollInterrupted()) {
+        LOG_RTU_DEBUG("[RTU] Bus %d: poll pass interrupted\n",
+                      worker.serialPort);
         break;  // Exit current iteration, next iteration will use updated
                 // device list
       }
 
-      // Use cached device data from rtuDevices vector
-      const char* deviceId = deviceEntry.deviceId.c_str();
-      JsonObject deviceObj = deviceEntry.doc->as<JsonObject>();
-
-      // Get device refresh rate from BLE config
-      uint32_t deviceRefreshRate = deviceObj["refresh_rate_ms"] | 5000;
-
-      // Check if device's refresh interval has elapsed (millis-based,
-      // non-blocking) shouldPollDevice() uses per-device lastRead timestamp for
-      // accurate timing
-      if (shouldPollDevice(deviceId, deviceRefreshRate)) {
-        readRtuDeviceData(deviceObj);
-        // Device-level timing is updated inside readRtuDeviceData via
-        // updateDeviceLastRead()
+      worker.schedule.popDue(millis(), slot);
+      RtuDeviceConfig& deviceEntry = rtuDevices[slot.index];
+      uint32_t readStart = millis();
+      uint32_t intervalMs = deviceEntry.plan.pollIntervalMs();
+      bool polled = readRtuDeviceData(deviceEntry);
+      if (polled) {
+        uint32_t cycleMs = millis() - readStart;
+        deviceEntry.state.readMs =
+            (uint16_t)std::min<uint32_t>(cycleMs, 0xFFFF);
+        // v1.3.3: Cycle vs interval (late = start behind the deadline)
+        int32_t lateMs = (int32_t)(readStart - slot.dueMs);
+        deviceEntry.state.cycle.record(cycleMs, lateMs > 0 ? lateMs : 0,
+                                       intervalMs);
       }
+      // v1.3.3: Done for its snapshot cycle (aligned acquisition)
+      AcquisitionCycle::getInstance()->complete(deviceEntry.plan.registrySlot);
+
+      deviceEntry.nextPollMs =
+          nextPollDeadline(deviceEntry, slot, polled, millis());
+      worker.schedule.schedule(slot.index, deviceEntry.nextPollMs,
+                               deviceEntry.state.readMs);
     }
 
-    xSemaphoreGiveRecursive(vectorMutex);
+    uint32_t waitMs =
+        worker.schedule.waitTime(millis(), RTU_MAX_IDLE_WAIT_MS);
 
-    // FIXED ISSUE #2 (REVISED): Constant short delay (non-blocking approach)
-    // v1.0.6 OPTIMIZED: Increased from 100ms to 150ms for 33% context switch reduction
-    // Loop runs every 150ms to check if any device is ready
-    // Per-device timing handled by shouldPollDevice() with millis()
-    // This allows accurate, independent timing for each device without blocking
-    // Note: 150ms is still responsive enough for typical 5000ms+ refresh rates
-    vTaskDelay(pdMS_TO_TICKS(150));
+    xSemaphoreGiveRecursive(vectorMutex);
+    xSemaphoreGive(worker.pollMutex);
+
+    // v1.3.3: Sleep until the next device is due (was a fixed 150ms loop
+    // delay: up to 150ms jitter per poll, every device checked each loop).
+    // A config change notification ends the wait early; so does a queued
+    // write (RTU_WRITE_LANE_NOTIFY, serviced at the top of the loop).
+    if (waitMs > 0) {
+      uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+      if ((notified & ~RTU_WRITE_LANE_NOTIFY) > 0 && ownsRefresh) {
+        configChangePending.store(true);  // Refresh at the top of the loop
+      }
+    } else {
+      vTaskDelay(1);  // Passes interrupted by BLE / refresh: yield
+    }
   }
 
+  // v1.3.3: Writers still waiting on the lane get their write executed
+  TaskProfiler::take(worker.busMutex, portMAX_DELAY, ProfiledLock::RTU_BUS);
+  serviceWriteLane(worker);
+  xSemaphoreGive(worker.busMutex);
+
   // CRITICAL FIX: Task must self-delete when loop exits to prevent FreeRTOS
   // abort
-  LOG_RTU_INFO("[RTU] Task loop exited, self-deleting...");
-  rtuTaskHandle = nullptr;  // Clear handle before deletion
-  vTaskDelete(NULL);        // Delete self (NULL = current task)
+  LOG_RTU_INFO("[RTU] Bus %d task loop exited, self-deleting...",
+               worker.serialPort);
+  worker.taskHandle = nullptr;  // Clear handle before deletion
+  vTaskDelete(NULL);            // Delete self (NULL = current task)
 }
 
 // ... rest of the functions (readRtuDeviceData, processRegisterValue, etc.)
 // remain the same ...
 
-void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
+bool ModbusRtuService::readRtuDeviceData(RtuDeviceConfig& device) {
+  JsonObject deviceConfig = device.doc->as<JsonObject>();
+  CompiledDevicePlan& plan = device.plan;
+
   const char* deviceId = deviceConfig["device_id"] |
                          "UNKNOWN";  // BUG #31: const char* (zero allocation!)
   int serialPort = deviceConfig["serial_port"] | 1;
-  uint8_t slaveId = deviceConfig["slave_id"] | 1;
-  uint32_t deviceRefreshRate =
-      deviceConfig["refresh_rate_ms"] | 5000;  // Device-level refresh rate
   uint32_t baudRate =
       deviceConfig["baud_rate"] | 9600;  // Get device baudrate from config
-  JsonArray registers = deviceConfig["registers"];
 
-  // OPTIMIZED: Get device_name once per device cycle (not per register)
-  const char* deviceName = deviceConfig["device_name"] |
-                           "";  // BUG #31: const char* (zero allocation!)
+  // v1.3.3: Device fields and registers come from the compiled plan
+  uint8_t slaveId = plan.slaveId;
+  const char* deviceName = plan.deviceName;
+  size_t registerTotal = plan.registers.size();
 
-  if (registers.size() == 0) {
-    return;
+  if (registerTotal == 0) {
+    return false;
   }
 
   // Check if device is enabled (failure state check)
-  if (!isDeviceEnabled(deviceId)) {
+  if (!isDeviceEnabled(device)) {
     // v2.5.9: Use throttled logging to prevent spam (log once per 30s per
     // device)
     static LogThrottle disabledThrottle(30000);
@@ -362,13 +514,12 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
     if (disabledThrottle.shouldLog(contextMsg)) {
       LOG_RTU_INFO("Device %s is disabled, skipping read\n", deviceId);
     }
-    return;
+    return false;
   }
 
   // Check if device should retry based on backoff timing
-  DeviceFailureState* failureState = getDeviceFailureState(deviceId);
-  if (failureState && failureState->retryCount > 0) {
-    if (!shouldRetryDevice(deviceId)) {
+  if (device.state.failure.retryCount > 0) {
+    if (!shouldRetryDevice(device)) {
       static LogThrottle retryThrottle(30000);  // Log every 30s to reduce spam
       char contextMsg[128];
       snprintf(contextMsg, sizeof(contextMsg), "RTU Device %s retry backoff",
@@ -377,30 +528,18 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
         LOG_RTU_DEBUG("Device %s retry backoff not elapsed, skipping\n",
                       deviceId);
       }
-      return;
+      return false;
     }
   }
 
-  ModbusMaster* modbus = getModbusForBus(serialPort);
-  if (!modbus) {
-    return;
+  if (!getBusWorker(serialPort)) {
+    return false;
   }
 
-  // Configure baudrate for this device (with caching to avoid unnecessary
-  // reconfig)
-  configureBaudRate(serialPort, baudRate);
-
-  // Set slave ID for this device
+  // v1.3.3: Baudrate (cached) and slave ID are applied per transaction in
+  // readSpanOnBus() under the bus lock (shared with writeRegisterValue)
   LOG_RTU_VERBOSE("Polling device %s (Slave:%d Port:%d Baud:%d)\n", deviceId,
                   slaveId, serialPort, baudRate);
-  if (serialPort == 1) {
-    modbus1->begin(slaveId, *serial1);
-  } else if (serialPort == 2) {
-    modbus2->begin(slaveId, *serial2);
-  }
-
-  // Track device attempt time (for retry interval gating)
-  updateDeviceLastRead(deviceId);
 
   // Track register read results (for End-of-Batch Marker)
   bool anyRegisterSucceeded = false;
@@ -415,22 +554,30 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
       "";  // BUG #31: PSRAMString to avoid DRAM fragmentation
   int successCount = 0;
   int lineNumber = 1;
+  // v1.3.3: The compact [DATA] line is only built if LOG_DATA_DEBUG is
+  // compiled in and enabled (was built on every poll and then dropped)
+  const bool buildDataLog =
+      logCompiled(LOG_LEVEL_DATA, LOG_DEBUG) && LOG_CHECK(LOG_DEBUG);
 
   // FIXED ISSUE #4: Move buffers outside register loop to reduce stack
   // allocation Prevents stack overflow with large register counts (50+
   // registers) These buffers are reused across loop iterations instead of
   // allocated per iteration
-  char dataTypeBuf[64];  // For FC3/4 data type parsing (max 64 chars)
-  uint16_t
-      values[4];  // For FC3/4 multi-register reads (max 4 registers = 8 bytes)
-
-  // Development mode: Collect polled data in JSON format for debugging (always
-  // compiled, runtime-checked)
-  SpiRamJsonDocument polledDataDoc;
+  uint16_t spanValues[RTU_MAX_SPAN_REGISTERS];  // v1.3.3: One span response
+
+  // Development mode: Collect polled data in JSON format for debugging
+  // v1.3.3: Compiled out with LOG_LEVEL_RTU below LOG_INFO (production
+  // build), runtime-checked otherwise (was always compiled)
+  const bool collectPolledData =
+      logCompiled(LOG_LEVEL_RTU, LOG_INFO) && IS_DEV_MODE();
+  // v1.3.3: From the bus worker's arena, released before the next poll
+  BusWorker& worker = busWorkers[(serialPort == 2) ? 1 : 0];
+  worker.pollArena.reset();
+  SpiRamJsonDocument polledDataDoc(&worker.pollArena);
   JsonObject polledData;
   JsonArray polledRegisters;
 
-  if (IS_DEV_MODE()) {
+  if (collectPolledData) {
     polledData = polledDataDoc.to<JsonObject>();
     polledData["device_id"] = deviceId;
     polledData["device_name"] = deviceName;
@@ -440,209 +587,158 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
     polledRegisters = polledData["registers"].to<JsonArray>();
   }
 
-  for (JsonVariant regVar : registers) {
+  // ============================================================================
+  // v1.3.3: BLOCK-READ PLANNING (register coalescing)
+  // ============================================================================
+  // Previous: One request/response per register (45 registers = 45 round-trips
+  // at 9600 baud, several seconds per device cycle)
+  // New: Registers with the same function code and contiguous addresses are
+  // merged into spans and each span is read ONCE (45 registers = 1 round-trip)
+  //
+  // Phase 1: Spans planned at refreshDeviceList() (ModbusPollPlan::compile)
+  // Phase 2: Read spans, copy raw words into per-register slots
+  // Phase 3: Decode + store slots in CONFIG ORDER (queue/MQTT order unchanged)
+  plan.resetSlots();
+  failedRegisterCount += plan.invalidCount;  // Address overflow registers
+
+  LOG_RTU_VERBOSE("Device %s: %d registers -> %d block read(s)\n", deviceId,
+                  plan.items.size(), plan.spans.size());
+
+  // v1.3.3: Timestamps come from the RTCManager fast clock, read once per
+  // span response (was one RTC I2C transaction per stored register)
+  RTCManager* rtcMgr = RTCManager::getInstance();
+
+  for (const ModbusReadSpan& span : plan.spans) {
     if (!running) break;
 
     // v2.5.41: Check for config changes DURING register iteration
     // CRITICAL FIX: Without this, many registers × timeout = long delay before
     // config refresh With this check, config changes are detected within 1
-    // register poll cycle
-    if (configChangePending.load()) {
+    // span poll cycle
+    if (configChangePending.load() || refreshRequested.load()) {
       LOG_RTU_INFO(
           "[RTU] Config change during register polling - aborting device "
           "read...\n");
-      break;  // Exit register loop immediately, let device loop handle refresh
+      break;  // Exit span loop immediately, let device loop handle refresh
     }
 
-    JsonObject reg = regVar.as<JsonObject>();
-    uint8_t functionCode = reg["function_code"] | 3;
-    uint16_t address = reg["address"] | 0;
-    const char* registerName =
-        reg["register_name"] |
-        "Unknown";  // BUG #31: const char* (zero allocation!)
-
-    // CLEANUP: Removed per-register polling logic
-    // All registers now use device-level polling interval (deviceRefreshRate)
-    // Device-level timing is already checked in shouldPollDevice() before
-    // calling this function
-
-    uint8_t result;
-    bool registerSuccess = false;
-
-    if (functionCode == 1) {
-      result = modbus->readCoils(address, 1);
-      if (result == modbus->ku8MBSuccess) {
-        double value = (modbus->getResponseBuffer(0) & 0x01) ? 1.0 : 0.0;
-
-        // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
-        // failures
-        bool storeSuccess =
-            storeRegisterValue(deviceId, reg, value, deviceName);
-
-        // Track result for End-of-Batch Marker
-        if (storeSuccess) {
-          successRegisterCount++;
-        } else {
-          failedRegisterCount++;  // Failure: queue full or memory exhausted
-        }
+    uint8_t result = readSpanOnBus(device, span.functionCode,
+                                   span.startAddress, span.quantity,
+                                   spanValues);
 
-        // FIXED ISSUE #3: Use helper function to eliminate duplication
-        const char* unit = reg["unit"] | "";
-        appendRegisterToLog(registerName, value, unit, deviceId, outputBuffer,
-                            compactLine, successCount, lineNumber);
-
-        // Add to JSON debug output (runtime check)
-        if (IS_DEV_MODE()) {
-          JsonObject regObj = polledRegisters.add<JsonObject>();
-          regObj["name"] = registerName;
-          regObj["address"] = address;
-          regObj["function_code"] = functionCode;
-          regObj["value"] = value;
-          if (strlen(unit) > 0) regObj["unit"] = unit;
-        }
+    if (result == RtuMaster::ku8MBSuccess) {
+      uint32_t spanTime = rtcMgr ? rtcMgr->getUnixTime() : 0;
+      for (uint16_t i = 0; i < span.itemCount; i++) {
+        const ModbusPollItem& item = plan.items[span.firstItem + i];
+        uint16_t offset = item.address - span.startAddress;
+        uint16_t* slot = &plan.slotWords[item.index * 4];
 
-        registerSuccess = true;
-        anyRegisterSucceeded = true;
-      } else {
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, registerName);
-        failedRegisterCount++;
-      }
-    } else if (functionCode == 2) {
-      result = modbus->readDiscreteInputs(address, 1);
-      if (result == modbus->ku8MBSuccess) {
-        double value = (modbus->getResponseBuffer(0) & 0x01) ? 1.0 : 0.0;
-
-        // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
-        // failures
-        bool storeSuccess =
-            storeRegisterValue(deviceId, reg, value, deviceName);
-
-        // Track result for End-of-Batch Marker
-        if (storeSuccess) {
-          successRegisterCount++;
+        if (span.functionCode <= 2) {
+          slot[0] = ModbusUtils::extractBit(spanValues, offset) ? 1 : 0;
         } else {
-          failedRegisterCount++;  // Failure: queue full or memory exhausted
+          memcpy(slot, &spanValues[offset], item.width * sizeof(uint16_t));
         }
-
-        // FIXED ISSUE #3: Use helper function to eliminate duplication
-        const char* unit = reg["unit"] | "";
-        appendRegisterToLog(registerName, value, unit, deviceId, outputBuffer,
-                            compactLine, successCount, lineNumber);
-
-        // Add to JSON debug output (runtime check)
-        if (IS_DEV_MODE()) {
-          JsonObject regObj = polledRegisters.add<JsonObject>();
-          regObj["name"] = registerName;
-          regObj["address"] = address;
-          regObj["function_code"] = functionCode;
-          regObj["value"] = value;
-          if (strlen(unit) > 0) regObj["unit"] = unit;
+        plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::OK;
+        plan.slotTime[item.index] = spanTime;
+      }
+    } else if (span.itemCount > 1 &&
+               result != RtuMaster::ku8MBResponseTimedOut) {
+      // Span rejected with an exception (e.g. 0x02 Illegal Data Address when
+      // the slave's register map has a boundary inside the span). Fall back
+      // to per-register reads so valid registers are still collected.
+      // Timeouts do NOT fall back: device is offline, N more timeouts would
+      // only stall the bus.
+      LOG_RTU_DEBUG(
+          "Device %s: Block read FC%d @%d x%d failed (0x%02X), falling back "
+          "to per-register reads\n",
+          deviceId, span.functionCode, span.startAddress, span.quantity,
+          result);
+
+      for (uint16_t i = 0; i < span.itemCount; i++) {
+        if (pollInterrupted()) break;
+
+        const ModbusPollItem& item = plan.items[span.firstItem + i];
+        pauseUnlocked(plan.turnaroundMs);  // Gap between requests
+
+        if (readSpanOnBus(device, item.functionCode, item.address,
+                          item.width, spanValues) == RtuMaster::ku8MBSuccess) {
+          uint16_t* slot = &plan.slotWords[item.index * 4];
+          if (item.functionCode <= 2) {
+            slot[0] = spanValues[0] & 0x01;
+          } else {
+            memcpy(slot, spanValues, item.width * sizeof(uint16_t));
+          }
+          plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::OK;
+          plan.slotTime[item.index] = rtcMgr ? rtcMgr->getUnixTime() : 0;
+        } else {
+          plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::FAILED;
         }
-
-        registerSuccess = true;
-        anyRegisterSucceeded = true;
-      } else {
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, registerName);
-        failedRegisterCount++;
       }
-    } else if (functionCode == 3 || functionCode == 4) {
-      // BUG #31: Use PSRAMString for data type parsing (was String)
-      PSRAMString dataType = reg["data_type"] | "INT16";
-
-      // FIXED ISSUE #4: Use buffer declared outside loop (line 370)
-      // Manual uppercase conversion (PSRAMString doesn't have toUpperCase()
-      // yet)
-      strncpy(dataTypeBuf, dataType.c_str(), sizeof(dataTypeBuf) - 1);
-      dataTypeBuf[sizeof(dataTypeBuf) - 1] = '\0';
-      for (int i = 0; dataTypeBuf[i]; i++) {
-        dataTypeBuf[i] = toupper(dataTypeBuf[i]);
+    } else {
+      for (uint16_t i = 0; i < span.itemCount; i++) {
+        plan.slotStatus[plan.items[span.firstItem + i].index] =
+            (uint8_t)PollSlotStatus::FAILED;
       }
+    }
 
-      int registerCount = 1;
-      const char* baseType = dataTypeBuf;
-      const char* endianness_variant = "";
+    // OPTIMIZED: Reduced delay from 100ms to 10ms to speed up batch processing
+    // v1.3.3: Now applied per span (not per register), per-device
+    // "turnaround_ms" (default 10, 0 = inter-frame silence only)
+    // This prevents MQTT keep-alive timeout during long polling cycles
+    pauseUnlocked(plan.turnaroundMs);
+  }
 
-      char* underscorePos = strchr(dataTypeBuf, '_');
-      if (underscorePos != NULL) {
-        *underscorePos = '\0';  // Split string at underscore
-        baseType = dataTypeBuf;
-        endianness_variant = underscorePos + 1;
-      }
+  // Phase 3: Decode and store in config order
+  // v1.3.3: One batch decode over all slots (calibration included, see
+  // ModbusUtils::decodeSpan), then store per register
+  ModbusPollPlan::decodeSlots(plan);
+  for (uint16_t slotIndex = 0; slotIndex < registerTotal; slotIndex++) {
+    PollSlotStatus status = (PollSlotStatus)plan.slotStatus[slotIndex];
+    if (status == PollSlotStatus::NOT_READ) {
+      continue;  // Invalid FC, address overflow, or read aborted
+    }
 
-      // Determine register count based on base type
-      if (strcmp(baseType, "INT32") == 0 || strcmp(baseType, "UINT32") == 0 ||
-          strcmp(baseType, "FLOAT32") == 0) {
-        registerCount = 2;
-      } else if (strcmp(baseType, "INT64") == 0 ||
-                 strcmp(baseType, "UINT64") == 0 ||
-                 strcmp(baseType, "DOUBLE64") == 0) {
-        registerCount = 4;
-      }
+    const CompiledRegister& reg = plan.registers[slotIndex];
 
-      // FIXED Bug #8: Validate address range doesn't overflow uint16_t address
-      // space
-      if (address > (65535 - registerCount + 1)) {
-        LOG_RTU_INFO(
-            "[RTU] ERROR: Address range overflow for %s (addr=%d, count=%d, "
-            "max=%d)\n",
-            registerName, address, registerCount,
-            address + registerCount - 1);  // BUG #31: removed .c_str()
-        failedRegisterCount++;
-        continue;  // Skip this register
-      }
+    if (status == PollSlotStatus::FAILED) {
+      // v2.5.35: Use DEV_MODE check to prevent log leak in production
+      DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, reg.name);
+      failedRegisterCount++;
+      continue;
+    }
 
-      // FIXED ISSUE #4: Use buffer declared outside loop (line 371) to reduce
-      // stack usage
-      if (readMultipleRegisters(modbus, functionCode, address, registerCount,
-                                values)) {
-        double value =
-            (registerCount == 1)
-                ? ModbusUtils::processRegisterValue(reg, values[0])
-                : ModbusUtils::processMultiRegisterValue(
-                      reg, values, registerCount, baseType, endianness_variant);
-
-        // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
-        // failures
-        bool storeSuccess =
-            storeRegisterValue(deviceId, reg, value, deviceName);
-
-        // Track result for End-of-Batch Marker
-        if (storeSuccess) {
-          successRegisterCount++;
-        } else {
-          failedRegisterCount++;  // Failure: queue full or memory exhausted
-        }
+    // v1.3.3: Decoded + calibrated by decodeSlots() above
+    double value = plan.slotValues[slotIndex];
 
-        // FIXED ISSUE #3: Use helper function to eliminate duplication
-        const char* unit = reg["unit"] | "";
-        appendRegisterToLog(registerName, value, unit, deviceId, outputBuffer,
-                            compactLine, successCount, lineNumber);
-
-        // Add to JSON debug output (runtime check)
-        if (IS_DEV_MODE()) {
-          JsonObject regObj = polledRegisters.add<JsonObject>();
-          regObj["name"] = registerName;
-          regObj["address"] = address;
-          regObj["function_code"] = functionCode;
-          regObj["value"] = value;
-          if (strlen(unit) > 0) regObj["unit"] = unit;
-        }
+    // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
+    // failures
+    bool storeSuccess =
+        storeRegisterValue(plan, slotIndex, value, plan.slotTime[slotIndex]);
 
-        registerSuccess = true;
-        anyRegisterSucceeded = true;
-      } else {
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, registerName);
-        failedRegisterCount++;
-      }
+    // Track result for End-of-Batch Marker
+    if (storeSuccess) {
+      successRegisterCount++;
+    } else {
+      failedRegisterCount++;  // Failure: queue full or memory exhausted
     }
 
-    // OPTIMIZED: Reduced delay from 100ms to 10ms to speed up batch processing
-    // 50 registers * 10ms = 0.5s overhead (vs 5s overhead previously)
-    // This prevents MQTT keep-alive timeout during long polling cycles
-    vTaskDelay(pdMS_TO_TICKS(10));
+    // FIXED ISSUE #3: Use helper function to eliminate duplication
+    if (buildDataLog) {
+      appendRegisterToLog(reg.name, value, reg.unit, deviceId, outputBuffer,
+                          compactLine, successCount, lineNumber);
+    }
+
+    // Add to JSON debug output
+    if (collectPolledData) {
+      JsonObject regObj = polledRegisters.add<JsonObject>();
+      regObj["name"] = reg.name;
+      regObj["address"] = reg.address;
+      regObj["function_code"] = reg.functionCode;
+      regObj["value"] = value;
+      if (reg.unit[0] != '\0') regObj["unit"] = (const char*)reg.unit;
+    }
+
+    anyRegisterSucceeded = true;
   }
 
   // COMPACT LOGGING: Add remaining items and print buffer atomically
@@ -674,35 +770,45 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
   // Handle device failure state based on read results
   if (anyRegisterSucceeded) {
     // At least one register succeeded - reset failure state
-    resetDeviceFailureState(deviceId);
+    resetDeviceFailureState(device);
     LOG_RTU_INFO("Device %s: Read successful, failure state reset\n", deviceId);
 
     // Update timeout tracking
-    DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-    if (timeout) {
-      timeout->lastSuccessfulRead = millis();
-      timeout->consecutiveTimeouts = 0;
+    DeviceReadTimeout& timeout = device.state.timeout;
+    timeout.lastSuccessfulRead = millis();
+    timeout.consecutiveTimeouts = 0;
+
+    // v1.3.3: Adaptive interval from value changes and this bus's load
+    if (plan.adaptive.enabled) {
+      uint32_t previousMs = plan.adaptive.intervalMs;
+      uint8_t busPercent = worker.utilization.percentAt(millis());
+      uint32_t intervalMs = plan.adaptive.update(
+          ModbusPollPlan::valueSignature(plan), busPercent);
+      if (intervalMs != previousMs) {
+        LOG_RTU_DEBUG("Device %s: refresh %lu -> %lu ms (bus %u%%)\n",
+                      deviceId, (unsigned long)previousMs,
+                      (unsigned long)intervalMs, busPercent);
+      }
     }
-  } else if (registers.size() > 0) {
+  } else {
     // All registers failed - handle read failure
     LOG_RTU_ERROR("Device %s: All %d register reads failed\n", deviceId,
                   failedRegisterCount);
-    handleReadFailure(deviceId);
+    handleReadFailure(device);
   }
 
   // END-OF-BATCH MARKER: Signal to MQTT that device batch is complete
   // This marker allows MQTT to know when to publish per-device data
   QueueManager* queueMgr = QueueManager::getInstance();
-  if (queueMgr && registers.size() > 0) {
-    SpiRamJsonDocument markerDoc;
-    JsonObject marker = markerDoc.to<JsonObject>();
-    marker["event"] = "BATCH_END";
-    marker["device_id"] = deviceId;
-    marker["success_count"] = successRegisterCount;
-    marker["failed_count"] = failedRegisterCount;
-    marker["timestamp"] = millis();
-
-    if (queueMgr->enqueue(marker)) {
+  if (queueMgr) {
+    // v1.3.3: Binary marker record (no JSON serialization). Unbound plans
+    // (registry full) queue nothing, see storeRegisterValue()
+    bool markerQueued =
+        plan.registrySlot != PollPlanRegistry::INVALID_SLOT &&
+        queueMgr->enqueueBatchEnd(plan.registrySlot, plan.registryGeneration,
+                                  successRegisterCount, failedRegisterCount);
+
+    if (markerQueued) {
       LOG_RTU_DEBUG(
           "Batch marker enqueued for device %s (success=%d, failed=%d)\n",
           deviceId, successRegisterCount, failedRegisterCount);
@@ -711,8 +817,8 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
     }
   }
 
-  // Development mode: Print polled data as JSON (one-line) - runtime check
-  if (IS_DEV_MODE() && successRegisterCount > 0) {
+  // Development mode: Print polled data as JSON (one-line)
+  if (collectPolledData && successRegisterCount > 0) {
     polledData["success_count"] = successRegisterCount;
     polledData["failed_count"] = failedRegisterCount;
 
@@ -720,14 +826,17 @@ void ModbusRtuService::readRtuDeviceData(const JsonObject& deviceConfig) {
     serializeJson(polledDataDoc, Serial);
     Serial.println("\n");
   }
+
+  return true;
 }
 
 // NOTE: processRegisterValue() moved to ModbusUtils class (shared with
 // ModbusTcpService) See ModbusUtils.cpp for implementation
 
-bool ModbusRtuService::storeRegisterValue(const char* deviceId,
-                                          const JsonObject& reg, double value,
-                                          const char* deviceName) {
+bool ModbusRtuService::storeRegisterValue(CompiledDevicePlan& plan,
+                                          uint16_t registerSlot,
+                                          double calibratedValue,
+                                          uint32_t timestamp) {
   QueueManager* queueMgr = QueueManager::getInstance();
 
   // FIXED Bug #12: Defensive null check for QueueManager
@@ -737,75 +846,47 @@ bool ModbusRtuService::storeRegisterValue(const char* deviceId,
     return false;  // FIXED: Return false on failure
   }
 
-  // Create data point in simplified format for MQTT
-  JsonDocument dataDoc;
-  JsonObject dataPoint = dataDoc.to<JsonObject>();
-
-  // Apply calibration formula: final_value = (raw_value × scale) + offset
-  float scale = reg["scale"] | 1.0;
-  float offset = reg["offset"] | 0.0;
-  double calibratedValue = (value * scale) + offset;
-
-  // v1.0.7: Apply decimal precision if specified
-  // -1 = auto (no rounding), 0-6 = fixed decimal places
-  int decimals = reg["decimals"] | -1;
-  if (decimals >= 0 && decimals <= 6) {
-    double multiplier = pow(10.0, decimals);
-    calibratedValue = round(calibratedValue * multiplier) / multiplier;
-  }
-
-  RTCManager* rtc = RTCManager::getInstance();
-  if (rtc) {
-    DateTime now = rtc->getCurrentTime();
-    dataPoint["time"] = now.unixtime();
-  }
-  dataPoint["name"] = reg["register_name"].as<String>();
-  dataPoint["device_id"] = deviceId;
-
-  // OPTIMIZED: Use pre-fetched device_name (passed from readRtuDeviceData)
-  // This avoids expensive getAllDevicesWithRegisters() call per register
-  // BUG #31: deviceName is const char*, not String, so check for null/empty
-  // differently
-  if (deviceName && deviceName[0] != '\0') {
-    dataPoint["device_name"] = deviceName;
-  }
-
-  dataPoint["address"] =
-      reg["address"];  // Register address (e.g., 4112) for BLE streaming
-  dataPoint["value"] = calibratedValue;  // Use calibrated value
-  dataPoint["description"] =
-      reg["description"] | "";  // Optional field from BLE config
-
-  // v2.5.40: Convert "deg" to degree symbol (°) for proper unit display
-  // User request: show "°C" instead of "degC" in output
-  // This also handles legacy data that might have been stored with "deg" prefix
-  String rawUnit = reg["unit"] | "";
-  rawUnit.replace("deg",
-                  "\xC2\xB0");  // Convert "deg" to UTF-8 degree symbol (°)
-  dataPoint["unit"] = rawUnit;  // Unit with proper degree symbol
-
-  dataPoint["register_id"] =
-      reg["register_id"].as<String>();  // Internal use for deduplication
-  dataPoint["register_index"] =
-      reg["register_index"] | 0;  // For customize mode topic mapping
-
-  // v1.3.2: Add writable status for mobile app
-  // FC1 (Coils) and FC3 (Holding Registers) are writable
-  // FC2 (Discrete Inputs) and FC4 (Input Registers) are read-only
-  uint8_t functionCode = reg["function_code"] | 3;
-  dataPoint["writable"] = ModbusUtils::isWritableType(functionCode);
+  const CompiledRegister& reg = plan.registers[registerSlot];
+  const char* deviceId = plan.deviceId;
+
+  // v1.3.3: Registry full - device was reported at refresh, no per-register
+  // error/diagnostics spam
+  if (plan.registrySlot == PollPlanRegistry::INVALID_SLOT) {
+    return false;
+  }
+
+  // v1.3.3: Publish window statistics see every read (deadband or not)
+  ModbusPollPlan::storeAggregate(plan, registerSlot, calibratedValue,
+                                 timestamp, PollPlanRegistry::currentWindow());
+  // v1.3.3: Short-term history (BLE trend query) keeps every read too
+  TrendHistory::getInstance()->record(plan.registrySlot,
+                                      plan.registryGeneration, registerSlot,
+                                      calibratedValue);
+
+  // v1.3.3: Report-by-exception - readings inside the register's deadband
+  // are dropped here (counted as read, not queued or published)
+  if (!ModbusPollPlan::checkDeadband(plan, registerSlot, calibratedValue,
+                                     millis())) {
+    return true;
+  }
+
+  // v1.3.3: MQTT latest-value table (overwritten in place, no queue drain)
+  ModbusPollPlan::storeLatest(plan, registerSlot, calibratedValue, timestamp);
 
   // CRITICAL FIX: Check enqueue() return value to detect data loss
-  // If enqueue fails (queue full, memory exhausted, mutex timeout), return
-  // false
-  bool enqueueSuccess = queueMgr->enqueue(dataPoint);
+  // v1.3.3: Binary record (24 bytes, strings resolved at publish time).
+  // Lock-free enqueue: only fails if the ring was never allocated (a full
+  // ring overwrites its oldest record)
+  bool enqueueSuccess =
+      queueMgr->enqueueRegister(plan.registrySlot, plan.registryGeneration,
+                                registerSlot, calibratedValue, timestamp);
 
   if (!enqueueSuccess) {
     // CRITICAL: Log detailed error for debugging
     LOG_RTU_ERROR(
         "Failed to enqueue register '%s' for device %s (queue full or memory "
         "exhausted)\n",
-        reg["register_name"].as<String>().c_str(), deviceId);
+        reg.name, deviceId);
 
     // Trigger memory diagnostics to identify root cause
     MemoryRecovery::logMemoryStatus("ENQUEUE_FAILED_RTU");
@@ -813,52 +894,233 @@ bool ModbusRtuService::storeRegisterValue(const char* deviceId,
     return false;  // Return failure to caller
   }
 
-  // Check if this device is being streamed (BUG #31: Optimized String usage)
-  if (crudHandler && queueMgr) {
-    String streamIdStr =
-        crudHandler->getStreamDeviceId();  // CRUDHandler returns String
-    if (!streamIdStr.isEmpty() && strcmp(streamIdStr.c_str(), deviceId) == 0) {
-      // Verbose log suppressed - summary shown in [STREAM] logs
-      queueMgr->enqueueStream(dataPoint);
+  // v1.3.3: BLE streaming reads the same record through its own queue
+  // cursor (QueueManager::dequeueStream) - no second JSON copy here
+
+  return true;  // Success
+}
+
+// v1.3.3: Generalized from readMultipleRegisters() to read a whole span for any
+// read function code. Returns the raw Modbus result code so the caller can
+// distinguish exception responses (fallback) from timeouts (no fallback).
+uint8_t ModbusRtuService::readSpan(RtuMaster& master,
+                                   const RtuMaster::Request& request,
+                                   uint16_t* values) {
+  uint8_t result = master.transact(request);
+  if (result == RtuMaster::ku8MBSuccess) {
+    // Bits packed LSB-first into words for FC1/FC2
+    uint16_t wordCount = request.functionCode <= 2
+                             ? (request.quantity + 15) / 16
+                             : request.quantity;
+    if (wordCount > RTU_MAX_SPAN_REGISTERS) {
+      wordCount = RTU_MAX_SPAN_REGISTERS;  // Defensive: never overrun buffer
+    }
+    for (uint16_t i = 0; i < wordCount; i++) {
+      values[i] = master.getResponseWord(i);  // Short response: zeros
     }
   }
+  return result;
+}
 
-  return true;  // Success
+uint8_t ModbusRtuService::readSpanOnBus(RtuDeviceConfig& device,
+                                        uint8_t functionCode, uint16_t address,
+                                        uint16_t quantity, uint16_t* values) {
+  const CompiledDevicePlan& plan = device.plan;
+  BusWorker* worker = getBusWorker(plan.serialPort);
+  if (!worker) {
+    return RtuMaster::ku8MBInvalidSlaveID;
+  }
+
+  // Timing is read under vectorMutex (auto-tune state changes per read)
+  uint32_t timeoutMs = responseTimeoutFor(device);
+  uint32_t interFrameUs = interFrameFor(device);
+
+  // Plan/device entry stay valid: the caller's worker holds its pollMutex
+  xSemaphoreGiveRecursive(vectorMutex);
+  TaskProfiler::take(worker->busMutex, portMAX_DELAY, ProfiledLock::RTU_BUS);
+
+  // v1.3.3: Queued writes take the next bus slot, ahead of this read
+  serviceWriteLane(*worker);
+
+  // Configure baudrate for this device (with caching to avoid unnecessary
+  // reconfig)
+  configureBaudRate(plan.serialPort, plan.baudRate);
+  RtuMaster::Request request;
+  request.slaveId = plan.slaveId;
+  request.functionCode = functionCode;
+  request.address = address;
+  request.quantity = quantity;
+  request.timeoutMs = timeoutMs;
+  request.interFrameUs = interFrameUs;
+  uint32_t startUs = micros();
+  uint8_t result = readSpan(worker->master, request, values);
+  worker->utilization.record(micros() - startUs, millis());
+  bool responded = worker->master.responded();
+  uint32_t latencyMs = worker->master.responseLatencyMs();
+
+  xSemaphoreGive(worker->busMutex);
+  xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+
+  recordTransaction(device, result, responded, latencyMs, timeoutMs);
+  return result;
 }
 
-bool ModbusRtuService::readMultipleRegisters(ModbusMaster* modbus,
-                                             uint8_t functionCode,
-                                             uint16_t address, int count,
-                                             uint16_t* values) {
-  uint8_t result;
-  if (functionCode == 3) {
-    result = modbus->readHoldingRegisters(address, count);
-  } else  // Read Input Registers (0x04)
-  {
-    result = modbus->readInputRegisters(address, count);
-  }
-
-  if (result == modbus->ku8MBSuccess) {
-    for (int i = 0; i < count; i++) {
-      values[i] = modbus->getResponseBuffer(i);
+void ModbusRtuService::serviceWriteLane(BusWorker& worker) {
+  RtuWriteRequest* request;
+  while (xQueueReceive(worker.writeLane, &request, 0) == pdTRUE) {
+    request->result = executeWrite(worker, *request);
+    xSemaphoreGive(request->done);
+  }
+}
+
+bool ModbusRtuService::submitWrite(BusWorker& worker,
+                                   RtuWriteRequest& request) {
+  TaskHandle_t handle = worker.taskHandle;
+  if (!running || !handle || handle == xTaskGetCurrentTaskHandle()) {
+    // No bus worker to hand the write to: take the bus directly
+    if (TaskProfiler::take(worker.busMutex, pdMS_TO_TICKS(5000),
+                           ProfiledLock::RTU_BUS) != pdTRUE) {
+      return false;
     }
+    request.result = executeWrite(worker, request);
+    xSemaphoreGive(worker.busMutex);
     return true;
   }
-  return false;
+
+  request.done = xSemaphoreCreateBinaryStatic(&request.doneBuffer);
+  RtuWriteRequest* queued = &request;
+  if (xQueueSend(worker.writeLane, &queued, pdMS_TO_TICKS(5000)) != pdTRUE) {
+    vSemaphoreDelete(request.done);
+    return false;  // Lane full for 5s: bus is stuck
+  }
+  xTaskNotify(handle, RTU_WRITE_LANE_NOTIFY, eSetBits);
+
+  // The worker drains its lane before exiting; if it is gone without
+  // having run the write, drop the lane (request is on this stack)
+  bool completed = false;
+  while (!completed) {
+    completed = xSemaphoreTake(request.done, pdMS_TO_TICKS(100)) == pdTRUE;
+    if (!completed && worker.taskHandle == nullptr) {
+      completed = xSemaphoreTake(request.done, 0) == pdTRUE;
+      if (!completed) {
+        xQueueReset(worker.writeLane);
+        break;
+      }
+    }
+  }
+  vSemaphoreDelete(request.done);
+  return completed;
 }
 
-// NOTE: processMultiRegisterValue() moved to ModbusUtils class (shared with
-// ModbusTcpService) See ModbusUtils.cpp for implementation
+uint8_t ModbusRtuService::executeWrite(BusWorker& worker,
+                                       RtuWriteRequest& request) {
+  configureBaudRate(worker.serialPort, request.baudRate);
+
+  // FC5 / FC6: values[0]; FC15: coil bits, 16 per word; FC16: registers
+  // FC1-4 (recovery probe): one item, values unused
+  RtuMaster::Request frame;
+  frame.slaveId = request.slaveId;
+  frame.functionCode = request.functionCode;
+  frame.address = request.address;
+  frame.quantity = request.functionCode <= 6 ? 1 : request.count;
+  frame.values = request.values;
+  frame.timeoutMs = request.timeoutMs;
+  frame.interFrameUs = request.interFrameUs;
 
-ModbusMaster* ModbusRtuService::getModbusForBus(int serialPort) {
-  if (serialPort == 1) {
-    return modbus1;
-  } else if (serialPort == 2) {
-    return modbus2;
+  unsigned long startTime = millis();
+  uint32_t startUs = micros();
+  uint8_t result = worker.master.transact(frame);
+  worker.utilization.record(micros() - startUs, millis());
+  request.responseTimeMs = millis() - startTime;
+  return result;
+}
+
+void ModbusRtuService::pauseUnlocked(uint32_t delayMs) {
+  if (delayMs == 0) {
+    return;
+  }
+  xSemaphoreGiveRecursive(vectorMutex);
+  vTaskDelay(pdMS_TO_TICKS(delayMs));
+  xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+}
+
+bool ModbusRtuService::prepareProbe(const RtuDeviceConfig& device,
+                                    RtuWriteRequest& request) const {
+  if (device.plan.spans.empty()) {
+    return false;
+  }
+  const ModbusReadSpan& span = device.plan.spans.front();
+  request.slaveId = device.plan.slaveId;
+  request.baudRate = device.plan.baudRate;
+  request.interFrameUs = interFrameFor(device);
+  request.timeoutMs = std::min(responseTimeoutFor(device),
+                               ModbusRecoveryConfig::PROBE_TIMEOUT_MS);
+  request.functionCode = span.functionCode;
+  request.address = span.startAddress;
+  request.values[0] = 0;
+  request.count = 1;
+  request.result = RtuMaster::ku8MBResponseTimedOut;
+  return true;
+}
+
+uint32_t ModbusRtuService::responseTimeoutFor(
+    const RtuDeviceConfig& device) const {
+  uint32_t configured = device.plan.responseTimeoutMs;
+  if (configured == 0 || configured > RtuMaster::DEFAULT_TIMEOUT_MS) {
+    configured = RtuMaster::DEFAULT_TIMEOUT_MS;
+  }
+  if (configured < RTU_MIN_RESPONSE_TIMEOUT_MS) {
+    configured = RTU_MIN_RESPONSE_TIMEOUT_MS;
+  }
+
+  // Auto-tune only from a settled history without recent timeouts
+  const DeviceHealthMetrics& metrics = device.state.metrics;
+  if (!device.plan.autoTimeout ||
+      metrics.successfulReads < RTU_AUTOTUNE_MIN_SAMPLES ||
+      device.state.timeout.consecutiveTimeouts > 0) {
+    return configured;
+  }
+
+  uint32_t tuned = 2UL * metrics.maxResponseTimeMs + RTU_AUTOTUNE_MARGIN_MS;
+  if (tuned < RTU_MIN_RESPONSE_TIMEOUT_MS) tuned = RTU_MIN_RESPONSE_TIMEOUT_MS;
+  return tuned < configured ? tuned : configured;
+}
+
+uint32_t ModbusRtuService::interFrameFor(const RtuDeviceConfig& device) const {
+  return device.plan.interFrameUs > 0
+             ? device.plan.interFrameUs
+             : RtuMaster::silentIntervalUs(device.plan.baudRate);
+}
+
+void ModbusRtuService::recordTransaction(RtuDeviceConfig& device,
+                                         uint8_t result, bool responded,
+                                         uint32_t latencyMs,
+                                         uint32_t timeoutMs) {
+  DeviceReadTimeout& timeout = device.state.timeout;
+  timeout.timeoutMs = (uint16_t)timeoutMs;  // Effective (possibly tuned)
+
+  if (result == RtuMaster::ku8MBResponseTimedOut && !responded) {
+    if (timeout.consecutiveTimeouts < 255) {
+      timeout.consecutiveTimeouts++;
+    }
+  } else if (responded) {
+    timeout.consecutiveTimeouts = 0;
+  }
+
+  // Latency = request sent -> first response byte (slave turnaround)
+  bool success = result == RtuMaster::ku8MBSuccess;
+  if (latencyMs > 0xFFFF) latencyMs = 0xFFFF;
+  device.state.metrics.recordRead(success,
+                                  success ? (uint16_t)latencyMs : 0);
+  if (success) {
+    busWorkers[(device.plan.serialPort == 2) ? 1 : 0].latency.record(
+        latencyMs);
   }
-  return nullptr;
 }
 
+// NOTE: processMultiRegisterValue() moved to ModbusUtils class (shared with
+// ModbusTcpService) See ModbusUtils.cpp for implementation
+
 // FIXED ISSUE #3: Consolidated register logging helper (eliminates 80+ lines of
 // duplication) Previously duplicated across FC1, FC2, and FC3/4 handlers
 void ModbusRtuService::appendRegisterToLog(const char* registerName,
@@ -928,124 +1190,55 @@ void ModbusRtuService::getStatus(JsonObject& status) {
 
 // NEW: Modbus Improvement Phase - Helper Method Implementations
 
-void ModbusRtuService::initializeDeviceFailureTracking() {
-  deviceFailureStates.clear();
+void ModbusRtuService::initializeDeviceState(RtuDeviceConfig& device) {
+  device.state = ModbusDeviceState();
 
-  for (const auto& device : rtuDevices) {
-    DeviceFailureState state;
-    state.deviceId = device.deviceId;
-    state.consecutiveFailures = 0;
-    state.retryCount = 0;
-    state.nextRetryTime = 0;
-    state.lastReadAttempt = 0;
-    state.isEnabled = true;
-
-    // Read baudrate from device config
-    if (device.doc) {
-      JsonObject deviceObj = device.doc->as<JsonObject>();
-      state.baudRate = deviceObj["baud_rate"] | 9600;
-    } else {
-      state.baudRate = 9600;  // Fallback default
-    }
-
-    state.maxRetries = 5;
-    deviceFailureStates.push_back(state);
+  // Read baudrate from device config
+  if (device.doc) {
+    JsonObject deviceObj = device.doc->as<JsonObject>();
+    device.state.failure.baudRate = deviceObj["baud_rate"] | 9600;
   }
-  // Concise summary log
-  LOG_RTU_INFO("[RTU] Failure tracking init: %d devices\n",
-               deviceFailureStates.size());
-}
-
-void ModbusRtuService::initializeDeviceTimeouts() {
-  deviceTimeouts.clear();
 
-  for (const auto& device : rtuDevices) {
-    DeviceReadTimeout timeout;
-    timeout.deviceId = device.deviceId;
-    timeout.timeoutMs = 5000;  // Default 5 second timeout
-    timeout.consecutiveTimeouts = 0;
-    timeout.lastSuccessfulRead = millis();
-    timeout.maxConsecutiveTimeouts = 3;
-    deviceTimeouts.push_back(timeout);
-  }
-  // Concise summary log
-  LOG_RTU_INFO("[RTU] Timeout tracking init: %d devices\n",
-               deviceTimeouts.size());
+  device.state.timeout.timeoutMs = (uint16_t)responseTimeoutFor(device);
+  device.state.timeout.lastSuccessfulRead = millis();
 }
 
-ModbusRtuService::DeviceFailureState* ModbusRtuService::getDeviceFailureState(
+// v1.3.3: O(1) ID lookup for BLE/MQTT commands (was a strcmp scan per
+// tracking vector). Caller holds vectorMutex or runs in the polling task.
+ModbusRtuService::RtuDeviceConfig* ModbusRtuService::findDevice(
     const char* deviceId) {
-  for (auto& state : deviceFailureStates) {
-    if (state.deviceId == deviceId) {
-      return &state;
-    }
-  }
-  return nullptr;
-}
-
-ModbusRtuService::DeviceReadTimeout* ModbusRtuService::getDeviceTimeout(
-    const char* deviceId) {
-  for (auto& timeout : deviceTimeouts) {
-    if (timeout.deviceId == deviceId) {
-      return &timeout;
-    }
-  }
-  return nullptr;
-}
-
-// NEW: Enhancement - Device Health Metrics Tracking
-void ModbusRtuService::initializeDeviceMetrics() {
-  deviceMetrics.clear();
-
-  for (const auto& device : rtuDevices) {
-    DeviceHealthMetrics metrics;
-    metrics.deviceId = device.deviceId;
-    metrics.totalReads = 0;
-    metrics.successfulReads = 0;
-    metrics.failedReads = 0;
-    metrics.totalResponseTimeMs = 0;
-    metrics.minResponseTimeMs = 65535;
-    metrics.maxResponseTimeMs = 0;
-    metrics.lastResponseTimeMs = 0;
-    deviceMetrics.push_back(metrics);
-  }
-  // Concise summary log
-  LOG_RTU_INFO("[RTU] Metrics tracking init: %d devices\n",
-               deviceMetrics.size());
-}
-
-ModbusRtuService::DeviceHealthMetrics* ModbusRtuService::getDeviceMetrics(
-    const char* deviceId) {
-  for (auto& metrics : deviceMetrics) {
-    if (metrics.deviceId == deviceId) {
-      return &metrics;
-    }
-  }
-  return nullptr;
+  uint16_t slot = deviceIndex.find(deviceId, [&](uint16_t candidate) {
+    return candidate < rtuDevices.size() &&
+           rtuDevices[candidate].deviceId == deviceId;
+  });
+  if (slot == ModbusDeviceIndex::INVALID_SLOT) {
+    return nullptr;
+  }
+  return &rtuDevices[slot];
 }
 
 bool ModbusRtuService::configureDeviceBaudRate(const char* deviceId,
                                                uint16_t baudRate) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  RtuDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_RTU_INFO(
         "[RTU] ERROR: Device %s not found for baud rate configuration\n",
         deviceId);
     return false;
   }
 
-  state->baudRate = baudRate;
+  device->state.failure.baudRate = baudRate;
   LOG_RTU_INFO("[RTU] Configured device %s baud rate to: %d\n", deviceId,
                baudRate);
   return true;
 }
 
 uint16_t ModbusRtuService::getDeviceBaudRate(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  RtuDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     return 9600;  // Default baud rate
   }
-  return state->baudRate;
+  return device->state.failure.baudRate;
 }
 
 // Validate baudrate (only allow standard Modbus RTU baudrates)
@@ -1070,6 +1263,31 @@ bool ModbusRtuService::validateBaudRate(uint32_t baudRate) {
 }
 
 // Configure baudrate for a specific serial port (with caching)
+void ModbusRtuService::beginSerial(int serialPort, uint32_t baudRate) {
+  HardwareSerial* serial = (serialPort == 2) ? serial2 : serial1;
+  int rxPin = (serialPort == 2) ? RTU_RX2 : RTU_RX1;
+  int txPin = (serialPort == 2) ? RTU_TX2 : RTU_TX1;
+  int dePin = (serialPort == 2) ? RTU_DE2 : RTU_DE1;
+
+  // v1.3.3: Whole FC16 request fits the TX buffer (RtuMaster does not wait
+  // for the transmission)
+  serial->setTxBufferSize(RTU_TX_BUFFER_SIZE);
+  serial->begin(baudRate, SERIAL_8N1, rxPin, txPin);
+  serial->setTimeout(200);  // FIXED: Reduce default 1000ms timeout to 200ms
+  if (dePin >= 0) {
+    // v1.3.3: Hardware RS485 half-duplex, the UART driver drives DE (RTS)
+    serial->setPins(rxPin, txPin, -1, dePin);
+    serial->setMode(UART_MODE_RS485_HALF_DUPLEX);
+  }
+  busWorkers[serialPort - 1].master.attach(serial, baudRate);
+
+  if (serialPort == 2) {
+    currentBaudRate2 = baudRate;
+  } else {
+    currentBaudRate1 = baudRate;
+  }
+}
+
 void ModbusRtuService::configureBaudRate(int serialPort, uint32_t baudRate) {
   // Validate baudrate first
   if (!validateBaudRate(baudRate)) {
@@ -1083,9 +1301,7 @@ void ModbusRtuService::configureBaudRate(int serialPort, uint32_t baudRate) {
       LOG_RTU_INFO("[RTU] Reconfiguring Serial1 from %d to %d baud\n",
                    currentBaudRate1, baudRate);
       serial1->end();
-      serial1->begin(baudRate, SERIAL_8N1, RTU_RX1, RTU_TX1);
-      serial1->setTimeout(200);  // FIXED: Reset timeout after baudrate change
-      currentBaudRate1 = baudRate;
+      beginSerial(1, baudRate);
 
       // Delay to stabilize serial communication
       vTaskDelay(pdMS_TO_TICKS(50));
@@ -1096,9 +1312,7 @@ void ModbusRtuService::configureBaudRate(int serialPort, uint32_t baudRate) {
       LOG_RTU_INFO("[RTU] Reconfiguring Serial2 from %d to %d baud\n",
                    currentBaudRate2, baudRate);
       serial2->end();
-      serial2->begin(baudRate, SERIAL_8N1, RTU_RX2, RTU_TX2);
-      serial2->setTimeout(200);  // FIXED: Reset timeout after baudrate change
-      currentBaudRate2 = baudRate;
+      beginSerial(2, baudRate);
 
       // Delay to stabilize serial communication
       vTaskDelay(pdMS_TO_TICKS(50));
@@ -1108,9 +1322,9 @@ void ModbusRtuService::configureBaudRate(int serialPort, uint32_t baudRate) {
   }
 }
 
-void ModbusRtuService::handleReadFailure(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+void ModbusRtuService::handleReadFailure(RtuDeviceConfig& device) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->consecutiveFailures++;
   state->lastReadAttempt = millis();
@@ -1126,17 +1340,17 @@ void ModbusRtuService::handleReadFailure(const char* deviceId) {
     // Max retries exceeded
     LOG_RTU_INFO("[RTU] Device %s exceeded max retries (%d), disabling...\n",
                  deviceId, state->maxRetries);
-    disableDevice(deviceId, DeviceFailureState::AUTO_RETRY,
+    disableDevice(device, ModbusDisableReason::AUTO_RETRY,
                   "Max retries exceeded");
   }
 }
 
-bool ModbusRtuService::shouldRetryDevice(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state || !state->isEnabled) return false;
-  if (state->retryCount == 0) return false;
+bool ModbusRtuService::shouldRetryDevice(const RtuDeviceConfig& device) {
+  const DeviceFailureState& state = device.state.failure;
+  if (!state.isEnabled) return false;
+  if (state.retryCount == 0) return false;
 
-  return millis() >= state->nextRetryTime;
+  return millis() >= state.nextRetryTime;
 }
 
 unsigned long ModbusRtuService::calculateBackoffTime(uint8_t retryCount) {
@@ -1167,9 +1381,9 @@ unsigned long ModbusRtuService::calculateBackoffTime(uint8_t retryCount) {
   return totalBackoff;
 }
 
-void ModbusRtuService::resetDeviceFailureState(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+void ModbusRtuService::resetDeviceFailureState(RtuDeviceConfig& device) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->consecutiveFailures = 0;
   state->retryCount = 0;
@@ -1179,16 +1393,16 @@ void ModbusRtuService::resetDeviceFailureState(const char* deviceId) {
   LOG_RTU_INFO("[RTU] Reset failure state for device %s\n", deviceId);
 }
 
-void ModbusRtuService::handleReadTimeout(const char* deviceId) {
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  if (!timeout) return;
+void ModbusRtuService::handleReadTimeout(RtuDeviceConfig& device) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceReadTimeout* timeout = &device.state.timeout;
 
   timeout->consecutiveTimeouts++;
 
   if (timeout->consecutiveTimeouts >= timeout->maxConsecutiveTimeouts) {
     LOG_RTU_INFO("[RTU] Device %s exceeded timeout limit (%d), disabling...\n",
                  deviceId, timeout->maxConsecutiveTimeouts);
-    disableDevice(deviceId, DeviceFailureState::AUTO_TIMEOUT,
+    disableDevice(device, ModbusDisableReason::AUTO_TIMEOUT,
                   "Max consecutive timeouts exceeded");
   } else {
     LOG_RTU_INFO("[RTU] Device %s timeout %d/%d\n", deviceId,
@@ -1196,66 +1410,57 @@ void ModbusRtuService::handleReadTimeout(const char* deviceId) {
   }
 }
 
-bool ModbusRtuService::isDeviceEnabled(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return true;  // Default to enabled if not found
-  return state->isEnabled;
+bool ModbusRtuService::isDeviceEnabled(const RtuDeviceConfig& device) {
+  return device.state.failure.isEnabled;
 }
 
-void ModbusRtuService::enableDevice(const char* deviceId, bool clearMetrics) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+void ModbusRtuService::enableDevice(RtuDeviceConfig& device,
+                                    bool clearMetrics) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->isEnabled = true;
-  state->disableReason = DeviceFailureState::NONE;  // Clear disable reason
+  state->disableReason = ModbusDisableReason::NONE;  // Clear disable reason
   state->disableReasonDetail = "";
   state->disabledTimestamp = 0;
-  resetDeviceFailureState(deviceId);
+  state->failedProbes = 0;  // v1.3.3
+  resetDeviceFailureState(device);
 
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  if (timeout) {
-    timeout->consecutiveTimeouts = 0;
-    timeout->lastSuccessfulRead = millis();
-  }
+  DeviceReadTimeout& timeout = device.state.timeout;
+  timeout.consecutiveTimeouts = 0;
+  timeout.lastSuccessfulRead = millis();
 
   // Optionally clear health metrics
   if (clearMetrics) {
-    DeviceHealthMetrics* metrics = getDeviceMetrics(deviceId);
-    if (metrics) {
-      metrics->totalReads = 0;
-      metrics->successfulReads = 0;
-      metrics->failedReads = 0;
-      metrics->totalResponseTimeMs = 0;
-      metrics->minResponseTimeMs = 65535;
-      metrics->maxResponseTimeMs = 0;
-      metrics->lastResponseTimeMs = 0;
-      LOG_RTU_INFO("[RTU] Device %s metrics cleared\n", deviceId);
-    }
+    device.state.metrics.reset();
+    device.state.cycle.reset();  // v1.3.3
+    LOG_RTU_INFO("[RTU] Device %s metrics cleared\n", deviceId);
   }
 
   LOG_RTU_INFO("[RTU] Device %s enabled (reason cleared)\n", deviceId);
 }
 
-void ModbusRtuService::disableDevice(const char* deviceId,
-                                     DeviceFailureState::DisableReason reason,
+void ModbusRtuService::disableDevice(RtuDeviceConfig& device,
+                                     ModbusDisableReason reason,
                                      const char* reasonDetail) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->isEnabled = false;
   state->disableReason = reason;
   state->disableReasonDetail = reasonDetail;
   state->disabledTimestamp = millis();
+  state->failedProbes = 0;  // v1.3.3
 
   const char* reasonText = "";
   switch (reason) {
-    case DeviceFailureState::MANUAL:
+    case ModbusDisableReason::MANUAL:
       reasonText = "MANUAL";
       break;
-    case DeviceFailureState::AUTO_RETRY:
+    case ModbusDisableReason::AUTO_RETRY:
       reasonText = "AUTO_RETRY";
       break;
-    case DeviceFailureState::AUTO_TIMEOUT:
+    case ModbusDisableReason::AUTO_TIMEOUT:
       reasonText = "AUTO_TIMEOUT";
       break;
     default:
@@ -1274,38 +1479,27 @@ void ModbusRtuService::disableDevice(const char* deviceId,
 // device-level polling interval
 
 // Level 1: Device-level timing methods
-ModbusRtuService::DeviceTimer* ModbusRtuService::getDeviceTimer(
-    const char* deviceId) {
-  for (auto& timer : deviceTimers) {
-    if (timer.deviceId == deviceId) {
-      return &timer;
+// v1.3.3: Deadline-based (PollScheduler). The next poll is one refresh
+// interval after the previous deadline, so the rate does not drift with read
+// duration. A device skipped for retry backoff is due again when its backoff
+// ends. The interval is stretched under memory pressure (MemoryRecovery
+// backpressure), so fewer values enter the queue while memory is short.
+// Aligned acquisition moves the deadline to the next cycle boundary.
+uint32_t ModbusRtuService::nextPollDeadline(RtuDeviceConfig& device,
+                                            const PollSlot& slot, bool polled,
+                                            uint32_t nowMs) {
+  uint32_t next = PollScheduler::nextDeadline(
+      slot.dueMs,
+      MemoryRecovery::applyBackpressure(device.plan.pollIntervalMs()), nowMs);
+  if (!polled) {
+    const DeviceFailureState& state = device.state.failure;
+    if (state.isEnabled && state.retryCount > 0 &&
+        !PollScheduler::isDue(state.nextRetryTime, nowMs)) {
+      next = state.nextRetryTime;
     }
   }
-  return nullptr;
-}
-
-bool ModbusRtuService::shouldPollDevice(const char* deviceId,
-                                        uint32_t refreshRateMs) {
-  DeviceTimer* timer = getDeviceTimer(deviceId);
-  if (!timer) {
-    // First time polling this device, create entry
-    DeviceTimer newTimer;
-    newTimer.deviceId = deviceId;
-    newTimer.lastRead = 0;
-    newTimer.refreshRateMs = refreshRateMs;
-    deviceTimers.push_back(newTimer);
-    return true;  // Always poll on first encounter
-  }
-
-  unsigned long now = millis();
-  return (now - timer->lastRead) >= timer->refreshRateMs;
-}
-
-void ModbusRtuService::updateDeviceLastRead(const char* deviceId) {
-  DeviceTimer* timer = getDeviceTimer(deviceId);
-  if (timer) {
-    timer->lastRead = millis();
-  }
+  return AcquisitionCycle::getInstance()->align(device.plan.registrySlot, next,
+                                                nowMs);
 }
 
 // Level 3: Server data transmission interval methods
@@ -1332,13 +1526,13 @@ bool ModbusRtuService::enableDeviceByCommand(const char* deviceId,
   LOG_RTU_INFO("[RTU] BLE Command: Enable device %s (clearMetrics: %s)\n",
                deviceId, clearMetrics ? "true" : "false");
 
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  RtuDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_RTU_INFO("[RTU] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  enableDevice(deviceId, clearMetrics);
+  enableDevice(*device, clearMetrics);
   return true;
 }
 
@@ -1347,26 +1541,28 @@ bool ModbusRtuService::disableDeviceByCommand(const char* deviceId,
   LOG_RTU_INFO("[RTU] BLE Command: Disable device %s (reason: %s)\n", deviceId,
                reasonDetail);
 
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  RtuDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_RTU_INFO("[RTU] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  disableDevice(deviceId, DeviceFailureState::MANUAL, reasonDetail);
+  disableDevice(*device, ModbusDisableReason::MANUAL, reasonDetail);
   return true;
 }
 
 bool ModbusRtuService::getDeviceStatusInfo(const char* deviceId,
-                                           JsonObject& statusInfo) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+                                           JsonObject& statusInfo,
+                                           bool includeHistogram) {
+  RtuDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_RTU_INFO("[RTU] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  DeviceHealthMetrics* metrics = getDeviceMetrics(deviceId);
+  const DeviceFailureState* state = &device->state.failure;
+  const DeviceReadTimeout* timeout = &device->state.timeout;
+  const DeviceHealthMetrics* metrics = &device->state.metrics;
 
   // Basic status
   statusInfo["device_id"] = deviceId;
@@ -1377,16 +1573,16 @@ bool ModbusRtuService::getDeviceStatusInfo(const char* deviceId,
   // Disable reason
   const char* reasonText = "";
   switch (state->disableReason) {
-    case DeviceFailureState::NONE:
+    case ModbusDisableReason::NONE:
       reasonText = "NONE";
       break;
-    case DeviceFailureState::MANUAL:
+    case ModbusDisableReason::MANUAL:
       reasonText = "MANUAL";
       break;
-    case DeviceFailureState::AUTO_RETRY:
+    case ModbusDisableReason::AUTO_RETRY:
       reasonText = "AUTO_RETRY";
       break;
-    case DeviceFailureState::AUTO_TIMEOUT:
+    case ModbusDisableReason::AUTO_TIMEOUT:
       reasonText = "AUTO_TIMEOUT";
       break;
   }
@@ -1397,26 +1593,34 @@ bool ModbusRtuService::getDeviceStatusInfo(const char* deviceId,
     unsigned long disabledDuration = millis() - state->disabledTimestamp;
     statusInfo["disabled_duration_ms"] = disabledDuration;
   }
+  statusInfo["failed_probes"] = state->failedProbes;  // v1.3.3
 
   // Timeout info
-  if (timeout) {
-    statusInfo["timeout_ms"] = timeout->timeoutMs;
-    statusInfo["consecutive_timeouts"] = timeout->consecutiveTimeouts;
-    statusInfo["max_consecutive_timeouts"] = timeout->maxConsecutiveTimeouts;
-  }
+  statusInfo["timeout_ms"] = timeout->timeoutMs;
+  statusInfo["consecutive_timeouts"] = timeout->consecutiveTimeouts;
+  statusInfo["max_consecutive_timeouts"] = timeout->maxConsecutiveTimeouts;
 
   // Health metrics
-  if (metrics) {
-    JsonObject metricsObj = statusInfo["metrics"].to<JsonObject>();
-    metricsObj["total_reads"] = metrics->totalReads;
-    metricsObj["successful_reads"] = metrics->successfulReads;
-    metricsObj["failed_reads"] = metrics->failedReads;
-    metricsObj["success_rate"] = metrics->getSuccessRate();
-    metricsObj["avg_response_time_ms"] = metrics->getAvgResponseTimeMs();
-    metricsObj["min_response_time_ms"] = metrics->minResponseTimeMs;
-    metricsObj["max_response_time_ms"] = metrics->maxResponseTimeMs;
-    metricsObj["last_response_time_ms"] = metrics->lastResponseTimeMs;
-  }
+  JsonObject metricsObj = statusInfo["metrics"].to<JsonObject>();
+  metricsObj["total_reads"] = metrics->totalReads;
+  metricsObj["successful_reads"] = metrics->successfulReads;
+  metricsObj["failed_reads"] = metrics->failedReads;
+  metricsObj["success_rate"] = metrics->getSuccessRate();
+  metricsObj["avg_response_time_ms"] = metrics->getAvgResponseTimeMs();
+  metricsObj["min_response_time_ms"] = metrics->minResponseTimeMs;
+  metricsObj["max_response_time_ms"] = metrics->maxResponseTimeMs;
+  metricsObj["last_response_time_ms"] = metrics->lastResponseTimeMs;
+  metrics->latency.writeStatus(metricsObj, includeHistogram);  // v1.3.3
+
+  // v1.3.3: Interval in use ("adaptive_refresh")
+  statusInfo["refresh_rate_ms"] = device->plan.pollIntervalMs();
+  if (device->plan.adaptive.enabled) {
+    statusInfo["change_rate_percent"] = device->plan.adaptive.changePercent;
+  }
+
+  // v1.3.3: Poll cycle duration vs refresh interval
+  JsonObject cycleObj = statusInfo["cycle"].to<JsonObject>();
+  device->state.cycle.writeStatus(cycleObj, device->plan.pollIntervalMs());
 
   return true;
 }
@@ -1424,15 +1628,52 @@ bool ModbusRtuService::getDeviceStatusInfo(const char* deviceId,
 bool ModbusRtuService::getAllDevicesStatus(JsonObject& allStatus) {
   JsonArray devicesArray = allStatus["devices"].to<JsonArray>();
 
+  // v1.3.3: Capacity per bus - summed device demand and deadline misses
+  uint32_t demand[RTU_BUS_COUNT] = {};
+  uint32_t missed[RTU_BUS_COUNT] = {};
+  uint32_t overruns[RTU_BUS_COUNT] = {};
+  uint16_t devices[RTU_BUS_COUNT] = {};
   for (const auto& device : rtuDevices) {
     JsonObject deviceStatus = devicesArray.add<JsonObject>();
-    getDeviceStatusInfo(device.deviceId.c_str(), deviceStatus);
+    getDeviceStatusInfo(device.deviceId.c_str(), deviceStatus, false);
+
+    int bus = device.plan.serialPort - 1;
+    if (bus < 0 || bus >= RTU_BUS_COUNT) continue;
+    const ModbusCycleMetrics& cycle = device.state.cycle;
+    devices[bus]++;
+    demand[bus] += cycle.demandPercent(device.plan.pollIntervalMs());
+    missed[bus] += cycle.missedDeadlines;
+    overruns[bus] += cycle.overruns;
   }
 
   allStatus["total_devices"] = rtuDevices.size();
+  // v1.3.3: Buckets per bus (device entries carry the percentiles only)
+  JsonObject buses = allStatus["buses"].to<JsonObject>();
+  getBusLatencyStatus(buses, true);
+  static const char* const BUS_NAMES[RTU_BUS_COUNT] = {"rtu_bus1",
+                                                       "rtu_bus2"};
+  for (uint8_t i = 0; i < RTU_BUS_COUNT; i++) {
+    JsonObject bus = buses[BUS_NAMES[i]];
+    bus["devices"] = devices[i];
+    bus["demand_percent"] = demand[i];
+    bus["missed_deadlines"] = missed[i];
+    bus["overruns"] = overruns[i];
+  }
   return true;
 }
 
+void ModbusRtuService::getBusLatencyStatus(JsonObject& buses,
+                                           bool includeHistogram) {
+  static const char* const BUS_NAMES[RTU_BUS_COUNT] = {"rtu_bus1",
+                                                       "rtu_bus2"};
+  for (uint8_t i = 0; i < RTU_BUS_COUNT; i++) {
+    JsonObject bus = buses[BUS_NAMES[i]].to<JsonObject>();
+    busWorkers[i].latency.writeStatus(bus, includeHistogram);
+    bus["utilization_percent"] =
+        busWorkers[i].utilization.percent;  // v1.3.3: Last 10 s window
+  }
+}
+
 // ============================================
 // NEW: Enhancement - Auto-Recovery Task
 // ============================================
@@ -1462,28 +1703,58 @@ void ModbusRtuService::autoRecoveryLoop() {
     }
 
     LOG_RTU_INFO("[RTU AutoRecovery] Checking for auto-disabled devices...");
-    unsigned long now = millis();
-
-    // FIXED ISSUE #1: Protect vector access with mutex
-    xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
 
-    for (auto& state : deviceFailureStates) {
-      if (!state.isEnabled &&
-          (state.disableReason == DeviceFailureState::AUTO_RETRY ||
-           state.disableReason == DeviceFailureState::AUTO_TIMEOUT)) {
-        unsigned long disabledDuration = now - state.disabledTimestamp;
-        LOG_RTU_INFO(
-            "[RTU AutoRecovery] Device %s auto-disabled for %lu ms, attempting "
-            "recovery...\n",
-            state.deviceId.c_str(), disabledDuration);
+    // v1.3.3: Probe first, re-enable only a device that answers. The probe
+    // runs on the bus without vectorMutex (lock order), so the device is
+    // looked up again afterwards (the list may have been rebuilt).
+    for (size_t i = 0; running; i++) {
+      xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+      if (i >= rtuDevices.size()) {
+        xSemaphoreGiveRecursive(vectorMutex);
+        break;
+      }
+      RtuDeviceConfig& device = rtuDevices[i];
+      if (!device.state.failure.autoDisabled()) {
+        xSemaphoreGiveRecursive(vectorMutex);
+        continue;
+      }
+      InternedString deviceId = device.deviceId;
+      unsigned long disabledDuration =
+          millis() - device.state.failure.disabledTimestamp;
+      BusWorker* worker = getBusWorker(device.plan.serialPort);
+      RtuWriteRequest probe;
+      bool probed = worker && prepareProbe(device, probe);
+      xSemaphoreGiveRecursive(vectorMutex);
 
-        enableDevice(state.deviceId.c_str(), false);  // Don't clear metrics
-        LOG_RTU_INFO("[RTU AutoRecovery] Device %s re-enabled\n",
-                     state.deviceId.c_str());
+      LOG_RTU_INFO(
+          "[RTU AutoRecovery] Device %s auto-disabled for %lu ms, probing...\n",
+          deviceId.c_str(), disabledDuration);
+      // Any reply (data or exception) means the slave is back
+      bool answered =
+          !probed ||
+          (submitWrite(*worker, probe) &&
+           (probe.result == RtuMaster::ku8MBSuccess ||
+            (probe.result >= RtuMaster::ku8MBIllegalFunction &&
+             probe.result <= RtuMaster::ku8MBSlaveDeviceFailure)));
+
+      xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+      RtuDeviceConfig* current = findDevice(deviceId.c_str());
+      if (current && current->state.failure.autoDisabled()) {
+        if (answered) {
+          enableDevice(*current, false);  // Don't clear metrics
+          LOG_RTU_INFO("[RTU AutoRecovery] Device %s re-enabled\n",
+                       deviceId.c_str());
+        } else {
+          DeviceFailureState& state = current->state.failure;
+          if (state.failedProbes < UINT16_MAX) state.failedProbes++;
+          LOG_RTU_INFO(
+              "[RTU AutoRecovery] Device %s still not answering (probe "
+              "result 0x%02X, %u failed)\n",
+              deviceId.c_str(), probe.result, state.failedProbes);
+        }
       }
+      xSemaphoreGiveRecursive(vectorMutex);
     }
-
-    xSemaphoreGiveRecursive(vectorMutex);
   }
 
   // CRITICAL FIX: Task must self-delete when loop exits to prevent FreeRTOS
@@ -1493,6 +1764,24 @@ void ModbusRtuService::autoRecoveryLoop() {
   vTaskDelete(NULL);                 // Delete self (NULL = current task)
 }
 
+// v1.3.3: Busiest bus and deadline misses for the ProductionLogger heartbeat
+void ModbusRtuService::getCapacitySummary(uint8_t& peakUtilization,
+                                          uint32_t& missedDeadlines) {
+  peakUtilization = 0;
+  missedDeadlines = 0;
+  for (uint8_t i = 0; i < RTU_BUS_COUNT; i++) {
+    peakUtilization =
+        std::max(peakUtilization, busWorkers[i].utilization.percent);
+  }
+
+  if (xSemaphoreTakeRecursive(vectorMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    for (const auto& device : rtuDevices) {
+      missedDeadlines += device.state.cycle.missedDeadlines;
+    }
+    xSemaphoreGiveRecursive(vectorMutex);
+  }
+}
+
 // v2.5.35: Get aggregated Modbus stats for ProductionLogger
 void ModbusRtuService::getAggregatedStats(uint32_t& totalSuccess,
                                           uint32_t& totalFailed) {
@@ -1500,9 +1789,9 @@ void ModbusRtuService::getAggregatedStats(uint32_t& totalSuccess,
   totalFailed = 0;
 
   if (xSemaphoreTake(vectorMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    for (const auto& metrics : deviceMetrics) {
-      totalSuccess += metrics.successfulReads;
-      totalFailed += metrics.failedReads;
+    for (const auto& device : rtuDevices) {
+      totalSuccess += device.state.metrics.successfulReads;
+      totalFailed += device.state.metrics.failedReads;
     }
     xSemaphoreGive(vectorMutex);
   }
@@ -1519,35 +1808,214 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
                deviceId, registerId, value);
 
   // 1. Find device and register configuration
-  if (xSemaphoreTake(vectorMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+  if (xSemaphoreTakeRecursive(vectorMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
     response["status"] = "error";
     response["error"] = "Failed to acquire mutex for write operation";
     response["error_code"] = 315;  // ERR_MODBUS_WRITE_MUTEX_TIMEOUT
     return false;
   }
 
-  // Find the device
-  JsonObject deviceConfig;
-  JsonObject registerConfig;
-  bool found = false;
+  RtuDeviceConfig* device = findDevice(deviceId);  // v1.3.3: Hashed lookup
+  RtuWriteItem item;
+  if (!device || !resolveWrite(*device, registerId, value, item, response)) {
+    xSemaphoreGiveRecursive(vectorMutex);
+    if (!device) {
+      response["status"] = "error";
+      response["error"] = "Device or register not found";
+      response["error_code"] = 316;  // ERR_MODBUS_WRITE_DEVICE_NOT_FOUND
+    }
+    return false;
+  }
+
+  RtuWriteRequest request = {};
+  int serialPort = prepareWriteRequest(*device, request);
+  xSemaphoreGiveRecursive(vectorMutex);
+
+  // Get bus worker (v1.3.3: the write is executed on its lane)
+  BusWorker* worker = getBusWorker(serialPort);
+  if (!worker) {
+    response["status"] = "error";
+    response["error"] = "Invalid serial port configuration";
+    response["error_code"] = 321;  // ERR_MODBUS_WRITE_CONNECTION_FAILED
+    return false;
+  }
+
+  request.functionCode = item.functionCode;
+  request.address = item.address;
+  request.count = item.count;
+  memcpy(request.values, item.words, sizeof(item.words));
+
+  // Perform write (v1.3.3: on the bus's priority write lane, ahead of the
+  // polling task's next transaction)
+  if (!submitWrite(*worker, request)) {
+    response["status"] = "error";
+    response["error"] = "RS485 bus busy";
+    response["error_code"] = 321;  // ERR_MODBUS_WRITE_CONNECTION_FAILED
+    return false;
+  }
+
+  return reportWriteResult(response, deviceId, registerId, value,
+                           item.rawValue, request.result,
+                           request.responseTimeMs);
+}
 
-  for (auto& device : rtuDevices) {
-    if (strcmp(device.deviceId.c_str(), deviceId) == 0) {
-      deviceConfig = device.doc->as<JsonObject>();
-      JsonArray registers = deviceConfig["registers"];
-      for (JsonVariant reg : registers) {
-        if (strcmp(reg["register_id"].as<const char*>(), registerId) == 0) {
-          registerConfig = reg.as<JsonObject>();
-          found = true;
-          break;
+size_t ModbusRtuService::writeRegisterValues(const char* deviceId,
+                                             const char* const* registerIds,
+                                             const double* values,
+                                             JsonObject* results,
+                                             size_t count) {
+  LOG_RTU_INFO("[RTU_WRITE] Batch write to device %s, %u registers\n",
+               deviceId, (unsigned)count);
+
+  if (xSemaphoreTakeRecursive(vectorMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    for (size_t i = 0; i < count; i++) {
+      results[i]["status"] = "error";
+      results[i]["error"] = "Failed to acquire mutex for write operation";
+      results[i]["error_code"] = 315;  // ERR_MODBUS_WRITE_MUTEX_TIMEOUT
+    }
+    return 0;
+  }
+
+  RtuDeviceConfig* device = findDevice(deviceId);
+  std::vector<RtuWriteItem> items;
+  items.reserve(count);
+  RtuWriteRequest request = {};
+  int serialPort = 0;
+  for (size_t i = 0; i < count; i++) {
+    RtuWriteItem item;
+    if (!device) {
+      results[i]["status"] = "error";
+      results[i]["error"] = "Device or register not found";
+      results[i]["error_code"] = 316;  // ERR_MODBUS_WRITE_DEVICE_NOT_FOUND
+    } else if (resolveWrite(*device, registerIds[i], values[i], item,
+                            results[i])) {
+      item.index = i;
+      items.push_back(item);
+    }
+  }
+  if (device) {
+    serialPort = prepareWriteRequest(*device, request);
+  }
+  xSemaphoreGiveRecursive(vectorMutex);
+
+  BusWorker* worker = getBusWorker(serialPort);
+  if (!items.empty() && !worker) {
+    for (const RtuWriteItem& item : items) {
+      results[item.index]["status"] = "error";
+      results[item.index]["error"] = "Invalid serial port configuration";
+      results[item.index]["error_code"] = 321;
+    }
+    return 0;
+  }
+
+  // Coils first, then holding registers, each by address: neighbours in
+  // this order are the contiguous runs
+  std::sort(items.begin(), items.end(),
+            [](const RtuWriteItem& a, const RtuWriteItem& b) {
+              bool aCoil = a.functionCode == 5;
+              bool bCoil = b.functionCode == 5;
+              if (aCoil != bCoil) return aCoil;
+              return a.address < b.address;
+            });
+
+  size_t successCount = 0;
+  for (size_t start = 0; start < items.size();) {
+    // Extend the run while the next item starts where the run ends
+    bool coils = items[start].functionCode == 5;
+    uint16_t length = items[start].count;
+    size_t end = start + 1;
+    while (end < items.size() && (items[end].functionCode == 5) == coils &&
+           items[end].address == items[start].address + length &&
+           length + items[end].count <= RTU_WRITE_MAX_WORDS) {
+      length += items[end].count;
+      end++;
+    }
+
+    bool batched = end - start > 1;
+    if (batched) {
+      // FC15 coil bits are packed LSB first, 16 per transmit word
+      request.functionCode = coils ? 15 : 16;
+      request.address = items[start].address;
+      request.count = length;
+      memset(request.values, 0, sizeof(request.values));
+      uint16_t word = 0;
+      for (size_t i = start; i < end; i++) {
+        const RtuWriteItem& item = items[i];
+        if (coils) {
+          if (item.words[0]) {
+            request.values[word / 16] |= 1u << (word % 16);
+          }
+          word++;
+        } else {
+          memcpy(request.values + word, item.words,
+                 item.count * sizeof(uint16_t));
+          word += item.count;
         }
       }
+      LOG_RTU_INFO("[RTU_WRITE] FC%d batch addr=%d, count=%d (%u values)\n",
+                   request.functionCode, request.address, length,
+                   (unsigned)(end - start));
+    }
+
+    // A slave without FC15/FC16 support gets the values one by one
+    bool sent = batched && submitWrite(*worker, request);
+    if (batched && (!sent || request.result != RtuMaster::ku8MBIllegalFunction)) {
+      for (size_t i = start; i < end; i++) {
+        const RtuWriteItem& item = items[i];
+        if (!sent) {
+          results[item.index]["status"] = "error";
+          results[item.index]["error"] = "RS485 bus busy";
+          results[item.index]["error_code"] = 321;
+        } else if (reportWriteResult(results[item.index], deviceId,
+                                     registerIds[item.index],
+                                     values[item.index], item.rawValue,
+                                     request.result,
+                                     request.responseTimeMs)) {
+          successCount++;
+        }
+      }
+      start = end;
+      continue;
+    }
+
+    for (size_t i = start; i < end; i++) {
+      const RtuWriteItem& item = items[i];
+      request.functionCode = item.functionCode;
+      request.address = item.address;
+      request.count = item.count;
+      memcpy(request.values, item.words, sizeof(item.words));
+      if (!submitWrite(*worker, request)) {
+        results[item.index]["status"] = "error";
+        results[item.index]["error"] = "RS485 bus busy";
+        results[item.index]["error_code"] = 321;
+      } else if (reportWriteResult(results[item.index], deviceId,
+                                   registerIds[item.index], values[item.index],
+                                   item.rawValue, request.result,
+                                   request.responseTimeMs)) {
+        successCount++;
+      }
+    }
+    start = end;
+  }
+  return successCount;
+}
+
+bool ModbusRtuService::resolveWrite(RtuDeviceConfig& device,
+                                    const char* registerId, double value,
+                                    RtuWriteItem& item, JsonObject& response) {
+  // Find the register
+  JsonObject registerConfig;
+  bool found = false;
+  JsonArray registers = (*device.doc)["registers"];
+  for (JsonVariant reg : registers) {
+    if (strcmp(reg["register_id"] | "", registerId) == 0) {
+      registerConfig = reg.as<JsonObject>();
+      found = true;
       break;
     }
   }
 
   if (!found) {
-    xSemaphoreGive(vectorMutex);
     response["status"] = "error";
     response["error"] = "Device or register not found";
     response["error_code"] = 316;  // ERR_MODBUS_WRITE_DEVICE_NOT_FOUND
@@ -1557,7 +2025,6 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
   // 2. Check if register is writable
   uint8_t readFC = registerConfig["function_code"] | 3;
   if (!ModbusUtils::isWritableType(readFC)) {
-    xSemaphoreGive(vectorMutex);
     response["status"] = "error";
     response["error"] = "Register is read-only (FC2 or FC4)";
     response["error_code"] = 317;  // ERR_MODBUS_WRITE_READONLY
@@ -1567,7 +2034,6 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
   // 3. Check writable flag if present
   bool writable = registerConfig["writable"] | true;  // Default true for backward compat
   if (!writable) {
-    xSemaphoreGive(vectorMutex);
     response["status"] = "error";
     response["error"] = "Register marked as not writable";
     response["error_code"] = 318;  // ERR_MODBUS_WRITE_NOT_WRITABLE
@@ -1578,7 +2044,6 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
   if (!registerConfig["min_value"].isNull()) {
     double minVal = registerConfig["min_value"].as<double>();
     if (value < minVal) {
-      xSemaphoreGive(vectorMutex);
       response["status"] = "error";
       response["error"] = "Value below minimum";
       response["error_code"] = 319;  // ERR_MODBUS_WRITE_VALUE_BELOW_MIN
@@ -1590,7 +2055,6 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
   if (!registerConfig["max_value"].isNull()) {
     double maxVal = registerConfig["max_value"].as<double>();
     if (value > maxVal) {
-      xSemaphoreGive(vectorMutex);
       response["status"] = "error";
       response["error"] = "Value above maximum";
       response["error_code"] = 320;  // ERR_MODBUS_WRITE_VALUE_ABOVE_MAX
@@ -1600,10 +2064,7 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
     }
   }
 
-  // 5. Get device parameters
-  uint8_t slaveId = deviceConfig["slave_id"] | 1;
-  int serialPort = deviceConfig["serial_port"] | 1;
-  uint16_t baudRate = deviceConfig["baud_rate"] | 9600;
+  // 5. Get register parameters
   uint16_t address = registerConfig["address"] | 0;
   const char* dataType = registerConfig["data_type"] | "UINT16";
   float scale = registerConfig["scale"] | 1.0f;
@@ -1617,45 +2078,29 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
     endianness[sizeof(endianness) - 1] = '\0';
   }
 
-  xSemaphoreGive(vectorMutex);
-
   // 6. Reverse calibration
   double rawValue = ModbusUtils::reverseCalibration(value, scale, offset);
   LOG_RTU_INFO("[RTU_WRITE] Reverse calibration: %.4f -> %.4f (scale=%.4f, offset=%.4f)\n",
                value, rawValue, scale, offset);
 
-  // 7. Configure baudrate
-  configureBaudRate(serialPort, baudRate);
-
-  // 8. Get Modbus instance
-  ModbusMaster* modbus = getModbusForBus(serialPort);
-  if (!modbus) {
-    response["status"] = "error";
-    response["error"] = "Invalid serial port configuration";
-    response["error_code"] = 321;  // ERR_MODBUS_WRITE_CONNECTION_FAILED
-    return false;
-  }
-
-  // 9. Set slave ID
-  modbus->begin(slaveId, serialPort == 1 ? *serial1 : *serial2);
-
-  // 10. Determine write function code and perform write
+  // 7. Determine write function code and raw register words
   uint8_t writeFC = ModbusUtils::getWriteFunctionCode(readFC, dataType);
-  int regCount = ModbusUtils::getRegisterCount(dataType);
-
-  unsigned long startTime = millis();
-  uint8_t result = 0;
+  item.functionCode = writeFC;
+  item.address = address;
+  item.rawValue = rawValue;
+  item.count = 1;
+  memset(item.words, 0, sizeof(item.words));
 
   if (writeFC == 5) {
     // FC5: Write Single Coil
     uint16_t coilValue = (rawValue != 0) ? 0xFF00 : 0x0000;
-    result = modbus->writeSingleCoil(address, coilValue);
+    item.words[0] = coilValue;
     LOG_RTU_INFO("[RTU_WRITE] FC5 writeSingleCoil addr=%d, value=0x%04X\n",
                  address, coilValue);
   } else if (writeFC == 6) {
     // FC6: Write Single Register
     uint16_t regValue = ModbusUtils::convertToSingleRegister(rawValue, dataType);
-    result = modbus->writeSingleRegister(address, regValue);
+    item.words[0] = regValue;
     LOG_RTU_INFO("[RTU_WRITE] FC6 writeSingleRegister addr=%d, value=%d (0x%04X)\n",
                  address, regValue, regValue);
   } else if (writeFC == 15) {
@@ -1666,15 +2111,10 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
     return false;
   } else if (writeFC == 16) {
     // FC16: Write Multiple Registers
-    uint16_t values[4];
     int count = 0;
-    ModbusUtils::convertToMultiRegister(rawValue, dataType, endianness, values, count);
-
-    // Load values into transmit buffer
-    for (int i = 0; i < count; i++) {
-      modbus->setTransmitBuffer(i, values[i]);
-    }
-    result = modbus->writeMultipleRegisters(address, count);
+    ModbusUtils::convertToMultiRegister(rawValue, dataType, endianness,
+                                        item.words, count);
+    item.count = (uint8_t)count;
     LOG_RTU_INFO("[RTU_WRITE] FC16 writeMultipleRegisters addr=%d, count=%d\n",
                  address, count);
   } else {
@@ -1683,11 +2123,29 @@ bool ModbusRtuService::writeRegisterValue(const char* deviceId,
     response["error_code"] = 322;  // ERR_MODBUS_WRITE_INVALID_FC
     return false;
   }
+  return true;
+}
 
-  unsigned long responseTime = millis() - startTime;
+int ModbusRtuService::prepareWriteRequest(const RtuDeviceConfig& device,
+                                          RtuWriteRequest& request) const {
+  JsonObjectConst deviceConfig = device.doc->as<JsonObjectConst>();
+  request.slaveId = deviceConfig["slave_id"] | 1;
+  request.baudRate = deviceConfig["baud_rate"] | 9600;
+
+  // v1.3.3: Bus timing. Writes use the configured timeout (not auto-tuned,
+  // slaves may take longer to commit a write than to answer a read)
+  request.timeoutMs = device.plan.responseTimeoutMs;
+  request.interFrameUs = interFrameFor(device);
+  return deviceConfig["serial_port"] | 1;
+}
 
-  // 11. Check result
-  if (result == modbus->ku8MBSuccess) {
+bool ModbusRtuService::reportWriteResult(JsonObject& response,
+                                         const char* deviceId,
+                                         const char* registerId, double value,
+                                         double rawValue, uint8_t result,
+                                         unsigned long responseTime) {
+  // 8. Check result
+  if (result == RtuMaster::ku8MBSuccess) {
     response["status"] = "ok";
     response["device_id"] = deviceId;
     response["register_id"] = registerId;
@@ -1752,17 +2210,8 @@ ModbusRtuService::~ModbusRtuService() {
   stop();
 
   // FIXED Bug #7: Delete in REVERSE order to prevent use-after-free
-  // ModbusMaster objects hold references to HardwareSerial objects
-  // Must delete modbus objects BEFORE deleting serial objects
-
-  if (modbus1) {
-    delete modbus1;
-    modbus1 = nullptr;
-  }
-  if (modbus2) {
-    delete modbus2;
-    modbus2 = nullptr;
-  }
+  // v1.3.3: The bus workers' RtuMaster objects only keep a pointer to their
+  // UART (unused after stop()); deleting a UART ends its event task
   if (serial1) {
     delete serial1;
     serial1 = nullptr;
@@ -1777,6 +2226,20 @@ ModbusRtuService::~ModbusRtuService() {
     vSemaphoreDelete(vectorMutex);
     vectorMutex = nullptr;
   }
+  for (int i = 0; i < RTU_BUS_COUNT; i++) {
+    if (busWorkers[i].pollMutex) {
+      vSemaphoreDelete(busWorkers[i].pollMutex);
+      busWorkers[i].pollMutex = nullptr;
+    }
+    if (busWorkers[i].busMutex) {
+      vSemaphoreDelete(busWorkers[i].busMutex);
+      busWorkers[i].busMutex = nullptr;
+    }
+    if (busWorkers[i].writeLane) {
+      vQueueDelete(busWorkers[i].writeLane);
+      busWorkers[i].writeLane = nullptr;
+    }
+  }
 
   LOG_RTU_INFO("[RTU] Service destroyed, resources cleaned up");
 }
@@ -3,8 +3,9 @@
 
 #include <ArduinoJson.h>
 #include <HardwareSerial.h>
-#include <ModbusMaster.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 
 #include <atomic>  // v2.5.39: For configChangePending flag
@@ -14,19 +15,104 @@
 
 #include "ConfigManager.h"
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include "ModbusDeviceTypes.h"  // v1.3.3: Shared per-device state record
+#include "ModbusPollPlan.h"     // v1.3.3: Compiled per-device register plan
 #include "ModbusUtils.h"        // Shared Modbus data parsing utilities
+#include "PollScheduler.h"      // v1.3.3: Deadline-ordered device schedule
+#include "RtuMaster.h"          // v1.3.3: Event-driven RTU master
+#include "StringIntern.h"       // v1.3.3: Interned device IDs
 #include "PSRAMString.h"  // BUG #31: Replace Arduino String with PSRAM-based String
 
 class ModbusRtuService {
  private:
   ConfigManager* configManager;
   bool running;
-  TaskHandle_t rtuTaskHandle;
+
+  // v1.3.3: Per-bus polling workers (one pinned task per serial_port)
+  // Previous: One MODBUS_RTU_TASK walked every device of both buses in turn,
+  // so a slow or timing-out device on bus 1 stalled all devices on bus 2.
+  // New: Each RS485 bus has its own worker that only polls devices with its
+  // serial_port. Bus transactions run without vectorMutex (bus lock only), so
+  // the two UARTs poll in parallel. Device timers, failure/timeout state and
+  // metrics stay per device (shared vectors, vectorMutex).
+  // Lock order: pollMutex -> vectorMutex, pollMutex -> busMutex (vectorMutex
+  // and busMutex are never held together).
+  static const int RTU_BUS_COUNT = 2;
+
+  // v1.3.3: Priority write lane
+  // Previous: writeRegisterValue() competed with the bus worker for
+  // busMutex, so a write could wait behind a whole poll pass (50 registers,
+  // multi-second timeouts) - mutex hand-off is not fair.
+  // New: writes are queued on their bus's lane and executed by the bus
+  // worker before its next transaction (and while it idles or pauses for
+  // BLE), so a write waits for at most the transaction in flight. The
+  // request lives on the caller's stack until the worker gives done.
+  static const uint8_t RTU_WRITE_LANE_DEPTH = 4;
+  // Notification bit set by submitWrite() (config changes increment the
+  // notification count, see notifyConfigChange())
+  static const uint32_t RTU_WRITE_LANE_NOTIFY = 0x80000000UL;
+  // v1.3.3: Batched writes (FC15/FC16) up to RtuMaster::MAX_WORDS (64
+  // words; coils count one each)
+  static const uint8_t RTU_WRITE_MAX_WORDS = 64;
+  struct RtuWriteRequest {
+    uint8_t slaveId;
+    uint32_t baudRate;
+    uint32_t interFrameUs;
+    uint32_t timeoutMs;
+    uint8_t functionCode;  // 5, 6, 15 or 16 (1-4: recovery probe, one item)
+    uint16_t address;
+    // FC5: values[0] = coil value (0xFF00 / 0x0000); FC15: coil bits
+    uint16_t values[RTU_WRITE_MAX_WORDS];
+    uint8_t count;  // Registers (FC16) or coils (FC15)
+    uint8_t result;  // Modbus result code (RtuMaster::ku8MB*)
+    unsigned long responseTimeMs;
+    SemaphoreHandle_t done;
+    StaticSemaphore_t doneBuffer;
+  };
+
+  // v1.3.3: One validated register write (raw words), before batching
+  struct RtuWriteItem {
+    size_t index;          // Position in the caller's register list
+    uint8_t functionCode;  // 5, 6 or 16 (single write)
+    uint16_t address;
+    uint16_t words[4];  // FC5: words[0] = coil value
+    uint8_t count;      // Registers (1 for coils)
+    double rawValue;
+  };
+
+  static constexpr size_t RTU_POLL_ARENA_SIZE =
+      16384;  // v1.3.3: Polled-data JSON of one device (PSRAM)
+
+  struct BusWorker {
+    ModbusRtuService* service;
+    int serialPort;  // 1 or 2
+    TaskHandle_t taskHandle;
+    SemaphoreHandle_t pollMutex;  // Held for one pass over the bus devices
+                                  // (refreshDeviceList waits for it)
+    SemaphoreHandle_t busMutex;   // Serial + RtuMaster + baud cache
+    PollScheduler schedule;  // v1.3.3: This bus's devices by next deadline
+                             // (rebuilt by refreshDeviceList under pollMutex)
+    RtuMaster master;        // v1.3.3: RTU master (under busMutex)
+    QueueHandle_t writeLane;  // v1.3.3: RtuWriteRequest* (bus worker runs)
+    // v1.3.3: Documents of one device poll (reset per poll)
+    ArduinoJson::ArenaAllocator pollArena{RTU_POLL_ARENA_SIZE};
+    ModbusLatencyHistogram latency;  // v1.3.3: Successful reads on this bus
+    BusUtilization utilization;  // v1.3.3: Busy share ("adaptive_refresh")
+  };
+  BusWorker busWorkers[RTU_BUS_COUNT];
+
+  // v1.3.3: Set while refreshDeviceList() waits for the workers' passes
+  std::atomic<bool> refreshRequested{false};
 
   // v2.5.39: Atomic flag for reliable config change detection
   // Consistent with ModbusTcpService implementation
   std::atomic<bool> configChangePending{false};
 
+  // v1.3.3: Devices changed since the last refresh (see ModbusChangeSet;
+  // touched by the CRUD task, guarded by changeMux)
+  ModbusChangeSet pendingChanges;
+  portMUX_TYPE changeMux = portMUX_INITIALIZER_UNLOCKED;
+
   // FIXED ISSUE #1: Critical race condition protection for all vectors
   // Prevents heap corruption when multiple tasks access vectors simultaneously
   // (BLE config change + polling loop + auto-recovery task)
@@ -36,13 +122,11 @@ class ModbusRtuService {
   // 2-Level Polling Hierarchy (CLEANUP: Removed Level 1 per-register polling)
 
   // Level 1: Device-level timing (device refresh_rate)
-  struct DeviceTimer {
-    PSRAMString deviceId;  // BUG #31: Use PSRAM instead of DRAM
-    unsigned long
-        lastRead;  // Last time device's registers were collectively polled
-    uint32_t refreshRateMs;  // Device-level interval
-  };
-  std::vector<DeviceTimer> deviceTimers;
+  // v1.3.3: Per-bus PollScheduler (was a DeviceTimer list scanned by
+  // shouldPollDevice() for every device on every loop)
+  static constexpr uint32_t RTU_MAX_IDLE_WAIT_MS =
+      1000;  // Longest sleep between passes (BLE pause / memory recovery
+             // checks); config changes wake the workers immediately
 
   // Level 2: Server data transmission interval (data_interval untuk MQTT/HTTP)
   struct DataTransmissionInterval {
@@ -52,104 +136,53 @@ class ModbusRtuService {
   } dataTransmissionSchedule;
 
   struct RtuDeviceConfig {
-    PSRAMString deviceId;  // BUG #31: Use PSRAM instead of DRAM
-    std::unique_ptr<JsonDocument>
-        doc;  // FIXED Bug #2: Use smart pointer for auto-cleanup
+    InternedString deviceId;  // v1.3.3: StringIntern handle (was PSRAMString)
+    // FIXED Bug #2: Use smart pointer for auto-cleanup
+    // v1.3.3: Shared with the ConfigManager generation (read-only, no copy)
+    ConfigManager::DeviceConfigHandle doc;
+    CompiledDevicePlan plan;  // v1.3.3: Compiled from doc (rebuilt together)
+    uint32_t nextPollMs = 0;  // v1.3.3: Scheduled deadline (kept on refresh)
+    ModbusDeviceState state;  // v1.3.3: Failure / timeout / metrics record
   };
   std::vector<RtuDeviceConfig> rtuDevices;
 
   // Device Failure State Tracking (Modbus Improvement Phase 1)
-  struct DeviceFailureState {
-    PSRAMString deviceId;               // BUG #31: Use PSRAM instead of DRAM
-    uint8_t consecutiveFailures = 0;    // Track consecutive read failures
-    uint8_t retryCount = 0;             // Current retry attempt count
-    unsigned long nextRetryTime = 0;    // When to retry (exponential backoff)
-    unsigned long lastReadAttempt = 0;  // Timestamp of last read attempt
-    unsigned long lastSuccessfulRead =
-        0;                     // NEW: Track last success time for metrics
-    bool isEnabled = true;     // Enable/disable for polling
-    uint16_t baudRate = 9600;  // Per-device baud rate
-    uint32_t maxRetries = 5;   // Max retry attempts
-
-    // NEW: Enhancement - Flexible Disable Reason Tracking
-    enum DisableReason {
-      NONE = 0,         // Device is enabled
-      MANUAL = 1,       // Manually disabled via BLE command
-      AUTO_RETRY = 2,   // Auto-disabled: max retries exceeded
-      AUTO_TIMEOUT = 3  // Auto-disabled: max consecutive timeouts
-    };
-    DisableReason disableReason = NONE;
-    PSRAMString
-        disableReasonDetail;  // User-provided reason (e.g., "maintenance")
-    unsigned long disabledTimestamp =
-        0;  // When device was disabled (for auto-recovery)
-  };
-  std::vector<DeviceFailureState>
-      deviceFailureStates;  // Dynamic device tracking
-
   // Device Read Timeout Configuration (Modbus Improvement Phase 2)
-  struct DeviceReadTimeout {
-    PSRAMString deviceId;             // BUG #31: Use PSRAM instead of DRAM
-    uint16_t timeoutMs = 5000;        // Per-device timeout (5 seconds default)
-    uint8_t consecutiveTimeouts = 0;  // Track consecutive timeouts
-    unsigned long lastSuccessfulRead = 0;  // Last successful read time
-    uint8_t maxConsecutiveTimeouts = 3;    // Disable device after 3 timeouts
-  };
-  std::vector<DeviceReadTimeout> deviceTimeouts;  // Dynamic timeout tracking
-
   // NEW: Enhancement - Device Health Metrics Tracking (Phase 2)
-  struct DeviceHealthMetrics {
-    PSRAMString deviceId;
-
-    // Counters
-    uint32_t totalReads = 0;
-    uint32_t successfulReads = 0;
-    uint32_t failedReads = 0;
-
-    // Response time tracking (in milliseconds)
-    uint32_t totalResponseTimeMs = 0;  // Sum for averaging
-    uint16_t minResponseTimeMs = 65535;
-    uint16_t maxResponseTimeMs = 0;
-    uint16_t lastResponseTimeMs = 0;
-
-    // Calculate metrics
-    float getSuccessRate() const {
-      if (totalReads == 0) return 100.0f;
-      return (successfulReads * 100.0f) / totalReads;
-    }
-
-    uint16_t getAvgResponseTimeMs() const {
-      if (successfulReads == 0) return 0;
-      return totalResponseTimeMs / successfulReads;
-    }
-
-    // Record a read attempt
-    void recordRead(bool success, uint16_t responseTimeMs = 0) {
-      totalReads++;
-      if (success) {
-        successfulReads++;
-        totalResponseTimeMs += responseTimeMs;
-        lastResponseTimeMs = responseTimeMs;
-        if (responseTimeMs < minResponseTimeMs)
-          minResponseTimeMs = responseTimeMs;
-        if (responseTimeMs > maxResponseTimeMs)
-          maxResponseTimeMs = responseTimeMs;
-      } else {
-        failedReads++;
-      }
-    }
-  };
-  std::vector<DeviceHealthMetrics> deviceMetrics;  // Dynamic metrics tracking
+  // v1.3.3: One ModbusDeviceState per device (RtuDeviceConfig::state), was
+  // three vectors searched by device ID on every access
+  using DeviceFailureState = ModbusDeviceFailureState;
+  using DeviceReadTimeout = ModbusDeviceReadTimeout;
+  using DeviceHealthMetrics = ModbusDeviceHealthMetrics;
+  ModbusDeviceIndex deviceIndex;  // Device ID -> rtuDevices slot
 
   static const int RTU_RX1 = 15;
   static const int RTU_TX1 = 16;
   static const int RTU_RX2 = 17;
   static const int RTU_TX2 = 18;
 
+  // v1.3.3: RS485 driver-enable pins for hardware half-duplex (UART RTS).
+  // -1 = not wired, the transceivers switch direction by themselves.
+  static const int RTU_DE1 = -1;
+  static const int RTU_DE2 = -1;
+  static const size_t RTU_TX_BUFFER_SIZE = 256;
+
+  // v1.3.3: Block-read span limits. RtuMaster stores at most MAX_WORDS (64)
+  // response words, so RTU spans are capped below the 125-word Modbus limit
+  // to avoid silently truncated responses.
+  static const uint16_t RTU_MAX_SPAN_REGISTERS = RtuMaster::MAX_WORDS;
+  static const uint16_t RTU_MAX_SPAN_BITS = RTU_MAX_SPAN_REGISTERS * 16;
+
+  // v1.3.3: Response timeout auto-tuning ("auto_timeout": true). After
+  // RTU_AUTOTUNE_MIN_SAMPLES successful reads the timeout shrinks to twice
+  // the slowest measured response + margin (never above the configured one,
+  // back to the configured one after a timeout).
+  static const uint32_t RTU_MIN_RESPONSE_TIMEOUT_MS = 20;
+  static const uint32_t RTU_AUTOTUNE_MIN_SAMPLES = 20;
+  static const uint32_t RTU_AUTOTUNE_MARGIN_MS = 20;
+
   HardwareSerial* serial1;
   HardwareSerial* serial2;
-  ModbusMaster* modbus1;
-  ModbusMaster* modbus2;
 
   // Baudrate caching to avoid unnecessary serial reconfig
   uint32_t currentBaudRate1;
@@ -157,20 +190,61 @@ class ModbusRtuService {
 
   // Helper method for dynamic baudrate switching
   void configureBaudRate(int serialPort, uint32_t baudRate);
+  // v1.3.3: begin() + RS485 mode + RtuMaster binding (init and baud change)
+  void beginSerial(int serialPort, uint32_t baudRate);
   bool validateBaudRate(uint32_t baudRate);
 
   static void readRtuDevicesTask(void* parameter);
-  void readRtuDevicesLoop();
-  void readRtuDeviceData(const JsonObject& deviceConfig);
+  void readRtuDevicesLoop(BusWorker& worker);
+  // v1.3.3: false = not polled (no registers, disabled or retry backoff)
+  bool readRtuDeviceData(RtuDeviceConfig& device);
+  BusWorker* getBusWorker(int serialPort);
+  // v1.3.3: Poll pass aborted (stop, pending config refresh)
+  bool pollInterrupted() const {
+    return !running || configChangePending.load() || refreshRequested.load();
+  }
   // NOTE: processRegisterValue and processMultiRegisterValue moved to
   // ModbusUtils (shared with TCP)
-  bool readMultipleRegisters(ModbusMaster* modbus, uint8_t functionCode,
-                             uint16_t address, int count, uint16_t* values);
-  bool storeRegisterValue(
-      const char* deviceId, const JsonObject& reg, double value,
-      const char* deviceName = "");  // BUG #31: const char* instead of String,
-                                     // FIXED: Returns bool for error handling
-  ModbusMaster* getModbusForBus(int serialPort);
+  // v1.3.3: Block read of one span (FC1-4), returns the Modbus result code
+  uint8_t readSpan(RtuMaster& master, const RtuMaster::Request& request,
+                   uint16_t* values);
+  // v1.3.3: One bus transaction (baud rate, slave ID, span read) under the
+  // bus lock. Caller holds vectorMutex once; it is released meanwhile so the
+  // other bus worker (and BLE commands) are not blocked by this bus.
+  // Applies the device's bus timing and records the result in its metrics.
+  uint8_t readSpanOnBus(RtuDeviceConfig& device, uint8_t functionCode,
+                        uint16_t address, uint16_t quantity, uint16_t* values);
+  // v1.3.3: Write lane. serviceWriteLane() runs the queued writes (caller
+  // holds busMutex), submitWrite() queues one and waits for its result (runs
+  // it directly when the bus worker is not running)
+  void serviceWriteLane(BusWorker& worker);
+  bool submitWrite(BusWorker& worker, RtuWriteRequest& request);
+  uint8_t executeWrite(BusWorker& worker, RtuWriteRequest& request);
+  // v1.3.3: Write path helpers (resolveWrite/prepareWriteRequest: caller
+  // holds vectorMutex)
+  bool resolveWrite(RtuDeviceConfig& device, const char* registerId,
+                    double value, RtuWriteItem& item, JsonObject& response);
+  int prepareWriteRequest(const RtuDeviceConfig& device,
+                          RtuWriteRequest& request) const;
+  bool reportWriteResult(JsonObject& response, const char* deviceId,
+                         const char* registerId, double value,
+                         double rawValue, uint8_t result,
+                         unsigned long responseTime);
+  // v1.3.3: Delay without holding vectorMutex (turnaround gaps, 0 = none)
+  void pauseUnlocked(uint32_t delayMs);
+  // v1.3.3: Bus timing of a device (caller holds vectorMutex)
+  uint32_t responseTimeoutFor(const RtuDeviceConfig& device) const;
+  uint32_t interFrameFor(const RtuDeviceConfig& device) const;
+  // v1.3.3: Feed one transaction into the device's timeout/metrics state
+  void recordTransaction(RtuDeviceConfig& device, uint8_t result,
+                         bool responded, uint32_t latencyMs,
+                         uint32_t timeoutMs);
+  // v1.3.3: Update latest value + enqueue one calibrated register value of
+  // a compiled plan (binary record when registry-bound). timestamp = span
+  // response time (v1.3.3: no RTC read per register).
+  // FIXED: Returns bool for error handling
+  bool storeRegisterValue(CompiledDevicePlan& plan, uint16_t registerSlot,
+                          double calibratedValue, uint32_t timestamp);
 
   // FIXED ISSUE #3: Helper function to eliminate code duplication in register
   // logging (FC1/2/3/4) Consolidates 80+ lines of duplicated unit processing,
@@ -184,13 +258,9 @@ class ModbusRtuService {
 
   // Polling Hierarchy Helper Methods (CLEANUP: Removed Level 1 per-register
   // methods) Level 1 (Device-level): Device-level timing
-  DeviceTimer* getDeviceTimer(
-      const char* deviceId);  // BUG #31: const char* instead of String
-  bool shouldPollDevice(
-      const char* deviceId,
-      uint32_t refreshRateMs);  // BUG #31: const char* instead of String
-  void updateDeviceLastRead(
-      const char* deviceId);  // BUG #31: const char* instead of String
+  // v1.3.3: Deadline after a pass (regular interval or retry backoff)
+  uint32_t nextPollDeadline(RtuDeviceConfig& device, const PollSlot& slot,
+                            bool polled, uint32_t nowMs);
 
   // Level 2 (Server-level): Data transmission interval
   bool shouldTransmitData(uint32_t dataIntervalMs);
@@ -198,16 +268,11 @@ class ModbusRtuService {
   void setDataTransmissionInterval(uint32_t intervalMs);
 
   // Modbus Improvement Phase - Helper Methods
-  void initializeDeviceFailureTracking();
-  void initializeDeviceTimeouts();
-  void
-  initializeDeviceMetrics();  // NEW: Enhancement - Initialize metrics tracking
-  struct DeviceFailureState* getDeviceFailureState(
-      const char* deviceId);  // BUG #31: const char* instead of String
-  struct DeviceReadTimeout* getDeviceTimeout(
-      const char* deviceId);  // BUG #31: const char* instead of String
-  struct DeviceHealthMetrics* getDeviceMetrics(
-      const char* deviceId);  // NEW: Enhancement - Get metrics
+  // v1.3.3: Fresh state record per device (replaces the three
+  // initializeDevice*() passes) and hashed ID lookup (replaces the
+  // getDeviceFailureState / getDeviceTimeout / getDeviceMetrics scans)
+  void initializeDeviceState(RtuDeviceConfig& device);
+  RtuDeviceConfig* findDevice(const char* deviceId);
 
   // Baud rate configuration
   bool configureDeviceBaudRate(
@@ -217,31 +282,31 @@ class ModbusRtuService {
       const char* deviceId);  // BUG #31: const char* instead of String
 
   // Exponential backoff retry logic
-  void handleReadFailure(
-      const char* deviceId);  // BUG #31: const char* instead of String
-  bool shouldRetryDevice(
-      const char* deviceId);  // BUG #31: const char* instead of String
+  // v1.3.3: Take the device entry (slot) instead of its ID
+  void handleReadFailure(RtuDeviceConfig& device);
+  bool shouldRetryDevice(const RtuDeviceConfig& device);
   unsigned long calculateBackoffTime(uint8_t retryCount);
-  void resetDeviceFailureState(
-      const char* deviceId);  // BUG #31: const char* instead of String
+  void resetDeviceFailureState(RtuDeviceConfig& device);
 
   // Timeout and device management
-  void handleReadTimeout(
-      const char* deviceId);  // BUG #31: const char* instead of String
-  bool isDeviceEnabled(
-      const char* deviceId);  // BUG #31: const char* instead of String
+  void handleReadTimeout(RtuDeviceConfig& device);
+  bool isDeviceEnabled(const RtuDeviceConfig& device);
 
   // NEW: Enhancement - Flexible enable/disable with reason tracking
-  void enableDevice(const char* deviceId,
+  void enableDevice(RtuDeviceConfig& device,
                     bool clearMetrics = false);  // Updated signature
-  void disableDevice(const char* deviceId,
-                     DeviceFailureState::DisableReason reason,
+  void disableDevice(RtuDeviceConfig& device, ModbusDisableReason reason,
                      const char* reasonDetail = "");  // Updated signature
 
   // NEW: Enhancement - Auto-recovery for auto-disabled devices
   static void autoRecoveryTask(void* parameter);
   void autoRecoveryLoop();
   TaskHandle_t autoRecoveryTaskHandle = nullptr;
+  // v1.3.3: One-register read of an auto-disabled device (see
+  // ModbusRecoveryConfig), queued on its bus's write lane. false = nothing
+  // to probe (no registers). Caller holds vectorMutex.
+  bool prepareProbe(const RtuDeviceConfig& device,
+                    RtuWriteRequest& request) const;
 
  public:
   ModbusRtuService(ConfigManager* config);
@@ -251,22 +316,38 @@ class ModbusRtuService {
   void stop();
   void getStatus(JsonObject& status);
 
-  void notifyConfigChange();
+  // v1.3.3: change = what was edited (default: unknown, rebuild all)
+  void notifyConfigChange(const ModbusConfigChange& change = {});
 
   // NEW: Enhancement - Public API for BLE device control commands
   bool enableDeviceByCommand(const char* deviceId, bool clearMetrics = false);
   bool disableDeviceByCommand(const char* deviceId,
                               const char* reasonDetail = "");
-  bool getDeviceStatusInfo(const char* deviceId, JsonObject& statusInfo);
+  // v1.3.3: includeHistogram adds the device's response time buckets
+  bool getDeviceStatusInfo(const char* deviceId, JsonObject& statusInfo,
+                           bool includeHistogram = true);
   bool getAllDevicesStatus(JsonObject& allStatus);
+  // v1.3.3: Response time percentiles per bus (MQTT full status, all-devices
+  // status)
+  void getBusLatencyStatus(JsonObject& buses, bool includeHistogram);
 
   // v2.5.35: Get aggregated Modbus stats for ProductionLogger
   void getAggregatedStats(uint32_t& totalSuccess, uint32_t& totalFailed);
+  // v1.3.3: Highest bus utilization (%) and missed deadlines of all devices
+  void getCapacitySummary(uint8_t& peakUtilization, uint32_t& missedDeadlines);
 
   // v1.0.8: Write Register Support
   // Write a value to a Modbus register (FC5, FC6, FC15, FC16)
   bool writeRegisterValue(const char* deviceId, const char* registerId,
                           double value, JsonObject& response);
+  // v1.3.3: Write several registers of one device. Contiguous holding
+  // registers / coils go out as one FC16 / FC15 transaction; results[i]
+  // gets the writeRegisterValue() response for registerIds[i].
+  // Returns the number of successful writes.
+  size_t writeRegisterValues(const char* deviceId,
+                             const char* const* registerIds,
+                             const double* values, JsonObject* results,
+                             size_t count);
 
   ~ModbusRtuService();
 };
@@ -0,0 +1,525 @@
+#include "ModbusTcpServer.h"
+
+#include <esp_heap_caps.h>
+
+#include <algorithm>  // std::sort, std::lower_bound
+
+#include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+#include "EthernetManager.h"
+#include "RTCManager.h"
+#include "ServerConfig.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+#include "WiFiManager.h"
+
+ModbusTcpServer* ModbusTcpServer::instance = nullptr;
+
+namespace {
+
+// Modbus exception codes
+constexpr uint8_t EXCEPTION_ILLEGAL_FUNCTION = 0x01;
+constexpr uint8_t EXCEPTION_ILLEGAL_ADDRESS = 0x02;
+constexpr uint8_t EXCEPTION_ILLEGAL_VALUE = 0x03;
+constexpr uint8_t EXCEPTION_PATH_UNAVAILABLE = 0x0A;
+constexpr uint8_t EXCEPTION_TARGET_NO_RESPONSE = 0x0B;
+
+// Widest served value (INT64 / UINT64 / DOUBLE64)
+constexpr uint8_t MAX_VALUE_WORDS = 4;
+
+}  // namespace
+
+ModbusTcpServer::ModbusTcpServer()
+    : port(502),
+      maxClients(2),
+      idleTimeoutMs(60000),
+      staleTimeoutS(0),
+      ethernetManager(nullptr),
+      ethServer(nullptr),
+      wifiServer(nullptr),
+      wifiListening(false),
+      clients(nullptr),
+      mapVersion(0),
+      mapBuilt(false),
+      taskHandle(nullptr),
+      taskRunning(false),
+      requestCount(0),
+      exceptionCount(0) {}
+
+ModbusTcpServer::~ModbusTcpServer() {
+  stop();
+  if (clients) {
+    for (uint8_t i = 0; i < ModbusServerConfig::MAX_CLIENTS; i++) {
+      closeClient(clients[i]);
+    }
+    heap_caps_free(clients);
+    clients = nullptr;
+  }
+  if (wifiServer) {
+    wifiServer->end();
+    delete wifiServer;
+    wifiServer = nullptr;
+  }
+  // ethServer is kept: the Ethernet library has no way to stop listening
+}
+
+ModbusTcpServer* ModbusTcpServer::getInstance() {
+  if (!instance) {
+    instance = new ModbusTcpServer();
+  }
+  return instance;
+}
+
+bool ModbusTcpServer::init(ServerConfig* serverConfig) {
+  if (!serverConfig) {
+    return false;
+  }
+
+  JsonDocument doc;
+  JsonObject settings = doc.to<JsonObject>();
+  if (!serverConfig->getModbusServerConfig(settings) ||
+      !(settings["enabled"] | false)) {
+    LOG_TCP_INFO("[MBSRV] Modbus TCP server disabled\n");
+    return false;
+  }
+
+  // Ranges checked by ServerConfig validation
+  port = settings["port"] | 502;
+  int requestedClients = settings["max_clients"] | 2;
+  maxClients =
+      (uint8_t)std::max(1, std::min<int>(requestedClients,
+                                         ModbusServerConfig::MAX_CLIENTS));
+  idleTimeoutMs = (uint32_t)(settings["idle_timeout"] | 60) * 1000;
+  staleTimeoutS = settings["stale_timeout"] | 0;
+
+  if (!clients) {
+    clients = (ClientSlot*)heap_caps_calloc(ModbusServerConfig::MAX_CLIENTS,
+                                            sizeof(ClientSlot),
+                                            MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!clients) {
+      clients = (ClientSlot*)heap_caps_calloc(ModbusServerConfig::MAX_CLIENTS,
+                                              sizeof(ClientSlot),
+                                              MALLOC_CAP_8BIT);
+    }
+    if (!clients) {
+      LOG_TCP_ERROR("[MBSRV] Failed to allocate client slots\n");
+      return false;
+    }
+  }
+
+  ethernetManager = EthernetManager::getInstance();
+  LOG_TCP_INFO("[MBSRV] Modbus TCP server on port %u (max %u clients)\n",
+               port, maxClients);
+  return true;
+}
+
+bool ModbusTcpServer::start() {
+  if (taskRunning) {
+    return true;
+  }
+  if (!clients) {
+    return false;
+  }
+  taskRunning = true;
+  BaseType_t result = TaskAffinity::create(
+      taskTrampoline, "MODBUS_SRV_TASK", ModbusServerConfig::TASK_STACK_SIZE,
+      this, TaskAffinity::Task::MODBUS_SERVER, &taskHandle);
+  if (result != pdPASS) {
+    LOG_TCP_ERROR("[MBSRV] Task creation failed\n");
+    taskRunning = false;
+    taskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void ModbusTcpServer::stop() {
+  if (taskRunning && taskHandle) {
+    taskRunning = false;
+    vTaskDelete(taskHandle);
+    taskHandle = nullptr;
+  }
+}
+
+void ModbusTcpServer::taskTrampoline(void* param) {
+  static_cast<ModbusTcpServer*>(param)->taskLoop();
+}
+
+void ModbusTcpServer::taskLoop() {
+  while (taskRunning) {
+    // Map follows device config refreshes (lock-free version check)
+    if (!mapBuilt ||
+        PollPlanRegistry::getInstance()->layoutVersion() != mapVersion) {
+      rebuildMap();
+    }
+
+    updateListeners();
+    acceptClients();
+
+    bool busy = false;
+    for (uint8_t i = 0; i < ModbusServerConfig::MAX_CLIENTS; i++) {
+      if (clients[i].client && serviceClient(clients[i])) {
+        busy = true;
+      }
+    }
+
+    // Back-to-back requests are answered without delay; otherwise poll the
+    // sockets every IDLE_DELAY_MS (the W5500 has no readiness interrupt)
+    vTaskDelay(busy ? 1 : pdMS_TO_TICKS(ModbusServerConfig::IDLE_DELAY_MS));
+  }
+  vTaskDelete(NULL);
+}
+
+void ModbusTcpServer::rebuildMap() {
+  ServerPointList newPoints;
+  RegisterRefList newRefs;
+
+  mapVersion = PollPlanRegistry::getInstance()->visitPlans(
+      [&](uint8_t slot, uint16_t generation, const CompiledDevicePlan& plan) {
+        for (size_t r = 0; r < plan.registers.size(); r++) {
+          const CompiledRegister& reg = plan.registers[r];
+          if (reg.functionCode != 3 && reg.functionCode != 4) {
+            continue;  // Coils / discrete inputs are not served
+          }
+          ServerPoint point;
+          point.unitId = plan.serverUnitId;
+          point.functionCode = reg.functionCode;
+          point.address = reg.serverAddress;
+          point.wordCount = ModbusUtils::getWordCount(reg.serverType);
+          point.type = reg.serverType;
+          point.endianness = reg.serverEndianness;
+          point.calibrated = reg.serverCalibrated;
+          point.scale = plan.decoders[r].scale;
+          point.offset = plan.decoders[r].offset;
+          if ((uint32_t)point.address + point.wordCount > 65536) {
+            continue;
+          }
+          newPoints.push_back(point);
+          newRefs.push_back(
+              PollPlanRegistry::RegisterRef{slot, generation, (uint16_t)r, 0});
+        }
+      });
+
+  // Sort (unit, FC, address); stable so the lower device slot wins overlaps
+  std::vector<uint16_t> order(newPoints.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint16_t a, uint16_t b) {
+    const ServerPoint& pa = newPoints[a];
+    const ServerPoint& pb = newPoints[b];
+    if (pa.unitId != pb.unitId) return pa.unitId < pb.unitId;
+    if (pa.functionCode != pb.functionCode) {
+      return pa.functionCode < pb.functionCode;
+    }
+    return pa.address < pb.address;
+  });
+
+  points.clear();
+  refs.clear();
+  points.reserve(order.size());
+  refs.reserve(order.size());
+  uint16_t overlaps = 0;
+  for (uint16_t index : order) {
+    const ServerPoint& point = newPoints[index];
+    if (!points.empty()) {
+      const ServerPoint& last = points.back();
+      if (last.unitId == point.unitId &&
+          last.functionCode == point.functionCode &&
+          (uint32_t)last.address + last.wordCount > point.address) {
+        overlaps++;
+        continue;
+      }
+    }
+    points.push_back(point);
+    refs.push_back(newRefs[index]);
+  }
+
+  mapBuilt = true;
+  if (overlaps > 0) {
+    LOG_TCP_WARN(
+        "[MBSRV] %u register(s) overlap another of the same unit - not "
+        "served (set server_unit_id / server_address)\n",
+        overlaps);
+  }
+  LOG_TCP_INFO("[MBSRV] Register map: %u register(s)\n", points.size());
+}
+
+void ModbusTcpServer::updateListeners() {
+  // W5500 (EthernetManager): begin() once the interface is up; the library
+  // keeps the listening socket afterwards
+  if (!ethServer && ethernetManager && ethernetManager->isAvailable()) {
+    ethServer = new EthernetServer(port);
+    ethServer->begin();
+    LOG_TCP_INFO("[MBSRV] Listening on %s:%u (Ethernet)\n",
+                 ethernetManager->getLocalIP().toString().c_str(), port);
+  }
+
+  WiFiManager* wifi = WiFiManager::getInstance();
+  bool wifiUp = wifi && wifi->isAvailable();
+  if (wifiUp && !wifiListening) {
+    if (!wifiServer) {
+      wifiServer = new WiFiServer(port, ModbusServerConfig::MAX_CLIENTS);
+    }
+    wifiServer->begin();
+    wifiListening = true;
+    LOG_TCP_INFO("[MBSRV] Listening on %s:%u (WiFi)\n",
+                 wifi->getLocalIP().toString().c_str(), port);
+  } else if (!wifiUp && wifiListening) {
+    wifiServer->end();  // Re-bound when WiFi comes back
+    wifiListening = false;
+  }
+}
+
+void ModbusTcpServer::acceptClients() {
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < ModbusServerConfig::MAX_CLIENTS; i++) {
+    if (clients[i].client) {
+      used++;
+    }
+  }
+
+  Client* accepted[2] = {nullptr, nullptr};
+  if (ethServer) {
+    EthernetClient client = ethServer->accept();
+    if (client) {
+      accepted[0] = new EthernetClient(client);
+    }
+  }
+  if (wifiListening) {
+    WiFiClient client = wifiServer->accept();
+    if (client) {
+      accepted[1] = new WiFiClient(client);
+    }
+  }
+
+  for (Client* client : accepted) {
+    if (!client) {
+      continue;
+    }
+    ClientSlot* slot = nullptr;
+    for (uint8_t i = 0; i < ModbusServerConfig::MAX_CLIENTS && !slot; i++) {
+      if (!clients[i].client) {
+        slot = &clients[i];
+      }
+    }
+    if (!slot || used >= maxClients) {
+      LOG_TCP_WARN("[MBSRV] Connection refused (%u clients)\n", used);
+      client->stop();
+      delete client;
+      continue;
+    }
+    slot->client = client;
+    slot->request.reset();
+    slot->lastActivity = millis();
+    used++;
+    LOG_TCP_DEBUG("[MBSRV] Client connected (%u/%u)\n", used, maxClients);
+  }
+}
+
+bool ModbusTcpServer::serviceClient(ClientSlot& slot) {
+  Client* client = slot.client;
+  if (!client->connected() && client->available() <= 0) {
+    closeClient(slot);
+    return false;
+  }
+
+  bool progress = false;
+  int available = client->available();
+  while (available > 0) {
+    // MBAP header first, then exactly the length it announces (pipelined
+    // requests stay in the socket until this one is answered)
+    MbapFrameAssembler& request = slot.request;
+    size_t wanted = request.wanted();
+    if ((size_t)available < wanted) {
+      wanted = available;
+    }
+    int bytesRead = client->read(request.writePointer(), wanted);
+    if (bytesRead <= 0) {
+      break;
+    }
+    available -= bytesRead;
+    slot.lastActivity = millis();
+    progress = true;
+
+    MbapFrameAssembler::Result result = request.commit(bytesRead);
+    if (result == MbapFrameAssembler::Result::INVALID) {
+      LOG_TCP_WARN("[MBSRV] Invalid MBAP header (length %u), closing\n",
+                   request.lengthField());
+      closeClient(slot);
+      return true;
+    }
+    if (result == MbapFrameAssembler::Result::INCOMPLETE) {
+      continue;
+    }
+
+    uint8_t response[ModbusServerConfig::MAX_ADU_SIZE];
+    uint16_t responseLength =
+        handleRequest(request.frame, request.received, response);
+    request.reset();
+    if (client->write(response, responseLength) != responseLength) {
+      closeClient(slot);
+      return true;
+    }
+  }
+
+  if (!progress && (millis() - slot.lastActivity) >= idleTimeoutMs) {
+    LOG_TCP_DEBUG("[MBSRV] Client idle, closing\n");
+    closeClient(slot);
+  }
+  return progress;
+}
+
+void ModbusTcpServer::closeClient(ClientSlot& slot) {
+  if (!slot.client) {
+    return;
+  }
+  slot.client->stop();
+  delete slot.client;
+  slot.client = nullptr;
+  slot.request.reset();
+}
+
+uint16_t ModbusTcpServer::handleRequest(const uint8_t* request,
+                                        uint16_t length, uint8_t* response) {
+  requestCount++;
+  uint8_t unitId = request[6];
+  uint8_t functionCode = request[7];
+
+  if (functionCode != 3 && functionCode != 4) {
+    return buildException(request, functionCode, EXCEPTION_ILLEGAL_FUNCTION,
+                          response);
+  }
+  if (length != 12) {
+    return buildException(request, functionCode, EXCEPTION_ILLEGAL_VALUE,
+                          response);
+  }
+
+  uint16_t address = ((uint16_t)request[8] << 8) | request[9];
+  uint16_t quantity = ((uint16_t)request[10] << 8) | request[11];
+  if (quantity < 1 || quantity > ModbusServerConfig::MAX_READ_REGISTERS) {
+    return buildException(request, functionCode, EXCEPTION_ILLEGAL_VALUE,
+                          response);
+  }
+  if ((uint32_t)address + quantity > 65536) {
+    return buildException(request, functionCode, EXCEPTION_ILLEGAL_ADDRESS,
+                          response);
+  }
+
+  uint16_t words[ModbusServerConfig::MAX_READ_REGISTERS];
+  uint8_t exceptionCode =
+      readRegisters(unitId, functionCode, address, quantity, words);
+  if (exceptionCode != 0) {
+    return buildException(request, functionCode, exceptionCode, response);
+  }
+
+  uint8_t byteCount = quantity * 2;
+  memcpy(response, request, 4);  // Transaction ID, protocol ID
+  response[4] = 0;
+  response[5] = 3 + byteCount;  // Unit + FC + byte count + data
+  response[6] = unitId;
+  response[7] = functionCode;
+  response[8] = byteCount;
+  for (uint16_t i = 0; i < quantity; i++) {
+    response[9 + i * 2] = words[i] >> 8;
+    response[10 + i * 2] = words[i] & 0xFF;
+  }
+  return 9 + byteCount;
+}
+
+uint8_t ModbusTcpServer::readRegisters(uint8_t unitId, uint8_t functionCode,
+                                       uint16_t address, uint16_t quantity,
+                                       uint16_t* words) {
+  // First entry of the unit / FC that may reach into the range (a value
+  // starting up to MAX_VALUE_WORDS - 1 words earlier)
+  uint16_t searchFrom =
+      address >= MAX_VALUE_WORDS - 1 ? address - (MAX_VALUE_WORDS - 1) : 0;
+  auto key = [](uint8_t unit, uint8_t fc, uint16_t addr) {
+    return ((uint32_t)unit << 24) | ((uint32_t)fc << 16) | addr;
+  };
+  auto first = std::lower_bound(
+      points.begin(), points.end(), key(unitId, functionCode, searchFrom),
+      [&](const ServerPoint& point, uint32_t value) {
+        return key(point.unitId, point.functionCode, point.address) < value;
+      });
+  if (first == points.end() || first->unitId != unitId) {
+    // No register of this unit with the FC at or after the range; unknown
+    // unit -> path unavailable
+    bool unitKnown = std::any_of(
+        points.begin(), points.end(),
+        [unitId](const ServerPoint& point) { return point.unitId == unitId; });
+    return unitKnown ? EXCEPTION_ILLEGAL_ADDRESS : EXCEPTION_PATH_UNAVAILABLE;
+  }
+
+  size_t begin = first - points.begin();
+  size_t end = begin;
+  uint32_t rangeEnd = (uint32_t)address + quantity;
+  while (end < points.size() && points[end].unitId == unitId &&
+         points[end].functionCode == functionCode &&
+         points[end].address < rangeEnd) {
+    end++;
+  }
+  // Skip entries that end before the range
+  while (begin < end && (uint32_t)points[begin].address +
+                                points[begin].wordCount <= address) {
+    begin++;
+  }
+  if (begin == end) {
+    bool unitKnown = std::any_of(
+        points.begin(), points.end(),
+        [unitId](const ServerPoint& point) { return point.unitId == unitId; });
+    return unitKnown ? EXCEPTION_ILLEGAL_ADDRESS : EXCEPTION_PATH_UNAVAILABLE;
+  }
+
+  // One registry lock for the whole range (at most 125 entries)
+  LatestValue values[ModbusServerConfig::MAX_READ_REGISTERS];
+  size_t count = end - begin;
+  PollPlanRegistry::getInstance()->peekLatest(&refs[begin], count, values);
+
+  uint32_t now = 0;
+  if (staleTimeoutS > 0) {
+    RTCManager* rtc = RTCManager::getInstance();
+    now = rtc ? rtc->getUnixTime() : 0;
+  }
+
+  memset(words, 0, quantity * sizeof(uint16_t));
+  for (size_t i = 0; i < count; i++) {
+    const ServerPoint& point = points[begin + i];
+    const LatestValue& latest = values[i];
+    if (latest.version == 0) {
+      return EXCEPTION_TARGET_NO_RESPONSE;  // Never read / device gone
+    }
+    if (staleTimeoutS > 0 && now > 0 && latest.timestamp > 0 &&
+        now - latest.timestamp > staleTimeoutS) {
+      return EXCEPTION_TARGET_NO_RESPONSE;
+    }
+
+    double value = point.calibrated
+                       ? latest.value
+                       : ModbusUtils::reverseCalibration(
+                             latest.value, point.scale, point.offset);
+    uint16_t encoded[MAX_VALUE_WORDS];
+    ModbusUtils::encodeValue(value, point.type, point.endianness, encoded);
+
+    // Copy the words inside the range (a value may straddle its edges)
+    for (uint8_t w = 0; w < point.wordCount; w++) {
+      uint32_t wordAddress = (uint32_t)point.address + w;
+      if (wordAddress >= address && wordAddress < rangeEnd) {
+        words[wordAddress - address] = encoded[w];
+      }
+    }
+  }
+  return 0;
+}
+
+uint16_t ModbusTcpServer::buildException(const uint8_t* request,
+                                         uint8_t functionCode,
+                                         uint8_t exceptionCode,
+                                         uint8_t* response) {
+  exceptionCount++;
+  memcpy(response, request, 4);  // Transaction ID, protocol ID
+  response[4] = 0;
+  response[5] = 3;
+  response[6] = request[6];
+  response[7] = functionCode | 0x80;
+  response[8] = exceptionCode;
+  return 9;
+}
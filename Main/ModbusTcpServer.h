@@ -0,0 +1,165 @@
+#ifndef MODBUS_TCP_SERVER_H
+#define MODBUS_TCP_SERVER_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Ethernet.h>
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <vector>
+
+#include "MbapFrame.h"  // v1.3.3: Request reassembly
+#include "ModbusPollPlan.h"
+#include "PSRAMAllocator.h"
+
+class ServerConfig;
+class EthernetManager;
+
+/**
+ * ModbusTcpServer - Modbus TCP server answering from the latest-value table
+ *
+ * v1.3.3: Built-in slave for SCADA / HMI systems on the plant LAN
+ * Previous: systems that needed the field values polled the field devices
+ * directly, in parallel with the gateway, doubling the load on slow RS485
+ * buses.
+ * New: the gateway answers FC3 / FC4 reads itself from the latest values
+ * of the polled registers (CompiledDevicePlan::latest, through
+ * PollPlanRegistry). Field buses are polled once; downstream reads cost no
+ * bus time.
+ *
+ * Register map (rebuilt whenever the registry layout changes):
+ * - Unit ID: device "server_unit_id" (default: the device's slave_id)
+ * - Address: register "server_address" (default: its field address), same
+ *   function code (FC3 holding / FC4 input registers)
+ * - Encoding: by default the raw value in the register's own data_type
+ *   (calibration reversed), so a client configured for the field device
+ *   reads the same words from the gateway. "server_data_type" (e.g.
+ *   "FLOAT32_BE") serves the calibrated value in that type instead.
+ * - FC1 / FC2 registers are not served; the first of two overlapping
+ *   entries of a unit wins (logged)
+ *
+ * Responses:
+ * - Unknown unit ID: exception 0x0A (gateway path unavailable)
+ * - No mapped register in the range: 0x02 (illegal data address), words
+ *   between mapped registers read 0
+ * - A register in the range never read, gone, or older than
+ *   "stale_timeout": 0x0B (gateway target device failed to respond)
+ * - Other function codes: 0x01 (writes go through BLE / MQTT as before)
+ *
+ * Values behind a deadband are the last reported ones (see
+ * ModbusPollPlan::checkDeadband); use max_silence_ms < stale_timeout.
+ *
+ * Listens on the W5500 (EthernetManager) and on WiFi, whichever is up, with
+ * "max_clients" connections in total.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+namespace ModbusServerConfig {
+constexpr uint8_t MAX_CLIENTS = 4;           // Upper bound of "max_clients"
+constexpr uint16_t MAX_READ_REGISTERS = 125;  // Modbus spec limit (FC3/FC4)
+constexpr uint16_t MAX_ADU_SIZE = MbapFrame::MAX_ADU_SIZE;
+constexpr uint32_t IDLE_DELAY_MS = 10;        // Loop delay without requests
+constexpr uint32_t TASK_STACK_SIZE = 4096;
+}  // namespace ModbusServerConfig
+
+class ModbusTcpServer {
+ public:
+  static ModbusTcpServer* getInstance();
+
+  ModbusTcpServer(const ModbusTcpServer&) = delete;
+  ModbusTcpServer& operator=(const ModbusTcpServer&) = delete;
+
+  /**
+   * Read "modbus_server" from the server config
+   * @return false if the server is disabled (nothing to start)
+   */
+  bool init(ServerConfig* serverConfig);
+
+  bool start();
+  void stop();
+
+  bool isRunning() const { return taskRunning; }
+
+ private:
+  // One served register (sorted by unit, function code, address)
+  struct ServerPoint {
+    uint8_t unitId;
+    uint8_t functionCode;  // 3 or 4
+    uint16_t address;
+    uint8_t wordCount;
+    ModbusDataType type;
+    ModbusEndianness endianness;
+    bool calibrated;  // Serve the calibrated value (else reverse calibration)
+    float scale;
+    float offset;
+  };
+  using ServerPointList =
+      std::vector<ServerPoint, STLPSRAMAllocator<ServerPoint>>;
+  using RegisterRefList =
+      std::vector<PollPlanRegistry::RegisterRef,
+                  STLPSRAMAllocator<PollPlanRegistry::RegisterRef>>;
+
+  struct ClientSlot {
+    Client* client;  // EthernetClient / WiFiClient (nullptr = free)
+    unsigned long lastActivity;
+    MbapFrameAssembler request;  // Current request frame
+  };
+
+  static ModbusTcpServer* instance;
+
+  // Settings ("modbus_server")
+  uint16_t port;
+  uint8_t maxClients;
+  uint32_t idleTimeoutMs;
+  uint32_t staleTimeoutS;  // 0 = never stale
+
+  EthernetManager* ethernetManager;
+  EthernetServer* ethServer;  // Created once (the library cannot stop it)
+  WiFiServer* wifiServer;
+  bool wifiListening;
+
+  ClientSlot* clients;  // ModbusServerConfig::MAX_CLIENTS (PSRAM)
+
+  ServerPointList points;
+  RegisterRefList refs;  // Parallel to points (PollPlanRegistry::peekLatest)
+  uint32_t mapVersion;   // PollPlanRegistry::layoutVersion() of the map
+  bool mapBuilt;
+
+  TaskHandle_t taskHandle;
+  volatile bool taskRunning;
+
+  // Statistics (logged)
+  uint32_t requestCount;
+  uint32_t exceptionCount;
+
+  ModbusTcpServer();
+  ~ModbusTcpServer();
+
+  static void taskTrampoline(void* param);
+  void taskLoop();
+
+  void rebuildMap();
+  void updateListeners();
+  void acceptClients();
+  bool serviceClient(ClientSlot& slot);
+  void closeClient(ClientSlot& slot);
+
+  /**
+   * Build the response of one complete request frame
+   * @return Response length in bytes
+   */
+  uint16_t handleRequest(const uint8_t* request, uint16_t length,
+                         uint8_t* response);
+  uint8_t readRegisters(uint8_t unitId, uint8_t functionCode,
+                        uint16_t address, uint16_t quantity, uint16_t* words);
+  uint16_t buildException(const uint8_t* request, uint8_t functionCode,
+                          uint8_t exceptionCode, uint8_t* response);
+};
+
+#endif  // MODBUS_TCP_SERVER_H
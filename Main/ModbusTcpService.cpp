@@ -2,22 +2,26 @@
 
 #include <WiFi.h>
 #include <byteswap.h>
+#include <esp_heap_caps.h>  // v1.3.3: Engine transaction slots (PSRAM)
+
+#include <algorithm>
 
-#include "CRUDHandler.h"
 #include "DebugConfig.h"  // MUST BE FIRST for DEV_SERIAL_* macros
+#include "AcquisitionCycle.h"  // v1.3.3: Aligned snapshot cycles
 #include "MemoryRecovery.h"
 #include "NetworkManager.h"
 #include "QueueManager.h"
 #include "RTCManager.h"
 #include "TCPClient.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+#include "TaskProfiler.h"  // v1.3.3: Pool lock wait profiling
+#include "TrendHistory.h"  // v1.3.3: On-device register history
 
 // v1.3.1: External reference to global BLE priority flag (defined in Main.ino)
 // When true, TCP polling should pause to give BLE highest priority
 #include <atomic>
 extern std::atomic<bool> g_bleCommandActive;
 
-extern CRUDHandler* crudHandler;
-
 // Atomic transaction counter initialization (thread-safe)
 std::atomic<uint16_t> ModbusTcpService::atomicTransactionCounter(1);
 
@@ -26,7 +30,8 @@ ModbusTcpService::ModbusTcpService(ConfigManager* config,
     : configManager(config),
       ethernetManager(ethernet),
       running(false),
-      tcpTaskHandle(nullptr) {
+      tcpTaskHandle(nullptr),
+      pollArena(ModbusTcpConfig::POLL_ARENA_SIZE) {
   // Initialize data transmission schedule
   dataTransmissionSchedule.lastTransmitted = 0;
   dataTransmissionSchedule.dataIntervalMs = 5000;  // Default 5 seconds
@@ -64,7 +69,40 @@ bool ModbusTcpService::init() {
 
   LOG_TCP_INFO("[TCP] Ethernet available: %s\n",
                ethernetManager->isAvailable() ? "YES" : "NO");
-  LOG_TCP_INFO("[TCP] Service initialized");
+
+  // v1.3.3: Transaction slots of the concurrent polling engine, and the
+  // connections they read through (receive buffers included, ~0.5KB each)
+  if (!transactions) {
+    transactions = (TcpTransaction*)heap_caps_calloc(
+        ModbusTcpConfig::MAX_CONCURRENT_DEVICES, sizeof(TcpTransaction),
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!transactions) {
+      transactions = (TcpTransaction*)heap_caps_calloc(
+          ModbusTcpConfig::MAX_CONCURRENT_DEVICES, sizeof(TcpTransaction),
+          MALLOC_CAP_8BIT);
+    }
+    if (!transactions) {
+      LOG_TCP_INFO("[TCP] ERROR: Failed to allocate transaction slots");
+      return false;
+    }
+  }
+  if (!connections) {
+    connections = (SharedConnection*)heap_caps_calloc(
+        ModbusTcpConfig::MAX_CONCURRENT_DEVICES, sizeof(SharedConnection),
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!connections) {
+      connections = (SharedConnection*)heap_caps_calloc(
+          ModbusTcpConfig::MAX_CONCURRENT_DEVICES, sizeof(SharedConnection),
+          MALLOC_CAP_8BIT);
+    }
+    if (!connections) {
+      LOG_TCP_INFO("[TCP] ERROR: Failed to allocate connection slots");
+      return false;
+    }
+  }
+
+  LOG_TCP_INFO("[TCP] Service initialized (max %d concurrent device reads)\n",
+               ModbusTcpConfig::MAX_CONCURRENT_DEVICES);
   return true;
 }
 
@@ -77,25 +115,23 @@ void ModbusTcpService::start() {
   }
 
   running = true;
-  BaseType_t result = xTaskCreatePinnedToCore(
+  // v1.3.3: Core / priority from TaskAffinity.h
+  BaseType_t result = TaskAffinity::create(
       readTcpDevicesTask, "MODBUS_TCP_TASK",
       12288,  // v1.0.6: Increased from 10KB to 12KB for handling 50+ registers
               // per device with safety margin
-      this, 2,
-      &tcpTaskHandle,  // Store the task handle
-      1);
+      this, TaskAffinity::Task::TCP_POLL,
+      &tcpTaskHandle);  // Store the task handle
 
   if (result == pdPASS) {
     LOG_TCP_INFO("[TCP] Service started successfully");
 
     // Start auto-recovery task
-    // MUST stay on Core 1: Modifies device status accessed by MODBUS_TCP_TASK
-    // (Core 1)
-    BaseType_t recoveryResult =
-        xTaskCreatePinnedToCore(autoRecoveryTask, "TCP_AUTO_RECOVERY", 4096,
-                                this, 1, &autoRecoveryTaskHandle,
-                                1);  // Core 1 (must stay with TCP polling task
-                                     // to avoid race conditions)
+    // MUST stay on the MODBUS_TCP_TASK core: Modifies device status accessed
+    // by MODBUS_TCP_TASK (TaskAffinity.h keeps the two together)
+    BaseType_t recoveryResult = TaskAffinity::create(
+        autoRecoveryTask, "TCP_AUTO_RECOVERY", 4096, this,
+        TaskAffinity::Task::TCP_AUTO_RECOVERY, &autoRecoveryTaskHandle);
 
     if (recoveryResult == pdPASS) {
       LOG_TCP_INFO("[TCP] Auto-recovery task started");
@@ -130,12 +166,18 @@ void ModbusTcpService::stop() {
   LOG_TCP_INFO("[TCP] Service stopped");
 }
 
-void ModbusTcpService::notifyConfigChange() {
+void ModbusTcpService::notifyConfigChange(const ModbusConfigChange& change) {
+  // v1.3.3: Record the changed device before raising the flag
+  portENTER_CRITICAL(&changeMux);
+  pendingChanges.add(change);
+  portEXIT_CRITICAL(&changeMux);
+
   // v2.5.39: Set atomic flag for reliable config change detection
   // This ensures config changes are detected even if task is blocked in TCP
   // operations
   configChangePending.store(true);
-  LOG_TCP_INFO("[TCP] Config change notified - flagged for refresh\n");
+  LOG_TCP_INFO("[TCP] Config change notified (%s) - flagged for refresh\n",
+               change.deviceId ? change.deviceId : "all devices");
 
   if (tcpTaskHandle != nullptr) {
     xTaskNotifyGive(tcpTaskHandle);
@@ -146,52 +188,191 @@ void ModbusTcpService::refreshDeviceList() {
   // FIXED ISSUE #1: Protect vector operations from race conditions
   xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
 
+  // v1.3.3: Devices named by the notified changes are rebuilt; the others
+  // are kept when their document is still the one in the generation
+  ModbusChangeSet changes;
+  portENTER_CRITICAL(&changeMux);
+  changes = pendingChanges;
+  pendingChanges.clear();
+  portEXIT_CRITICAL(&changeMux);
+  size_t rebuilt = 0;
+
   // v2.5.40 FIX: Close all pooled connections when config changes
   // This ensures clean reconnection when IP/port changes
   // Without this, old connections might linger and cause confusion
-  closeAllConnections();
+  // v1.3.3: Only for a full refresh; otherwise just the endpoints of
+  // rebuilt / removed devices are closed (below)
+  if (changes.isFull()) {
+    closeAllConnections();
+  }
 
-  LOG_TCP_INFO("[TCP Task] Refreshing device list (connections cleared)...");
-  tcpDevices.clear();  // FIXED Bug #2: Now safe - unique_ptr auto-deletes old
-                       // documents
+  LOG_TCP_INFO("[TCP Task] Refreshing device list...");
+  // v1.3.3: Build into a new vector; old documents/plans are released only
+  // after the PollPlanRegistry points at the new plans (queued binary records
+  // are resolved against them)
+  std::vector<TcpDeviceConfig> newDevices;
 
-  JsonDocument devicesIdList;
-  JsonArray deviceIds = devicesIdList.to<JsonArray>();
-  configManager->listDevices(deviceIds);
+  // v1.3.3: Hold the config generation for the whole refresh; device
+  // documents are shared with it (was listDevices() + readDevice() copying
+  // every device into the entry document)
+  ConfigManager::DevicesGenerationHandle generation =
+      configManager->getDevicesGeneration();
+  if (!generation) {
+    generation = std::make_shared<ConfigManager::DevicesGeneration>();
+  }
 
   unsigned long now = millis();
 
-  for (JsonVariant deviceIdVar : deviceIds) {
+  for (const ConfigManager::DeviceConfigEntry& device : generation->devices) {
     // v2.5.41: Use const char* to avoid String allocation (matches RTU service
     // pattern)
-    const char* deviceId = deviceIdVar.as<const char*>();
+    const char* deviceId = device.deviceId.c_str();
     if (!deviceId || strcmp(deviceId, "") == 0 || strcmp(deviceId, "{}") == 0 ||
         strlen(deviceId) < 3) {
       continue;
     }
 
-    JsonDocument tempDeviceDoc;
-    JsonObject deviceObj = tempDeviceDoc.to<JsonObject>();
-    if (configManager->readDevice(deviceId, deviceObj)) {
+    if (device.config) {
+      JsonObject deviceObj = device.config->as<JsonObject>();
       const char* protocol = deviceObj["protocol"] | "";
       if (strcmp(protocol, "TCP") == 0) {
+        // v1.3.3: Unchanged device - copy the entry (plan, deadline and
+        // failure / timeout / metrics state). Copied, not moved: the
+        // registry still points at the old plan until attach() below.
+        TcpDeviceConfig* old = findDevice(deviceId);
+        if (old && old->doc == device.config && !changes.isFull() &&
+            !changes.contains(deviceId)) {
+          newDevices.push_back(*old);
+          continue;
+        }
+
         TcpDeviceConfig newDeviceEntry;
-        newDeviceEntry.deviceId = deviceId;  // PSRAMString accepts const char*
-        newDeviceEntry.doc =
-            std::make_unique<JsonDocument>();  // FIXED Bug #2: Use smart
-                                               // pointer
-        newDeviceEntry.doc->set(deviceObj);
-        tcpDevices.push_back(std::move(newDeviceEntry));
+        newDeviceEntry.deviceId = device.deviceId;  // Same handle
+        newDeviceEntry.doc = device.config;
+
+        // v1.3.3: Compile register plan ONCE (polling loop no longer walks
+        // the JsonDocument). String pointers reference newDeviceEntry.doc
+        ModbusPollPlan::compile(newDeviceEntry.doc->as<JsonObject>(),
+                                newDeviceEntry.plan,
+                                ModbusSpanConfig::MAX_SPAN_REGISTERS,
+                                ModbusSpanConfig::MAX_SPAN_BITS);
+        // Keep the deadline across the refresh (new devices are due now)
+        newDeviceEntry.nextPollMs = old ? old->nextPollMs : now;
+        initializeDeviceState(newDeviceEntry);
+        newDevices.push_back(std::move(newDeviceEntry));
+        rebuilt++;
+      }
+    }
+  }
+
+  // v1.3.3: Bind compiled plans to registry slots (vector is final here)
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  uint32_t epoch = registry->beginRefresh();
+  for (auto& device : newDevices) {
+    registry->attach(PollPlanRegistry::OWNER_TCP, epoch, device.plan);
+  }
+  registry->endRefresh(PollPlanRegistry::OWNER_TCP, epoch);
+
+  // v1.3.3: Close the old endpoint of every rebuilt / removed device (its IP
+  // or port may have changed) unless a kept device still polls it
+  if (!changes.isFull()) {
+    for (const auto& oldDevice : tcpDevices) {
+      if (!oldDevice.doc) continue;
+      bool kept = false;
+      for (const auto& device : newDevices) {
+        if (device.doc == oldDevice.doc) {
+          kept = true;
+          break;
+        }
+      }
+      if (kept) continue;
+      JsonObject oldObj = oldDevice.doc->as<JsonObject>();
+      const char* ip = oldObj["ip"] | "";
+      int port = oldObj["port"] | 502;
+      bool shared = false;
+      for (const auto& device : newDevices) {
+        JsonObject other = device.doc->as<JsonObject>();
+        if (strcmp(ip, other["ip"] | "") == 0 &&
+            port == (other["port"] | 502)) {
+          shared = true;
+          break;
+        }
+      }
+      if (!shared) {
+        closeEndpointConnections(ip, port);
       }
     }
   }
-  LOG_TCP_INFO("[TCP Task] Found %d TCP devices. Schedule rebuilt.\n",
-               tcpDevices.size());
 
-  // Initialize device tracking after device list is loaded
-  initializeDeviceFailureTracking();
-  initializeDeviceTimeouts();
-  initializeDeviceMetrics();
+  // FIXED Bug #2: unique_ptr auto-deletes old documents
+  tcpDevices = std::move(newDevices);
+
+  // v1.3.3: Slots are the tcpDevices indices; the index is rebuilt with the
+  // list. State records travel with their entry (rebuilt devices were
+  // initialized above; replaces initializeDeviceFailureTracking /
+  // initializeDeviceTimeouts / initializeDeviceMetrics for all devices)
+  deviceIndex.reset(tcpDevices.size());
+  for (size_t i = 0; i < tcpDevices.size(); i++) {
+    deviceIndex.insert(tcpDevices[i].deviceId.c_str(), i);
+  }
+
+  // Aligned acquisition: kept and new deadlines move to a cycle boundary
+  AcquisitionCycle* cycle = AcquisitionCycle::getInstance();
+  schedule.clear();
+  schedule.reserve(tcpDevices.size());
+  for (size_t i = 0; i < tcpDevices.size(); i++) {
+    TcpDeviceConfig& device = tcpDevices[i];
+    device.nextPollMs =
+        cycle->align(device.plan.registrySlot, device.nextPollMs, millis());
+    schedule.schedule(i, device.nextPollMs, device.state.readMs);
+  }
+
+  // v1.3.3: Pool sizing - devices sharing an IP:port share one connection
+  // (and are marked sharedEndpoint, recomputed for kept entries as well).
+  // Endpoint load windows carry over by IP:port.
+  std::vector<EndpointLoad> endpoints;
+  poolEndpoints = 0;
+  for (TcpDeviceConfig& device : tcpDevices) {
+    device.sharedEndpoint = false;
+  }
+  for (size_t i = 0; i < tcpDevices.size(); i++) {
+    JsonObject deviceObj = tcpDevices[i].doc->as<JsonObject>();
+    const char* ip = deviceObj["ip"] | "";
+    int port = deviceObj["port"] | 502;
+    bool duplicate = false;
+    for (size_t j = 0; j < i; j++) {
+      JsonObject other = tcpDevices[j].doc->as<JsonObject>();
+      if (strcmp(ip, other["ip"] | "") == 0 && port == (other["port"] | 502)) {
+        if (!duplicate) {
+          tcpDevices[i].endpoint = tcpDevices[j].endpoint;
+        }
+        duplicate = true;
+        tcpDevices[i].sharedEndpoint = true;
+        tcpDevices[j].sharedEndpoint = true;
+      }
+    }
+    if (!duplicate) {
+      EndpointLoad load;
+      load.key = getDeviceKey(ip, port);
+      for (const EndpointLoad& previous : endpointLoads) {
+        if (previous.key == load.key) {
+          load.utilization = previous.utilization;
+          break;
+        }
+      }
+      tcpDevices[i].endpoint = endpoints.size();
+      endpoints.push_back(load);
+      if (poolEndpoints < 255) {
+        poolEndpoints++;
+      }
+    }
+  }
+  endpointLoads = std::move(endpoints);
+
+  LOG_TCP_INFO(
+      "[TCP Task] Found %d TCP devices (%d rebuilt, %d endpoints). Schedule "
+      "rebuilt.\n",
+      tcpDevices.size(), rebuilt, poolEndpoints);
 
   // FIXED ISSUE #1: Release vector mutex
   xSemaphoreGiveRecursive(vectorMutex);
@@ -300,74 +481,18 @@ void ModbusTcpService::readTcpDevicesLoop() {
     unsigned long currentTime = millis();
 
     // FIXED ISSUE #5 (REVISED): Non-blocking millis-based timing per device
-    // Loop runs continuously with SHORT delay, shouldPollDevice() handles
-    // per-device timing This allows independent refresh rates without blocking
-    // other devices
+    // v1.3.3: Due devices come from the deadline-ordered schedule
 
     // FIXED ISSUE #3: Use cached tcpDevices vector (eliminates file system
     // access) FIXED ISSUE #1: Protect vector iteration with mutex
     xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
 
-    for (auto& deviceEntry : tcpDevices) {
-      if (!running) {
-        xSemaphoreGiveRecursive(vectorMutex);
-        break;  // Exit if stopped
-      }
+    // v1.3.3: Concurrent engine - due devices are read in parallel, BLE
+    // activity or a config change aborts the pass (refresh at loop top)
+    pollDevicesConcurrently();
 
-      // v1.3.1: Check if BLE became active during iteration - abort polling
-      if (g_bleCommandActive.load()) {
-        LOG_TCP_DEBUG("[TCP] BLE command started - aborting device polling\n");
-        break;  // Exit device loop, will pause at top of while loop
-      }
-
-      // v2.5.39: Check for config changes during iteration using BOTH atomic
-      // flag AND task notification This catches config changes that occur while
-      // task is blocked in TCP connect/read operations
-      bool midLoopRefresh = configChangePending.exchange(false);
-      if (midLoopRefresh || ulTaskNotifyTake(pdTRUE, 0) > 0) {
-        LOG_TCP_INFO(
-            "[TCP] Config change during polling - refreshing immediately...\n");
-        xSemaphoreGiveRecursive(vectorMutex);
-        refreshDeviceList();
-        break;  // Exit current iteration, next iteration will use updated
-                // device list
-      }
-
-      // Use cached device data from tcpDevices vector
-      // v2.5.41: Use const char* instead of String (matches RTU service
-      // pattern)
-      const char* deviceId = deviceEntry.deviceId.c_str();
-      JsonObject deviceObj = deviceEntry.doc->as<JsonObject>();
-
-      // Get device refresh rate from BLE config
-      uint32_t deviceRefreshRate = deviceObj["refresh_rate_ms"] | 5000;
-
-      // Check if device's refresh interval has elapsed (millis-based,
-      // non-blocking) shouldPollDevice() uses per-device lastRead timestamp for
-      // accurate timing
-      if (shouldPollDevice(deviceId, deviceRefreshRate)) {
-        // CRITICAL FIX: Check if device is enabled before polling
-        if (!isDeviceEnabled(deviceId)) {
-          // Device is disabled, skip polling
-          static LogThrottle disabledThrottle(
-              30000);  // Log every 30s to reduce spam
-          char contextMsg[64];
-          snprintf(contextMsg, sizeof(contextMsg), "TCP Device %s disabled",
-                   deviceId);
-          if (disabledThrottle.shouldLog(contextMsg)) {
-            LOG_TCP_INFO("Device %s is disabled, skipping read\n", deviceId);
-          }
-          continue;  // Skip to next device
-        }
-
-        readTcpDeviceData(deviceObj);
-        // Device-level timing is updated inside readTcpDeviceData via
-        // updateDeviceLastRead()
-      }
-
-      // Feed watchdog between device reads
-      vTaskDelay(pdMS_TO_TICKS(10));
-    }
+    uint32_t waitMs =
+        schedule.waitTime(millis(), ModbusTcpConfig::MAX_IDLE_WAIT_MS);
 
     // FIXED ISSUE #1: Release vector mutex
     xSemaphoreGiveRecursive(vectorMutex);
@@ -380,12 +505,16 @@ void ModbusTcpService::readTcpDevicesLoop() {
       lastCleanup = millis();
     }
 
-    // FIXED ISSUE #5 (REVISED): Constant short delay (non-blocking approach)
-    // Loop runs every 100ms to check if any device is ready
-    // Per-device timing handled by shouldPollDevice() with millis()
-    // This allows accurate, independent timing for each device without blocking
-    // v1.0.6 OPTIMIZED: Increased from 100ms to 150ms for 33% context switch reduction
-    vTaskDelay(pdMS_TO_TICKS(150));
+    // v1.3.3: Sleep until the next device is due (was a fixed 150ms loop
+    // delay: up to 150ms jitter per poll, every device checked each loop).
+    // A config change notification ends the wait early.
+    if (waitMs > 0) {
+      if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0) {
+        configChangePending.store(true);  // Refresh at the top of the loop
+      }
+    } else {
+      vTaskDelay(1);  // Pass interrupted by BLE / config change: yield
+    }
   }
 
   // CRITICAL FIX: Task must self-delete when loop exits to prevent FreeRTOS
@@ -395,19 +524,152 @@ void ModbusTcpService::readTcpDevicesLoop() {
   vTaskDelete(NULL);        // Delete self (NULL = current task)
 }
 
-void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
+// ============================================================================
+// v1.3.3: CONCURRENT POLLING ENGINE
+// ============================================================================
+
+uint8_t ModbusTcpService::getConcurrencyLimit() const {
+  // Every read in flight holds one socket - scale down when internal RAM is
+  // short instead of running into the pool's emergency cleanup
+  size_t dramFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  uint32_t limit = 1;
+  if (dramFree > ModbusTcpConfig::DRAM_RESERVE) {
+    limit = (dramFree - ModbusTcpConfig::DRAM_RESERVE) /
+            ModbusTcpConfig::DRAM_PER_TRANSACTION;
+  }
+  if (limit < 1) {
+    limit = 1;
+  }
+  if (limit > ModbusTcpConfig::MAX_CONCURRENT_DEVICES) {
+    limit = ModbusTcpConfig::MAX_CONCURRENT_DEVICES;
+  }
+  return (uint8_t)limit;
+}
+
+void ModbusTcpService::pollDevicesConcurrently() {
+  // Caller holds vectorMutex: device entries and plans stay valid for the
+  // whole pass
+  if (!transactions || !connections) {
+    return;
+  }
+
+  uint8_t limit = getConcurrencyLimit();
+  updatePoolCapacity(limit);
+
+  // transactions[0..active) are in flight (member: shared connections look
+  // up their other users)
+  int& active = activeTransactions;
+  active = 0;
+
+  while (true) {
+    // v1.3.1: BLE priority / v2.5.39: config change - abort the pass.
+    // Outstanding requests leave their stream out of sync, so those
+    // connections are not reused.
+    if (!running || g_bleCommandActive.load() || configChangePending.load()) {
+      if (active > 0) {
+        LOG_TCP_DEBUG("[TCP] Polling interrupted - aborting %d device read(s)\n",
+                      active);
+      }
+      for (int i = 0; i < active; i++) {
+        TcpTransaction& txn = transactions[i];
+        if (txn.connection != NO_CONNECTION &&
+            (txn.phase == TransactionPhase::CONNECTING ||
+             txn.pendingCount > 0)) {
+          connections[txn.connection].healthy = false;
+        }
+        finishDeviceRead(txn);
+      }
+      active = 0;
+      return;
+    }
+
+    // Fill free slots with due devices, earliest deadline first
+    // v1.3.3: Devices sharing the IP:port of a read in flight join its
+    // connection. BUSY (connection held by a register write, or failed and
+    // not yet released) puts them back after this round, kept due.
+    PollSlot deferred[ModbusTcpConfig::MAX_CONCURRENT_DEVICES];
+    uint8_t deferredCount = 0;
+    PollSlot slot;
+    while (active < limit && deferredCount < limit &&
+           schedule.popDue(millis(), slot)) {
+      StartResult result = startDeviceRead(transactions[active], slot);
+      if (result == StartResult::STARTED) {
+        active++;
+      } else if (result == StartResult::BUSY && active > 0) {
+        deferred[deferredCount++] = slot;
+      } else if (result == StartResult::BUSY) {
+        // Held by a register write - retried shortly
+        uint32_t retryAt = millis() + ModbusTcpConfig::BUSY_RETRY_MS;
+        tcpDevices[slot.index].nextPollMs = retryAt;
+        schedule.schedule(slot.index, retryAt, slot.rank);
+      } else {
+        reschedule(slot, millis());  // Disabled / invalid config
+      }
+    }
+    for (uint8_t i = 0; i < deferredCount; i++) {
+      schedule.schedule(deferred[i].index, deferred[i].dueMs,
+                        deferred[i].rank);
+    }
+
+    if (active == 0) {
+      return;  // Pass complete
+    }
+
+    // One non-blocking step per transaction
+    bool progress = false;
+    for (int i = 0; i < active;) {
+      if (stepTransaction(transactions[i])) {
+        progress = true;
+      }
+      if (transactions[i].phase == TransactionPhase::DONE) {
+        finishDeviceRead(transactions[i]);
+        active--;
+        if (i != active) {
+          transactions[i] = transactions[active];  // Keep slots compact
+        }
+        progress = true;
+        continue;
+      }
+      i++;
+    }
+
+    if (!progress) {
+      waitForTransactions(transactions, active);
+    }
+  }
+}
+
+ModbusTcpService::StartResult ModbusTcpService::startDeviceRead(
+    TcpTransaction& txn, const PollSlot& slot) {
+  TcpDeviceConfig& device = tcpDevices[slot.index];
+  JsonObject deviceConfig = device.doc->as<JsonObject>();
+  CompiledDevicePlan& plan = device.plan;
+  const char* deviceId = device.deviceId.c_str();
+
+  // v1.3.3: Only due devices get here (PollScheduler, was shouldPollDevice())
+
+  // CRITICAL FIX: Check if device is enabled before polling
+  if (!isDeviceEnabled(device)) {
+    // Device is disabled, skip polling
+    static LogThrottle disabledThrottle(30000);  // Log every 30s to reduce spam
+    char contextMsg[64];
+    snprintf(contextMsg, sizeof(contextMsg), "TCP Device %s disabled",
+             deviceId);
+    if (disabledThrottle.shouldLog(contextMsg)) {
+      LOG_TCP_INFO("Device %s is disabled, skipping read\n", deviceId);
+    }
+    return StartResult::SKIPPED;
+  }
+
   // v2.5.41: Use const char* instead of String (matches RTU service pattern)
-  const char* deviceId = deviceConfig["device_id"] | "UNKNOWN";
   const char* ip = deviceConfig["ip"] | "";
   int port = deviceConfig["port"] | 502;
-  uint8_t slaveId = deviceConfig["slave_id"] | 1;
-  JsonArray registers = deviceConfig["registers"];
 
   // FIXED BUG #8: Validate IP address format before use
   // Previous code only checked isEmpty() → invalid IPs like "999.999.999.999"
   // passed!
-  if (!ip || strlen(ip) == 0 || registers.size() == 0) {
-    return;
+  if (!ip || strlen(ip) == 0 || plan.registers.size() == 0) {
+    return StartResult::SKIPPED;
   }
 
   // Validate IP address format using IPAddress::fromString()
@@ -423,29 +685,609 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
           "[TCP] HINT: IP must be in format A.B.C.D where 0 <= A,B,C,D <= 255");
       lastWarning = millis();
     }
-    return;  // Skip device with invalid IP
+    return StartResult::SKIPPED;  // Skip device with invalid IP
+  }
+
+  txn.device = &device;
+  txn.slot = slot;
+  txn.startedAt = millis();
+  txn.ip = ip;
+  txn.port = port;
+  txn.depth = plan.pipelineDepth;
+
+  // FIXED ISSUE #2: Get pooled connection ONCE for all registers (eliminates
+  // repeated handshakes). v1.3.3: New connections are started non-blocking and
+  // completed by the engine (CONNECTING phase); a connection already in use
+  // by another unit behind the same gateway is joined
+  bool busy = false;
+  bool connected = acquireConnection(txn, &busy);
+  if (!connected && busy) {
+    return StartResult::BUSY;
+  }
+  TCPClient* client = txn.client;
+
+  LOG_TCP_VERBOSE("[TCP] Polling device %s at %s:%d (unit %d)\n", deviceId,
+                  ip, port, plan.slaveId);
+
+  txn.lastSendSeq = 0;
+  txn.nextSpan = 0;
+  txn.fallbackSpan = 0;
+  txn.fallbackNext = -1;
+  txn.fallbackCount = 0;
+  txn.pendingCount = 0;
+  txn.phaseStart = millis();
+
+  // ============================================================================
+  // v1.3.3: BLOCK-READ PLANNING (shared planner with RTU, see ModbusUtils)
+  // ============================================================================
+  // Previous: One MBAP transaction per register (100 tags = 100 round-trips,
+  // each with its own send/wait loop)
+  // New: Adjacent addresses with the same FC are merged into one request of up
+  // to 125 words / 2000 bits. Per-device "max_gap" lets small unused holes be
+  // read through instead of splitting the request (100 tags = 2-3 requests).
+  // Spans are planned once in refreshDeviceList() (ModbusPollPlan::compile)
+  plan.resetSlots();
+
+  LOG_TCP_VERBOSE("Device %s: %d registers -> %d block read(s), depth %d\n",
+                  deviceId, plan.items.size(), plan.spans.size(), txn.depth);
+
+  if (!client) {
+    LOG_TCP_INFO("[TCP] ERROR: Failed to get pooled connection for %s:%d\n", ip,
+                 port);
+    failDeviceRead(txn);
+  } else if (plan.spans.empty()) {
+    txn.phase = TransactionPhase::DONE;
+  } else {
+    txn.phase = client->isConnecting() ? TransactionPhase::CONNECTING
+                                       : TransactionPhase::TRANSFER;
+  }
+  return StartResult::STARTED;
+}
+
+bool ModbusTcpService::stepTransaction(TcpTransaction& txn) {
+  switch (txn.phase) {
+    case TransactionPhase::CONNECTING: {
+      int state = txn.client->pollConnect();
+      if (state == 0) {
+        if ((millis() - txn.phaseStart) < ModbusTcpConfig::CONNECT_TIMEOUT_MS) {
+          return false;
+        }
+        state = -1;
+      }
+      if (state < 0) {
+        LOG_TCP_INFO("[TCP] Failed to connect to %s:%d\n", txn.ip, txn.port);
+        failConnection(txn.connection);
+        return true;
+      }
+      txn.phase = TransactionPhase::TRANSFER;
+      return true;
+    }
+
+    case TransactionPhase::TRANSFER: {
+      bool progress = false;
+
+      // Keep the pipeline full: up to depth requests outstanding (v1.3.3:
+      // on a shared connection, in turn with the other units)
+      while (canSendRequest(txn)) {
+        if (!sendNextRequest(txn)) {
+          LOG_TCP_INFO("[TCP] Request write failed for %s:%d\n", txn.ip,
+                       txn.port);
+          failConnection(txn.connection);
+          return true;
+        }
+        progress = true;
+      }
+
+      if (receiveResponses(txn)) {
+        progress = true;
+      }
+      if (txn.phase != TransactionPhase::TRANSFER) {
+        return true;  // Device failed while parsing
+      }
+
+      if (txn.pendingCount == 0) {
+        if (!hasPendingWork(txn)) {
+          txn.phase = TransactionPhase::DONE;
+          return true;
+        }
+        return progress;  // Fallback queued / waiting for its turn
+      }
+
+      // FIXED Bug #11: Safe time comparison to handle millis() wraparound
+      // Requests are answered in order by almost every server, so the oldest
+      // outstanding request times out first
+      const PipelinedRequest& oldest = txn.pending[0];
+      if ((millis() - oldest.sentAt) >= ModbusTcpConfig::TIMEOUT_MS) {
+        LOG_TCP_INFO("[TCP] Response timeout for %s:%d unit %d (FC%d x%d)\n",
+                     txn.ip, txn.port, txn.device->plan.slaveId,
+                     oldest.functionCode, oldest.quantity);
+        txn.device->state.metrics.recordRead(false);
+
+        // v1.3.3: Behind a gateway, a reply to another unit since this
+        // request was sent means the gateway is alive and this unit is not
+        // answering - only this unit fails. A late reply is dropped as
+        // unmatched, so the shared stream stays in sync.
+        const SharedConnection& conn = connections[txn.connection];
+        if (txn.device->sharedEndpoint && conn.anyFrame &&
+            (long)(conn.lastFrameAt - oldest.sentAt) >= 0) {
+          failDeviceRead(txn);
+        } else {
+          failConnection(txn.connection);
+        }
+        return true;
+      }
+      return progress;
+    }
+
+    default:
+      return false;
+  }
+}
+
+bool ModbusTcpService::hasPendingWork(const TcpTransaction& txn) const {
+  return txn.fallbackNext >= 0 || txn.fallbackCount > 0 ||
+         txn.nextSpan < txn.device->plan.spans.size();
+}
+
+bool ModbusTcpService::acquireConnection(TcpTransaction& txn, bool* busy) {
+  txn.connection = NO_CONNECTION;
+  txn.client = nullptr;
+
+  // v1.3.3: Another unit behind the same gateway is being read - share its
+  // socket (the pool hands out one connection per IP:port)
+  for (uint8_t c = 0; c < ModbusTcpConfig::MAX_CONCURRENT_DEVICES; c++) {
+    SharedConnection& conn = connections[c];
+    if (conn.client && conn.healthy && conn.port == txn.port &&
+        strcmp(conn.ip, txn.ip) == 0) {
+      conn.users++;
+      if (txn.depth < conn.depth) {
+        conn.depth = txn.depth;
+      }
+      txn.connection = c;
+      txn.client = conn.client;
+      return true;
+    }
   }
 
-  // Determine network type for log
-  const char* networkType = "TCP/WiFi";  // Default assume WiFi
-  NetworkMgr* networkMgr = NetworkMgr::getInstance();
-  if (networkMgr) {
-    String currentMode = networkMgr->getCurrentMode();
-    if (currentMode == "ETH") {
-      networkType = "TCP/ETH";
+  TCPClient* client = getPooledConnection(
+      txn.ip, txn.port, true, busy, txn.device->plan.refreshRateMs);
+  if (!client) {
+    return false;
+  }
+
+  // At most one connection per transaction slot, so a free one exists
+  for (uint8_t c = 0; c < ModbusTcpConfig::MAX_CONCURRENT_DEVICES; c++) {
+    SharedConnection& conn = connections[c];
+    if (conn.client) {
+      continue;
     }
+    conn.client = client;
+    conn.ip = txn.ip;
+    conn.port = txn.port;
+    conn.users = 1;
+    conn.endpoint = txn.device->endpoint;
+    conn.busySince = micros();
+    conn.depth = txn.depth;
+    conn.sendSeq = 0;
+    conn.lastFrameAt = 0;
+    conn.anyFrame = false;
+    conn.healthy = true;
+    conn.received = 0;
+    txn.connection = c;
+    txn.client = client;
+    return true;
   }
 
-  LOG_TCP_VERBOSE("[%s] Polling device %s at %s:%d\n", networkType, deviceId,
-                  ip, port);
+  returnPooledConnection(txn.ip, txn.port, client, true);
+  return false;
+}
+
+void ModbusTcpService::releaseConnection(TcpTransaction& txn) {
+  if (txn.connection == NO_CONNECTION) {
+    return;
+  }
+  SharedConnection& conn = connections[txn.connection];
+  txn.connection = NO_CONNECTION;
+  txn.client = nullptr;
+  if (--conn.users > 0) {
+    return;  // Still read by other units
+  }
+  // v1.3.3: Endpoint busy from the first user's acquire to the last release
+  if (conn.endpoint < endpointLoads.size()) {
+    endpointLoads[conn.endpoint].utilization.record(micros() - conn.busySince,
+                                                    millis());
+  }
+
+  // FIXED ISSUE #2: Return connection to pool (mark as healthy/unhealthy for
+  // reuse decision) If connection was unhealthy, pool will close it. If
+  // healthy, pool keeps it for next device.
+  returnPooledConnection(conn.ip, conn.port, conn.client, conn.healthy);
+  LOG_TCP_INFO("[TCP] Returned pooled connection for %s:%d (healthy: %s)\n",
+               conn.ip, conn.port, conn.healthy ? "YES" : "NO");
+  conn.client = nullptr;
+}
+
+uint8_t ModbusTcpService::outstandingRequests(uint8_t connection) const {
+  uint8_t count = 0;
+  for (int i = 0; i < activeTransactions; i++) {
+    if (transactions[i].connection == connection) {
+      count += transactions[i].pendingCount;
+    }
+  }
+  return count;
+}
+
+bool ModbusTcpService::canSendRequest(const TcpTransaction& txn) const {
+  if (txn.pendingCount >= txn.depth || !hasPendingWork(txn)) {
+    return false;
+  }
+  const SharedConnection& conn = connections[txn.connection];
+  if (conn.users == 1) {
+    return true;
+  }
+  if (outstandingRequests(txn.connection) >= conn.depth) {
+    return false;
+  }
+
+  // Round-robin: the unit that sent least recently goes first, so one
+  // device's many spans cannot starve the others behind the gateway
+  for (int i = 0; i < activeTransactions; i++) {
+    const TcpTransaction& other = transactions[i];
+    if (&other == &txn || other.connection != txn.connection ||
+        other.phase != TransactionPhase::TRANSFER ||
+        other.pendingCount >= other.depth || !hasPendingWork(other)) {
+      continue;
+    }
+    if (other.lastSendSeq < txn.lastSendSeq ||
+        (other.lastSendSeq == txn.lastSendSeq && &other < &txn)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ModbusTcpService::TcpTransaction* ModbusTcpService::findRequestOwner(
+    uint8_t connection, uint16_t transId, uint8_t* index) {
+  for (int i = 0; i < activeTransactions; i++) {
+    TcpTransaction& txn = transactions[i];
+    if (txn.connection != connection) {
+      continue;
+    }
+    for (uint8_t p = 0; p < txn.pendingCount; p++) {
+      if (txn.pending[p].transId == transId) {
+        *index = p;
+        return &txn;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool ModbusTcpService::sendNextRequest(TcpTransaction& txn) {
+  CompiledDevicePlan& plan = txn.device->plan;
+
+  // Per-register re-reads of rejected spans go first. No new span is started
+  // while one is queued, which bounds fallbackQueue by the pipeline depth.
+  if (txn.fallbackNext < 0 && txn.fallbackCount > 0) {
+    txn.fallbackSpan = txn.fallbackQueue[0];
+    txn.fallbackNext = 0;
+    txn.fallbackCount--;
+    memmove(txn.fallbackQueue, txn.fallbackQueue + 1,
+            txn.fallbackCount * sizeof(txn.fallbackQueue[0]));
+  }
+
+  PipelinedRequest& request = txn.pending[txn.pendingCount];
+  uint16_t address;
+  if (txn.fallbackNext >= 0) {
+    const ModbusReadSpan& span = plan.spans[txn.fallbackSpan];
+    const ModbusPollItem& item = plan.items[span.firstItem + txn.fallbackNext];
+    request.spanIndex = txn.fallbackSpan;
+    request.item = txn.fallbackNext;
+    request.functionCode = item.functionCode;
+    request.quantity = item.width;
+    address = item.address;
+    if (++txn.fallbackNext >= (int16_t)span.itemCount) {
+      txn.fallbackNext = -1;
+    }
+  } else {
+    const ModbusReadSpan& span = plan.spans[txn.nextSpan];
+    request.spanIndex = txn.nextSpan++;
+    request.item = -1;
+    request.functionCode = span.functionCode;
+    request.quantity = span.quantity;
+    address = span.startAddress;
+  }
+
+  uint8_t frame[ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE];
+  request.transId = getNextTransactionId();
+  buildModbusRequest(frame, request.transId, plan.slaveId,
+                     request.functionCode, address, request.quantity);
+  request.sentAt = millis();
+  txn.pendingCount++;
+  txn.lastSendSeq = ++connections[txn.connection].sendSeq;
+
+  return txn.client->write(frame, ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE) ==
+         ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE;
+}
+
+bool ModbusTcpService::receiveResponses(TcpTransaction& txn) {
+  // v1.3.3: Reads frames for every unit on the connection - each reply is
+  // dispatched to the transaction that owns its transaction ID
+  SharedConnection& conn = connections[txn.connection];
+  bool progress = false;
+
+  while (conn.healthy && outstandingRequests(txn.connection) > 0) {
+    // Frame length from the MBAP header: 6 bytes + length field. Never
+    // reads past the frame, the next reply stays in the socket.
+    uint16_t frameLength = 6;
+    if (conn.received >= 6) {
+      frameLength += ((uint16_t)conn.response[4] << 8) | conn.response[5];
+    }
+
+    int available = conn.client->available();
+    if (available <= 0) {
+      break;
+    }
+
+    size_t wanted = frameLength - conn.received;
+    if ((size_t)available < wanted) {
+      wanted = available;
+    }
+    int bytesRead = conn.client->read(conn.response + conn.received, wanted);
+    if (bytesRead <= 0) {
+      break;
+    }
+    conn.received += bytesRead;
+    progress = true;
+
+    if (conn.received == 6) {
+      uint16_t protocolId =
+          ((uint16_t)conn.response[2] << 8) | conn.response[3];
+      uint16_t length = ((uint16_t)conn.response[4] << 8) | conn.response[5];
+      if (protocolId != 0 || length < 3 ||
+          6 + length > (int)sizeof(conn.response)) {
+        // Not a Modbus TCP frame = stream out of sync
+        LOG_TCP_WARN("Invalid MBAP header from %s:%d (length %u)\n", conn.ip,
+                     conn.port, length);
+        failConnection(txn.connection);
+        return true;
+      }
+      continue;
+    }
+    if (conn.received < frameLength) {
+      continue;
+    }
+
+    // Complete frame - match it to an outstanding request by transaction ID
+    uint16_t respTransId =
+        ((uint16_t)conn.response[0] << 8) | conn.response[1];
+    conn.received = 0;
+    conn.lastFrameAt = millis();
+    conn.anyFrame = true;
+
+    uint8_t match = 0;
+    TcpTransaction* owner =
+        findRequestOwner(txn.connection, respTransId, &match);
+    if (!owner) {
+      // Stale reply (framing intact, e.g. late answer of a unit that timed
+      // out) - drop it and keep reading
+      LOG_TCP_WARN("Unmatched transaction ID %u from %s:%d\n", respTransId,
+                   conn.ip, conn.port);
+      continue;
+    }
+
+    PipelinedRequest request = owner->pending[match];
+    owner->pendingCount--;
+    memmove(&owner->pending[match], &owner->pending[match + 1],
+            (owner->pendingCount - match) * sizeof(PipelinedRequest));
+
+    if (conn.response[6] != owner->device->plan.slaveId) {
+      LOG_TCP_DEBUG("Reply unit %d for unit %d from %s:%d\n", conn.response[6],
+                    owner->device->plan.slaveId, conn.ip, conn.port);
+    }
+
+    uint8_t exceptionCode = 0;
+    bool success = parseMultiModbusResponse(conn.response, frameLength,
+                                            request.functionCode,
+                                            request.quantity, conn.words,
+                                            &exceptionCode);
+    if (!success && exceptionCode == 0) {
+      LOG_TCP_WARN("Unexpected response for %s:%d unit %d (FC%d, %d bytes)\n",
+                   conn.ip, conn.port, owner->device->plan.slaveId,
+                   conn.response[7], conn.response[8]);
+    }
+    recordResponse(*owner, request, success);
+    completeRequest(*owner, request, success, exceptionCode);
+  }
+  return progress;
+}
+
+void ModbusTcpService::completeRequest(TcpTransaction& txn,
+                                       const PipelinedRequest& request,
+                                       bool success, uint8_t exceptionCode) {
+  CompiledDevicePlan& plan = txn.device->plan;
+  const ModbusReadSpan& span = plan.spans[request.spanIndex];
+  const uint16_t* words = connections[txn.connection].words;
+
+  // v1.3.3: Gateway exceptions (0x0A path unavailable, 0x0B target device
+  // failed to respond) are about the unit, not the register map - fail the
+  // unit without per-register fallback reads
+  if (exceptionCode == 0x0A || exceptionCode == 0x0B) {
+    LOG_TCP_DEBUG("Device %s: Gateway exception 0x%02X for unit %d\n",
+                  plan.deviceId, exceptionCode, plan.slaveId);
+    failDeviceRead(txn);
+    return;
+  }
+
+  // v1.3.3: Timestamps come from the RTCManager fast clock, read once per
+  // span response (was one RTC I2C transaction per stored register)
+  RTCManager* rtcMgr = RTCManager::getInstance();
+
+  if (request.item < 0) {
+    if (success) {
+      uint32_t spanTime = rtcMgr ? rtcMgr->getUnixTime() : 0;
+      for (uint16_t i = 0; i < span.itemCount; i++) {
+        const ModbusPollItem& item = plan.items[span.firstItem + i];
+        uint16_t offset = item.address - span.startAddress;
+        uint16_t* slot = &plan.slotWords[item.index * 4];
+
+        if (span.functionCode <= 2) {
+          slot[0] = ModbusUtils::extractBit(words, offset) ? 1 : 0;
+        } else {
+          memcpy(slot, &words[offset], item.width * sizeof(uint16_t));
+        }
+        plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::OK;
+        plan.slotTime[item.index] = spanTime;
+      }
+      return;
+    }
+
+    if (exceptionCode != 0 && span.itemCount > 1) {
+      // Span rejected with a Modbus exception (typically 0x02 Illegal Data
+      // Address when a gap or map boundary is inside the span). Connection is
+      // still in sync, re-read the span's registers one by one.
+      LOG_TCP_DEBUG(
+          "Device %s: Block read FC%d @%d x%d exception 0x%02X, falling "
+          "back to per-register reads\n",
+          plan.deviceId, span.functionCode, span.startAddress, span.quantity,
+          exceptionCode);
+      txn.fallbackQueue[txn.fallbackCount++] = request.spanIndex;
+      return;
+    }
+
+    for (uint16_t i = 0; i < span.itemCount; i++) {
+      plan.slotStatus[plan.items[span.firstItem + i].index] =
+          (uint8_t)PollSlotStatus::FAILED;
+    }
+  } else {
+    const ModbusPollItem& item = plan.items[span.firstItem + request.item];
+    if (success) {
+      uint16_t* slot = &plan.slotWords[item.index * 4];
+      if (item.functionCode <= 2) {
+        slot[0] = words[0] & 0x01;
+      } else {
+        memcpy(slot, words, item.width * sizeof(uint16_t));
+      }
+      plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::OK;
+      plan.slotTime[item.index] = rtcMgr ? rtcMgr->getUnixTime() : 0;
+      return;
+    }
+    plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::FAILED;
+  }
+
+  if (exceptionCode == 0) {
+    // FIXED ISSUE #2: Mark connection as unhealthy on read failure
+    // v1.3.3: After a malformed reply the device is treated as unreachable -
+    // the remaining spans are marked failed instead of paying TIMEOUT_MS for
+    // each. The MBAP framing is intact, so behind a gateway the other units
+    // keep the connection.
+    if (txn.device->sharedEndpoint) {
+      failDeviceRead(txn);
+    } else {
+      failConnection(txn.connection);
+    }
+  }
+}
+
+void ModbusTcpService::recordResponse(TcpTransaction& txn,
+                                      const PipelinedRequest& request,
+                                      bool success) {
+  // Latency = request written -> reply frame complete (includes the wait
+  // behind earlier requests of the same pipeline)
+  uint32_t latencyMs = millis() - request.sentAt;
+  if (latencyMs > 0xFFFF) latencyMs = 0xFFFF;
+  txn.device->state.metrics.recordRead(success,
+                                       success ? (uint16_t)latencyMs : 0);
+  if (success) {
+    busLatency.record(latencyMs);
+  }
+}
+
+void ModbusTcpService::failDeviceRead(TcpTransaction& txn) {
+  // Every item not answered yet (outstanding, queued for fallback or never
+  // sent) is marked failed. Already stored results are kept.
+  CompiledDevicePlan& plan = txn.device->plan;
+  for (const ModbusPollItem& item : plan.items) {
+    if (plan.slotStatus[item.index] == (uint8_t)PollSlotStatus::NOT_READ) {
+      plan.slotStatus[item.index] = (uint8_t)PollSlotStatus::FAILED;
+    }
+  }
+  txn.nextSpan = plan.spans.size();
+  txn.fallbackNext = -1;
+  txn.fallbackCount = 0;
+  txn.pendingCount = 0;
+  txn.phase = TransactionPhase::DONE;
+}
+
+void ModbusTcpService::failConnection(uint8_t connection) {
+  // Socket fault (connect / write failure, stream out of sync, silent
+  // gateway): every unit reading through it fails, the pool closes it
+  connections[connection].healthy = false;
+  for (int i = 0; i < activeTransactions; i++) {
+    TcpTransaction& txn = transactions[i];
+    if (txn.connection == connection &&
+        txn.phase != TransactionPhase::DONE) {
+      failDeviceRead(txn);
+    }
+  }
+}
+
+void ModbusTcpService::waitForTransactions(TcpTransaction* active,
+                                           int count) {
+  // v1.3.3: select() readiness wait over every socket in flight (response
+  // data or connect completion). W5500 sockets have no descriptor - those
+  // passes poll available() every READINESS_WAIT_MS instead.
+  fd_set readSet;
+  fd_set writeSet;
+  FD_ZERO(&readSet);
+  FD_ZERO(&writeSet);
+  int maxFd = -1;
+
+  for (int i = 0; i < count; i++) {
+    TcpTransaction& txn = active[i];
+    if (txn.phase != TransactionPhase::CONNECTING && txn.pendingCount == 0) {
+      continue;
+    }
+    int fd = txn.client ? txn.client->fd() : -1;
+    if (fd < 0) {
+      maxFd = -1;
+      break;
+    }
+    FD_SET(fd, txn.phase == TransactionPhase::CONNECTING ? &writeSet
+                                                         : &readSet);
+    if (fd > maxFd) {
+      maxFd = fd;
+    }
+  }
+
+  if (maxFd < 0) {
+    vTaskDelay(pdMS_TO_TICKS(ModbusTcpConfig::READINESS_WAIT_MS));
+    return;
+  }
+
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = ModbusTcpConfig::READINESS_WAIT_MS * 1000;
+  select(maxFd + 1, &readSet, &writeSet, nullptr, &tv);
+}
+
+void ModbusTcpService::finishDeviceRead(TcpTransaction& txn) {
+  TcpDeviceConfig& device = *txn.device;
+  CompiledDevicePlan& plan = device.plan;
+
+  const char* deviceId = device.deviceId.c_str();
+  const char* ip = txn.ip;
+  int port = txn.port;
+  uint8_t slaveId = plan.slaveId;
+  size_t registerTotal = plan.registers.size();
 
   // OPTIMIZED: Get device_name once per device cycle (not per register)
-  // v2.5.41: Use const char* instead of String
-  const char* deviceName = deviceConfig["device_name"] | "";
+  // v1.3.3: Resolved at compile time (plan.deviceName)
+  const char* deviceName = plan.deviceName;
 
   // Track register read results (for End-of-Batch Marker)
   uint8_t successRegisterCount = 0;
-  uint8_t failedRegisterCount = 0;
+  uint8_t failedRegisterCount = plan.invalidCount;  // Address overflow
 
   // COMPACT LOGGING: Buffer all output for atomic printing (prevent
   // interruption by other tasks) v2.5.41: Use PSRAMString instead of String
@@ -454,14 +1296,23 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
   PSRAMString compactLine = "";
   int successCount = 0;
   int lineNumber = 1;
-
-  // Development mode: Collect polled data in JSON format for debugging (always
-  // compiled, runtime-checked)
-  SpiRamJsonDocument polledDataDoc;
+  // v1.3.3: The compact [DATA] line is only built if LOG_DATA_DEBUG is
+  // compiled in and enabled (was built on every poll and then dropped)
+  const bool buildDataLog =
+      logCompiled(LOG_LEVEL_DATA, LOG_DEBUG) && LOG_CHECK(LOG_DEBUG);
+
+  // Development mode: Collect polled data in JSON format for debugging
+  // v1.3.3: Compiled out with LOG_LEVEL_TCP below LOG_INFO (production
+  // build), runtime-checked otherwise (was always compiled)
+  const bool collectPolledData =
+      logCompiled(LOG_LEVEL_TCP, LOG_INFO) && IS_DEV_MODE();
+  // v1.3.3: From the read arena, released before the next device read
+  pollArena.reset();
+  SpiRamJsonDocument polledDataDoc(&pollArena);
   JsonObject polledData;
   JsonArray polledRegisters;
 
-  if (IS_DEV_MODE()) {
+  if (collectPolledData) {
     polledData = polledDataDoc.to<JsonObject>();
     polledData["device_id"] = deviceId;
     polledData["device_name"] = deviceName;
@@ -473,196 +1324,59 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
     polledRegisters = polledData["registers"].to<JsonArray>();
   }
 
-  // FIXED ISSUE #2: Get pooled connection ONCE for all registers (eliminates
-  // repeated handshakes) Instead of Connect->Read->Disconnect per register, we
-  // now Connect->Read all->Disconnect
-  TCPClient* pooledClient = getPooledConnection(ip, port);
-  bool connectionHealthy =
-      (pooledClient != nullptr && pooledClient->connected());
+  // Decode and store in config order (payload ordering unchanged)
+  // v1.3.3: One batch decode over all slots (calibration included, see
+  // ModbusUtils::decodeSpan), then store per register
+  ModbusPollPlan::decodeSlots(plan);
+  for (uint16_t slotIndex = 0; slotIndex < registerTotal; slotIndex++) {
+    PollSlotStatus status = (PollSlotStatus)plan.slotStatus[slotIndex];
+    if (status == PollSlotStatus::NOT_READ) {
+      continue;  // Invalid FC, address overflow, or read aborted
+    }
 
-  if (!connectionHealthy) {
-    LOG_TCP_INFO("[TCP] ERROR: Failed to get pooled connection for %s:%d\n", ip,
-                 port);
-    // Continue without pooling (fallback to per-register connections)
-    pooledClient = nullptr;
-  }
+    const CompiledRegister& reg = plan.registers[slotIndex];
 
-  for (JsonVariant regVar : registers) {
-    if (!running) break;
+    if (status == PollSlotStatus::FAILED) {
+      // v2.5.35: Use DEV_MODE check to prevent log leak in production
+      DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, reg.name);
+      failedRegisterCount++;
+      continue;
+    }
 
-    // v2.5.41: Check for config changes DURING register iteration
-    // CRITICAL FIX: Without this, 45 registers × 3s timeout = 135 second delay
-    // before config refresh With this check, config changes are detected within
-    // 1 register poll cycle (~3s max)
-    if (configChangePending.load()) {
-      LOG_TCP_INFO(
-          "[TCP] Config change during register polling - aborting device "
-          "read...\n");
-      break;  // Exit register loop immediately, let device loop handle refresh
-    }
-
-    JsonObject reg = regVar.as<JsonObject>();
-    uint8_t functionCode = reg["function_code"] | 3;
-    uint16_t address = reg["address"] | 0;
-    // STRING OPTIMIZATION (v2.3.8): Use const char* instead of String to reduce
-    // DRAM fragmentation
-    const char* registerName = reg["register_name"] | "Unknown";
-
-    if (functionCode == 1 || functionCode == 2) {
-      // Read coils/discrete inputs
-      bool result = false;
-      // FIXED ISSUE #2: Pass pooled connection to eliminate per-register TCP
-      // handshakes
-      if (readModbusCoil(ip, port, slaveId, address, &result, pooledClient)) {
-        float value = result ? 1.0 : 0.0;
-
-        // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
-        // failures
-        bool storeSuccess =
-            storeRegisterValue(deviceId, reg, value, deviceName);
-
-        // Track result for End-of-Batch Marker
-        if (storeSuccess) {
-          successRegisterCount++;
-        } else {
-          failedRegisterCount++;  // Failure: queue full or memory exhausted
-        }
+    // v1.3.3: Decoded + calibrated by decodeSlots() above
+    double value = plan.slotValues[slotIndex];
 
-        // FIXED ISSUE #4: Use helper function to eliminate code duplication (FC
-        // 1/2) STRING OPTIMIZATION (v2.3.8): Use const char* instead of String
-        const char* unit = reg["unit"] | "";
-        appendRegisterToLog(registerName, value, unit, deviceId, outputBuffer,
-                            compactLine, successCount, lineNumber);
-
-        // Add to JSON debug output (runtime check)
-        if (IS_DEV_MODE()) {
-          JsonObject regObj = polledRegisters.add<JsonObject>();
-          regObj["name"] = registerName;
-          regObj["address"] = address;
-          regObj["function_code"] = functionCode;
-          regObj["value"] = value;
-          if (strlen(unit) > 0) regObj["unit"] = unit;
-        }
-      } else {
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, registerName);
-        failedRegisterCount++;
+    // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
+    // failures
+    bool storeSuccess =
+        storeRegisterValue(plan, slotIndex, value, plan.slotTime[slotIndex]);
 
-        // FIXED ISSUE #2: Mark connection as unhealthy on read failure
-        connectionHealthy = false;
-      }
+    // Track result for End-of-Batch Marker
+    if (storeSuccess) {
+      successRegisterCount++;
     } else {
-      // Read registers
-      // STRING OPTIMIZATION (v2.3.8): Use const char* + manual uppercase (like
-      // RTU service does)
-      const char* dataType = reg["data_type"] | "UINT16";
-      char dataTypeBuf[32];
-      strncpy(dataTypeBuf, dataType, sizeof(dataTypeBuf) - 1);
-      dataTypeBuf[sizeof(dataTypeBuf) - 1] = '\0';
-
-      // Manual uppercase conversion
-      for (int i = 0; dataTypeBuf[i]; i++) {
-        dataTypeBuf[i] = toupper(dataTypeBuf[i]);
-      }
-
-      int registerCount = 1;
-      const char* baseType = dataTypeBuf;
-      const char* endianness_variant = "";
-
-      // Extract baseType and endianness variant
-      char* underscorePos = strchr(dataTypeBuf, '_');
-      if (underscorePos != NULL) {
-        *underscorePos = '\0';  // Split string at underscore
-        baseType = dataTypeBuf;
-        endianness_variant = underscorePos + 1;
-      }
-
-      // Determine register count based on base type
-      // v2.5.41: Use strcmp() instead of == for const char* comparison
-      if (strcmp(baseType, "INT32") == 0 || strcmp(baseType, "UINT32") == 0 ||
-          strcmp(baseType, "FLOAT32") == 0) {
-        registerCount = 2;
-      } else if (strcmp(baseType, "INT64") == 0 ||
-                 strcmp(baseType, "UINT64") == 0 ||
-                 strcmp(baseType, "DOUBLE64") == 0) {
-        registerCount = 4;
-      }
-
-      // FIXED Bug #8: Validate address range doesn't overflow uint16_t address
-      // space
-      if (address > (65535 - registerCount + 1)) {
-        // STRING OPTIMIZATION (v2.3.8): registerName already const char*, no
-        // .c_str() needed
-        LOG_TCP_INFO(
-            "[TCP] ERROR: Address range overflow for %s (addr=%d, count=%d, "
-            "max=%d)\n",
-            registerName, address, registerCount, address + registerCount - 1);
-        failedRegisterCount++;
-
-        continue;  // Skip this register
-      }
-
-      uint16_t results[4];
-      // FIXED ISSUE #2: Pass pooled connection to eliminate per-register TCP
-      // handshakes
-      if (readModbusRegisters(ip, port, slaveId, functionCode, address,
-                              registerCount, results, pooledClient)) {
-        // STRING OPTIMIZATION (v2.3.8): baseType and endianness_variant already
-        // const char*
-        double value = (registerCount == 1)
-                           ? ModbusUtils::processRegisterValue(reg, results[0])
-                           : ModbusUtils::processMultiRegisterValue(
-                                 reg, results, registerCount, baseType,
-                                 endianness_variant);
-
-        // CRITICAL FIX: Check storeRegisterValue() return to detect enqueue
-        // failures
-        bool storeSuccess =
-            storeRegisterValue(deviceId, reg, value, deviceName);
-
-        // Track result for End-of-Batch Marker
-        if (storeSuccess) {
-          successRegisterCount++;
-        } else {
-          failedRegisterCount++;  // Failure: queue full or memory exhausted
-        }
-
-        // FIXED ISSUE #4: Use helper function to eliminate code duplication (FC
-        // 3/4) STRING OPTIMIZATION (v2.3.8): Use const char* instead of String
-        const char* unit = reg["unit"] | "";
-        appendRegisterToLog(registerName, value, unit, deviceId, outputBuffer,
-                            compactLine, successCount, lineNumber);
-
-        // Add to JSON debug output (runtime check)
-        if (IS_DEV_MODE()) {
-          JsonObject regObj = polledRegisters.add<JsonObject>();
-          regObj["name"] = registerName;
-          regObj["address"] = address;
-          regObj["function_code"] = functionCode;
-          regObj["value"] = value;
-          if (strlen(unit) > 0) regObj["unit"] = unit;
-        }
-      } else {
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("%s: %s = ERROR\n", deviceId, registerName);
-        failedRegisterCount++;
+      failedRegisterCount++;  // Failure: queue full or memory exhausted
+    }
 
-        // FIXED ISSUE #2: Mark connection as unhealthy on read failure
-        connectionHealthy = false;
-      }
+    // FIXED ISSUE #4: Use helper function to eliminate code duplication
+    if (buildDataLog) {
+      appendRegisterToLog(reg.name, value, reg.unit, deviceId, outputBuffer,
+                          compactLine, successCount, lineNumber);
     }
 
-    vTaskDelay(pdMS_TO_TICKS(50));  // Small delay between registers
+    // Add to JSON debug output
+    if (collectPolledData) {
+      JsonObject regObj = polledRegisters.add<JsonObject>();
+      regObj["name"] = reg.name;
+      regObj["address"] = reg.address;
+      regObj["function_code"] = reg.functionCode;
+      regObj["value"] = value;
+      if (reg.unit[0] != '\0') regObj["unit"] = (const char*)reg.unit;
+    }
   }
 
-  // FIXED ISSUE #2: Return connection to pool (mark as healthy/unhealthy for
-  // reuse decision) If connection was unhealthy, pool will close it. If
-  // healthy, pool keeps it for next device.
-  if (pooledClient != nullptr) {
-    returnPooledConnection(ip, port, pooledClient, connectionHealthy);
-    LOG_TCP_INFO("[TCP] Returned pooled connection for %s:%d (healthy: %s)\n",
-                 ip, port, connectionHealthy ? "YES" : "NO");
-  }
+  // v1.3.3: Back to the pool once the last unit using it is done
+  releaseConnection(txn);
 
   // COMPACT LOGGING: Add remaining items and print buffer atomically
   // v2.5.16: Optimized with snprintf to eliminate heap fragmentation
@@ -687,24 +1401,47 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
     LOG_DATA_DEBUG("%s", outputBuffer.c_str());
   }
 
+  // v1.3.3: Cycle vs interval (late = start behind the deadline), before
+  // the adaptive interval moves
+  uint32_t cycleMs = millis() - txn.startedAt;
+  int32_t lateMs = (int32_t)(txn.startedAt - txn.slot.dueMs);
+  device.state.cycle.record(cycleMs, lateMs > 0 ? lateMs : 0,
+                            plan.pollIntervalMs());
+
+  // v1.3.3: Adaptive interval from value changes ("adaptive_refresh"). No
+  // shared bus to measure: devices have their own endpoint (or a gateway
+  // whose load shows in its response times)
+  if (plan.adaptive.enabled && successRegisterCount > 0) {
+    uint32_t previousMs = plan.adaptive.intervalMs;
+    uint32_t intervalMs =
+        plan.adaptive.update(ModbusPollPlan::valueSignature(plan), 0);
+    if (intervalMs != previousMs) {
+      LOG_TCP_DEBUG("Device %s: refresh %lu -> %lu ms\n", deviceId,
+                    (unsigned long)previousMs, (unsigned long)intervalMs);
+    }
+  }
+
+  // v1.3.3: Read time ranks the device within a cycle (fastest first), and
+  // the device is done for its snapshot cycle (aligned acquisition)
+  device.state.readMs = (uint16_t)std::min<uint32_t>(cycleMs, 0xFFFF);
+  AcquisitionCycle::getInstance()->complete(plan.registrySlot);
+
   // CRITICAL FIX: Update device last read timestamp to respect refresh_rate_ms
-  // Without this, shouldPollDevice() always returns true and device is polled
-  // every 100ms!
-  updateDeviceLastRead(deviceId);
+  // v1.3.3: Next deadline = previous deadline + refresh_rate_ms (no drift)
+  reschedule(txn.slot, millis());
 
   // END-OF-BATCH MARKER: Signal to MQTT that device batch is complete
   // This marker allows MQTT to know when to publish per-device data
   QueueManager* queueMgr = QueueManager::getInstance();
-  if (queueMgr && registers.size() > 0) {
-    SpiRamJsonDocument markerDoc;
-    JsonObject marker = markerDoc.to<JsonObject>();
-    marker["event"] = "BATCH_END";
-    marker["device_id"] = deviceId;
-    marker["success_count"] = successRegisterCount;
-    marker["failed_count"] = failedRegisterCount;
-    marker["timestamp"] = millis();
-
-    if (queueMgr->enqueue(marker)) {
+  if (queueMgr) {
+    // v1.3.3: Binary marker record (no JSON serialization). Unbound plans
+    // (registry full) queue nothing, see storeRegisterValue()
+    bool markerQueued =
+        plan.registrySlot != PollPlanRegistry::INVALID_SLOT &&
+        queueMgr->enqueueBatchEnd(plan.registrySlot, plan.registryGeneration,
+                                  successRegisterCount, failedRegisterCount);
+
+    if (markerQueued) {
       LOG_TCP_DEBUG(
           "Batch marker enqueued for device %s (success=%d, failed=%d)\n",
           deviceId, successRegisterCount, failedRegisterCount);
@@ -713,8 +1450,8 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
     }
   }
 
-  // Development mode: Print polled data as JSON (one-line) - runtime check
-  if (IS_DEV_MODE() && successRegisterCount > 0) {
+  // Development mode: Print polled data as JSON (one-line)
+  if (collectPolledData && successRegisterCount > 0) {
     polledData["success_count"] = successRegisterCount;
     polledData["failed_count"] = failedRegisterCount;
 
@@ -722,6 +1459,8 @@ void ModbusTcpService::readTcpDeviceData(const JsonObject& deviceConfig) {
     serializeJson(polledDataDoc, Serial);
     Serial.println("\n");
   }
+
+  txn.phase = TransactionPhase::IDLE;
 }
 
 // FIXED ISSUE #4: Helper function to eliminate code duplication in register
@@ -833,37 +1572,10 @@ bool ModbusTcpService::readModbusRegister(const char* ip, int port,
   // Send request
   client->write(request, ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE);
 
-  // FIXED Bug #11: Safe time comparison to handle millis() wraparound
-  unsigned long startTime = millis();
-  while (client->available() < ModbusTcpConfig::MIN_RESPONSE_SIZE &&
-         (millis() - startTime) < ModbusTcpConfig::TIMEOUT_MS) {
-    vTaskDelay(pdMS_TO_TICKS(10));
-  }
-
-  if (client->available() < ModbusTcpConfig::MIN_RESPONSE_SIZE) {
-    if (shouldCloseConnection) {
-      client->stop();
-      delete client;
-    }
-    return false;
-  }
-
-  // Read response - FIXED Bug #3: Use dynamic buffer with bounds check
-  int availableBytes = client->available();
-
-  // Sanity check: Modbus TCP response shouldn't exceed reasonable size
-  if (availableBytes > ModbusTcpConfig::MAX_RESPONSE_SIZE) {
-    LOG_TCP_INFO("[TCP] Response too large (%d bytes), rejecting\n",
-                 availableBytes);
-    if (shouldCloseConnection) {
-      client->stop();
-      delete client;
-    }
-    return false;
-  }
-
-  std::vector<uint8_t> response(availableBytes);
-  int bytesRead = client->readBytes(response.data(), availableBytes);
+  // v1.3.3: Wakes when the frame has arrived (was 10ms available() polling)
+  uint8_t response[ModbusTcpConfig::MIN_RESPONSE_SIZE + 250];
+  int frameLength = receiveFrame(client, transId, response, sizeof(response),
+                                 ModbusTcpConfig::TIMEOUT_MS);
 
   // FIXED ISSUE #2: Only close if NOT using pooled connection
   if (shouldCloseConnection) {
@@ -871,8 +1583,12 @@ bool ModbusTcpService::readModbusRegister(const char* ip, int port,
     delete client;
   }
 
+  if (frameLength <= 0) {
+    return false;
+  }
+
   bool dummy = false;
-  return parseModbusResponse(response.data(), bytesRead, functionCode, result,
+  return parseModbusResponse(response, frameLength, functionCode, result,
                              &dummy);
 }
 
@@ -907,39 +1623,10 @@ bool ModbusTcpService::readModbusRegisters(
   // Send request
   client->write(request, ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE);
 
-  // FIXED Bug #11: Safe time comparison to handle millis() wraparound
-  unsigned long startTime = millis();
-  int expectedBytes = ModbusTcpConfig::MIN_RESPONSE_SIZE + (count * 2);
-  while (client->available() < expectedBytes &&
-         (millis() - startTime) < ModbusTcpConfig::TIMEOUT_MS) {
-    vTaskDelay(pdMS_TO_TICKS(10));
-  }
-
-  if (client->available() < expectedBytes) {
-    LOG_TCP_INFO("[TCP] Response timeout or incomplete for %s:%d\n", ip, port);
-    if (shouldCloseConnection) {
-      client->stop();
-      delete client;
-    }
-    return false;
-  }
-
-  // Read response - FIXED Bug #3: Use dynamic buffer with bounds check
-  int availableBytes = client->available();
-
-  // Sanity check: Modbus TCP response shouldn't exceed reasonable size
-  if (availableBytes > ModbusTcpConfig::MAX_RESPONSE_SIZE) {
-    LOG_TCP_INFO("[TCP] Response too large (%d bytes), rejecting\n",
-                 availableBytes);
-    if (shouldCloseConnection) {
-      client->stop();
-      delete client;
-    }
-    return false;
-  }
-
-  std::vector<uint8_t> response(availableBytes);
-  int bytesRead = client->readBytes(response.data(), availableBytes);
+  // v1.3.3: Wakes when the frame has arrived (was 10ms available() polling)
+  uint8_t response[ModbusTcpConfig::MIN_RESPONSE_SIZE + 250];
+  int frameLength = receiveFrame(client, transId, response, sizeof(response),
+                                 ModbusTcpConfig::TIMEOUT_MS);
 
   // FIXED ISSUE #2: Only close if NOT using pooled connection
   if (shouldCloseConnection) {
@@ -947,8 +1634,13 @@ bool ModbusTcpService::readModbusRegisters(
     delete client;
   }
 
-  return parseMultiModbusResponse(response.data(), bytesRead, functionCode,
-                                  count, results);
+  if (frameLength <= 0) {
+    LOG_TCP_INFO("[TCP] Response timeout or incomplete for %s:%d\n", ip, port);
+    return false;
+  }
+
+  return parseMultiModbusResponse(response, frameLength, functionCode, count,
+                                  results);
 }
 
 // v2.5.41: Changed from const String& to const char* for consistency with RTU
@@ -987,51 +1679,105 @@ bool ModbusTcpService::readModbusCoil(const char* ip, int port, uint8_t slaveId,
   client->write(request,
                 ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE);  // FIXED Bug #10
 
-  // FIXED Bug #11: Safe time comparison to handle millis() wraparound
-  unsigned long startTime = millis();
-  while (client->available() < ModbusTcpConfig::MIN_RESPONSE_SIZE &&
-         (millis() - startTime) < ModbusTcpConfig::TIMEOUT_MS) {
-    vTaskDelay(pdMS_TO_TICKS(10));
-  }
+  // v1.3.3: Wakes when the frame has arrived (was 10ms available() polling)
+  uint8_t response[ModbusTcpConfig::MIN_RESPONSE_SIZE + 250];
+  int frameLength = receiveFrame(client, transId, response, sizeof(response),
+                                 ModbusTcpConfig::TIMEOUT_MS);
+
+  // FIXED ISSUE #2: Only close if NOT using pooled connection
+  if (shouldCloseConnection) {
+    client->stop();
+    delete client;
+  }
+
+  if (frameLength <= 0) {
+    return false;
+  }
+
+  uint16_t dummy;
+  return parseModbusResponse(response, frameLength, 1, &dummy, result);
+}
+
+// v1.3.3: Block read of one span (FC1-4). The reply is framed by its MBAP
+// length field, so exception responses (9 bytes) are detected immediately
+// instead of waiting TIMEOUT_MS for a full data frame.
+// exceptionCode = 0 on timeout/IO/framing errors (connection not reusable),
+// else the Modbus exception code (connection still in sync).
+bool ModbusTcpService::readModbusSpan(const char* ip, int port, uint8_t slaveId,
+                                      uint8_t functionCode, uint16_t address,
+                                      uint16_t quantity, uint16_t* results,
+                                      uint8_t* exceptionCode,
+                                      TCPClient* existingClient,
+                                      uint32_t timeoutMs) {
+  if (exceptionCode) *exceptionCode = 0;
+
+  TCPClient* client = nullptr;
+  bool shouldCloseConnection = false;
+
+  if (existingClient && existingClient->connected()) {
+    client = existingClient;
+  } else {
+    client = new TCPClient();
+    client->setTimeout(ModbusTcpConfig::TIMEOUT_MS);
 
-  if (client->available() <
-      ModbusTcpConfig::MIN_RESPONSE_SIZE)  // FIXED Bug #10
-  {
-    // FIXED ISSUE #2: Only close if NOT using pooled connection
-    if (shouldCloseConnection) {
-      client->stop();
+    if (!client->connect(ip, port)) {
+      LOG_TCP_INFO("[TCP] Failed to connect to %s:%d\n", ip, port);
       delete client;
+      return false;
     }
-    return false;
+    shouldCloseConnection = true;
   }
 
-  // Read response - FIXED Bug #3: Use dynamic buffer with bounds check
-  int availableBytes = client->available();
+  // Build Modbus TCP request
+  uint8_t request[ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE];
+  uint16_t transId = getNextTransactionId();
+  buildModbusRequest(request, transId, slaveId, functionCode, address,
+                     quantity);
+  client->write(request, ModbusTcpConfig::MODBUS_TCP_HEADER_SIZE);
 
-  // Sanity check: Modbus TCP response shouldn't exceed reasonable size
-  if (availableBytes > ModbusTcpConfig::MAX_RESPONSE_SIZE)  // FIXED Bug #10
-  {
-    LOG_TCP_INFO("[TCP] Response too large (%d bytes), rejecting\n",
-                 availableBytes);
-    // FIXED ISSUE #2: Only close if NOT using pooled connection
-    if (shouldCloseConnection) {
-      client->stop();
-      delete client;
+  // v1.3.3: Wakes when the frame has arrived (was 10ms available() polling)
+  uint8_t response[ModbusTcpConfig::MIN_RESPONSE_SIZE + 250];
+  int frameLength = receiveFrame(client, transId, response, sizeof(response),
+                                 timeoutMs);
+
+  bool success = false;
+  if (frameLength == 0) {
+    LOG_TCP_INFO("[TCP] Response timeout for %s:%d (FC%d @%d x%d)\n", ip, port,
+                 functionCode, address, quantity);
+  } else if (frameLength > 0) {
+    success = parseMultiModbusResponse(response, frameLength, functionCode,
+                                       quantity, results, exceptionCode);
+    if (!success && (!exceptionCode || *exceptionCode == 0)) {
+      LOG_TCP_WARN("Unexpected response for %s:%d (FC%d, %d bytes)\n", ip,
+                   port, response[7], response[8]);
     }
-    return false;
   }
 
-  std::vector<uint8_t> response(availableBytes);
-  int bytesRead = client->readBytes(response.data(), availableBytes);
-
   // FIXED ISSUE #2: Only close if NOT using pooled connection
   if (shouldCloseConnection) {
     client->stop();
     delete client;
   }
 
-  uint16_t dummy;
-  return parseModbusResponse(response.data(), bytesRead, 1, &dummy, result);
+  return success;
+}
+
+void ModbusTcpService::unpackSpanData(const uint8_t* data, uint8_t functionCode,
+                                      uint16_t byteCount, uint16_t quantity,
+                                      uint16_t* results) {
+  if (functionCode <= 2) {
+    // Pack bytes LSB-first into words (same layout as ModbusMaster, so
+    // ModbusUtils::extractBit() works for both RTU and TCP)
+    for (uint16_t i = 0; i < (byteCount + 1) / 2; i++) {
+      uint16_t lo = data[i * 2];
+      uint16_t hi = (i * 2 + 1 < byteCount) ? data[i * 2 + 1] : 0;
+      results[i] = (hi << 8) | lo;
+    }
+  } else {
+    for (uint16_t i = 0; i < quantity; i++) {
+      results[i] = ((uint16_t)data[i * 2] << 8) | data[i * 2 + 1];
+    }
+  }
 }
 
 void ModbusTcpService::buildModbusRequest(uint8_t* buffer, uint16_t transId,
@@ -1054,6 +1800,47 @@ void ModbusTcpService::buildModbusRequest(uint8_t* buffer, uint16_t transId,
   buffer[11] = qty & 0xFF;         // Quantity low
 }
 
+int ModbusTcpService::receiveFrame(TCPClient* client, uint16_t transId,
+                                   uint8_t* buffer, size_t bufferSize,
+                                   uint32_t timeoutMs) {
+  // FIXED Bug #11: Safe time comparison to handle millis() wraparound
+  unsigned long startTime = millis();
+  size_t received = 0;
+  size_t frameLength = 6;  // MBAP header up to the length field
+
+  while (received < frameLength) {
+    unsigned long elapsed = millis() - startTime;
+    if (elapsed >= timeoutMs || !client->waitReadable(timeoutMs - elapsed)) {
+      return 0;
+    }
+
+    int bytesRead = client->read(buffer + received, frameLength - received);
+    if (bytesRead <= 0) {
+      continue;
+    }
+    received += bytesRead;
+
+    if (received == 6) {
+      uint16_t protocolId = ((uint16_t)buffer[2] << 8) | buffer[3];
+      uint16_t length = ((uint16_t)buffer[4] << 8) | buffer[5];
+      if (protocolId != 0 || length < 3 || 6 + (size_t)length > bufferSize) {
+        LOG_TCP_WARN("Invalid MBAP header (length %u)\n", length);
+        return -1;
+      }
+      frameLength = 6 + length;
+    }
+  }
+
+  // Stale response from an earlier timed-out request = stream out of sync
+  uint16_t respTransId = ((uint16_t)buffer[0] << 8) | buffer[1];
+  if (respTransId != transId) {
+    LOG_TCP_WARN("Transaction ID mismatch (got %u, want %u)\n", respTransId,
+                 transId);
+    return -1;
+  }
+  return (int)frameLength;
+}
+
 bool ModbusTcpService::parseModbusResponse(uint8_t* buffer, int length,
                                            uint8_t expectedFunc,
                                            uint16_t* result, bool* boolResult) {
@@ -1095,10 +1882,14 @@ bool ModbusTcpService::parseModbusResponse(uint8_t* buffer, int length,
   return false;
 }
 
-bool ModbusTcpService::parseMultiModbusResponse(uint8_t* buffer, int length,
-                                                uint8_t expectedFunc, int count,
-                                                uint16_t* results) {
-  if (length < 9) {
+bool ModbusTcpService::parseMultiModbusResponse(const uint8_t* buffer,
+                                                int length,
+                                                uint8_t expectedFunc,
+                                                uint16_t count,
+                                                uint16_t* results,
+                                                uint8_t* exceptionCode) {
+  if (exceptionCode) *exceptionCode = 0;
+  if (length < ModbusTcpConfig::MIN_RESPONSE_SIZE) {
     return false;
   }
 
@@ -1106,35 +1897,31 @@ bool ModbusTcpService::parseMultiModbusResponse(uint8_t* buffer, int length,
   uint8_t funcCode = buffer[7];
   if (funcCode != expectedFunc) {
     // Check for error response
-    if (funcCode == (expectedFunc | 0x80)) {
-      // Modbus error
+    if (funcCode == (expectedFunc | 0x80) && exceptionCode) {
+      *exceptionCode = buffer[8];  // Modbus exception
     }
     return false;
   }
 
-  // Parse data based on function code
-  if (funcCode == 3 || funcCode == 4) {
-    // Register response (holding or input registers)
-    if (length >= 9 && results) {
-      uint8_t byteCount = buffer[8];
-      if (byteCount == count * 2) {
-        // Extract register values
-        for (int i = 0; i < count; i++) {
-          results[i] = (buffer[9 + (i * 2)] << 8) | buffer[9 + (i * 2) + 1];
-        }
-        return true;
-      }
-    }
+  // v1.3.3: All read FCs - packed bits (FC1/2) or 2 bytes per word (FC3/4)
+  uint16_t expectedBytes = (funcCode <= 2) ? (count + 7) / 8 : count * 2;
+  uint8_t byteCount = buffer[8];
+  if (funcCode < 1 || funcCode > 4 || byteCount != expectedBytes ||
+      length < ModbusTcpConfig::MIN_RESPONSE_SIZE + byteCount || !results) {
+    return false;
   }
 
-  return false;
+  unpackSpanData(buffer + ModbusTcpConfig::MIN_RESPONSE_SIZE, funcCode,
+                 byteCount, count, results);
+  return true;
 }
 
 // v2.5.41: Changed from const String& to const char* for consistency with RTU
 // service
-bool ModbusTcpService::storeRegisterValue(const char* deviceId,
-                                          const JsonObject& reg, double value,
-                                          const char* deviceName) {
+bool ModbusTcpService::storeRegisterValue(CompiledDevicePlan& plan,
+                                          uint16_t registerSlot,
+                                          double calibratedValue,
+                                          uint32_t timestamp) {
   QueueManager* queueMgr = QueueManager::getInstance();
 
   // FIXED Bug #12: Defensive null check for QueueManager
@@ -1144,73 +1931,47 @@ bool ModbusTcpService::storeRegisterValue(const char* deviceId,
     return false;  // FIXED: Return false on failure
   }
 
-  // Create data point in simplified format for MQTT
-  JsonDocument dataDoc;
-  JsonObject dataPoint = dataDoc.to<JsonObject>();
-
-  // Apply calibration formula: final_value = (raw_value × scale) + offset
-  float scale = reg["scale"] | 1.0;
-  float offset = reg["offset"] | 0.0;
-  double calibratedValue = (value * scale) + offset;
+  const CompiledRegister& reg = plan.registers[registerSlot];
+  const char* deviceId = plan.deviceId;
 
-  // v1.0.7: Apply decimal precision if specified
-  // -1 = auto (no rounding), 0-6 = fixed decimal places
-  int decimals = reg["decimals"] | -1;
-  if (decimals >= 0 && decimals <= 6) {
-    double multiplier = pow(10.0, decimals);
-    calibratedValue = round(calibratedValue * multiplier) / multiplier;
+  // v1.3.3: Registry full - device was reported at refresh, no per-register
+  // error/diagnostics spam
+  if (plan.registrySlot == PollPlanRegistry::INVALID_SLOT) {
+    return false;
   }
 
-  RTCManager* rtc = RTCManager::getInstance();
-  if (rtc) {
-    DateTime now = rtc->getCurrentTime();
-    dataPoint["time"] = now.unixtime();
-  }
-  dataPoint["name"] = reg["register_name"].as<String>();
-  dataPoint["device_id"] = deviceId;
+  // v1.3.3: Publish window statistics see every read (deadband or not)
+  ModbusPollPlan::storeAggregate(plan, registerSlot, calibratedValue,
+                                 timestamp, PollPlanRegistry::currentWindow());
+  // v1.3.3: Short-term history (BLE trend query) keeps every read too
+  TrendHistory::getInstance()->record(plan.registrySlot,
+                                      plan.registryGeneration, registerSlot,
+                                      calibratedValue);
 
-  // OPTIMIZED: Use pre-fetched device_name (passed from readTcpDeviceData)
-  // This avoids expensive getAllDevicesWithRegisters() call per register
-  if (deviceName && strlen(deviceName) > 0) {
-    dataPoint["device_name"] = deviceName;
+  // v1.3.3: Report-by-exception - readings inside the register's deadband
+  // are dropped here (counted as read, not queued or published)
+  if (!ModbusPollPlan::checkDeadband(plan, registerSlot, calibratedValue,
+                                     millis())) {
+    return true;
   }
 
-  dataPoint["address"] =
-      reg["address"];  // Register address (e.g., 4112) for BLE streaming
-  dataPoint["value"] = calibratedValue;  // Use calibrated value
-  dataPoint["description"] =
-      reg["description"] | "";  // Optional field from BLE config
-
-  // v2.5.40: Convert "deg" to degree symbol (°) for proper unit display
-  // User request: show "°C" instead of "degC" in output
-  // This also handles legacy data that might have been stored with "deg" prefix
-  String rawUnit = reg["unit"] | "";
-  rawUnit.replace("deg",
-                  "\xC2\xB0");  // Convert "deg" to UTF-8 degree symbol (°)
-  dataPoint["unit"] = rawUnit;  // Unit with proper degree symbol
-
-  dataPoint["register_id"] =
-      reg["register_id"].as<String>();  // Internal use for deduplication
-  dataPoint["register_index"] =
-      reg["register_index"] | 0;  // For customize mode topic mapping
-
-  // v1.3.2: Add writable status for mobile app
-  // FC1 (Coils) and FC3 (Holding Registers) are writable
-  // FC2 (Discrete Inputs) and FC4 (Input Registers) are read-only
-  uint8_t functionCode = reg["function_code"] | 3;
-  dataPoint["writable"] = ModbusUtils::isWritableType(functionCode);
+  // v1.3.3: MQTT latest-value table (overwritten in place, no queue drain)
+  ModbusPollPlan::storeLatest(plan, registerSlot, calibratedValue, timestamp);
 
   // CRITICAL FIX: Check enqueue() return value to detect data loss
-  // If enqueue fails (queue full, memory exhausted, mutex timeout), return
-  // false
-  bool enqueueSuccess = queueMgr->enqueue(dataPoint);
+  // v1.3.3: Binary record (24 bytes, strings resolved at publish time).
+  // Lock-free enqueue: only fails if the ring was never allocated (a full
+  // ring overwrites its oldest record)
+  bool enqueueSuccess =
+      queueMgr->enqueueRegister(plan.registrySlot, plan.registryGeneration,
+                                registerSlot, calibratedValue, timestamp);
 
   if (!enqueueSuccess) {
     // CRITICAL: Log detailed error for debugging
     LOG_TCP_ERROR(
         "Failed to enqueue register '%s' for device %s (queue full or memory "
         "exhausted)\n",
-        reg["register_name"].as<String>().c_str(), deviceId);
+        reg.name, deviceId);
 
     // Trigger memory diagnostics to identify root cause
     MemoryRecovery::logMemoryStatus("ENQUEUE_FAILED_TCP");
@@ -1218,20 +1979,8 @@ bool ModbusTcpService::storeRegisterValue(const char* deviceId,
     return false;  // Return failure to caller
   }
 
-  // Check if this device is being streamed
-  String streamId = "";
-  bool crudHandlerAvailable = (crudHandler != nullptr);
-
-  if (crudHandler) {
-    streamId = crudHandler->getStreamDeviceId();
-  }
-
-  // v2.5.41: Compare String with const char* using strcmp
-  if (!streamId.isEmpty() && strcmp(streamId.c_str(), deviceId) == 0 &&
-      queueMgr) {
-    // Verbose log suppressed - summary shown in [STREAM] logs
-    queueMgr->enqueueStream(dataPoint);
-  }
+  // v1.3.3: BLE streaming reads the same record through its own queue
+  // cursor (QueueManager::dequeueStream) - no second JSON copy here
 
   return true;  // Success
 }
@@ -1240,6 +1989,27 @@ void ModbusTcpService::getStatus(JsonObject& status) {
   status["running"] = running;
   status["service_type"] = "modbus_tcp";
   status["tcp_device_count"] = tcpDevices.size();
+
+  // v1.3.3: Connection pool counters
+  JsonObject pool = status["connection_pool"].to<JsonObject>();
+  if (poolMutex && TaskProfiler::take(poolMutex, pdMS_TO_TICKS(100),
+                                      ProfiledLock::TCP_POOL) == pdTRUE) {
+    uint8_t pinned = 0;
+    for (const auto& entry : connectionPool) {
+      if (entry.pollIntervalMs > 0 &&
+          entry.pollIntervalMs <= POOL_PIN_INTERVAL_MS) {
+        pinned++;
+      }
+    }
+    pool["size"] = connectionPool.size();
+    pool["pinned"] = pinned;
+    xSemaphoreGive(poolMutex);
+  }
+  pool["capacity"] = poolCapacity;
+  pool["endpoints"] = poolEndpoints;
+  pool["hits"] = poolHits;
+  pool["misses"] = poolMisses;
+  pool["evictions"] = poolEvictions;
 }
 
 // Modbus TCP Improvement Phase - Helper Method Implementations
@@ -1264,45 +2034,19 @@ uint16_t ModbusTcpService::getNextTransactionId() {
 // device-level polling interval
 
 // Level 1: Device-level timing methods
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-ModbusTcpService::DeviceTimer* ModbusTcpService::getDeviceTimer(
-    const char* deviceId) {
-  for (auto& timer : deviceTimers) {
-    // v2.5.41: PSRAMString comparison with const char*
-    if (strcmp(timer.deviceId.c_str(), deviceId) == 0) {
-      return &timer;
-    }
-  }
-  return nullptr;
-}
-
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-bool ModbusTcpService::shouldPollDevice(const char* deviceId,
-                                        uint32_t refreshRateMs) {
-  DeviceTimer* timer = getDeviceTimer(deviceId);
-  if (!timer) {
-    // First time polling this device, create entry
-    DeviceTimer newTimer;
-    newTimer.deviceId = deviceId;  // PSRAMString accepts const char*
-    newTimer.lastRead = 0;
-    newTimer.refreshRateMs = refreshRateMs;
-    deviceTimers.push_back(newTimer);
-    return true;  // Always poll on first encounter
-  }
-
-  unsigned long now = millis();
-  return (now - timer->lastRead) >= timer->refreshRateMs;
-}
-
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::updateDeviceLastRead(const char* deviceId) {
-  DeviceTimer* timer = getDeviceTimer(deviceId);
-  if (timer) {
-    timer->lastRead = millis();
-  }
+// v1.3.3: Deadline-based (PollScheduler). The next poll is one refresh
+// interval after the previous deadline, so the rate does not drift with read
+// duration. The interval is stretched under memory pressure (MemoryRecovery
+// backpressure). Aligned acquisition moves the deadline to the next cycle
+// boundary.
+void ModbusTcpService::reschedule(const PollSlot& slot, uint32_t nowMs) {
+  TcpDeviceConfig& device = tcpDevices[slot.index];
+  uint32_t next = PollScheduler::nextDeadline(
+      slot.dueMs,
+      MemoryRecovery::applyBackpressure(device.plan.pollIntervalMs()), nowMs);
+  device.nextPollMs = AcquisitionCycle::getInstance()->align(
+      device.plan.registrySlot, next, nowMs);
+  schedule.schedule(slot.index, device.nextPollMs, device.state.readMs);
 }
 
 // Level 3: Server data transmission interval methods
@@ -1355,7 +2099,10 @@ PSRAMString ModbusTcpService::getDeviceKey(const char* ip, int port) {
 
 // v2.5.41: Changed from const String& to const char* for consistency with RTU
 // service
-TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
+TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port,
+                                                 bool startOnly, bool* busy,
+                                                 uint32_t pollIntervalMs) {
+  if (busy) *busy = false;
   if (!poolMutex) {
     return nullptr;  // Pool not initialized
   }
@@ -1365,7 +2112,8 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
   unsigned long now = millis();
 
   // Lock pool for thread-safe access
-  if (xSemaphoreTake(poolMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (TaskProfiler::take(poolMutex, pdMS_TO_TICKS(100),
+                         ProfiledLock::TCP_POOL) != pdTRUE) {
     LOG_TCP_WARN("Pool mutex timeout in getPooledConnection\n");
     return nullptr;
   }
@@ -1374,6 +2122,13 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
   for (auto& entry : connectionPool) {
     // v2.5.41: PSRAMString comparison
     if (strcmp(entry.deviceKey.c_str(), deviceKey.c_str()) == 0) {
+      // v1.3.3: One user per socket (concurrent engine / register writes)
+      if (entry.inUse) {
+        if (busy) *busy = true;
+        xSemaphoreGive(poolMutex);
+        return nullptr;
+      }
+
       // OPTIMIZED (v2.3.10): Smarter health check - don't rely on connected()
       // alone connected() is unreliable for pooled connections (false positives
       // for idle sockets) Trust isHealthy flag (set by actual read/write
@@ -1384,7 +2139,13 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
           // Connection is good - reuse it
           entry.lastUsed = now;
           entry.useCount++;
+          entry.inUse = true;
+          if (pollIntervalMs > 0 && (entry.pollIntervalMs == 0 ||
+                                     pollIntervalMs < entry.pollIntervalMs)) {
+            entry.pollIntervalMs = pollIntervalMs;
+          }
           client = entry.client;
+          poolHits++;
 
           LOG_TCP_DEBUG(
               "Reusing pooled connection to %s (uses: %u, age: %lums)\n",
@@ -1424,12 +2185,17 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
     client = new TCPClient();
     client->setTimeout(ModbusTcpConfig::TIMEOUT_MS);
 
-    if (!client->connect(ip, port)) {
+    // v1.3.3: startOnly = non-blocking connect, completed by the polling
+    // engine (TCPClient::pollConnect)
+    bool connectOk =
+        startOnly ? client->startConnect(ip, port) : client->connect(ip, port);
+    if (!connectOk) {
       LOG_TCP_INFO("[TCP] Failed to connect to %s:%d for pooling\n", ip, port);
       delete client;
       xSemaphoreGive(poolMutex);
       return nullptr;
     }
+    poolMisses++;
 
     // CRITICAL FIX: Check if we have an existing entry with nullptr client
     // (from unhealthy cleanup above) If yes, REUSE that entry instead of
@@ -1445,6 +2211,11 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
         entry.createdAt = now;
         entry.useCount = 1;
         entry.isHealthy = true;
+        entry.inUse = true;
+        if (pollIntervalMs > 0 && (entry.pollIntervalMs == 0 ||
+                                   pollIntervalMs < entry.pollIntervalMs)) {
+          entry.pollIntervalMs = pollIntervalMs;
+        }
         foundExistingEntry = true;
         LOG_TCP_INFO("[TCP] Recreated connection for %s (reused pool entry)\n",
                      deviceKey.c_str());
@@ -1456,30 +2227,14 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
     if (!foundExistingEntry) {
       // DRAM FIX (v2.3.9): NEVER create temporary connections - always force
       // cleanup oldest!
-      if (connectionPool.size() >= MAX_POOL_SIZE) {
+      // v1.3.3: Connections in use are never evicted (the pool only exceeds
+      // poolCapacity while all of them are busy)
+      if (connectionPool.size() >= poolCapacity) {
         // Pool full - FORCE cleanup oldest connection BEFORE adding new one
         LOG_TCP_INFO(
-            "[TCP] Pool full (%d), force cleanup oldest connection before "
-            "adding %s\n",
-            MAX_POOL_SIZE, deviceKey.c_str());
-
-        unsigned long oldestTime = now;
-        size_t oldestIdx = 0;
-        for (size_t i = 0; i < connectionPool.size(); i++) {
-          if (connectionPool[i].lastUsed < oldestTime) {
-            oldestTime = connectionPool[i].lastUsed;
-            oldestIdx = i;
-          }
-        }
-
-        // Close and delete oldest connection
-        if (connectionPool[oldestIdx].client) {
-          connectionPool[oldestIdx].client->stop();
-          delete connectionPool[oldestIdx].client;
-          connectionPool[oldestIdx].client = nullptr;
-        }
-        connectionPool.erase(connectionPool.begin() + oldestIdx);
-        LOG_TCP_INFO("[TCP] Cleaned up oldest connection (freed DRAM)\n");
+            "[TCP] Pool full (%d), evicting a connection before adding %s\n",
+            poolCapacity, deviceKey.c_str());
+        evictIdleConnection();
       }
 
       // Now add new connection (pool has space)
@@ -1490,11 +2245,13 @@ TCPClient* ModbusTcpService::getPooledConnection(const char* ip, int port) {
       newEntry.createdAt = now;
       newEntry.useCount = 1;
       newEntry.isHealthy = true;
+      newEntry.inUse = true;
+      newEntry.pollIntervalMs = pollIntervalMs;
       connectionPool.push_back(newEntry);
 
       LOG_TCP_INFO(
           "[TCP] Created new pooled connection to %s (pool size: %d/%d)\n",
-          deviceKey.c_str(), connectionPool.size(), MAX_POOL_SIZE);
+          deviceKey.c_str(), connectionPool.size(), poolCapacity);
     }
   }
 
@@ -1513,7 +2270,8 @@ void ModbusTcpService::returnPooledConnection(const char* ip, int port,
   PSRAMString deviceKey = getDeviceKey(ip, port);
   unsigned long now = millis();
 
-  if (xSemaphoreTake(poolMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (TaskProfiler::take(poolMutex, pdMS_TO_TICKS(100),
+                         ProfiledLock::TCP_POOL) != pdTRUE) {
     LOG_TCP_WARN("Pool mutex timeout in returnPooledConnection\n");
     return;
   }
@@ -1525,6 +2283,7 @@ void ModbusTcpService::returnPooledConnection(const char* ip, int port,
     if (strcmp(entry.deviceKey.c_str(), deviceKey.c_str()) == 0) {
       entry.lastUsed = now;
       entry.isHealthy = healthy;
+      entry.inUse = false;
       found = true;
 
       if (!healthy) {
@@ -1542,7 +2301,7 @@ void ModbusTcpService::returnPooledConnection(const char* ip, int port,
 
   if (!found && healthy) {
     // New connection - add to pool if not full
-    if (connectionPool.size() < MAX_POOL_SIZE) {
+    if (connectionPool.size() < poolCapacity) {
       ConnectionPoolEntry newEntry;
       newEntry.deviceKey = deviceKey;
       newEntry.client = client;
@@ -1550,31 +2309,14 @@ void ModbusTcpService::returnPooledConnection(const char* ip, int port,
       newEntry.createdAt = now;
       newEntry.useCount = 1;
       newEntry.isHealthy = true;
+      newEntry.inUse = false;
+      newEntry.pollIntervalMs = 0;
       connectionPool.push_back(newEntry);
 
       LOG_TCP_INFO("Added new connection to pool: %s (pool size: %d)\n",
                    deviceKey.c_str(), connectionPool.size());
-    } else {
-      // Pool full - close oldest connection
-      LOG_TCP_WARN("Connection pool full (%d), closing oldest connection\n",
-                   MAX_POOL_SIZE);
-
-      unsigned long oldestTime = now;
-      size_t oldestIdx = 0;
-      for (size_t i = 0; i < connectionPool.size(); i++) {
-        if (connectionPool[i].lastUsed < oldestTime) {
-          oldestTime = connectionPool[i].lastUsed;
-          oldestIdx = i;
-        }
-      }
-
-      if (connectionPool[oldestIdx].client) {
-        connectionPool[oldestIdx].client->stop();
-        delete connectionPool[oldestIdx].client;
-      }
-      connectionPool.erase(connectionPool.begin() + oldestIdx);
-
-      // Add new connection
+    } else if (evictIdleConnection()) {
+      // Pool full - oldest idle connection closed
       ConnectionPoolEntry newEntry;
       newEntry.deviceKey = deviceKey;
       newEntry.client = client;
@@ -1582,15 +2324,123 @@ void ModbusTcpService::returnPooledConnection(const char* ip, int port,
       newEntry.createdAt = now;
       newEntry.useCount = 1;
       newEntry.isHealthy = true;
+      newEntry.inUse = false;
+      newEntry.pollIntervalMs = 0;
       connectionPool.push_back(newEntry);
 
       LOG_TCP_INFO("Replaced oldest connection with %s\n", deviceKey.c_str());
+    } else {
+      // v1.3.3: Every pooled connection is in use - don't keep this one
+      LOG_TCP_WARN("Connection pool full (%d), closing %s\n", poolCapacity,
+                   deviceKey.c_str());
+      client->stop();
+      delete client;
     }
   }
 
+  // v1.3.3: Shrink back to capacity once connections are released
+  while (connectionPool.size() > poolCapacity && evictIdleConnection()) {
+  }
+
   xSemaphoreGive(poolMutex);
 }
 
+// v1.3.3: Close the connection needed last (caller holds poolMutex).
+// Previous: plain LRU - with more devices than pool slots and round-robin
+// polling, the least recently used connection is exactly the next one needed.
+// New: Each entry's next use is predicted from its poll interval
+// (lastUsed + pollIntervalMs). Dead entries go first, then the connection
+// whose next poll is furthest away. Pinned (fast-polled) connections are
+// only closed when every candidate is pinned. Connections in use never are.
+// Returns false if every connection is in use.
+bool ModbusTcpService::evictIdleConnection() {
+  unsigned long now = millis();
+  int victim = -1;
+  int victimRank = -1;  // 2 = dead, 1 = unpinned, 0 = pinned
+  long victimUntilUse = 0;
+
+  for (size_t i = 0; i < connectionPool.size(); i++) {
+    const ConnectionPoolEntry& entry = connectionPool[i];
+    if (entry.inUse) continue;
+
+    uint32_t interval =
+        entry.pollIntervalMs ? entry.pollIntervalMs : CONNECTION_IDLE_TIMEOUT_MS;
+    long untilUse = (long)interval - (long)(now - entry.lastUsed);
+    int rank;
+    if (!entry.client || !entry.isHealthy) {
+      rank = 2;
+    } else if (entry.pollIntervalMs > 0 &&
+               entry.pollIntervalMs <= POOL_PIN_INTERVAL_MS) {
+      rank = 0;
+    } else {
+      rank = 1;
+    }
+
+    if (rank > victimRank || (rank == victimRank && untilUse > victimUntilUse)) {
+      victim = i;
+      victimRank = rank;
+      victimUntilUse = untilUse;
+    }
+  }
+  if (victim < 0) {
+    return false;
+  }
+
+  LOG_TCP_INFO("[TCP] Evicting pooled connection %s (%s, next use in %ldms)\n",
+               connectionPool[victim].deviceKey.c_str(),
+               victimRank == 0 ? "pinned" : "idle", victimUntilUse);
+  if (connectionPool[victim].client) {
+    connectionPool[victim].client->stop();
+    delete connectionPool[victim].client;
+    connectionPool[victim].client = nullptr;
+  }
+  connectionPool.erase(connectionPool.begin() + victim);
+  poolEvictions++;
+  return true;
+}
+
+void ModbusTcpService::updatePoolCapacity(uint8_t concurrencyLimit) {
+  // One connection per configured endpoint, at least the old fixed size
+  uint32_t capacity = poolEndpoints;
+  if (capacity < MAX_POOL_SIZE) {
+    capacity = MAX_POOL_SIZE;
+  }
+  if (capacity > MAX_POOL_CONNECTIONS) {
+    capacity = MAX_POOL_CONNECTIONS;
+  }
+
+  // Socket buffers live in internal RAM (not PSRAM): open connections keep
+  // theirs, each new one needs DRAM_PER_TRANSACTION above DRAM_RESERVE
+  size_t openConnections = 0;
+  if (poolMutex && TaskProfiler::take(poolMutex, pdMS_TO_TICKS(100),
+                                      ProfiledLock::TCP_POOL) == pdTRUE) {
+    for (const auto& entry : connectionPool) {
+      if (entry.client) openConnections++;
+    }
+    xSemaphoreGive(poolMutex);
+  }
+  size_t dramFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  uint32_t affordable = openConnections;
+  if (dramFree > ModbusTcpConfig::DRAM_RESERVE) {
+    affordable += (dramFree - ModbusTcpConfig::DRAM_RESERVE) /
+                  ModbusTcpConfig::DRAM_PER_TRANSACTION;
+  }
+  if (capacity > affordable) {
+    capacity = affordable;
+  }
+
+  // The engine holds one connection per read in flight
+  if (capacity < concurrencyLimit) {
+    capacity = concurrencyLimit;
+  }
+
+  if (capacity != poolCapacity) {
+    LOG_TCP_DEBUG("[TCP] Pool capacity %d -> %d (endpoints: %d)\n",
+                  poolCapacity, capacity, poolEndpoints);
+    poolCapacity = (uint8_t)capacity;
+  }
+}
+
 void ModbusTcpService::closeIdleConnections() {
   if (!poolMutex) {
     return;
@@ -1598,7 +2448,8 @@ void ModbusTcpService::closeIdleConnections() {
 
   unsigned long now = millis();
 
-  if (xSemaphoreTake(poolMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (TaskProfiler::take(poolMutex, pdMS_TO_TICKS(100),
+                         ProfiledLock::TCP_POOL) != pdTRUE) {
     return;
   }
 
@@ -1612,14 +2463,18 @@ void ModbusTcpService::closeIdleConnections() {
         "connections\n",
         dramFree);
     // Emergency: close ALL connections to free DRAM immediately
-    for (auto& entry : connectionPool) {
-      if (entry.client) {
-        entry.client->stop();
-        delete entry.client;
-        entry.client = nullptr;
+    // v1.3.3: Except those held by a running register write
+    for (auto it = connectionPool.begin(); it != connectionPool.end();) {
+      if (it->inUse) {
+        ++it;
+        continue;
+      }
+      if (it->client) {
+        it->client->stop();
+        delete it->client;
       }
+      it = connectionPool.erase(it);
     }
-    connectionPool.clear();
     LOG_TCP_INFO(
         "[TCP] Emergency cleanup: ALL connections closed (pool cleared)\n");
     xSemaphoreGive(poolMutex);
@@ -1627,9 +2482,19 @@ void ModbusTcpService::closeIdleConnections() {
   }
 
   // Normal cleanup: Remove idle connections
+  // v1.3.3: Slowly polled devices keep their connection across cycles (idle
+  // limit = 2 poll intervals, was a fixed 30s that closed every connection of
+  // a device polled every 60s before its next read)
   for (auto it = connectionPool.begin(); it != connectionPool.end();) {
     unsigned long idleTime = now - it->lastUsed;
-    if (idleTime > CONNECTION_IDLE_TIMEOUT_MS || !it->isHealthy) {
+    uint32_t idleLimit = CONNECTION_IDLE_TIMEOUT_MS;
+    if (it->pollIntervalMs * 2 > idleLimit) {
+      idleLimit = it->pollIntervalMs * 2;
+    }
+    if (idleLimit > CONNECTION_MAX_AGE_MS) {
+      idleLimit = CONNECTION_MAX_AGE_MS;
+    }
+    if (!it->inUse && (idleTime > idleLimit || !it->isHealthy)) {
       LOG_TCP_INFO("Closing idle/unhealthy connection to %s (idle: %lums)\n",
                    it->deviceKey.c_str(), idleTime);
 
@@ -1651,7 +2516,8 @@ void ModbusTcpService::closeAllConnections() {
     return;
   }
 
-  if (xSemaphoreTake(poolMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+  if (TaskProfiler::take(poolMutex, pdMS_TO_TICKS(1000),
+                         ProfiledLock::TCP_POOL) != pdTRUE) {
     return;
   }
 
@@ -1669,166 +2535,107 @@ void ModbusTcpService::closeAllConnections() {
   xSemaphoreGive(poolMutex);
 }
 
-// ============================================
-// NEW: Enhancement - Device Failure and Metrics Management
-// ============================================
-
-void ModbusTcpService::initializeDeviceFailureTracking() {
-  deviceFailureStates.clear();
-
-  for (const auto& device : tcpDevices) {
-    DeviceFailureState state;
-    state.deviceId = device.deviceId;
-    state.consecutiveFailures = 0;
-    state.retryCount = 0;
-    state.nextRetryTime = 0;
-    state.lastReadAttempt = 0;
-    state.lastSuccessfulRead = 0;
-    state.isEnabled = true;
-    state.maxRetries = 5;
-    state.disableReason = DeviceFailureState::NONE;
-    state.disableReasonDetail = "";
-    state.disabledTimestamp = 0;
-    deviceFailureStates.push_back(state);
-  }
-  // Concise summary log
-  LOG_TCP_INFO("[TCP] Failure tracking init: %d devices\n",
-               deviceFailureStates.size());
-}
-
-void ModbusTcpService::initializeDeviceTimeouts() {
-  deviceTimeouts.clear();
-
-  for (const auto& device : tcpDevices) {
-    DeviceReadTimeout timeout;
-    timeout.deviceId = device.deviceId;
-    timeout.timeoutMs = 5000;
-    timeout.consecutiveTimeouts = 0;
-    timeout.lastSuccessfulRead = millis();
-    timeout.maxConsecutiveTimeouts = 3;
-    deviceTimeouts.push_back(timeout);
+void ModbusTcpService::closeEndpointConnections(const char* ip, int port) {
+  if (!poolMutex) {
+    return;
   }
-  // Concise summary log
-  LOG_TCP_INFO("[TCP] Timeout tracking init: %d devices\n",
-               deviceTimeouts.size());
-}
-
-void ModbusTcpService::initializeDeviceMetrics() {
-  deviceMetrics.clear();
 
-  for (const auto& device : tcpDevices) {
-    DeviceHealthMetrics metrics;
-    metrics.deviceId = device.deviceId;
-    metrics.totalReads = 0;
-    metrics.successfulReads = 0;
-    metrics.failedReads = 0;
-    metrics.totalResponseTimeMs = 0;
-    metrics.minResponseTimeMs = 65535;
-    metrics.maxResponseTimeMs = 0;
-    metrics.lastResponseTimeMs = 0;
-    deviceMetrics.push_back(metrics);
-  }
-  // Concise summary log
-  LOG_TCP_INFO("[TCP] Metrics tracking init: %d devices\n",
-               deviceMetrics.size());
-}
+  if (TaskProfiler::take(poolMutex, pdMS_TO_TICKS(1000),
+                         ProfiledLock::TCP_POOL) != pdTRUE) {
+    return;
+  }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-ModbusTcpService::DeviceFailureState* ModbusTcpService::getDeviceFailureState(
-    const char* deviceId) {
-  for (auto& state : deviceFailureStates) {
-    // v2.5.41: PSRAMString comparison with const char*
-    if (strcmp(state.deviceId.c_str(), deviceId) == 0) {
-      return &state;
+  // Connections held by a running write are left to that write (idle cleanup
+  // closes them afterwards)
+  PSRAMString deviceKey = getDeviceKey(ip, port);
+  for (auto it = connectionPool.begin(); it != connectionPool.end();) {
+    if (it->inUse || it->deviceKey != deviceKey) {
+      ++it;
+      continue;
+    }
+    LOG_TCP_INFO("Closing pooled connection %s (device config changed)\n",
+                 deviceKey.c_str());
+    if (it->client) {
+      it->client->stop();
+      delete it->client;
     }
+    it = connectionPool.erase(it);
   }
-  return nullptr;
+
+  xSemaphoreGive(poolMutex);
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-ModbusTcpService::DeviceReadTimeout* ModbusTcpService::getDeviceTimeout(
-    const char* deviceId) {
-  for (auto& timeout : deviceTimeouts) {
-    // v2.5.41: PSRAMString comparison with const char*
-    if (strcmp(timeout.deviceId.c_str(), deviceId) == 0) {
-      return &timeout;
-    }
-  }
-  return nullptr;
+// ============================================
+// NEW: Enhancement - Device Failure and Metrics Management
+// ============================================
+
+void ModbusTcpService::initializeDeviceState(TcpDeviceConfig& device) {
+  device.state = ModbusDeviceState();
+  device.state.timeout.lastSuccessfulRead = millis();
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-ModbusTcpService::DeviceHealthMetrics* ModbusTcpService::getDeviceMetrics(
+// v1.3.3: O(1) ID lookup for BLE/MQTT commands (was a strcmp scan per
+// tracking vector). Caller holds vectorMutex or runs in the polling task.
+ModbusTcpService::TcpDeviceConfig* ModbusTcpService::findDevice(
     const char* deviceId) {
-  for (auto& metrics : deviceMetrics) {
-    // v2.5.41: PSRAMString comparison with const char*
-    if (strcmp(metrics.deviceId.c_str(), deviceId) == 0) {
-      return &metrics;
-    }
+  uint16_t slot = deviceIndex.find(deviceId, [&](uint16_t candidate) {
+    return candidate < tcpDevices.size() &&
+           strcmp(tcpDevices[candidate].deviceId.c_str(), deviceId) == 0;
+  });
+  if (slot == ModbusDeviceIndex::INVALID_SLOT) {
+    return nullptr;
   }
-  return nullptr;
+  return &tcpDevices[slot];
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::enableDevice(const char* deviceId, bool clearMetrics) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+void ModbusTcpService::enableDevice(TcpDeviceConfig& device,
+                                    bool clearMetrics) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->isEnabled = true;
-  state->disableReason = DeviceFailureState::NONE;
+  state->disableReason = ModbusDisableReason::NONE;
   state->disableReasonDetail = "";
   state->disabledTimestamp = 0;
-  resetDeviceFailureState(deviceId);
+  state->failedProbes = 0;  // v1.3.3
+  resetDeviceFailureState(device);
 
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  if (timeout) {
-    timeout->consecutiveTimeouts = 0;
-    timeout->lastSuccessfulRead = millis();
-  }
+  DeviceReadTimeout& timeout = device.state.timeout;
+  timeout.consecutiveTimeouts = 0;
+  timeout.lastSuccessfulRead = millis();
 
   if (clearMetrics) {
-    DeviceHealthMetrics* metrics = getDeviceMetrics(deviceId);
-    if (metrics) {
-      metrics->totalReads = 0;
-      metrics->successfulReads = 0;
-      metrics->failedReads = 0;
-      metrics->totalResponseTimeMs = 0;
-      metrics->minResponseTimeMs = 65535;
-      metrics->maxResponseTimeMs = 0;
-      metrics->lastResponseTimeMs = 0;
-      LOG_TCP_INFO("[TCP] Device %s metrics cleared\n", deviceId);
-    }
+    device.state.metrics.reset();
+    device.state.cycle.reset();  // v1.3.3
+    LOG_TCP_INFO("[TCP] Device %s metrics cleared\n", deviceId);
   }
 
   LOG_TCP_INFO("[TCP] Device %s enabled (reason cleared)\n", deviceId);
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::disableDevice(const char* deviceId,
-                                     DeviceFailureState::DisableReason reason,
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+void ModbusTcpService::disableDevice(TcpDeviceConfig& device,
+                                     ModbusDisableReason reason,
                                      const char* reasonDetail) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->isEnabled = false;
   state->disableReason = reason;
   state->disableReasonDetail = reasonDetail ? reasonDetail : "";
   state->disabledTimestamp = millis();
+  state->failedProbes = 0;  // v1.3.3
 
   const char* reasonText = "";
   switch (reason) {
-    case DeviceFailureState::MANUAL:
+    case ModbusDisableReason::MANUAL:
       reasonText = "MANUAL";
       break;
-    case DeviceFailureState::AUTO_RETRY:
+    case ModbusDisableReason::AUTO_RETRY:
       reasonText = "AUTO_RETRY";
       break;
-    case DeviceFailureState::AUTO_TIMEOUT:
+    case ModbusDisableReason::AUTO_TIMEOUT:
       reasonText = "AUTO_TIMEOUT";
       break;
     default:
@@ -1840,11 +2647,10 @@ void ModbusTcpService::disableDevice(const char* deviceId,
                reasonText, reasonDetail ? reasonDetail : "");
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::handleReadFailure(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+void ModbusTcpService::handleReadFailure(TcpDeviceConfig& device) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceFailureState* state = &device.state.failure;
 
   state->consecutiveFailures++;
   state->lastReadAttempt = millis();
@@ -1859,19 +2665,18 @@ void ModbusTcpService::handleReadFailure(const char* deviceId) {
   } else {
     LOG_TCP_INFO("[TCP] Device %s exceeded max retries (%d), disabling...\n",
                  deviceId, state->maxRetries);
-    disableDevice(deviceId, DeviceFailureState::AUTO_RETRY,
+    disableDevice(device, ModbusDisableReason::AUTO_RETRY,
                   "Max retries exceeded");
   }
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-bool ModbusTcpService::shouldRetryDevice(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state || !state->isEnabled) return false;
-  if (state->retryCount == 0) return false;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+bool ModbusTcpService::shouldRetryDevice(const TcpDeviceConfig& device) {
+  const DeviceFailureState& state = device.state.failure;
+  if (!state.isEnabled) return false;
+  if (state.retryCount == 0) return false;
 
-  return millis() >= state->nextRetryTime;
+  return millis() >= state.nextRetryTime;
 }
 
 unsigned long ModbusTcpService::calculateBackoffTime(uint8_t retryCount) {
@@ -1884,29 +2689,26 @@ unsigned long ModbusTcpService::calculateBackoffTime(uint8_t retryCount) {
   return backoff + jitter;
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::resetDeviceFailureState(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+void ModbusTcpService::resetDeviceFailureState(TcpDeviceConfig& device) {
+  DeviceFailureState* state = &device.state.failure;
 
   state->consecutiveFailures = 0;
   state->retryCount = 0;
   state->nextRetryTime = 0;
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-void ModbusTcpService::handleReadTimeout(const char* deviceId) {
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  if (!timeout) return;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+void ModbusTcpService::handleReadTimeout(TcpDeviceConfig& device) {
+  const char* deviceId = device.deviceId.c_str();
+  DeviceReadTimeout* timeout = &device.state.timeout;
 
   timeout->consecutiveTimeouts++;
 
   if (timeout->consecutiveTimeouts >= timeout->maxConsecutiveTimeouts) {
     LOG_TCP_INFO("[TCP] Device %s exceeded timeout limit (%d), disabling...\n",
                  deviceId, timeout->maxConsecutiveTimeouts);
-    disableDevice(deviceId, DeviceFailureState::AUTO_TIMEOUT,
+    disableDevice(device, ModbusDisableReason::AUTO_TIMEOUT,
                   "Max consecutive timeouts exceeded");
   } else {
     LOG_TCP_INFO("[TCP] Device %s timeout %d/%d\n", deviceId,
@@ -1914,12 +2716,9 @@ void ModbusTcpService::handleReadTimeout(const char* deviceId) {
   }
 }
 
-// v2.5.41: Changed from const String& to const char* for consistency with RTU
-// service
-bool ModbusTcpService::isDeviceEnabled(const char* deviceId) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) return true;
-  return state->isEnabled;
+// v1.3.3: Device entry instead of ID (v2.5.41: was const char*)
+bool ModbusTcpService::isDeviceEnabled(const TcpDeviceConfig& device) {
+  return device.state.failure.isEnabled;
 }
 
 // ============================================
@@ -1933,13 +2732,13 @@ bool ModbusTcpService::enableDeviceByCommand(const char* deviceId,
   LOG_TCP_INFO("[TCP] BLE Command: Enable device %s (clearMetrics: %s)\n",
                deviceId, clearMetrics ? "true" : "false");
 
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  TcpDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_TCP_INFO("[TCP] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  enableDevice(deviceId, clearMetrics);
+  enableDevice(*device, clearMetrics);
   return true;
 }
 
@@ -1950,28 +2749,30 @@ bool ModbusTcpService::disableDeviceByCommand(const char* deviceId,
   LOG_TCP_INFO("[TCP] BLE Command: Disable device %s (reason: %s)\n", deviceId,
                reasonDetail ? reasonDetail : "");
 
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+  TcpDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_TCP_INFO("[TCP] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  disableDevice(deviceId, DeviceFailureState::MANUAL, reasonDetail);
+  disableDevice(*device, ModbusDisableReason::MANUAL, reasonDetail);
   return true;
 }
 
 // v2.5.41: Changed from const String& to const char* for consistency with RTU
 // service
 bool ModbusTcpService::getDeviceStatusInfo(const char* deviceId,
-                                           JsonObject& statusInfo) {
-  DeviceFailureState* state = getDeviceFailureState(deviceId);
-  if (!state) {
+                                           JsonObject& statusInfo,
+                                           bool includeHistogram) {
+  TcpDeviceConfig* device = findDevice(deviceId);
+  if (!device) {
     LOG_TCP_INFO("[TCP] ERROR: Device %s not found\n", deviceId);
     return false;
   }
 
-  DeviceReadTimeout* timeout = getDeviceTimeout(deviceId);
-  DeviceHealthMetrics* metrics = getDeviceMetrics(deviceId);
+  const DeviceFailureState* state = &device->state.failure;
+  const DeviceReadTimeout* timeout = &device->state.timeout;
+  const DeviceHealthMetrics* metrics = &device->state.metrics;
 
   statusInfo["device_id"] = deviceId;
   statusInfo["enabled"] = state->isEnabled;
@@ -1980,16 +2781,16 @@ bool ModbusTcpService::getDeviceStatusInfo(const char* deviceId,
 
   const char* reasonText = "";
   switch (state->disableReason) {
-    case DeviceFailureState::NONE:
+    case ModbusDisableReason::NONE:
       reasonText = "NONE";
       break;
-    case DeviceFailureState::MANUAL:
+    case ModbusDisableReason::MANUAL:
       reasonText = "MANUAL";
       break;
-    case DeviceFailureState::AUTO_RETRY:
+    case ModbusDisableReason::AUTO_RETRY:
       reasonText = "AUTO_RETRY";
       break;
-    case DeviceFailureState::AUTO_TIMEOUT:
+    case ModbusDisableReason::AUTO_TIMEOUT:
       reasonText = "AUTO_TIMEOUT";
       break;
   }
@@ -2000,23 +2801,34 @@ bool ModbusTcpService::getDeviceStatusInfo(const char* deviceId,
     unsigned long disabledDuration = millis() - state->disabledTimestamp;
     statusInfo["disabled_duration_ms"] = disabledDuration;
   }
+  statusInfo["failed_probes"] = state->failedProbes;  // v1.3.3
 
-  if (timeout) {
-    statusInfo["timeout_ms"] = timeout->timeoutMs;
-    statusInfo["consecutive_timeouts"] = timeout->consecutiveTimeouts;
-    statusInfo["max_consecutive_timeouts"] = timeout->maxConsecutiveTimeouts;
+  statusInfo["timeout_ms"] = timeout->timeoutMs;
+  statusInfo["consecutive_timeouts"] = timeout->consecutiveTimeouts;
+  statusInfo["max_consecutive_timeouts"] = timeout->maxConsecutiveTimeouts;
+
+  JsonObject metricsObj = statusInfo["metrics"].to<JsonObject>();
+  metricsObj["total_reads"] = metrics->totalReads;
+  metricsObj["successful_reads"] = metrics->successfulReads;
+  metricsObj["failed_reads"] = metrics->failedReads;
+  metricsObj["success_rate"] = metrics->getSuccessRate();
+  metricsObj["avg_response_time_ms"] = metrics->getAvgResponseTimeMs();
+  metricsObj["min_response_time_ms"] = metrics->minResponseTimeMs;
+  metricsObj["max_response_time_ms"] = metrics->maxResponseTimeMs;
+  metricsObj["last_response_time_ms"] = metrics->lastResponseTimeMs;
+  metrics->latency.writeStatus(metricsObj, includeHistogram);  // v1.3.3
+
+  // v1.3.3: Interval in use ("adaptive_refresh")
+  statusInfo["refresh_rate_ms"] = device->plan.pollIntervalMs();
+  if (device->plan.adaptive.enabled) {
+    statusInfo["change_rate_percent"] = device->plan.adaptive.changePercent;
   }
 
-  if (metrics) {
-    JsonObject metricsObj = statusInfo["metrics"].to<JsonObject>();
-    metricsObj["total_reads"] = metrics->totalReads;
-    metricsObj["successful_reads"] = metrics->successfulReads;
-    metricsObj["failed_reads"] = metrics->failedReads;
-    metricsObj["success_rate"] = metrics->getSuccessRate();
-    metricsObj["avg_response_time_ms"] = metrics->getAvgResponseTimeMs();
-    metricsObj["min_response_time_ms"] = metrics->minResponseTimeMs;
-    metricsObj["max_response_time_ms"] = metrics->maxResponseTimeMs;
-    metricsObj["last_response_time_ms"] = metrics->lastResponseTimeMs;
+  // v1.3.3: Poll cycle duration vs refresh interval
+  JsonObject cycleObj = statusInfo["cycle"].to<JsonObject>();
+  device->state.cycle.writeStatus(cycleObj, device->plan.pollIntervalMs());
+  if (device->endpoint < endpointLoads.size()) {
+    statusInfo["endpoint"] = endpointLoads[device->endpoint].key.c_str();
   }
 
   return true;
@@ -2028,13 +2840,50 @@ bool ModbusTcpService::getAllDevicesStatus(JsonObject& allStatus) {
   for (const auto& device : tcpDevices) {
     JsonObject deviceStatus = devicesArray.add<JsonObject>();
     // v2.5.41: Pass PSRAMString as const char*
-    getDeviceStatusInfo(device.deviceId.c_str(), deviceStatus);
+    getDeviceStatusInfo(device.deviceId.c_str(), deviceStatus, false);
+  }
+
+  // v1.3.3: Capacity per IP:port (serial gateways: all units behind it) -
+  // measured busy share, summed device demand and deadline misses
+  JsonArray endpoints = allStatus["endpoints"].to<JsonArray>();
+  if (xSemaphoreTakeRecursive(vectorMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+    for (size_t e = 0; e < endpointLoads.size(); e++) {
+      uint32_t demand = 0;
+      uint32_t missed = 0;
+      uint32_t overruns = 0;
+      uint16_t devices = 0;
+      for (const auto& device : tcpDevices) {
+        if (device.endpoint != e) continue;
+        const ModbusCycleMetrics& cycle = device.state.cycle;
+        devices++;
+        demand += cycle.demandPercent(device.plan.pollIntervalMs());
+        missed += cycle.missedDeadlines;
+        overruns += cycle.overruns;
+      }
+      JsonObject endpoint = endpoints.add<JsonObject>();
+      endpoint["endpoint"] = endpointLoads[e].key.c_str();
+      endpoint["devices"] = devices;
+      endpoint["utilization_percent"] = endpointLoads[e].utilization.percent;
+      endpoint["demand_percent"] = demand;
+      endpoint["missed_deadlines"] = missed;
+      endpoint["overruns"] = overruns;
+    }
+    xSemaphoreGiveRecursive(vectorMutex);
   }
 
   allStatus["total_devices"] = tcpDevices.size();
+  // v1.3.3: Buckets of the bus (device entries carry the percentiles only)
+  JsonObject buses = allStatus["buses"].to<JsonObject>();
+  getBusLatencyStatus(buses, true);
   return true;
 }
 
+void ModbusTcpService::getBusLatencyStatus(JsonObject& buses,
+                                           bool includeHistogram) {
+  JsonObject bus = buses["tcp"].to<JsonObject>();
+  busLatency.writeStatus(bus, includeHistogram);
+}
+
 // ============================================
 // NEW: Enhancement - Auto-Recovery Task
 // ============================================
@@ -2058,23 +2907,62 @@ void ModbusTcpService::autoRecoveryLoop() {
     if (!running) break;
 
     LOG_TCP_INFO("[TCP AutoRecovery] Checking for auto-disabled devices...");
-    unsigned long now = millis();
 
-    for (auto& state : deviceFailureStates) {
-      if (!state.isEnabled &&
-          (state.disableReason == DeviceFailureState::AUTO_RETRY ||
-           state.disableReason == DeviceFailureState::AUTO_TIMEOUT)) {
-        unsigned long disabledDuration = now - state.disabledTimestamp;
-        LOG_TCP_INFO(
-            "[TCP AutoRecovery] Device %s auto-disabled for %lu ms, attempting "
-            "recovery...\n",
-            state.deviceId.c_str(), disabledDuration);
-
-        // v2.5.41: Pass PSRAMString as const char*
-        enableDevice(state.deviceId.c_str(), false);
-        LOG_TCP_INFO("[TCP AutoRecovery] Device %s re-enabled\n",
-                     state.deviceId.c_str());
+    // v1.3.3: Probe first, re-enable only a device that answers. The probe
+    // runs without vectorMutex (the polling task holds it for a whole
+    // round), so the device is looked up again afterwards.
+    for (size_t i = 0; running; i++) {
+      xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+      if (i >= tcpDevices.size()) {
+        xSemaphoreGiveRecursive(vectorMutex);
+        break;
+      }
+      TcpDeviceConfig& device = tcpDevices[i];
+      if (!device.state.failure.autoDisabled()) {
+        xSemaphoreGiveRecursive(vectorMutex);
+        continue;
       }
+      InternedString deviceId = device.deviceId;
+      unsigned long disabledDuration =
+          millis() - device.state.failure.disabledTimestamp;
+      // The handle keeps the ip string alive after the mutex is released
+      ConfigManager::DeviceConfigHandle doc = device.doc;
+      const char* ip = (*doc)["ip"] | "";
+      int port = (*doc)["port"] | 502;
+      uint8_t slaveId = device.plan.slaveId;
+      bool probed = !device.plan.spans.empty() && strlen(ip) > 0;
+      ModbusReadSpan span;
+      if (probed) span = device.plan.spans.front();
+      xSemaphoreGiveRecursive(vectorMutex);
+
+      LOG_TCP_INFO(
+          "[TCP AutoRecovery] Device %s auto-disabled for %lu ms, probing...\n",
+          deviceId.c_str(), disabledDuration);
+      bool busy = false;
+      bool answered =
+          !probed ||
+          probeDevice(ip, port, slaveId, span, &busy);
+      if (busy) {
+        continue;  // Endpoint in use, next round
+      }
+
+      xSemaphoreTakeRecursive(vectorMutex, portMAX_DELAY);
+      TcpDeviceConfig* current = findDevice(deviceId.c_str());
+      if (current && current->state.failure.autoDisabled()) {
+        if (answered) {
+          enableDevice(*current, false);  // Don't clear metrics
+          LOG_TCP_INFO("[TCP AutoRecovery] Device %s re-enabled\n",
+                       deviceId.c_str());
+        } else {
+          DeviceFailureState& state = current->state.failure;
+          if (state.failedProbes < UINT16_MAX) state.failedProbes++;
+          LOG_TCP_INFO(
+              "[TCP AutoRecovery] Device %s still not answering (%u failed "
+              "probes)\n",
+              deviceId.c_str(), state.failedProbes);
+        }
+      }
+      xSemaphoreGiveRecursive(vectorMutex);
     }
   }
 
@@ -2085,6 +2973,66 @@ void ModbusTcpService::autoRecoveryLoop() {
   vTaskDelete(NULL);                 // Delete self (NULL = current task)
 }
 
+// v1.3.3: Any reply (data or a Modbus exception from the slave) means the
+// device is back. Gateway exceptions (0x0A path unavailable, 0x0B target
+// failed to respond) come from a serial gateway whose slave is still silent.
+bool ModbusTcpService::probeDevice(const char* ip, int port, uint8_t slaveId,
+                                   const ModbusReadSpan& span, bool* busy) {
+  TCPClient* client = getPooledConnection(ip, port, true, busy);
+  if (!client) {
+    return false;
+  }
+
+  // Non-blocking connect with the short probe timeout (not the 5s default)
+  unsigned long start = millis();
+  int state = client->isConnecting() ? 0 : 1;
+  while (state == 0) {
+    state = client->pollConnect();
+    if (state == 0) {
+      if ((millis() - start) >=
+          ModbusRecoveryConfig::PROBE_CONNECT_TIMEOUT_MS) {
+        state = -1;
+      } else {
+        vTaskDelay(pdMS_TO_TICKS(10));
+      }
+    }
+  }
+
+  bool answered = false;
+  bool inSync = false;  // Reply received: connection reusable
+  if (state > 0) {
+    uint16_t result[1] = {0};
+    uint8_t exceptionCode = 0;
+    bool success =
+        readModbusSpan(ip, port, slaveId, span.functionCode, span.startAddress,
+                       1, result, &exceptionCode, client,
+                       ModbusRecoveryConfig::PROBE_TIMEOUT_MS);
+    answered = success || (exceptionCode != 0 && exceptionCode != 0x0A &&
+                           exceptionCode != 0x0B);
+    inSync = success || exceptionCode != 0;
+  }
+
+  returnPooledConnection(ip, port, client, inSync);
+  return answered;
+}
+
+// v1.3.3: Busiest endpoint and deadline misses for the ProductionLogger
+// heartbeat
+void ModbusTcpService::getCapacitySummary(uint8_t& peakUtilization,
+                                          uint32_t& missedDeadlines) {
+  peakUtilization = 0;
+  missedDeadlines = 0;
+  if (xSemaphoreTakeRecursive(vectorMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    for (const EndpointLoad& load : endpointLoads) {
+      peakUtilization = std::max(peakUtilization, load.utilization.percent);
+    }
+    for (const auto& device : tcpDevices) {
+      missedDeadlines += device.state.cycle.missedDeadlines;
+    }
+    xSemaphoreGiveRecursive(vectorMutex);
+  }
+}
+
 // v2.5.35: Get aggregated Modbus stats for ProductionLogger
 void ModbusTcpService::getAggregatedStats(uint32_t& totalSuccess,
                                           uint32_t& totalFailed) {
@@ -2092,9 +3040,9 @@ void ModbusTcpService::getAggregatedStats(uint32_t& totalSuccess,
   totalFailed = 0;
 
   if (xSemaphoreTake(vectorMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    for (const auto& metrics : deviceMetrics) {
-      totalSuccess += metrics.successfulReads;
-      totalFailed += metrics.failedReads;
+    for (const auto& device : tcpDevices) {
+      totalSuccess += device.state.metrics.successfulReads;
+      totalFailed += device.state.metrics.failedReads;
     }
     xSemaphoreGive(vectorMutex);
   }
@@ -2123,18 +3071,16 @@ bool ModbusTcpService::writeRegisterValue(const char* deviceId,
   JsonObject registerConfig;
   bool found = false;
 
-  for (auto& device : tcpDevices) {
-    if (strcmp(device.deviceId.c_str(), deviceId) == 0) {
-      deviceConfig = device.doc->as<JsonObject>();
-      JsonArray registers = deviceConfig["registers"];
-      for (JsonVariant reg : registers) {
-        if (strcmp(reg["register_id"].as<const char*>(), registerId) == 0) {
-          registerConfig = reg.as<JsonObject>();
-          found = true;
-          break;
-        }
+  TcpDeviceConfig* device = findDevice(deviceId);  // v1.3.3: Hashed lookup
+  if (device) {
+    deviceConfig = device->doc->as<JsonObject>();
+    JsonArray registers = deviceConfig["registers"];
+    for (JsonVariant reg : registers) {
+      if (strcmp(reg["register_id"].as<const char*>(), registerId) == 0) {
+        registerConfig = reg.as<JsonObject>();
+        found = true;
+        break;
       }
-      break;
     }
   }
 
@@ -2219,7 +3165,15 @@ bool ModbusTcpService::writeRegisterValue(const char* deviceId,
   // v1.2.1 FIX: Don't use connected() check - it's unreliable for pooled connections
   // getPooledConnection() already ensures the connection is healthy or creates a new one
   // If getPooledConnection() returns nullptr, it means the actual TCP connect() failed
-  TCPClient* pooledClient = getPooledConnection(ipAddress, port);
+  // v1.3.3: Wait while the polling engine has a read in flight on it
+  bool busy = false;
+  TCPClient* pooledClient = getPooledConnection(ipAddress, port, false, &busy);
+  unsigned long busyStart = millis();
+  while (!pooledClient && busy &&
+         (millis() - busyStart) < ModbusTcpConfig::TIMEOUT_MS) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+    pooledClient = getPooledConnection(ipAddress, port, false, &busy);
+  }
   if (!pooledClient) {
     response["status"] = "error";
     response["error"] = "Failed to connect to device for write operation";
@@ -2293,6 +3247,7 @@ bool ModbusTcpService::writeRegisterValue(const char* deviceId,
     request[4] = (pduLen >> 8) & 0xFF;
     request[5] = pduLen & 0xFF;
   } else {
+    returnPooledConnection(ipAddress, port, pooledClient, true);
     response["status"] = "error";
     response["error"] = "Invalid write function code";
     response["error_code"] = 322;  // ERR_MODBUS_WRITE_INVALID_FC
@@ -2304,14 +3259,16 @@ bool ModbusTcpService::writeRegisterValue(const char* deviceId,
   pooledClient->write(request, reqLen);
 
   // Wait for response (timeout 5s)
+  // v1.3.3: Readiness wait + MBAP framing (was 10ms available() polling and
+  // one read of whatever had arrived)
   unsigned long timeout = 5000;
-  while (pooledClient->available() < 8 && (millis() - startTime) < timeout) {
-    vTaskDelay(pdMS_TO_TICKS(10));
-  }
+  uint8_t respBuffer[32];
+  int respLen = receiveFrame(pooledClient, transactionId, respBuffer,
+                             sizeof(respBuffer), timeout);
 
   unsigned long responseTime = millis() - startTime;
 
-  if (pooledClient->available() < 8) {
+  if (respLen == 0) {
     response["status"] = "error";
     response["error"] = "Write response timeout";
     response["error_code"] = 323;  // ERR_MODBUS_WRITE_TIMEOUT
@@ -2320,10 +3277,6 @@ bool ModbusTcpService::writeRegisterValue(const char* deviceId,
     return false;
   }
 
-  // Read response
-  uint8_t respBuffer[32];
-  int respLen = pooledClient->read(respBuffer, sizeof(respBuffer));
-
   // 11. Parse response
   if (respLen >= 8) {
     uint8_t respFC = respBuffer[7];
@@ -2389,6 +3342,15 @@ ModbusTcpService::~ModbusTcpService() {
   // FIXED BUG #14: Clean up connection pool
   closeAllConnections();
 
+  if (connections) {
+    heap_caps_free(connections);
+    connections = nullptr;
+  }
+  if (transactions) {
+    heap_caps_free(transactions);
+    transactions = nullptr;
+  }
+
   if (poolMutex) {
     vSemaphoreDelete(poolMutex);
     poolMutex = nullptr;
@@ -13,8 +13,12 @@
 #include "ConfigManager.h"
 #include "EthernetManager.h"
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+#include "ModbusDeviceTypes.h"  // v1.3.3: Shared per-device state record
+#include "ModbusPollPlan.h"     // v1.3.3: Compiled per-device register plan
 #include "ModbusUtils.h"        // Shared Modbus data parsing utilities
 #include "PSRAMString.h"  // v2.5.41: Unified PSRAMString for TCP (was using Arduino String)
+#include "PollScheduler.h"  // v1.3.3: Deadline-ordered device schedule
+#include "StringIntern.h"  // v1.3.3: Interned device IDs
 #include "TCPClient.h"  // FIXED BUG #14: Required for connection pooling
 
 // FIXED Bug #10: Named constants instead of magic numbers
@@ -26,6 +30,26 @@ constexpr uint16_t MAX_RESPONSE_SIZE =
 constexpr uint8_t MODBUS_TCP_HEADER_SIZE =
     12;                                   // Modbus TCP request header size
 constexpr uint8_t MIN_RESPONSE_SIZE = 9;  // Minimum Modbus TCP response size
+
+// v1.3.3: Concurrent polling engine
+constexpr uint8_t MAX_CONCURRENT_DEVICES =
+    4;  // Device reads in flight at once (1 = sequential polling)
+constexpr uint32_t CONNECT_TIMEOUT_MS =
+    3000;  // Non-blocking connect (WiFi) - device skipped after this
+constexpr uint32_t DRAM_PER_TRANSACTION =
+    8192;  // Estimated internal RAM per open socket (lwIP PCB + buffers)
+constexpr uint32_t DRAM_RESERVE =
+    65536;  // Free DRAM kept for the rest of the system (emergency pool
+            // cleanup starts at 50KB)
+constexpr uint32_t READINESS_WAIT_MS =
+    10;  // Max select() wait per engine round
+constexpr uint32_t MAX_IDLE_WAIT_MS =
+    1000;  // Longest sleep between passes (BLE pause / memory recovery /
+           // pool cleanup checks); config changes wake the task immediately
+constexpr uint32_t BUSY_RETRY_MS =
+    100;  // Device whose connection is held by a register write
+constexpr size_t POLL_ARENA_SIZE =
+    16384;  // v1.3.3: Polled-data JSON of one device read (PSRAM)
 }  // namespace ModbusTcpConfig
 
 class ModbusTcpService {
@@ -39,17 +63,23 @@ class ModbusTcpService {
   // Task notifications can be missed if task is blocked in TCP operations
   std::atomic<bool> configChangePending{false};
 
+  // v1.3.3: Devices changed since the last refresh (see ModbusChangeSet;
+  // touched by the CRUD task, guarded by changeMux)
+  ModbusChangeSet pendingChanges;
+  portMUX_TYPE changeMux = portMUX_INITIALIZER_UNLOCKED;
+
   // 2-Level Polling Hierarchy (CLEANUP: Removed Level 1 per-register polling)
 
   // Level 1: Device-level timing (device refresh_rate)
-  // v2.5.41: Changed from String to PSRAMString (unified with RTU service)
-  struct DeviceTimer {
-    PSRAMString deviceId;  // v2.5.41: PSRAMString for memory efficiency
-    unsigned long
-        lastRead;  // Last time device's registers were collectively polled
-    uint32_t refreshRateMs;  // Device-level interval
-  };
-  std::vector<DeviceTimer> deviceTimers;
+  // v1.3.3: PollScheduler (was a DeviceTimer list scanned by
+  // shouldPollDevice() for every device on every loop)
+  PollScheduler schedule;
+
+  // v1.3.3: Documents of one device read (reset per read, TCP task only)
+  ArduinoJson::ArenaAllocator pollArena;
+
+  // v1.3.3: Response times of all TCP devices (TCP task only)
+  ModbusLatencyHistogram busLatency;
 
   // Level 2: Server data transmission interval (data_interval untuk MQTT/HTTP)
   struct DataTransmissionInterval {
@@ -60,89 +90,37 @@ class ModbusTcpService {
 
   // v2.5.41: Changed from String to PSRAMString (unified with RTU service)
   struct TcpDeviceConfig {
-    PSRAMString deviceId;  // v2.5.41: PSRAMString for memory efficiency
-    std::unique_ptr<JsonDocument>
-        doc;  // FIXED Bug #2: Use smart pointer for auto-cleanup
+    InternedString deviceId;  // v1.3.3: StringIntern handle (was PSRAMString)
+    // FIXED Bug #2: Use smart pointer for auto-cleanup
+    // v1.3.3: Shared with the ConfigManager generation (read-only, no copy)
+    ConfigManager::DeviceConfigHandle doc;
+    CompiledDevicePlan plan;  // v1.3.3: Compiled from doc (rebuilt together)
+    uint32_t nextPollMs = 0;  // v1.3.3: Scheduled deadline (kept on refresh)
+    ModbusDeviceState state;  // v1.3.3: Failure / timeout / metrics record
+    // v1.3.3: Another TCP device has the same IP:port (serial gateway)
+    bool sharedEndpoint = false;
+    uint16_t endpoint = 0;  // v1.3.3: endpointLoads index
   };
   std::vector<TcpDeviceConfig> tcpDevices;
 
-  // NEW: Enhancement - Device Failure State Tracking (matching RTU service)
-  // v2.5.41: Changed from String to PSRAMString (unified with RTU service)
-  struct DeviceFailureState {
-    PSRAMString deviceId;  // v2.5.41: PSRAMString for memory efficiency
-    uint8_t consecutiveFailures = 0;
-    uint8_t retryCount = 0;
-    unsigned long nextRetryTime = 0;
-    unsigned long lastReadAttempt = 0;
-    unsigned long lastSuccessfulRead = 0;
-    bool isEnabled = true;
-    uint32_t maxRetries = 5;
-
-    // Flexible disable reason tracking
-    enum DisableReason {
-      NONE = 0,
-      MANUAL = 1,
-      AUTO_RETRY = 2,
-      AUTO_TIMEOUT = 3
-    };
-    DisableReason disableReason = NONE;
-    PSRAMString
-        disableReasonDetail;  // v2.5.41: PSRAMString for memory efficiency
-    unsigned long disabledTimestamp = 0;
+  // v1.3.3: Capacity of one configured IP:port - share of time a connection
+  // to it is in use by device reads (rebuilt with the device list, kept per
+  // key across refreshes; TCP task writes, status readers take vectorMutex)
+  struct EndpointLoad {
+    PSRAMString key;  // "IP:PORT"
+    BusUtilization utilization;
   };
-  std::vector<DeviceFailureState> deviceFailureStates;
+  std::vector<EndpointLoad> endpointLoads;
 
+  // NEW: Enhancement - Device Failure State Tracking (matching RTU service)
   // NEW: Enhancement - Device Read Timeout Configuration
-  // v2.5.41: Changed from String to PSRAMString (unified with RTU service)
-  struct DeviceReadTimeout {
-    PSRAMString deviceId;  // v2.5.41: PSRAMString for memory efficiency
-    uint16_t timeoutMs = 5000;
-    uint8_t consecutiveTimeouts = 0;
-    unsigned long lastSuccessfulRead = 0;
-    uint8_t maxConsecutiveTimeouts = 3;
-  };
-  std::vector<DeviceReadTimeout> deviceTimeouts;
-
   // NEW: Enhancement - Device Health Metrics Tracking
-  // v2.5.41: Changed from String to PSRAMString (unified with RTU service)
-  struct DeviceHealthMetrics {
-    PSRAMString deviceId;  // v2.5.41: PSRAMString for memory efficiency
-
-    uint32_t totalReads = 0;
-    uint32_t successfulReads = 0;
-    uint32_t failedReads = 0;
-
-    uint32_t totalResponseTimeMs = 0;
-    uint16_t minResponseTimeMs = 65535;
-    uint16_t maxResponseTimeMs = 0;
-    uint16_t lastResponseTimeMs = 0;
-
-    float getSuccessRate() const {
-      if (totalReads == 0) return 100.0f;
-      return (successfulReads * 100.0f) / totalReads;
-    }
-
-    uint16_t getAvgResponseTimeMs() const {
-      if (successfulReads == 0) return 0;
-      return totalResponseTimeMs / successfulReads;
-    }
-
-    void recordRead(bool success, uint16_t responseTimeMs = 0) {
-      totalReads++;
-      if (success) {
-        successfulReads++;
-        totalResponseTimeMs += responseTimeMs;
-        lastResponseTimeMs = responseTimeMs;
-        if (responseTimeMs < minResponseTimeMs)
-          minResponseTimeMs = responseTimeMs;
-        if (responseTimeMs > maxResponseTimeMs)
-          maxResponseTimeMs = responseTimeMs;
-      } else {
-        failedReads++;
-      }
-    }
-  };
-  std::vector<DeviceHealthMetrics> deviceMetrics;
+  // v1.3.3: One ModbusDeviceState per device (TcpDeviceConfig::state), was
+  // three vectors searched with strcmp() on every access
+  using DeviceFailureState = ModbusDeviceFailureState;
+  using DeviceReadTimeout = ModbusDeviceReadTimeout;
+  using DeviceHealthMetrics = ModbusDeviceHealthMetrics;
+  ModbusDeviceIndex deviceIndex;  // Device ID -> tcpDevices slot
 
   // Atomic Transaction Counter (Modbus TCP Improvement Phase 2)
   static std::atomic<uint16_t> atomicTransactionCounter;
@@ -157,6 +135,9 @@ class ModbusTcpService {
     unsigned long createdAt;  // Connection creation time
     uint32_t useCount;        // Number of times reused
     bool isHealthy;           // Connection health status
+    bool inUse;  // v1.3.3: Held by a device read / write (never evicted)
+    uint32_t pollIntervalMs;  // v1.3.3: Shortest refresh_rate_ms of devices
+                              // using it (0 = unknown, eviction order)
   };
   std::vector<ConnectionPoolEntry> connectionPool;
   SemaphoreHandle_t poolMutex;  // Protect connection pool access
@@ -173,26 +154,170 @@ class ModbusTcpService {
       180000;  // Recreate after 3min (was 5min)
   static constexpr uint8_t MAX_POOL_SIZE =
       3;  // DRAM FIX (v2.3.9): Reduced from 10 to 3 (ESP32 DRAM limited!)
+          // v1.3.3: Floor of the adaptive capacity (poolCapacity)
+  // v1.3.3: Adaptive pool - one connection per configured IP:port, bounded by
+  // the lwIP socket budget and free internal RAM (updatePoolCapacity())
+  static constexpr uint8_t MAX_POOL_CONNECTIONS =
+      8;  // lwIP sockets are shared with MQTT/HTTP/BLE bridge (default 10-16)
+  static constexpr uint32_t POOL_PIN_INTERVAL_MS =
+      10000;  // Devices polled at least this often keep their connection
+              // (evicted only when every other connection is pinned too)
+  uint8_t poolCapacity = MAX_POOL_SIZE;
+  uint8_t poolEndpoints = 0;  // Distinct IP:port of the configured devices
+
+  // v1.3.3: Pool counters (getStatus)
+  uint32_t poolHits = 0;       // Healthy connection reused
+  uint32_t poolMisses = 0;     // New connection opened
+  uint32_t poolEvictions = 0;  // Closed to make room (capacity)
 
   // Connection pool methods
   // v2.5.41: Changed from String& to const char* for consistency with RTU
   // service
-  TCPClient* getPooledConnection(const char* ip, int port);
+  // v1.3.3: startOnly = non-blocking connect for new connections (caller
+  // completes it with TCPClient::pollConnect()). busy = connection in use by
+  // another transaction (nullptr returned, try again later). pollIntervalMs =
+  // caller's refresh rate (0 = not a poll, e.g. register write)
+  TCPClient* getPooledConnection(const char* ip, int port,
+                                 bool startOnly = false, bool* busy = nullptr,
+                                 uint32_t pollIntervalMs = 0);
   void returnPooledConnection(const char* ip, int port, TCPClient* client,
                               bool healthy);
+  bool evictIdleConnection();
+  void updatePoolCapacity(uint8_t concurrencyLimit);
   void closeIdleConnections();
   void closeAllConnections();
+  void closeEndpointConnections(const char* ip, int port);  // v1.3.3
   PSRAMString getDeviceKey(const char* ip, int port);
 
   static void readTcpDevicesTask(void* parameter);
   void readTcpDevicesLoop();
-  void readTcpDeviceData(const JsonObject& deviceConfig);
+
+  // ============================================
+  // v1.3.3: CONCURRENT POLLING ENGINE
+  // ============================================
+  // Previous: readTcpDevicesLoop() read devices one after another and blocked
+  // up to TIMEOUT_MS on every response, so one unreachable PLC delayed every
+  // other device (cycle time = sum of all devices).
+  // New: Up to getConcurrencyLimit() device reads are in flight at once. Each
+  // read is a small state machine (connect -> request -> response, span by
+  // span) on its own pooled connection. Sockets are never waited on
+  // individually: one engine round steps every transaction without blocking,
+  // then waits for the next readable/connected socket with select().
+  // Cycle time ~ slowest device per concurrency slot.
+  // v1.3.3: Request pipelining - per-device "pipeline_depth" requests are
+  // written back-to-back on the connection and replies are matched by MBAP
+  // transaction ID (any order). Depth 1 = one request at a time (default).
+  // v1.3.3: Serial gateways - reads of devices with the same IP:port (RTU
+  // slaves behind one Modbus TCP gateway, told apart by slave_id) share one
+  // SharedConnection instead of waiting for each other. Their spans are
+  // interleaved round-robin, at most the smallest member depth outstanding
+  // on the socket (the gateway serializes its serial line). A unit that
+  // times out or is reported unreachable by the gateway (exception 0x0A /
+  // 0x0B) fails alone; the socket is only dropped for connection faults.
+  enum class TransactionPhase : uint8_t {
+    IDLE = 0,
+    CONNECTING,  // Non-blocking connect in progress
+    TRANSFER,    // Requests being written / replies outstanding
+    DONE         // All spans handled (or device unreachable)
+  };
+
+  enum class StartResult : uint8_t {
+    STARTED,  // Transaction in flight
+    SKIPPED,  // Disabled or invalid config (rescheduled one interval on)
+    BUSY      // Connection in use elsewhere (retry later in this pass)
+  };
+
+  static constexpr uint8_t NO_CONNECTION = 0xFF;
+
+  // v1.3.3: Pooled socket of the reads in flight to one IP:port. Replies are
+  // framed here and dispatched to the member transaction by transaction ID.
+  struct SharedConnection {
+    TCPClient* client;  // nullptr = slot free
+    const char* ip;     // Points into the first member's device document
+    int port;
+    uint8_t users;  // Transactions using it (returned to the pool at 0)
+    uint16_t endpoint;        // v1.3.3: endpointLoads index
+    unsigned long busySince;  // v1.3.3: First user acquired it (micros())
+    uint8_t depth;  // Requests outstanding on the socket (smallest member)
+    uint32_t sendSeq;           // Round-robin counter of written requests
+    unsigned long lastFrameAt;  // Last complete reply frame
+    bool anyFrame;              // lastFrameAt is valid
+    bool healthy;
+    uint16_t received;  // Bytes of the current reply frame read so far
+    uint8_t response[ModbusTcpConfig::MIN_RESPONSE_SIZE + 250];
+    uint16_t words[ModbusSpanConfig::MAX_SPAN_REGISTERS];
+  };
+  SharedConnection* connections = nullptr;  // MAX_CONCURRENT_DEVICES (PSRAM)
+
+  // One request written to the connection, reply not yet matched
+  struct PipelinedRequest {
+    uint16_t transId;    // MBAP transaction ID
+    uint16_t spanIndex;  // Span in plan.spans
+    int16_t item;        // -1 = whole span, else item within the span
+    uint8_t functionCode;
+    uint16_t quantity;
+    unsigned long sentAt;
+  };
+
+  struct TcpTransaction {
+    TcpDeviceConfig* device;
+    PollSlot slot;  // Schedule entry (rescheduled by finishDeviceRead)
+    TCPClient* client;   // connections[connection].client
+    uint8_t connection;  // v1.3.3: connections index (NO_CONNECTION = none)
+    uint32_t lastSendSeq;  // v1.3.3: sendSeq of its last request (turns)
+    const char* ip;
+    int port;
+    TransactionPhase phase;
+    uint8_t depth;          // plan.pipelineDepth (max requests outstanding)
+    uint16_t nextSpan;      // Next span to request
+    uint16_t fallbackSpan;  // Span being re-read register by register
+    int16_t fallbackNext;   // Next item of fallbackSpan (-1 = none)
+    // Spans rejected with an exception, waiting for their per-register
+    // re-read. Bounded by depth: no new span is sent while one is queued.
+    uint16_t fallbackQueue[ModbusSpanConfig::MAX_PIPELINE_DEPTH];
+    uint8_t fallbackCount;
+    PipelinedRequest pending[ModbusSpanConfig::MAX_PIPELINE_DEPTH];
+    uint8_t pendingCount;   // Oldest first
+    unsigned long phaseStart;
+    unsigned long startedAt;  // v1.3.3: Device read start (readMs)
+  };
+  TcpTransaction* transactions = nullptr;  // MAX_CONCURRENT_DEVICES (PSRAM)
+  int activeTransactions = 0;  // v1.3.3: transactions[0..n) in flight
+
+  uint8_t getConcurrencyLimit() const;
+  void pollDevicesConcurrently();
+  StartResult startDeviceRead(TcpTransaction& txn, const PollSlot& slot);
+  bool stepTransaction(TcpTransaction& txn);  // true = progress made
+  bool sendNextRequest(TcpTransaction& txn);  // false = write failed
+  bool receiveResponses(TcpTransaction& txn);  // true = frame(s) handled
+  void completeRequest(TcpTransaction& txn, const PipelinedRequest& request,
+                       bool success, uint8_t exceptionCode);
+  // v1.3.3: Device metrics + bus histogram of one reply
+  void recordResponse(TcpTransaction& txn, const PipelinedRequest& request,
+                      bool success);
+  bool hasPendingWork(const TcpTransaction& txn) const;
+  // v1.3.3: Shared connection helpers
+  bool acquireConnection(TcpTransaction& txn, bool* busy);
+  void releaseConnection(TcpTransaction& txn);
+  uint8_t outstandingRequests(uint8_t connection) const;
+  bool canSendRequest(const TcpTransaction& txn) const;
+  TcpTransaction* findRequestOwner(uint8_t connection, uint16_t transId,
+                                   uint8_t* index);
+  // Fails the unit only (socket kept); failConnection() fails every member
+  // and drops the socket
+  void failDeviceRead(TcpTransaction& txn);
+  void failConnection(uint8_t connection);
+  void finishDeviceRead(TcpTransaction& txn);
+  void waitForTransactions(TcpTransaction* active, int count);
   // NOTE: processRegisterValue and processMultiRegisterValue moved to
   // ModbusUtils (shared with RTU) v2.5.41: Changed from String& to const char*
   // for consistency with RTU service
-  bool storeRegisterValue(
-      const char* deviceId, const JsonObject& reg, double value,
-      const char* deviceName = "");  // FIXED: Returns bool for error handling
+  // v1.3.3: Update latest value + enqueue one calibrated register value of
+  // a compiled plan (binary record when registry-bound). timestamp = span
+  // response time (v1.3.3: no RTC read per register).
+  // FIXED: Returns bool for error handling
+  bool storeRegisterValue(CompiledDevicePlan& plan, uint16_t registerSlot,
+                          double calibratedValue, uint32_t timestamp);
   bool readModbusRegister(const char* ip, int port, uint8_t slaveId,
                           uint8_t functionCode, uint16_t address,
                           uint16_t* result,
@@ -204,13 +329,30 @@ class ModbusTcpService {
   bool readModbusCoil(const char* ip, int port, uint8_t slaveId,
                       uint16_t address, bool* result,
                       TCPClient* existingClient = nullptr);
+  // v1.3.3: Block read of one span (FC1-4), shared planner with RTU
+  bool readModbusSpan(const char* ip, int port, uint8_t slaveId,
+                      uint8_t functionCode, uint16_t address, uint16_t quantity,
+                      uint16_t* results, uint8_t* exceptionCode,
+                      TCPClient* existingClient = nullptr,
+                      uint32_t timeoutMs = ModbusTcpConfig::TIMEOUT_MS);
+  // v1.3.3: Span response data -> words (FC1/2 bits packed LSB-first)
+  void unpackSpanData(const uint8_t* data, uint8_t functionCode,
+                      uint16_t byteCount, uint16_t quantity, uint16_t* results);
   void buildModbusRequest(uint8_t* buffer, uint16_t transId, uint8_t unitId,
                           uint8_t funcCode, uint16_t addr, uint16_t qty);
+  // v1.3.3: Read one reply frame (MBAP length field = exact frame size),
+  // waking on socket readiness. Returns frame length, 0 on timeout, -1 on an
+  // invalid frame or transaction ID mismatch.
+  int receiveFrame(TCPClient* client, uint16_t transId, uint8_t* buffer,
+                   size_t bufferSize, uint32_t timeoutMs);
   bool parseModbusResponse(uint8_t* buffer, int length, uint8_t expectedFunc,
                            uint16_t* result, bool* boolResult);
-  bool parseMultiModbusResponse(uint8_t* buffer, int length,
-                                uint8_t expectedFunc, int count,
-                                uint16_t* results);
+  // v1.3.3: Parses one complete reply frame of any read FC (1-4). Exception
+  // replies return false with exceptionCode set.
+  bool parseMultiModbusResponse(const uint8_t* buffer, int length,
+                                uint8_t expectedFunc, uint16_t count,
+                                uint16_t* results,
+                                uint8_t* exceptionCode = nullptr);
 
   void refreshDeviceList();
 
@@ -224,11 +366,9 @@ class ModbusTcpService {
                            int& successCount, int& lineNumber);
 
   // Polling Hierarchy Helper Methods (CLEANUP: Removed Level 1 per-register
-  // methods) Level 1 (Device-level): Device-level timing v2.5.41: Changed from
-  // String& to const char* for consistency with RTU service
-  DeviceTimer* getDeviceTimer(const char* deviceId);
-  bool shouldPollDevice(const char* deviceId, uint32_t refreshRateMs);
-  void updateDeviceLastRead(const char* deviceId);
+  // methods) Level 1 (Device-level): Device-level timing
+  // v1.3.3: Put a device back into the schedule one interval after slot
+  void reschedule(const PollSlot& slot, uint32_t nowMs);
 
   // Level 3 (Server-level): Data transmission interval
   bool shouldTransmitData(uint32_t dataIntervalMs);
@@ -241,41 +381,36 @@ class ModbusTcpService {
   uint16_t getNextTransactionId();
 
   // NEW: Enhancement - Device failure and metrics management
-  // v2.5.41: Changed from String& to const char* for consistency with RTU
-  // service
-  void initializeDeviceFailureTracking();
-  void initializeDeviceTimeouts();
-  void initializeDeviceMetrics();
-  struct DeviceFailureState* getDeviceFailureState(const char* deviceId);
-  struct DeviceReadTimeout* getDeviceTimeout(const char* deviceId);
-  struct DeviceHealthMetrics* getDeviceMetrics(const char* deviceId);
+  // v1.3.3: Fresh state record per device (replaces the three
+  // initializeDevice*() passes) and hashed ID lookup (replaces the
+  // getDeviceFailureState / getDeviceTimeout / getDeviceMetrics scans)
+  void initializeDeviceState(TcpDeviceConfig& device);
+  TcpDeviceConfig* findDevice(const char* deviceId);
 
   // NEW: Enhancement - Flexible enable/disable with reason tracking
-  // v2.5.41: Changed from String& to const char* for consistency with RTU
-  // service
-  void enableDevice(const char* deviceId, bool clearMetrics = false);
-  void disableDevice(const char* deviceId,
-                     DeviceFailureState::DisableReason reason,
+  // v1.3.3: Helpers take the device entry (slot) instead of its ID
+  void enableDevice(TcpDeviceConfig& device, bool clearMetrics = false);
+  void disableDevice(TcpDeviceConfig& device, ModbusDisableReason reason,
                      const char* reasonDetail = "");
 
   // Exponential backoff retry logic
-  // v2.5.41: Changed from String& to const char* for consistency with RTU
-  // service
-  void handleReadFailure(const char* deviceId);
-  bool shouldRetryDevice(const char* deviceId);
+  void handleReadFailure(TcpDeviceConfig& device);
+  bool shouldRetryDevice(const TcpDeviceConfig& device);
   unsigned long calculateBackoffTime(uint8_t retryCount);
-  void resetDeviceFailureState(const char* deviceId);
+  void resetDeviceFailureState(TcpDeviceConfig& device);
 
   // Timeout and device management
-  // v2.5.41: Changed from String& to const char* for consistency with RTU
-  // service
-  void handleReadTimeout(const char* deviceId);
-  bool isDeviceEnabled(const char* deviceId);
+  void handleReadTimeout(TcpDeviceConfig& device);
+  bool isDeviceEnabled(const TcpDeviceConfig& device);
 
   // NEW: Enhancement - Auto-recovery for auto-disabled devices
   static void autoRecoveryTask(void* parameter);
   void autoRecoveryLoop();
   TaskHandle_t autoRecoveryTaskHandle = nullptr;
+  // v1.3.3: One-register read with ModbusRecoveryConfig timeouts over a
+  // pooled connection. busy = endpoint in use by a poll (not probed).
+  bool probeDevice(const char* ip, int port, uint8_t slaveId,
+                   const ModbusReadSpan& span, bool* busy);
 
  public:
   ModbusTcpService(ConfigManager* config, EthernetManager* ethernet);
@@ -285,7 +420,8 @@ class ModbusTcpService {
   void stop();
   void getStatus(JsonObject& status);
 
-  void notifyConfigChange();
+  // v1.3.3: change = what was edited (default: unknown, rebuild all)
+  void notifyConfigChange(const ModbusConfigChange& change = {});
 
   // NEW: Enhancement - Public API for BLE device control commands
   // v2.5.41: Changed from String& to const char* for consistency with RTU
@@ -293,11 +429,19 @@ class ModbusTcpService {
   bool enableDeviceByCommand(const char* deviceId, bool clearMetrics = false);
   bool disableDeviceByCommand(const char* deviceId,
                               const char* reasonDetail = "");
-  bool getDeviceStatusInfo(const char* deviceId, JsonObject& statusInfo);
+  // v1.3.3: includeHistogram adds the device's response time buckets
+  bool getDeviceStatusInfo(const char* deviceId, JsonObject& statusInfo,
+                           bool includeHistogram = true);
   bool getAllDevicesStatus(JsonObject& allStatus);
+  // v1.3.3: Response time percentiles per bus (MQTT full status, all-devices
+  // status)
+  void getBusLatencyStatus(JsonObject& buses, bool includeHistogram);
 
   // v2.5.35: Get aggregated Modbus stats for ProductionLogger
   void getAggregatedStats(uint32_t& totalSuccess, uint32_t& totalFailed);
+  // v1.3.3: Highest endpoint utilization (%) and missed deadlines of all
+  // devices
+  void getCapacitySummary(uint8_t& peakUtilization, uint32_t& missedDeadlines);
 
   // v1.0.8: Write Register Support
   // Write a value to a Modbus TCP register (FC5, FC6, FC15, FC16)
@@ -3,6 +3,8 @@
 #include <ctype.h>
 #include <string.h>
 
+#include <algorithm>  // v1.3.3: std::sort for span planning
+
 // ============================================================================
 // SINGLE REGISTER VALUE PROCESSING
 // ============================================================================
@@ -43,106 +45,341 @@ double ModbusUtils::processMultiRegisterValue(const JsonObject& reg,
                                               uint16_t* values, int count,
                                               const char* baseType,
                                               const char* endianness_variant) {
-  // ========== 2-REGISTER (32-BIT) VALUES ==========
-  if (count == 2) {
-    uint32_t combined;
-    if (strcmp(endianness_variant, "BE") == 0) {  // Big Endian (ABCD)
-      combined = ((uint32_t)values[0] << 16) | values[1];
-    } else if (strcmp(endianness_variant, "LE") ==
-               0) {  // True Little Endian (DCBA)
-      combined = (((uint32_t)values[1] & 0xFF) << 24) |
-                 (((uint32_t)values[1] & 0xFF00) << 8) |
-                 (((uint32_t)values[0] & 0xFF) << 8) |
-                 ((uint32_t)values[0] >> 8);
-    } else if (strcmp(endianness_variant, "BE_BS") ==
-               0) {  // Big Endian + Byte Swap (BADC)
-      combined = (((uint32_t)values[0] & 0xFF) << 24) |
-                 (((uint32_t)values[0] & 0xFF00) << 8) |
-                 (((uint32_t)values[1] & 0xFF) << 8) |
-                 ((uint32_t)values[1] >> 8);
-    } else if (strcmp(endianness_variant, "LE_BS") ==
-               0) {  // Little Endian + Word Swap (CDAB)
-      combined = ((uint32_t)values[1] << 16) | values[0];
-    } else {  // Default to Big Endian
-      combined = ((uint32_t)values[0] << 16) | values[1];
+  // v1.3.3: String front-end for decodeValue() (single source of truth for
+  // word/byte ordering, also used by the compiled poll plan)
+  ModbusDataType type = parseBaseType(baseType);
+  if (getWordCount(type) != count) {
+    return values[0];  // Fallback (type/count mismatch)
+  }
+  return decodeValue(values, type, parseEndianness(endianness_variant));
+}
+
+// ============================================================================
+// v1.3.3: ENUM-BASED DECODING (hot path - no string compares)
+// ============================================================================
+
+ModbusDataType ModbusUtils::parseBaseType(const char* baseType) {
+  if (!baseType) return ModbusDataType::UINT16;
+  if (strcmp(baseType, "INT16") == 0) return ModbusDataType::INT16;
+  if (strcmp(baseType, "UINT16") == 0) return ModbusDataType::UINT16;
+  if (strcmp(baseType, "BOOL") == 0) return ModbusDataType::BOOL;
+  if (strcmp(baseType, "BINARY") == 0) return ModbusDataType::BINARY;
+  if (strcmp(baseType, "INT32") == 0) return ModbusDataType::INT32;
+  if (strcmp(baseType, "UINT32") == 0) return ModbusDataType::UINT32;
+  if (strcmp(baseType, "FLOAT32") == 0) return ModbusDataType::FLOAT32;
+  if (strcmp(baseType, "INT64") == 0) return ModbusDataType::INT64;
+  if (strcmp(baseType, "UINT64") == 0) return ModbusDataType::UINT64;
+  if (strcmp(baseType, "DOUBLE64") == 0) return ModbusDataType::DOUBLE64;
+  return ModbusDataType::UINT16;  // Unknown: raw 16-bit value
+}
+
+ModbusEndianness ModbusUtils::parseEndianness(const char* endianness) {
+  if (!endianness) return ModbusEndianness::BE;
+  if (strcmp(endianness, "LE") == 0) return ModbusEndianness::LE;
+  if (strcmp(endianness, "BE_BS") == 0) return ModbusEndianness::BE_BS;
+  if (strcmp(endianness, "LE_BS") == 0) return ModbusEndianness::LE_BS;
+  return ModbusEndianness::BE;  // Default to Big Endian
+}
+
+void ModbusUtils::parseDataType(const char* dataType, ModbusDataType& type,
+                                ModbusEndianness& endianness) {
+  // Manual uppercase conversion + split "BASE_ENDIANNESS"
+  char dataTypeBuf[32];
+  strncpy(dataTypeBuf, dataType ? dataType : "INT16", sizeof(dataTypeBuf) - 1);
+  dataTypeBuf[sizeof(dataTypeBuf) - 1] = '\0';
+  for (int i = 0; dataTypeBuf[i]; i++) {
+    dataTypeBuf[i] = toupper(dataTypeBuf[i]);
+  }
+
+  const char* endianness_variant = "";
+  char* underscorePos = strchr(dataTypeBuf, '_');
+  if (underscorePos != NULL) {
+    *underscorePos = '\0';
+    endianness_variant = underscorePos + 1;
+  }
+
+  type = parseBaseType(dataTypeBuf);
+  endianness = parseEndianness(endianness_variant);
+}
+
+uint8_t ModbusUtils::getWordCount(ModbusDataType type) {
+  switch (type) {
+    case ModbusDataType::INT32:
+    case ModbusDataType::UINT32:
+    case ModbusDataType::FLOAT32:
+      return 2;
+    case ModbusDataType::INT64:
+    case ModbusDataType::UINT64:
+    case ModbusDataType::DOUBLE64:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+// v1.3.3: Word/byte order kernels, one specialization per endianness so the
+// batch decoder dispatches once per value and each kernel compiles to plain
+// shifts (no runtime switch inside the combine)
+namespace {
+
+template <ModbusEndianness E>
+struct WordOrder;
+
+template <>
+struct WordOrder<ModbusEndianness::BE> {  // Big Endian (ABCD / W0..W3)
+  static uint32_t combine32(const uint16_t* values) {
+    return ((uint32_t)values[0] << 16) | values[1];
+  }
+  static uint64_t combine64(const uint16_t* values) {
+    return ((uint64_t)values[0] << 48) | ((uint64_t)values[1] << 32) |
+           ((uint64_t)values[2] << 16) | values[3];
+  }
+  static void split32(uint32_t bits, uint16_t* values) {
+    values[0] = bits >> 16;
+    values[1] = bits & 0xFFFF;
+  }
+  static void split64(uint64_t bits, uint16_t* values) {
+    for (int i = 0; i < 4; i++) {
+      values[i] = (bits >> (48 - 16 * i)) & 0xFFFF;
+    }
+  }
+};
+
+template <>
+struct WordOrder<ModbusEndianness::LE> {  // True Little Endian (DCBA)
+  static uint32_t combine32(const uint16_t* values) {
+    return (((uint32_t)values[1] & 0xFF) << 24) |
+           (((uint32_t)values[1] & 0xFF00) << 8) |
+           (((uint32_t)values[0] & 0xFF) << 8) | ((uint32_t)values[0] >> 8);
+  }
+  static uint64_t combine64(const uint16_t* values) {  // B8..B1
+    uint64_t b1 = values[0] >> 8;
+    uint64_t b2 = values[0] & 0xFF;
+    uint64_t b3 = values[1] >> 8;
+    uint64_t b4 = values[1] & 0xFF;
+    uint64_t b5 = values[2] >> 8;
+    uint64_t b6 = values[2] & 0xFF;
+    uint64_t b7 = values[3] >> 8;
+    uint64_t b8 = values[3] & 0xFF;
+    return (b8 << 56) | (b7 << 48) | (b6 << 40) | (b5 << 32) | (b4 << 24) |
+           (b3 << 16) | (b2 << 8) | b1;
+  }
+  static void split32(uint32_t bits, uint16_t* values) {
+    values[0] = ((bits & 0xFF) << 8) | ((bits >> 8) & 0xFF);
+    values[1] = (((bits >> 16) & 0xFF) << 8) | (bits >> 24);
+  }
+  static void split64(uint64_t bits, uint16_t* values) {
+    for (int i = 0; i < 4; i++) {
+      values[i] = (((bits >> (16 * i)) & 0xFF) << 8) |
+                  ((bits >> (16 * i + 8)) & 0xFF);
     }
+  }
+};
+
+template <>
+struct WordOrder<ModbusEndianness::BE_BS> {  // Big Endian + Byte Swap (BADC)
+  static uint32_t combine32(const uint16_t* values) {
+    return (((uint32_t)values[0] & 0xFF) << 24) |
+           (((uint32_t)values[0] & 0xFF00) << 8) |
+           (((uint32_t)values[1] & 0xFF) << 8) | ((uint32_t)values[1] >> 8);
+  }
+  static uint64_t combine64(const uint16_t* values) {  // BADCFEHG
+    // Registers have bytes swapped within each word
+    uint64_t b1 = (values[0] >> 8) & 0xFF;  // High byte of R1
+    uint64_t b2 = values[0] & 0xFF;         // Low byte of R1
+    uint64_t b3 = (values[1] >> 8) & 0xFF;  // High byte of R2
+    uint64_t b4 = values[1] & 0xFF;         // Low byte of R2
+    uint64_t b5 = (values[2] >> 8) & 0xFF;  // High byte of R3
+    uint64_t b6 = values[2] & 0xFF;         // Low byte of R3
+    uint64_t b7 = (values[3] >> 8) & 0xFF;  // High byte of R4
+    uint64_t b8 = values[3] & 0xFF;         // Low byte of R4
+    return (b2 << 56) | (b1 << 48) | (b4 << 40) | (b3 << 32) | (b6 << 24) |
+           (b5 << 16) | (b8 << 8) | b7;
+  }
+  static void split32(uint32_t bits, uint16_t* values) {
+    values[0] = (((bits >> 16) & 0xFF) << 8) | (bits >> 24);
+    values[1] = ((bits & 0xFF) << 8) | ((bits >> 8) & 0xFF);
+  }
+  static void split64(uint64_t bits, uint16_t* values) {
+    for (int i = 0; i < 4; i++) {
+      int shift = 48 - 16 * i;
+      values[i] = (((bits >> shift) & 0xFF) << 8) |
+                  ((bits >> (shift + 8)) & 0xFF);
+    }
+  }
+};
 
-    // Interpret combined value based on base type
-    if (strcmp(baseType, "INT32") == 0) {
-      return (int32_t)combined;
-    } else if (strcmp(baseType, "UINT32") == 0) {
-      return combined;
-    } else if (strcmp(baseType, "FLOAT32") == 0) {
+template <>
+struct WordOrder<ModbusEndianness::LE_BS> {  // Little Endian + Word Swap
+  static uint32_t combine32(const uint16_t* values) {  // CDAB
+    return ((uint32_t)values[1] << 16) | values[0];
+  }
+  static uint64_t combine64(const uint16_t* values) {  // W3..W0
+    return ((uint64_t)values[3] << 48) | ((uint64_t)values[2] << 32) |
+           ((uint64_t)values[1] << 16) | (uint64_t)values[0];
+  }
+  static void split32(uint32_t bits, uint16_t* values) {
+    values[0] = bits & 0xFFFF;
+    values[1] = bits >> 16;
+  }
+  static void split64(uint64_t bits, uint16_t* values) {
+    for (int i = 0; i < 4; i++) {
+      values[i] = (bits >> (16 * i)) & 0xFFFF;
+    }
+  }
+};
+
+template <ModbusEndianness E>
+double decodeWith(const uint16_t* values, ModbusDataType type) {
+  switch (type) {
+    case ModbusDataType::INT16:
+      return (int16_t)values[0];
+    case ModbusDataType::BOOL:
+      return values[0] != 0 ? 1.0 : 0.0;
+    case ModbusDataType::UINT16:
+    case ModbusDataType::BINARY:
+      return values[0];
+
+    // ========== 2-REGISTER (32-BIT) VALUES ==========
+    case ModbusDataType::INT32:
+      return (int32_t)WordOrder<E>::combine32(values);
+    case ModbusDataType::UINT32:
+      return WordOrder<E>::combine32(values);
+    case ModbusDataType::FLOAT32: {
       // FIXED Bug #5: Use union for safe type conversion (no strict aliasing
       // violation)
       union {
         uint32_t bits;
         float value;
       } converter;
-      converter.bits = combined;
+      converter.bits = WordOrder<E>::combine32(values);
+      return converter.value;
+    }
+
+    // ========== 4-REGISTER (64-BIT) VALUES ==========
+    case ModbusDataType::INT64:
+      return (double)(int64_t)WordOrder<E>::combine64(values);
+    case ModbusDataType::UINT64:
+      return (double)WordOrder<E>::combine64(values);
+    case ModbusDataType::DOUBLE64: {
+      // Safe type-punning using union for IEEE 754 reinterpretation
+      union {
+        uint64_t bits;
+        double value;
+      } converter;
+      converter.bits = WordOrder<E>::combine64(values);
       return converter.value;
     }
   }
+  return values[0];
+}
 
-  // ========== 4-REGISTER (64-BIT) VALUES ==========
-  else if (count == 4) {
-    uint64_t combined;
+// Round and clamp to [low, high] (casting an out-of-range double to an
+// integer type is undefined); NaN gives 0
+double saturate(double value, double low, double high) {
+  if (isnan(value)) return 0.0;
+  value = round(value);
+  return value < low ? low : (value > high ? high : value);
+}
 
-    if (strcmp(endianness_variant, "BE") == 0) {  // Big Endian (W0, W1, W2, W3)
-      combined = ((uint64_t)values[0] << 48) | ((uint64_t)values[1] << 32) |
-                 ((uint64_t)values[2] << 16) | values[3];
-    } else if (strcmp(endianness_variant, "LE") ==
-               0) {  // True Little Endian (B8..B1)
-      uint64_t b1 = values[0] >> 8;
-      uint64_t b2 = values[0] & 0xFF;
-      uint64_t b3 = values[1] >> 8;
-      uint64_t b4 = values[1] & 0xFF;
-      uint64_t b5 = values[2] >> 8;
-      uint64_t b6 = values[2] & 0xFF;
-      uint64_t b7 = values[3] >> 8;
-      uint64_t b8 = values[3] & 0xFF;
-      combined = (b8 << 56) | (b7 << 48) | (b6 << 40) | (b5 << 32) |
-                 (b4 << 24) | (b3 << 16) | (b2 << 8) | b1;
-    } else if (strcmp(endianness_variant, "BE_BS") ==
-               0) {  // Big Endian with Byte Swap (B2B1, B4B3, B6B5, B8B7)
-      // Registers have bytes swapped within each word. Extract bytes and
-      // reassemble as BADCFEHG pattern
-      uint64_t b1 = (values[0] >> 8) & 0xFF;  // High byte of R1
-      uint64_t b2 = values[0] & 0xFF;         // Low byte of R1
-      uint64_t b3 = (values[1] >> 8) & 0xFF;  // High byte of R2
-      uint64_t b4 = values[1] & 0xFF;         // Low byte of R2
-      uint64_t b5 = (values[2] >> 8) & 0xFF;  // High byte of R3
-      uint64_t b6 = values[2] & 0xFF;         // Low byte of R3
-      uint64_t b7 = (values[3] >> 8) & 0xFF;  // High byte of R4
-      uint64_t b8 = values[3] & 0xFF;         // Low byte of R4
-      combined = (b2 << 56) | (b1 << 48) | (b4 << 40) | (b3 << 32) |
-                 (b6 << 24) | (b5 << 16) | (b8 << 8) | b7;
-    } else if (strcmp(endianness_variant, "LE_BS") ==
-               0) {  // Little Endian with Word Swap (W3, W2, W1, W0)
-      combined = ((uint64_t)values[3] << 48) | ((uint64_t)values[2] << 32) |
-                 ((uint64_t)values[1] << 16) | (uint64_t)values[0];
-    } else {  // Default to Big Endian
-      combined = ((uint64_t)values[0] << 48) | ((uint64_t)values[1] << 32) |
-                 ((uint64_t)values[2] << 16) | values[3];
+template <ModbusEndianness E>
+uint8_t encodeWith(double value, ModbusDataType type, uint16_t* values) {
+  switch (type) {
+    case ModbusDataType::INT16:
+      values[0] = (uint16_t)(int16_t)saturate(value, -32768.0, 32767.0);
+      return 1;
+    case ModbusDataType::BOOL:
+      values[0] = (value != 0.0 && !isnan(value)) ? 1 : 0;
+      return 1;
+    case ModbusDataType::UINT16:
+    case ModbusDataType::BINARY:
+      values[0] = (uint16_t)saturate(value, 0.0, 65535.0);
+      return 1;
+
+    // ========== 2-REGISTER (32-BIT) VALUES ==========
+    case ModbusDataType::INT32:
+      WordOrder<E>::split32(
+          (uint32_t)(int32_t)saturate(value, -2147483648.0, 2147483647.0),
+          values);
+      return 2;
+    case ModbusDataType::UINT32:
+      WordOrder<E>::split32((uint32_t)saturate(value, 0.0, 4294967295.0),
+                            values);
+      return 2;
+    case ModbusDataType::FLOAT32: {
+      union {
+        float value;
+        uint32_t bits;
+      } converter;
+      converter.value = (float)value;
+      WordOrder<E>::split32(converter.bits, values);
+      return 2;
     }
 
-    // Interpret combined value based on base type
-    if (strcmp(baseType, "INT64") == 0) {
-      return (double)(int64_t)combined;
-    } else if (strcmp(baseType, "UINT64") == 0) {
-      return (double)combined;
-    } else if (strcmp(baseType, "DOUBLE64") == 0) {
-      // Safe type-punning using union for IEEE 754 reinterpretation
+    // ========== 4-REGISTER (64-BIT) VALUES ==========
+    // Limits are the largest doubles below 2^63 / 2^64
+    case ModbusDataType::INT64:
+      WordOrder<E>::split64(
+          (uint64_t)(int64_t)saturate(value, -9223372036854775808.0,
+                                      9223372036854774784.0),
+          values);
+      return 4;
+    case ModbusDataType::UINT64:
+      WordOrder<E>::split64(
+          (uint64_t)saturate(value, 0.0, 18446744073709549568.0), values);
+      return 4;
+    case ModbusDataType::DOUBLE64: {
       union {
-        uint64_t bits;
         double value;
+        uint64_t bits;
       } converter;
-      converter.bits = combined;
-      return converter.value;
+      converter.value = value;
+      WordOrder<E>::split64(converter.bits, values);
+      return 4;
     }
   }
+  values[0] = 0;
+  return 1;
+}
 
-  return values[0];  // Fallback
+}  // namespace
+
+double ModbusUtils::decodeValue(const uint16_t* values, ModbusDataType type,
+                                ModbusEndianness endianness) {
+  switch (endianness) {
+    case ModbusEndianness::LE:
+      return decodeWith<ModbusEndianness::LE>(values, type);
+    case ModbusEndianness::BE_BS:
+      return decodeWith<ModbusEndianness::BE_BS>(values, type);
+    case ModbusEndianness::LE_BS:
+      return decodeWith<ModbusEndianness::LE_BS>(values, type);
+    default:
+      return decodeWith<ModbusEndianness::BE>(values, type);
+  }
+}
+
+uint8_t ModbusUtils::encodeValue(double value, ModbusDataType type,
+                                 ModbusEndianness endianness, uint16_t* out) {
+  switch (endianness) {
+    case ModbusEndianness::LE:
+      return encodeWith<ModbusEndianness::LE>(value, type, out);
+    case ModbusEndianness::BE_BS:
+      return encodeWith<ModbusEndianness::BE_BS>(value, type, out);
+    case ModbusEndianness::LE_BS:
+      return encodeWith<ModbusEndianness::LE_BS>(value, type, out);
+    default:
+      return encodeWith<ModbusEndianness::BE>(value, type, out);
+  }
+}
+
+void ModbusUtils::decodeSpan(const uint16_t* words,
+                             const ModbusDecodeItem* items, size_t count,
+                             double* out) {
+  for (size_t i = 0; i < count; i++) {
+    const ModbusDecodeItem& item = items[i];
+    out[i] = calibrate(
+        item, decodeValue(words + item.wordOffset, item.type, item.endianness));
+  }
 }
 
 // ============================================================================
@@ -366,3 +603,81 @@ bool ModbusUtils::isWritableType(uint8_t readFunctionCode) {
   // FC2 (Discrete Inputs) and FC4 (Input Registers) are read-only
   return (readFunctionCode == 1 || readFunctionCode == 3);
 }
+
+// ============================================================================
+// v1.3.3: BLOCK-READ PLANNING
+// ============================================================================
+
+size_t ModbusUtils::planReadSpans(ModbusPollItemList& items,
+                                  ModbusReadSpanList& spans,
+                                  uint16_t maxGap, uint16_t maxRegisters,
+                                  uint16_t maxBits) {
+  spans.clear();
+  if (items.empty()) {
+    return 0;
+  }
+
+  // Sort by (function code, address); index keeps order deterministic for
+  // duplicate addresses
+  std::sort(items.begin(), items.end(),
+            [](const ModbusPollItem& a, const ModbusPollItem& b) {
+              if (a.functionCode != b.functionCode)
+                return a.functionCode < b.functionCode;
+              if (a.address != b.address) return a.address < b.address;
+              return a.index < b.index;
+            });
+
+  uint32_t spanEnd = 0;  // Exclusive end address of current span (32-bit to
+                         // avoid wrap at 65535)
+
+  for (size_t i = 0; i < items.size(); i++) {
+    const ModbusPollItem& item = items[i];
+    uint32_t itemEnd = (uint32_t)item.address + item.width;
+    uint16_t limit = (item.functionCode <= 2) ? maxBits : maxRegisters;
+
+    if (!spans.empty()) {
+      ModbusReadSpan& span = spans.back();
+      uint32_t mergedEnd = (itemEnd > spanEnd) ? itemEnd : spanEnd;
+
+      if (span.functionCode == item.functionCode &&
+          (uint32_t)item.address <= spanEnd + maxGap &&
+          (mergedEnd - span.startAddress) <= limit) {
+        // Extend current span (reads through holes of <= maxGap addresses)
+        spanEnd = mergedEnd;
+        span.quantity = (uint16_t)(spanEnd - span.startAddress);
+        span.itemCount++;
+        continue;
+      }
+    }
+
+    // Start new span
+    ModbusReadSpan span;
+    span.functionCode = item.functionCode;
+    span.startAddress = item.address;
+    span.quantity = item.width;
+    span.firstItem = (uint16_t)i;
+    span.itemCount = 1;
+    spans.push_back(span);
+    spanEnd = itemEnd;
+  }
+
+  return spans.size();
+}
+
+uint16_t ModbusUtils::getDeviceMaxGap(const JsonObject& deviceConfig) {
+  int maxGap = deviceConfig["max_gap"] | 0;
+  if (maxGap < 0) return 0;
+  if (maxGap > ModbusSpanConfig::MAX_READ_GAP) {
+    return ModbusSpanConfig::MAX_READ_GAP;
+  }
+  return (uint16_t)maxGap;
+}
+
+uint8_t ModbusUtils::getDevicePipelineDepth(const JsonObject& deviceConfig) {
+  int depth = deviceConfig["pipeline_depth"] | 1;
+  if (depth < 1) return 1;
+  if (depth > ModbusSpanConfig::MAX_PIPELINE_DEPTH) {
+    return ModbusSpanConfig::MAX_PIPELINE_DEPTH;
+  }
+  return (uint8_t)depth;
+}
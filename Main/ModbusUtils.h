@@ -4,6 +4,10 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
+#include <vector>
+
+#include "PSRAMAllocator.h"  // v1.3.3: STLPSRAMAllocator for plan containers
+
 /**
  * ModbusUtils - Shared Modbus Data Parsing Utilities
  *
@@ -36,9 +40,103 @@
  *     reg, values, count, "FLOAT32", "BE"
  *   );
  *
+ * v1.3.3: Block-read planning (register coalescing)
+ * - planReadSpans() groups registers of the same function code into
+ *   contiguous spans so each span is fetched with ONE Modbus request
+ * - Used by RTU (and TCP) polling to replace one-request-per-register reads
+ *
  * Version: 1.0.0
  * Created: November 25, 2025
  */
+
+// ============================================================================
+// v1.3.3: BLOCK-READ PLANNING TYPES
+// ============================================================================
+
+namespace ModbusSpanConfig {
+constexpr uint16_t MAX_SPAN_REGISTERS =
+    125;  // Modbus spec limit for FC3/FC4 (125 words per request)
+constexpr uint16_t MAX_SPAN_BITS =
+    2000;  // Modbus spec limit for FC1/FC2 (2000 bits per request)
+constexpr uint16_t MAX_READ_GAP =
+    32;  // Upper bound for per-device "max_gap" (unused addresses read through)
+constexpr uint8_t MAX_PIPELINE_DEPTH =
+    8;  // Upper bound for per-device "pipeline_depth" (Modbus TCP requests
+        // outstanding on one connection)
+constexpr uint16_t MAX_TURNAROUND_MS =
+    1000;  // Upper bound for per-device "turnaround_ms" (Modbus RTU)
+constexpr uint32_t MAX_INTER_FRAME_US =
+    100000;  // Upper bound for per-device "inter_frame_us" (Modbus RTU)
+}  // namespace ModbusSpanConfig
+
+/**
+ * v1.3.3: Parsed data type / byte order (replaces per-poll strcmp chains)
+ */
+enum class ModbusDataType : uint8_t {
+  UINT16 = 0,
+  INT16,
+  BOOL,
+  BINARY,
+  INT32,
+  UINT32,
+  FLOAT32,
+  INT64,
+  UINT64,
+  DOUBLE64
+};
+
+enum class ModbusEndianness : uint8_t {
+  BE = 0,  // Big Endian (ABCD)
+  LE,      // Little Endian (DCBA)
+  BE_BS,   // Big Endian + Byte Swap (BADC)
+  LE_BS    // Little Endian + Word Swap (CDAB)
+};
+
+/**
+ * One configured register as seen by the span planner
+ */
+struct ModbusPollItem {
+  uint16_t index;        // Position in device "registers" array
+  uint8_t functionCode;  // 1, 2, 3 or 4
+  uint16_t address;      // Start address
+  uint8_t width;         // Words (FC3/4) or bits (FC1/2) occupied (1, 2, 4)
+};
+
+/**
+ * One coalesced read request covering N poll items
+ */
+struct ModbusReadSpan {
+  uint8_t functionCode;   // Function code shared by all items in span
+  uint16_t startAddress;  // First address read
+  uint16_t quantity;      // Words (FC3/4) or bits (FC1/2) read
+  uint16_t firstItem;     // Index of first item in (sorted) items vector
+  uint16_t itemCount;     // Number of items covered by this span
+};
+
+// PSRAM-backed containers (plans live as long as the device config)
+using ModbusPollItemList =
+    std::vector<ModbusPollItem, STLPSRAMAllocator<ModbusPollItem>>;
+using ModbusReadSpanList =
+    std::vector<ModbusReadSpan, STLPSRAMAllocator<ModbusReadSpan>>;
+
+/**
+ * v1.3.3: Compiled decode + calibration of one value inside a word buffer
+ * (built once per config refresh, see ModbusUtils::decodeSpan)
+ * final = round((decode(words + wordOffset) * scale) + offset, decimals)
+ */
+struct ModbusDecodeItem {
+  uint16_t wordOffset;  // First word of the value in the buffer
+  ModbusDataType type;
+  ModbusEndianness endianness;
+  int8_t decimals;        // -1 = auto (no rounding), 0-6 = fixed places
+  float scale;
+  float offset;
+  double decimalsFactor;  // 10^decimals (precomputed, 1.0 if auto)
+};
+
+using ModbusDecodeList =
+    std::vector<ModbusDecodeItem, STLPSRAMAllocator<ModbusDecodeItem>>;
+
 class ModbusUtils {
  public:
   /**
@@ -67,6 +165,81 @@ class ModbusUtils {
                                           const char* baseType,
                                           const char* endianness_variant);
 
+  // =========================================================================
+  // v1.3.3: ENUM-BASED DECODING (used by compiled poll plans)
+  // =========================================================================
+
+  /**
+   * Parse a data type string ("FLOAT32_BE", "int16", ...) into enums
+   *
+   * @param dataType Data type string (case-insensitive, optional _SUFFIX)
+   * @param type Output: base type (UINT16 if unknown)
+   * @param endianness Output: byte order (BE if missing/unknown)
+   */
+  static void parseDataType(const char* dataType, ModbusDataType& type,
+                            ModbusEndianness& endianness);
+
+  /**
+   * Parse uppercase base type / endianness strings (no suffix handling)
+   */
+  static ModbusDataType parseBaseType(const char* baseType);
+  static ModbusEndianness parseEndianness(const char* endianness);
+
+  /**
+   * Number of 16-bit words for a data type (1, 2 or 4)
+   */
+  static uint8_t getWordCount(ModbusDataType type);
+
+  /**
+   * Decode raw words to a value without any string handling
+   *
+   * @param values Raw words (getWordCount(type) entries)
+   * @param type Parsed base type
+   * @param endianness Parsed byte order (ignored for 16-bit types)
+   * @return Decoded value (before scale/offset calibration)
+   */
+  static double decodeValue(const uint16_t* values, ModbusDataType type,
+                            ModbusEndianness endianness);
+
+  /**
+   * v1.3.3: Encode a value into raw words, the exact inverse of
+   * decodeValue() (Modbus TCP server). Integer types are rounded and
+   * saturated to their range; NaN encodes as 0 (FLOAT32/DOUBLE64: NaN).
+   *
+   * @param value Value to encode (before calibration, i.e. raw)
+   * @param type Parsed base type
+   * @param endianness Parsed byte order (ignored for 16-bit types)
+   * @param out Output words (getWordCount(type) entries)
+   * @return Number of words written (1, 2 or 4)
+   */
+  static uint8_t encodeValue(double value, ModbusDataType type,
+                             ModbusEndianness endianness, uint16_t* out);
+
+  /**
+   * Batch decode: decode and calibrate every item of a word buffer in one
+   * pass (word/byte order kernels are specialized per endianness at compile
+   * time, no strings or per-value parsing)
+   *
+   * @param words Raw word buffer (e.g. a span response or plan slot words)
+   * @param items Compiled descriptors (wordOffset + word count in bounds)
+   * @param count Number of descriptors
+   * @param out Calibrated values (count entries, same order as items)
+   */
+  static void decodeSpan(const uint16_t* words, const ModbusDecodeItem* items,
+                         size_t count, double* out);
+
+  /**
+   * Scale/offset/decimals calibration of one decoded value
+   */
+  static double calibrate(const ModbusDecodeItem& item, double raw) {
+    double calibrated = (raw * item.scale) + item.offset;
+    if (item.decimals >= 0) {
+      calibrated =
+          round(calibrated * item.decimalsFactor) / item.decimalsFactor;
+    }
+    return calibrated;
+  }
+
   // =========================================================================
   // v1.0.8: WRITE REGISTER SUPPORT
   // =========================================================================
@@ -132,6 +305,59 @@ class ModbusUtils {
    */
   static bool isWritableType(uint8_t readFunctionCode);
 
+  // =========================================================================
+  // v1.3.3: BLOCK-READ PLANNING
+  // =========================================================================
+
+  /**
+   * Coalesce poll items into block-read spans
+   *
+   * Items are sorted in place by (function code, address). Consecutive items
+   * with the same function code are merged while the hole between them is
+   * <= maxGap addresses and the span stays within the per-request limit.
+   * Overlapping items (same address configured twice) share one span.
+   *
+   * @param items Poll items (sorted in place, spans index into it)
+   * @param spans Output spans (cleared first)
+   * @param maxGap Max unused addresses to read through (0 = contiguous only)
+   * @param maxRegisters Max words per FC3/FC4 span (<= 125)
+   * @param maxBits Max bits per FC1/FC2 span (<= 2000)
+   * @return Number of spans produced
+   */
+  static size_t planReadSpans(
+      ModbusPollItemList& items, ModbusReadSpanList& spans,
+      uint16_t maxGap = 0,
+      uint16_t maxRegisters = ModbusSpanConfig::MAX_SPAN_REGISTERS,
+      uint16_t maxBits = ModbusSpanConfig::MAX_SPAN_BITS);
+
+  /**
+   * Extract one bit from a packed FC1/FC2 response
+   *
+   * @param words Response words (bit 0 = LSB of words[0], Modbus order)
+   * @param bitOffset Bit offset from span start address
+   * @return true if bit is set
+   */
+  static bool extractBit(const uint16_t* words, uint16_t bitOffset) {
+    return (words[bitOffset >> 4] >> (bitOffset & 0x0F)) & 0x01;
+  }
+
+  /**
+   * Read and clamp the per-device "max_gap" setting
+   *
+   * @param deviceConfig Device JSON object
+   * @return Gap in addresses (0 = contiguous only, max MAX_READ_GAP)
+   */
+  static uint16_t getDeviceMaxGap(const JsonObject& deviceConfig);
+
+  /**
+   * Read and clamp the per-device "pipeline_depth" setting (Modbus TCP)
+   *
+   * @param deviceConfig Device JSON object
+   * @return Requests in flight per connection (1 = one at a time, max
+   *         MAX_PIPELINE_DEPTH)
+   */
+  static uint8_t getDevicePipelineDepth(const JsonObject& deviceConfig);
+
  private:
   // Private constructor (utility class, no instances)
   ModbusUtils() {}
@@ -1,13 +1,20 @@
 #include "MqttManager.h"
 
-#include <set>  // For std::set to track cleared devices
+#include <esp_heap_caps.h>  // v1.3.3: Outbound payloads in PSRAM
+#include <esp_rom_crc.h>    // v1.3.3: Compact layout schema_id
+
+#include <algorithm>  // std::min (MqttChunkWriter), std::binary_search
+#include <set>        // For std::set to track cleared devices
 
 #include "DebugConfig.h"  // MUST BE FIRST for DEV_SERIAL_* macros
+#include "AcquisitionCycle.h"  // v1.3.3: Aligned snapshot cycles
 #include "LEDManager.h"
 #include "MemoryRecovery.h"
 #include "ModbusRtuService.h"  // v1.1.0: For MQTT Subscribe Control write operations
 #include "ModbusTcpService.h"  // v1.1.0: For MQTT Subscribe Control write operations
 #include "RTCManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+#include "TaskProfiler.h"  // v1.3.3: Diagnostics topic
 
 // v1.3.1: External reference to global BLE priority flag (defined in Main.ino)
 // When true, MQTT operations should pause to give BLE highest priority
@@ -70,15 +77,32 @@ MqttManager::MqttManager(ConfigManager* config, ServerConfig* serverCfg,
       running(false),
       taskHandle(nullptr),
       taskExitEvent(nullptr),  // v2.5.1 FIX: Initialize event group
+      publishTaskHandle(nullptr),
+      outboundQueue(nullptr),
+      outboundHead(nullptr),
+      brokerConnected(false),
+      persistentRetryPending(false),
+      publishArena(MqttConfig::PUBLISH_ARENA_SIZE),
+      publishQos(1),
+      diagnosticsIntervalMs(0),
+      lastDiagnosticsPublish(0),
+      inFlightWindow(MqttConfig::DEFAULT_INFLIGHT_WINDOW),
+      inFlightCount(0),
+      nextPacketId(1),
       brokerPort(1883),
       lastReconnectAttempt(0),
-      cachedBufferSize(0),
-      bufferSizeNeedsRecalculation(true),  // FIXED BUG #5: Initialize cache
+      payloadFormat(PayloadFormat::JSON),
+      windowAggregation(false),
+      compactLayout(false),
+      schemaLayoutVersion(0),
+      schemaId(0),
+      schemaPublished(false),
       lastDebugTime(0),  // v2.3.8 PHASE 1: Initialize connection state
       // v1.2.0: Initialize topic-centric subscribe control fields
       customSubscribeModeEnabled(false),
       topicMode("default"),
-      subscriptionsMutex(nullptr)
+      subscriptionsMutex(nullptr),
+      writeTargetsGeneration(0)
 {
   queueManager = QueueManager::getInstance();
   persistentQueue = MQTTPersistentQueue::getInstance();
@@ -87,9 +111,7 @@ MqttManager::MqttManager(ConfigManager* config, ServerConfig* serverCfg,
   publishState.targetTime = 0;
   publishState.timeLocked = false;
   publishState.lastLoggedInterval = 0;
-  publishState.batchWaitStart = 0;
-  publishState.batchTimeout = 0;
-  publishState.flushedOnce = false;
+  publishState.cycleId = 0;
 
   // v1.3.0: Initialize MQTT statistics for Desktop App MQTT Monitor
   stats.publishSuccessCount = 0;
@@ -101,16 +123,26 @@ MqttManager::MqttManager(ConfigManager* config, ServerConfig* serverCfg,
   stats.lastSubscribeTimestamp = 0;
   stats.connectionStartTime = 0;
   stats.reconnectCount = 0;
+  stats.outboundHighWater = 0;
+  stats.outboundFullCount = 0;
+  stats.outboundDropCount = 0;
+  stats.pubackCount = 0;
+  stats.pubackTimeoutCount = 0;
+  stats.inFlightHighWater = 0;
 
   // v2.3.8 PHASE 1: Create mutexes for thread safety
-  bufferCacheMutex = xSemaphoreCreateMutex();
   publishStateMutex = xSemaphoreCreateMutex();
 
   // v1.2.0: Create mutex for topic-centric subscriptions thread safety
   subscriptionsMutex = xSemaphoreCreateMutex();
 
-  if (bufferCacheMutex == NULL || publishStateMutex == NULL ||
-      subscriptionsMutex == NULL) {
+  // v1.3.3: Outbound publish queue (publish task -> network task)
+  outboundQueue = xQueueCreate(MqttConfig::OUTBOUND_QUEUE_DEPTH,
+                               sizeof(OutboundMessage*));
+  TaskProfiler::getInstance()->watchQueue("mqtt_outbound", outboundQueue);
+
+  if (publishStateMutex == NULL || subscriptionsMutex == NULL ||
+      outboundQueue == NULL) {
     LOG_MQTT_INFO("[MQTT] CRITICAL: Failed to create mutexes!");
   } else {
     LOG_MQTT_INFO("[MQTT] Thread safety mutexes created successfully");
@@ -148,6 +180,52 @@ bool MqttManager::init() {
 
   loadMqttConfig();
 
+  // v1.3.3: Resend path of the persistent queue (was never registered, so
+  // queued messages were retried until they failed). Payload is written from
+  // the queue's PSRAM buffer, without retain: a resent backlog message must
+  // not replace the retained live value. At QoS 1 the message stays in the
+  // queue (PUBLISH_PENDING_ACK) until processAcks() sees its PUBACK.
+  if (persistentQueue) {
+    persistentQueue->setPublishCallback(
+        [this](uint16_t messageId, const char* topic, const char* payload,
+               size_t length) -> PublishOutcome {
+          if (!mqttClient.connected()) {
+            return PUBLISH_FAILED;
+          }
+          uint16_t packetId = 0;
+          if (publishQos > 0) {
+            if (inFlightFull()) {
+              return PUBLISH_DEFERRED;
+            }
+            packetId = allocatePacketId();
+          }
+
+          bool published;
+          if (payloadFormat != PayloadFormat::JSON) {
+            // v1.3.3: Messages are queued as JSON text; re-encode them so a
+            // resent message has the same format as live ones
+            SpiRamJsonDocument doc;
+            if (deserializeJson(doc, payload, length)) {
+              return PUBLISH_FAILED;
+            }
+            published =
+                streamPayload(topic, doc, measurePayload(doc, payloadFormat),
+                              false, packetId);
+          } else {
+            published = publishRaw(topic, (const uint8_t*)payload, length,
+                                   false, packetId);
+          }
+          if (!published) {
+            return PUBLISH_FAILED;
+          }
+          if (packetId == 0) {
+            return PUBLISH_SENT;
+          }
+          trackInFlight(packetId, nullptr, messageId);
+          return PUBLISH_PENDING_ACK;
+        });
+  }
+
   // OPTIMIZED: Clean up expired messages from persistent queue on startup
   if (persistentQueue) {
     uint32_t expiredCount = persistentQueue->getPendingMessageCount();
@@ -172,22 +250,40 @@ void MqttManager::start() {
   }
 
   running = true;
-  BaseType_t result = xTaskCreatePinnedToCore(
+  // FIXED: Priority 2 (equal to Modbus RTU task) to ensure fair CPU time for
+  // MQTT PINGREQ Previous: Priority 1 was too low - MQTT task was starved
+  // during long RTU polling New: Priority 2 ensures MQTT keep-alive packets
+  // are sent even during heavy RTU load
+  // FIXED: Run on Core 1 to avoid blocking IDLE0 on Core 0
+  // v1.3.3: Both now set in TaskAffinity.h (MQTT_NETWORK)
+  BaseType_t result = TaskAffinity::create(
       mqttTask, "MQTT_TASK", MqttConfig::MQTT_TASK_STACK_SIZE, this,
-      2,  // FIXED: Priority 2 (equal to Modbus RTU task) to ensure fair CPU
-          // time for MQTT PINGREQ Previous: Priority 1 was too low - MQTT task
-          // was starved during long RTU polling New: Priority 2 ensures MQTT
-          // keep-alive packets are sent even during heavy RTU load
-      &taskHandle,
-      1);  // FIXED: Run on Core 1 to avoid blocking IDLE0 on Core 0
-
-  if (result == pdPASS) {
-    LOG_MQTT_INFO("[MQTT] Manager started successfully");
-  } else {
+      TaskAffinity::Task::MQTT_NETWORK, &taskHandle);
+
+  if (result != pdPASS) {
     LOG_MQTT_INFO("[MQTT] ERROR: Failed to create MQTT task");
     running = false;
     taskHandle = nullptr;
+    return;
+  }
+
+  // v1.3.3: Publish task builds payloads, the MQTT task sends them.
+  // Priority 1 (one below): keep-alives and write commands preempt payload
+  // building. The balanced TaskAffinity profile builds on the other core
+  result = outboundQueue ? TaskAffinity::create(
+                               publishTask, "MQTT_PUB_TASK",
+                               MqttConfig::PUBLISH_TASK_STACK_SIZE, this,
+                               TaskAffinity::Task::MQTT_PUBLISH,
+                               &publishTaskHandle)
+                         : pdFAIL;
+  if (result != pdPASS) {
+    LOG_MQTT_INFO("[MQTT] ERROR: Failed to create MQTT publish task");
+    publishTaskHandle = nullptr;
+    stop();
+    return;
   }
+
+  LOG_MQTT_INFO("[MQTT] Manager started successfully");
 }
 
 void MqttManager::stop() {
@@ -199,19 +295,23 @@ void MqttManager::stop() {
   // group
   if (taskHandle) {
     if (taskExitEvent) {
-      // Clear the bit first in case it was set from previous run
-      xEventGroupClearBits(taskExitEvent, TASK_EXITED_BIT);
+      // v1.3.3: Both tasks (network + publish) signal their exit
+      EventBits_t exitBits =
+          TASK_EXITED_BIT | (publishTaskHandle ? PUBLISH_TASK_EXITED_BIT : 0);
+
+      // Clear the bits first in case they were set from previous run
+      xEventGroupClearBits(taskExitEvent, exitBits);
 
       // Wait for task to signal it has exited (max 2 seconds)
       EventBits_t bits = xEventGroupWaitBits(
           taskExitEvent,
-          TASK_EXITED_BIT,     // Wait for this bit
-          pdTRUE,              // Clear bit after return
-          pdTRUE,              // Wait for all bits (only 1 in this case)
+          exitBits,            // Wait for these bits
+          pdTRUE,              // Clear bits after return
+          pdTRUE,              // Wait for all bits
           pdMS_TO_TICKS(2000)  // 2 second timeout
       );
 
-      if (!(bits & TASK_EXITED_BIT)) {
+      if ((bits & exitBits) != exitBits) {
         LOG_MQTT_INFO(
             "[MQTT] WARNING: Task did not exit gracefully within 2s, forcing "
             "deletion");
@@ -224,7 +324,13 @@ void MqttManager::stop() {
     // Now safe to delete the task (it has confirmed exit or timed out)
     vTaskDelete(taskHandle);
     taskHandle = nullptr;
+    if (publishTaskHandle) {
+      vTaskDelete(publishTaskHandle);
+      publishTaskHandle = nullptr;
+    }
   }
+  releaseOutbound();  // v1.3.3: Payloads not sent before stop
+  brokerConnected.store(false);
 
   if (mqttClient.connected()) {
     mqttClient.disconnect();
@@ -244,11 +350,44 @@ void MqttManager::mqttTask(void* parameter) {
   manager->mqttLoop();
 }
 
+void MqttManager::publishTask(void* parameter) {
+  MqttManager* manager = static_cast<MqttManager*>(parameter);
+  manager->publishLoop();
+  vTaskSuspend(NULL);  // stop() deletes the task
+}
+
+/**
+ * v1.3.3: Publish task - interval checks, payload building and encoding.
+ * Never touches the PubSubClient; payloads go to outboundQueue.
+ */
+void MqttManager::publishLoop() {
+  while (running) {
+    // v1.3.1: BLE PRIORITY CHECK - no payload building while BLE is active
+    if (g_bleCommandActive.load()) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+      continue;
+    }
+
+    if (brokerConnected.load()) {
+      publishQueueData();
+      publishDiagnostics();
+    }
+    vTaskDelay(pdMS_TO_TICKS(MqttConfig::PUBLISH_TASK_PERIOD_MS));
+  }
+
+  if (taskExitEvent) {
+    xEventGroupSetBits(taskExitEvent, PUBLISH_TASK_EXITED_BIT);
+  }
+}
+
 void MqttManager::mqttLoop() {
   bool wasConnected = false;
   bool wifiWasConnected = false;
+  // v1.3.3: Active interface the connection was made on (NetworkMgr)
+  uint32_t networkGeneration = networkManager->getModeGeneration();
+  bool reconnectNow = false;
 
-  LOG_MQTT_INFO("[MQTT] Task started on Core 1");
+  LOG_MQTT_INFO("[MQTT] Task started on Core %d\n", xPortGetCoreID());
 
   while (running) {
     // ============================================
@@ -266,10 +405,24 @@ void MqttManager::mqttLoop() {
     // ============================================
     MemoryRecovery::checkAndRecover();
 
+    // v1.3.3: Failover switched the interface - the connection still uses
+    // the old one, so re-establish on the new one without the reconnect delay
+    uint32_t generation = networkManager->getModeGeneration();
+    if (generation != networkGeneration) {
+      networkGeneration = generation;
+      if (mqttClient.connected()) {
+        LOG_MQTT_INFO("[MQTT] Network switched to %s, reconnecting\n",
+                      networkManager->getCurrentMode().c_str());
+        mqttClient.disconnect();
+      }
+      reconnectNow = true;
+    }
+
     // Check network availability
     bool networkAvailable = isNetworkAvailable();
 
     if (!networkAvailable) {
+      brokerConnected.store(false);
       if (wifiWasConnected) {
         LOG_MQTT_INFO("[MQTT] Network disconnected");
         wifiWasConnected = false;
@@ -280,7 +433,8 @@ void MqttManager::mqttLoop() {
                     networkManager->getLocalIP().toString().c_str());
 
       // vTaskDelay automatically feeds watchdog
-      vTaskDelay(pdMS_TO_TICKS(5000));
+      // v1.3.3: Ends early when failover brings up another interface
+      networkManager->waitForModeChange(networkGeneration, 5000);
       continue;
     } else if (!wifiWasConnected) {
       LOG_MQTT_INFO("[MQTT] Network available | Mode: %s | IP: %s\n",
@@ -291,6 +445,7 @@ void MqttManager::mqttLoop() {
 
     // Connect to MQTT if not connected
     if (!mqttClient.connected()) {
+      brokerConnected.store(false);
       if (wasConnected) {
         LOG_MQTT_INFO("[MQTT] Connection lost, attempting reconnect...");
         wasConnected = false;
@@ -302,7 +457,8 @@ void MqttManager::mqttLoop() {
       }
 
       unsigned long now = millis();
-      if (now - lastReconnectAttempt > 5000) {
+      if (reconnectNow || now - lastReconnectAttempt > 5000) {
+        reconnectNow = false;
         lastReconnectAttempt = now;
         // v2.3.8 PHASE 1: Use instance member instead of static variable
         if (now - lastDebugTime > 30000) {
@@ -336,9 +492,35 @@ void MqttManager::mqttLoop() {
       // v1.0.6 OPTIMIZED: Consolidated delays for better responsiveness
       // Previous: loop() + 10ms + publish() + 10ms + 50ms = 70ms per iteration
       // New: loop() + publish() + 30ms = 30ms per iteration (2.3x faster)
+      // v1.3.3: Payloads come from the publish task (outbound queue)
+      brokerConnected.store(true);
       mqttClient.loop();
-      publishQueueData();
-      vTaskDelay(pdMS_TO_TICKS(30));  // Single consolidated delay
+      processAcks();
+      checkInFlight(false);
+      drainOutbound();
+
+      // v1.3.3: Large backlog (reconnect after an outage): paced catch-up
+      // on every cycle, live payloads keep their share of the broker rate
+      if (persistentQueueEnabled && persistentQueue &&
+          mqttClient.connected() && persistentQueue->isCatchingUp()) {
+        persistentQueue->processCatchUp();
+      } else if (persistentRetryPending.exchange(false) &&
+                 persistentQueueEnabled && persistentQueue &&
+                 mqttClient.connected()) {
+        // Persistent queue resends, requested by the publish task when a
+        // cycle has new data (its publish callback needs this task)
+        uint32_t persistedSent = persistentQueue->processQueue();
+#if PRODUCTION_MODE == 0
+        if (persistedSent > 0) {
+          LOG_MQTT_INFO("[MQTT] Resent %ld persistent messages\n",
+                        persistedSent);
+        }
+#endif
+      }
+
+      // Single consolidated delay; a queued payload ends it early
+      OutboundMessage* next;
+      xQueuePeek(outboundQueue, &next, pdMS_TO_TICKS(30));
     }
 
     // v1.0.6: Base delay moved inside conditions for better control
@@ -366,39 +548,16 @@ bool MqttManager::connectToMqtt() {
     return false;
   }
 
-  mqttClient.setClient(*activeClient);
-
-  // FIXED BUG #15: Dynamic buffer sizing based on actual device configuration
-  // FIXED BUG #5 & #7: Use cached buffer size to avoid repeated calculations
-  // Previous: Hardcoded 8192 bytes, recalculated every connection
-  // New: Calculate once, cache result, recalculate only on config change
-  // v2.3.8 PHASE 1: Added mutex protection for thread safety
-  xSemaphoreTake(bufferCacheMutex, portMAX_DELAY);
-  if (bufferSizeNeedsRecalculation || cachedBufferSize == 0) {
-    cachedBufferSize = calculateOptimalBufferSize();
-    bufferSizeNeedsRecalculation = false;
-#if PRODUCTION_MODE == 0
-    LOG_MQTT_INFO(
-        "[MQTT] Buffer size calculated: %u bytes (cached for reuse)\n",
-        cachedBufferSize);
-#endif
-  }
-#if PRODUCTION_MODE == 0
-  else {
-    LOG_MQTT_INFO("[MQTT] Buffer size using cached value: %u bytes\n",
-                  cachedBufferSize);
-  }
-#endif
-  uint16_t bufferSize = cachedBufferSize;  // Copy under mutex protection
-  xSemaphoreGive(bufferCacheMutex);
-
-  mqttClient.setBufferSize(bufferSize,
-                           bufferSize);  // Use local copy (thread-safe)
+  // v1.3.3: PubSubClient reads through ackTap (PUBACKs of QoS 1 publishes)
+  ackTap.setClient(activeClient);
+  mqttClient.setClient(ackTap);
 
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO("[MQTT] Max packet size: %u bytes (MQTT_MAX_PACKET_SIZE)\n",
-                MQTT_MAX_PACKET_SIZE);
-#endif
+  // v1.3.3: Fixed client buffer. Data payloads are streamed
+  // (publishDocument), so the buffer only holds incoming subscribe messages,
+  // packet headers and small responses. Replaces the per-config buffer sizing
+  // (calculateOptimalBufferSize, FIXED BUG #15 / #5 / #7).
+  mqttClient.setBufferSize(MqttConfig::CLIENT_BUFFER_SIZE,
+                           MqttConfig::CLIENT_BUFFER_SIZE);
 
   // FIXED: Increased keep_alive to 120s to prevent timeouts during long Modbus
   // polling cycles Previous: 60s was too short when RTU polling takes ~50s +
@@ -452,6 +611,12 @@ bool MqttManager::connectToMqtt() {
 
     // v1.1.0: Initialize MQTT subscriptions for write control
     initializeSubscriptions();
+
+    // v1.3.3: Re-send the compact layout schema (broker may have lost it)
+    schemaPublished = false;
+
+    // v1.3.3: Clean session - publishes of the lost one are sent again
+    checkInFlight(true);
   } else {
     LOG_MQTT_INFO("[MQTT] ERROR: Connection failed | Error code: %d\n",
                   mqttClient.state());
@@ -490,11 +655,14 @@ void MqttManager::loadMqttConfig() {
     uint64_t mac = ESP.getEfuseMac();
     clientId = String("MGate1210_") + String((uint32_t)(mac & 0xFFFFFF), HEX);
     publishMode = "default";
+    payloadFormat = PayloadFormat::JSON;
+    windowAggregation = false;
     defaultModeEnabled = true;
     defaultTopicPublish = "device/data";
     defaultTopicSubscribe = "device/control";
     defaultInterval = 5000;
     defaultIntervalUnit = "ms";
+    compactLayout = false;
     customizeModeEnabled = false;
   }
 
@@ -530,170 +698,202 @@ void MqttManager::buildTimestamp(JsonDocument& doc, unsigned long now) {
 }
 
 /**
- * Helper 2: Validate devices and group registers by device_id
- * @param uniqueRegisters Input map of register data
- * @param devicesObject Output JSON object for devices
- * @param deviceObjects Output map tracking device objects
- * @param filterRegisters Optional filter (nullptr = include all, else filter by
- * register_id)
- * @return Number of valid registers added
+ * v1.3.3: CRC32 of serialized JSON (compact layout schema_id)
  */
-int MqttManager::validateAndGroupRegisters(
-    std::map<String, JsonDocument>& uniqueRegisters, JsonObject& devicesObject,
-    std::map<String, JsonObject>& deviceObjects,
-    const std::vector<String>* filterRegisters) {
-  // Track deleted devices to avoid spam logging
-  std::map<String, int> deletedDevices;  // device_id -> skipped register count
-  int validRegisterCount = 0;
-
-  for (auto& entry : uniqueRegisters) {
-    JsonObject dataPoint = entry.second.as<JsonObject>();
-
-    // Validate: Skip if data doesn't have required fields
-    if (dataPoint["name"].isNull() || dataPoint["value"].isNull()) {
-      continue;  // Silent skip - data validation
-    }
-
-    String deviceId = dataPoint["device_id"].as<String>();
-    String registerName = dataPoint["name"].as<String>();
-    String registerId = dataPoint["register_id"].as<String>();
-
-    if (deviceId.isEmpty() || registerName.isEmpty()) {
-      continue;  // Silent skip - empty device_id or register name
-    }
-
-    // Optional: Filter by register_id list (for customize mode)
-    if (filterRegisters != nullptr) {
-      if (std::find(filterRegisters->begin(), filterRegisters->end(),
-                    registerId) == filterRegisters->end()) {
-        continue;  // Register not in filter list
-      }
-    }
-
-    // Validate device still exists (not deleted) before publishing
-    if (deviceObjects.find(deviceId) == deviceObjects.end()) {
-      // Check if we already know this device is deleted
-      if (deletedDevices.find(deviceId) != deletedDevices.end()) {
-        deletedDevices[deviceId]++;  // Increment skip count
-        continue;
-      }
-
-      // First time seeing this device in this batch - verify it exists in
-      // config
-      JsonDocument tempDoc;
-      JsonObject tempObj = tempDoc.to<JsonObject>();
-      if (!configManager->readDevice(deviceId, tempObj)) {
-        // Device deleted - track it and skip
-        deletedDevices[deviceId] = 1;  // Start count at 1
-        continue;
-      }
-    }
-
-    // Create device object with device_id as key if not exists
-    if (deviceObjects.find(deviceId) == deviceObjects.end()) {
-      JsonObject deviceObj = devicesObject[deviceId].to<JsonObject>();
-
-      // Add device_name at device level
-      if (!dataPoint["device_name"].isNull()) {
-        deviceObj["device_name"] = dataPoint["device_name"];
-      }
-
-      // Store reference to this device object for grouping
-      deviceObjects[deviceId] = deviceObj;
-    }
+class Crc32Print : public Print {
+ public:
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t length) override {
+    crc = esp_rom_crc32_le(crc, data, length);
+    return length;
+  }
+  uint32_t crc = 0;
+};
 
-    // Add register as nested object: devices.{device_id}.{register_name} =
-    // {value, unit}
-    JsonObject registerObj =
-        deviceObjects[deviceId][registerName].to<JsonObject>();
-    registerObj["value"] = dataPoint["value"];
-    registerObj["unit"] = dataPoint["unit"];
+/**
+ * v1.3.3: Publish the compact layout schema (retained) on schemaTopic
+ *
+ * The schema lists every polled device with its registers in value-array
+ * order. schema_id is the CRC32 of that list, so the same layout keeps its
+ * id across reboots and an unchanged layout is not published again after a
+ * device refresh.
+ *
+ * @return true if the schema on the broker (or queued for it) matches the
+ *         current layout
+ */
+bool MqttManager::publishSchema() {
+  schemaLayout.resize(PollPlanRegistry::MAX_SLOTS);
+
+  SpiRamJsonDocument schemaDoc(&publishArena);  // v1.3.3: Cycle arena
+  schemaDoc["layout"] = "compact";
+  JsonArray devices = schemaDoc["devices"].to<JsonArray>();
+  uint32_t version = PollPlanRegistry::getInstance()->describeLayout(
+      devices, schemaLayout.data());
+
+  schemaRegisterCounts.clear();
+  for (JsonObject device : devices) {
+    schemaRegisterCounts.push_back(device["registers"].size());
+  }
+
+  Crc32Print crc;
+  serializeJson(devices, crc);
+  if (windowAggregation) {
+    // v1.3.3: Values are [last, min, max, avg, count] - different schema id
+    schemaDoc["aggregation"] = "window";
+    crc.write((const uint8_t*)"window", 6);
+  }
+  bool changed = (crc.crc != schemaId);
+  schemaId = crc.crc;
+  schemaLayoutVersion = version;
+
+  if (schemaPublished && !changed) {
+    return true;  // Refresh without layout change
+  }
+
+  char idText[9];
+  snprintf(idText, sizeof(idText), "%08lx", (unsigned long)schemaId);
+  schemaDoc["schema_id"] = idText;
+
+  // v1.3.3: Queued ahead of the values that use it; the network task clears
+  // schemaPublished if the schema is lost
+  size_t payloadSize = 0;
+  schemaPublished = publishDocument(schemaTopic, schemaDoc, "Compact Schema",
+                                    payloadSize, true);
+  if (schemaPublished) {
+    LOG_MQTT_INFO("[MQTT] Compact schema %s queued for %s (%u devices, %u "
+                  "bytes)\n",
+                  idText, schemaTopic.c_str(), (unsigned)devices.size(),
+                  (unsigned)payloadSize);
+  }
+  return schemaPublished;
+}
 
-    validRegisterCount++;
+/**
+ * v1.3.3: Publish the task profiler sample on diagnostics_topic every
+ * diagnostics_interval seconds (publish task)
+ */
+void MqttManager::publishDiagnostics() {
+  if (diagnosticsTopic.isEmpty() || diagnosticsIntervalMs == 0) {
+    return;
   }
-
-  // Log summary for deleted devices (compact - one line)
-  if (!deletedDevices.empty()) {
-    int totalSkipped = 0;
-    for (auto& entry : deletedDevices) {
-      totalSkipped += entry.second;
-    }
-    LOG_MQTT_INFO("[MQTT] Skipped %d registers from %d deleted device(s)\n",
-                  totalSkipped, deletedDevices.size());
+  unsigned long now = millis();
+  if (lastDiagnosticsPublish != 0 &&
+      now - lastDiagnosticsPublish < diagnosticsIntervalMs) {
+    return;
   }
+  lastDiagnosticsPublish = now;
+
+  SpiRamJsonDocument doc(&publishArena);  // v1.3.3: Cycle arena
+  doc["uptime_ms"] = now;
+  doc["free_heap"] = ESP.getFreeHeap();
+  doc["free_psram"] = ESP.getFreePsram();
+  doc["memory_pressure"] =
+      MemoryRecovery::getPressureName(MemoryRecovery::getPressure());
+  JsonObject profile = doc["task_profile"].to<JsonObject>();
+  TaskProfiler::getInstance()->getStatus(profile);
+
+  size_t payloadSize = 0;
+  publishDocument(diagnosticsTopic, doc, "Diagnostics", payloadSize, false);
+  doc.clear();
+  publishArena.reset();
+}
 
-  return validRegisterCount;
+/**
+ * v1.3.3: Fill doc with values[] in schema order (MqttPayloadBuilder)
+ * @param registerCount Output: values written
+ * @param deviceCount Output: devices with at least one value
+ */
+void MqttManager::buildCompactPayload(JsonDocument& doc, int& registerCount,
+                                      int& deviceCount) {
+  if (!MqttPayloadBuilder::buildCompactValues(
+          doc, schemaId, schemaLayout.data(), schemaRegisterCounts,
+          registerCount, deviceCount, windowAggregation,
+          payloadFormat == PayloadFormat::JSON)) {
+    schemaLayoutVersion = 0;  // Rebuild (and maybe re-publish) next cycle
+  }
 }
 
 /**
- * Helper 3: Serialize and validate JSON payload
- * @param doc JsonDocument to serialize
- * @param payload Output string for serialized JSON
- * @param estimatedSize Estimated size for logging (optional)
- * @return true if serialization successful and valid, false otherwise
+ * v1.3.3: Print adapter that streams serializeJson() output into an open
+ * PubSubClient publish (between beginPublish() and endPublish()).
+ *
+ * ArduinoJson writes mostly single characters; they are collected in a small
+ * stack buffer and handed to the socket in STREAM_CHUNK_SIZE blocks instead
+ * of one client write per character.
  */
-bool MqttManager::serializeAndValidatePayload(JsonDocument& doc,
-                                              String& payload,
-                                              uint32_t estimatedSize) {
-  // Serialize batch payload
-  size_t serializedSize = serializeJson(doc, payload);
-
-  // Validate serialization success
-  if (serializedSize == 0) {
-    LOG_MQTT_INFO("[MQTT] ERROR: serializeJson() returned 0 bytes!");
-    return false;
+class MqttChunkWriter : public Print {
+ public:
+  explicit MqttChunkWriter(PubSubClient& client) : client(client) {}
+
+  size_t write(uint8_t c) override {
+    if (used == sizeof(chunk) && !flush()) {
+      return 0;
+    }
+    chunk[used++] = c;
+    return 1;
   }
 
-  // Validate payload is valid JSON (check first and last characters)
-  if (payload.length() > 0) {
-    if (payload.charAt(0) != '{' ||
-        payload.charAt(payload.length() - 1) != '}') {
-      LOG_MQTT_INFO(
-          "[MQTT] ERROR: Payload is not valid JSON! First char: '%c', Last "
-          "char: '%c'\n",
-          payload.charAt(0), payload.charAt(payload.length() - 1));
-      if (payload.length() <= 2000) {
-        LOG_MQTT_INFO("[MQTT] Invalid payload (%u bytes): %s\n",
-                      payload.length(), payload.c_str());
-      } else {
-        LOG_MQTT_INFO("[MQTT] Invalid payload too large (%u bytes)\n",
-                      payload.length());
-        // v2.5.35: Use DEV_MODE check to prevent log leak in production
-        DEV_SERIAL_PRINTF("  First 200 chars: %s\n",
-                          payload.substring(0, 200).c_str());
-        DEV_SERIAL_PRINTF(
-            "  Last 200 chars: %s\n",
-            payload.substring(max(0, (int)payload.length() - 200)).c_str());
+  size_t write(const uint8_t* data, size_t length) override {
+    size_t written = 0;
+    while (written < length) {
+      if (used == sizeof(chunk) && !flush()) {
+        break;
       }
+      size_t n = std::min(length - written, sizeof(chunk) - used);
+      memcpy(chunk + used, data + written, n);
+      used += n;
+      written += n;
+    }
+    return written;
+  }
+
+  // Send buffered bytes; false once any socket write came up short
+  bool flush() {
+    if (failed) {
       return false;
     }
+    if (used > 0) {
+      size_t sent = client.write(chunk, used);
+      totalSent += sent;
+      failed = (sent != used);
+      used = 0;
+    }
+    return !failed;
   }
 
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO(
-      "[MQTT] Serialization complete: %u bytes (expected ~%u bytes)\n",
-      serializedSize, estimatedSize);
-#endif
+  size_t bytesSent() const { return totalSent; }
 
-  return true;
-}
+ private:
+  PubSubClient& client;
+  uint8_t chunk[MqttConfig::STREAM_CHUNK_SIZE];
+  size_t used = 0;
+  size_t totalSent = 0;
+  bool failed = false;
+};
 
 /**
- * Helper 4: Publish payload to MQTT broker with buffer validation
+ * Helper 3: Stream a JSON document to the MQTT broker
+ *
+ * v1.3.3: Replaces serializeAndValidatePayload() + publishPayload().
+ * Previous: doc -> String (payload) -> heap copy -> PubSubClient buffer, ~3x
+ * the payload size in RAM and a hard 16KB cap (buffer sizing heuristics).
+ * New: The exact size is measured first (measureJson), then the document is
+ * encoded once into a PSRAM buffer of that size and queued for the network
+ * task (outbound queue), which sends it with beginPublish/write/endPublish.
+ *
  * @param topic MQTT topic to publish to
- * @param payload JSON payload string
+ * @param doc JSON document to publish
  * @param modeLabel Label for logging ("Default Mode" or "Customize Mode")
- * @return true if publish successful, false otherwise
+ * @param payloadSize Output: serialized payload size in bytes
+ * @param schema True for the compact layout schema
+ * @return true if queued for publish, false otherwise
  */
-bool MqttManager::publishPayload(const String& topic, const String& payload,
-                                 const char* modeLabel) {
-  // Check buffer size
-  if (payload.length() > cachedBufferSize) {
-    LOG_MQTT_INFO(
-        "[MQTT] ERROR: Payload too large (%d bytes > %u bytes buffer)!\n",
-        payload.length(), cachedBufferSize);
-    LOG_MQTT_INFO("[MQTT] %s: Splitting needed. Payload size: %d\n", modeLabel,
-                  payload.length());
+bool MqttManager::publishDocument(const String& topic, JsonDocument& doc,
+                                  const char* modeLabel, size_t& payloadSize,
+                                  bool schema, const CyclePayload* encoded) {
+  payloadSize = encoded ? encoded->length : measurePayload(doc, payloadFormat);
+  if (payloadSize == 0) {
+    LOG_MQTT_INFO("[MQTT] ERROR: measurePayload() returned 0 bytes!");
     return false;
   }
 
@@ -702,51 +902,26 @@ bool MqttManager::publishPayload(const String& topic, const String& payload,
   if (IS_DEV_MODE()) {
     Serial.printf("\n[MQTT] PUBLISH REQUEST - %s\n", modeLabel);
     Serial.printf("  Topic: %s\n", topic.c_str());
-    Serial.printf("  Size: %u bytes\n", payload.length());
+    Serial.printf("  Size: %u bytes (%s)\n", payloadSize,
+                  payloadFormatName(payloadFormat));
 
-    // Print payload (verbose mode) - show full JSON as one-line
-    if (payload.length() > 0) {
-      Serial.printf("  Payload: %s\n", payload.c_str());
-    } else {
-      Serial.println("  Payload: [EMPTY]");
-    }
+    // Print payload (verbose mode) - show full JSON as one-line (binary
+    // formats encode this same document)
+    Serial.print("  Payload: ");
+    serializeJson(doc, Serial);
+    Serial.println();
+    Serial.printf("  Broker: %s:%d\n\n", brokerAddress.c_str(), brokerPort);
   }
 
   // Check MQTT connection state before publish
-  if (!mqttClient.connected()) {
-    LOG_MQTT_ERROR("MQTT client not connected before publish! State: %d",
-                   mqttClient.state());
+  // v1.3.3: As last seen by the network task (owns the client)
+  if (!brokerConnected.load()) {
+    LOG_MQTT_ERROR("MQTT client not connected before publish!");
     return false;
   }
 
-  // Calculate total MQTT packet size for validation
-  uint32_t mqttPacketSize = 5 + 2 + topic.length() + payload.length();
-
-  // Show broker info in development mode - runtime check
-  if (IS_DEV_MODE()) {
-    Serial.printf("  Broker: %s:%d\n", brokerAddress.c_str(), brokerPort);
-    Serial.printf("  Packet size: %u/%u bytes\n\n", mqttPacketSize,
-                  cachedBufferSize);
-  }
-
-  // Validate packet size doesn't exceed buffer
-  if (mqttPacketSize > cachedBufferSize) {
-    LOG_MQTT_INFO(
-        "[MQTT] ERROR: Packet size (%u) exceeds buffer (%u)! Cannot publish.\n",
-        mqttPacketSize, cachedBufferSize);
-    return false;
-  }
-
-  // Validate payload is not empty or corrupted
-  if (payload.length() == 0 || payload.length() > 16000) {
-    LOG_MQTT_INFO("[MQTT] ERROR: Invalid payload size: %u bytes\n",
-                  payload.length());
-    return false;
-  }
-
-  // CRITICAL FIX: Dynamic topic buffer allocation (prevent buffer overflow for
-  // long topics) MQTT spec allows topics up to 65535 bytes, but practically
-  // limit to 512 bytes
+  // CRITICAL FIX: Limit topic length (MQTT spec allows up to 65535 bytes, but
+  // practically limit to 512 bytes)
   constexpr uint16_t MAX_TOPIC_LENGTH = 512;
 
   if (topic.length() > MAX_TOPIC_LENGTH) {
@@ -756,89 +931,409 @@ bool MqttManager::publishPayload(const String& topic, const String& payload,
     return false;
   }
 
-  // Allocate topic buffer dynamically based on actual topic length
-  char* topicBuffer =
-      (char*)heap_caps_malloc(topic.length() + 1, MALLOC_CAP_8BIT);
-  if (!topicBuffer) {
-    LOG_MQTT_INFO(
-        "[MQTT] ERROR: Failed to allocate %u bytes for topic buffer!\n",
-        topic.length() + 1);
-    return false;
-  }
-  // v2.3.15 FIX: Use memcpy for bounds-safe copy (defensive programming)
-  memcpy(topicBuffer, topic.c_str(), topic.length() + 1);
-
-  // Allocate separate buffer for payload to prevent String memory issues
-  uint8_t* payloadBuffer =
-      (uint8_t*)heap_caps_malloc(payload.length(), MALLOC_CAP_8BIT);
-  if (!payloadBuffer) {
-    LOG_MQTT_INFO(
-        "[MQTT] ERROR: Failed to allocate %u bytes for payload buffer!\n",
-        payload.length());
-    heap_caps_free(topicBuffer);  // Free topic buffer before returning
-    return false;
-  }
-
-  // Copy payload to dedicated buffer
-  memcpy(payloadBuffer, payload.c_str(), payload.length());
-  uint32_t payloadLen = payload.length();
-
   // v2.3.18 FIX: Adaptive retain flag based on payload size
   // Some public brokers (e.g., broker.emqx.io) have undocumented ~2KB limit for
   // retained messages Payloads exceeding this limit are silently dropped by the
   // broker when retain=true Solution: Only use retain for payloads under the
   // safe threshold For larger payloads, publish without retain (real-time
-  // delivery still works) v2.5.19 UPDATE: Increased to 16KB (maximum buffer
-  // size) for full retained message support Modern brokers (HiveMQ, Mosquitto,
-  // EMQX, AWS IoT) support 16KB+ retained messages Note: broker.emqx.io free
-  // tier may still drop >2KB, but most production brokers support this
-  const uint32_t RETAIN_PAYLOAD_THRESHOLD =
-      16384;  // 16KB threshold (maximum buffer size)
-  bool useRetain = (payloadLen <= RETAIN_PAYLOAD_THRESHOLD);
+  // delivery still works) v2.5.19 UPDATE: Increased to 16KB for full retained
+  // message support Modern brokers (HiveMQ, Mosquitto, EMQX, AWS IoT) support
+  // 16KB+ retained messages Note: broker.emqx.io free tier may still drop >2KB
+  const uint32_t RETAIN_PAYLOAD_THRESHOLD = 16384;  // 16KB threshold
+  bool useRetain = (payloadSize <= RETAIN_PAYLOAD_THRESHOLD);
 
 #if PRODUCTION_MODE == 0
   if (!useRetain) {
     LOG_MQTT_INFO(
         "[MQTT] Payload %u bytes exceeds retain threshold (%u), publishing "
         "without retain flag\n",
-        payloadLen, RETAIN_PAYLOAD_THRESHOLD);
+        payloadSize, RETAIN_PAYLOAD_THRESHOLD);
   }
 #endif
 
-  bool published = mqttClient.publish(
-      topicBuffer,    // Topic (dynamically allocated buffer)
-      payloadBuffer,  // Payload (dedicated buffer)
-      payloadLen,     // Explicit length
-      useRetain       // ADAPTIVE: retain only for small payloads (v2.3.18)
-  );
-
-  // CRITICAL: Free buffers after publish to prevent memory leak
-  heap_caps_free(topicBuffer);    // Free topic buffer (dynamic allocation)
-  heap_caps_free(payloadBuffer);  // Free payload buffer
+  // v1.3.3: Publish statistics are counted by the network task when the
+  // payload is actually sent
+  bool queued =
+      enqueueOutbound(topic, doc, payloadSize, useRetain, schema, encoded);
 
 #if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO("[MQTT] Publish: %s | State: %d (%s)\n",
-                published ? "SUCCESS" : "FAILED", mqttClient.state(),
-                mqttClient.state() == 0 ? "connected" : "disconnected");
+  LOG_MQTT_INFO("[MQTT] Publish: %s (outbound queue %u/%u)\n",
+                queued ? "QUEUED" : "QUEUE FULL",
+                (unsigned)uxQueueMessagesWaiting(outboundQueue),
+                (unsigned)MqttConfig::OUTBOUND_QUEUE_DEPTH);
 #else
-  if (!published) {
-    LOG_MQTT_ERROR("Publish FAILED! State: %d", mqttClient.state());
+  if (!queued) {
+    LOG_MQTT_ERROR("Publish FAILED! Outbound queue full");
   }
 #endif
 
-  // Delay for TCP flush (20ms sufficient for 16KB payloads)
-  if (published) {
-    vTaskDelay(pdMS_TO_TICKS(20));
-  }
+  return queued;
+}
 
-  // v1.3.0: Update MQTT statistics for Desktop App MQTT Monitor
-  if (published) {
-    stats.publishSuccessCount++;
-    stats.lastPublishTimestamp = millis();
+/**
+ * v1.3.3: Encode doc into one PSRAM block (header + topic + payload) and
+ * queue it for the network task. Waits OUTBOUND_ENQUEUE_WAIT_MS on a full
+ * queue (backpressure); false means the caller keeps the payload.
+ * A shared cycle payload (encoded) is copied instead of encoding doc again.
+ */
+bool MqttManager::enqueueOutbound(const String& topic, JsonDocument& doc,
+                                  size_t payloadSize, bool retain,
+                                  bool schema, const CyclePayload* encoded) {
+  size_t topicSize = topic.length() + 1;
+  OutboundMessage* msg = (OutboundMessage*)heap_caps_malloc(
+      sizeof(OutboundMessage) + topicSize + payloadSize,
+      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!msg) {
+    LOG_MQTT_ERROR("Outbound payload allocation failed (%u bytes)",
+                   (unsigned)payloadSize);
+    return false;
+  }
+  msg->topic = (char*)(msg + 1);
+  msg->payload = (uint8_t*)msg->topic + topicSize;
+  memcpy(msg->topic, topic.c_str(), topicSize);
+  if (encoded) {
+    memcpy(msg->payload, encoded->data(), encoded->length);
+    msg->length = encoded->length;
   } else {
-    stats.publishFailCount++;
+    msg->length =
+        serializePayload(doc, payloadFormat, msg->payload, payloadSize);
+  }
+  msg->format = payloadFormat;
+  msg->retain = retain;
+  msg->schema = schema;
+  msg->attempts = 0;
+
+  if (msg->length != payloadSize ||
+      xQueueSend(outboundQueue, &msg,
+                 pdMS_TO_TICKS(MqttConfig::OUTBOUND_ENQUEUE_WAIT_MS)) !=
+          pdTRUE) {
+    if (msg->length == payloadSize) {
+      stats.outboundFullCount++;
+    }
+    heap_caps_free(msg);
+    return false;
+  }
+
+  uint32_t depth = uxQueueMessagesWaiting(outboundQueue);
+  if (depth > stats.outboundHighWater) {
+    stats.outboundHighWater = depth;
+  }
+  return true;
+}
+
+/**
+ * v1.3.3: Network task - send queued payloads for up to
+ * OUTBOUND_DRAIN_BUDGET_MS, running loop() after each one. A payload whose
+ * send failed stays at the head and is retried once connected again. At
+ * QoS 1 a sent payload moves to the in-flight window; a full window stops
+ * the drain until PUBACKs arrive (the outbound queue then fills up and
+ * backpressures the publish task).
+ */
+void MqttManager::drainOutbound() {
+  unsigned long start = millis();
+  while (millis() - start < MqttConfig::OUTBOUND_DRAIN_BUDGET_MS) {
+    if (publishQos > 0 && inFlightFull()) {
+      return;
+    }
+    if (!outboundHead &&
+        xQueueReceive(outboundQueue, &outboundHead, 0) != pdTRUE) {
+      return;
+    }
+    if (!mqttClient.connected()) {
+      return;  // Kept for the next connection
+    }
+
+    OutboundMessage* msg = outboundHead;
+    uint16_t packetId = (publishQos > 0) ? allocatePacketId() : 0;
+    bool published = publishRaw(msg->topic, msg->payload, msg->length,
+                                msg->retain, packetId);
+    msg->attempts++;
+
+    // v1.3.0: Update MQTT statistics for Desktop App MQTT Monitor
+    if (published) {
+      stats.publishSuccessCount++;
+      stats.lastPublishTimestamp = millis();
+      if (ledManager && !msg->schema) {
+        ledManager->notifyDataTransmission();
+      }
+    } else {
+      stats.publishFailCount++;
+      LOG_MQTT_ERROR("Publish FAILED to %s (attempt %u), State: %d",
+                     msg->topic, msg->attempts, mqttClient.state());
+      if (msg->attempts < MqttConfig::OUTBOUND_MAX_ATTEMPTS) {
+        return;  // Retried after reconnect
+      }
+      persistOutbound(*msg);
+    }
+
+    outboundHead = nullptr;
+    if (published && packetId != 0) {
+      trackInFlight(packetId, msg, 0);  // Freed on its PUBACK
+    } else {
+      heap_caps_free(msg);
+    }
+    mqttClient.loop();  // Keep-alive and incoming commands between payloads
+    processAcks();
+  }
+}
+
+/**
+ * v1.3.3: Send an encoded payload (beginPublish + chunked write +
+ * endPublish). An incomplete write drops the connection: the broker waits
+ * for the announced length and the stream cannot be resynchronized.
+ */
+bool MqttManager::publishRaw(const char* topic, const uint8_t* payload,
+                             size_t length, bool retain, uint16_t packetId,
+                             bool dup) {
+  if (!mqttClient.connected() ||
+      !beginPublishPacket(topic, length, retain, packetId, dup)) {
+    return false;
+  }
+  size_t sent = 0;
+  while (sent < length) {
+    size_t n = std::min(length - sent, MqttConfig::STREAM_CHUNK_SIZE);
+    size_t written = mqttClient.write(payload + sent, n);
+    sent += written;
+    if (written != n) {
+      break;
+    }
+  }
+  bool complete = (sent == length);
+  bool published = mqttClient.endPublish() && complete;
+  if (!complete) {
+    LOG_MQTT_ERROR("Sent %u of %u payload bytes, disconnecting",
+                   (unsigned)sent, (unsigned)length);
+    mqttClient.disconnect();
+  }
+  return published;
+}
+
+/**
+ * v1.3.3: A payload that failed its last attempt goes to the persistent
+ * queue (stored as JSON, re-encoded on resend). CBOR payloads cannot be
+ * decoded here and are dropped; a lost schema is re-published instead.
+ */
+void MqttManager::persistOutbound(const OutboundMessage& msg) {
+  if (msg.schema) {
+    schemaPublished = false;
+    return;
+  }
+
+  bool kept = false;
+  if (persistentQueueEnabled && persistentQueue &&
+      msg.format != PayloadFormat::CBOR) {
+    SpiRamJsonDocument doc;
+    DeserializationError error =
+        (msg.format == PayloadFormat::MSGPACK)
+            ? deserializeMsgPack(doc, msg.payload, msg.length)
+            : deserializeJson(doc, msg.payload, msg.length);
+    if (!error) {
+      JsonObject cleanPayload = doc.as<JsonObject>();
+      kept = persistentQueue->enqueueJsonMessage(
+                 msg.topic, cleanPayload, PRIORITY_NORMAL, 86400000) ==
+             QUEUE_SUCCESS;
+    }
+  }
+  if (!kept) {
+    stats.outboundDropCount++;
+    LOG_MQTT_ERROR("Dropped %u byte payload for %s", (unsigned)msg.length,
+                   msg.topic);
+  }
+}
+
+/**
+ * v1.3.3: Free queued payloads (tasks stopped)
+ */
+void MqttManager::releaseOutbound() {
+  // v1.3.3: Unacknowledged publishes - live payloads are lost like queued
+  // ones, persistent queue messages go back to their queue
+  while (inFlightCount > 0) {
+    InFlightPublish& entry = inFlight[inFlightCount - 1];
+    if (entry.message) {
+      heap_caps_free(entry.message);
+    } else if (persistentQueue) {
+      persistentQueue->requeueInFlight(entry.queuedId);
+    }
+    inFlightCount--;
+  }
+  if (outboundHead) {
+    heap_caps_free(outboundHead);
+    outboundHead = nullptr;
+  }
+  OutboundMessage* msg;
+  while (outboundQueue && xQueueReceive(outboundQueue, &msg, 0) == pdTRUE) {
+    heap_caps_free(msg);
+  }
+}
+
+/**
+ * v1.3.3: Start a PUBLISH packet. packetId 0 = QoS 0 (PubSubClient
+ * beginPublish); otherwise the QoS 1 fixed header, topic and packet ID are
+ * written here, since beginPublish only builds QoS 0 headers. The payload
+ * follows through mqttClient.write() either way.
+ */
+bool MqttManager::beginPublishPacket(const char* topic, size_t length,
+                                     bool retain, uint16_t packetId,
+                                     bool dup) {
+  if (packetId == 0) {
+    return mqttClient.beginPublish(topic, length, retain);
+  }
+
+  size_t topicLength = strlen(topic);
+  uint32_t remaining = 2 + topicLength + 2 + length;  // Topic, ID, payload
+  uint8_t header[7];  // Type + up to 4 length bytes + topic length
+  size_t pos = 0;
+  header[pos++] = 0x32 | (dup ? 0x08 : 0) | (retain ? 0x01 : 0);
+  do {
+    uint8_t digit = remaining % 128;
+    remaining /= 128;
+    header[pos++] = remaining > 0 ? (digit | 0x80) : digit;
+  } while (remaining > 0 && pos < 5);
+  header[pos++] = topicLength >> 8;
+  header[pos++] = topicLength & 0xFF;
+  uint8_t id[2] = {(uint8_t)(packetId >> 8), (uint8_t)(packetId & 0xFF)};
+
+  return mqttClient.write(header, pos) == pos &&
+         mqttClient.write((const uint8_t*)topic, topicLength) == topicLength &&
+         mqttClient.write(id, sizeof(id)) == sizeof(id);
+}
+
+bool MqttManager::inFlightFull() const {
+  return inFlightCount >= inFlightWindow ||
+         inFlightCount >= MqttConfig::MAX_INFLIGHT_WINDOW;
+}
+
+/**
+ * v1.3.3: Next packet ID (1..65535, never one still awaiting its PUBACK)
+ */
+uint16_t MqttManager::allocatePacketId() {
+  while (true) {
+    uint16_t id = nextPacketId++;
+    if (nextPacketId == 0) {
+      nextPacketId = 1;
+    }
+    bool used = false;
+    for (uint8_t i = 0; i < inFlightCount && !used; i++) {
+      used = (inFlight[i].packetId == id);
+    }
+    if (!used) {
+      return id;
+    }
+  }
+}
+
+void MqttManager::trackInFlight(uint16_t packetId, OutboundMessage* message,
+                                uint16_t queuedId) {
+  InFlightPublish& entry = inFlight[inFlightCount++];
+  entry.packetId = packetId;
+  entry.sentAt = millis();
+  entry.message = message;
+  entry.queuedId = queuedId;
+  if (inFlightCount > stats.inFlightHighWater) {
+    stats.inFlightHighWater = inFlightCount;
+  }
+}
+
+void MqttManager::removeInFlight(uint8_t index) {
+  // Keeps send order (resends go out oldest first)
+  for (uint8_t i = index; i + 1 < inFlightCount; i++) {
+    inFlight[i] = inFlight[i + 1];
+  }
+  inFlightCount--;
+}
+
+/**
+ * v1.3.3: Complete the publishes whose PUBACK PubSubClient has read. Run
+ * after every mqttClient.loop(). Unknown IDs (late PUBACK of a publish
+ * already resent and acknowledged) are ignored.
+ */
+void MqttManager::processAcks() {
+  uint16_t packetId;
+  while (ackTap.popAck(packetId)) {
+    for (uint8_t i = 0; i < inFlightCount; i++) {
+      if (inFlight[i].packetId != packetId) {
+        continue;
+      }
+      if (inFlight[i].message) {
+        heap_caps_free(inFlight[i].message);
+      } else if (persistentQueue) {
+        persistentQueue->acknowledgeMessage(inFlight[i].queuedId);
+      }
+      stats.pubackCount++;
+      removeInFlight(i);
+      break;
+    }
+  }
+}
+
+/**
+ * v1.3.3: Resend publishes without a PUBACK after PUBACK_TIMEOUT_MS, or all
+ * of them after a reconnect (sessionLost: clean session, the broker kept no
+ * state). Live payloads are resent with DUP until OUTBOUND_MAX_ATTEMPTS,
+ * then handed to the persistent queue; persistent queue messages go back to
+ * their queue and are resent by processQueue().
+ */
+void MqttManager::checkInFlight(bool sessionLost) {
+  unsigned long now = millis();
+  uint8_t i = 0;
+  while (i < inFlightCount) {
+    InFlightPublish& entry = inFlight[i];
+    if (!sessionLost && now - entry.sentAt < MqttConfig::PUBACK_TIMEOUT_MS) {
+      i++;
+      continue;
+    }
+    if (!sessionLost) {
+      stats.pubackTimeoutCount++;
+    }
+
+    OutboundMessage* msg = entry.message;
+    if (!msg) {
+      if (persistentQueue) {
+        persistentQueue->requeueInFlight(entry.queuedId);
+      }
+      persistentRetryPending.store(true);
+      removeInFlight(i);
+      continue;
+    }
+    if (msg->attempts >= MqttConfig::OUTBOUND_MAX_ATTEMPTS) {
+      persistOutbound(*msg);
+      heap_caps_free(msg);
+      removeInFlight(i);
+      continue;
+    }
+    if (!publishRaw(msg->topic, msg->payload, msg->length, msg->retain,
+                    entry.packetId, true)) {
+      return;  // Connection lost, everything is resent after reconnect
+    }
+    msg->attempts++;
+    entry.sentAt = now;
+    i++;
   }
+}
 
+/**
+ * v1.3.3: Publish doc encoded in payloadFormat. payloadSize must be the
+ * measurePayload() result (announced in the fixed header before streaming).
+ */
+bool MqttManager::streamPayload(const char* topic, JsonVariantConst doc,
+                                size_t payloadSize, bool retain,
+                                uint16_t packetId) {
+  if (!beginPublishPacket(topic, payloadSize, retain, packetId, false)) {
+    return false;
+  }
+  MqttChunkWriter writer(mqttClient);
+  serializePayload(doc, payloadFormat, writer);
+  bool complete = writer.flush() && writer.bytesSent() == payloadSize;
+  bool published = mqttClient.endPublish() && complete;
+
+  if (!complete) {
+    // The broker is waiting for the rest of the announced length; the
+    // stream cannot be resynchronized, so drop the connection (reconnect
+    // loop takes over)
+    LOG_MQTT_ERROR("Streamed %u of %u payload bytes, disconnecting",
+                   writer.bytesSent(), payloadSize);
+    mqttClient.disconnect();
+  }
   return published;
 }
 
@@ -922,12 +1417,45 @@ void MqttManager::loadBrokerConfig(JsonObject& mqttConfig) {
 
   publishMode = mqttConfig["publish_mode"] | "default";
 
+  // v1.3.3: Uplink encoding (unknown values are rejected by ServerConfig)
+  payloadFormat = PayloadFormat::JSON;
+  parsePayloadFormat(mqttConfig["payload_format"] | "json", payloadFormat);
+
+  // v1.3.3: "last" (default) or "window" (per-register publish statistics)
+  String aggregation = mqttConfig["aggregation"] | "last";
+  windowAggregation = aggregation.equalsIgnoreCase("window");
+
+  // v1.3.3: QoS 1 publishing (values range checked by ServerConfig)
+  publishQos = ((mqttConfig["publish_qos"] | 1) == 0) ? 0 : 1;
+  int window =
+      mqttConfig["inflight_window"] | (int)MqttConfig::DEFAULT_INFLIGHT_WINDOW;
+  inFlightWindow = constrain(window, 1, (int)MqttConfig::MAX_INFLIGHT_WINDOW);
+
+  // v1.3.3: Backlog catch-up after a reconnect. Batches are JSON arrays, so
+  // binary formats keep one record per publish.
+  int catchUpBatch = mqttConfig["catch_up_batch"] | 1;
+  int liveShare = mqttConfig["catch_up_live_share"] | 30;
+  if (payloadFormat != PayloadFormat::JSON) {
+    catchUpBatch = 1;
+  }
+  if (persistentQueue) {
+    persistentQueue->setCatchUp(constrain(catchUpBatch, 1, 50),
+                                constrain(liveShare, 0, 90));
+  }
+
+  // v1.3.3: Optional task profiler topic (empty = off)
+  diagnosticsTopic = mqttConfig["diagnostics_topic"] | "";
+  diagnosticsTopic.trim();
+  uint32_t diagnosticsInterval = mqttConfig["diagnostics_interval"] | 60;
+  diagnosticsIntervalMs = diagnosticsInterval * 1000UL;
+
 #if PRODUCTION_MODE == 0
   LOG_MQTT_INFO(
       "[MQTT] Config loaded | Broker: %s:%d | Client: %s | Auth: %s | Mode: "
-      "%s\n",
+      "%s | Format: %s | QoS: %u (window %u)\n",
       brokerAddress.c_str(), brokerPort, clientId.c_str(),
-      (username.length() > 0) ? "YES" : "NO", publishMode.c_str());
+      (username.length() > 0) ? "YES" : "NO", publishMode.c_str(),
+      payloadFormatName(payloadFormat), publishQos, inFlightWindow);
 #endif
 }
 
@@ -954,6 +1482,12 @@ void MqttManager::loadDefaultModeConfig(JsonObject& mqttConfig) {
     defaultInterval = convertToMilliseconds(intervalValue, defaultIntervalUnit);
     lastDefaultPublish = 0;
 
+    // v1.3.3: "nested" (default) or "compact" (schema + value arrays)
+    String layout = defaultMode["payload_layout"] | "nested";
+    compactLayout = layout.equalsIgnoreCase("compact");
+    schemaTopic = defaultTopicPublish + "/schema";
+    schemaPublished = false;
+
 #if PRODUCTION_MODE == 0
     LOG_MQTT_INFO(
         "[MQTT] Default Mode: %s | Topic: %s | Interval: %u%s (%ums)\n",
@@ -999,13 +1533,16 @@ void MqttManager::loadCustomizeModeConfig(JsonObject& mqttConfig) {
         }
 
         if (!ct.topic.isEmpty() && ct.registers.size() > 0) {
+          // v1.3.3: String matching happens here, not per publish
+          ct.refsLayout = PollPlanRegistry::getInstance()->resolveRegisters(
+              ct.registers, ct.refs);
           customTopics.push_back(ct);
 #if PRODUCTION_MODE == 0
           LOG_MQTT_INFO(
-              "[MQTT] Custom Topic: %s | Registers: %d | Interval: %u%s "
-              "(%ums)\n",
-              ct.topic.c_str(), ct.registers.size(), intervalValue,
-              ct.intervalUnit.c_str(), ct.interval);
+              "[MQTT] Custom Topic: %s | Registers: %d (%u bound) | "
+              "Interval: %u%s (%ums)\n",
+              ct.topic.c_str(), ct.registers.size(), (unsigned)ct.refs.size(),
+              intervalValue, ct.intervalUnit.c_str(), ct.interval);
 #endif
         }
       }
@@ -1019,131 +1556,12 @@ void MqttManager::loadCustomizeModeConfig(JsonObject& mqttConfig) {
   }
 }
 
-/**
- * Helper 10: Analyze device configurations for timeout calculation
- * @param devices Device array from config
- * @param maxRefreshRate Output: Maximum refresh rate found
- * @param totalRegisters Output: Total register count
- * @param hasSlowRTU Output: Whether slow RTU detected
- */
-void MqttManager::analyzeDeviceConfigurations(JsonArray& devices,
-                                              uint32_t& maxRefreshRate,
-                                              uint32_t& totalRegisters,
-                                              bool& hasSlowRTU) {
-  maxRefreshRate = 0;
-  totalRegisters = 0;
-  hasSlowRTU = false;
-
-  int deviceIndex = 0;
-  for (JsonVariant deviceVar : devices) {
-    JsonObject device = deviceVar.as<JsonObject>();
-    String protocol = device["protocol"] | "RTU";
-    uint32_t refreshRate = device["refresh_rate_ms"] | 5000;
-    uint32_t baudRate = device["baud_rate"] | 9600;
-    JsonArray registers = device["registers"];
-    uint32_t registerCount = registers.size();
-
-#if PRODUCTION_MODE == 0
-    String deviceId = device["device_id"] | "UNKNOWN";
-    LOG_MQTT_INFO(
-        "[MQTT][DEBUG] Device %d (%s): protocol=%s, refresh=%lums, baud=%lu, "
-        "registers=%lu\n",
-        deviceIndex, deviceId.c_str(), protocol.c_str(), refreshRate, baudRate,
-        registerCount);
-#endif
-
-    totalRegisters += registerCount;
-
-    // Track slowest refresh rate
-    if (refreshRate > maxRefreshRate) {
-      maxRefreshRate = refreshRate;
-#if PRODUCTION_MODE == 0
-      LOG_MQTT_INFO("[MQTT][DEBUG]   → New maxRefreshRate: %lums\n",
-                    maxRefreshRate);
-#endif
-    }
-
-    // Detect slow RTU configurations (9600 baud with many registers)
-    if (protocol == "RTU" && baudRate <= 9600 && registerCount > 20) {
-      hasSlowRTU = true;
-#if PRODUCTION_MODE == 0
-      LOG_MQTT_INFO(
-          "[MQTT][DEBUG]   → Slow RTU detected! (baud=%lu, registers=%lu)\n",
-          baudRate, registerCount);
-#endif
-    }
-
-    deviceIndex++;
-  }
-
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO(
-      "[MQTT][DEBUG] Analysis summary: totalRegisters=%lu, "
-      "maxRefreshRate=%lums, hasSlowRTU=%s\n",
-      totalRegisters, maxRefreshRate, hasSlowRTU ? "YES" : "NO");
-#endif
-}
-
-/**
- * Helper 11: Determine timeout strategy based on device analysis
- * @param totalRegisters Total register count
- * @param maxRefreshRate Maximum refresh rate
- * @param hasSlowRTU Whether slow RTU was detected
- * @return Calculated timeout in milliseconds
- */
-uint32_t MqttManager::determineTimeoutStrategy(uint32_t totalRegisters,
-                                               uint32_t maxRefreshRate,
-                                               bool hasSlowRTU) {
-  uint32_t timeout;
-  String calculationReason = "";
-
-  if (totalRegisters == 0) {
-    timeout = 1000;  // 1s for empty config
-    calculationReason = "no registers";
-  } else if (hasSlowRTU) {
-    // Slow RTU detected - use longer timeout
-    timeout = maxRefreshRate + 2000;  // Refresh rate + 2s margin
-    calculationReason = "slow RTU (refresh + 2000ms)";
-  } else if (totalRegisters <= 10) {
-    // Fast scenario: Few registers
-    timeout = 1000;  // 1s timeout
-    calculationReason = "few registers (≤10)";
-  } else if (totalRegisters <= 50) {
-    // Medium scenario: Moderate registers
-    timeout = maxRefreshRate + 1000;  // Refresh rate + 1s margin
-    calculationReason = "moderate registers (≤50, refresh + 1000ms)";
-  } else {
-    // Heavy scenario: Many registers
-    timeout = maxRefreshRate + 2000;  // Refresh rate + 2s margin
-    calculationReason = "many registers (>50, refresh + 2000ms)";
-  }
-
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO("[MQTT][DEBUG] Timeout BEFORE clamp: %lums (reason: %s)\n",
-                timeout, calculationReason.c_str());
-#endif
-
-  // Clamp between 1s and 10s
-  uint32_t timeoutBeforeClamp = timeout;
-  timeout = constrain(timeout, 1000, 10000);
-
-#if PRODUCTION_MODE == 0
-  if (timeout != timeoutBeforeClamp) {
-    LOG_MQTT_INFO(
-        "[MQTT][DEBUG] Timeout AFTER clamp: %lums (clamped from %lums)\n",
-        timeout, timeoutBeforeClamp);
-  }
-#endif
-
-  return timeout;
-}
-
 // ============================================================================
 // END OF PHASE 2 HELPER METHODS
 // ============================================================================
 
 void MqttManager::publishQueueData() {
-  if (!mqttClient.connected()) {
+  if (!brokerConnected.load()) {  // v1.3.3: Runs in the publish task
     return;
   }
 
@@ -1155,14 +1573,27 @@ void MqttManager::publishQueueData() {
   // ============================================
 
   // Step 1: Check if interval has elapsed (TIME-BASED TRIGGER)
+  // v1.3.3: Intervals stretch under memory pressure (MemoryRecovery
+  // backpressure) - each publish then carries more updates in one payload,
+  // the latest-value table itself does not grow
   bool defaultIntervalElapsed =
       (publishMode == "default" && defaultModeEnabled &&
-       (now - lastDefaultPublish) >= defaultInterval);
+       (now - lastDefaultPublish) >=
+           MemoryRecovery::applyBackpressure(defaultInterval));
+  // v1.3.3: Aligned acquisition - one publish per snapshot cycle, once its
+  // devices are read (or its deadline passed); the interval is not used
+  uint32_t cycleId = 0;
+  AcquisitionCycle* acquisition = AcquisitionCycle::getInstance();
+  if (publishMode == "default" && acquisition->aligned()) {
+    defaultIntervalElapsed =
+        defaultModeEnabled && acquisition->takeReady(cycleId);
+  }
 
   bool customizeIntervalElapsed = false;
   if (publishMode == "customize" && customizeModeEnabled) {
     for (auto& customTopic : customTopics) {
-      if ((now - customTopic.lastPublish) >= customTopic.interval) {
+      if ((now - customTopic.lastPublish) >=
+          MemoryRecovery::applyBackpressure(customTopic.interval)) {
         customizeIntervalElapsed = true;
         break;
       }
@@ -1185,6 +1616,7 @@ void MqttManager::publishQueueData() {
       !publishState.timeLocked) {
     publishState.targetTime = now;  // Lock this time for this publish cycle
     publishState.timeLocked = true;
+    publishState.cycleId = defaultIntervalElapsed ? cycleId : 0;
 
 #if PRODUCTION_MODE == 0
     LOG_MQTT_INFO(
@@ -1203,7 +1635,8 @@ void MqttManager::publishQueueData() {
   }
   if (customizeIntervalElapsed) {
     for (auto& customTopic : customTopics) {
-      if ((now - customTopic.lastPublish) >= customTopic.interval) {
+      if ((now - customTopic.lastPublish) >=
+          MemoryRecovery::applyBackpressure(customTopic.interval)) {
         customTopic.lastPublish = publishState.targetTime;
       }
     }
@@ -1230,12 +1663,15 @@ void MqttManager::publishQueueData() {
   }
 #endif
 
-  // Step 3: Check if queue is empty
-  // NOTE: Batch waiting logic removed - End-of-Batch Marker pattern handles
-  // device completion signaling directly through queue markers
-  QueueManager* queueMgr = QueueManager::getInstance();
-  if (queueMgr && queueMgr->isEmpty()) {
-    // Queue is empty - no data to publish, skip silently
+  // Step 3: Check if any register was updated since the last publish
+  // v1.3.3: Latest-value table (PollPlanRegistry) instead of the data queue,
+  // or any read in the open window when aggregating. Custom topics track
+  // their own updates (readLatest), so they are not skipped here.
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  bool skipWhenIdle = windowAggregation || defaultIntervalElapsed;
+  if (skipWhenIdle && (windowAggregation ? registry->pendingAggregates()
+                                         : registry->pendingLatest()) == 0) {
+    // No new data to publish, skip silently
     // v2.5.1: lastDefaultPublish already updated above, so next interval check
     // will be correct
     publishState.timeLocked = false;  // Reset for next interval
@@ -1257,60 +1693,25 @@ void MqttManager::publishQueueData() {
   // v2.3.7 OPTIMIZED: Process persistent queue AFTER batch wait (before
   // dequeue) This prevents queue processing delays from affecting interval
   // precision
+  // v1.3.3: Resends run in the network task (persistentRetryPending)
   if (persistentQueueEnabled && persistentQueue) {
-    uint32_t persistedSent = persistentQueue->processQueue();
-#if PRODUCTION_MODE == 0
-    if (persistedSent > 0) {
-      LOG_MQTT_INFO("[MQTT] Resent %ld persistent messages\n", persistedSent);
-    }
-#endif
-  }
-
-  // Only dequeue if we're actually going to publish
-  std::map<String, JsonDocument> uniqueRegisters;
-
-  // DEBUG: Track dequeue count
-  int dequeueCount = 0;
-
-  // Dequeue up to MAX_REGISTERS_PER_PUBLISH registers (configurable limit)
-  while (uniqueRegisters.size() < MqttConfig::MAX_REGISTERS_PER_PUBLISH) {
-    JsonDocument dataDoc;
-    JsonObject dataPoint = dataDoc.to<JsonObject>();
-
-    if (!queueManager->dequeue(dataPoint)) {
-      break;  // Queue empty
-    }
-
-    dequeueCount++;
-
-    String deviceId = dataPoint["device_id"].as<String>();
-    String registerId = dataPoint["register_id"].as<String>();
-
-    if (!deviceId.isEmpty() && !registerId.isEmpty()) {
-      // Use device_id + register_id as unique key to prevent data overwrite
-      // between devices
-      String uniqueKey = deviceId + "_" + registerId;
-      uniqueRegisters[uniqueKey] = dataDoc;
-    }
-  }
-
-  if (uniqueRegisters.empty()) {
-    publishState.timeLocked = false;  // Reset for next interval
-    xSemaphoreGive(publishStateMutex);
-    return;  // Nothing to publish
+    persistentRetryPending.store(true);
   }
 
   // Route to appropriate publish mode
   if (defaultIntervalElapsed) {
-    publishDefaultMode(uniqueRegisters, now);
+    publishDefaultMode(now);
   } else if (customizeIntervalElapsed) {
-    publishCustomizeMode(uniqueRegisters, now);
+    publishCustomizeMode(now);
   }
 
   // v2.3.7 CRITICAL FIX: Reset target time lock for next interval
   // This allows the next interval to capture a fresh timestamp
   publishState.timeLocked = false;
 
+  // v1.3.3: The cycle's documents are gone - release their memory at once
+  publishArena.reset();
+
 #if PRODUCTION_MODE == 0
   LOG_MQTT_INFO("[MQTT] ✓ Publish cycle complete - ready for next interval\n");
 #endif
@@ -1321,40 +1722,77 @@ void MqttManager::publishQueueData() {
 
 // v2.3.8 PHASE 1: REFACTORED - Reduced from 323 lines to ~60 lines using helper
 // methods (81% reduction)
-void MqttManager::publishDefaultMode(
-    std::map<String, JsonDocument>& uniqueRegisters, unsigned long now) {
-  // Calculate estimated size for logging/monitoring
-  constexpr uint32_t AVG_BYTES_PER_REGISTER = 150;
-  constexpr uint32_t JSON_OVERHEAD = 1000;
-  uint32_t estimatedSize =
-      (uniqueRegisters.size() * AVG_BYTES_PER_REGISTER) + JSON_OVERHEAD;
-
+void MqttManager::publishDefaultMode(unsigned long now) {
   // Create JSON document with PSRAM allocation
-  SpiRamJsonDocument batchDoc;
-  LOG_MQTT_DEBUG(
-      "JsonDocument created for %d registers (estimated: ~%u bytes)\n",
-      uniqueRegisters.size(), estimatedSize);
+  // v1.3.3: From the publish cycle arena (reset in publishQueueData)
+  SpiRamJsonDocument batchDoc(&publishArena);
+  // v1.3.3: HTTP "cycle" layout consumers send this cycle too (not the
+  // compact layout - its value arrays need MQTT's schema)
+  CyclePayloadStore* cycleStore = CyclePayloadStore::getInstance();
+  bool sharedCycle = false;
 
   // Helper 1: Build RTC timestamp
   buildTimestamp(batchDoc, now);
+  if (publishState.cycleId != 0) {
+    batchDoc["cycle_id"] = publishState.cycleId;  // v1.3.3: Aligned cycle
+  }
 
-  // Create devices object for grouping
-  JsonObject devicesObject = batchDoc["devices"].to<JsonObject>();
-  std::map<String, JsonObject> deviceObjects;
-
-  // Helper 2: Validate devices and group registers (nullptr = include all
-  // registers)
-  int totalRegisters = validateAndGroupRegisters(uniqueRegisters, devicesObject,
-                                                 deviceObjects, nullptr);
-
-  // Helper 3: Serialize and validate JSON payload
-  String payload;
-  if (!serializeAndValidatePayload(batchDoc, payload, estimatedSize)) {
-    return;  // Serialization or validation failed
+  int totalRegisters = 0;
+  int deviceCount = 0;
+  if (compactLayout) {
+    // v1.3.3: Value arrays in schema order (schema published first)
+    if (schemaLayoutVersion !=
+            PollPlanRegistry::getInstance()->layoutVersion() ||
+        !schemaPublished) {
+      if (!publishSchema()) {
+        return;  // Values stay in the latest-value table until next cycle
+      }
+    }
+    buildCompactPayload(batchDoc, totalRegisters, deviceCount);
+  } else {
+    // Create devices object for grouping
+    DeviceGrouping grouping;
+    grouping.devices = batchDoc["devices"].to<JsonObject>();
+    // v1.3.3: Fixed-decimal text only if every encoding of the cycle is JSON
+    sharedCycle = cycleStore->hasSubscribers();
+    grouping.fixedText = sharedCycle ? cycleStore->textOnly(payloadFormat)
+                                     : payloadFormat == PayloadFormat::JSON;
+
+    // Helper 2: Group every register updated since the last publish
+    // (v1.3.3: latest-value table, no register cap)
+    if (windowAggregation) {
+      PollPlanRegistry::getInstance()->drainAggregates(
+          [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+              const WindowStats& stats) {
+            MqttPayloadBuilder::addAggregateRegister(grouping, plan, reg,
+                                                     stats);
+          });
+    } else {
+      PollPlanRegistry::getInstance()->drainLatest(
+          [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+              double value, uint32_t timestamp) {
+            MqttPayloadBuilder::addLatestRegister(grouping, plan, reg, value);
+          });
+    }
+    totalRegisters = grouping.registerCount;
+    deviceCount = grouping.deviceCount;
   }
+  if (totalRegisters == 0) {
+    return;  // Nothing to publish
+  }
+
+  LOG_MQTT_DEBUG("JsonDocument created for %d registers\n", totalRegisters);
 
-  // Helper 4: Publish payload to MQTT broker
-  bool published = publishPayload(defaultTopicPublish, payload, "Default Mode");
+  // Helper 3: Stream payload to MQTT broker
+  size_t payloadSize = 0;
+  // v1.3.3: Encoded once per format; HTTP keeps its copy even if the
+  // outbound queue is full (independent delivery cursors)
+  CyclePayload* encoded =
+      sharedCycle ? cycleStore->publish(batchDoc, payloadFormat) : nullptr;
+  bool published = publishDocument(defaultTopicPublish, batchDoc,
+                                   "Default Mode", payloadSize, false,
+                                   encoded);
+  cycleStore->release(encoded);
 
   if (published) {
     // Helper 5: Calculate display interval with unit conversion
@@ -1363,40 +1801,23 @@ void MqttManager::publishDefaultMode(
     calculateDisplayInterval(defaultInterval, defaultIntervalUnit,
                              displayInterval, displayUnit);
 
+    // v1.3.3: Queued for the network task (LED blinks when it is sent)
     LOG_MQTT_INFO(
-        "Default Mode: Published %d registers from %d devices to %s (%.1f KB) "
+        "Default Mode: Queued %d registers from %d devices to %s (%.1f KB) "
         "/ %u%s\n",
-        totalRegisters, deviceObjects.size(), defaultTopicPublish.c_str(),
-        payload.length() / 1024.0, displayInterval, displayUnit);
+        totalRegisters, deviceCount, defaultTopicPublish.c_str(),
+        payloadSize / 1024.0, displayInterval, displayUnit);
 
     // Batch clearing no longer needed - End-of-Batch Marker pattern handles
     // this automatically
-
-    if (ledManager) {
-      ledManager->notifyDataTransmission();
-    }
   } else {
-    LOG_MQTT_INFO(
-        "[MQTT] Default Mode: Publish failed (payload: %d bytes, buffer: %u "
-        "bytes)\n",
-        payload.length(), cachedBufferSize);
-
-    // CRITICAL FIX: Prevent "Poison Message" - Don't enqueue payloads that are
-    // too large for buffer If payload exceeds buffer size, it will fail again
-    // when retried, creating infinite loop
-    if (payload.length() > cachedBufferSize) {
-      LOG_MQTT_INFO(
-          "[MQTT] ERROR: Payload dropped (too large: %d bytes > %u bytes "
-          "buffer)\n",
-          payload.length(), cachedBufferSize);
-      LOG_MQTT_INFO(
-          "[MQTT] SOLUTION: Increase MQTT_MAX_PACKET_SIZE or reduce "
-          "device/register count");
-      // Don't enqueue - message is permanently dropped to prevent queue
-      // poisoning
-    } else if (persistentQueueEnabled && persistentQueue) {
-      // Only enqueue if size is reasonable (failed for other reasons like
-      // network)
+    LOG_MQTT_INFO("[MQTT] Default Mode: Publish failed (payload: %u bytes)\n",
+                  payloadSize);
+
+    // v1.3.3: No payload size limit anymore (streamed publish), so every
+    // failure is transient (network/broker/full outbound queue) and worth
+    // retrying
+    if (persistentQueueEnabled && persistentQueue) {
       JsonObject cleanPayload = batchDoc.as<JsonObject>();
       persistentQueue->enqueueJsonMessage(defaultTopicPublish, cleanPayload,
                                           PRIORITY_NORMAL, 86400000);
@@ -1406,51 +1827,108 @@ void MqttManager::publishDefaultMode(
 
 // v2.3.8 PHASE 1: REFACTORED - Reduced from 342 lines using helper methods
 // (similar reduction as default mode)
-void MqttManager::publishCustomizeMode(
-    std::map<String, JsonDocument>& uniqueRegisters, unsigned long now) {
-  // Publish to each custom topic based on its interval
+void MqttManager::publishCustomizeMode(unsigned long now) {
+  // v1.3.3: One payload per due topic, all filled by a single drain of the
+  // latest-value table
+  struct TopicPayload {
+    explicit TopicPayload(ArduinoJson::Allocator* allocator) : doc(allocator) {}
+    CustomTopic* topic;
+    SpiRamJsonDocument doc;
+    DeviceGrouping grouping;
+  };
+  std::vector<std::unique_ptr<TopicPayload>> payloads;
+
   for (auto& customTopic : customTopics) {
     // Check if interval elapsed for this topic
-    if ((now - customTopic.lastPublish) < customTopic.interval) {
+    if ((now - customTopic.lastPublish) <
+        MemoryRecovery::applyBackpressure(customTopic.interval)) {
       continue;  // Wait for this topic's interval
     }
 
-    // Calculate estimated size for logging
-    constexpr uint32_t AVG_BYTES_PER_REGISTER = 150;
-    constexpr uint32_t JSON_OVERHEAD = 1000;
-    uint32_t estimatedSize =
-        (customTopic.registers.size() * AVG_BYTES_PER_REGISTER) + JSON_OVERHEAD;
-
     // Create JSON document with PSRAM allocation
-    SpiRamJsonDocument topicDoc;
-    LOG_MQTT_DEBUG(
-        "Customize Mode: JsonDocument created for topic %s (%d registers, "
-        "estimated: ~%u bytes)\n",
-        customTopic.topic.c_str(), customTopic.registers.size(), estimatedSize);
+    // v1.3.3: From the publish cycle arena (reset in publishQueueData)
+    std::unique_ptr<TopicPayload> topicPayload(
+        new TopicPayload(&publishArena));
+    topicPayload->topic = &customTopic;
 
     // Helper 1: Build RTC timestamp
-    buildTimestamp(topicDoc, now);
+    buildTimestamp(topicPayload->doc, now);
 
     // Create devices object for grouping
-    JsonObject devicesObject = topicDoc["devices"].to<JsonObject>();
-    std::map<String, JsonObject> deviceObjects;
+    topicPayload->grouping.devices =
+        topicPayload->doc["devices"].to<JsonObject>();
+    topicPayload->grouping.fixedText =
+        payloadFormat == PayloadFormat::JSON;  // v1.3.3
+    payloads.push_back(std::move(topicPayload));
+  }
 
-    // Helper 2: Validate and group registers (with filter for this topic's
-    // registers)
-    int registerCount = validateAndGroupRegisters(
-        uniqueRegisters, devicesObject, deviceObjects, &customTopic.registers);
+  if (payloads.empty()) {
+    return;
+  }
 
-    // Only publish if there's data for this topic
-    if (registerCount > 0) {
-      // Helper 3: Serialize and validate JSON payload
-      String payload;
-      if (!serializeAndValidatePayload(topicDoc, payload, estimatedSize)) {
-        continue;  // Skip to next topic if serialization failed
+  // Helper 2: Fill every due topic from its resolved register list
+  // (v1.3.3: no register_id matching per publish)
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  uint32_t layout = registry->layoutVersion();
+  for (auto& topicPayload : payloads) {
+    CustomTopic& customTopic = *topicPayload->topic;
+    if (customTopic.refsLayout != layout) {
+      customTopic.refsLayout =
+          registry->resolveRegisters(customTopic.registers, customTopic.refs);
+    }
+  }
+
+  if (windowAggregation) {
+    // v1.3.3: One window for all topics (closed by this publish cycle)
+    registry->drainAggregates([&](const CompiledDevicePlan& plan,
+                                  const CompiledRegister& reg,
+                                  const WindowStats& stats) {
+      PollPlanRegistry::RegisterRef key{
+          plan.registrySlot, plan.registryGeneration,
+          (uint16_t)(&reg - plan.registers.data()), 0};
+      auto before = [](const PollPlanRegistry::RegisterRef& a,
+                       const PollPlanRegistry::RegisterRef& b) {
+        return a.slot < b.slot ||
+               (a.slot == b.slot && a.registerSlot < b.registerSlot);
+      };
+      for (auto& topicPayload : payloads) {
+        const auto& refs = topicPayload->topic->refs;
+        if (std::binary_search(refs.begin(), refs.end(), key, before)) {
+          MqttPayloadBuilder::addAggregateRegister(topicPayload->grouping,
+                                                   plan, reg, stats);
+        }
       }
+    });
+  } else {
+    // Each topic consumes its own updates: a topic with a longer interval
+    // still gets values another topic already published
+    for (auto& topicPayload : payloads) {
+      DeviceGrouping& grouping = topicPayload->grouping;
+      registry->readLatest(
+          topicPayload->topic->refs,
+          [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+              double value, uint32_t timestamp) {
+            MqttPayloadBuilder::addLatestRegister(grouping, plan, reg, value);
+          });
+    }
+  }
 
-      // Helper 4: Publish payload to MQTT broker
-      bool published =
-          publishPayload(customTopic.topic, payload, "Customize Mode");
+  // Publish to each due custom topic
+  for (auto& topicPayload : payloads) {
+    CustomTopic& customTopic = *topicPayload->topic;
+    SpiRamJsonDocument& topicDoc = topicPayload->doc;
+    int registerCount = topicPayload->grouping.registerCount;
+
+    LOG_MQTT_DEBUG(
+        "Customize Mode: JsonDocument created for topic %s (%d registers)\n",
+        customTopic.topic.c_str(), registerCount);
+
+    // Only publish if there's data for this topic
+    if (registerCount > 0) {
+      // Helper 3: Stream payload to MQTT broker
+      size_t payloadSize = 0;
+      bool published = publishDocument(customTopic.topic, topicDoc,
+                                       "Customize Mode", payloadSize);
 
       if (published) {
         // Helper 5: Calculate display interval with unit conversion
@@ -1459,37 +1937,22 @@ void MqttManager::publishCustomizeMode(
         calculateDisplayInterval(customTopic.interval, customTopic.intervalUnit,
                                  displayInterval, displayUnit);
 
+        // v1.3.3: Queued for the network task (LED blinks when it is sent)
         LOG_MQTT_INFO(
-            "[MQTT] Customize Mode: Published %d registers from %d devices to "
+            "[MQTT] Customize Mode: Queued %d registers from %d devices to "
             "%s (%.1f KB) / %u%s\n",
-            registerCount, deviceObjects.size(), customTopic.topic.c_str(),
-            payload.length() / 1024.0, displayInterval, displayUnit);
+            registerCount, topicPayload->grouping.deviceCount,
+            customTopic.topic.c_str(), payloadSize / 1024.0,
+            displayInterval, displayUnit);
 
         // Batch clearing no longer needed - End-of-Batch Marker pattern handles
         // this automatically
-
-        if (ledManager) {
-          ledManager->notifyDataTransmission();
-        }
       } else {
         LOG_MQTT_INFO("[MQTT] Customize Mode: Publish failed for topic %s\n",
                       customTopic.topic.c_str());
 
-        // CRITICAL FIX: Prevent "Poison Message" - Don't enqueue payloads that
-        // are too large for buffer
-        if (payload.length() > cachedBufferSize) {
-          LOG_MQTT_INFO(
-              "[MQTT] ERROR: Payload dropped for topic %s (too large: %d bytes "
-              "> %u bytes buffer)\n",
-              customTopic.topic.c_str(), payload.length(), cachedBufferSize);
-          LOG_MQTT_INFO(
-              "[MQTT] SOLUTION: Increase MQTT_MAX_PACKET_SIZE or reduce "
-              "registers in this topic");
-          // Don't enqueue - message is permanently dropped to prevent queue
-          // poisoning
-        } else if (persistentQueueEnabled && persistentQueue) {
-          // Only enqueue if size is reasonable (failed for other reasons like
-          // network)
+        // v1.3.3: Streamed publish has no size limit - retry any failure
+        if (persistentQueueEnabled && persistentQueue) {
           JsonObject cleanPayload = topicDoc.as<JsonObject>();
           persistentQueue->enqueueJsonMessage(customTopic.topic, cleanPayload,
                                               PRIORITY_NORMAL, 86400000);
@@ -1551,9 +2014,13 @@ void MqttManager::getStatus(JsonObject& status) {
   status["broker_port"] = brokerPort;
   status["client_id"] = clientId;
   status["topic_publish"] = topicPublish;
-  status["queue_size"] = queueManager->size();
+  // v1.3.3: Registers updated since the last publish (latest-value table)
+  status["queue_size"] = PollPlanRegistry::getInstance()->pendingLatest();
   status["publish_mode"] = publishMode;  // v2.2.0: Show current publish mode
                                          // instead of legacy data_interval_ms
+  // v1.3.3: Snapshot cycle statistics (aligned acquisition)
+  JsonObject acquisition = status["acquisition"].to<JsonObject>();
+  AcquisitionCycle::getInstance()->getStatus(acquisition);
 
   // v1.1.0: Include subscribe control status
   JsonObject subscribeStatus = status["subscribe_control"].to<JsonObject>();
@@ -1595,130 +2062,6 @@ uint32_t MqttManager::getQueuedMessageCount() const {
   return 0;
 }
 
-// ============================================
-// FIXED BUG #15: DYNAMIC MQTT BUFFER SIZING
-// ============================================
-uint16_t MqttManager::calculateOptimalBufferSize() {
-  if (!configManager) {
-    // Fallback to conservative default if no config
-    return 4096;  // 4KB default
-  }
-
-  // Load all devices to count total registers
-  // Use getAllDevicesWithRegisters() to get device data
-  // BUG #31: JsonDocument will use PSRAM via DefaultAllocator override
-  // (JsonDocumentPSRAM.h)
-  JsonDocument devicesDoc;  // Automatically uses PSRAM allocator from
-                            // JsonDocumentPSRAM.h
-  JsonArray devices = devicesDoc.to<JsonArray>();
-  configManager->getAllDevicesWithRegisters(devices, true);  // minimal fields
-
-  if (devices.size() == 0) {
-    return 4096;  // 4KB default if no devices
-  }
-
-  uint32_t totalRegisters = 0;
-  uint32_t maxDeviceRegisters = 0;
-
-  // Count total and max registers
-  for (JsonVariant deviceVar : devices) {
-    JsonObject device = deviceVar.as<JsonObject>();
-    JsonArray registers = device["registers"];
-    uint32_t deviceRegCount = registers.size();
-
-    totalRegisters += deviceRegCount;
-    if (deviceRegCount > maxDeviceRegisters) {
-      maxDeviceRegisters = deviceRegCount;
-    }
-  }
-
-  // Calculate buffer size based on total registers
-  // Formula: (totalRegisters * BYTES_PER_REGISTER) + BUFFER_OVERHEAD
-  // - Each register: ~50-70 bytes (name, value, unit, timestamp, device_id)
-  // - Batch overhead: ~300 bytes (JSON structure, device metadata)
-  uint32_t calculatedSize = (totalRegisters * MqttConfig::BYTES_PER_REGISTER) +
-                            MqttConfig::BUFFER_OVERHEAD;
-
-  // Apply constraints
-  uint16_t optimalSize = MqttConfig::DEFAULT_BUFFER_SIZE;
-
-  if (calculatedSize < MqttConfig::MIN_BUFFER_SIZE) {
-    optimalSize = MqttConfig::MIN_BUFFER_SIZE;
-  } else if (calculatedSize > MqttConfig::MAX_BUFFER_SIZE) {
-    optimalSize = MqttConfig::MAX_BUFFER_SIZE;
-    LOG_MQTT_INFO(
-        "[MQTT] WARNING: Calculated buffer (%lu bytes) exceeds max (%u "
-        "bytes)\n",
-        calculatedSize, MqttConfig::MAX_BUFFER_SIZE);
-    LOG_MQTT_INFO(
-        "[MQTT] Consider reducing devices/registers or enabling payload "
-        "splitting\n");
-  } else {
-    optimalSize = (uint16_t)calculatedSize;
-  }
-
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO(
-      "[MQTT] Buffer calculation: %u registers = %u bytes (min: %u, max: %u)\n",
-      totalRegisters, optimalSize, MqttConfig::MIN_BUFFER_SIZE,
-      MqttConfig::MAX_BUFFER_SIZE);
-#endif
-
-  return optimalSize;
-}
-
-// ============================================
-// v2.3.7: ADAPTIVE BATCH TIMEOUT CALCULATION
-// v2.3.8 PHASE 2: REFACTORED - Reduced from 128 lines to ~30 lines using helper
-// methods (77% reduction)
-// ============================================
-uint32_t MqttManager::calculateAdaptiveBatchTimeout() {
-  if (!configManager) {
-#if PRODUCTION_MODE == 0
-    LOG_MQTT_INFO("[MQTT][DEBUG] No ConfigManager - returning default 2000ms");
-#endif
-    return 2000;  // Default 2s if no config
-  }
-
-  // Load all devices to analyze configuration
-  JsonDocument devicesDoc;
-  JsonArray devices = devicesDoc.to<JsonArray>();
-  configManager->getAllDevicesWithRegisters(devices, true);  // minimal fields
-
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO("[MQTT][DEBUG] Loaded %d devices for timeout calculation\n",
-                devices.size());
-#endif
-
-  if (devices.size() == 0) {
-#if PRODUCTION_MODE == 0
-    LOG_MQTT_INFO("[MQTT][DEBUG] No devices - returning default 1000ms");
-#endif
-    return 1000;  // 1s default if no devices
-  }
-
-  // Helper 10: Analyze device configurations (refresh rates, register counts,
-  // RTU detection)
-  uint32_t maxRefreshRate = 0;
-  uint32_t totalRegisters = 0;
-  bool hasSlowRTU = false;
-  analyzeDeviceConfigurations(devices, maxRefreshRate, totalRegisters,
-                              hasSlowRTU);
-
-  // Helper 11: Determine timeout strategy based on analysis results
-  uint32_t timeout =
-      determineTimeoutStrategy(totalRegisters, maxRefreshRate, hasSlowRTU);
-
-#if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO(
-      "[MQTT] ✓ Adaptive batch timeout: %lums (devices: %d, registers: %lu, "
-      "max_refresh: %lums)\n",
-      timeout, devices.size(), totalRegisters, maxRefreshRate);
-#endif
-
-  return timeout;
-}
-
 // ============================================================================
 // v1.2.0: TOPIC-CENTRIC MQTT SUBSCRIBE CONTROL (Desktop App Spec)
 // One topic → N registers from multiple devices
@@ -1794,6 +2137,14 @@ void MqttManager::loadCustomSubscribeConfig(JsonObject& mqttConfig) {
         }
       }
 
+      // v1.3.3: Hashed topic routing (vector is final now)
+      subscriptionIndex.reset(subscriptions.size());
+      for (size_t i = 0; i < subscriptions.size(); i++) {
+        subscriptionIndex.insert(subscriptions[i].topic.c_str(), (uint16_t)i);
+      }
+      writeTargetsGeneration = 0;  // Resolve on the first command
+      refreshWriteTargets();
+
       xSemaphoreGive(subscriptionsMutex);
     }
 
@@ -1843,19 +2194,55 @@ void MqttManager::initializeSubscriptions() {
 
 /**
  * Find subscription by exact topic match
+ * v1.3.3: Hash lookup (was a String compare against every subscription)
  */
 MqttManager::MqttSubscription* MqttManager::findSubscriptionByTopic(
-    const String& topic) {
+    const char* topic) {
+  uint16_t slot = subscriptionIndex.find(topic, [&](uint16_t candidate) {
+    return candidate < subscriptions.size() &&
+           subscriptions[candidate].topic == topic;
+  });
+  if (slot == ModbusDeviceIndex::INVALID_SLOT) {
+    return nullptr;
+  }
+  return &subscriptions[slot];
+}
+
+/**
+ * v1.3.3: Resolve device existence and protocol of every subscription
+ * register once per devices generation (caller holds subscriptionsMutex)
+ */
+void MqttManager::refreshWriteTargets() {
+  if (!configManager) {
+    return;
+  }
+  ConfigManager::DevicesGenerationHandle generation =
+      configManager->getDevicesGeneration();
+  if (!generation || generation->number == writeTargetsGeneration) {
+    return;
+  }
+  writeTargetsGeneration = generation->number;
+
   for (auto& sub : subscriptions) {
-    if (sub.topic == topic) {
-      return &sub;
+    for (auto& reg : sub.registers) {
+      reg.found = false;
+      reg.tcp = false;
+      for (const auto& entry : generation->devices) {
+        if (reg.deviceId == (const char*)entry.deviceId) {
+          reg.found = true;
+          reg.tcp =
+              strcmp((*entry.config)["protocol"] | "RTU", "TCP") == 0;
+          break;
+        }
+      }
     }
   }
-  return nullptr;
 }
 
 /**
  * Static callback for incoming MQTT messages
+ * v1.3.3: Topic and payload are used in place from the PubSubClient buffer
+ * (no String copies)
  */
 void MqttManager::onMqttMessage(char* topic, byte* payload,
                                 unsigned int length) {
@@ -1863,27 +2250,21 @@ void MqttManager::onMqttMessage(char* topic, byte* payload,
     return;
   }
 
-  // Convert payload to string
-  String payloadStr;
-  payloadStr.reserve(length + 1);
-  for (unsigned int i = 0; i < length; i++) {
-    payloadStr += (char)payload[i];
-  }
-
 #if PRODUCTION_MODE == 0
-  LOG_MQTT_INFO("[MQTT] Message received | Topic: %s | Payload: %s\n", topic,
-                payloadStr.c_str());
+  LOG_MQTT_INFO("[MQTT] Message received | Topic: %s | Payload: %.*s\n",
+                topic, (int)length, (const char*)payload);
 #endif
 
   // Handle write command
-  instance->handleWriteCommand(String(topic), payloadStr);
+  instance->handleWriteCommand(topic, payload, length);
 }
 
 /**
  * Handle incoming write command from MQTT (topic-centric approach)
  */
-void MqttManager::handleWriteCommand(const String& topic,
-                                     const String& payload) {
+void MqttManager::handleWriteCommand(const char* topic,
+                                     const uint8_t* payload,
+                                     unsigned int length) {
   if (!customSubscribeModeEnabled) {
     return;
   }
@@ -1896,10 +2277,12 @@ void MqttManager::handleWriteCommand(const String& topic,
     xSemaphoreGive(subscriptionsMutex);
     return;  // Not one of our subscribed topics
   }
+  refreshWriteTargets();  // v1.3.3: No-op unless devices changed
 
   // Parse payload as JSON
   JsonDocument payloadDoc;
-  DeserializationError error = deserializeJson(payloadDoc, payload);
+  DeserializationError error =
+      deserializeJson(payloadDoc, (const char*)payload, length);
   if (error) {
     xSemaphoreGive(subscriptionsMutex);
     publishErrorResponse(*sub, "Invalid JSON payload", 400);
@@ -1939,16 +2322,33 @@ void MqttManager::handleWriteCommand(const String& topic,
     }
   } else {
     // Multi-register: {"RegA": 1, "RegB": 0}
+    // v1.3.3: Collected first, then written per device (one batch each)
+    std::vector<SubscriptionRegister*> writeRegs;
+    std::vector<float> writeValues;
+    std::vector<JsonObject> writeResults;
     for (auto& reg : sub->registers) {
       if (!payloadDoc[reg.registerId].isNull()) {
-        float value = payloadDoc[reg.registerId].as<float>();
-        JsonObject result = results.add<JsonObject>();
-        if (writeToRegister(reg, value, result)) {
-          successCount++;
-        } else {
-          failCount++;
+        writeRegs.push_back(&reg);
+        writeValues.push_back(payloadDoc[reg.registerId].as<float>());
+        writeResults.push_back(results.add<JsonObject>());
+      }
+    }
+
+    std::vector<bool> written(writeRegs.size(), false);
+    std::vector<size_t> group;
+    for (size_t i = 0; i < writeRegs.size(); i++) {
+      if (written[i]) continue;
+      group.clear();
+      for (size_t j = i; j < writeRegs.size(); j++) {
+        if (!written[j] && writeRegs[j]->deviceId == writeRegs[i]->deviceId) {
+          group.push_back(j);
+          written[j] = true;
         }
       }
+      int groupSuccess = writeDeviceRegisters(group, writeRegs, writeValues,
+                                              writeResults);
+      successCount += groupSuccess;
+      failCount += (int)group.size() - groupSuccess;
     }
   }
 
@@ -1973,7 +2373,7 @@ void MqttManager::handleWriteCommand(const String& topic,
 
   LOG_MQTT_INFO(
       "[MQTT] Write Command: topic=%s, success=%d, failed=%d\n",
-      topic.c_str(), successCount, failCount);
+      topic, successCount, failCount);
 }
 
 /**
@@ -1990,20 +2390,18 @@ bool MqttManager::writeToRegister(SubscriptionRegister& reg, float value,
     return false;
   }
 
-  // Read device to determine protocol
-  JsonDocument deviceDoc;
-  JsonObject deviceObj = deviceDoc.to<JsonObject>();
-  if (!configManager->readDevice(reg.deviceId, deviceObj)) {
+  // v1.3.3: Protocol resolved by refreshWriteTargets() (was a readDevice()
+  // copy of the whole device config per write)
+  if (!reg.found) {
     result["status"] = "error";
     result["error"] = "Device not found";
     result["error_code"] = 404;
     return false;
   }
 
-  String protocol = deviceObj["protocol"] | "RTU";
   bool success = false;
 
-  if (protocol == "TCP") {
+  if (reg.tcp) {
     if (modbusTcpService) {
       success = modbusTcpService->writeRegisterValue(
           reg.deviceId.c_str(), reg.registerId.c_str(), value, result);
@@ -2029,6 +2427,56 @@ bool MqttManager::writeToRegister(SubscriptionRegister& reg, float value,
   return success;
 }
 
+/**
+ * Write the registers of one device (v1.3.3)
+ * RTU devices get one batched call (contiguous registers share a FC15/FC16
+ * transaction); other devices are written register by register.
+ */
+int MqttManager::writeDeviceRegisters(
+    const std::vector<size_t>& group,
+    const std::vector<SubscriptionRegister*>& regs,
+    const std::vector<float>& values, std::vector<JsonObject>& results) {
+  int successCount = 0;
+  const String& deviceId = regs[group[0]]->deviceId;
+
+  const SubscriptionRegister& target = *regs[group[0]];
+  bool rtu = group.size() > 1 && modbusRtuService && target.found &&
+             !target.tcp;
+
+  if (!rtu) {
+    for (size_t index : group) {
+      if (writeToRegister(*regs[index], values[index], results[index])) {
+        successCount++;
+      }
+    }
+    return successCount;
+  }
+
+  std::vector<const char*> registerIds;
+  std::vector<double> rawValues;
+  std::vector<JsonObject> groupResults;
+  for (size_t index : group) {
+    registerIds.push_back(regs[index]->registerId.c_str());
+    rawValues.push_back(values[index]);
+    groupResults.push_back(results[index]);
+  }
+  modbusRtuService->writeRegisterValues(deviceId.c_str(), registerIds.data(),
+                                        rawValues.data(), groupResults.data(),
+                                        group.size());
+
+  // Same result fields as writeToRegister()
+  for (size_t i = 0; i < group.size(); i++) {
+    JsonObject& result = groupResults[i];
+    result["device_id"] = deviceId;
+    result["register_id"] = regs[group[i]]->registerId;
+    if (strcmp(result["status"] | "", "ok") == 0) {
+      result["written_value"] = values[group[i]];
+      successCount++;
+    }
+  }
+  return successCount;
+}
+
 /**
  * Publish write response to configured response topic
  */
@@ -2262,9 +2710,39 @@ void MqttManager::getFullStatus(JsonObject& status) {
   statsObj["last_subscribe_timestamp"] = stats.lastSubscribeTimestamp;
   statsObj["connection_uptime_ms"] = getConnectionUptime();
   statsObj["reconnect_count"] = stats.reconnectCount;
+  // v1.3.3: Outbound queue backpressure (publish task -> network task)
+  statsObj["outbound_queue_depth"] =
+      outboundQueue ? uxQueueMessagesWaiting(outboundQueue) : 0;
+  statsObj["outbound_queue_capacity"] = MqttConfig::OUTBOUND_QUEUE_DEPTH;
+  statsObj["outbound_queue_high_water"] = stats.outboundHighWater;
+  statsObj["outbound_full_count"] = stats.outboundFullCount;
+  statsObj["outbound_drop_count"] = stats.outboundDropCount;
+  // v1.3.3: QoS 1 delivery
+  statsObj["publish_qos"] = publishQos;
+  statsObj["inflight_count"] = inFlightCount;
+  statsObj["inflight_window"] = inFlightWindow;
+  statsObj["inflight_high_water"] = stats.inFlightHighWater;
+  statsObj["publish_arena_peak"] = publishArena.getPeakUsed();
+  statsObj["publish_arena_overflow"] = publishArena.getOverflowCount();
+  statsObj["puback_count"] = stats.pubackCount;
+  statsObj["puback_timeout_count"] = stats.pubackTimeoutCount;
+  // v1.3.3: Backlog catch-up
+  if (persistentQueue) {
+    statsObj["catch_up_active"] = persistentQueue->isCatchingUp();
+    statsObj["broker_rate_bps"] = persistentQueue->getBrokerRate();
+  }
   // v1.3.0: Add gateway uptime for accurate "time ago" calculation
   statsObj["gateway_uptime_ms"] = millis();
 
+  // v1.3.3: Modbus response time percentiles per bus
+  JsonObject latencyObj = status["modbus_latency"].to<JsonObject>();
+  if (modbusRtuService) {
+    modbusRtuService->getBusLatencyStatus(latencyObj, false);
+  }
+  if (modbusTcpService) {
+    modbusTcpService->getBusLatencyStatus(latencyObj, false);
+  }
+
   // Add publish topics list
   JsonArray pubTopics = status["publish_topics"].to<JsonArray>();
   getPublishTopicsList(pubTopics);
@@ -2278,33 +2756,10 @@ void MqttManager::getFullStatus(JsonObject& status) {
 // END OF TOPIC-CENTRIC MQTT SUBSCRIBE CONTROL IMPLEMENTATION
 // ============================================================================
 
-// FIXED BUG #5: Notify MQTT manager when device configuration changes
-// This invalidates the cached buffer size calculation
-// v2.3.8 PHASE 1: Added mutex protection for thread safety
-void MqttManager::notifyConfigChange() {
-  xSemaphoreTake(bufferCacheMutex, portMAX_DELAY);
-  bufferSizeNeedsRecalculation = true;
-  xSemaphoreGive(bufferCacheMutex);
-
-  // CRITICAL FIX: Reset batchTimeout cache to force recalculation with new
-  // device configs
-  xSemaphoreTake(publishStateMutex, portMAX_DELAY);
-  publishState.batchTimeout = 0;
-  xSemaphoreGive(publishStateMutex);
-
-  LOG_MQTT_INFO(
-      "[MQTT] Config change detected - buffer size and batch timeout will be "
-      "recalculated");
-}
-
 MqttManager::~MqttManager() {
   stop();
 
   // v2.3.8 PHASE 1: Delete mutexes for cleanup
-  if (bufferCacheMutex != NULL) {
-    vSemaphoreDelete(bufferCacheMutex);
-    bufferCacheMutex = NULL;
-  }
   if (publishStateMutex != NULL) {
     vSemaphoreDelete(publishStateMutex);
     publishStateMutex = NULL;
@@ -2316,6 +2771,12 @@ MqttManager::~MqttManager() {
     subscriptionsMutex = NULL;
   }
 
+  // v1.3.3: stop() already freed the queued payloads
+  if (outboundQueue != NULL) {
+    vQueueDelete(outboundQueue);
+    outboundQueue = NULL;
+  }
+
   // v2.5.1 FIX: Delete event group for cleanup
   if (taskExitEvent != NULL) {
     vEventGroupDelete(taskExitEvent);
@@ -3,24 +3,33 @@
 
 #include <WiFi.h>
 #include <freertos/event_groups.h>  // v2.5.1 FIX: For safe task termination
+#include <freertos/queue.h>  // v1.3.3: Outbound publish queue
+
+#include <atomic>
 
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
 
 // CRITICAL FIX: Override PubSubClient's default MQTT_MAX_PACKET_SIZE (256
-// bytes) Must be defined BEFORE including PubSubClient.h This allows sending
-// large payloads (2-16 KB) without truncation
+// bytes) Must be defined BEFORE including PubSubClient.h
+// v1.3.3: Data payloads are streamed (beginPublish/write/endPublish) and are
+// not limited by this value; it only bounds the client buffer
+// (subscribe messages, small responses)
 #ifndef MQTT_MAX_PACKET_SIZE
-#define MQTT_MAX_PACKET_SIZE 16384  // 16KB - matches MAX_BUFFER_SIZE
+#define MQTT_MAX_PACKET_SIZE 16384  // 16KB upper bound for CLIENT_BUFFER_SIZE
 #endif
 
 #include <ArduinoJson.h>
 #include <PubSubClient.h>
 
-#include <map>  // For std::map in deduplication logic
-
 #include "ConfigManager.h"
+#include "CyclePayload.h"  // v1.3.3: Cycle payloads shared with HTTP
+#include "ModbusDeviceTypes.h"  // v1.3.3: ModbusDeviceIndex (topic routing)
+#include "ModbusPollPlan.h"  // v1.3.3: Latest-value table (PollPlanRegistry)
 #include "MQTTPersistentQueue.h"  // Persistent queue for failed publishes
+#include "MqttPayloadBuilder.h"  // v1.3.3: Default / compact payload bodies
+#include "MqttPubAckTap.h"  // v1.3.3: PUBACKs for QoS 1 publishing
 #include "NetworkManager.h"
+#include "PayloadFormat.h"  // v1.3.3: json / msgpack / cbor payloads
 #include "QueueManager.h"
 #include "ServerConfig.h"
 
@@ -29,25 +38,40 @@ class ModbusRtuService;
 class ModbusTcpService;
 
 // FIXED BUG #21: Define named constants for magic numbers
-// FIXED BUG #27: Increased BYTES_PER_REGISTER for accurate buffer sizing
 // FIXED BUG #28 + #29: Increased MQTT_TASK_STACK_SIZE for ArduinoJson v7
 // dynamic allocations
 namespace MqttConfig {
 constexpr uint32_t MQTT_TASK_STACK_SIZE =
     24576;  // 24KB stack for ArduinoJson v7 dynamic allocations (50+ registers)
-constexpr uint16_t MIN_BUFFER_SIZE =
-    8192;  // 8KB minimum buffer (supports 60+ registers safely)
-constexpr uint16_t MAX_BUFFER_SIZE =
-    16384;  // 16KB maximum (PubSubClient limit)
-constexpr uint16_t DEFAULT_BUFFER_SIZE = 8192;  // 8KB conservative default
-constexpr uint16_t BYTES_PER_REGISTER =
-    120;  // Realistic bytes per register (includes metadata, descriptions, JSON
-          // overhead)
-constexpr uint16_t BUFFER_OVERHEAD =
-    500;  // JSON structure overhead (increased for safety)
-constexpr uint16_t MAX_REGISTERS_PER_PUBLISH =
-    100;  // Maximum registers to dequeue per MQTT publish cycle (increased from
-          // 50 to support larger configurations)
+// v1.3.3: Streamed publish replaces MIN/MAX/DEFAULT_BUFFER_SIZE,
+// BYTES_PER_REGISTER and BUFFER_OVERHEAD (payload size no longer bounded by
+// the PubSubClient buffer)
+constexpr uint16_t CLIENT_BUFFER_SIZE =
+    4096;  // Incoming subscribe messages + small publishes (write responses)
+constexpr size_t STREAM_CHUNK_SIZE =
+    1024;  // Bytes per socket write while streaming a payload (task stack)
+// v1.3.3: MAX_REGISTERS_PER_PUBLISH (100) removed - every register updated
+// since the last publish is taken from the latest-value table
+
+// v1.3.3: Publish pipeline (publish task -> outbound queue -> network task)
+constexpr uint32_t PUBLISH_TASK_STACK_SIZE =
+    16384;  // Builds the payload documents (PSRAM) and encodes them
+constexpr uint32_t PUBLISH_TASK_PERIOD_MS = 30;  // Interval check period
+constexpr uint8_t OUTBOUND_QUEUE_DEPTH = 8;      // Encoded payloads in flight
+constexpr uint32_t OUTBOUND_ENQUEUE_WAIT_MS =
+    200;  // Publish task wait on a full queue, then persistent queue
+constexpr uint32_t OUTBOUND_DRAIN_BUDGET_MS =
+    100;  // Publishing per network loop pass before loop() runs again
+constexpr uint8_t OUTBOUND_MAX_ATTEMPTS =
+    2;  // A failed payload is retried once after reconnect
+constexpr size_t PUBLISH_ARENA_SIZE =
+    65536;  // Payload documents of one publish cycle (PSRAM, reset per cycle)
+
+// v1.3.3: QoS 1 publishing (mqtt_config.publish_qos / inflight_window)
+constexpr uint8_t DEFAULT_INFLIGHT_WINDOW = 8;  // PUBLISH awaiting PUBACK
+constexpr uint8_t MAX_INFLIGHT_WINDOW = 16;     // Upper bound of the setting
+constexpr uint32_t PUBACK_TIMEOUT_MS =
+    20000;  // No PUBACK: resend with DUP (counts as an attempt)
 }  // namespace MqttConfig
 
 class MqttManager {
@@ -65,6 +89,52 @@ class MqttManager {
   // v2.5.1 FIX: Event group for safe task termination (race condition fix)
   EventGroupHandle_t taskExitEvent;
   static constexpr uint32_t TASK_EXITED_BIT = BIT0;
+  static constexpr uint32_t PUBLISH_TASK_EXITED_BIT = BIT1;  // v1.3.3
+
+  // v1.3.3: Asynchronous publish pipeline
+  // Previous: mqttLoop() ran loop(), reconnects, payload building and every
+  // publish in one task, so a slow publish on a congested link delayed
+  // keep-alives and incoming write commands.
+  // New: the publish task builds and encodes payloads into outboundQueue;
+  // the network task (mqttLoop) owns the PubSubClient, drains the queue in
+  // bounded slices and runs loop() between them. A full queue makes the
+  // publish task wait, then hand the payload to the persistent queue.
+  struct OutboundMessage {
+    char* topic;       // Same PSRAM block as this header
+    uint8_t* payload;  // Encoded in format
+    size_t length;
+    PayloadFormat format;
+    bool retain;
+    bool schema;  // Compact layout schema (clears schemaPublished on loss)
+    uint8_t attempts;
+  };
+  TaskHandle_t publishTaskHandle;
+  QueueHandle_t outboundQueue;    // OutboundMessage*
+  OutboundMessage* outboundHead;  // Taken by the network task, not yet sent
+  std::atomic<bool> brokerConnected;         // Network task -> publish task
+  std::atomic<bool> persistentRetryPending;  // Publish task -> network task
+  // Payload/schema documents of the current publish cycle (publish task)
+  ArduinoJson::ArenaAllocator publishArena;
+
+  // v1.3.3: QoS 1 publishing
+  // PubSubClient publishes at QoS 0 only, so a payload counted as sent could
+  // still be lost with the TCP connection. With publish_qos = 1 the network
+  // task writes QoS 1 PUBLISH packets itself and keeps up to inFlightWindow
+  // of them outstanding; ackTap matches the broker's PUBACKs by packet ID.
+  // Live payloads are freed and persistent queue messages acknowledged only
+  // on their PUBACK. Touched by the network task only.
+  struct InFlightPublish {
+    uint16_t packetId;
+    unsigned long sentAt;
+    OutboundMessage* message;  // Live payload (owned until the PUBACK)
+    uint16_t queuedId;         // Persistent queue message (message null)
+  };
+  MqttPubAckTap ackTap;  // Between PubSubClient and the network client
+  uint8_t publishQos;
+  uint8_t inFlightWindow;
+  InFlightPublish inFlight[MqttConfig::MAX_INFLIGHT_WINDOW];
+  uint8_t inFlightCount;
+  uint16_t nextPacketId;
 
   String brokerAddress;
   int brokerPort;
@@ -74,15 +144,17 @@ class MqttManager {
   String topicPublish;
   unsigned long lastReconnectAttempt;
 
-  // FIXED BUG #5 & #7: Cache buffer size calculation
-  uint16_t cachedBufferSize;
-  bool bufferSizeNeedsRecalculation;
-
-  // v2.3.8 PHASE 1: Thread safety - Mutex for buffer cache
-  SemaphoreHandle_t bufferCacheMutex;
+  // v1.3.3: Task profiler sample (mqtt_config.diagnostics_topic, empty = off)
+  String diagnosticsTopic;
+  uint32_t diagnosticsIntervalMs;
+  unsigned long lastDiagnosticsPublish;
 
   // MQTT Publish Mode ("default" or "customize")
   String publishMode;
+  PayloadFormat payloadFormat;  // v1.3.3: mqtt_config.payload_format
+  // v1.3.3: mqtt_config.aggregation = "window": publish min/max/avg/count of
+  // every read since the previous publish instead of the last value only
+  bool windowAggregation;
 
   // Default mode fields
   bool defaultModeEnabled;
@@ -92,6 +164,16 @@ class MqttManager {
   String defaultIntervalUnit;  // "ms", "s", or "m"
   unsigned long lastDefaultPublish;
 
+  // v1.3.3: Compact default-mode layout (default_mode.payload_layout =
+  // "compact"): retained schema on <topic>/schema, then value arrays only
+  bool compactLayout;
+  String schemaTopic;
+  uint32_t schemaLayoutVersion;  // Registry layout the schema describes
+  uint32_t schemaId;             // CRC32 of the schema devices array
+  std::atomic<bool> schemaPublished;  // Cleared on (re)connect, config load
+  std::vector<PollPlanRegistry::LayoutEntry> schemaLayout;  // Per slot
+  std::vector<uint16_t> schemaRegisterCounts;  // Per schema device
+
   // Customize mode fields
   bool customizeModeEnabled;
   struct CustomTopic {
@@ -100,6 +182,10 @@ class MqttManager {
     uint32_t interval;
     String intervalUnit;  // "ms", "s", or "m"
     unsigned long lastPublish;
+    // v1.3.3: registers resolved to registry indices (re-resolved when the
+    // registry layout changes); each topic consumes its own updates
+    PollPlanRegistry::RegisterRefList refs;
+    uint32_t refsLayout = 0;
   };
   std::vector<CustomTopic> customTopics;
 
@@ -114,9 +200,7 @@ class MqttManager {
     unsigned long targetTime;          // Replaces static publishTargetTime
     bool timeLocked;                   // Replaces static targetTimeLocked
     unsigned long lastLoggedInterval;  // Replaces static lastLoggedInterval
-    unsigned long batchWaitStart;      // Replaces static batchWaitStartTime
-    uint32_t batchTimeout;             // Replaces static cachedBatchTimeout
-    bool flushedOnce;                  // Replaces static flushedOnce
+    uint32_t cycleId;  // v1.3.3: Aligned snapshot cycle (0 = none)
   };
   PublishState publishState;
   SemaphoreHandle_t publishStateMutex;  // Mutex for publishState
@@ -135,6 +219,15 @@ class MqttManager {
     unsigned long lastSubscribeTimestamp;
     unsigned long connectionStartTime;
     uint32_t reconnectCount;
+    // v1.3.3: Outbound queue backpressure
+    uint32_t outboundHighWater;  // Most payloads queued at once
+    uint32_t outboundFullCount;  // Payloads sent to the persistent queue
+                                 // because the outbound queue stayed full
+    uint32_t outboundDropCount;  // Failed payloads that could not be kept
+    // v1.3.3: QoS 1 delivery
+    uint32_t pubackCount;         // Publishes acknowledged by the broker
+    uint32_t pubackTimeoutCount;  // Publishes resent for a missing PUBACK
+    uint32_t inFlightHighWater;   // Most publishes awaiting PUBACK at once
   };
   MqttStatistics stats;
 
@@ -148,6 +241,10 @@ class MqttManager {
   struct SubscriptionRegister {
     String deviceId;
     String registerId;
+    // v1.3.3: Write target resolved per devices generation (no device JSON
+    // copy per write)
+    bool found = false;
+    bool tcp = false;
   };
 
   struct MqttSubscription {
@@ -159,39 +256,64 @@ class MqttManager {
 
   std::vector<MqttSubscription> subscriptions;
   SemaphoreHandle_t subscriptionsMutex;  // Thread safety for subscription operations
+  // v1.3.3: Topic hash -> subscriptions slot (rebuilt with the vector)
+  ModbusDeviceIndex subscriptionIndex;
+  uint32_t writeTargetsGeneration;  // Devices generation of found/tcp
 
   MqttManager(ConfigManager* config, ServerConfig* serverCfg,
               NetworkMgr* netMgr);
 
   static void mqttTask(void* parameter);
   void mqttLoop();
+  // v1.3.3: Publish pipeline
+  static void publishTask(void* parameter);
+  void publishLoop();
+  bool enqueueOutbound(const String& topic, JsonDocument& doc,
+                       size_t payloadSize, bool retain, bool schema,
+                       const CyclePayload* encoded = nullptr);
+  void drainOutbound();
+  bool publishRaw(const char* topic, const uint8_t* payload, size_t length,
+                  bool retain, uint16_t packetId = 0, bool dup = false);
+  // v1.3.3: QoS 1 publishing (packetId 0 = QoS 0)
+  bool beginPublishPacket(const char* topic, size_t length, bool retain,
+                          uint16_t packetId, bool dup);
+  bool inFlightFull() const;
+  uint16_t allocatePacketId();
+  void trackInFlight(uint16_t packetId, OutboundMessage* message,
+                     uint16_t queuedId);
+  void removeInFlight(uint8_t index);
+  void processAcks();
+  void checkInFlight(bool sessionLost);
+  void persistOutbound(const OutboundMessage& msg);
+  void releaseOutbound();
   bool connectToMqtt();
   void loadMqttConfig();
   void publishQueueData();
-  void publishDefaultMode(std::map<String, JsonDocument>& uniqueRegisters,
-                          unsigned long now);
-  void publishCustomizeMode(std::map<String, JsonDocument>& uniqueRegisters,
-                            unsigned long now);
+  void publishDefaultMode(unsigned long now);
+  void publishCustomizeMode(unsigned long now);
   void debugNetworkConnectivity();
   bool isNetworkAvailable();
 
-  // FIXED BUG #15: Dynamic MQTT buffer sizing
-  uint16_t calculateOptimalBufferSize();
-
-  // v2.3.7: Adaptive batch timeout based on device configuration
-  uint32_t calculateAdaptiveBatchTimeout();
-
   // v2.3.8 PHASE 1: Helper methods to eliminate code duplication (DRY
   // principle)
   void buildTimestamp(JsonDocument& doc, unsigned long now);
-  int validateAndGroupRegisters(
-      std::map<String, JsonDocument>& uniqueRegisters,
-      JsonObject& devicesObject, std::map<String, JsonObject>& deviceObjects,
-      const std::vector<String>* filterRegisters = nullptr);
-  bool serializeAndValidatePayload(JsonDocument& doc, String& payload,
-                                   uint32_t estimatedSize);
-  bool publishPayload(const String& topic, const String& payload,
-                      const char* modeLabel);
+  // v1.3.3: devices.{device_id}.{name} grouping (MqttPayloadBuilder)
+  using DeviceGrouping = MqttPayloadBuilder::DeviceGrouping;
+  // v1.3.3: Compact layout (schema + value arrays)
+  bool publishSchema();
+  void publishDiagnostics();  // v1.3.3: mqtt_config.diagnostics_topic
+  void buildCompactPayload(JsonDocument& doc, int& registerCount,
+                           int& deviceCount);
+  // v1.3.3: Encodes doc for the network task (replaces
+  // serializeAndValidatePayload + publishPayload); encoded = doc already
+  // encoded in payloadFormat (shared cycle payload, CyclePayload)
+  bool publishDocument(const String& topic, JsonDocument& doc,
+                       const char* modeLabel, size_t& payloadSize,
+                       bool schema = false,
+                       const CyclePayload* encoded = nullptr);
+  // v1.3.3: beginPublish + encoded doc (payloadFormat) + endPublish
+  bool streamPayload(const char* topic, JsonVariantConst doc,
+                     size_t payloadSize, bool retain, uint16_t packetId = 0);
   void calculateDisplayInterval(uint32_t intervalMs, const String& unit,
                                 uint32_t& displayInterval,
                                 const char*& displayUnit);
@@ -200,20 +322,22 @@ class MqttManager {
   void loadBrokerConfig(JsonObject& mqttConfig);
   void loadDefaultModeConfig(JsonObject& mqttConfig);
   void loadCustomizeModeConfig(JsonObject& mqttConfig);
-  void analyzeDeviceConfigurations(JsonArray& devices, uint32_t& maxRefreshRate,
-                                   uint32_t& totalRegisters, bool& hasSlowRTU);
-  uint32_t determineTimeoutStrategy(uint32_t totalRegisters,
-                                    uint32_t maxRefreshRate, bool hasSlowRTU);
 
   // v1.2.0: Topic-centric MQTT Subscribe Control - Private methods
   static void onMqttMessage(char* topic, byte* payload, unsigned int length);
   void loadCustomSubscribeConfig(JsonObject& mqttConfig);
   void initializeSubscriptions();
-  MqttSubscription* findSubscriptionByTopic(const String& topic);
-  void handleWriteCommand(const String& topic, const String& payload);
+  MqttSubscription* findSubscriptionByTopic(const char* topic);
+  void refreshWriteTargets();
+  void handleWriteCommand(const char* topic, const uint8_t* payload,
+                          unsigned int length);
   void publishWriteResponse(MqttSubscription& sub, JsonDocument& response);
   void publishErrorResponse(MqttSubscription& sub, const String& errorMsg, int errorCode);
   bool writeToRegister(SubscriptionRegister& reg, float value, JsonObject& result);
+  int writeDeviceRegisters(const std::vector<size_t>& group,
+                           const std::vector<SubscriptionRegister*>& regs,
+                           const std::vector<float>& values,
+                           std::vector<JsonObject>& results);
   bool parsePayloadValue(const String& payload, float& value);
   bool parseMultiRegisterPayload(const String& payload, JsonDocument& values);
 
@@ -228,9 +352,6 @@ class MqttManager {
   void disconnect();  // Graceful disconnect from MQTT broker
   void getStatus(JsonObject& status);
 
-  // FIXED BUG #5: Config change notification to invalidate buffer size cache
-  void notifyConfigChange();
-
   // Persistent queue methods
   void setPersistentQueueEnabled(bool enable);
   bool isPersistentQueueEnabled() const;
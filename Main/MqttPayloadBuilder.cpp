@@ -0,0 +1,144 @@
+#include "MqttPayloadBuilder.h"
+
+#include <stdio.h>
+
+#include "NumberFormat.h"  // v1.3.3: Fixed-decimal values
+
+/**
+ * Entries come from PollPlanRegistry::drainLatest() (device by device,
+ * deleted devices already skipped), so no std::map<String, ...> lookups and
+ * no per-publish readDevice() validation are needed.
+ */
+bool MqttPayloadBuilder::beginRegister(DeviceGrouping& grouping,
+                                       const CompiledDevicePlan& plan,
+                                       const CompiledRegister& reg) {
+  if (reg.name == nullptr || reg.name[0] == '\0') {
+    return false;  // Silent skip - empty register name
+  }
+
+  // Create device object with device_id as key on first register of device
+  if (grouping.plan != &plan) {
+    grouping.plan = &plan;
+    grouping.device = grouping.devices[plan.deviceId].to<JsonObject>();
+
+    // Add device_name at device level
+    if (plan.deviceName[0] != '\0') {
+      grouping.device["device_name"] = plan.deviceName;
+    }
+    grouping.deviceCount++;
+  }
+  return true;
+}
+
+void MqttPayloadBuilder::addLatestRegister(DeviceGrouping& grouping,
+                                           const CompiledDevicePlan& plan,
+                                           const CompiledRegister& reg,
+                                           double value) {
+  if (!beginRegister(grouping, plan, reg)) {
+    return;
+  }
+
+  // Add register as nested object: devices.{device_id}.{register_name} =
+  // {value, unit}
+  JsonObject registerObj = grouping.device[reg.name].to<JsonObject>();
+  NumberFormat::setValue(registerObj["value"], value,
+                         ModbusPollPlan::decimalsOf(plan, reg),
+                         grouping.fixedText);
+  registerObj["unit"] = (const char*)reg.unit;  // Copied (not a literal)
+
+  grouping.registerCount++;
+}
+
+void MqttPayloadBuilder::addAggregateRegister(DeviceGrouping& grouping,
+                                              const CompiledDevicePlan& plan,
+                                              const CompiledRegister& reg,
+                                              const WindowStats& stats) {
+  if (!beginRegister(grouping, plan, reg)) {
+    return;
+  }
+
+  // "value" keeps its last-value meaning for existing consumers
+  // (v1.3.3: readings as fixed-decimal text; the mean is not rounded)
+  JsonObject registerObj = grouping.device[reg.name].to<JsonObject>();
+  int8_t decimals = ModbusPollPlan::decimalsOf(plan, reg);
+  NumberFormat::setValue(registerObj["value"], stats.last, decimals,
+                         grouping.fixedText);
+  NumberFormat::setValue(registerObj["min"], stats.min, decimals,
+                         grouping.fixedText);
+  NumberFormat::setValue(registerObj["max"], stats.max, decimals,
+                         grouping.fixedText);
+  registerObj["avg"] = stats.mean;
+  registerObj["count"] = stats.count;
+  registerObj["unit"] = (const char*)reg.unit;  // Copied (not a literal)
+
+  grouping.registerCount++;
+}
+
+bool MqttPayloadBuilder::buildCompactValues(
+    JsonDocument& doc, uint32_t schemaId,
+    const PollPlanRegistry::LayoutEntry* layout,
+    const std::vector<uint16_t>& registerCounts, int& registerCount,
+    int& deviceCount, bool aggregated, bool fixedText) {
+  char idText[9];
+  snprintf(idText, sizeof(idText), "%08lx", (unsigned long)schemaId);
+  doc["schema_id"] = idText;
+
+  JsonArray values = doc["values"].to<JsonArray>();
+  for (size_t i = 0; i < registerCounts.size(); i++) {
+    values.add(nullptr);
+  }
+
+  bool stale = false;
+  // Array slot of one entry (null = layout changed after the schema)
+  auto slotOf = [&](const CompiledDevicePlan& plan,
+                    const CompiledRegister& reg) -> JsonVariant {
+    if (plan.registrySlot >= PollPlanRegistry::MAX_SLOTS) return JsonVariant();
+    const PollPlanRegistry::LayoutEntry& entry = layout[plan.registrySlot];
+    if (entry.position < 0 || entry.generation != plan.registryGeneration) {
+      stale = true;  // Layout changed after the schema was built
+      return JsonVariant();
+    }
+
+    JsonVariant device = values[entry.position];
+    if (device.isNull()) {
+      JsonArray registers = device.to<JsonArray>();
+      for (uint16_t r = 0; r < registerCounts[entry.position]; r++) {
+        registers.add(nullptr);
+      }
+      deviceCount++;
+    }
+    registerCount++;
+    return device[(size_t)(&reg - plan.registers.data())];
+  };
+
+  if (aggregated) {
+    PollPlanRegistry::getInstance()->drainAggregates(
+        [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+            const WindowStats& stats) {
+          JsonVariant slot = slotOf(plan, reg);
+          if (slot.isUnbound()) return;
+          JsonArray entry = slot.to<JsonArray>();
+          int8_t decimals = ModbusPollPlan::decimalsOf(plan, reg);
+          NumberFormat::setValue(entry.add<JsonVariant>(), stats.last,
+                                 decimals, fixedText);
+          NumberFormat::setValue(entry.add<JsonVariant>(), stats.min,
+                                 decimals, fixedText);
+          NumberFormat::setValue(entry.add<JsonVariant>(), stats.max,
+                                 decimals, fixedText);
+          entry.add(stats.mean);
+          entry.add(stats.count);
+        });
+  } else {
+    PollPlanRegistry::getInstance()->drainLatest(
+        [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+            double value, uint32_t timestamp) {
+          JsonVariant slot = slotOf(plan, reg);
+          if (slot.isUnbound()) return;
+          NumberFormat::setValue(slot, value,
+                                 ModbusPollPlan::decimalsOf(plan, reg),
+                                 fixedText);
+        });
+  }
+
+  return !stale;
+}
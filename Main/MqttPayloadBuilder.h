@@ -0,0 +1,88 @@
+#ifndef MQTT_PAYLOAD_BUILDER_H
+#define MQTT_PAYLOAD_BUILDER_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <ArduinoJson.h>
+
+#include <vector>
+
+#include "ModbusPollPlan.h"  // CompiledDevicePlan, PollPlanRegistry::LayoutEntry
+
+/**
+ * MqttPayloadBuilder - Publish payload bodies from latest-value entries
+ *
+ * v1.3.3: Split out of MqttManager
+ * The grouping and compact value builders only depend on the compiled poll
+ * plan and ArduinoJson, so they live here without the MQTT client, network
+ * and config dependencies. MqttManager calls them from its drainLatest()
+ * visitors; Testing/HostBench links them into the host micro-benchmarks.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class MqttPayloadBuilder {
+ public:
+  // Groups latest-value entries as devices.{device_id}.{name}
+  // (replaces validateAndGroupRegisters() and its std::map<String, ...>)
+  struct DeviceGrouping {
+    JsonObject devices;
+    const CompiledDevicePlan* plan = nullptr;  // Device of current object
+    JsonObject device;
+    int registerCount = 0;
+    int deviceCount = 0;
+    // v1.3.3: Values as fixed-decimal text (JSON payload, see NumberFormat)
+    bool fixedText = false;
+  };
+
+  /**
+   * Add one latest-value entry to grouping (default and customize mode)
+   * Entries must arrive device by device (PollPlanRegistry::drainLatest()).
+   * @param grouping Output devices object + current device object
+   * @param plan Compiled plan of the register's device
+   * @param reg Compiled register
+   * @param value Calibrated value
+   */
+  static void addLatestRegister(DeviceGrouping& grouping,
+                                const CompiledDevicePlan& plan,
+                                const CompiledRegister& reg, double value);
+
+  /**
+   * v1.3.3: Add one closed-window entry (mqtt_config.aggregation = "window")
+   * as {value (last read), min, max, avg, count, unit}. Same ordering rule
+   * as addLatestRegister() (PollPlanRegistry::drainAggregates()).
+   */
+  static void addAggregateRegister(DeviceGrouping& grouping,
+                                   const CompiledDevicePlan& plan,
+                                   const CompiledRegister& reg,
+                                   const WindowStats& stats);
+
+  /**
+   * Fill doc with schema_id and values[] (compact layout) from the
+   * latest-value table. One array per schema device in register order;
+   * null = not updated since the last publish, or a whole device without
+   * updates. With aggregated, values come from the closed publish window
+   * as [last, min, max, avg, count] per register. fixedText: see
+   * DeviceGrouping.
+   * @param layout Schema position per registry slot (MAX_SLOTS entries)
+   * @param registerCounts Registers per schema device
+   * @param registerCount Output: values written
+   * @param deviceCount Output: devices with at least one value
+   * @return false if an entry did not match the schema (layout changed
+   *         after the schema was built; the entry is skipped)
+   */
+  static bool buildCompactValues(
+      JsonDocument& doc, uint32_t schemaId,
+      const PollPlanRegistry::LayoutEntry* layout,
+      const std::vector<uint16_t>& registerCounts, int& registerCount,
+      int& deviceCount, bool aggregated = false, bool fixedText = false);
+
+ private:
+  // Start the device object of plan if it is not the current one
+  // @return false if the register has no name (skipped)
+  static bool beginRegister(DeviceGrouping& grouping,
+                            const CompiledDevicePlan& plan,
+                            const CompiledRegister& reg);
+};
+
+#endif  // MQTT_PAYLOAD_BUILDER_H
@@ -0,0 +1,122 @@
+#include "MqttPubAckTap.h"
+
+MqttPubAckTap::MqttPubAckTap() : client(nullptr) { reset(); }
+
+void MqttPubAckTap::reset() {
+  phase = Phase::HEADER;
+  packetType = 0;
+  remaining = 0;
+  lengthShift = 0;
+  bodyPos = 0;
+  packetId = 0;
+  ringHead = 0;
+  ringCount = 0;
+}
+
+bool MqttPubAckTap::popAck(uint16_t& packetId) {
+  if (ringCount == 0) {
+    return false;
+  }
+  packetId = ring[ringHead];
+  ringHead = (ringHead + 1) % ACK_RING_SIZE;
+  ringCount--;
+  return true;
+}
+
+void MqttPubAckTap::feed(uint8_t byte) {
+  switch (phase) {
+    case Phase::HEADER:
+      packetType = byte >> 4;
+      remaining = 0;
+      lengthShift = 0;
+      phase = Phase::LENGTH;
+      break;
+
+    case Phase::LENGTH:
+      remaining |= (uint32_t)(byte & 0x7F) << lengthShift;
+      lengthShift += 7;
+      if (!(byte & 0x80) || lengthShift > 21) {
+        bodyPos = 0;
+        packetId = 0;
+        phase = (remaining > 0) ? Phase::BODY : Phase::HEADER;
+      }
+      break;
+
+    case Phase::BODY:
+      if (packetType == PUBACK_TYPE && bodyPos < 2) {
+        packetId = (packetId << 8) | byte;
+      }
+      bodyPos++;
+      if (--remaining == 0) {
+        if (packetType == PUBACK_TYPE && bodyPos == 2) {
+          // Full ring: the oldest ack is overwritten (its publish times out
+          // and is sent again)
+          uint8_t slot = (ringHead + ringCount) % ACK_RING_SIZE;
+          ring[slot] = packetId;
+          if (ringCount < ACK_RING_SIZE) {
+            ringCount++;
+          } else {
+            ringHead = (ringHead + 1) % ACK_RING_SIZE;
+          }
+        }
+        phase = Phase::HEADER;
+      }
+      break;
+  }
+}
+
+int MqttPubAckTap::connect(IPAddress ip, uint16_t port) {
+  reset();
+  return client ? client->connect(ip, port) : 0;
+}
+
+int MqttPubAckTap::connect(const char* host, uint16_t port) {
+  reset();
+  return client ? client->connect(host, port) : 0;
+}
+
+size_t MqttPubAckTap::write(uint8_t byte) {
+  return client ? client->write(byte) : 0;
+}
+
+size_t MqttPubAckTap::write(const uint8_t* buffer, size_t size) {
+  return client ? client->write(buffer, size) : 0;
+}
+
+int MqttPubAckTap::available() { return client ? client->available() : 0; }
+
+int MqttPubAckTap::read() {
+  int byte = client ? client->read() : -1;
+  if (byte >= 0) {
+    feed((uint8_t)byte);
+  }
+  return byte;
+}
+
+int MqttPubAckTap::read(uint8_t* buffer, size_t size) {
+  int count = client ? client->read(buffer, size) : -1;
+  for (int i = 0; i < count; i++) {
+    feed(buffer[i]);
+  }
+  return count;
+}
+
+int MqttPubAckTap::peek() { return client ? client->peek() : -1; }
+
+void MqttPubAckTap::flush() {
+  if (client) {
+    client->flush();
+  }
+}
+
+void MqttPubAckTap::stop() {
+  if (client) {
+    client->stop();
+  }
+}
+
+uint8_t MqttPubAckTap::connected() {
+  return client ? client->connected() : 0;
+}
+
+MqttPubAckTap::operator bool() { return client && (bool)*client; }
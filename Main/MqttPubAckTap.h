@@ -0,0 +1,80 @@
+#ifndef MQTT_PUBACK_TAP_H
+#define MQTT_PUBACK_TAP_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+/**
+ * MqttPubAckTap - Pass-through Client that picks PUBACKs out of the stream
+ *
+ * v1.3.3: QoS 1 publishing
+ * PubSubClient only publishes at QoS 0 and drops any PUBACK it reads in
+ * loop(). MqttManager sends QoS 1 PUBLISH packets itself and binds
+ * PubSubClient to this Client (setClient), which forwards every call to the
+ * real network client and follows the MQTT framing of the bytes PubSubClient
+ * reads. The packet ID of each PUBACK is stored for popAck(); the bytes are
+ * passed on unchanged, so PubSubClient sees the same stream as before.
+ *
+ * Not thread-safe: used by the MQTT network task only (the task that owns
+ * the PubSubClient).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class MqttPubAckTap : public Client {
+ public:
+  // PUBACKs kept between popAck() calls (above the largest in-flight window)
+  static constexpr uint8_t ACK_RING_SIZE = 32;
+
+  MqttPubAckTap();
+
+  void setClient(Client* client) { this->client = client; }
+
+  /**
+   * Next PUBACK packet ID read by PubSubClient
+   * @return false if none is pending
+   */
+  bool popAck(uint16_t& packetId);
+
+  void reset();  // New connection: drop parser state and pending acks
+
+  // Client interface (forwarded to the network client)
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t byte) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override;
+
+ private:
+  enum class Phase : uint8_t {
+    HEADER,  // Fixed header byte (packet type)
+    LENGTH,  // Remaining length (varint)
+    BODY     // Packet body
+  };
+
+  static constexpr uint8_t PUBACK_TYPE = 4;
+
+  Client* client;
+
+  Phase phase;
+  uint8_t packetType;
+  uint32_t remaining;  // Body bytes left in the current packet
+  uint8_t lengthShift;
+  uint8_t bodyPos;
+  uint16_t packetId;
+
+  uint16_t ring[ACK_RING_SIZE];
+  uint8_t ringHead;
+  uint8_t ringCount;
+
+  void feed(uint8_t byte);
+};
+
+#endif  // MQTT_PUBACK_TAP_H
@@ -4,6 +4,7 @@
 
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
 #include "ServerConfig.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 NetworkMgr* NetworkMgr::instance = nullptr;
 
@@ -21,7 +22,9 @@ NetworkMgr::NetworkMgr()
       activeMode(""),
       networkAvailable(false),
       failoverTaskHandle(nullptr),
-      modeMutex(nullptr) {
+      modeMutex(nullptr),
+      modeGeneration(0),
+      primaryUpSince(0) {
   // FIXED Bug #6: Initialize mutex for thread-safe activeMode access
   modeMutex = xSemaphoreCreateMutex();
   if (!modeMutex) {
@@ -135,6 +138,15 @@ bool NetworkMgr::init(ServerConfig* serverConfig) {
     activeMode = "NONE";
   }
 
+  // v1.3.3: The active interface holds a reference on top of the standing
+  // one from init(), so switching away drops only that one and the
+  // interface stays up as warm standby (was shut down at refs 0)
+  if (activeMode == "WIFI") {
+    wifiManager->addReference();
+  } else if (activeMode == "ETH") {
+    ethernetManager->addReference();
+  }
+
   if (activeMode != "NONE") {
     networkAvailable = true;
     LOG_NET_INFO("[NetworkMgr] Initial active network: %s. IP: %s\n",
@@ -183,15 +195,16 @@ void NetworkMgr::startFailoverTask() {
   if (failoverTaskHandle == nullptr) {
     // OPTIMIZATION: Moved to Core 0 to balance load (network monitoring
     // background task)
-    xTaskCreatePinnedToCore(failoverTask, "NET_FAILOVER_TASK",
-                            4096,  // Stack size
-                            this,
-                            1,  // Priority
-                            &failoverTaskHandle,
-                            0  // Core 0 (moved from Core 1 for load balancing)
-    );
+    // v1.3.3: Priority and core from TaskAffinity.h
+    TaskAffinity::create(failoverTask, "NET_FAILOVER_TASK",
+                         4096,  // Stack size
+                         this, TaskAffinity::Task::NET_FAILOVER,
+                         &failoverTaskHandle);
     LOG_NET_INFO("[NETWORK] Failover task started");
   }
+  if (wifiManager) {
+    wifiManager->setLinkEventTask(failoverTaskHandle);  // v1.3.3
+  }
 }
 
 void NetworkMgr::failoverTask(void* parameter) {
@@ -203,6 +216,7 @@ void NetworkMgr::failoverLoop() {
   unsigned long lastCheck = 0;
   unsigned long lastSignalCheck = 0;
   unsigned long lastReconnectCheck = 0;  // v2.5.33: Track reconnect attempts
+  bool linkEvent = false;
 
   while (true) {
     unsigned long now = millis();
@@ -226,71 +240,18 @@ void NetworkMgr::failoverLoop() {
       }
     }
 
+    // v1.3.3: W5500 link bit (no interrupt); WiFi events arrive as task
+    // notifications
+    if (ethernetManager && ethernetManager->pollLinkChange()) {
+      linkEvent = true;
+    }
+
     // Use configurable check interval instead of hardcoded 5000
-    if (now - lastCheck >= failoverCheckInterval) {
+    // v1.3.3: Link events and a pending failback are handled at once
+    if (linkEvent || primaryUpSince != 0 ||
+        now - lastCheck >= failoverCheckInterval) {
       lastCheck = now;
-
-      bool primaryAvailable = false;
-      bool secondaryAvailable = false;
-      int8_t primaryRSSI = 0;
-      int8_t secondaryRSSI = 0;
-
-      // Check primary mode availability
-      if (primaryMode == "ETH" && ethernetManager) {
-        primaryAvailable = ethernetManager->isAvailable();
-      } else if (primaryMode == "WIFI" && wifiManager) {
-        primaryAvailable = wifiManager->isAvailable();
-        if (primaryAvailable) {
-          primaryRSSI = (int8_t)getWiFiRSSI();  // Get RSSI for WiFi
-        }
-      }
-
-      // Check secondary mode availability
-      if (primaryMode == "ETH" && wifiManager) {
-        secondaryAvailable = wifiManager->isAvailable();
-        if (secondaryAvailable) {
-          secondaryRSSI = (int8_t)getWiFiRSSI();
-        }
-      } else if (primaryMode == "WIFI" && ethernetManager) {
-        secondaryAvailable = ethernetManager->isAvailable();
-      }
-
-      // Network failover switching logic
-      if (activeMode == "NONE") {
-        if (primaryAvailable) {
-          switchMode(primaryMode);
-        } else if (secondaryAvailable) {
-          String secondaryMode = (primaryMode == "ETH") ? "WIFI" : "ETH";
-          switchMode(secondaryMode);
-        }
-      } else if (activeMode == primaryMode) {
-        if (!primaryAvailable) {
-          Serial.printf(
-              "Primary network (%s) lost. Attempting to switch to secondary.\n",
-              primaryMode.c_str());
-          String secondaryMode = (primaryMode == "ETH") ? "WIFI" : "ETH";
-
-          if (secondaryAvailable) {
-            switchMode(secondaryMode);
-          } else {
-            switchMode("NONE");  // Both down
-          }
-        }
-      } else {  // activeMode is secondary
-        if (!secondaryAvailable) {
-          Serial.printf(
-              "Secondary network (%s) lost. Attempting to switch to primary.\n",
-              activeMode.c_str());
-          if (primaryAvailable) {
-            switchMode(primaryMode);
-          }
-        } else if (primaryAvailable) {
-          // Primary is back, switch back to primary
-          Serial.printf("Primary network (%s) restored. Switching back.\n",
-                        primaryMode.c_str());
-          switchMode(primaryMode);
-        }
-      }
+      checkFailover(now);
 
       // Update WiFi signal strength monitoring
       if (now - lastSignalCheck >= signalStrengthCheckInterval) {
@@ -298,7 +259,78 @@ void NetworkMgr::failoverLoop() {
         updateWiFiSignalStrength();
       }
     }
-    vTaskDelay(pdMS_TO_TICKS(100));  // Small delay to yield
+
+    // v1.3.3: Woken early by WiFi link events (WiFiManager)
+    linkEvent = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LINK_POLL_MS)) > 0;
+  }
+}
+
+void NetworkMgr::checkFailover(unsigned long now) {
+  bool primaryAvailable = false;
+  bool secondaryAvailable = false;
+
+  // Check primary mode availability
+  if (primaryMode == "ETH" && ethernetManager) {
+    primaryAvailable = ethernetManager->isAvailable();
+  } else if (primaryMode == "WIFI" && wifiManager) {
+    primaryAvailable = wifiManager->isAvailable();
+  }
+
+  // Check secondary mode availability
+  if (primaryMode == "ETH" && wifiManager) {
+    secondaryAvailable = wifiManager->isAvailable();
+  } else if (primaryMode == "WIFI" && ethernetManager) {
+    secondaryAvailable = ethernetManager->isAvailable();
+  }
+  String secondaryMode = (primaryMode == "ETH") ? "WIFI" : "ETH";
+
+  if (!primaryAvailable) {
+    primaryUpSince = 0;
+  }
+
+  // Network failover switching logic
+  if (activeMode == "NONE") {
+    if (primaryAvailable) {
+      switchMode(primaryMode);
+    } else if (secondaryAvailable) {
+      switchMode(secondaryMode);
+    }
+  } else if (activeMode == primaryMode) {
+    if (!primaryAvailable) {
+      Serial.printf(
+          "Primary network (%s) lost. Attempting to switch to secondary.\n",
+          primaryMode.c_str());
+
+      if (secondaryAvailable) {
+        switchMode(secondaryMode);
+      } else {
+        switchMode("NONE");  // Both down
+      }
+    }
+  } else {  // activeMode is secondary
+    if (!secondaryAvailable) {
+      Serial.printf(
+          "Secondary network (%s) lost. Attempting to switch to primary.\n",
+          activeMode.c_str());
+      if (primaryAvailable) {
+        primaryUpSince = 0;
+        switchMode(primaryMode);
+      } else {
+        switchMode("NONE");  // v1.3.3: Was left on the dead interface
+      }
+    } else if (primaryAvailable) {
+      // v1.3.3: The secondary still works - switch back only once the
+      // primary has stayed up for failoverSwitchDelay (flapping cable)
+      if (primaryUpSince == 0) {
+        primaryUpSince = now;
+      } else if (now - primaryUpSince >= failoverSwitchDelay) {
+        // Primary is back, switch back to primary
+        Serial.printf("Primary network (%s) restored. Switching back.\n",
+                      primaryMode.c_str());
+        primaryUpSince = 0;
+        switchMode(primaryMode);
+      }
+    }
   }
 }
 
@@ -343,9 +375,15 @@ void NetworkMgr::switchMode(const String& newMode) {
     networkAvailable = false;
   }
 
+  modeGeneration.fetch_add(1);  // v1.3.3: MQTT/HTTP reconnect on the new one
+
   if (networkAvailable) {
+    // v1.3.3: IP read directly - getLocalIP() takes modeMutex (held here)
+    // and stalled every switch for its 100ms timeout
+    IPAddress ip = (activeMode == "WIFI") ? wifiManager->getLocalIP()
+                                          : ethernetManager->getLocalIP();
     Serial.printf("Successfully switched to %s. IP: %s\n", activeMode.c_str(),
-                  getLocalIP().toString().c_str());
+                  ip.toString().c_str());
   } else {
     Serial.println("No network active.");
   }
@@ -439,6 +477,17 @@ Client* NetworkMgr::getActiveClient() {
   return client;
 }
 
+bool NetworkMgr::waitForModeChange(uint32_t generation, uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (millis() - start < timeoutMs) {
+    if (modeGeneration.load() != generation) {
+      return true;
+    }
+    vTaskDelay(pdMS_TO_TICKS(LINK_POLL_MS));
+  }
+  return modeGeneration.load() != generation;
+}
+
 void NetworkMgr::cleanup() {
   if (failoverTaskHandle) {
     vTaskDelete(failoverTaskHandle);
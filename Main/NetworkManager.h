@@ -4,6 +4,7 @@
 #include <ArduinoJson.h>
 #include <freertos/semphr.h>  // For mutex (Bug #6 fix)
 
+#include <atomic>
 #include <vector>
 
 #include "EthernetManager.h"
@@ -28,6 +29,22 @@ class NetworkMgr {
   static void failoverTask(void* parameter);
   void failoverLoop();
 
+  // v1.3.3: Event-driven failover
+  // Previous: failoverLoop() checked the links every failoverCheckInterval
+  // (5s), and dropping the last reference of the old interface on a switch
+  // shut it down, so a pulled cable meant seconds of failed publishes and a
+  // cold start of the other interface on the way back.
+  // New: WiFi events notify the task and the Ethernet link bit is polled
+  // every LINK_POLL_MS, so a lost link is switched away from at once; both
+  // interfaces keep their standing reference (warm standby). Failback to
+  // the primary waits until it has been up for failoverSwitchDelay.
+  // MqttManager / HttpManager follow getModeGeneration() and re-establish
+  // their connection on the new interface.
+  static constexpr uint32_t LINK_POLL_MS = 100;
+  std::atomic<uint32_t> modeGeneration;  // Incremented on every switchMode()
+  unsigned long primaryUpSince;          // Failback hold (0 = primary down)
+  void checkFailover(unsigned long now);
+
   WiFiClient _wifiClient;          // Internal WiFiClient for MQTT/HTTP
   EthernetClient _ethernetClient;  // Internal EthernetClient for MQTT/HTTP
 
@@ -88,6 +105,10 @@ class NetworkMgr {
   IPAddress getLocalIP();
   String getCurrentMode();
   Client* getActiveClient();  // New method to get active client
+  // v1.3.3: Changes whenever the active interface changes
+  uint32_t getModeGeneration() const { return modeGeneration.load(); }
+  // v1.3.3: Sleep up to timeoutMs, returning early (true) on a mode change
+  bool waitForModeChange(uint32_t generation, uint32_t timeoutMs);
   void cleanup();
   void getStatus(JsonObject& status);
 
@@ -0,0 +1,96 @@
+#include "NumberFormat.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double POW10[NumberFormat::MAX_DECIMALS + 1] = {1.0, 1e1, 1e2, 1e3,
+                                                      1e4, 1e5, 1e6};
+
+const double MAX_SCALED = 9007199254740991.0;  // 2^53 - 1 (exact in double)
+
+// Digits of value, backwards from end; returns the first digit
+char* writeDigits(uint64_t value, char* end) {
+  // 64-bit division is a library call on the ESP32 - only for the high part
+  while (value > UINT32_MAX) {
+    *--end = (char)('0' + value % 10);
+    value /= 10;
+  }
+  uint32_t low = (uint32_t)value;
+  do {
+    *--end = (char)('0' + low % 10);
+    low /= 10;
+  } while (low != 0);
+  return end;
+}
+
+}  // namespace
+
+namespace NumberFormat {
+
+double decimalsFactor(int8_t decimals) {
+  if (decimals < 0 || decimals > MAX_DECIMALS) {
+    return 1.0;
+  }
+  return POW10[decimals];
+}
+
+size_t formatFixed(double value, int8_t decimals, char* text) {
+  if (decimals < 0 || decimals > MAX_DECIMALS) {
+    return 0;
+  }
+  double scaled = value * POW10[decimals];
+  if (!(std::fabs(scaled) < MAX_SCALED)) {
+    return 0;  // NaN, Inf or beyond exact integers
+  }
+
+  // Round half away from zero (same as ModbusUtils::calibrate's round())
+  bool negative = scaled < 0;
+  uint64_t digits = (uint64_t)(std::fabs(scaled) + 0.5);
+
+  // Drop trailing fraction zeros (ArduinoJson prints 1.5, not 1.50)
+  int8_t places = decimals;
+  while (places > 0 && digits % 10 == 0) {
+    digits /= 10;
+    places--;
+  }
+
+  char buffer[MAX_TEXT];
+  char* end = buffer + sizeof(buffer);
+  char* start = writeDigits(digits, end);
+  // Leading zeros of a pure fraction: 0.05 -> "005" before the point
+  while (end - start <= places) {
+    *--start = '0';
+  }
+
+  char* out = text;
+  if (negative && digits != 0) {
+    *out++ = '-';  // -0.001 at 2 places prints "0"
+  }
+  size_t integral = (size_t)(end - start) - places;
+  memcpy(out, start, integral);
+  out += integral;
+  if (places > 0) {
+    *out++ = '.';
+    memcpy(out, start + integral, places);
+    out += places;
+  }
+  *out = '\0';
+  return (size_t)(out - text);
+}
+
+void setValue(JsonVariant target, double value, int8_t decimals,
+              bool fixedText) {
+  if (fixedText) {
+    char text[MAX_TEXT];
+    size_t length = formatFixed(value, decimals, text);
+    if (length > 0) {
+      target.set(serialized((const char*)text, length));  // Copied
+      return;
+    }
+  }
+  target.set(value);
+}
+
+}  // namespace NumberFormat
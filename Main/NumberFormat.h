@@ -0,0 +1,55 @@
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <cstdint>
+
+/**
+ * NumberFormat - Fixed-decimal text of register values (JSON payloads)
+ *
+ * v1.3.3: Payload number formatting
+ * Previous: every register value went into the payload document as a double
+ * and ArduinoJson formatted it with its generic algorithm (normalize by
+ * powers of ten, split integral / decimal parts) on each publish - double
+ * arithmetic in software on the ESP32-S3, for every register.
+ * New: a register with "decimals" 0-6 is printed from one scaled integer:
+ * value * 10^decimals (table, no pow()) rounded once, then digits from
+ * 32/64-bit integer division with the decimal point inserted. Trailing
+ * fraction zeros are dropped, so the text equals ArduinoJson's for the
+ * rounded value (1.50 -> "1.5", 2.00 -> "2") and consumers see no change.
+ * "decimals" -1 (auto) keeps ArduinoJson's shortest formatting.
+ *
+ * The text is stored with serialized(), so it is only used for JSON text
+ * encoders; MessagePack / CBOR payloads keep the double (fixedText false).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace NumberFormat {
+
+constexpr int8_t MAX_DECIMALS = 6;  // "decimals" range (ConfigManager)
+constexpr size_t MAX_TEXT = 24;     // "-9007199254740991" + '.' + NUL
+
+// 10^decimals for 0..MAX_DECIMALS, 1.0 otherwise
+double decimalsFactor(int8_t decimals);
+
+/**
+ * Write value rounded to decimals places (no exponent, no trailing zeros)
+ * @param text At least MAX_TEXT bytes
+ * @return Text length, 0 if not representable (auto decimals, NaN/Inf, or
+ *         |value| * 10^decimals beyond 2^53) - use the double instead
+ */
+size_t formatFixed(double value, int8_t decimals, char* text);
+
+/**
+ * Store value in target: fixed-decimal text when fixedText and the value
+ * is representable, else the double
+ */
+void setValue(JsonVariant target, double value, int8_t decimals,
+              bool fixedText);
+
+}  // namespace NumberFormat
+
+#endif  // NUMBER_FORMAT_H
@@ -83,6 +83,11 @@
 #define OTA_HTTPS_BUFFER_SIZE \
   32768  // Download buffer size (PSRAM) - 32KB for faster download
 #define OTA_HTTPS_MAX_REDIRECTS 3  // Maximum HTTP redirects to follow
+// v1.3.3: Download/flash pipeline (second PSRAM buffer + writer task)
+#define OTA_PIPELINE_WRITER_STACK 6144  // esp_ota_write + SHA-256 update
+#define OTA_PIPELINE_WAIT_MS 30000      // Max wait for a flash write slot
+// v1.3.3: TLS session resumption (BearSSL session per host:port)
+#define OTA_TLS_SESSION_SLOTS 4  // Hosts remembered (API, raw, release CDN)
 
 // GitHub requires TLS 1.2+
 #define OTA_TLS_MIN_VERSION MBEDTLS_SSL_MINOR_VERSION_3  // TLS 1.2
@@ -304,7 +309,7 @@ struct OTAPackageHeader {
 #define OTA_FLAG_MANDATORY 0x0001   // Mandatory update
 #define OTA_FLAG_ENCRYPTED 0x0002   // Firmware is encrypted (future)
 #define OTA_FLAG_COMPRESSED 0x0004  // Firmware is compressed (future)
-#define OTA_FLAG_DELTA 0x0008       // Delta update (future)
+#define OTA_FLAG_DELTA 0x0008       // Delta update (HTTPS: OTADeltaPatch)
 
 // ============================================
 // FIRMWARE MANIFEST STRUCT (v2.5.35: Moved from OTAHttps.h)
@@ -325,11 +330,23 @@ struct FirmwareManifest {
   String sha256Hash;
   String signature;  // Base64 encoded
 
+  // v1.3.3: Delta patch against the running version (deltaUrl empty = none)
+  String deltaUrl;
+  uint32_t deltaSize;
+  String deltaBaseVersion;
+  uint32_t deltaBaseSize;
+  String deltaBaseSha256;
+
   bool mandatory;
   bool valid;
 
   FirmwareManifest()
-      : buildNumber(0), firmwareSize(0), mandatory(false), valid(false) {}
+      : buildNumber(0),
+        firmwareSize(0),
+        deltaSize(0),
+        deltaBaseSize(0),
+        mandatory(false),
+        valid(false) {}
 };
 
 // ============================================
@@ -348,10 +365,17 @@ typedef void (*OTAStateCallback)(OTAState oldState, OTAState newState);
 // after including DebugConfig.h
 
 #ifndef LOG_OTA_ERROR
-#define LOG_OTA_ERROR(fmt, ...) LOG_ERROR_F("OTA", fmt, ##__VA_ARGS__)
-#define LOG_OTA_WARN(fmt, ...) LOG_WARN_F("OTA", fmt, ##__VA_ARGS__)
-#define LOG_OTA_INFO(fmt, ...) LOG_INFO_F("OTA", fmt, ##__VA_ARGS__)
-#define LOG_OTA_DEBUG(fmt, ...) LOG_DEBUG_F("OTA", fmt, ##__VA_ARGS__)
+#ifndef LOG_LEVEL_OTA
+#define LOG_LEVEL_OTA COMPILE_LOG_LEVEL  // v1.3.3: Module compile-time level
+#endif
+#define LOG_OTA_ERROR(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_OTA, LOG_ERROR, "OTA", fmt, ##__VA_ARGS__)
+#define LOG_OTA_WARN(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_OTA, LOG_WARN, "OTA", fmt, ##__VA_ARGS__)
+#define LOG_OTA_INFO(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_OTA, LOG_INFO, "OTA", fmt, ##__VA_ARGS__)
+#define LOG_OTA_DEBUG(fmt, ...) \
+  LOG_MODULE_F(LOG_LEVEL_OTA, LOG_DEBUG, "OTA", fmt, ##__VA_ARGS__)
 #endif
 
 // ============================================
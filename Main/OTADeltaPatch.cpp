@@ -0,0 +1,374 @@
+#include "OTADeltaPatch.h"
+
+#include <esp_heap_caps.h>
+
+#include "mbedtls/sha256.h"
+
+const uint8_t OTADeltaPatch::MAGIC_BYTES[4] = {'O', 'T', 'D', '1'};
+
+namespace {
+enum : uint8_t {
+  OP_END = 0x00,
+  OP_COPY = 0x01,
+  OP_ADD = 0x02,
+  OP_INSERT = 0x03
+};
+}
+
+OTADeltaPatch::OTADeltaPatch()
+    : source(nullptr),
+      sourceSize(0),
+      targetSize(0),
+      sink(nullptr),
+      context(nullptr),
+      outBuffer(nullptr),
+      outUsed(0),
+      written(0),
+      state(State::FAILED),
+      magicPos(0),
+      varint(0),
+      varintShift(0),
+      sourcePos(0),
+      opRemaining(0),
+      runRemaining(0),
+      error("Not started") {}
+
+OTADeltaPatch::~OTADeltaPatch() { end(); }
+
+bool OTADeltaPatch::begin(const esp_partition_t* source, size_t sourceSize,
+                          size_t targetSize, OutputSink sink, void* context) {
+  if (!outBuffer) {
+    outBuffer = (uint8_t*)heap_caps_malloc(OUTPUT_SIZE,
+                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  if (!outBuffer || !source || !sink) {
+    return fail("Delta buffer allocation failed");
+  }
+
+  this->source = source;
+  this->sourceSize = sourceSize;
+  this->targetSize = targetSize;
+  this->sink = sink;
+  this->context = context;
+  outUsed = 0;
+  written = 0;
+  state = State::MAGIC;
+  magicPos = 0;
+  varint = 0;
+  varintShift = 0;
+  sourcePos = 0;
+  opRemaining = 0;
+  runRemaining = 0;
+  error = nullptr;
+  return true;
+}
+
+void OTADeltaPatch::end() {
+  if (outBuffer) {
+    heap_caps_free(outBuffer);
+    outBuffer = nullptr;
+  }
+  outUsed = 0;
+}
+
+bool OTADeltaPatch::apply(const uint8_t* data, size_t len) {
+  size_t pos = 0;
+  while (pos < len) {
+    if (state == State::FAILED) {
+      return false;
+    }
+
+    // Bulk states consume as much as the output buffer takes
+    if (state == State::ADD_LITERAL) {
+      pos += addLiterals(data + pos, len - pos);
+      continue;
+    }
+    if (state == State::INSERT_DATA) {
+      pos += insertBytes(data + pos, len - pos);
+      continue;
+    }
+
+    uint8_t byte = data[pos++];
+    switch (state) {
+      case State::MAGIC:
+        if (byte != MAGIC_BYTES[magicPos]) {
+          return fail("Not a delta patch");
+        }
+        if (++magicPos == sizeof(MAGIC_BYTES)) {
+          state = State::TARGET_SIZE;
+        }
+        break;
+
+      case State::TARGET_SIZE:
+        if (readVarint(byte)) {
+          if (varint != targetSize) {
+            return fail("Patch target size mismatch");
+          }
+          state = State::SOURCE_SIZE;
+        }
+        break;
+
+      case State::SOURCE_SIZE:
+        if (readVarint(byte)) {
+          if (varint != sourceSize) {
+            return fail("Patch base size mismatch");
+          }
+          state = State::OPCODE;
+        }
+        break;
+
+      case State::OPCODE:
+        switch (byte) {
+          case OP_END:
+            state = State::DONE;
+            break;
+          case OP_COPY:
+            state = State::COPY_OFFSET;
+            break;
+          case OP_ADD:
+            state = State::ADD_OFFSET;
+            break;
+          case OP_INSERT:
+            state = State::INSERT_LENGTH;
+            break;
+          default:
+            return fail("Unknown patch op");
+        }
+        break;
+
+      case State::COPY_OFFSET:
+      case State::ADD_OFFSET:
+        if (readVarint(byte)) {
+          sourcePos = varint;
+          state = (state == State::COPY_OFFSET) ? State::COPY_LENGTH
+                                                : State::ADD_LENGTH;
+        }
+        break;
+
+      case State::COPY_LENGTH:
+        if (readVarint(byte)) {
+          if (!startOp(sourcePos, varint) || !copySource(varint)) {
+            return false;
+          }
+          state = State::OPCODE;
+        }
+        break;
+
+      case State::ADD_LENGTH:
+        if (readVarint(byte)) {
+          if (!startOp(sourcePos, varint)) {
+            return false;
+          }
+          state = (opRemaining > 0) ? State::ADD_ZERO_RUN : State::OPCODE;
+        }
+        break;
+
+      case State::ADD_ZERO_RUN:
+        if (readVarint(byte)) {
+          if (varint > opRemaining) {
+            return fail("ADD run exceeds op length");
+          }
+          if (!copySource(varint)) {  // Zero diff = source byte as is
+            return false;
+          }
+          state = State::ADD_LITERAL_RUN;
+        }
+        break;
+
+      case State::ADD_LITERAL_RUN:
+        if (readVarint(byte)) {
+          if (varint > opRemaining) {
+            return fail("ADD run exceeds op length");
+          }
+          runRemaining = varint;
+          if (runRemaining > 0) {
+            state = State::ADD_LITERAL;
+          } else {
+            state = (opRemaining > 0) ? State::ADD_ZERO_RUN : State::OPCODE;
+          }
+        }
+        break;
+
+      case State::INSERT_LENGTH:
+        if (readVarint(byte)) {
+          if (written + outUsed + (uint64_t)varint > targetSize) {
+            return fail("Patch exceeds target size");
+          }
+          opRemaining = varint;
+          state = (opRemaining > 0) ? State::INSERT_DATA : State::OPCODE;
+        }
+        break;
+
+      case State::DONE:
+        return fail("Data after patch end");
+
+      default:
+        return fail("Invalid patch state");
+    }
+  }
+  return state != State::FAILED;
+}
+
+bool OTADeltaPatch::finish() {
+  if (state == State::FAILED) {
+    return false;
+  }
+  if (state != State::DONE) {
+    return fail("Patch truncated");
+  }
+  if (!flush()) {
+    return false;
+  }
+  if (written != targetSize) {
+    return fail("Rebuilt image size mismatch");
+  }
+  return true;
+}
+
+bool OTADeltaPatch::hashPartition(const esp_partition_t* partition,
+                                  size_t size, uint8_t* hashOut) {
+  if (!partition || size > partition->size) {
+    return false;
+  }
+  uint8_t* chunk = (uint8_t*)heap_caps_malloc(
+      OUTPUT_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!chunk) {
+    return false;
+  }
+
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);  // 0 = SHA-256 (not SHA-224)
+  bool ok = true;
+  for (size_t offset = 0; offset < size && ok; offset += OUTPUT_SIZE) {
+    size_t n = min(OUTPUT_SIZE, size - offset);
+    ok = esp_partition_read(partition, offset, chunk, n) == ESP_OK;
+    if (ok) {
+      mbedtls_sha256_update(&sha, chunk, n);
+    }
+    if ((offset / OUTPUT_SIZE) % 64 == 0) {
+      vTaskDelay(1);  // ~2MB image: keep the watchdog fed
+    }
+  }
+  if (ok) {
+    mbedtls_sha256_finish(&sha, hashOut);
+  }
+  mbedtls_sha256_free(&sha);
+  heap_caps_free(chunk);
+  return ok;
+}
+
+bool OTADeltaPatch::readVarint(uint8_t byte) {
+  if (varintShift > 28) {
+    fail("Patch integer too large");
+    return false;
+  }
+  if (varintShift == 0) {
+    varint = 0;
+  }
+  varint |= (uint32_t)(byte & 0x7F) << varintShift;
+  varintShift += 7;
+  if (byte & 0x80) {
+    return false;
+  }
+  varintShift = 0;
+  return true;
+}
+
+bool OTADeltaPatch::startOp(uint32_t offset, uint32_t length) {
+  if ((uint64_t)offset + length > sourceSize) {
+    return fail("Patch reads past base image");
+  }
+  if (written + outUsed + (uint64_t)length > targetSize) {
+    return fail("Patch exceeds target size");
+  }
+  sourcePos = offset;
+  opRemaining = length;
+  return true;
+}
+
+bool OTADeltaPatch::copySource(uint32_t length) {
+  while (length > 0) {
+    size_t room;
+    if (!reserveOutput(room)) {
+      return false;
+    }
+    size_t n = min((size_t)length, room);
+    if (esp_partition_read(source, sourcePos, outBuffer + outUsed, n) !=
+        ESP_OK) {
+      return fail("Base partition read failed");
+    }
+    outUsed += n;
+    sourcePos += n;
+    opRemaining -= n;
+    length -= n;
+  }
+  return true;
+}
+
+size_t OTADeltaPatch::addLiterals(const uint8_t* data, size_t len) {
+  size_t room;
+  if (!reserveOutput(room)) {
+    return len;
+  }
+  size_t n = min(min(len, (size_t)runRemaining), room);
+  uint8_t* out = outBuffer + outUsed;
+  if (esp_partition_read(source, sourcePos, out, n) != ESP_OK) {
+    fail("Base partition read failed");
+    return len;
+  }
+  for (size_t i = 0; i < n; i++) {
+    out[i] += data[i];
+  }
+  outUsed += n;
+  sourcePos += n;
+  opRemaining -= n;
+  runRemaining -= n;
+  if (runRemaining == 0) {
+    state = (opRemaining > 0) ? State::ADD_ZERO_RUN : State::OPCODE;
+  }
+  return n;
+}
+
+size_t OTADeltaPatch::insertBytes(const uint8_t* data, size_t len) {
+  size_t room;
+  if (!reserveOutput(room)) {
+    return len;
+  }
+  size_t n = min(min(len, (size_t)opRemaining), room);
+  memcpy(outBuffer + outUsed, data, n);
+  outUsed += n;
+  opRemaining -= n;
+  if (opRemaining == 0) {
+    state = State::OPCODE;
+  }
+  return n;
+}
+
+bool OTADeltaPatch::reserveOutput(size_t& room) {
+  if (outUsed == OUTPUT_SIZE && !flush()) {
+    return false;
+  }
+  room = OUTPUT_SIZE - outUsed;
+  return true;
+}
+
+bool OTADeltaPatch::flush() {
+  if (outUsed == 0) {
+    return true;
+  }
+  if (!sink(context, outBuffer, outUsed)) {
+    return fail("Image write failed");
+  }
+  written += outUsed;
+  outUsed = 0;
+  return true;
+}
+
+bool OTADeltaPatch::fail(const char* message) {
+  if (state != State::FAILED) {
+    error = message;
+    state = State::FAILED;
+  }
+  return false;
+}
@@ -0,0 +1,130 @@
+#ifndef OTA_DELTA_PATCH_H
+#define OTA_DELTA_PATCH_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+#include <cstdint>
+
+/**
+ * OTADeltaPatch - Streaming delta patch decoder for HTTPS OTA
+ *
+ * v1.3.3: Delta OTA
+ * A patch rebuilds the new image from the running partition (source) plus
+ * the bytes that changed, so a small release does not cost a full 1.5-2MB
+ * download. Patch bytes are fed in arbitrary chunks as they arrive; the
+ * rebuilt image is handed to the output sink in order (esp_ota_write +
+ * SHA-256 in OTAHttps), so OTAValidator checks the final image exactly as
+ * for a full download.
+ *
+ * Patch format (Tools/make_delta_patch.py), integers are unsigned LEB128:
+ *   header:  "OTD1", target size, source size
+ *   COPY   (0x01): source offset, length          - source bytes as is
+ *   ADD    (0x02): source offset, length, runs    - source bytes + diff;
+ *                  runs = (zero count, literal count, literal bytes)...
+ *                  until length is covered (diff bytes added mod 256)
+ *   INSERT (0x03): length, bytes                  - new bytes
+ *   END    (0x00)
+ *
+ * Any malformed op, out-of-range source read or size mismatch fails the
+ * patch; the caller falls back to the full image.
+ *
+ * Not thread-safe: one patch per download.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class OTADeltaPatch {
+ public:
+  // Receives the rebuilt image in order; false aborts the patch
+  typedef bool (*OutputSink)(void* context, const uint8_t* data, size_t len);
+
+  OTADeltaPatch();
+  ~OTADeltaPatch();
+
+  /**
+   * Start (or restart) decoding a patch
+   * @param source Running partition the patch was made against
+   * @param sourceSize Base image size (manifest base_size)
+   * @param targetSize New image size (manifest firmware size)
+   * @return false if the output buffer could not be allocated
+   */
+  bool begin(const esp_partition_t* source, size_t sourceSize,
+             size_t targetSize, OutputSink sink, void* context);
+
+  /**
+   * Decode the next patch bytes
+   * @return false once the patch failed (see errorMessage())
+   */
+  bool apply(const uint8_t* data, size_t len);
+
+  /**
+   * Flush the rebuilt tail
+   * @return true if END was reached with exactly targetSize bytes written
+   */
+  bool finish();
+
+  void end();  // Free the output buffer
+
+  bool failed() const { return state == State::FAILED; }
+  const char* errorMessage() const { return error; }
+  size_t bytesWritten() const { return written + outUsed; }
+
+  /**
+   * SHA-256 of the first size bytes of a partition (base image check)
+   */
+  static bool hashPartition(const esp_partition_t* partition, size_t size,
+                            uint8_t* hashOut);
+
+ private:
+  enum class State : uint8_t {
+    MAGIC,
+    TARGET_SIZE,
+    SOURCE_SIZE,
+    OPCODE,
+    COPY_OFFSET,
+    COPY_LENGTH,
+    ADD_OFFSET,
+    ADD_LENGTH,
+    ADD_ZERO_RUN,
+    ADD_LITERAL_RUN,
+    ADD_LITERAL,
+    INSERT_LENGTH,
+    INSERT_DATA,
+    DONE,
+    FAILED
+  };
+
+  static constexpr size_t OUTPUT_SIZE = 4096;
+  static const uint8_t MAGIC_BYTES[4];
+
+  const esp_partition_t* source;
+  size_t sourceSize;
+  size_t targetSize;
+  OutputSink sink;
+  void* context;
+
+  uint8_t* outBuffer;  // PSRAM, flushed to sink when full
+  size_t outUsed;
+  size_t written;  // Bytes already passed to sink
+
+  State state;
+  uint8_t magicPos;
+  uint32_t varint;  // LEB128 value being read
+  uint8_t varintShift;
+  uint32_t sourcePos;  // Next source byte of the current op
+  uint32_t opRemaining;  // Output bytes left in the current op
+  uint32_t runRemaining;  // Literal bytes left in the current ADD run
+  const char* error;
+
+  bool readVarint(uint8_t byte);  // true when the value is complete
+  bool startOp(uint32_t offset, uint32_t length);
+  bool copySource(uint32_t length);
+  size_t addLiterals(const uint8_t* data, size_t len);
+  size_t insertBytes(const uint8_t* data, size_t len);
+  bool reserveOutput(size_t& room);
+  bool flush();
+  bool fail(const char* message);
+};
+
+#endif  // OTA_DELTA_PATCH_H
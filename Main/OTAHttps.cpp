@@ -34,10 +34,60 @@
 #include <mbedtls/base64.h>
 
 #include "JsonDocumentPSRAM.h"  // For SpiRamJsonDocument
+#include "ProductConfig.h"      // v1.3.3: FIRMWARE_VERSION (delta base)
 
 // Singleton instance
 OTAHttps* OTAHttps::instance = nullptr;
 
+// ============================================
+// v1.3.3: TLS SESSION CACHE
+// ============================================
+// Previous: every manifest fetch, redirect, download and resume reconnect
+// ran a full handshake (certificate chain + ECDHE, hundreds of ms of CPU).
+// New: one BearSSL session per host:port outlives the SSL client objects
+// (they are recreated on redirects and network changes). ESP_SSLClient
+// offers the stored session on connect and updates it after the handshake,
+// so repeated connections to the same endpoint resume with an abbreviated
+// handshake; a server that does not resume simply does a full one.
+// Lives here because ESP_SSLClient.h may only be included by this file.
+namespace {
+struct TlsSessionSlot {
+  String host;
+  uint16_t port = 0;
+  uint32_t lastUsed = 0;
+  BearSSL_Session session;
+};
+TlsSessionSlot tlsSessions[OTA_TLS_SESSION_SLOTS];
+
+BearSSL_Session* tlsSessionFor(const String& host, uint16_t port) {
+  TlsSessionSlot* slot = &tlsSessions[0];
+  for (TlsSessionSlot& candidate : tlsSessions) {
+    if (candidate.port == port && candidate.host == host) {
+      slot = &candidate;
+      break;
+    }
+    if (candidate.lastUsed < slot->lastUsed) {
+      slot = &candidate;  // Least recently used (or empty) slot
+    }
+  }
+  if (slot->port != port || slot->host != host) {
+    slot->host = host;
+    slot->port = port;
+    slot->session = BearSSL_Session();  // New host: nothing to resume
+  }
+  slot->lastUsed = millis() | 1;  // 0 = never used
+  return &slot->session;
+}
+
+void tlsSessionForget(const String& host, uint16_t port) {
+  for (TlsSessionSlot& slot : tlsSessions) {
+    if (slot.port == port && slot.host == host) {
+      slot.session = BearSSL_Session();
+    }
+  }
+}
+}  // namespace
+
 // ============================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================
@@ -67,8 +117,19 @@ OTAHttps::OTAHttps()
       progressCallback(nullptr),
       downloadBuffer(nullptr),
       bufferSize(OTA_HTTPS_BUFFER_SIZE),
-      bufferFromPsram(false)  // v2.5.34 FIX: Initialize to false
-{
+      bufferFromPsram(false),  // v2.5.34 FIX: Initialize to false
+      pipelineBuffer(nullptr),
+      filledBlocks(nullptr),
+      freeBlocks(nullptr),
+      writerTask(nullptr),
+      writerFailed(false),
+      pipelineOwner(nullptr),
+      fillBuffer(nullptr),
+      fillLength(0),
+      deltaPatch(nullptr),
+      deltaSource(nullptr),
+      deltaBaseSize(0),
+      deltaTargetSize(0) {
   httpMutex = xSemaphoreCreateMutex();
 
   // Get NetworkManager for network status
@@ -548,14 +609,18 @@ int OTAHttps::performRequest(const char* method, size_t rangeStart) {
 
   if (usingWiFi && wifiSecure) {
     // ESP_SSLClient wrapping WiFiClient
+    wifiSecure->setSession(tlsSessionFor(host, port));  // v1.3.3: Resume
     connected = wifiSecure->connect(host.c_str(), port);
   } else if (!usingWiFi && ethSecure) {
     // ESP_SSLClient wrapping EthernetClient
+    ethSecure->setSession(tlsSessionFor(host, port));  // v1.3.3: Resume
     connected = ethSecure->connect(host.c_str(), port);
   }
   unsigned long connectTime = millis() - connectStart;
 
   if (!connected) {
+    tlsSessionForget(host, port);  // v1.3.3: Next attempt starts clean
+
     LOG_OTA_ERROR("SSL connection failed to %s:%d (took %lu ms)\n",
                   host.c_str(), port, connectTime);
 
@@ -751,6 +816,199 @@ void OTAHttps::abortOTA() {
   }
 }
 
+// ============================================
+// v1.3.3: DOWNLOAD / FLASH PIPELINE
+// ============================================
+
+bool OTAHttps::startPipeline() {
+  fillBuffer = nullptr;
+  fillLength = 0;
+  writerFailed = false;
+  pipelineOwner = xTaskGetCurrentTaskHandle();
+
+  // Second buffer only next to a full-size PSRAM one (the 1KB DRAM fallback
+  // is too small to be worth a task)
+  if (bufferFromPsram) {
+    pipelineBuffer = (uint8_t*)heap_caps_malloc(
+        bufferSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  if (pipelineBuffer) {
+    filledBlocks = xQueueCreate(2, sizeof(PipelineBlock));
+    freeBlocks = xQueueCreate(2, sizeof(uint8_t*));
+  }
+  if (pipelineBuffer && filledBlocks && freeBlocks) {
+    xQueueSend(freeBlocks, &downloadBuffer, 0);
+    xQueueSend(freeBlocks, &pipelineBuffer, 0);
+
+    // Writer on the other core, so TLS decryption and flash writes overlap
+    BaseType_t otherCore = (xPortGetCoreID() == 0) ? 1 : 0;
+    xTaskCreatePinnedToCore(pipelineWriterTask, "OTA_WRITER",
+                            OTA_PIPELINE_WRITER_STACK, this,
+                            uxTaskPriorityGet(nullptr), &writerTask,
+                            otherCore);
+  }
+
+  if (!writerTask) {
+    if (filledBlocks) vQueueDelete(filledBlocks);
+    if (freeBlocks) vQueueDelete(freeBlocks);
+    if (pipelineBuffer) heap_caps_free(pipelineBuffer);
+    filledBlocks = nullptr;
+    freeBlocks = nullptr;
+    pipelineBuffer = nullptr;
+    LOG_OTA_WARN("Download pipeline unavailable, writing inline\n");
+    return false;
+  }
+
+  LOG_OTA_DEBUG("Download pipeline started (2 x %u bytes)\n", bufferSize);
+  return true;
+}
+
+void OTAHttps::pipelineWriterTask(void* parameter) {
+  OTAHttps* self = static_cast<OTAHttps*>(parameter);
+  PipelineBlock block;
+  while (xQueueReceive(self->filledBlocks, &block, portMAX_DELAY) == pdTRUE) {
+    if (block.data == nullptr) {
+      break;  // Stop request (queue drained before it was sent)
+    }
+
+    // After the first failure blocks are only recycled; the download task
+    // sees writerFailed and aborts
+    if (!self->writerFailed && !self->consumeBlock(block.data, block.length)) {
+      self->writerFailed = true;
+    }
+    xQueueSend(self->freeBlocks, &block.data, portMAX_DELAY);
+  }
+
+  // No queue access after this point (owner deletes them once notified)
+  xTaskNotifyGive(self->pipelineOwner);
+  vTaskDelete(nullptr);
+}
+
+uint8_t* OTAHttps::acquireFillBuffer() {
+  if (fillBuffer) {
+    return fillBuffer;
+  }
+  fillLength = 0;
+  if (!writerTask) {
+    fillBuffer = downloadBuffer;  // Inline mode: one buffer
+  } else if (xQueueReceive(freeBlocks, &fillBuffer,
+                           pdMS_TO_TICKS(OTA_PIPELINE_WAIT_MS)) != pdTRUE) {
+    fillBuffer = nullptr;
+    lastError = OTAError::FLASH_ERROR;
+    lastErrorMessage = "Flash write stalled";
+    LOG_OTA_ERROR("No free download buffer after %d ms\n",
+                  OTA_PIPELINE_WAIT_MS);
+  }
+  return fillBuffer;
+}
+
+bool OTAHttps::submitFillBuffer() {
+  if (!fillBuffer || fillLength == 0) {
+    return !writerFailed;
+  }
+
+  if (!writerTask) {
+    // Inline write (previous behaviour)
+    if (!consumeBlock(fillBuffer, fillLength)) {
+      writerFailed = true;
+    } else {
+      vTaskDelay(1);  // Yield after flash write to prevent watchdog timeout
+    }
+  } else {
+    PipelineBlock block = {fillBuffer, fillLength};
+    xQueueSend(filledBlocks, &block, portMAX_DELAY);  // Never full (2 slots)
+  }
+
+  fillBuffer = nullptr;
+  fillLength = 0;
+  return !writerFailed;
+}
+
+bool OTAHttps::drainPipeline(bool keepPartial) {
+  if (keepPartial) {
+    submitFillBuffer();
+  } else {
+    fillLength = 0;
+  }
+  if (!writerTask) {
+    fillBuffer = nullptr;
+    return !writerFailed;
+  }
+
+  if (fillBuffer) {
+    xQueueSend(freeBlocks, &fillBuffer, 0);
+    fillBuffer = nullptr;
+  }
+
+  // Both buffers back in freeBlocks = every block written
+  unsigned long start = millis();
+  while (uxQueueMessagesWaiting(freeBlocks) < 2) {
+    if (millis() - start > OTA_PIPELINE_WAIT_MS) {
+      LOG_OTA_ERROR("Flash writer did not finish within %d ms\n",
+                    OTA_PIPELINE_WAIT_MS);
+      writerFailed = true;
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+  return !writerFailed;
+}
+
+void OTAHttps::stopPipeline() {
+  bool drained = drainPipeline(false);
+  if (!writerTask) {
+    return;
+  }
+
+  PipelineBlock stop = {nullptr, 0};
+  xQueueSend(filledBlocks, &stop, portMAX_DELAY);
+  if (!drained ||
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(OTA_PIPELINE_WAIT_MS)) == 0) {
+    // Writer still busy: leak the queues and buffer rather than free them
+    // under a running task
+    LOG_OTA_ERROR("Flash writer did not stop, pipeline resources kept\n");
+    writerTask = nullptr;
+    return;
+  }
+
+  writerTask = nullptr;
+  vQueueDelete(filledBlocks);
+  vQueueDelete(freeBlocks);
+  filledBlocks = nullptr;
+  freeBlocks = nullptr;
+  heap_caps_free(pipelineBuffer);
+  pipelineBuffer = nullptr;
+}
+
+bool OTAHttps::consumeBlock(const uint8_t* data, size_t len) {
+  if (!deltaPatch) {
+    return writeImageData(this, data, len);
+  }
+
+  // v1.3.3: Patch bytes - the rebuilt image reaches writeImageData()
+  if (!deltaPatch->apply(data, len)) {
+    if (lastError == OTAError::NONE) {
+      lastError = OTAError::INVALID_FIRMWARE;
+      lastErrorMessage = String("Delta patch: ") + deltaPatch->errorMessage();
+    }
+    LOG_OTA_ERROR("Delta patch failed: %s\n", deltaPatch->errorMessage());
+    return false;
+  }
+  return true;
+}
+
+bool OTAHttps::writeImageData(void* context, const uint8_t* data,
+                              size_t len) {
+  OTAHttps* self = static_cast<OTAHttps*>(context);
+  if (!self->writeOTAData(data, len)) {
+    return false;
+  }
+  if (self->validator) {
+    self->validator->hashUpdate(data, len);
+  }
+  return true;
+}
+
 // ============================================
 // v2.5.15: PROGRESS BAR DISPLAY (Dev Mode Only)
 // ============================================
@@ -975,11 +1233,52 @@ bool OTAHttps::parseManifest(const String& json, FirmwareManifest& manifest) {
     manifest.firmwareUrl = buildRawUrl(filename);
   }
 
+  // v1.3.3: Delta patches ("delta": object or array), only the one made
+  // against the running version is kept
+  manifest.deltaUrl = "";
+  manifest.deltaSize = 0;
+  auto pickDelta = [&](JsonObject delta) {
+    if (manifest.deltaUrl.length() > 0 ||
+        delta["base_version"].as<String>() != FIRMWARE_VERSION) {
+      return;
+    }
+    String deltaFile = delta["filename"].as<String>();
+    if (delta["url"].is<String>() &&
+        delta["url"].as<String>().startsWith("http")) {
+      manifest.deltaUrl = delta["url"].as<String>();
+    } else if (deltaFile.length() == 0) {
+      return;
+    } else if (githubConfig.useReleases) {
+      manifest.deltaUrl = buildReleaseUrl("v" + manifest.version, deltaFile);
+    } else {
+      manifest.deltaUrl = buildRawUrl(deltaFile);
+    }
+    manifest.deltaSize = delta["size"] | 0;
+    manifest.deltaBaseVersion = delta["base_version"].as<String>();
+    manifest.deltaBaseSize = delta["base_size"] | 0;
+    manifest.deltaBaseSha256 = delta["base_sha256"].as<String>();
+    if (manifest.deltaSize == 0 || manifest.deltaBaseSize == 0 ||
+        manifest.deltaBaseSha256.length() != OTA_HASH_SIZE * 2) {
+      manifest.deltaUrl = "";  // Incomplete entry: full image only
+    }
+  };
+  if (firmware["delta"].is<JsonObject>()) {
+    pickDelta(firmware["delta"].as<JsonObject>());
+  } else {
+    for (JsonObject delta : firmware["delta"].as<JsonArray>()) {
+      pickDelta(delta);
+    }
+  }
+
   manifest.valid = manifest.version.length() > 0 && manifest.firmwareSize > 0;
 
   LOG_OTA_INFO("Manifest parsed: v%s (build %u), size %u\n",
                manifest.version.c_str(), manifest.buildNumber,
                manifest.firmwareSize);
+  if (manifest.deltaUrl.length() > 0) {
+    LOG_OTA_INFO("Delta patch from v%s: %u bytes\n",
+                 manifest.deltaBaseVersion.c_str(), manifest.deltaSize);
+  }
 
   return manifest.valid;
 }
@@ -990,11 +1289,88 @@ bool OTAHttps::parseManifest(const String& json, FirmwareManifest& manifest) {
 
 bool OTAHttps::downloadFirmware(const FirmwareManifest& manifest,
                                 ValidationResult& result) {
+  // v1.3.3: Delta patch first, full image on any failure
+  if (manifest.deltaUrl.length() > 0) {
+    if (downloadDelta(manifest, result)) {
+      return true;
+    }
+    if (lastError == OTAError::ABORTED) {
+      return false;
+    }
+    LOG_OTA_WARN("Delta update failed (%s), downloading full image\n",
+                 lastErrorMessage.c_str());
+    result = ValidationResult();
+  }
+
   // v2.5.15: Retry wrapper with automatic retry on failure
   return downloadWithRetry(manifest.firmwareUrl, manifest.firmwareSize,
                            manifest.sha256Hash, manifest.signature, result);
 }
 
+// v1.3.3: Delta download - patch applied against the running partition
+bool OTAHttps::downloadDelta(const FirmwareManifest& manifest,
+                             ValidationResult& result) {
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  if (!verifyDeltaBase(running, manifest)) {
+    return false;
+  }
+
+  LOG_OTA_INFO("Delta update v%s -> v%s: %u bytes instead of %u\n",
+               manifest.deltaBaseVersion.c_str(), manifest.version.c_str(),
+               manifest.deltaSize, manifest.firmwareSize);
+
+  OTADeltaPatch patch;
+  deltaPatch = &patch;
+  deltaSource = running;
+  deltaBaseSize = manifest.deltaBaseSize;
+  deltaTargetSize = manifest.firmwareSize;
+
+  // Final image is checked against the full image hash/signature
+  bool success =
+      downloadWithRetry(manifest.deltaUrl, manifest.deltaSize,
+                        manifest.sha256Hash, manifest.signature, result);
+
+  deltaPatch = nullptr;
+  deltaSource = nullptr;
+  return success;
+}
+
+bool OTAHttps::verifyDeltaBase(const esp_partition_t* running,
+                               const FirmwareManifest& manifest) {
+  lastError = OTAError::INVALID_FIRMWARE;
+  if (!running || !validator || manifest.deltaBaseSize > running->size) {
+    lastErrorMessage = "Delta base unavailable";
+    return false;
+  }
+
+  // Same version string is not enough (local builds): the running image must
+  // be byte-identical to the patch base
+  uint8_t expected[OTA_HASH_SIZE];
+  uint8_t actual[OTA_HASH_SIZE];
+  if (!validator->hexToHash(manifest.deltaBaseSha256.c_str(), expected) ||
+      !OTADeltaPatch::hashPartition(running, manifest.deltaBaseSize, actual)) {
+    lastErrorMessage = "Delta base hash unavailable";
+    return false;
+  }
+  if (!validator->compareHash(actual, expected)) {
+    lastErrorMessage = "Running image does not match delta base";
+    return false;
+  }
+
+  lastError = OTAError::NONE;
+  return true;
+}
+
+bool OTAHttps::beginDeltaPatch() {
+  if (!deltaPatch->begin(deltaSource, deltaBaseSize, deltaTargetSize,
+                         writeImageData, this)) {
+    lastError = OTAError::MEMORY_ERROR;
+    lastErrorMessage = String("Delta patch: ") + deltaPatch->errorMessage();
+    return false;
+  }
+  return true;
+}
+
 // v2.5.15: Download with retry support
 bool OTAHttps::downloadWithRetry(const String& url, size_t expectedSize,
                                  const String& expectedHash,
@@ -1216,8 +1592,8 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
   progress.totalBytes = contentLength;
   LOG_OTA_INFO("Content length: %u bytes\n", contentLength);
 
-  // Begin OTA partition
-  if (!beginOTAPartition(contentLength)) {
+  // Begin OTA partition (v1.3.3: delta writes the rebuilt image size)
+  if (!beginOTAPartition(deltaPatch ? deltaTargetSize : contentLength)) {
     sslClient->stop();
     downloading = false;
     progress.inProgress = false;
@@ -1230,6 +1606,18 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
     validator->hashBegin();
   }
 
+  if (deltaPatch && !beginDeltaPatch()) {
+    abortOTA();
+    sslClient->stop();
+    downloading = false;
+    progress.inProgress = false;
+    xSemaphoreGive(httpMutex);
+    return false;
+  }
+
+  // v1.3.3: Flash writes + hashing overlap the next network read
+  startPipeline();
+
   unsigned long startTime = millis();
   unsigned long lastProgressTime = startTime;
   unsigned long lastDataTime =
@@ -1251,6 +1639,7 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
     if (abortRequested) {
       lastError = OTAError::ABORTED;
       lastErrorMessage = "Download aborted by user";
+      stopPipeline();
       abortOTA();
       sslClient->stop();
       downloading = false;
@@ -1261,7 +1650,18 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
 
     size_t available = sslClient->available();
     if (available > 0) {
-      size_t toRead = min(available, bufferSize);
+      // v1.3.3: Read straight into the free pipeline buffer
+      uint8_t* block = acquireFillBuffer();
+      if (!block) {
+        stopPipeline();
+        abortOTA();
+        sslClient->stop();
+        downloading = false;
+        progress.inProgress = false;
+        xSemaphoreGive(httpMutex);
+        return false;
+      }
+      size_t toRead = min(available, bufferSize - fillLength);
 
       // v2.5.26: Prevent over-downloading
       // Ensure we don't read more than needed
@@ -1270,13 +1670,24 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
         toRead = remaining;
       }
 
-      size_t bytesRead = sslClient->readBytes(downloadBuffer, toRead);
+      size_t bytesRead = sslClient->readBytes(block + fillLength, toRead);
 
       if (bytesRead > 0) {
         lastDataTime = millis();  // Reset timeout on data received
+        fillLength += bytesRead;
+
+        // Hand the block to the flash writer once it is full, the image is
+        // complete or the socket has nothing more right now
+        bool submitted = true;
+        if (fillLength == bufferSize ||
+            progress.bytesDownloaded + bytesRead >= targetSize ||
+            sslClient->available() == 0) {
+          submitted = submitFillBuffer();
+        }
 
-        // Write to OTA partition
-        if (!writeOTAData(downloadBuffer, bytesRead)) {
+        // Write to OTA partition failed (inline or in the writer task)
+        if (!submitted || writerFailed) {
+          stopPipeline();
           abortOTA();
           sslClient->stop();
           downloading = false;
@@ -1285,16 +1696,7 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
           return false;
         }
 
-        // Yield after flash write to prevent watchdog timeout
-        vTaskDelay(1);
-
-        // Update hash
-        if (validator) {
-          validator->hashUpdate(downloadBuffer, bytesRead);
-          vTaskDelay(1);  // Yield after hash computation
-        }
-
-        // Update progress
+        // Update progress (network bytes; flash may lag by one block)
         progress.bytesDownloaded += bytesRead;
         progress.percent = (progress.bytesDownloaded * 100) / targetSize;
 
@@ -1364,7 +1766,9 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
                   "Server returned 200 (no Range support). Restarting download "
                   "from byte 0\n");
 
-              // Abort current OTA and restart
+              // Abort current OTA and restart (v1.3.3: after in-flight
+              // blocks are written, so none lands in the new session)
+              drainPipeline(false);
               abortOTA();
 
               // Read headers and verify Content-Length before restarting
@@ -1402,6 +1806,11 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
                 validator->hashBegin();
               }
 
+              // v1.3.3: Patch restarts from its header too
+              if (deltaPatch && !beginDeltaPatch()) {
+                break;
+              }
+
               // Reset progress
               progress.bytesDownloaded = 0;
               progress.percent = 0;
@@ -1435,6 +1844,22 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
 
   sslClient->stop();
 
+  // v1.3.3: Write the last block and stop the writer before validating
+  bool flushed = drainPipeline(progress.bytesDownloaded == targetSize);
+  stopPipeline();
+  if (!flushed && progress.bytesDownloaded == targetSize) {
+    LOG_OTA_ERROR("Flash write of final block failed\n");
+    if (lastError == OTAError::NONE) {
+      lastError = OTAError::FLASH_ERROR;
+      lastErrorMessage = "Flash write failed";
+    }
+    abortOTA();
+    downloading = false;
+    progress.inProgress = false;
+    xSemaphoreGive(httpMutex);
+    return false;
+  }
+
   // Verify download complete
   if (progress.bytesDownloaded != targetSize) {
     // Don't overwrite specific error if already set
@@ -1451,6 +1876,20 @@ bool OTAHttps::downloadFirmwareFromUrl(const String& url, size_t expectedSize,
     return false;
   }
 
+  // v1.3.3: Whole patch applied and exactly the new image size rebuilt
+  if (deltaPatch && !deltaPatch->finish()) {
+    if (lastError == OTAError::NONE) {
+      lastError = OTAError::INVALID_FIRMWARE;
+      lastErrorMessage = String("Delta patch: ") + deltaPatch->errorMessage();
+    }
+    LOG_OTA_ERROR("Delta patch incomplete: %s\n", deltaPatch->errorMessage());
+    abortOTA();
+    downloading = false;
+    progress.inProgress = false;
+    xSemaphoreGive(httpMutex);
+    return false;
+  }
+
   LOG_OTA_INFO("Download complete: %u bytes in %lu ms\n",
                progress.bytesDownloaded, millis() - startTime);
 
@@ -12,6 +12,9 @@
  * - TLS 1.2+ security
  * - Manifest parsing
  *
+ * v1.3.3: TLS session resumption - one cached session per host:port
+ * v1.3.3: Delta OTA - patch against the running image, full image fallback
+ * v1.3.3: Pipelined download - network reads and flash writes overlap
  * v2.5.35: Fix ESP_SSLClient v3.x linker error - moved #include to OTAHttps.cpp
  * only v2.5.34: Fix memory allocator mismatch (PSRAM/DRAM) - use correct free()
  * v2.5.30: Increase OTA buffer size to 32KB for faster download
@@ -26,6 +29,7 @@
 
 #include <Arduino.h>
 #include <WiFi.h>  // v2.5.3: For WiFiClient base transport
+#include <freertos/queue.h>  // v1.3.3: Download pipeline
 
 #include "DebugConfig.h"     // MUST BE FIRST
 #include "NetworkManager.h"  // v2.5.3: For multi-network support (WiFi + Ethernet)
@@ -58,6 +62,7 @@ class ESP_SSLClient;
 #include <esp_partition.h>
 
 #include "GitHubTrustAnchors.h"  // GitHub root CA certificates
+#include "OTADeltaPatch.h"       // v1.3.3: Delta OTA
 // v2.5.9: ESP_SSLClient (mobizt) - PSRAM support for large SSL buffers
 
 // Forward declarations
@@ -164,6 +169,35 @@ class OTAHttps {
   bool bufferFromPsram;  // v2.5.34 FIX: Track allocation source for correct
                          // deallocation
 
+  // v1.3.3: Download/flash pipeline
+  // Previous: read a chunk, esp_ota_write + SHA-256 it, then read the next
+  // one - the socket sat idle during every flash erase/program (TLS window
+  // stalls). New: the download task fills one buffer while a writer task
+  // flashes and hashes the other (downloadBuffer + pipelineBuffer, same
+  // size). Buffers cycle through two queues, so blocks are flashed and
+  // hashed in download order. Without a second buffer or writer task the
+  // blocks are written inline (previous behaviour).
+  struct PipelineBlock {
+    uint8_t* data;
+    size_t length;
+  };
+  uint8_t* pipelineBuffer;
+  QueueHandle_t filledBlocks;  // Download task -> writer task
+  QueueHandle_t freeBlocks;    // Writer task -> download task
+  TaskHandle_t writerTask;
+  volatile bool writerFailed;  // Set by writer (first flash error)
+  TaskHandle_t pipelineOwner;  // Download task (notified when writer exits)
+  uint8_t* fillBuffer;         // Buffer being filled (nullptr = none)
+  size_t fillLength;
+
+  // v1.3.3: Delta OTA - while deltaPatch is set, downloaded bytes are a
+  // patch that OTADeltaPatch applies against the running partition; the
+  // rebuilt image is what gets flashed and hashed
+  OTADeltaPatch* deltaPatch;
+  const esp_partition_t* deltaSource;
+  size_t deltaBaseSize;
+  size_t deltaTargetSize;
+
   // Private constructor (singleton)
   OTAHttps();
   ~OTAHttps();
@@ -189,6 +223,25 @@ class OTAHttps {
   bool finalizeOTA();
   void abortOTA();
 
+  // v1.3.3: Download/flash pipeline
+  bool startPipeline();
+  void stopPipeline();  // Drops the partial buffer, waits for queued writes
+  uint8_t* acquireFillBuffer();  // nullptr = no buffer came back in time
+  bool submitFillBuffer();       // Hand the filled buffer to the writer
+  // Wait until every submitted block is written (keepPartial = submit the
+  // partially filled buffer first, else drop it). false = write failed
+  bool drainPipeline(bool keepPartial);
+  static void pipelineWriterTask(void* parameter);
+  bool consumeBlock(const uint8_t* data, size_t len);  // Flash (or patch)
+
+  // v1.3.3: Delta OTA
+  bool downloadDelta(const FirmwareManifest& manifest,
+                     ValidationResult& result);
+  bool verifyDeltaBase(const esp_partition_t* running,
+                       const FirmwareManifest& manifest);
+  bool beginDeltaPatch();
+  static bool writeImageData(void* context, const uint8_t* data, size_t len);
+
   // v2.5.15: Progress display (dev mode only)
   void printProgressBar(uint8_t percent, size_t downloaded, size_t total,
                         uint32_t speed);
@@ -289,6 +342,10 @@ class OTAHttps {
 
   /**
    * @brief Download firmware from manifest
+   *
+   * v1.3.3: Uses the manifest's delta patch when it was made against the
+   * running image, and falls back to the full image if the patch fails.
+   *
    * @param manifest Firmware manifest
    * @param result Output validation result
    * @return true if download and validation successful
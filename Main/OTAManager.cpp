@@ -18,6 +18,7 @@
 #include "DebugConfig.h"  // MUST BE FIRST
 #include "JsonDocumentPSRAM.h"
 #include "OTAHttps.h"  // v2.5.35: Include here instead of in header (ESP_SSLClient fix)
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 // Singleton instance
 OTAManager* OTAManager::instance = nullptr;
@@ -1009,14 +1010,11 @@ void OTAManager::process() {
 
         // Launch async check task
         checkTaskRunning = true;
-        BaseType_t result = xTaskCreatePinnedToCore(
+        // Low priority, core 0 (same as network tasks) - TaskAffinity.h
+        BaseType_t result = TaskAffinity::create(
             checkTaskFunction, "OTA_CHECK",
             12288,  // Stack size 12KB for SSL/HTTPS operations (v2.5.30)
-            this,
-            1,  // Low priority - doesn't block critical tasks
-            &checkTaskHandle,
-            0  // Core 0 (same as network tasks)
-        );
+            this, TaskAffinity::Task::OTA_CHECK, &checkTaskHandle);
 
         if (result != pdPASS) {
           LOG_OTA_ERROR("[OTA] Failed to create async check task\n");
@@ -23,10 +23,54 @@
  *   if (deviceId == "D7A3F2") { ... }
  */
 class PSRAMString {
+ public:
+  // v1.3.3: Small-string buffer. Previous: every string, even an empty one,
+  // took a 16-byte heap block. New: up to INLINE_CAPACITY characters are kept
+  // in the object itself (device IDs, short log and status strings); only
+  // longer strings are allocated in PSRAM.
+  static constexpr size_t INLINE_CAPACITY = 15;
+
  private:
-  char* buffer;
+  char* buffer;  // inlineBuffer or a heap block, never nullptr
   size_t len;
   size_t capacity;
+  char inlineBuffer[INLINE_CAPACITY + 1];
+
+  bool isInline() const { return buffer == inlineBuffer; }
+
+  void resetInline() {
+    buffer = inlineBuffer;
+    inlineBuffer[0] = '\0';
+    len = 0;
+    capacity = INLINE_CAPACITY;
+  }
+
+  // Take other's text, leaving other empty (inline text is copied)
+  void takeFrom(PSRAMString& other) {
+    if (other.isInline()) {
+      memcpy(inlineBuffer, other.inlineBuffer, other.len + 1);
+      buffer = inlineBuffer;
+      capacity = INLINE_CAPACITY;
+    } else {
+      buffer = other.buffer;
+      capacity = other.capacity;
+    }
+    len = other.len;
+    other.resetInline();
+  }
+
+  // Replace the text; an allocation failure leaves the string empty
+  void assign(const char* str, size_t strLen) {
+    len = 0;  // reserve() then copies nothing of the old text
+    reserve(strLen);
+    if (capacity < strLen) {
+      buffer[0] = '\0';
+      return;
+    }
+    memmove(buffer, str, strLen);
+    buffer[strLen] = '\0';
+    len = strLen;
+  }
 
   // Allocate buffer in PSRAM with DRAM fallback
   char* allocate(size_t size) {
@@ -63,14 +107,10 @@ class PSRAMString {
     }
 
     // Copy existing data
-    if (buffer && len > 0) {
-      memcpy(newBuffer, buffer, len + 1);
-    } else {
-      newBuffer[0] = '\0';
-    }
+    memcpy(newBuffer, buffer, len + 1);
 
     // Free old buffer
-    if (buffer) {
+    if (!isInline()) {
       heap_caps_free(buffer);
     }
 
@@ -79,65 +119,45 @@ class PSRAMString {
   }
 
  public:
-  // Constructor - empty string
-  PSRAMString() : buffer(nullptr), len(0), capacity(0) {
-    reserve(16);  // Default 16 bytes
-  }
+  // Constructor - empty string (inline, no allocation)
+  PSRAMString() { resetInline(); }
 
   // Constructor - from C string
-  PSRAMString(const char* str) : buffer(nullptr), len(0), capacity(0) {
+  PSRAMString(const char* str) {
+    resetInline();
     if (str) {
-      len = strlen(str);
-      reserve(len);
-      if (buffer) {
-        strcpy(buffer, str);
-      }
-    } else {
-      reserve(16);
+      assign(str, strlen(str));
     }
   }
 
   // Constructor - from Arduino String
-  PSRAMString(const String& str) : buffer(nullptr), len(0), capacity(0) {
-    len = str.length();
-    reserve(len);
-    if (buffer) {
-      strcpy(buffer, str.c_str());
-    }
+  PSRAMString(const String& str) {
+    resetInline();
+    assign(str.c_str(), str.length());
   }
 
   // Copy constructor
-  PSRAMString(const PSRAMString& other) : buffer(nullptr), len(0), capacity(0) {
-    len = other.len;
-    reserve(len);
-    if (buffer && other.buffer) {
-      strcpy(buffer, other.buffer);
-    }
+  PSRAMString(const PSRAMString& other) {
+    resetInline();
+    assign(other.buffer, other.len);
   }
 
   // Move constructor
-  PSRAMString(PSRAMString&& other) noexcept
-      : buffer(other.buffer), len(other.len), capacity(other.capacity) {
-    other.buffer = nullptr;
-    other.len = 0;
-    other.capacity = 0;
-  }
+  PSRAMString(PSRAMString&& other) noexcept { takeFrom(other); }
 
   // Destructor
   ~PSRAMString() {
-    if (buffer) {
+    if (!isInline()) {
       heap_caps_free(buffer);
     }
   }
 
   // Assignment operators
+  // v1.3.3: Through assign(), which sets the length after reserve() (was: new
+  // length first, reserve() then read past a shorter old buffer)
   PSRAMString& operator=(const char* str) {
     if (str) {
-      len = strlen(str);
-      reserve(len);
-      if (buffer) {
-        strcpy(buffer, str);
-      }
+      assign(str, strlen(str));
     } else {
       clear();
     }
@@ -145,51 +165,37 @@ class PSRAMString {
   }
 
   PSRAMString& operator=(const String& str) {
-    len = str.length();
-    reserve(len);
-    if (buffer) {
-      strcpy(buffer, str.c_str());
-    }
+    assign(str.c_str(), str.length());
     return *this;
   }
 
   PSRAMString& operator=(const PSRAMString& other) {
     if (this != &other) {
-      len = other.len;
-      reserve(len);
-      if (buffer && other.buffer) {
-        strcpy(buffer, other.buffer);
-      }
+      assign(other.buffer, other.len);
     }
     return *this;
   }
 
   PSRAMString& operator=(PSRAMString&& other) noexcept {
     if (this != &other) {
-      if (buffer) {
+      if (!isInline()) {
         heap_caps_free(buffer);
       }
-      buffer = other.buffer;
-      len = other.len;
-      capacity = other.capacity;
-      other.buffer = nullptr;
-      other.len = 0;
-      other.capacity = 0;
+      takeFrom(other);
     }
     return *this;
   }
 
   // Comparison operators
   bool operator==(const char* str) const {
-    if (!buffer || !str) return false;
+    if (!str) return false;
     return strcmp(buffer, str) == 0;
   }
 
   bool operator==(const String& str) const { return operator==(str.c_str()); }
 
   bool operator==(const PSRAMString& other) const {
-    if (!buffer || !other.buffer) return false;
-    return strcmp(buffer, other.buffer) == 0;
+    return len == other.len && memcmp(buffer, other.buffer, len) == 0;
   }
 
   bool operator!=(const char* str) const { return !operator==(str); }
@@ -203,8 +209,8 @@ class PSRAMString {
     if (str) {
       size_t addLen = strlen(str);
       reserve(len + addLen);
-      if (buffer) {
-        strcat(buffer, str);
+      if (capacity >= len + addLen) {
+        memcpy(buffer + len, str, addLen + 1);
         len += addLen;
       }
     }
@@ -214,10 +220,7 @@ class PSRAMString {
   PSRAMString& operator+=(const String& str) { return operator+=(str.c_str()); }
 
   PSRAMString& operator+=(const PSRAMString& other) {
-    if (other.buffer) {
-      return operator+=(other.buffer);
-    }
-    return *this;
+    return operator+=(other.buffer);
   }
 
   PSRAMString operator+(const char* str) const {
@@ -237,28 +240,26 @@ class PSRAMString {
   }
 
   // Arduino String compatibility methods
-  const char* c_str() const { return buffer ? buffer : ""; }
+  const char* c_str() const { return buffer; }
 
   size_t length() const { return len; }
 
   bool isEmpty() const { return len == 0; }
 
   void clear() {
-    if (buffer) {
-      buffer[0] = '\0';
-    }
+    buffer[0] = '\0';
     len = 0;
   }
 
   // Convert to Arduino String (for legacy code compatibility)
-  String toString() const { return String(buffer ? buffer : ""); }
+  String toString() const { return String(buffer); }
 
   // Implicit conversion to const char* (for printf, Serial.print, etc.)
   operator const char*() const { return c_str(); }
 
   // Indexing operator
   char operator[](size_t index) const {
-    if (buffer && index < len) {
+    if (index < len) {
       return buffer[index];
     }
     return '\0';
@@ -268,7 +269,7 @@ class PSRAMString {
   // FIXED: Replaced alloca() with heap allocation to prevent stack overflow
   // alloca() allocates from stack - dangerous for long strings (>4KB can crash)
   PSRAMString substring(size_t start, size_t end = 0) const {
-    if (!buffer || start >= len) {
+    if (start >= len) {
       return PSRAMString();
     }
     if (end == 0 || end > len) {
@@ -300,14 +301,14 @@ class PSRAMString {
 
   // Find
   int indexOf(const char* str) const {
-    if (!buffer || !str) return -1;
+    if (!str) return -1;
     char* pos = strstr(buffer, str);
     return pos ? (pos - buffer) : -1;
   }
 
   // Memory diagnostics
   bool isInPSRAM() const {
-    if (!buffer) return false;
+    if (isInline()) return false;  // Lives wherever the object lives
     // Check if pointer is in PSRAM address range (ESP32-S3 specific)
     // PSRAM starts at 0x3C000000 for ESP32-S3
     uintptr_t addr = (uintptr_t)buffer;
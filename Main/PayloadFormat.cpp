@@ -0,0 +1,199 @@
+#include "PayloadFormat.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Print that only counts bytes (measurePayload for CBOR)
+class CountingPrint : public Print {
+ public:
+  size_t write(uint8_t) override {
+    count++;
+    return 1;
+  }
+  size_t write(const uint8_t*, size_t size) override {
+    count += size;
+    return size;
+  }
+  size_t count = 0;
+};
+
+// Print into a fixed buffer (stops at capacity)
+class BufferPrint : public Print {
+ public:
+  BufferPrint(uint8_t* buffer, size_t capacity)
+      : buffer(buffer), capacity(capacity) {}
+
+  size_t write(uint8_t byte) override { return write(&byte, 1); }
+  size_t write(const uint8_t* data, size_t size) override {
+    size_t room = std::min(size, capacity - used);
+    memcpy(buffer + used, data, room);
+    used += room;
+    return room;
+  }
+
+ private:
+  uint8_t* buffer;
+  size_t capacity;
+  size_t used = 0;
+};
+
+// Initial byte + big-endian argument (RFC 8949 section 3)
+size_t writeCborHead(Print& out, uint8_t major, uint64_t value) {
+  uint8_t head[9];
+  size_t argBytes;
+  head[0] = major << 5;
+  if (value < 24) {
+    head[0] |= (uint8_t)value;
+    argBytes = 0;
+  } else if (value <= 0xFF) {
+    head[0] |= 24;
+    argBytes = 1;
+  } else if (value <= 0xFFFF) {
+    head[0] |= 25;
+    argBytes = 2;
+  } else if (value <= 0xFFFFFFFFULL) {
+    head[0] |= 26;
+    argBytes = 4;
+  } else {
+    head[0] |= 27;
+    argBytes = 8;
+  }
+  for (size_t i = 0; i < argBytes; i++) {
+    head[argBytes - i] = (uint8_t)(value >> (8 * i));
+  }
+  return out.write(head, 1 + argBytes);
+}
+
+size_t writeCborString(Print& out, uint8_t major, JsonString str) {
+  size_t n = writeCborHead(out, major, str.size());
+  return n + out.write(reinterpret_cast<const uint8_t*>(str.c_str()),
+                       str.size());
+}
+
+size_t writeCbor(Print& out, JsonVariantConst value) {
+  if (value.is<JsonObjectConst>()) {
+    JsonObjectConst object = value.as<JsonObjectConst>();
+    size_t n = writeCborHead(out, 5, object.size());
+    for (JsonPairConst kv : object) {
+      n += writeCborString(out, 3, kv.key());
+      n += writeCbor(out, kv.value());
+    }
+    return n;
+  }
+  if (value.is<JsonArrayConst>()) {
+    JsonArrayConst array = value.as<JsonArrayConst>();
+    size_t n = writeCborHead(out, 4, array.size());
+    for (JsonVariantConst element : array) {
+      n += writeCbor(out, element);
+    }
+    return n;
+  }
+  if (value.is<const char*>()) {
+    return writeCborString(out, 3, value.as<JsonString>());
+  }
+  if (value.is<bool>()) {
+    return out.write(value.as<bool>() ? 0xF5 : 0xF4);
+  }
+  if (value.is<int64_t>()) {
+    int64_t number = value.as<int64_t>();
+    return number >= 0 ? writeCborHead(out, 0, (uint64_t)number)
+                       : writeCborHead(out, 1, (uint64_t)(-(number + 1)));
+  }
+  if (value.is<uint64_t>()) {
+    return writeCborHead(out, 0, value.as<uint64_t>());
+  }
+  if (value.is<double>()) {
+    // float32 when it round-trips (most register values), else float64
+    double number = value.as<double>();
+    float single = (float)number;
+    uint8_t bytes[9];
+    size_t length;
+    if ((double)single == number || std::isnan(number)) {
+      uint32_t bits;
+      memcpy(&bits, &single, sizeof(bits));
+      bytes[0] = 0xFA;
+      for (int i = 0; i < 4; i++) bytes[4 - i] = (uint8_t)(bits >> (8 * i));
+      length = 5;
+    } else {
+      uint64_t bits;
+      memcpy(&bits, &number, sizeof(bits));
+      bytes[0] = 0xFB;
+      for (int i = 0; i < 8; i++) bytes[8 - i] = (uint8_t)(bits >> (8 * i));
+      length = 9;
+    }
+    return out.write(bytes, length);
+  }
+  return out.write(0xF6);  // null (and unsupported raw values)
+}
+
+}  // namespace
+
+bool parsePayloadFormat(const char* name, PayloadFormat& format) {
+  if (!name) return false;
+  if (strcasecmp(name, "json") == 0) {
+    format = PayloadFormat::JSON;
+  } else if (strcasecmp(name, "msgpack") == 0) {
+    format = PayloadFormat::MSGPACK;
+  } else if (strcasecmp(name, "cbor") == 0) {
+    format = PayloadFormat::CBOR;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char* payloadFormatName(PayloadFormat format) {
+  switch (format) {
+    case PayloadFormat::MSGPACK:
+      return "msgpack";
+    case PayloadFormat::CBOR:
+      return "cbor";
+    default:
+      return "json";
+  }
+}
+
+const char* payloadContentType(PayloadFormat format) {
+  switch (format) {
+    case PayloadFormat::MSGPACK:
+      return "application/msgpack";
+    case PayloadFormat::CBOR:
+      return "application/cbor";
+    default:
+      return "application/json";
+  }
+}
+
+size_t measurePayload(JsonVariantConst doc, PayloadFormat format) {
+  switch (format) {
+    case PayloadFormat::MSGPACK:
+      return measureMsgPack(doc);
+    case PayloadFormat::CBOR: {
+      CountingPrint counter;
+      writeCbor(counter, doc);
+      return counter.count;
+    }
+    default:
+      return measureJson(doc);
+  }
+}
+
+size_t serializePayload(JsonVariantConst doc, PayloadFormat format,
+                        Print& out) {
+  switch (format) {
+    case PayloadFormat::MSGPACK:
+      return serializeMsgPack(doc, out);
+    case PayloadFormat::CBOR:
+      return writeCbor(out, doc);
+    default:
+      return serializeJson(doc, out);
+  }
+}
+
+size_t serializePayload(JsonVariantConst doc, PayloadFormat format,
+                        uint8_t* buffer, size_t capacity) {
+  BufferPrint out(buffer, capacity);
+  return serializePayload(doc, format, out);
+}
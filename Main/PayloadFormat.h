@@ -0,0 +1,47 @@
+#ifndef PAYLOAD_FORMAT_H
+#define PAYLOAD_FORMAT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <cstdint>
+
+/**
+ * PayloadFormat - Uplink payload encodings (MQTT / HTTP)
+ *
+ * v1.3.3: Binary payload option
+ * Text JSON repeats key names in full and prints every float in decimal.
+ * mqtt_config / http_config "payload_format" selects how the same document
+ * is encoded on the wire:
+ *   "json"     UTF-8 JSON (default, unchanged)
+ *   "msgpack"  MessagePack (ArduinoJson serializeMsgPack)
+ *   "cbor"     CBOR, RFC 8949 (definite lengths; floats as float32 when
+ *              lossless, else float64)
+ *
+ * Every function takes the document as JsonVariantConst and writes to a
+ * Print (socket stream) or a buffer, like serializeJson().
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+enum class PayloadFormat : uint8_t { JSON = 0, MSGPACK = 1, CBOR = 2 };
+
+/**
+ * Parse a payload_format value (case-insensitive)
+ * @return false if the name is unknown (format is left unchanged)
+ */
+bool parsePayloadFormat(const char* name, PayloadFormat& format);
+
+const char* payloadFormatName(PayloadFormat format);
+const char* payloadContentType(PayloadFormat format);  // HTTP Content-Type
+
+// Exact encoded size in bytes (like measureJson)
+size_t measurePayload(JsonVariantConst doc, PayloadFormat format);
+
+// Encode doc; returns bytes written (like serializeJson)
+size_t serializePayload(JsonVariantConst doc, PayloadFormat format,
+                        Print& out);
+size_t serializePayload(JsonVariantConst doc, PayloadFormat format,
+                        uint8_t* buffer, size_t capacity);
+
+#endif  // PAYLOAD_FORMAT_H
@@ -0,0 +1,142 @@
+#include "PollScheduler.h"
+
+// ============================================================================
+// v1.3.3: DEADLINE-ORDERED POLL SCHEDULE (binary min-heap)
+// ============================================================================
+
+void PollScheduler::schedule(uint16_t index, uint32_t dueMs, uint16_t rank) {
+  heap.push_back({dueMs, index, rank});
+  siftUp(heap.size() - 1);
+}
+
+bool PollScheduler::peekDue(uint32_t nowMs, PollSlot& slot) const {
+  if (heap.empty() || !isDue(heap[0].dueMs, nowMs)) {
+    return false;
+  }
+  slot = heap[0];
+  return true;
+}
+
+bool PollScheduler::popDue(uint32_t nowMs, PollSlot& slot) {
+  if (!peekDue(nowMs, slot)) {
+    return false;
+  }
+  heap[0] = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    siftDown(0);
+  }
+  return true;
+}
+
+uint32_t PollScheduler::waitTime(uint32_t nowMs, uint32_t maxWaitMs) const {
+  if (heap.empty()) {
+    return maxWaitMs;
+  }
+  if (isDue(heap[0].dueMs, nowMs)) {
+    return 0;
+  }
+  uint32_t wait = heap[0].dueMs - nowMs;
+  return (wait < maxWaitMs) ? wait : maxWaitMs;
+}
+
+uint32_t PollScheduler::nextDeadline(uint32_t dueMs, uint32_t intervalMs,
+                                     uint32_t nowMs) {
+  uint32_t next = dueMs + intervalMs;
+  if (isDue(next, nowMs)) {
+    return nowMs;  // Missed - realign instead of bursting to catch up
+  }
+  return next;
+}
+
+void PollScheduler::siftUp(size_t pos) {
+  PollSlot slot = heap[pos];
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (!earlier(slot, heap[parent])) break;
+    heap[pos] = heap[parent];
+    pos = parent;
+  }
+  heap[pos] = slot;
+}
+
+void PollScheduler::siftDown(size_t pos) {
+  size_t count = heap.size();
+  PollSlot slot = heap[pos];
+  while (true) {
+    size_t child = pos * 2 + 1;
+    if (child >= count) break;
+    if (child + 1 < count && earlier(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if (!earlier(heap[child], slot)) break;
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  heap[pos] = slot;
+}
+
+// ============================================================================
+// v1.3.3: BUS UTILIZATION / ADAPTIVE REFRESH
+// ============================================================================
+
+void BusUtilization::roll(uint32_t nowMs) {
+  if (windowStartMs == 0) {
+    windowStartMs = nowMs ? nowMs : 1;
+    return;
+  }
+  uint32_t elapsedMs = nowMs - windowStartMs;
+  if (elapsedMs < WINDOW_MS) {
+    return;
+  }
+  // Idle windows in between are averaged in (busyUs / elapsed)
+  uint32_t share = busyUs / (elapsedMs * 10);
+  percent = share > 100 ? 100 : (uint8_t)share;
+  busyUs = 0;
+  windowStartMs = nowMs ? nowMs : 1;
+}
+
+void AdaptiveRefresh::configure(bool enabled, uint32_t baseMs, uint32_t minMs,
+                                uint32_t maxMs) {
+  this->enabled = enabled;
+  uint32_t base = baseMs > MIN_INTERVAL_MS ? baseMs : MIN_INTERVAL_MS;
+  this->minMs = minMs > 0 ? minMs : base / 4;
+  this->maxMs = maxMs > 0 ? maxMs : base * 4;
+  if (this->minMs < MIN_INTERVAL_MS) this->minMs = MIN_INTERVAL_MS;
+  if (this->minMs > base) this->minMs = base;
+  if (this->maxMs < base) this->maxMs = base;
+  intervalMs = base;
+  signature = 0;
+  hasSignature = false;
+  quietPolls = 0;
+  changePercent = 0;
+}
+
+uint32_t AdaptiveRefresh::update(uint32_t valueSignature, uint8_t busPercent) {
+  bool changed = hasSignature && valueSignature != signature;
+  signature = valueSignature;
+  hasSignature = true;
+  changePercent = (uint8_t)((changePercent * 7 + (changed ? 100 : 0)) / 8);
+
+  if (changed) {
+    quietPolls = 0;
+  } else if (quietPolls < QUIET_POLLS) {
+    quietPolls++;
+  }
+
+  uint32_t next = intervalMs;
+  if (busPercent >= BUS_SATURATED_PERCENT) {
+    next += next / 4;  // Overloaded bus: everyone backs off
+  } else if (changed) {
+    if (busPercent < BUS_BUSY_PERCENT) {
+      next /= 2;
+    }
+  } else if (quietPolls >= QUIET_POLLS) {
+    next += (busPercent >= BUS_BUSY_PERCENT) ? next / 2 : next / 4;
+  }
+
+  if (next < minMs) next = minMs;
+  if (next > maxMs) next = maxMs;
+  intervalMs = next;
+  return intervalMs;
+}
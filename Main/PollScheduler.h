@@ -0,0 +1,171 @@
+#ifndef POLL_SCHEDULER_H
+#define POLL_SCHEDULER_H
+
+#include <Arduino.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * PollScheduler - Deadline-ordered device poll schedule
+ *
+ * v1.3.3: Replaces the per-service DeviceTimer list
+ * Previous: Each polling task walked every device every 100-150ms and called
+ * shouldPollDevice(), a linear strcmp() scan over deviceTimers (O(n^2) per
+ * pass). A device became due at most one loop delay late (refresh jitter up
+ * to 150ms) and its interval was measured from the end of the last read
+ * (drift).
+ * New: A binary min-heap of {deadline, device index}. The task pops only due
+ * devices (O(log n)) and sleeps exactly until the earliest deadline.
+ * Deadlines advance by the refresh interval from the previous deadline, so
+ * the poll rate does not drift with read duration.
+ *
+ * Deadlines are millis() values compared with wraparound-safe arithmetic
+ * (valid for intervals < 24 days).
+ *
+ * Not thread-safe: each schedule is owned by one polling task (and rebuilt
+ * by refreshDeviceList() while that task is outside its pass).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+struct PollSlot {
+  uint32_t dueMs;  // millis() deadline
+  uint16_t index;  // Index into the owner's device vector
+  uint16_t rank;   // v1.3.3: Tie-break of equal deadlines (last read ms)
+};
+
+class PollScheduler {
+ public:
+  static constexpr uint32_t NO_DEADLINE = 0xFFFFFFFF;
+
+  void clear() { heap.clear(); }
+  void reserve(size_t devices) { heap.reserve(devices); }
+  bool empty() const { return heap.empty(); }
+  size_t size() const { return heap.size(); }
+
+  /**
+   * Add a device (or put a popped one back). Devices due at the same time
+   * are popped in ascending rank (fastest read first: aligned cycles).
+   */
+  void schedule(uint16_t index, uint32_t dueMs, uint16_t rank = 0);
+
+  /**
+   * Earliest entry if it is due at nowMs (left in the schedule)
+   */
+  bool peekDue(uint32_t nowMs, PollSlot& slot) const;
+
+  /**
+   * Remove and return the earliest entry if it is due at nowMs
+   */
+  bool popDue(uint32_t nowMs, PollSlot& slot);
+
+  /**
+   * Milliseconds until the earliest deadline (0 = due now), capped at
+   * maxWaitMs. Empty schedule = maxWaitMs.
+   */
+  uint32_t waitTime(uint32_t nowMs, uint32_t maxWaitMs) const;
+
+  /**
+   * Deadline after a poll that was due at dueMs: one interval later. If that
+   * is already in the past (read slower than the interval, paused for BLE)
+   * the device is due once more at nowMs, then continues from there.
+   */
+  static uint32_t nextDeadline(uint32_t dueMs, uint32_t intervalMs,
+                               uint32_t nowMs);
+
+  static bool isDue(uint32_t dueMs, uint32_t nowMs) {
+    return (int32_t)(nowMs - dueMs) >= 0;
+  }
+
+ private:
+  std::vector<PollSlot> heap;  // heap[0] = earliest deadline
+
+  static bool earlier(const PollSlot& a, const PollSlot& b) {
+    int32_t diff = (int32_t)(a.dueMs - b.dueMs);
+    return diff < 0 || (diff == 0 && a.rank < b.rank);
+  }
+  void siftUp(size_t pos);
+  void siftDown(size_t pos);
+};
+
+/**
+ * BusUtilization - Share of time a bus spends in transactions
+ *
+ * v1.3.3: Fed by the bus worker with the duration of each transaction
+ * (inter-frame silence, request, response or timeout). Reports the busy
+ * share of the last complete window; a window without transactions reads 0.
+ * Owned by one bus worker (not thread-safe).
+ */
+struct BusUtilization {
+  static constexpr uint32_t WINDOW_MS = 10000;
+
+  uint32_t windowStartMs = 0;
+  uint32_t busyUs = 0;   // Transactions in the open window
+  uint8_t percent = 0;   // Last complete window
+
+  void record(uint32_t transactionUs, uint32_t nowMs) {
+    roll(nowMs);
+    busyUs += transactionUs;
+  }
+
+  uint8_t percentAt(uint32_t nowMs) {
+    roll(nowMs);
+    return percent;
+  }
+
+ private:
+  void roll(uint32_t nowMs);
+};
+
+/**
+ * AdaptiveRefresh - Per-device poll interval from value changes and bus load
+ *
+ * v1.3.3: Device "adaptive_refresh": true
+ * Previous: every device was polled at its fixed refresh_rate_ms, set for the
+ * worst case, so static devices used bus time that dynamic devices on the
+ * same bus needed.
+ * New: after each successful poll the interval moves within
+ * [refresh_rate_min_ms, refresh_rate_max_ms]:
+ * - Values changed since the previous poll: halved (bus below
+ *   BUS_BUSY_PERCENT), kept otherwise
+ * - QUIET_POLLS polls in a row without a change: +25% (+50% while the bus is
+ *   busy)
+ * - Bus at or above BUS_SATURATED_PERCENT: +25% for every device, changed or
+ *   not, until the load drops
+ * Changes are detected on the raw words of the registers read (see
+ * ModbusPollPlan::valueSignature), so a noisy register keeps its device fast;
+ * deadbands do not slow polling down.
+ */
+struct AdaptiveRefresh {
+  static constexpr uint32_t MIN_INTERVAL_MS = 100;
+  static constexpr uint8_t QUIET_POLLS = 3;
+  static constexpr uint8_t BUS_BUSY_PERCENT = 70;
+  static constexpr uint8_t BUS_SATURATED_PERCENT = 90;
+
+  bool enabled = false;
+  uint32_t minMs = 0;
+  uint32_t maxMs = 0;
+  uint32_t intervalMs = 0;  // Current interval (refresh_rate_ms at start)
+  uint32_t signature = 0;   // Values of the previous poll
+  bool hasSignature = false;
+  uint8_t quietPolls = 0;
+  uint8_t changePercent = 0;  // Moving share of polls with a change (status)
+
+  /**
+   * Bounds and start interval (compile; a kept plan keeps its state)
+   * @param minMs 0 = baseMs / 4, maxMs 0 = baseMs * 4
+   */
+  void configure(bool enabled, uint32_t baseMs, uint32_t minMs,
+                 uint32_t maxMs);
+
+  /**
+   * Next interval after a successful poll
+   * @param valueSignature Hash of the values read
+   * @param busPercent BusUtilization of the device's bus (0 = unknown)
+   */
+  uint32_t update(uint32_t valueSignature, uint8_t busPercent);
+};
+
+#endif  // POLL_SCHEDULER_H
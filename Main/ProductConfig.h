@@ -35,14 +35,14 @@
 // Format: MAJOR.MINOR.PATCH
 // Update this for every release
 
-#define FIRMWARE_VERSION "1.3.2"
+#define FIRMWARE_VERSION "1.3.3"
 #define FIRMWARE_VERSION_MAJOR 1
 #define FIRMWARE_VERSION_MINOR 3
-#define FIRMWARE_VERSION_PATCH 2
+#define FIRMWARE_VERSION_PATCH 3
 
-// Build number: Derived from version (1.3.2 = 132)
+// Build number: Derived from version (1.3.3 = 133)
 // Used for OTA version comparison
-#define FIRMWARE_BUILD_NUMBER 132
+#define FIRMWARE_BUILD_NUMBER 133
 
 // ============================================================================
 // PRODUCT MODEL & VARIANT
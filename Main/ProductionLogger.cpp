@@ -1,6 +1,7 @@
 #include "ProductionLogger.h"
 
 #include "RTCManager.h"
+#include "TaskProfiler.h"  // v1.3.3: Heartbeat profile summary
 
 // Static instance
 ProductionLogger* ProductionLogger::instance = nullptr;
@@ -39,6 +40,9 @@ ProductionLogger::ProductionLogger()
       modbusSuccessCount(0),
       networkReconnectCount(0),
       protocolReconnectCount(0),
+      rtuBusUtilization(0),
+      tcpEndpointUtilization(0),
+      missedDeadlineCount(0),
       currentNetStatus(NetStatus::NONE),
       mqttStatus(ProtoStatus::OFF),
       httpStatus(ProtoStatus::OFF),
@@ -231,24 +235,50 @@ void ProductionLogger::heartbeat() {
       protoStat = protoStatusStr(httpStatus);
     }
 
+    // v1.3.3: Compact task profiler summary (empty until the first sample)
+    TaskProfiler::Summary prof;
+    TaskProfiler::getInstance()->getSummary(prof);
+    char profText[112] = "";
+    if (prof.valid && jsonFormat) {
+      snprintf(profText, sizeof(profText),
+               ",\"prof\":{\"cpu\":[%u,%u],\"top\":\"%s\",\"topc\":%u,"
+               "\"stk\":\"%s\",\"stkb\":%lu,\"q\":%u}",
+               prof.coreLoad[0], prof.coreLoad[1], prof.topTask,
+               prof.topTaskCpu, prof.lowStackTask,
+               (unsigned long)prof.lowStackBytes, prof.queueDepth);
+    } else if (prof.valid) {
+      snprintf(profText, sizeof(profText),
+               " CPU:%u/%u TOP:%s(%u%%) STK:%s(%lu) Q:%u", prof.coreLoad[0],
+               prof.coreLoad[1], prof.topTask, prof.topTaskCpu,
+               prof.lowStackTask, (unsigned long)prof.lowStackBytes,
+               prof.queueDepth);
+    }
+
     if (jsonFormat) {
       // Compact JSON format for easy parsing
-      // {"ts":"2025-11-26T07:40:06","t":"HB","up":3600,"mem":{"d":150000,"p":7500000},"net":"ETH","proto":"mqtt","st":"OK","err":0,"mb":{"ok":100,"er":2}}
+      // {"ts":"2025-11-26T07:40:06","t":"HB","up":3600,"mem":{"d":150000,"p":7500000},"net":"ETH","proto":"mqtt","st":"OK","err":0,"mb":{"ok":100,"er":2,"bus":[40,75],"miss":3}}
+      // v1.3.3: mb.bus = busiest RTU bus / TCP endpoint (%), mb.miss =
+      // polls that ended after their next deadline
       Serial.printf(
           "{\"ts\":\"%s\",\"t\":\"HB\",\"up\":%lu,\"mem\":{\"d\":%d,\"p\":%d},"
           "\"net\":\"%s\",\"proto\":\"%s\",\"st\":\"%s\",\"err\":%lu,\"mb\":{"
-          "\"ok\":%lu,\"er\":%lu}}\n",
+          "\"ok\":%lu,\"er\":%lu,\"bus\":[%u,%u],\"miss\":%lu}%s}\n",
           getTimestampISO().c_str(), getUptime(), freeDram, freePsram,
           netStatusStr(currentNetStatus), activeProtocol.c_str(), protoStat,
-          errorCount, modbusSuccessCount, modbusErrorCount);
+          errorCount, modbusSuccessCount, modbusErrorCount, rtuBusUtilization,
+          tcpEndpointUtilization, (unsigned long)missedDeadlineCount,
+          profText);
     } else {
       // Human-readable format
       Serial.printf(
-          "[%lu][HB] NET:%s PROTO:%s/%s MEM:D%d/P%d ERR:%lu MB:%lu/%lu\n",
+          "[%lu][HB] NET:%s PROTO:%s/%s MEM:D%d/P%d ERR:%lu MB:%lu/%lu "
+          "BUS:%u/%u%% MISS:%lu%s\n",
           getUptime(), netStatusStr(currentNetStatus), activeProtocol.c_str(),
           protoStat,
           freeDram / 1000,  // KB
-          freePsram / 1000, errorCount, modbusSuccessCount, modbusErrorCount);
+          freePsram / 1000, errorCount, modbusSuccessCount, modbusErrorCount,
+          rtuBusUtilization, tcpEndpointUtilization,
+          (unsigned long)missedDeadlineCount, profText);
     }
     xSemaphoreGive(logMutex);
   }
@@ -325,3 +355,11 @@ void ProductionLogger::logModbusStats(uint32_t success, uint32_t errors) {
   modbusSuccessCount = success;
   modbusErrorCount = errors;
 }
+
+void ProductionLogger::logModbusCapacity(uint8_t rtuUtilization,
+                                         uint8_t tcpUtilization,
+                                         uint32_t missedDeadlines) {
+  rtuBusUtilization = rtuUtilization;
+  tcpEndpointUtilization = tcpUtilization;
+  missedDeadlineCount = missedDeadlines;
+}
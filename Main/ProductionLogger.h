@@ -27,6 +27,8 @@
  * - mem.p: Free PSRAM bytes
  * - net: Network type (ETH/WIFI/NONE)
  * - mqtt/http: Protocol status (OK/ERR/OFF)
+ * - mb.bus: Busiest RTU bus / TCP endpoint utilization % (v1.3.3)
+ * - mb.miss: Device polls that ended after their next deadline (v1.3.3)
  */
 
 // Production log types
@@ -65,6 +67,11 @@ class ProductionLogger {
   uint32_t modbusSuccessCount;
   uint32_t networkReconnectCount;
   uint32_t protocolReconnectCount;
+  // v1.3.3: Modbus capacity (busiest RTU bus / TCP endpoint, missed
+  // deadlines of all devices)
+  uint8_t rtuBusUtilization;
+  uint8_t tcpEndpointUtilization;
+  uint32_t missedDeadlineCount;
 
   // Current state
   NetStatus currentNetStatus;
@@ -108,6 +115,8 @@ class ProductionLogger {
   void logSystem(const char* event,
                  const char* detail = nullptr);            // System events
   void logModbusStats(uint32_t success, uint32_t errors);  // Modbus summary
+  void logModbusCapacity(uint8_t rtuUtilization, uint8_t tcpUtilization,
+                         uint32_t missedDeadlines);  // v1.3.3
 
   // Statistics
   uint32_t getUptime();
@@ -3,14 +3,14 @@
 #include <esp_heap_caps.h>
 
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+#include "ModbusPollPlan.h"  // v1.3.3: PollPlanRegistry (record resolution)
 
 QueueManager* QueueManager::instance = nullptr;
 
 QueueManager::QueueManager()
-    : dataQueue(nullptr),
-      streamQueue(nullptr),
-      queueMutex(nullptr),
-      streamMutex(nullptr) {}
+    : dataRing(nullptr), dataCapacity(0), dataMask(0), streamMutex(nullptr) {
+  streamDeviceId[0] = '\0';
+}
 
 QueueManager* QueueManager::getInstance() {
   // Thread-safe Meyers Singleton (C++11 guarantees thread-safe static init)
@@ -20,304 +20,382 @@ QueueManager* QueueManager::getInstance() {
 }
 
 bool QueueManager::init() {
-  // Create FreeRTOS queue for data points
-  dataQueue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(char*));
-  if (dataQueue == nullptr) {
+  // v1.3.3: Preallocate record ring in PSRAM (no per-item allocation)
+  dataRing = (RingSlot*)heap_caps_calloc(MAX_QUEUE_SIZE, sizeof(RingSlot),
+                                         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  dataCapacity = MAX_QUEUE_SIZE;
+  if (dataRing == nullptr) {
+    // PSRAM unavailable - smaller ring in DRAM
+    dataRing = (RingSlot*)heap_caps_calloc(FALLBACK_QUEUE_SIZE,
+                                           sizeof(RingSlot), MALLOC_CAP_8BIT);
+    dataCapacity = FALLBACK_QUEUE_SIZE;
+    LOG_QUEUE_WARN("PSRAM ring allocation failed, using %d records in DRAM\n",
+                   FALLBACK_QUEUE_SIZE);
+  }
+  if (dataRing == nullptr) {
+    dataCapacity = 0;
     Serial.println("Failed to create data queue");
     return false;
   }
+  dataMask = dataCapacity - 1;
 
-  // Create mutex for thread safety
-  queueMutex = xSemaphoreCreateMutex();
-  if (queueMutex == nullptr) {
-    Serial.println("Failed to create queue mutex");
-    return false;
-  }
-
-  // Create streaming queue
-  streamQueue = xQueueCreate(MAX_STREAM_QUEUE_SIZE, sizeof(char*));
-  if (streamQueue == nullptr) {
-    Serial.println("Failed to create stream queue");
-    return false;
+  // Stamps two laps back: no reader treats the zeroed records as committed
+  // and oldestSequence() can tell the ring has not wrapped yet
+  for (uint32_t i = 0; i < dataCapacity; i++) {
+    uint32_t stamp = i - 2 * dataCapacity;
+    dataRing[i].claimed.store(stamp, std::memory_order_relaxed);
+    dataRing[i].committed.store(stamp, std::memory_order_relaxed);
   }
+  std::atomic_thread_fence(std::memory_order_release);
 
-  // Create streaming mutex
+  // Create streaming mutex (stream device filter)
   streamMutex = xSemaphoreCreateMutex();
   if (streamMutex == nullptr) {
     Serial.println("Failed to create stream mutex");
     return false;
   }
 
-  LOG_QUEUE_INFO("[QUEUE] Manager initialized");
+  LOG_QUEUE_INFO("[QUEUE] Manager initialized (%d records, %d bytes each)\n",
+                 dataCapacity, sizeof(RingSlot));
   return true;
 }
 
-bool QueueManager::enqueue(const JsonObject& dataPoint) {
-  // Serialize JSON to string first, outside the mutex (avoid holding lock
-  // during serialization)
-  String jsonString;
-  serializeJson(dataPoint, jsonString);
+// ============================================================================
+// v1.3.3: LOCK-FREE RING HELPERS
+// ============================================================================
 
-  // Use configurable timeout instead of hardcoded 100ms
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(queueMutexTimeout)) != pdTRUE) {
+bool QueueManager::pushRecord(const QueueRecord& record) {
+  if (dataRing == nullptr || dataCapacity == 0) {
     return false;
   }
 
-  // Check if queue is full
-  if (uxQueueMessagesWaiting(dataQueue) >= MAX_QUEUE_SIZE) {
-    // Remove oldest item to make space
-    char* oldItem;
-    if (xQueueReceive(dataQueue, &oldItem, 0) == pdTRUE) {
-      heap_caps_free(oldItem);  // FIXED: Use heap_caps_free instead of free
-    }
+  // Claim a sequence (only RMW, on a DRAM member). A full ring simply
+  // overwrites the oldest slot - lapped consumers skip ahead on read.
+  uint32_t seq = writeSeq.fetch_add(1, std::memory_order_acq_rel);
+  RingSlot& slot = dataRing[seq & dataMask];
+
+  slot.claimed.store(seq, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.record = record;
+  slot.committed.store(seq, std::memory_order_release);
+  return true;
+}
+
+uint32_t QueueManager::oldestSequence(uint32_t head) const {
+  // Slot of head holds head - capacity once the ring wrapped; before the
+  // first lap everything since sequence 0 is retained
+  uint32_t firstStamp = dataRing[head & dataMask].committed.load(
+      std::memory_order_acquire);
+  return ((int32_t)(firstStamp - (head - dataCapacity)) >= 0)
+             ? head - dataCapacity
+             : 0;
+}
+
+bool QueueManager::readRecord(QueueConsumer consumer, QueueRecord& record,
+                              bool advance) {
+  if (dataRing == nullptr) {
+    return false;
   }
+  ConsumerCursor& c = cursor(consumer);
 
-  // FIXED BUG #6: Add DRAM fallback if PSRAM allocation fails
-  // Previous code had NO fallback → DATA LOSS when PSRAM exhausted!
-  char* jsonCopy = (char*)heap_caps_malloc(jsonString.length() + 1,
-                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  while (true) {
+    uint32_t seq = c.readSeq.load(std::memory_order_acquire);
+    uint32_t head = writeSeq.load(std::memory_order_acquire);
+    if (seq == head) {
+      return false;  // Caught up
+    }
 
-  if (jsonCopy == nullptr) {
-    // PSRAM exhausted - fallback to DRAM (internal heap)
-    jsonCopy =
-        (char*)heap_caps_malloc(jsonString.length() + 1, MALLOC_CAP_8BIT);
+    if ((uint32_t)(head - seq) > dataCapacity) {
+      // Lapped: oldest records were overwritten. Skip to oldest retained.
+      uint32_t oldest = head - dataCapacity;
+      if (c.readSeq.compare_exchange_strong(seq, oldest)) {
+        c.overflowDropped.fetch_add(oldest - seq, std::memory_order_relaxed);
+      }
+      continue;
+    }
 
-    if (jsonCopy == nullptr) {
-      // Both PSRAM and DRAM exhausted - critical memory shortage
-      xSemaphoreGive(queueMutex);
-      LOG_QUEUE_INFO(
-          "[QUEUE] CRITICAL ERROR: Both PSRAM and DRAM allocation failed!");
-      return false;
-    } else {
-      // Fallback successful - log warning
-      static unsigned long lastWarning = 0;
-      if (millis() - lastWarning > 30000)  // Log max once per 30s to avoid spam
-      {
-        LOG_QUEUE_INFO(
-            "[QUEUE] WARNING: PSRAM exhausted, using DRAM fallback (%d "
-            "bytes)\n",
-            jsonString.length());
-        lastWarning = millis();
+    RingSlot& slot = dataRing[seq & dataMask];
+    uint32_t committed = slot.committed.load(std::memory_order_acquire);
+    if (committed != seq) {
+      if ((int32_t)(committed - seq) < 0) {
+        return false;  // Producer claimed but not finished yet
       }
+      continue;  // Overwritten (lap detected on next iteration)
     }
+
+    record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.claimed.load(std::memory_order_relaxed) != seq) {
+      continue;  // Overwritten while copying
+    }
+
+    if (advance && !c.readSeq.compare_exchange_strong(seq, seq + 1)) {
+      continue;  // Cursor moved by discard()/clear() - re-read
+    }
+    return true;
   }
+}
 
-  // v2.5.36 FIX: Use memcpy instead of strcpy for defensive programming
-  // (explicit bounds)
-  memcpy(jsonCopy, jsonString.c_str(), jsonString.length() + 1);
+uint32_t QueueManager::pending(QueueConsumer consumer) const {
+  const ConsumerCursor& c = cursor(consumer);
+  uint32_t head = writeSeq.load(std::memory_order_acquire);
+  uint32_t count = head - c.readSeq.load(std::memory_order_acquire);
+  return (count > dataCapacity) ? dataCapacity : count;
+}
 
-  // Add to queue
-  bool success = xQueueSend(dataQueue, &jsonCopy, 0) == pdTRUE;
+bool QueueManager::expandRecord(const QueueRecord& record,
+                                JsonObject& dataPoint, bool fixedText) const {
+  switch (record.type) {
+    case QueueRecordType::REGISTER:
+      // Strings resolved from compiled plan at publish time
+      return PollPlanRegistry::getInstance()->resolveRegister(
+          record.deviceSlot, record.generation, record.registerSlot,
+          record.value, record.timestamp, dataPoint, fixedText);
+
+    case QueueRecordType::BATCH_END:
+      if (!PollPlanRegistry::getInstance()->resolveDevice(
+              record.deviceSlot, record.generation, dataPoint)) {
+        return false;
+      }
+      dataPoint["event"] = "BATCH_END";
+      dataPoint["success_count"] = record.batch.successCount;
+      dataPoint["failed_count"] = record.batch.failedCount;
+      dataPoint["timestamp"] = record.timestamp;
+      return true;
 
-  if (!success) {
-    heap_caps_free(jsonCopy);
+    default:
+      return false;
   }
+}
 
-  xSemaphoreGive(queueMutex);
-  return success;
+// ============================================================================
+// PRODUCERS
+// ============================================================================
+
+bool QueueManager::enqueueRegister(uint8_t deviceSlot, uint16_t generation,
+                                   uint16_t registerSlot, double value,
+                                   uint32_t timestamp) {
+  QueueRecord record = {};
+  record.type = QueueRecordType::REGISTER;
+  record.deviceSlot = deviceSlot;
+  record.registerSlot = registerSlot;
+  record.generation = generation;
+  record.timestamp = timestamp;
+  record.value = value;
+  return pushRecord(record);
 }
 
-bool QueueManager::dequeue(JsonObject& dataPoint) {
-  if (dataQueue == nullptr || queueMutex == nullptr) {
-    return false;
-  }
+bool QueueManager::enqueueBatchEnd(uint8_t deviceSlot, uint16_t generation,
+                                   uint16_t successCount,
+                                   uint16_t failedCount) {
+  QueueRecord record = {};
+  record.type = QueueRecordType::BATCH_END;
+  record.deviceSlot = deviceSlot;
+  record.generation = generation;
+  record.timestamp = millis();
+  record.batch.successCount = successCount;
+  record.batch.failedCount = failedCount;
+  return pushRecord(record);
+}
 
-  char* jsonString = nullptr;
-  // Use configurable timeout
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(queueMutexTimeout)) == pdTRUE) {
-    if (xQueueReceive(dataQueue, &jsonString, 0) != pdTRUE) {
-      jsonString = nullptr;
-    }
-    xSemaphoreGive(queueMutex);
-  }
+// ============================================================================
+// CONSUMERS
+// ============================================================================
 
-  if (jsonString == nullptr) {
-    return false;
+void QueueManager::attachConsumer(QueueConsumer consumer) {
+  if (dataRing == nullptr) {
+    return;
   }
+  ConsumerCursor& c = cursor(consumer);
+  if (c.active.load()) {
+    return;
+  }
+  // Start at the oldest retained record (backlog queued before start)
+  c.readSeq.store(oldestSequence(writeSeq.load()));
+  c.active.store(true);
+}
 
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, jsonString);
-  bool success = false;
+void QueueManager::detachConsumer(QueueConsumer consumer) {
+  cursor(consumer).active.store(false);
+}
 
-  if (error == DeserializationError::Ok) {
-    JsonObject obj = doc.as<JsonObject>();
-    for (JsonPair kv : obj) {
-      dataPoint[kv.key()] = kv.value();
+bool QueueManager::dequeue(QueueConsumer consumer, JsonObject& dataPoint) {
+  // Loop skips stale records (device removed or register layout changed)
+  QueueRecord record;
+  while (readRecord(consumer, record, true)) {
+    // Expanded from a private copy: producers are never blocked
+    if (expandRecord(record, dataPoint)) {
+      return true;
     }
-    success = true;
+    staleDropped.fetch_add(1, std::memory_order_relaxed);
   }
-
-  heap_caps_free(jsonString);
-  return success;
+  return false;
 }
 
-bool QueueManager::peek(const JsonObject& dataPoint) const {
-  if (dataQueue == nullptr || queueMutex == nullptr) {
-    return false;
+bool QueueManager::peek(QueueConsumer consumer, JsonObject& dataPoint) {
+  // Stale records at the cursor are consumed (never publishable)
+  QueueRecord record;
+  while (readRecord(consumer, record, false)) {
+    if (expandRecord(record, dataPoint)) {
+      return true;
+    }
+    staleDropped.fetch_add(1, std::memory_order_relaxed);
+    readRecord(consumer, record, true);
   }
+  return false;
+}
 
-  // Use configurable timeout (queueMutex is mutable, no const_cast needed)
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(queueMutexTimeout)) != pdTRUE) {
-    return false;
+int QueueManager::peekBatch(QueueConsumer consumer, JsonArray& dataPoints,
+                            int maxPoints, QueueBatch& batch,
+                            bool fixedText) {
+  batch = QueueBatch();
+  if (dataRing == nullptr || maxPoints <= 0) {
+    return 0;
   }
-
-  char* jsonString;
-  bool success = false;
-
-  if (xQueuePeek(dataQueue, &jsonString, 0) == pdTRUE) {
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, jsonString);
-
-    if (error == DeserializationError::Ok) {
-      JsonObject obj = doc.as<JsonObject>();
-      for (JsonPair kv : obj) {
-        dataPoint[kv.key()] = kv.value();
-      }
-      success = true;
+  ConsumerCursor& c = cursor(consumer);
+
+  uint32_t seq = c.readSeq.load(std::memory_order_acquire);
+  uint32_t head = writeSeq.load(std::memory_order_acquire);
+  if ((uint32_t)(head - seq) > dataCapacity) {
+    // Lapped: skip to oldest retained (same as readRecord). On CAS failure
+    // seq holds the moved cursor; an unreadable slot ends the batch below.
+    uint32_t oldest = head - dataCapacity;
+    if (c.readSeq.compare_exchange_strong(seq, oldest)) {
+      c.overflowDropped.fetch_add(oldest - seq, std::memory_order_relaxed);
+      seq = oldest;
     }
   }
+  batch.startSeq = seq;
 
-  xSemaphoreGive(queueMutex);
-  return success;
-}
+  int count = 0;
+  QueueRecord record;
+  while (count < maxPoints && seq != head) {
+    RingSlot& slot = dataRing[seq & dataMask];
+    if (slot.committed.load(std::memory_order_acquire) != seq) {
+      break;  // Producer not finished, or overwritten (lap on next read)
+    }
+    record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.claimed.load(std::memory_order_relaxed) != seq) {
+      break;  // Overwritten while copying
+    }
+    seq++;
 
-bool QueueManager::isEmpty() const {
-  // Add mutex protection to prevent race condition
-  if (dataQueue == nullptr || queueMutex == nullptr) {
-    return true;
+    JsonObject dataPoint = dataPoints.add<JsonObject>();
+    if (expandRecord(record, dataPoint, fixedText)) {
+      count++;
+    } else {
+      dataPoints.remove(dataPoints.size() - 1);
+      batch.stale++;
+    }
   }
+  batch.endSeq = seq;
 
-  // Use short timeout to avoid blocking
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    // Can't acquire mutex - assume empty to avoid deadlock
-    return true;
+  // Only stale records read: consume them now (never publishable)
+  if (count == 0 && batch.endSeq != batch.startSeq) {
+    commitBatch(consumer, batch);
   }
-
-  bool empty = (uxQueueMessagesWaiting(dataQueue) == 0);
-  xSemaphoreGive(queueMutex);
-
-  return empty;
+  return count;
 }
 
-bool QueueManager::isFull() const {
-  // Add mutex protection to prevent race condition
-  if (dataQueue == nullptr || queueMutex == nullptr) {
-    return false;
-  }
-
-  // Use short timeout to avoid blocking
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    // Can't acquire mutex - assume not full to avoid deadlock
-    return false;
+bool QueueManager::commitBatch(QueueConsumer consumer,
+                               const QueueBatch& batch) {
+  ConsumerCursor& c = cursor(consumer);
+  uint32_t seq = c.readSeq.load(std::memory_order_acquire);
+
+  // discard() may have moved the cursor into the batch meanwhile; clear() or
+  // a lap past the batch end leave the cursor where it is
+  while ((int32_t)(seq - batch.startSeq) >= 0 &&
+         (int32_t)(batch.endSeq - seq) > 0) {
+    if (c.readSeq.compare_exchange_weak(seq, batch.endSeq)) {
+      staleDropped.fetch_add(batch.stale, std::memory_order_relaxed);
+      return true;
+    }
   }
+  return false;
+}
 
-  bool full = (uxQueueMessagesWaiting(dataQueue) >= MAX_QUEUE_SIZE);
-  xSemaphoreGive(queueMutex);
-
-  return full;
+bool QueueManager::isEmpty(QueueConsumer consumer) const {
+  return pending(consumer) == 0;
 }
 
-int QueueManager::size() const {
-  // Add mutex protection to prevent race condition
-  if (dataQueue == nullptr || queueMutex == nullptr) {
-    return 0;
-  }
+int QueueManager::size(QueueConsumer consumer) const {
+  return (int)pending(consumer);
+}
 
-  // Use short timeout to avoid blocking
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    // Can't acquire mutex - return 0 to avoid deadlock
-    return 0;
-  }
+bool QueueManager::isEmpty() const { return size() == 0; }
 
-  int queueSize = uxQueueMessagesWaiting(dataQueue);
-  xSemaphoreGive(queueMutex);
+bool QueueManager::isFull() const {
+  return dataCapacity > 0 && (uint32_t)size() >= dataCapacity;
+}
 
-  return queueSize;
+int QueueManager::size() const {
+  // Backlog of the active publisher (BLE stream excluded)
+  return cursor(QueueConsumer::HTTP).active.load()
+             ? (int)pending(QueueConsumer::HTTP)
+             : 0;
 }
 
 void QueueManager::clear() {
-  if (dataQueue == nullptr || queueMutex == nullptr) {
+  if (dataRing == nullptr) {
     return;
   }
 
-  // Use configurable timeout
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(queueMutexTimeout)) != pdTRUE) {
-    return;
+  uint32_t head = writeSeq.load();
+  for (int i = 0; i < (int)QueueConsumer::COUNT; i++) {
+    consumers[i].readSeq.store(head);
   }
+  Serial.println("Queue cleared");
+}
 
-  char* jsonString;
-  while (xQueueReceive(dataQueue, &jsonString, 0) == pdTRUE) {
-    heap_caps_free(jsonString);
+int QueueManager::discard(int count) {
+  if (dataRing == nullptr || count <= 0) {
+    return 0;
   }
 
-  xSemaphoreGive(queueMutex);
-  Serial.println("Queue cleared");
+  int discarded = 0;
+  for (int i = 0; i < (int)QueueConsumer::COUNT; i++) {
+    ConsumerCursor& c = consumers[i];
+    if (!c.active.load()) {
+      continue;
+    }
+    uint32_t seq = c.readSeq.load();
+    uint32_t skip;
+    do {
+      skip = pending((QueueConsumer)i);
+      if (skip > (uint32_t)count) skip = count;
+    } while (skip > 0 && !c.readSeq.compare_exchange_weak(seq, seq + skip));
+    if ((int)skip > discarded) discarded = skip;
+  }
+  return discarded;
 }
 
 int QueueManager::flushDeviceData(const String& deviceId) {
-  if (dataQueue == nullptr || queueMutex == nullptr) {
+  if (dataRing == nullptr) {
     return 0;
   }
 
-  if (xSemaphoreTake(queueMutex, pdMS_TO_TICKS(queueMutexTimeout)) != pdTRUE) {
-    LOG_QUEUE_INFO("[QUEUE] Failed to acquire mutex for flush operation");
-    return 0;
+  // v1.3.3: Records cannot be removed from a lock-free ring. Count the
+  // device's pending records, then retire its registry generation so every
+  // queued record of it is dropped as stale by all consumers.
+  uint32_t head = writeSeq.load(std::memory_order_acquire);
+  uint32_t oldest = head;
+  for (int i = 0; i < (int)QueueConsumer::COUNT; i++) {
+    if (!consumers[i].active.load()) continue;
+    uint32_t seq = head - pending((QueueConsumer)i);
+    if ((int32_t)(seq - oldest) < 0) oldest = seq;
   }
 
-  // Create temporary storage for items to keep
-  char* tempItems[MAX_QUEUE_SIZE];
-  int keepCount = 0;
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
   int flushedCount = 0;
-
-  // CRITICAL FIX: Use filtered parsing to only extract device_id
-  // This dramatically reduces CPU time compared to full JSON deserialization
-  // Performance: ~50-100x faster for large JSON documents (1000 items: ~500ms →
-  // ~5-10ms)
-
-  // Create filter to only parse device_id field (not entire JSON)
-  JsonDocument filter;
-  filter["device_id"] = true;
-
-  // Dequeue all items and filter
-  char* jsonString;
-  while (xQueueReceive(dataQueue, &jsonString, 0) == pdTRUE) {
-    // Deserialize ONLY device_id field (filtered parsing - much faster!)
-    JsonDocument doc;
-    DeserializationError error =
-        deserializeJson(doc, jsonString, DeserializationOption::Filter(filter));
-
-    if (error == DeserializationError::Ok) {
-      String itemDeviceId = doc["device_id"] | "";
-
-      if (itemDeviceId == deviceId) {
-        // This is data from deleted device - free it
-        heap_caps_free(jsonString);
-        flushedCount++;
-      } else {
-        // Keep this item
-        if (keepCount < MAX_QUEUE_SIZE) {
-          tempItems[keepCount++] = jsonString;
-        } else {
-          // Safety: shouldn't happen, but free if we run out of space
-          heap_caps_free(jsonString);
-        }
-      }
-    } else {
-      // Corrupted data, free it
-      heap_caps_free(jsonString);
+  for (uint32_t seq = oldest; seq != head; seq++) {
+    QueueRecord record = dataRing[seq & dataMask].record;
+    if (registry->matchesDevice(record.deviceSlot, record.generation,
+                                deviceId.c_str())) {
       flushedCount++;
     }
   }
-
-  // Re-queue items we want to keep
-  for (int i = 0; i < keepCount; i++) {
-    if (xQueueSend(dataQueue, &tempItems[i], 0) != pdTRUE) {
-      // Queue full (shouldn't happen), free the item
-      heap_caps_free(tempItems[i]);
-    }
-  }
-
-  xSemaphoreGive(queueMutex);
+  registry->retireDevice(deviceId.c_str());
 
   if (flushedCount > 0) {
     LOG_QUEUE_INFO("[QUEUE] Flushed %d data points for deleted device: %s\n",
@@ -329,137 +407,103 @@ int QueueManager::flushDeviceData(const String& deviceId) {
 
 void QueueManager::getStats(JsonObject& stats) const {
   stats["size"] = size();
-  stats["max_size"] = MAX_QUEUE_SIZE;
+  stats["max_size"] = dataCapacity;
   stats["is_empty"] = isEmpty();
   stats["is_full"] = isFull();
+  stats["record_bytes"] = sizeof(RingSlot);
+  stats["stale_dropped"] = staleDropped.load();
+
+  static const char* const names[] = {"http", "stream"};
+  uint32_t overflow = 0;
+  JsonObject cursors = stats["consumers"].to<JsonObject>();
+  for (int i = 0; i < (int)QueueConsumer::COUNT; i++) {
+    overflow += consumers[i].overflowDropped.load();
+    if (consumers[i].active.load()) {
+      cursors[names[i]] = pending((QueueConsumer)i);
+    }
+  }
+  stats["overflow_dropped"] = overflow;
 }
 
-bool QueueManager::enqueueStream(const JsonObject& dataPoint) {
-  if (streamQueue == nullptr || streamMutex == nullptr) {
-    return false;
+// ============================================================================
+// BLE STREAMING (STREAM cursor)
+// ============================================================================
+
+void QueueManager::beginStream(const char* deviceId) {
+  if (dataRing == nullptr || streamMutex == nullptr) {
+    return;
   }
 
-  // Use configurable timeout for stream operations
   if (xSemaphoreTake(streamMutex, pdMS_TO_TICKS(streamMutexTimeout)) !=
       pdTRUE) {
-    return false;
-  }
-
-  // Remove oldest if full
-  if (uxQueueMessagesWaiting(streamQueue) >= MAX_STREAM_QUEUE_SIZE) {
-    char* oldItem;
-    if (xQueueReceive(streamQueue, &oldItem, 0) == pdTRUE) {
-      heap_caps_free(oldItem);  // FIXED: Use heap_caps_free instead of free
-    }
-  }
-
-  String jsonString;
-  serializeJson(dataPoint, jsonString);
-
-  char* jsonCopy = (char*)heap_caps_malloc(jsonString.length() + 1,
-                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-  if (jsonCopy == nullptr) {
-    // FIXED: Remove malloc() fallback - fail gracefully instead of mixing
-    // allocators
-    xSemaphoreGive(streamMutex);
-    Serial.println(
-        "[QUEUE STREAM] ERROR: PSRAM allocation failed - stream queue full");
-    return false;
+    return;
   }
+  strncpy(streamDeviceId, deviceId, sizeof(streamDeviceId) - 1);
+  streamDeviceId[sizeof(streamDeviceId) - 1] = '\0';
+  xSemaphoreGive(streamMutex);
 
-  // v2.5.36 FIX: Use memcpy instead of strcpy for defensive programming
-  // (explicit bounds)
-  memcpy(jsonCopy, jsonString.c_str(), jsonString.length() + 1);
-  bool success = xQueueSend(streamQueue, &jsonCopy, 0) == pdTRUE;
+  // Stream starts with new readings only (previous queue started empty)
+  ConsumerCursor& c = cursor(QueueConsumer::STREAM);
+  c.readSeq.store(writeSeq.load());
+  c.active.store(true);
+}
 
-  if (success) {
-    // Verbose log suppressed - summary shown in [STREAM] logs
-  } else {
-    Serial.println("Stream queue: Failed to add data");
-    heap_caps_free(jsonCopy);
+bool QueueManager::dequeueStream(JsonObject& dataPoint) {
+  // Skip batch markers (and stale records that fail to expand)
+  QueueRecord record;
+  while (dequeueStreamRecord(record)) {
+    // BLE responses are always JSON text (v1.3.3: fixed-decimal values)
+    if (record.type == QueueRecordType::REGISTER &&
+        expandRecord(record, dataPoint, true)) {
+      return true;
+    }
   }
-
-  xSemaphoreGive(streamMutex);
-  return success;
+  return false;
 }
 
-bool QueueManager::dequeueStream(JsonObject& dataPoint) {
-  if (streamQueue == nullptr || streamMutex == nullptr) {
+bool QueueManager::dequeueStreamRecord(QueueRecord& record) {
+  if (!cursor(QueueConsumer::STREAM).active.load() ||
+      streamMutex == nullptr) {
     return false;
   }
 
-  // Use configurable timeout for stream operations
+  char deviceId[sizeof(streamDeviceId)];
   if (xSemaphoreTake(streamMutex, pdMS_TO_TICKS(streamMutexTimeout)) !=
       pdTRUE) {
     return false;
   }
+  memcpy(deviceId, streamDeviceId, sizeof(deviceId));
+  xSemaphoreGive(streamMutex);
 
-  char* jsonString;
-  bool success = false;
-
-  if (xQueueReceive(streamQueue, &jsonString, 0) == pdTRUE) {
-    // Verbose log suppressed - summary shown in [STREAM] logs
-    JsonDocument doc;
-    if (deserializeJson(doc, jsonString) == DeserializationError::Ok) {
-      JsonObject obj = doc.as<JsonObject>();
-      for (JsonPair kv : obj) {
-        dataPoint[kv.key()] = kv.value();
-      }
-      success = true;
+  // Skip records of other devices
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  while (readRecord(QueueConsumer::STREAM, record, true)) {
+    if (registry->matchesDevice(record.deviceSlot, record.generation,
+                                deviceId)) {
+      return true;
     }
-    heap_caps_free(jsonString);
   }
-
-  xSemaphoreGive(streamMutex);
-  return success;
+  return false;
 }
 
 bool QueueManager::isStreamEmpty() const {
-  // Add mutex protection to prevent race condition
-  // This prevents accessing streamQueue after it's been deleted by another
-  // thread
-  if (streamQueue == nullptr || streamMutex == nullptr) {
-    return true;
-  }
-
-  // Use short timeout to avoid blocking
-  if (xSemaphoreTake(streamMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
-    // Can't acquire mutex - assume empty to avoid deadlock
-    return true;
-  }
-
-  bool isEmpty = (uxQueueMessagesWaiting(streamQueue) == 0);
-  xSemaphoreGive(streamMutex);
-
-  return isEmpty;
+  return !cursor(QueueConsumer::STREAM).active.load() ||
+         pending(QueueConsumer::STREAM) == 0;
 }
 
 void QueueManager::clearStream() {
-  if (streamQueue == nullptr || streamMutex == nullptr) {
-    return;
-  }
+  cursor(QueueConsumer::STREAM).active.store(false);
 
-  // Use configurable timeout for stream operations
-  if (xSemaphoreTake(streamMutex, pdMS_TO_TICKS(streamMutexTimeout)) !=
-      pdTRUE) {
+  if (streamMutex == nullptr ||
+      xSemaphoreTake(streamMutex, pdMS_TO_TICKS(streamMutexTimeout)) !=
+          pdTRUE) {
     return;
   }
-
-  char* jsonString;
-  while (xQueueReceive(streamQueue, &jsonString, 0) == pdTRUE) {
-    heap_caps_free(jsonString);
-  }
-
+  streamDeviceId[0] = '\0';
   xSemaphoreGive(streamMutex);
 }
 
 // Configurable timeout setter methods
-void QueueManager::setQueueMutexTimeout(uint32_t timeoutMs) {
-  queueMutexTimeout = timeoutMs;
-  Serial.printf("[QueueManager] Queue mutex timeout set to: %lums\n",
-                timeoutMs);
-}
-
 void QueueManager::setStreamMutexTimeout(uint32_t timeoutMs) {
   streamMutexTimeout = timeoutMs;
   Serial.printf("[QueueManager] Stream mutex timeout set to: %lums\n",
@@ -467,27 +511,15 @@ void QueueManager::setStreamMutexTimeout(uint32_t timeoutMs) {
 }
 
 // Configurable timeout getter methods
-uint32_t QueueManager::getQueueMutexTimeout() const {
-  return queueMutexTimeout;
-}
-
 uint32_t QueueManager::getStreamMutexTimeout() const {
   return streamMutexTimeout;
 }
 
 QueueManager::~QueueManager() {
-  clear();
-  clearStream();
-  if (dataQueue) {
-    vQueueDelete(dataQueue);
-  }
-  if (streamQueue) {
-    vQueueDelete(streamQueue);
-  }
-  if (queueMutex) {
-    vSemaphoreDelete(queueMutex);
+  if (dataRing) {
+    heap_caps_free(dataRing);
   }
   if (streamMutex) {
     vSemaphoreDelete(streamMutex);
   }
-}
\ No newline at end of file
+}
@@ -3,61 +3,198 @@
 
 #include <ArduinoJson.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
 #include <freertos/semphr.h>
 
+#include <atomic>
+
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
 
+/**
+ * v1.3.3: Fixed-size binary queue record (24 bytes)
+ *
+ * Previous: Every data point was serialized to a JSON String (~300 bytes,
+ * ~12 fields), copied into a heap_caps_malloc() block and deserialized again
+ * by the consumer - two JSON passes + 2 allocations per register reading.
+ * New: Register readings are stored as {device slot, register slot,
+ * timestamp, value} in a preallocated PSRAM ring. Strings (name, unit,
+ * description, device_id, ...) are resolved from the compiled poll plan
+ * (PollPlanRegistry) only when the record is read for publishing.
+ */
+enum class QueueRecordType : uint8_t {
+  EMPTY = 0,
+  REGISTER = 1,  // Binary register reading (resolved via PollPlanRegistry)
+  BATCH_END = 2  // Binary End-of-Batch marker
+};
+
+struct QueueRecord {
+  QueueRecordType type;
+  uint8_t deviceSlot;     // PollPlanRegistry slot
+  uint16_t registerSlot;  // Index into CompiledDevicePlan::registers
+  uint16_t generation;    // Registry slot generation (stale layout check)
+  uint16_t reserved;
+  uint32_t timestamp;  // REGISTER: unix time (0 = no RTC), BATCH_END: millis
+  union {
+    double value;  // REGISTER: calibrated value
+    struct {
+      uint16_t successCount;
+      uint16_t failedCount;
+    } batch;  // BATCH_END
+  };
+};
+
+/**
+ * v1.3.3: Independent readers of the data ring
+ *
+ * Each consumer owns a read cursor, so HTTP publishing and BLE streaming see
+ * the same records without copies. Inactive consumers are ignored (never hold
+ * back producers). MQTT publishes from the latest-value table
+ * (PollPlanRegistry::drainLatest) instead of the ring.
+ */
+enum class QueueConsumer : uint8_t {
+  HTTP = 0,
+  STREAM = 1,  // BLE streaming (filtered by streamed device)
+  COUNT = 2
+};
+
+/**
+ * v1.3.3: Ring range read by QueueManager::peekBatch()
+ *
+ * The consumer cursor is only moved by commitBatch(), so a batch that could
+ * not be delivered is read again on the next attempt.
+ */
+struct QueueBatch {
+  uint32_t startSeq = 0;  // Cursor when the batch was read
+  uint32_t endSeq = 0;    // First sequence after the batch
+  uint32_t stale = 0;     // Skipped stale records (counted on commit)
+};
+
+/**
+ * QueueManager - Modbus -> publisher data path
+ *
+ * v1.3.3: Lock-free multi-producer ring with per-consumer cursors
+ * Previous: Every enqueue/dequeue took one mutex (100ms timeout). A publisher
+ * busy in JSON work stalled the RTU/TCP polling tasks, and a timed-out take
+ * silently dropped the reading. BLE streaming kept a second queue of JSON
+ * string copies.
+ * New:
+ * - Producers (RTU/TCP) claim a sequence number with one atomic fetch_add and
+ *   publish the slot with seqlock-style stamps. No mutex, no allocation.
+ * - Each consumer advances its own cursor. Records are never removed; the
+ *   oldest record is overwritten when the ring is full and a consumer that
+ *   was lapped skips ahead (counted as overflow).
+ * - Atomic read-modify-write is only used on DRAM members (writeSeq, cursors).
+ *   Ring slots (PSRAM) only use plain 32-bit atomic loads/stores.
+ */
 class QueueManager {
  private:
   static QueueManager* instance;
-  QueueHandle_t dataQueue;
-  QueueHandle_t streamQueue;
-  mutable SemaphoreHandle_t
-      queueMutex;  // Mutable: mutex operations don't change logical state
+
+  struct RingSlot {
+    std::atomic<uint32_t> claimed;    // Sequence being / last written
+    std::atomic<uint32_t> committed;  // Sequence fully written
+    QueueRecord record;
+  };
+
+  struct ConsumerCursor {
+    std::atomic<uint32_t> readSeq{0};
+    std::atomic<bool> active{false};
+    std::atomic<uint32_t> overflowDropped{0};  // Lapped by producers
+  };
+
+  // v1.3.3: Data ring is a preallocated array of RingSlot (PSRAM)
+  RingSlot* dataRing;
+  uint32_t dataCapacity;  // Power of two (sequence -> index by mask)
+  uint32_t dataMask;
+  std::atomic<uint32_t> writeSeq{0};  // Next sequence to claim
+  ConsumerCursor consumers[(int)QueueConsumer::COUNT];
+  std::atomic<uint32_t> staleDropped{0};  // Device removed / layout changed
+
+  // BLE stream filter (consumer side only, producers never take this mutex)
+  char streamDeviceId[64];
   mutable SemaphoreHandle_t
       streamMutex;  // Mutable: mutex operations don't change logical state
-  static const int MAX_QUEUE_SIZE =
-      1000;  // CRITICAL FIX: Increased from 200 to 1000 to prevent queue
-             // overflow during slow MQTT publish intervals (60s+). Supports
-             // ~60s publish interval with 2 devices × 50 registers each.
-  static const int MAX_STREAM_QUEUE_SIZE = 50;
+  static const uint32_t MAX_QUEUE_SIZE =
+      4096;  // v1.3.3: 4096 slots x 32 bytes = 128KB PSRAM (was 1000 JSON
+             // strings of ~300 bytes each = ~300KB). CRITICAL FIX history:
+             // 200 -> 1000 to prevent overflow at slow MQTT intervals (60s+)
+  static const uint32_t FALLBACK_QUEUE_SIZE =
+      1024;  // v1.3.3: Ring capacity if PSRAM unavailable (32KB DRAM)
 
   // Configurable mutex timeout (milliseconds)
-  uint32_t queueMutexTimeout =
-      100;  // Default timeout for queue operations (100ms)
   uint32_t streamMutexTimeout =
       10;  // Default timeout for stream operations (10ms)
 
   QueueManager();
 
+  // v1.3.3: Ring helpers
+  bool pushRecord(const QueueRecord& record);
+  bool readRecord(QueueConsumer consumer, QueueRecord& record, bool advance);
+  uint32_t oldestSequence(uint32_t head) const;
+  uint32_t pending(QueueConsumer consumer) const;
+  bool expandRecord(const QueueRecord& record, JsonObject& dataPoint,
+                    bool fixedText = false) const;
+  ConsumerCursor& cursor(QueueConsumer consumer) {
+    return consumers[(int)consumer];
+  }
+  const ConsumerCursor& cursor(QueueConsumer consumer) const {
+    return consumers[(int)consumer];
+  }
+
  public:
   static QueueManager* getInstance();
 
   bool init();
-  // Using const reference to avoid copying large JsonObject
-  bool enqueue(const JsonObject& dataPoint);
-  bool dequeue(JsonObject& dataPoint);
-  bool peek(const JsonObject& dataPoint) const;
+
+  // v1.3.3: Binary records (lock-free, no serialization, no allocation)
+  bool enqueueRegister(uint8_t deviceSlot, uint16_t generation,
+                       uint16_t registerSlot, double value,
+                       uint32_t timestamp);
+  bool enqueueBatchEnd(uint8_t deviceSlot, uint16_t generation,
+                       uint16_t successCount, uint16_t failedCount);
+
+  // v1.3.3: Consumer lifecycle (publisher start/stop). Attaching starts at
+  // the oldest record still in the ring.
+  void attachConsumer(QueueConsumer consumer);
+  void detachConsumer(QueueConsumer consumer);
+
+  // Publisher side (HTTP). Each consumer must only be read by one task.
+  bool dequeue(QueueConsumer consumer, JsonObject& dataPoint);
+  bool peek(QueueConsumer consumer, JsonObject& dataPoint);
+  bool isEmpty(QueueConsumer consumer) const;
+  int size(QueueConsumer consumer) const;
+
+  // v1.3.3: Batched publisher read (HTTP). Appends up to maxPoints data points
+  // to dataPoints without advancing the cursor; commitBatch() consumes them.
+  // fixedText: values as fixed-decimal text (JSON body, see NumberFormat).
+  int peekBatch(QueueConsumer consumer, JsonArray& dataPoints, int maxPoints,
+                QueueBatch& batch, bool fixedText = false);
+  bool commitBatch(QueueConsumer consumer, const QueueBatch& batch);
+
+  // Aggregates over active publisher consumers (HTTP)
   bool isEmpty() const;
   bool isFull() const;
   int size() const;
   void clear();
   void getStats(JsonObject& stats) const;
 
+  // v1.3.3: Skip the oldest records of every consumer (memory recovery)
+  int discard(int count);
+
   // Priority 1: Flush queue data for deleted device
   int flushDeviceData(const String& deviceId);
 
-  // Streaming queue methods
-  bool enqueueStream(const JsonObject& dataPoint);
+  // Streaming methods (v1.3.3: STREAM cursor over the data ring, records of
+  // the streamed device only - no separate queue, no JSON copies)
+  void beginStream(const char* deviceId);
   bool dequeueStream(JsonObject& dataPoint);
+  // v1.3.3: Raw REGISTER/BATCH_END records of the streamed device (binary
+  // BLE stream, no JSON expansion)
+  bool dequeueStreamRecord(QueueRecord& record);
   bool isStreamEmpty() const;
   void clearStream();
 
   // Configurable timeout methods
-  void setQueueMutexTimeout(uint32_t timeoutMs);
   void setStreamMutexTimeout(uint32_t timeoutMs);
-  uint32_t getQueueMutexTimeout() const;
   uint32_t getStreamMutexTimeout() const;
 
   ~QueueManager();
@@ -2,6 +2,7 @@
 
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
 #include "NetworkManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
 
 RTCManager* RTCManager::instance = nullptr;
 
@@ -10,7 +11,13 @@ RTCManager::RTCManager()
       syncRunning(false),
       syncTaskHandle(nullptr),
       lastNtpSync(0),
-      ntpClient(nullptr) {}
+      ntpClient(nullptr),
+      clockValid(false),
+      clockBaseUs(0),
+      clockBaseMs(0),
+      clockLastMs(0),
+      lastRtcClockSync(0),
+      clockEdgeSynced(false) {}
 
 RTCManager* RTCManager::getInstance() {
   // Thread-safe Meyers Singleton (C++11 guarantees thread-safe static init)
@@ -57,6 +64,11 @@ bool RTCManager::init() {
   // Update system time from RTC immediately
   updateSystemTime(rtcTime);
 
+  // v1.3.3: Start the fast clock (readers no longer query the RTC) at
+  // whole-second accuracy; the sync task aligns it on the seconds tick
+  // without holding up boot
+  setClockBase((uint64_t)rtcTime.unixtime() * 1000);
+
   // NTP sync will be handled by startSync() task
   // This prevents blocking during boot if network is not ready
 
@@ -68,9 +80,9 @@ void RTCManager::startSync() {
 
   syncRunning = true;
   // OPTIMIZATION: Moved to Core 0 to balance load (background sync task)
-  xTaskCreatePinnedToCore(timeSyncTask, "RTC_SYNC_TASK", 4096, this, 1,
-                          &syncTaskHandle,
-                          0);  // Core 0 (moved from Core 1 for load balancing)
+  // v1.3.3: Priority and core from TaskAffinity.h
+  TaskAffinity::create(timeSyncTask, "RTC_SYNC_TASK", 4096, this,
+                       TaskAffinity::Task::RTC_SYNC, &syncTaskHandle);
   LOG_NET_INFO("[RTC] Sync service started");
 }
 
@@ -101,6 +113,12 @@ void RTCManager::timeSyncLoop() {
     bool intervalElapsed = (now - lastNtpSync >= ntpUpdateInterval);
     bool firstRun = (lastNtpSync == 0);
 
+    // v1.3.3: Correct esp_timer drift against the DS3231 (TCXO, +-2 ppm);
+    // the first pass replaces init()'s whole-second anchor
+    if (!clockEdgeSynced || now - lastRtcClockSync >= rtcClockSyncInterval) {
+      syncClockFromRtc();
+    }
+
     if (firstRun || intervalElapsed || timeInvalid) {
       if (timeInvalid) {
         LOG_NET_INFO("[RTC] Time invalid (Year: %d), forcing NTP sync...",
@@ -188,6 +206,7 @@ bool RTCManager::syncWithNTP() {
   // Update RTC and system time
   rtc.adjust(ntpTime);
   updateSystemTime(ntpTime);
+  setClockBase((uint64_t)ntpTime.unixtime() * 1000);
 
   LOG_NET_INFO(
       "[RTC] NTP sync: %04d-%02d-%02d %02d:%02d:%02d (WIB/GMT+7) via %s\n",
@@ -247,11 +266,74 @@ void RTCManager::updateSystemTime(DateTime rtcTime) {
   settimeofday(&tv, NULL);
 }
 
+/**
+ * v1.3.3: Re-anchor the fast clock on the RTC
+ *
+ * The DS3231 only reports whole seconds, so the sync waits for the seconds
+ * register to change (max ~1s, 5ms polls) and anchors the clock on that
+ * edge. Result is accurate to a few ms instead of up to 999ms. Only called
+ * from the sync task; init() seeds the clock without waiting.
+ */
+void RTCManager::syncClockFromRtc() {
+  DateTime first = rtc.now();
+  DateTime current = first;
+  int64_t deadline = esp_timer_get_time() + 1100000;  // 1.1 s
+
+  while (current.unixtime() == first.unixtime() &&
+         esp_timer_get_time() < deadline) {
+    vTaskDelay(pdMS_TO_TICKS(5));
+    current = rtc.now();
+  }
+
+  // No edge seen (I2C error): keep second resolution rather than no clock
+  setClockBase((uint64_t)current.unixtime() * 1000);
+  lastRtcClockSync = millis();
+  clockEdgeSynced = true;
+}
+
+void RTCManager::setClockBase(uint64_t epochMs) {
+  int64_t nowUs = esp_timer_get_time();
+
+  portENTER_CRITICAL(&clockMux);
+  uint64_t previousMs =
+      clockBaseMs + (uint64_t)((nowUs - clockBaseUs) / 1000);
+  int64_t stepMs = (int64_t)(epochMs - previousMs);
+  clockBaseUs = nowUs;
+  clockBaseMs = epochMs;
+  // Drift corrections keep the clock monotonic (readers wait for a small
+  // backward step to pass); a real time change (setTime/NTP) is applied as is
+  if (!clockValid || stepMs > 2000 || stepMs < -2000) {
+    clockLastMs = 0;
+  }
+  clockValid = true;
+  portEXIT_CRITICAL(&clockMux);
+}
+
+uint64_t RTCManager::getEpochMillis() {
+  if (!clockValid) {
+    return 0;
+  }
+
+  int64_t nowUs = esp_timer_get_time();
+
+  portENTER_CRITICAL(&clockMux);
+  uint64_t epochMs = clockBaseMs + (uint64_t)((nowUs - clockBaseUs) / 1000);
+  if (epochMs < clockLastMs) {
+    epochMs = clockLastMs;
+  } else {
+    clockLastMs = epochMs;
+  }
+  portEXIT_CRITICAL(&clockMux);
+
+  return epochMs;
+}
+
 DateTime RTCManager::getCurrentTime() {
   if (!initialized) {
     return DateTime();
   }
-  return rtc.now();
+  // v1.3.3: Fast clock instead of an I2C transaction per call
+  return DateTime(getUnixTime());
 }
 
 bool RTCManager::setTime(DateTime newTime) {
@@ -259,6 +341,7 @@ bool RTCManager::setTime(DateTime newTime) {
 
   rtc.adjust(newTime);
   updateSystemTime(newTime);
+  setClockBase((uint64_t)newTime.unixtime() * 1000);
 
   LOG_NET_INFO("[RTC] Time set: %04d-%02d-%02d %02d:%02d:%02d\n",
                newTime.year(), newTime.month(), newTime.day(), newTime.hour(),
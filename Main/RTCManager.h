@@ -9,6 +9,7 @@
 #include <WiFi.h>
 #include <WiFiUdp.h>
 #include <Wire.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -34,6 +35,19 @@ class RTCManager {
   EthernetUDP ethernetUdp;
   NTPClient* ntpClient;
 
+  // v1.3.3: Fast clock - epoch derived from esp_timer (monotonic, us) and
+  // corrected from the DS3231 every rtcClockSyncInterval. Readers never touch
+  // the I2C bus (was: rtc.now() per getCurrentTime() call, i.e. per register
+  // stored and per log line timestamp).
+  portMUX_TYPE clockMux = portMUX_INITIALIZER_UNLOCKED;
+  bool clockValid;
+  int64_t clockBaseUs;   // esp_timer_get_time() at the sync point
+  uint64_t clockBaseMs;  // Epoch (local time) in ms at the sync point
+  uint64_t clockLastMs;  // Last value returned (never goes backwards)
+  unsigned long lastRtcClockSync;
+  bool clockEdgeSynced;  // Anchored on a seconds tick (sync task)
+  const unsigned long rtcClockSyncInterval = 600000;  // 10 minutes
+
   RTCManager();
 
   static void timeSyncTask(void* parameter);
@@ -41,6 +55,8 @@ class RTCManager {
   bool syncWithNTP();
   bool checkInternetConnectivity();
   void updateSystemTime(DateTime rtcTime);
+  void syncClockFromRtc();
+  void setClockBase(uint64_t epochMs);
 
  public:
   static RTCManager* getInstance();
@@ -49,7 +65,12 @@ class RTCManager {
   void startSync();
   void stopSync();
 
-  DateTime getCurrentTime();
+  DateTime getCurrentTime();  // v1.3.3: From the fast clock (no I2C read)
+
+  // v1.3.3: Fast clock (ms resolution, 0 = RTC not initialized)
+  uint64_t getEpochMillis();
+  uint32_t getUnixTime() { return (uint32_t)(getEpochMillis() / 1000); }
+
   bool setTime(DateTime newTime);
   bool forceNtpSync();
   void getStatus(JsonObject& status);
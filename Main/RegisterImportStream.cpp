@@ -0,0 +1,237 @@
+#include "RegisterImportStream.h"
+
+#include <esp_heap_caps.h>
+
+#include "DebugConfig.h"
+
+RegisterImportStream::RegisterImportStream()
+    : current(IDLE),
+      phase(HEADER),
+      buffer(nullptr),
+      used(0),
+      depth(0),
+      inString(false),
+      escaped(false),
+      received(0) {
+  errorText[0] = '\0';
+}
+
+RegisterImportStream::~RegisterImportStream() {
+  if (buffer) {
+    heap_caps_free(buffer);
+  }
+}
+
+bool RegisterImportStream::begin() {
+  if (current.load() == QUEUED) {
+    return false;  // Previous import not applied yet
+  }
+  if (!buffer) {
+    // +4: closeHeader() appends "[]}"
+    buffer = (char*)heap_caps_malloc(
+        RegisterImportConfig::MAX_OBJECT_BYTES + 4,
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buffer) {
+      current.store(IDLE);
+      return false;
+    }
+  }
+  clear();
+  staged.to<JsonArray>();
+  current.store(RECEIVING);
+  return true;
+}
+
+bool RegisterImportStream::feed(const char* data, size_t length) {
+  if (current.load() != RECEIVING) {
+    return false;
+  }
+  received += length;
+  for (size_t i = 0; i < length; i++) {
+    if (!scan(data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RegisterImportStream::finish(JsonDocument& command) {
+  if (current.load() != RECEIVING) {
+    return false;
+  }
+  if (phase != COMPLETE) {
+    return fail("Import incomplete (document not closed)");
+  }
+  if (staged.size() == 0) {
+    return fail("No registers in import");
+  }
+  command.set(header);
+  header.clear();
+  current.store(QUEUED);
+  return true;
+}
+
+void RegisterImportStream::cancel() {
+  if (receiving()) {
+    clear();
+    current.store(IDLE);
+  }
+}
+
+void RegisterImportStream::release() {
+  clear();
+  current.store(IDLE);
+}
+
+void RegisterImportStream::clear() {
+  phase = HEADER;
+  used = 0;
+  depth = 0;
+  inString = false;
+  escaped = false;
+  received = 0;
+  errorText[0] = '\0';
+  header.clear();
+  staged.clear();  // Frees the staged registers
+  object.clear();
+}
+
+bool RegisterImportStream::fail(const char* message) {
+  snprintf(errorText, sizeof(errorText), "%s", message);
+  current.store(FAILED);
+  LOG_BLE_INFO("[IMPORT] Aborted after %lu bytes: %s\n",
+               (unsigned long)received, errorText);
+  return false;
+}
+
+/**
+ * One byte of the document
+ * Tracks strings and nesting only; the text of the header and of each
+ * register object is buffered and parsed by ArduinoJson when it closes.
+ */
+bool RegisterImportStream::scan(char c) {
+  bool capture = phase == HEADER || (phase == ELEMENTS && depth > 2);
+  if (capture) {
+    if (used >= RegisterImportConfig::MAX_OBJECT_BYTES) {
+      return fail(phase == HEADER ? "Import header too long"
+                                  : "Register object too long");
+    }
+    buffer[used++] = c;
+  }
+
+  if (inString) {
+    if (escaped) {
+      escaped = false;
+    } else if (c == '\\') {
+      escaped = true;
+    } else if (c == '"') {
+      inString = false;
+    }
+    return true;
+  }
+  if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+    return true;
+  }
+
+  switch (phase) {
+    case HEADER:
+      if (depth == 0 && c != '{') {
+        return fail("Import must be a JSON object");
+      }
+      if (c == '[' && depth == 1) {
+        used--;  // Header ends before the registers array
+        depth++;
+        return closeHeader();
+      }
+      if (c == '"') {
+        inString = true;
+      } else if (c == '{' || c == '[') {
+        depth++;
+      } else if ((c == '}' || c == ']') && --depth == 0) {
+        return fail("\"registers\" array missing");
+      }
+      return true;
+
+    case ELEMENTS:
+      if (depth == 2) {
+        // Between two register objects
+        if (c == ',') {
+          return true;
+        }
+        if (c == ']') {
+          depth = 1;
+          phase = TRAILER;
+          return true;
+        }
+        if (c != '{') {
+          return fail("\"registers\" must hold objects");
+        }
+        used = 0;
+        buffer[used++] = c;
+        depth = 3;
+        return true;
+      }
+      if (c == '"') {
+        inString = true;
+      } else if (c == '{' || c == '[') {
+        depth++;
+      } else if ((c == '}' || c == ']') && --depth == 2) {
+        return closeObject();
+      }
+      return true;
+
+    case TRAILER:
+      // Fields after "registers" are not used
+      if (c == '"') {
+        inString = true;
+      } else if (c == '{' || c == '[') {
+        depth++;
+      } else if ((c == '}' || c == ']') && --depth == 0) {
+        phase = COMPLETE;
+      }
+      return true;
+
+    case COMPLETE:
+    default:
+      return fail("Data after the end of the import");
+  }
+}
+
+bool RegisterImportStream::closeHeader() {
+  // {"op":...,"registers": + []} = the header as a complete document
+  memcpy(buffer + used, "[]}", 3);
+  DeserializationError error = deserializeJson(header, buffer, used + 3);
+  used = 0;
+  if (error) {
+    return fail("Invalid import header");
+  }
+  if (!header["registers"].is<JsonArray>()) {
+    return fail("\"registers\" must be the last field");
+  }
+  if (strcmp(header["op"] | "", "import") != 0 ||
+      strcmp(header["type"] | "", "registers") != 0) {
+    return fail("<IMPORT> only carries \"import registers\"");
+  }
+  header.remove("registers");
+  phase = ELEMENTS;
+  return true;
+}
+
+bool RegisterImportStream::closeObject() {
+  size_t index = staged.size();
+  DeserializationError error = deserializeJson(object, buffer, used);
+  used = 0;
+  if (error) {
+    char message[sizeof(errorText)];
+    snprintf(message, sizeof(message), "Register %u: invalid JSON (%s)",
+             (unsigned)index, error.c_str());
+    return fail(message);
+  }
+  if (index >= RegisterImportConfig::MAX_REGISTERS) {
+    return fail("Too many registers in import");
+  }
+  if (!staged.add(object.as<JsonObjectConst>())) {
+    return fail("Out of memory staging registers");
+  }
+  return true;
+}
@@ -0,0 +1,111 @@
+#ifndef REGISTER_IMPORT_STREAM_H
+#define REGISTER_IMPORT_STREAM_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * RegisterImportStream - Incremental parser for "import registers" uploads
+ *
+ * v1.3.3: Streaming register import (<IMPORT> ... <END>)
+ * Previous: a command had to fit the 16KB BLE reassembly buffer before it
+ * was parsed (~80 registers), so a large device was commissioned with a
+ * dozen create commands, each rewriting the device record.
+ * New: fragments framed by <IMPORT> instead of <START> are scanned as they
+ * arrive. The command is the usual JSON, with "registers" as its last field:
+ *   {"op":"import","type":"registers","device_id":"D1","registers":[{...}]}
+ * Each register object is parsed into a PSRAM document when its closing
+ * brace arrives; only one object's text is buffered at a time
+ * (MAX_OBJECT_BYTES), so the upload size is bounded by MAX_REGISTERS, not
+ * by the BLE buffer. At <END> the header (without "registers") is queued as
+ * a normal command and CRUDHandler::importRegisters() applies the staged
+ * registers in one ConfigManager batch.
+ *
+ * Threads: feed() / finish() run on the BLE stack task. Once finished, the
+ * stream belongs to the command task until release(); a new <IMPORT> is
+ * rejected meanwhile (plain atomic state, no read-modify-write on PSRAM).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace RegisterImportConfig {
+constexpr size_t MAX_OBJECT_BYTES = 4096;  // Header or one register
+constexpr size_t MAX_REGISTERS = 1000;
+}  // namespace RegisterImportConfig
+
+class RegisterImportStream {
+ public:
+  enum State : uint8_t {
+    IDLE = 0,       // No import
+    RECEIVING = 1,  // BLE task: fragments being scanned
+    FAILED = 2,     // BLE task: error sent, fragments ignored until <END>
+    QUEUED = 3      // Command task: staged registers being applied
+  };
+
+  RegisterImportStream();
+  ~RegisterImportStream();
+
+  RegisterImportStream(const RegisterImportStream&) = delete;
+  RegisterImportStream& operator=(const RegisterImportStream&) = delete;
+
+  /**
+   * <IMPORT>: start a new upload
+   * @return false if the previous one is still queued or out of memory
+   */
+  bool begin();
+
+  /**
+   * Scan one fragment
+   * @return false on a structure error (see error(), state FAILED)
+   */
+  bool feed(const char* data, size_t length);
+
+  /**
+   * <END>: the document must be complete. Writes the header fields (all but
+   * "registers") to command and hands the stream to the command task.
+   */
+  bool finish(JsonDocument& command);
+
+  void cancel();   // BLE task: drop a receiving / failed upload
+  void release();  // Command task: staged registers applied
+
+  State state() const { return (State)current.load(); }
+  bool receiving() const {
+    uint8_t value = current.load();
+    return value == RECEIVING || value == FAILED;
+  }
+  const char* error() const { return errorText; }
+  size_t bytesReceived() const { return received; }
+
+  // Command task (QUEUED)
+  JsonArrayConst registers() const { return staged.as<JsonArrayConst>(); }
+
+ private:
+  enum Phase : uint8_t { HEADER, ELEMENTS, TRAILER, COMPLETE };
+
+  std::atomic<uint8_t> current;
+  Phase phase;
+  char* buffer;  // MAX_OBJECT_BYTES + 4 (PSRAM)
+  size_t used;
+  uint16_t depth;  // Nesting of the whole document
+  bool inString;
+  bool escaped;
+  size_t received;
+  JsonDocument header;
+  JsonDocument staged;  // Array of register objects
+  JsonDocument object;  // Parse target of one register
+  char errorText[80];
+
+  bool scan(char c);
+  bool closeHeader();
+  bool closeObject();
+  bool fail(const char* message);
+  void clear();
+};
+
+#endif  // REGISTER_IMPORT_STREAM_H
@@ -0,0 +1,324 @@
+#include "RtuMaster.h"
+
+#include <freertos/task.h>
+
+RtuMaster::RtuMaster()
+    : serial(nullptr),
+      rxEvent(nullptr),
+      baudRate(9600),
+      charTimeUs(1146),
+      currentState(State::IDLE),
+      resultCode(ku8MBSuccess),
+      slaveId(0),
+      functionCode(0),
+      quantity(0),
+      rxLength(0),
+      expectedLength(0),
+      rxCrc(0xFFFF),
+      wordCount(0),
+      sentAtMs(0),
+      deadlineMs(0),
+      lastActivityUs(0),
+      latencyMs(0),
+      gotResponse(false) {}
+
+RtuMaster::~RtuMaster() {
+  // The UART (and its event task) is deleted by the owner first
+  if (rxEvent) {
+    vSemaphoreDelete(rxEvent);
+    rxEvent = nullptr;
+  }
+}
+
+uint32_t RtuMaster::silentIntervalUs(uint32_t baudRate) {
+  if (baudRate == 0 || baudRate > 19200) {
+    return 1750;
+  }
+  return (35UL * 11UL * 1000000UL) / (10UL * baudRate);  // 3.5 x 11 bits
+}
+
+uint16_t RtuMaster::crc16Update(uint16_t crc, uint8_t byte) {
+  crc ^= byte;
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+  }
+  return crc;
+}
+
+void RtuMaster::attach(HardwareSerial* serial, uint32_t baudRate) {
+  this->serial = serial;
+  this->baudRate = baudRate;
+  charTimeUs = baudRate > 0 ? 11000000UL / baudRate : 1146;
+
+  if (!rxEvent) {
+    rxEvent = xSemaphoreCreateBinary();  // nullptr: waits fall back to polling
+  }
+  if (!serial) {
+    return;
+  }
+
+  // RX timeout event once the line has been idle for a few symbols (end of
+  // a response), FIFO-full events in between for long frames
+  serial->setRxTimeout(RX_TIMEOUT_SYMBOLS);
+  SemaphoreHandle_t event = rxEvent;
+  serial->onReceive(
+      [event]() {
+        if (event) {
+          xSemaphoreGive(event);
+        }
+      },
+      false);
+}
+
+bool RtuMaster::startRequest(const Request& request) {
+  if (!serial) {
+    return false;
+  }
+
+  uint16_t count = request.quantity;
+  switch (request.functionCode) {
+    case 1:
+    case 2:
+      if (count == 0 || count > MAX_WORDS * 16) return false;
+      break;
+    case 3:
+    case 4:
+      if (count == 0 || count > MAX_WORDS) return false;
+      break;
+    case 5:
+    case 6:
+      if (!request.values) return false;
+      count = 1;
+      break;
+    case 15:
+      if (!request.values || count == 0 || count > MAX_WORDS * 16) {
+        return false;
+      }
+      break;
+    case 16:
+      if (!request.values || count == 0 || count > MAX_WORDS) return false;
+      break;
+    default:
+      return false;
+  }
+
+  // Inter-frame silence since the last bus activity
+  uint32_t quietUs = micros() - lastActivityUs;
+  if (quietUs < request.interFrameUs) {
+    uint32_t waitUs = request.interFrameUs - quietUs;
+    if (waitUs >= 2000) {
+      vTaskDelay(pdMS_TO_TICKS(waitUs / 1000));  // Long gaps: let others run
+      waitUs %= 1000;
+    }
+    if (waitUs > 0) {
+      delayMicroseconds(waitUs);
+    }
+  }
+
+  // Late bytes of a previous (timed out) response and their events
+  while (serial->available() > 0) {
+    serial->read();
+  }
+  if (rxEvent) {
+    xSemaphoreTake(rxEvent, 0);
+  }
+
+  size_t n = 0;
+  frame[n++] = request.slaveId;
+  frame[n++] = request.functionCode;
+  frame[n++] = request.address >> 8;
+  frame[n++] = request.address & 0xFF;
+  switch (request.functionCode) {
+    case 5:
+    case 6:
+      frame[n++] = request.values[0] >> 8;
+      frame[n++] = request.values[0] & 0xFF;
+      break;
+    case 15: {
+      uint8_t byteCount = (count + 7) / 8;
+      frame[n++] = count >> 8;
+      frame[n++] = count & 0xFF;
+      frame[n++] = byteCount;
+      for (uint8_t i = 0; i < byteCount; i++) {
+        uint16_t word = request.values[i / 2];
+        frame[n++] = (i & 1) ? word >> 8 : word & 0xFF;  // LSB first
+      }
+      break;
+    }
+    case 16:
+      frame[n++] = count >> 8;
+      frame[n++] = count & 0xFF;
+      frame[n++] = count * 2;
+      for (uint16_t i = 0; i < count; i++) {
+        frame[n++] = request.values[i] >> 8;
+        frame[n++] = request.values[i] & 0xFF;
+      }
+      break;
+    default:  // FC1-4
+      frame[n++] = count >> 8;
+      frame[n++] = count & 0xFF;
+      break;
+  }
+
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < n; i++) {
+    crc = crc16Update(crc, frame[i]);
+  }
+  frame[n++] = crc & 0xFF;
+  frame[n++] = crc >> 8;
+
+  // Queued to the driver's TX buffer; the wire time is estimated instead of
+  // waiting for it (no response can start before the request has left)
+  serial->write(frame, n);
+  uint32_t txMs = (uint32_t)((n * charTimeUs + 999) / 1000);
+  sentAtMs = millis() + txMs;
+  deadlineMs = request.timeoutMs > 0 ? request.timeoutMs : DEFAULT_TIMEOUT_MS;
+
+  slaveId = request.slaveId;
+  functionCode = request.functionCode;
+  quantity = count;
+  rxLength = 0;
+  expectedLength = 0;
+  rxCrc = 0xFFFF;
+  wordCount = 0;
+  latencyMs = 0;
+  gotResponse = false;
+  resultCode = ku8MBResponseTimedOut;
+  currentState = State::WAITING;
+  return true;
+}
+
+RtuMaster::State RtuMaster::poll() {
+  if (currentState != State::WAITING) {
+    return currentState;
+  }
+
+  int available = serial->available();
+  if (available > 0) {
+    if (!gotResponse) {
+      // Buffered bytes arrived before now: back-date to the first of them
+      gotResponse = true;
+      int32_t elapsedMs = (int32_t)(millis() - sentAtMs);
+      int32_t bufferedMs = (int32_t)(((uint32_t)available * charTimeUs) / 1000);
+      latencyMs = elapsedMs > bufferedMs ? (uint32_t)(elapsedMs - bufferedMs)
+                                         : 0;
+    }
+    while (available-- > 0 && currentState == State::WAITING) {
+      int byte = serial->read();
+      if (byte < 0) {
+        break;
+      }
+      consume((uint8_t)byte);
+    }
+    lastActivityUs = micros();
+    if (currentState != State::WAITING) {
+      return currentState;
+    }
+  }
+
+  if ((int32_t)(millis() - sentAtMs) >= (int32_t)deadlineMs) {
+    finish(ku8MBResponseTimedOut);  // Nothing, or an incomplete frame
+  }
+  return currentState;
+}
+
+void RtuMaster::consume(uint8_t byte) {
+  frame[rxLength++] = byte;
+  rxCrc = crc16Update(rxCrc, byte);
+
+  if (rxLength == 1) {
+    if (byte != slaveId) {
+      finish(ku8MBInvalidSlaveID);
+    }
+    return;
+  }
+
+  if (rxLength == 2) {
+    if ((byte & 0x7F) != functionCode) {
+      finish(ku8MBInvalidFunction);
+    } else if (byte & 0x80) {
+      expectedLength = 5;  // Slave, FC | 0x80, exception code, CRC
+    } else if (functionCode >= 5) {
+      expectedLength = 8;  // Writes echo address + value / quantity
+    }
+    return;
+  }
+
+  if (rxLength == 3 && expectedLength == 0) {
+    expectedLength = 3 + byte + 2;  // Reads: byte count + data + CRC
+    if (expectedLength > FRAME_SIZE) {
+      finish(ku8MBInvalidCRC);  // Corrupted byte count
+    }
+    return;
+  }
+
+  if (expectedLength > 0 && rxLength >= expectedLength) {
+    // CRC over a frame including its own CRC is 0
+    if (rxCrc != 0) {
+      finish(ku8MBInvalidCRC);
+    } else if (frame[1] & 0x80) {
+      finish(frame[2]);  // Exception code
+    } else {
+      decodeResponse();
+      finish(ku8MBSuccess);
+    }
+  }
+}
+
+void RtuMaster::decodeResponse() {
+  wordCount = 0;
+  if (functionCode > 4) {
+    return;
+  }
+
+  uint8_t byteCount = frame[2];
+  const uint8_t* data = &frame[3];
+  if (functionCode <= 2) {
+    // Coils / inputs: bytes packed LSB first into words
+    wordCount = (byteCount + 1) / 2;
+    if (wordCount > MAX_WORDS) wordCount = MAX_WORDS;
+    for (uint16_t i = 0; i < wordCount; i++) {
+      uint16_t low = data[2 * i];
+      uint16_t high = (2 * i + 1 < byteCount) ? data[2 * i + 1] : 0;
+      words[i] = (high << 8) | low;
+    }
+  } else {
+    wordCount = byteCount / 2;
+    if (wordCount > MAX_WORDS) wordCount = MAX_WORDS;
+    for (uint16_t i = 0; i < wordCount; i++) {
+      words[i] = ((uint16_t)data[2 * i] << 8) | data[2 * i + 1];
+    }
+  }
+}
+
+void RtuMaster::finish(uint8_t code) {
+  resultCode = code;
+  currentState = State::DONE;
+  lastActivityUs = micros();  // Start of the next inter-frame silence
+}
+
+uint8_t RtuMaster::waitForResponse() {
+  while (poll() == State::WAITING) {
+    int32_t remainingMs =
+        (int32_t)deadlineMs - (int32_t)(millis() - sentAtMs);
+    TickType_t ticks = remainingMs > 0 ? pdMS_TO_TICKS(remainingMs) : 0;
+    if (ticks == 0) {
+      ticks = 1;
+    }
+    if (rxEvent) {
+      xSemaphoreTake(rxEvent, ticks);  // Given by the UART event task
+    } else {
+      vTaskDelay(1);
+    }
+  }
+  return resultCode;
+}
+
+uint8_t RtuMaster::transact(const Request& request) {
+  if (!startRequest(request)) {
+    currentState = State::IDLE;
+    resultCode = ku8MBInvalidFunction;
+    return resultCode;
+  }
+  return waitForResponse();
+}
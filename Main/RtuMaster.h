@@ -0,0 +1,161 @@
+#ifndef RTU_MASTER_H
+#define RTU_MASTER_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * RtuMaster - Event-driven Modbus RTU master on one RS485 UART
+ *
+ * v1.3.3: Replaces ModbusMaster + RtuBusStream
+ * Previous: ModbusMaster polled the UART byte by byte until the response was
+ * complete. RtuBusStream wrapped the UART so the library could be given a
+ * per-device timeout (by injecting a mismatching frame) and so the wait
+ * yielded with vTaskDelay(1) per empty poll. The response CRC was computed
+ * only after the whole frame had been buffered.
+ * New: Requests are framed here and handed to the UART driver's TX buffer
+ * (startRequest() returns immediately). The UART driver's RX-timeout /
+ * FIFO-full events (HardwareSerial::onReceive) wake the waiting task, which
+ * consumes the received bytes with poll(). The CRC is updated per byte, and
+ * the frame ends at its expected length (known from the function code and
+ * byte count), so nothing waits for a 3.5 character gap.
+ * - Per-request response timeout (no library constant to work around)
+ * - Inter-frame silence before the request (3.5 character times default)
+ * - responseLatencyMs(): request sent -> first response byte
+ *
+ * Result codes keep the ModbusMaster values (logged and returned in BLE
+ * write responses).
+ *
+ * Not thread-safe: the owner holds the bus lock for the whole transaction.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class RtuMaster {
+ public:
+  // Modbus exception codes (slave responses)
+  static constexpr uint8_t ku8MBSuccess = 0x00;
+  static constexpr uint8_t ku8MBIllegalFunction = 0x01;
+  static constexpr uint8_t ku8MBIllegalDataAddress = 0x02;
+  static constexpr uint8_t ku8MBIllegalDataValue = 0x03;
+  static constexpr uint8_t ku8MBSlaveDeviceFailure = 0x04;
+  // Master-side errors
+  static constexpr uint8_t ku8MBInvalidSlaveID = 0xE0;
+  static constexpr uint8_t ku8MBInvalidFunction = 0xE1;
+  static constexpr uint8_t ku8MBResponseTimedOut = 0xE2;
+  static constexpr uint8_t ku8MBInvalidCRC = 0xE3;
+
+  // Response words per request (reads: registers, or coils / 16)
+  static constexpr uint16_t MAX_WORDS = 64;
+  // Used when a device configures no response timeout
+  static constexpr uint32_t DEFAULT_TIMEOUT_MS = 2000;
+  // UART RX timeout event after this many idle symbols (end of a burst)
+  static constexpr uint8_t RX_TIMEOUT_SYMBOLS = 2;
+
+  enum class State : uint8_t {
+    IDLE,     // No request
+    WAITING,  // Request sent, response incomplete
+    DONE      // result() is final
+  };
+
+  struct Request {
+    uint8_t slaveId = 1;
+    uint8_t functionCode = 3;  // 1-6, 15, 16
+    uint16_t address = 0;
+    uint16_t quantity = 1;  // Registers / coils (FC5 / FC6: 1)
+    // FC5: values[0] = 0xFF00 / 0x0000, FC6: values[0], FC15: coil bits
+    // (LSB first, 16 per word), FC16: registers. Copied by startRequest().
+    const uint16_t* values = nullptr;
+    uint32_t timeoutMs = 0;     // 0 = DEFAULT_TIMEOUT_MS
+    uint32_t interFrameUs = 0;  // Bus silence before the request
+  };
+
+  RtuMaster();
+  ~RtuMaster();
+
+  RtuMaster(const RtuMaster&) = delete;
+  RtuMaster& operator=(const RtuMaster&) = delete;
+
+  /**
+   * Bind to a started UART (again after every begin(), e.g. baud change):
+   * registers the RX event callback and the RX timeout
+   */
+  void attach(HardwareSerial* serial, uint32_t baudRate);
+
+  /**
+   * Wait for inter-frame silence, frame the request and queue it to the UART
+   * TX buffer. Does not wait for the response.
+   * @return false if no UART is attached or the request is invalid
+   */
+  bool startRequest(const Request& request);
+
+  /**
+   * Consume received bytes and check the timeout (non-blocking)
+   */
+  State poll();
+
+  /**
+   * Block on UART RX events until the running request is DONE
+   * @return result()
+   */
+  uint8_t waitForResponse();
+
+  // startRequest() + waitForResponse()
+  uint8_t transact(const Request& request);
+
+  State state() const { return currentState; }
+  uint8_t result() const { return resultCode; }
+  bool responded() const { return gotResponse; }
+  uint32_t responseLatencyMs() const { return latencyMs; }
+
+  // Response data of a successful read (FC1/2: bits packed LSB first)
+  uint16_t responseWordCount() const { return wordCount; }
+  uint16_t getResponseWord(uint16_t index) const {
+    return index < wordCount ? words[index] : 0;
+  }
+
+  /**
+   * Modbus RTU t3.5 in microseconds (11 bits per character; fixed 1750us
+   * above 19200 baud as recommended by the Modbus serial line spec)
+   */
+  static uint32_t silentIntervalUs(uint32_t baudRate);
+
+  // Modbus CRC-16 (poly 0xA001, init 0xFFFF), one byte
+  static uint16_t crc16Update(uint16_t crc, uint8_t byte);
+
+ private:
+  static constexpr size_t FRAME_SIZE = 256;  // Max RTU ADU
+
+  HardwareSerial* serial;
+  SemaphoreHandle_t rxEvent;  // Given from the UART event task
+  uint32_t baudRate;
+  uint32_t charTimeUs;  // 11 bits per character
+
+  State currentState;
+  uint8_t resultCode;
+  uint8_t slaveId;
+  uint8_t functionCode;
+  uint16_t quantity;
+
+  uint8_t frame[FRAME_SIZE];  // Request, then response
+  uint16_t rxLength;
+  uint16_t expectedLength;  // 0 = not known yet
+  uint16_t rxCrc;           // Running CRC over the received bytes
+
+  uint16_t words[MAX_WORDS];
+  uint16_t wordCount;
+
+  uint32_t sentAtMs;    // Request fully transmitted (estimated)
+  uint32_t deadlineMs;  // Relative to sentAtMs
+  uint32_t lastActivityUs;
+  uint32_t latencyMs;
+  bool gotResponse;
+
+  void consume(uint8_t byte);
+  void finish(uint8_t code);
+  void decodeResponse();
+};
+
+#endif  // RTU_MASTER_H
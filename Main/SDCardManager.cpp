@@ -0,0 +1,334 @@
+#include "SDCardManager.h"
+
+#include "DebugConfig.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+
+SDCardManager* SDCardManager::instance = nullptr;
+
+SDCardManager::SDCardManager()
+    : currentState(SD_NOT_INITIALIZED),
+      sdMutex(nullptr),
+      taskHandle(nullptr),
+      taskRunning(false),
+      ioErrorPending(false),
+#if SD_MODE == SD_MODE_SPI
+      sdSPI(nullptr),
+#endif
+      lastCardCheck(0),
+      lastMountAttempt(0) {
+  sdMutex = xSemaphoreCreateMutex();
+}
+
+SDCardManager::~SDCardManager() {
+  stop();
+  if (sdMutex) {
+    vSemaphoreDelete(sdMutex);
+    sdMutex = nullptr;
+  }
+}
+
+SDCardManager* SDCardManager::getInstance() {
+  if (!instance) {
+    instance = new SDCardManager();
+  }
+  return instance;
+}
+
+fs::FS& SDCardManager::fileSystem() {
+#if SD_MODE == SD_MODE_SDMMC
+  return SD_MMC;
+#else
+  return SD;
+#endif
+}
+
+bool SDCardManager::init() {
+  if (!sdMutex) {
+    LOG_SD_ERROR("Mutex creation failed, SD card disabled\n");
+    return false;
+  }
+  if (currentState != SD_NOT_INITIALIZED) {
+    return true;
+  }
+
+#if SD_MODE == SD_MODE_SPI
+  // Separate bus from the W5500 (default SPI) - no shared chip selects
+  sdSPI = new SPIClass(HSPI);
+  sdSPI->begin(SCK_PIN, MISO_PIN, MOSI_PIN, CS_PIN);
+#elif SD_MODE == SD_MODE_SDMMC
+  SD_MMC.setPins(SCK_PIN, CS_PIN, MISO_PIN);
+#endif
+
+  xSemaphoreTake(sdMutex, portMAX_DELAY);
+  lastMountAttempt = millis();
+  if (mountCard()) {
+    updateCardInfo();
+    setState(SD_READY);
+  } else {
+    setState(SD_REMOVED);
+  }
+  xSemaphoreGive(sdMutex);
+
+  if (currentState == SD_READY) {
+    LOG_SD_INFO("Card mounted: %llu MB, %llu MB free\n", info.cardSizeMB,
+                (info.totalBytes - info.usedBytes) / (1024 * 1024));
+  } else {
+    LOG_SD_INFO("No card at startup (mounted when inserted)\n");
+  }
+  return true;
+}
+
+bool SDCardManager::start() {
+  if (taskRunning) {
+    return true;
+  }
+  taskRunning = true;
+  BaseType_t result =
+      TaskAffinity::create(taskTrampoline, "SD_CARD_TASK", TASK_STACK_SIZE,
+                           this, TaskAffinity::Task::SD_MONITOR, &taskHandle);
+  if (result != pdPASS) {
+    LOG_SD_ERROR("Monitor task creation failed\n");
+    taskRunning = false;
+    taskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void SDCardManager::stop() {
+  if (taskRunning && taskHandle) {
+    taskRunning = false;
+    vTaskDelete(taskHandle);
+    taskHandle = nullptr;
+  }
+}
+
+void SDCardManager::taskTrampoline(void* param) {
+  static_cast<SDCardManager*>(param)->taskLoop();
+}
+
+void SDCardManager::taskLoop() {
+  while (taskRunning) {
+    unsigned long now = millis();
+    if (now - lastCardCheck >= CHECK_INTERVAL_MS || ioErrorPending) {
+      lastCardCheck = now;
+      if (xSemaphoreTake(sdMutex, pdMS_TO_TICKS(MUTEX_TIMEOUT_MS)) ==
+          pdTRUE) {
+        checkCard();
+        xSemaphoreGive(sdMutex);
+      }
+    }
+    vTaskDelay(pdMS_TO_TICKS(200));
+  }
+  vTaskDelete(NULL);
+}
+
+void SDCardManager::checkCard() {
+  // Caller holds sdMutex
+  switch (currentState) {
+    case SD_READY:
+      if (ioErrorPending || !checkCardPresence()) {
+        LOG_SD_WARN("Card %s, unmounting\n",
+                    ioErrorPending ? "I/O error" : "removed");
+        unmountCard();
+        info.unmountCount++;
+        info.reconnectAttempts = 0;
+        setState(SD_REMOVED);
+      }
+      ioErrorPending = false;
+      break;
+
+    case SD_REMOVED:
+    case SD_RECONNECTING:
+      setState(SD_RECONNECTING);
+      info.reconnectAttempts++;
+      lastMountAttempt = millis();
+      if (mountCard()) {
+        updateCardInfo();
+        info.reconnectAttempts = 0;
+        setState(SD_READY);
+        LOG_SD_INFO("Card mounted (generation %lu)\n",
+                    (unsigned long)info.mountCount);
+      } else if (info.reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
+        setState(SD_ERROR);
+      }
+      break;
+
+    case SD_ERROR:
+      // No card detect pin: keep probing, but slowly (a mount attempt holds
+      // the bus for up to a second)
+      if (millis() - lastMountAttempt >= ERROR_RETRY_INTERVAL_MS) {
+        info.reconnectAttempts = 0;
+        setState(SD_RECONNECTING);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+bool SDCardManager::mountCard() {
+#if SD_MODE == SD_MODE_SPI
+  if (!SD.begin(CS_PIN, *sdSPI, SPI_FREQUENCY, "/sd", 5)) {
+    SD.end();
+    if (!SD.begin(CS_PIN, *sdSPI, SPI_FALLBACK_FREQUENCY, "/sd", 5)) {
+      SD.end();
+      return false;
+    }
+  }
+#elif SD_MODE == SD_MODE_SDMMC
+  if (!SD_MMC.begin("/sdcard", true)) {  // 1-bit mode
+    return false;
+  }
+#endif
+  if (!checkCardPresence()) {
+    unmountCard();
+    return false;
+  }
+  info.mountCount++;
+  return true;
+}
+
+void SDCardManager::unmountCard() {
+#if SD_MODE == SD_MODE_SPI
+  SD.end();
+#elif SD_MODE == SD_MODE_SDMMC
+  SD_MMC.end();
+#endif
+}
+
+bool SDCardManager::checkCardPresence() {
+#if SD_MODE == SD_MODE_SPI
+  return SD.cardType() != CARD_NONE;
+#elif SD_MODE == SD_MODE_SDMMC
+  return SD_MMC.cardType() != CARD_NONE;
+#endif
+}
+
+void SDCardManager::updateCardInfo() {
+#if SD_MODE == SD_MODE_SPI
+  info.cardType = SD.cardType();
+  info.cardSizeMB = SD.cardSize() / (1024 * 1024);
+  info.totalBytes = SD.totalBytes();
+  info.usedBytes = SD.usedBytes();
+#elif SD_MODE == SD_MODE_SDMMC
+  info.cardType = SD_MMC.cardType();
+  info.cardSizeMB = SD_MMC.cardSize() / (1024 * 1024);
+  info.totalBytes = SD_MMC.totalBytes();
+  info.usedBytes = SD_MMC.usedBytes();
+#endif
+}
+
+void SDCardManager::setState(SDCardState newState) {
+  if (currentState == newState) {
+    return;
+  }
+  LOG_SD_INFO("%s -> %s\n", getStateString(),
+              newState == SD_READY          ? "READY"
+              : newState == SD_REMOVED      ? "REMOVED"
+              : newState == SD_RECONNECTING ? "RECONNECTING"
+              : newState == SD_ERROR        ? "ERROR"
+                                            : "DISABLED");
+  currentState = newState;
+  info.state = newState;
+}
+
+const char* SDCardManager::getStateString() const {
+  switch (currentState) {
+    case SD_NOT_INITIALIZED:
+      return "NOT_INITIALIZED";
+    case SD_READY:
+      return "READY";
+    case SD_REMOVED:
+      return "REMOVED";
+    case SD_RECONNECTING:
+      return "RECONNECTING";
+    case SD_ERROR:
+      return "ERROR";
+    case SD_DISABLED:
+      return "DISABLED";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+SDCardInfo SDCardManager::getInfo() {
+  SDCardInfo copy;
+  if (sdMutex &&
+      xSemaphoreTake(sdMutex, pdMS_TO_TICKS(MUTEX_TIMEOUT_MS)) == pdTRUE) {
+    copy = info;
+    xSemaphoreGive(sdMutex);
+  } else {
+    copy = info;  // Possibly torn, diagnostics only
+  }
+  return copy;
+}
+
+bool SDCardManager::lock(uint32_t timeoutMs) {
+  return sdMutex &&
+         xSemaphoreTake(sdMutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void SDCardManager::unlock() { xSemaphoreGive(sdMutex); }
+
+uint64_t SDCardManager::freeBytes() {
+  if (currentState != SD_READY) {
+    return 0;
+  }
+  updateCardInfo();
+  return (info.totalBytes > info.usedBytes)
+             ? info.totalBytes - info.usedBytes
+             : 0;
+}
+
+void SDCardManager::reportIoError() {
+  info.ioErrors++;
+  ioErrorPending = true;
+}
+
+bool SDCardManager::forceReconnect() {
+  if (currentState == SD_READY) {
+    return true;
+  }
+  if (currentState == SD_DISABLED || !lock()) {
+    return false;
+  }
+  info.reconnectAttempts = 0;
+  setState(SD_RECONNECTING);
+  unlock();
+  return true;
+}
+
+void SDCardManager::disable() {
+  if (!lock()) {
+    return;
+  }
+  if (currentState == SD_READY) {
+    unmountCard();
+    info.unmountCount++;
+  }
+  setState(SD_DISABLED);
+  unlock();
+}
+
+void SDCardManager::enable() {
+  if (currentState != SD_DISABLED || !lock()) {
+    return;
+  }
+  info.reconnectAttempts = 0;
+  setState(SD_RECONNECTING);
+  unlock();
+}
+
+void SDCardManager::printStatus() {
+  SDCardInfo i = getInfo();
+  Serial.println("\n[SD] SD CARD STATUS");
+  Serial.printf("  State: %s\n", getStateString());
+  Serial.printf("  Card size: %llu MB\n", i.cardSizeMB);
+  Serial.printf("  Used / total: %llu / %llu MB\n", i.usedBytes / (1024 * 1024),
+                i.totalBytes / (1024 * 1024));
+  Serial.printf("  Mounts: %lu | Unmounts: %lu | I/O errors: %lu\n\n",
+                (unsigned long)i.mountCount, (unsigned long)i.unmountCount,
+                (unsigned long)i.ioErrors);
+}
@@ -0,0 +1,165 @@
+#ifndef SD_CARD_MANAGER_H
+#define SD_CARD_MANAGER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <SD.h>
+#include <SPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * SDCardManager - Hot-plug microSD card on its own SPI bus
+ *
+ * v1.3.3: Production port of HardwareSamples/SD_Card_Logging_Test
+ * Previous: the SD card manager only existed as a hardware sample. The
+ * firmware buffered offline MQTT messages on the LittleFS partition only, so
+ * a long backhaul outage ended in dropped data once the partition was full.
+ * New: the manager mounts the card on HSPI (separate from the W5500 bus),
+ * detects removal and re-insertion from a background task and serializes all
+ * card access with one mutex. MQTTPersistentQueue uses the card as the
+ * overflow tier of its disk log.
+ *
+ * Users hold lock() around any File work on fileSystem(). A remount
+ * increments getMountGeneration(); files opened before it are invalid.
+ * Report failed card I/O with reportIoError() - the SPI driver does not
+ * notice a removed card by itself, the next check then remounts it.
+ *
+ * Hardware: CS 11, MOSI 10, MISO 13, SCK 12 (HSPI / SPI3)
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+#ifndef SD_CARD_ENABLED
+#define SD_CARD_ENABLED 1
+#endif
+
+#define SD_MODE_SPI 1    // HSPI (separate from the Ethernet SPI bus)
+#define SD_MODE_SDMMC 2  // Native SDMMC peripheral (1-bit)
+
+#ifndef SD_MODE
+#define SD_MODE SD_MODE_SPI
+#endif
+
+#if SD_MODE == SD_MODE_SDMMC
+#include <SD_MMC.h>
+#endif
+
+// ESP32-S3: HSPI is the second user SPI bus (Arduino core 3.x has no macro)
+#ifndef HSPI
+#define HSPI 2
+#endif
+
+enum SDCardState {
+  SD_NOT_INITIALIZED = 0,  // init() not called
+  SD_READY,                // Card mounted
+  SD_REMOVED,              // No card (or unmounted after an I/O error)
+  SD_RECONNECTING,         // Mount attempts running
+  SD_ERROR,                // Mount attempts exhausted (slow retry)
+  SD_DISABLED              // Disabled by disable()
+};
+
+struct SDCardInfo {
+  SDCardState state = SD_NOT_INITIALIZED;
+  uint8_t cardType = 0;  // CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC
+  uint64_t cardSizeMB = 0;
+  uint64_t totalBytes = 0;
+  uint64_t usedBytes = 0;
+
+  uint32_t mountCount = 0;    // Successful mounts (= mount generation)
+  uint32_t unmountCount = 0;  // Removals / I/O error unmounts
+  uint32_t ioErrors = 0;      // reportIoError() calls
+  uint32_t reconnectAttempts = 0;
+};
+
+class SDCardManager {
+ public:
+  static constexpr int CS_PIN = 11;
+  static constexpr int MOSI_PIN = 10;
+  static constexpr int MISO_PIN = 13;
+  static constexpr int SCK_PIN = 12;
+
+  static constexpr uint32_t SPI_FREQUENCY = 4000000;       // 4 MHz
+  static constexpr uint32_t SPI_FALLBACK_FREQUENCY = 1000000;
+  static constexpr uint32_t CHECK_INTERVAL_MS = 2000;      // Presence check
+  static constexpr uint32_t ERROR_RETRY_INTERVAL_MS = 30000;
+  static constexpr uint32_t MAX_RECONNECT_ATTEMPTS = 3;
+  static constexpr uint32_t MUTEX_TIMEOUT_MS = 500;
+  static constexpr uint32_t TASK_STACK_SIZE = 4096;
+
+  static SDCardManager* getInstance();
+
+  SDCardManager(const SDCardManager&) = delete;
+  SDCardManager& operator=(const SDCardManager&) = delete;
+
+  /**
+   * Configure the bus and try the first mount
+   * @return false only if the mutex cannot be created (no card is not an
+   * error, the monitor task mounts it when inserted)
+   */
+  bool init();
+
+  // Background presence check / remount task
+  bool start();
+  void stop();
+
+  SDCardState getState() const { return currentState; }
+  const char* getStateString() const;
+  bool isReady() const { return currentState == SD_READY; }
+  SDCardInfo getInfo();
+
+  /**
+   * Exclusive card access (every File operation on fileSystem())
+   */
+  bool lock(uint32_t timeoutMs = MUTEX_TIMEOUT_MS);
+  void unlock();
+
+  static fs::FS& fileSystem();
+
+  // Incremented by every mount (caller holds lock())
+  uint32_t getMountGeneration() const { return info.mountCount; }
+
+  // Free card space in bytes (caller holds lock())
+  uint64_t freeBytes();
+
+  // Card I/O failed: unmount and remount on the next check
+  void reportIoError();
+
+  bool forceReconnect();
+  void disable();
+  void enable();
+
+  void printStatus();
+
+  void taskLoop();
+
+ private:
+  static SDCardManager* instance;
+
+  volatile SDCardState currentState;
+  SDCardInfo info;
+  SemaphoreHandle_t sdMutex;
+  TaskHandle_t taskHandle;
+  bool taskRunning;
+  volatile bool ioErrorPending;
+#if SD_MODE == SD_MODE_SPI
+  SPIClass* sdSPI;
+#endif
+  unsigned long lastCardCheck;
+  unsigned long lastMountAttempt;
+
+  SDCardManager();
+  ~SDCardManager();
+
+  bool mountCard();
+  void unmountCard();
+  bool checkCardPresence();
+  void updateCardInfo();
+  void setState(SDCardState newState);
+  void checkCard();
+
+  static void taskTrampoline(void* param);
+};
+
+#endif  // SD_CARD_MANAGER_H
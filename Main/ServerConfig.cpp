@@ -4,7 +4,8 @@
 
 #include <new>
 
-#include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
+#include "DebugConfig.h"    // MUST BE FIRST for LOG_* macros
+#include "PayloadFormat.h"  // v1.3.3: payload_format validation
 
 const char* ServerConfig::CONFIG_FILE = "/server_config.json";
 
@@ -102,6 +103,14 @@ void ServerConfig::createDefaultConfig() {
   mqtt["clean_session"] = true;
   mqtt["use_tls"] = false;
   mqtt["publish_mode"] = "default";  // "default" or "customize"
+  mqtt["payload_format"] = "json";   // v1.3.3: "json", "msgpack" or "cbor"
+  mqtt["aggregation"] = "last";      // v1.3.3: "last" or "window"
+  mqtt["publish_qos"] = 1;           // v1.3.3: 0 or 1 (PUBACK before dequeue)
+  mqtt["inflight_window"] = 8;       // v1.3.3: QoS 1 PUBLISH awaiting PUBACK
+  mqtt["catch_up_batch"] = 1;        // v1.3.3: Backlog records per publish
+  mqtt["catch_up_live_share"] = 30;  // v1.3.3: % of broker rate for live data
+  mqtt["diagnostics_topic"] = "";    // v1.3.3: Task profiler (empty = off)
+  mqtt["diagnostics_interval"] = 60;  // v1.3.3: Seconds
 
   // Default mode configuration (for MQTT modes feature)
   JsonObject defaultMode = mqtt["default_mode"].to<JsonObject>();
@@ -111,6 +120,7 @@ void ServerConfig::createDefaultConfig() {
   defaultMode["interval"] = 5;
   defaultMode["interval_unit"] =
       "s";  // "ms" (milliseconds), "s" (seconds), "m" (minutes)
+  defaultMode["payload_layout"] = "nested";  // v1.3.3: or "compact"
 
   // Customize mode configuration (for MQTT modes feature)
   JsonObject customizeMode = mqtt["customize_mode"].to<JsonObject>();
@@ -139,14 +149,39 @@ void ServerConfig::createDefaultConfig() {
   http["endpoint_url"] = "https://api.example.com/data";
   http["method"] = "POST";
   http["body_format"] = "json";
+  http["payload_format"] = "json";  // v1.3.3: "json", "msgpack" or "cbor"
   http["timeout"] = 5000;
   http["retry"] = 3;
-  http["interval"] = 5;         // HTTP transmission interval
-  http["interval_unit"] = "s";  // "ms", "s", or "m"
+  http["batch_size"] = 1;        // v1.3.3: Data points per request
+  http["compression"] = "none";  // v1.3.3: "none" or "gzip"
+  http["layout"] = "points";     // v1.3.3: "points" or "cycle"
+  http["interval"] = 5;          // HTTP transmission interval
+  http["interval_unit"] = "s";   // "ms", "s", or "m"
 
   JsonObject headers = http["headers"].to<JsonObject>();
   headers["Authorization"] = "Bearer token";
   headers["Content-Type"] = "application/json";
+
+  // v1.3.3: Modbus TCP server (SCADA/HMI read the latest values)
+  JsonObject modbusServer = root["modbus_server"].to<JsonObject>();
+  modbusServer["enabled"] = false;
+  modbusServer["port"] = 502;
+  modbusServer["max_clients"] = 2;     // W5500 sockets are shared with polling
+  modbusServer["idle_timeout"] = 60;   // Seconds without a request
+  modbusServer["stale_timeout"] = 0;   // Seconds (0 = values never expire)
+
+  // v1.3.3: On-device register history (BLE "read history")
+  JsonObject history = root["history"].to<JsonObject>();
+  history["enabled"] = true;
+  history["retention"] = 60;   // Minutes
+  history["interval"] = 10;    // Seconds per sample
+  history["memory_kb"] = 256;  // PSRAM pool
+
+  // v1.3.3: Device polling cycles ("free" = per-device refresh_rate_ms)
+  JsonObject acquisition = root["acquisition"].to<JsonObject>();
+  acquisition["mode"] = "free";  // "free" or "aligned"
+  acquisition["cycle"] = 10;     // Seconds between aligned cycles
+  acquisition["deadline"] = 80;  // % of the cycle before publishing anyway
 }
 
 bool ServerConfig::saveConfig() {
@@ -402,6 +437,62 @@ ConfigValidationResult ServerConfig::validateConfigEnhanced(
               "Set publish_mode to 'default' or 'customize'");
         }
 
+        // v1.3.3: Validate payload_format if present
+        PayloadFormat mqttFormat;
+        if (!parsePayloadFormat(mqtt["payload_format"] | "json", mqttFormat)) {
+          return ConfigValidationResult::error(
+              509,
+              "Invalid payload_format. Must be 'json', 'msgpack' or 'cbor'",
+              "mqtt_config.payload_format",
+              "Use 'json' (default) or a binary format for metered links");
+        }
+
+        // v1.3.3: Validate aggregation if present
+        String aggregation = mqtt["aggregation"] | "last";
+        if (!aggregation.equalsIgnoreCase("last") &&
+            !aggregation.equalsIgnoreCase("window")) {
+          return ConfigValidationResult::error(
+              509, "Invalid aggregation. Must be 'last' or 'window'",
+              "mqtt_config.aggregation",
+              "Use 'window' to publish min/max/avg/count per interval");
+        }
+
+        // v1.3.3: Validate publish_qos / inflight_window if present
+        int publishQos = mqtt["publish_qos"] | 1;
+        if (publishQos != 0 && publishQos != 1) {
+          return ConfigValidationResult::error(
+              509, "Invalid publish_qos. Must be 0 or 1",
+              "mqtt_config.publish_qos",
+              "QoS 2 is not supported; use 1 for acknowledged delivery");
+        }
+        int inflightWindow = mqtt["inflight_window"] | 8;
+        if (inflightWindow < 1 || inflightWindow > 16) {
+          return ConfigValidationResult::error(
+              509, "MQTT inflight_window must be between 1 and 16",
+              "mqtt_config.inflight_window", "Recommended value is 8");
+        }
+        // v1.3.3: Validate catch_up_batch / catch_up_live_share if present
+        int catchUpBatch = mqtt["catch_up_batch"] | 1;
+        if (catchUpBatch < 1 || catchUpBatch > 50) {
+          return ConfigValidationResult::error(
+              509, "MQTT catch_up_batch must be between 1 and 50",
+              "mqtt_config.catch_up_batch",
+              "Use 1 unless the receiver accepts JSON arrays");
+        }
+        int liveShare = mqtt["catch_up_live_share"] | 30;
+        if (liveShare < 0 || liveShare > 90) {
+          return ConfigValidationResult::error(
+              509, "MQTT catch_up_live_share must be between 0 and 90",
+              "mqtt_config.catch_up_live_share", "Recommended value is 30");
+        }
+        int diagnosticsInterval = mqtt["diagnostics_interval"] | 60;
+        if (diagnosticsInterval < 10 || diagnosticsInterval > 86400) {
+          return ConfigValidationResult::error(
+              509, "MQTT diagnostics_interval must be between 10 and 86400",
+              "mqtt_config.diagnostics_interval",
+              "Interval is in seconds; recommended value is 60");
+        }
+
         // Validate interval_unit if present
         // v1.0.6 FIX: Case-insensitive comparison
         JsonObjectConst defaultMode = mqtt["default_mode"];
@@ -424,6 +515,16 @@ ConfigValidationResult ServerConfig::validateConfigEnhanced(
                 "mqtt_config.default_mode.interval",
                 "Set a reasonable data transmission interval");
           }
+
+          // v1.3.3: Validate payload_layout if present
+          String layout = defaultMode["payload_layout"] | "nested";
+          if (!layout.equalsIgnoreCase("nested") &&
+              !layout.equalsIgnoreCase("compact")) {
+            return ConfigValidationResult::error(
+                509, "Invalid payload_layout. Must be 'nested' or 'compact'",
+                "mqtt_config.default_mode.payload_layout",
+                "Use 'compact' to send a schema once and value arrays after");
+          }
         }
       }
     }
@@ -464,6 +565,16 @@ ConfigValidationResult ServerConfig::validateConfigEnhanced(
               "Use a valid HTTP method (POST is recommended for telemetry)");
         }
 
+        // v1.3.3: Validate payload_format if present
+        PayloadFormat httpFormat;
+        if (!parsePayloadFormat(http["payload_format"] | "json", httpFormat)) {
+          return ConfigValidationResult::error(
+              509,
+              "Invalid payload_format. Must be 'json', 'msgpack' or 'cbor'",
+              "http_config.payload_format",
+              "Use 'json' (default) or a binary format for metered links");
+        }
+
         // Validate timeout
         int timeout = http["timeout"] | 5000;
         if (timeout < 1000 || timeout > 30000) {
@@ -481,6 +592,36 @@ ConfigValidationResult ServerConfig::validateConfigEnhanced(
               "http_config.retry", "Recommended retry count is 3");
         }
 
+        // v1.3.3: Validate batch size (1 = one data point object per request)
+        int batchSize = http["batch_size"] | 1;
+        if (batchSize < 1 || batchSize > 100) {
+          return ConfigValidationResult::error(
+              509, "HTTP batch size must be between 1 and 100",
+              "http_config.batch_size",
+              "Use 1 for one object per request, or 20-50 for JSON arrays");
+        }
+
+        // v1.3.3: Validate compression if present
+        String compression = http["compression"] | "none";
+        if (!compression.equalsIgnoreCase("none") &&
+            !compression.equalsIgnoreCase("gzip")) {
+          return ConfigValidationResult::error(
+              509, "Invalid compression. Must be 'none' or 'gzip'",
+              "http_config.compression",
+              "Use 'gzip' only if the endpoint accepts Content-Encoding: gzip");
+        }
+
+        // v1.3.3: Validate layout if present
+        String layout = http["layout"] | "points";
+        if (!layout.equalsIgnoreCase("points") &&
+            !layout.equalsIgnoreCase("cycle")) {
+          return ConfigValidationResult::error(
+              509, "Invalid layout. Must be 'points' or 'cycle'",
+              "http_config.layout",
+              "Use 'cycle' to send the MQTT default-mode payload of each "
+              "cycle");
+        }
+
         // Validate interval_unit if present
         // v1.0.6 FIX: Case-insensitive comparison
         String intervalUnit = http["interval_unit"] | "s";
@@ -504,6 +645,95 @@ ConfigValidationResult ServerConfig::validateConfigEnhanced(
     }
   }
 
+  // 8. v1.3.3: Modbus TCP server validation (independent of protocol)
+  JsonObjectConst modbusServer = cfg["modbus_server"];
+  if (modbusServer && (modbusServer["enabled"] | false)) {
+    int port = modbusServer["port"] | 502;
+    if (port < 1 || port > 65535) {
+      return ConfigValidationResult::error(
+          509, "Modbus server port must be between 1 and 65535",
+          "modbus_server.port", "Standard Modbus TCP port is 502");
+    }
+
+    int maxClients = modbusServer["max_clients"] | 2;
+    if (maxClients < 1 || maxClients > 4) {
+      return ConfigValidationResult::error(
+          509, "Modbus server max_clients must be between 1 and 4",
+          "modbus_server.max_clients",
+          "Each client uses a network socket shared with device polling");
+    }
+
+    int idleTimeout = modbusServer["idle_timeout"] | 60;
+    if (idleTimeout < 5 || idleTimeout > 3600) {
+      return ConfigValidationResult::error(
+          509, "Modbus server idle_timeout must be between 5 and 3600 seconds",
+          "modbus_server.idle_timeout", "Recommended value is 60 seconds");
+    }
+
+    int staleTimeout = modbusServer["stale_timeout"] | 0;
+    if (staleTimeout < 0 || staleTimeout > 86400) {
+      return ConfigValidationResult::error(
+          509, "Modbus server stale_timeout must be between 0 and 86400",
+          "modbus_server.stale_timeout",
+          "Use 0 to serve the last value regardless of its age");
+    }
+  }
+
+  // 9. v1.3.3: Register history validation
+  JsonObjectConst history = cfg["history"];
+  if (history && (history["enabled"] | true)) {
+    int retention = history["retention"] | 60;
+    if (retention < 5 || retention > 1440) {
+      return ConfigValidationResult::error(
+          509, "History retention must be between 5 and 1440 minutes",
+          "history.retention", "Recommended value is 60 minutes");
+    }
+
+    int interval = history["interval"] | 10;
+    if (interval < 1 || interval > 600) {
+      return ConfigValidationResult::error(
+          509, "History interval must be between 1 and 600 seconds",
+          "history.interval",
+          "Reads within one interval are averaged into one sample");
+    }
+
+    int memoryKb = history["memory_kb"] | 256;
+    if (memoryKb < 32 || memoryKb > 2048) {
+      return ConfigValidationResult::error(
+          509, "History memory_kb must be between 32 and 2048",
+          "history.memory_kb",
+          "256 KB holds ~38000 samples (1 hour of 100 registers at 10 s)");
+    }
+  }
+
+  // 10. v1.3.3: Acquisition cycle validation
+  JsonObjectConst acquisition = cfg["acquisition"];
+  if (acquisition) {
+    String mode = acquisition["mode"] | "free";
+    if (mode != "free" && mode != "aligned") {
+      return ConfigValidationResult::error(
+          509, "Acquisition mode must be \"free\" or \"aligned\"",
+          "acquisition.mode",
+          "Use \"aligned\" for time-coherent snapshots across devices");
+    }
+
+    int cycle = acquisition["cycle"] | 10;
+    if (cycle < 1 || cycle > 3600) {
+      return ConfigValidationResult::error(
+          509, "Acquisition cycle must be between 1 and 3600 seconds",
+          "acquisition.cycle",
+          "Device refresh rates are rounded up to whole cycles");
+    }
+
+    int deadline = acquisition["deadline"] | 80;
+    if (deadline < 10 || deadline > 100) {
+      return ConfigValidationResult::error(
+          509, "Acquisition deadline must be between 10 and 100 percent",
+          "acquisition.deadline",
+          "Share of the cycle a publish waits for slow devices");
+    }
+  }
+
   // All validations passed
   LOG_CONFIG_INFO("[SERVER] Configuration validation passed");
   return ConfigValidationResult::success();
@@ -539,6 +769,14 @@ bool ServerConfig::getConfig(JsonObject& result) {
   if (mqtt["clean_session"].isNull()) mqtt["clean_session"] = true;
   if (mqtt["use_tls"].isNull()) mqtt["use_tls"] = false;
   if (mqtt["publish_mode"].isNull()) mqtt["publish_mode"] = "default";
+  if (mqtt["payload_format"].isNull()) mqtt["payload_format"] = "json";
+  if (mqtt["aggregation"].isNull()) mqtt["aggregation"] = "last";
+  if (mqtt["publish_qos"].isNull()) mqtt["publish_qos"] = 1;
+  if (mqtt["inflight_window"].isNull()) mqtt["inflight_window"] = 8;
+  if (mqtt["catch_up_batch"].isNull()) mqtt["catch_up_batch"] = 1;
+  if (mqtt["catch_up_live_share"].isNull()) mqtt["catch_up_live_share"] = 30;
+  if (mqtt["diagnostics_topic"].isNull()) mqtt["diagnostics_topic"] = "";
+  if (mqtt["diagnostics_interval"].isNull()) mqtt["diagnostics_interval"] = 60;
 
   // Ensure default_mode exists (for MQTT modes feature)
   if (!mqtt["default_mode"]) {
@@ -613,8 +851,13 @@ bool ServerConfig::getConfig(JsonObject& result) {
     http["method"] = "POST";  // CRITICAL for mobile app!
   if (http["body_format"].isNull())
     http["body_format"] = "json";  // CRITICAL for mobile app!
+  if (http["payload_format"].isNull()) http["payload_format"] = "json";
   if (http["timeout"].isNull()) http["timeout"] = 5000;
   if (http["retry"].isNull()) http["retry"] = 3;
+  if (http["batch_size"].isNull())
+    http["batch_size"] = 1;  // v1.3.3: Data points per request
+  if (http["compression"].isNull()) http["compression"] = "none";
+  if (http["layout"].isNull()) http["layout"] = "points";
   if (http["interval"].isNull())
     http["interval"] = 5;  // v2.2.0: HTTP transmission interval
   if (http["interval_unit"].isNull())
@@ -623,6 +866,37 @@ bool ServerConfig::getConfig(JsonObject& result) {
     http["headers"].to<JsonObject>();
   }
 
+  // v1.3.3: Modbus TCP server defaults
+  if (!result["modbus_server"]) {
+    result["modbus_server"].to<JsonObject>();
+  }
+  JsonObject modbusServer = result["modbus_server"];
+  if (modbusServer["enabled"].isNull()) modbusServer["enabled"] = false;
+  if (modbusServer["port"].isNull()) modbusServer["port"] = 502;
+  if (modbusServer["max_clients"].isNull()) modbusServer["max_clients"] = 2;
+  if (modbusServer["idle_timeout"].isNull()) modbusServer["idle_timeout"] = 60;
+  if (modbusServer["stale_timeout"].isNull())
+    modbusServer["stale_timeout"] = 0;
+
+  // v1.3.3: Register history defaults
+  if (!result["history"]) {
+    result["history"].to<JsonObject>();
+  }
+  JsonObject history = result["history"];
+  if (history["enabled"].isNull()) history["enabled"] = true;
+  if (history["retention"].isNull()) history["retention"] = 60;
+  if (history["interval"].isNull()) history["interval"] = 10;
+  if (history["memory_kb"].isNull()) history["memory_kb"] = 256;
+
+  // v1.3.3: Acquisition cycle defaults
+  if (!result["acquisition"]) {
+    result["acquisition"].to<JsonObject>();
+  }
+  JsonObject acquisition = result["acquisition"];
+  if (acquisition["mode"].isNull()) acquisition["mode"] = "free";
+  if (acquisition["cycle"].isNull()) acquisition["cycle"] = 10;
+  if (acquisition["deadline"].isNull()) acquisition["deadline"] = 80;
+
   return true;
 }
 
@@ -735,6 +1009,42 @@ bool ServerConfig::getHttpConfig(JsonObject& result) {
   return false;
 }
 
+// v1.3.3: Modbus TCP server settings (false if the section is missing)
+bool ServerConfig::getModbusServerConfig(JsonObject& result) {
+  if (config->as<JsonObject>()["modbus_server"]) {
+    JsonObject modbusServer = (*config)["modbus_server"];
+    for (JsonPair kv : modbusServer) {
+      result[kv.key()] = kv.value();
+    }
+    return true;
+  }
+  return false;
+}
+
+// v1.3.3: Register history settings (false if the section is missing)
+bool ServerConfig::getHistoryConfig(JsonObject& result) {
+  if (config->as<JsonObject>()["history"]) {
+    JsonObject history = (*config)["history"];
+    for (JsonPair kv : history) {
+      result[kv.key()] = kv.value();
+    }
+    return true;
+  }
+  return false;
+}
+
+// v1.3.3: Acquisition cycle settings (false if the section is missing)
+bool ServerConfig::getAcquisitionConfig(JsonObject& result) {
+  if (config->as<JsonObject>()["acquisition"]) {
+    JsonObject acquisition = (*config)["acquisition"];
+    for (JsonPair kv : acquisition) {
+      result[kv.key()] = kv.value();
+    }
+    return true;
+  }
+  return false;
+}
+
 bool ServerConfig::getWifiConfig(JsonObject& result) {
   if (config->as<JsonObject>()["communication"]) {
     JsonObject comm = (*config)["communication"];
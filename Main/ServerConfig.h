@@ -82,6 +82,9 @@ class ServerConfig {
   String getProtocol();
   bool getMqttConfig(JsonObject& result);
   bool getHttpConfig(JsonObject& result);
+  bool getModbusServerConfig(JsonObject& result);  // v1.3.3
+  bool getHistoryConfig(JsonObject& result);       // v1.3.3
+  bool getAcquisitionConfig(JsonObject& result);   // v1.3.3
   bool getWifiConfig(JsonObject& result);
   bool getEthernetConfig(JsonObject& result);
   String getPrimaryNetworkMode();
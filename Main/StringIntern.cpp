@@ -0,0 +1,154 @@
+#include "StringIntern.h"
+
+#include <esp_heap_caps.h>
+
+#include "DebugConfig.h"
+
+StringIntern* StringIntern::instance = nullptr;
+
+StringIntern::StringIntern()
+    : count(0), block(nullptr), blockUsed(0), textBytes(0) {
+  for (uint16_t i = 0; i < MAX_PAGES; i++) {
+    pages[i] = nullptr;
+  }
+  mutex = xSemaphoreCreateMutex();
+}
+
+StringIntern* StringIntern::getInstance() {
+  if (!instance) {
+    instance = new StringIntern();
+  }
+  return instance;
+}
+
+// FNV-1a (same as ModbusDeviceIndex::hashId)
+uint32_t StringIntern::hashText(const char* text, size_t length) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)text[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+uint16_t StringIntern::findLocked(const char* text, size_t length,
+                                  uint32_t hash) const {
+  if (index.empty()) {
+    return INVALID_HANDLE;
+  }
+  size_t mask = index.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    uint16_t handle = index[i];
+    if (handle == INVALID_HANDLE) {
+      return INVALID_HANDLE;
+    }
+    const char* stored = get(handle);
+    if (strncmp(stored, text, length) == 0 && stored[length] == '\0') {
+      return handle;
+    }
+  }
+}
+
+uint16_t StringIntern::find(const char* text) const {
+  if (!text || !text[0]) {
+    return INVALID_HANDLE;
+  }
+  size_t length = strnlen(text, MAX_LENGTH);
+  uint32_t hash = hashText(text, length);
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint16_t handle = findLocked(text, length, hash);
+  xSemaphoreGive(mutex);
+  return handle;
+}
+
+uint16_t StringIntern::intern(const char* text) {
+  if (!text || !text[0]) {
+    return INVALID_HANDLE;
+  }
+  size_t length = strnlen(text, MAX_LENGTH);
+  uint32_t hash = hashText(text, length);
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint16_t handle = findLocked(text, length, hash);
+  if (handle != INVALID_HANDLE) {
+    xSemaphoreGive(mutex);
+    return handle;
+  }
+
+  uint16_t next = count.load(std::memory_order_relaxed);
+  uint16_t page = next / PAGE_SIZE;
+  if (page >= MAX_PAGES) {
+    xSemaphoreGive(mutex);
+    LOG_MEM_ERROR("String table full (%u strings), \"%s\" not interned\n",
+                  next, text);
+    return INVALID_HANDLE;
+  }
+  if (!pages[page]) {
+    pages[page] = (const char**)heap_caps_malloc(
+        sizeof(const char*) * PAGE_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!pages[page]) {
+      pages[page] = (const char**)heap_caps_malloc(
+          sizeof(const char*) * PAGE_SIZE, MALLOC_CAP_8BIT);
+    }
+  }
+  char* stored = pages[page] ? storeText(text, length) : nullptr;
+  if (!stored) {
+    xSemaphoreGive(mutex);
+    LOG_MEM_ERROR("String table allocation failed, \"%s\" not interned\n",
+                  text);
+    return INVALID_HANDLE;
+  }
+
+  // Load factor <= 0.5 after this insert
+  if ((size_t)(next + 1) * 2 > index.size()) {
+    growIndex();
+  }
+  pages[page][next % PAGE_SIZE] = stored;
+  count.store(next + 1, std::memory_order_release);  // Publish to get()
+
+  size_t mask = index.size() - 1;
+  size_t i = hash & mask;
+  while (index[i] != INVALID_HANDLE) {
+    i = (i + 1) & mask;
+  }
+  index[i] = next;
+  xSemaphoreGive(mutex);
+  return next;
+}
+
+char* StringIntern::storeText(const char* text, size_t length) {
+  if (!block || blockUsed + length + 1 > BLOCK_SIZE) {
+    // The rest of the previous block is left unused (blocks never move)
+    char* fresh = (char*)heap_caps_malloc(BLOCK_SIZE,
+                                          MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!fresh) {
+      fresh = (char*)heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_8BIT);
+    }
+    if (!fresh) {
+      return nullptr;
+    }
+    block = fresh;
+    blockUsed = 0;
+  }
+  char* stored = block + blockUsed;
+  memcpy(stored, text, length);
+  stored[length] = '\0';
+  blockUsed += length + 1;
+  textBytes += length + 1;
+  return stored;
+}
+
+void StringIntern::growIndex() {
+  size_t capacity = index.empty() ? 64 : index.size() * 2;
+  index.assign(capacity, INVALID_HANDLE);
+  size_t mask = capacity - 1;
+  uint16_t total = count.load(std::memory_order_relaxed);
+  for (uint16_t handle = 0; handle < total; handle++) {
+    const char* stored = get(handle);
+    size_t i = hashText(stored, strlen(stored)) & mask;
+    while (index[i] != INVALID_HANDLE) {
+      i = (i + 1) & mask;
+    }
+    index[i] = handle;
+  }
+}
@@ -0,0 +1,134 @@
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
+#include <vector>
+
+#include "PSRAMAllocator.h"
+
+/**
+ * StringIntern - Global table of device IDs and register units
+ *
+ * v1.3.3: Interned identifiers
+ * Previous: every device kept its ID as a PSRAMString in the service device
+ * list and again in the ConfigManager generation (one 16-byte heap block
+ * each), and every compiled register carried a 24-byte inline unit, although
+ * a gateway only uses a handful of distinct units ("V", "A", "kWh", ...).
+ * Looking a device up meant strcmp() against these copies.
+ * New: strings are stored once, at config load / device list refresh, and
+ * the structures carry a 16-bit handle (InternedString). Equal strings have
+ * equal handles, so device matching is a handle compare and a unit costs two
+ * bytes per register.
+ *
+ * Strings are never removed (handles and pointers stay valid for the life of
+ * the firmware); a renamed device adds its new ID. Text lives in PSRAM
+ * blocks that never move, so get() needs no lock. intern() and find() take
+ * the table mutex (config load and refresh only).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+class StringIntern {
+ public:
+  static constexpr uint16_t INVALID_HANDLE = 0xFFFF;
+  static constexpr uint16_t PAGE_SIZE = 256;  // Handles per pointer page
+  static constexpr uint16_t MAX_PAGES = 255;  // 65280 strings
+  static constexpr size_t BLOCK_SIZE = 2048;  // Text block (PSRAM)
+  static constexpr size_t MAX_LENGTH = 255;   // Longer strings are cut
+
+  static StringIntern* getInstance();
+
+  /**
+   * Store a string (or find the stored copy)
+   * @return Handle; INVALID_HANDLE for "" / nullptr (reads back as "") and
+   *         if out of memory
+   */
+  uint16_t intern(const char* text);
+
+  /**
+   * Handle of an already stored string (never stores)
+   * @return Handle, INVALID_HANDLE if text was never interned
+   */
+  uint16_t find(const char* text) const;
+
+  /**
+   * Text of a handle (lock-free, valid forever)
+   * @return "" for INVALID_HANDLE
+   */
+  const char* get(uint16_t handle) const {
+    if (handle >= count.load(std::memory_order_acquire)) {
+      return "";
+    }
+    return pages[handle / PAGE_SIZE][handle % PAGE_SIZE];
+  }
+
+  uint16_t getCount() const { return count.load(std::memory_order_relaxed); }
+  size_t getTextBytes() const { return textBytes; }
+
+ private:
+  static StringIntern* instance;
+
+  const char** pages[MAX_PAGES];  // Written before count is published
+  std::atomic<uint16_t> count;
+  std::vector<uint16_t, STLPSRAMAllocator<uint16_t>>
+      index;  // Open addressing, power of two (handles)
+  char* block;       // Current text block
+  size_t blockUsed;
+  size_t textBytes;  // Diagnostics
+  SemaphoreHandle_t mutex;
+
+  StringIntern();
+
+  static uint32_t hashText(const char* text, size_t length);
+  uint16_t findLocked(const char* text, size_t length, uint32_t hash) const;
+  char* storeText(const char* text, size_t length);
+  void growIndex();
+};
+
+/**
+ * 16-bit handle to an interned string
+ *
+ * Drop-in for the PSRAMString members it replaces: c_str(), comparison with
+ * text and implicit const char* conversion. Default: empty string.
+ */
+class InternedString {
+ public:
+  InternedString() : handle(StringIntern::INVALID_HANDLE) {}
+  InternedString(const char* text)
+      : handle(StringIntern::getInstance()->intern(text)) {}
+
+  InternedString& operator=(const char* text) {
+    handle = StringIntern::getInstance()->intern(text);
+    return *this;
+  }
+
+  const char* c_str() const {
+    return handle == StringIntern::INVALID_HANDLE
+               ? ""
+               : StringIntern::getInstance()->get(handle);
+  }
+  operator const char*() const { return c_str(); }
+
+  uint16_t getHandle() const { return handle; }
+  bool isEmpty() const { return handle == StringIntern::INVALID_HANDLE; }
+
+  bool operator==(const InternedString& other) const {
+    return handle == other.handle;
+  }
+  bool operator!=(const InternedString& other) const {
+    return handle != other.handle;
+  }
+  bool operator==(const char* text) const {
+    return text && strcmp(c_str(), text) == 0;
+  }
+  bool operator!=(const char* text) const { return !operator==(text); }
+
+ private:
+  uint16_t handle;
+};
+
+#endif  // STRING_INTERN_H
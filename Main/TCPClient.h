@@ -3,6 +3,7 @@
 
 #include <Ethernet.h>
 #include <WiFi.h>
+#include <lwip/sockets.h>  // v1.3.3: Non-blocking connect (WiFi)
 
 #include "NetworkManager.h"
 
@@ -13,11 +14,15 @@ class TCPClient {
   WiFiClient* wifiClient;
   EthernetClient* ethClient;
   bool useEthernet;
+  int pendingFd;         // v1.3.3: WiFi socket with connect() in progress
+  uint32_t timeoutMs;    // Re-applied when pendingFd becomes the WiFiClient
 
  public:
   TCPClient() {
     wifiClient = nullptr;
     ethClient = nullptr;
+    pendingFd = -1;
+    timeoutMs = 0;
 
     // Detect active network mode
     NetworkMgr* netMgr = NetworkMgr::getInstance();
@@ -37,6 +42,7 @@ class TCPClient {
   }
 
   ~TCPClient() {
+    abortConnect();
     if (wifiClient) {
       delete wifiClient;
       wifiClient = nullptr;
@@ -48,6 +54,7 @@ class TCPClient {
   }
 
   void setTimeout(uint32_t milliseconds) {
+    timeoutMs = milliseconds;
     if (useEthernet && ethClient) {
       ethClient->setTimeout(milliseconds);
     } else if (wifiClient) {
@@ -73,6 +80,104 @@ class TCPClient {
     return 0;
   }
 
+  // v1.3.3: Non-blocking connect (concurrent Modbus TCP polling)
+  // WiFi: lwIP socket with O_NONBLOCK, completion checked by pollConnect()
+  // and handed to the WiFiClient once established.
+  // Ethernet: the W5500 library has no asynchronous connect, the connect is
+  // done here (bounded by the library connection timeout).
+  // Returns false if the connect could not be started.
+  bool startConnect(const char* host, uint16_t port) {
+    if (useEthernet) {
+      return ethClient && ethClient->connect(host, port);
+    }
+
+    IPAddress ip;
+    if (!wifiClient || !ip.fromString(host)) {
+      return false;
+    }
+    abortConnect();
+
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+      return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = (uint32_t)ip;
+
+    if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 &&
+        errno != EINPROGRESS) {
+      close(fd);
+      return false;
+    }
+    pendingFd = fd;
+    return true;
+  }
+
+  // v1.3.3: Result of startConnect(): 1 = connected, 0 = in progress,
+  // -1 = failed
+  int pollConnect() {
+    if (pendingFd < 0) {
+      return connected() ? 1 : -1;
+    }
+
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(pendingFd, &writeSet);
+    struct timeval tv = {0, 0};
+    int ready = select(pendingFd + 1, nullptr, &writeSet, nullptr, &tv);
+    if (ready == 0) {
+      return 0;
+    }
+
+    int sockError = 0;
+    socklen_t len = sizeof(sockError);
+    if (ready < 0 ||
+        getsockopt(pendingFd, SOL_SOCKET, SO_ERROR, &sockError, &len) < 0 ||
+        sockError != 0) {
+      abortConnect();
+      return -1;
+    }
+
+    // Same socket options as WiFiClient::connect() (blocking, no Nagle)
+    fcntl(pendingFd, F_SETFL, fcntl(pendingFd, F_GETFL, 0) & ~O_NONBLOCK);
+    int one = 1;
+    setsockopt(pendingFd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    delete wifiClient;
+    wifiClient = new WiFiClient(pendingFd);  // Takes ownership of the socket
+    pendingFd = -1;
+    if (timeoutMs > 0) {
+      wifiClient->setTimeout(timeoutMs);
+    }
+    return 1;
+  }
+
+  // v1.3.3: Socket descriptor for select() readiness waits
+  // (-1 = not available, e.g. Ethernet/W5500 sockets)
+  int fd() {
+    if (useEthernet) {
+      return -1;
+    }
+    if (pendingFd >= 0) {
+      return pendingFd;
+    }
+    return wifiClient ? wifiClient->fd() : -1;
+  }
+
+  bool isConnecting() const { return pendingFd >= 0; }
+
+  void abortConnect() {
+    if (pendingFd >= 0) {
+      close(pendingFd);
+      pendingFd = -1;
+    }
+  }
+
   size_t write(const uint8_t* buf, size_t size) {
     if (useEthernet && ethClient) {
       return ethClient->write(buf, size);
@@ -91,6 +196,37 @@ class TCPClient {
     return 0;
   }
 
+  // v1.3.3: Block until data is readable or timeoutMs passed (replaces
+  // available() + vTaskDelay(10) polling). WiFi sockets wait in select() and
+  // wake as soon as data arrives. W5500 sockets have no descriptor, so those
+  // are polled every tick. Returns true if data is available.
+  bool waitReadable(uint32_t timeoutMs) {
+    if (available() > 0) {
+      return true;
+    }
+    int sock = fd();
+    if (sock >= 0 && pendingFd < 0) {
+      fd_set readSet;
+      FD_ZERO(&readSet);
+      FD_SET(sock, &readSet);
+      struct timeval tv;
+      tv.tv_sec = timeoutMs / 1000;
+      tv.tv_usec = (timeoutMs % 1000) * 1000;
+      if (select(sock + 1, &readSet, nullptr, nullptr, &tv) <= 0) {
+        return false;
+      }
+      return available() > 0;
+    }
+    unsigned long start = millis();
+    while ((millis() - start) < timeoutMs) {
+      vTaskDelay(1);
+      if (available() > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   int read(uint8_t* buf, size_t size) {
     if (useEthernet && ethClient) {
       return ethClient->read(buf, size);
@@ -110,6 +246,7 @@ class TCPClient {
   }
 
   void stop() {
+    abortConnect();
     if (useEthernet && ethClient) {
       ethClient->stop();
     } else if (wifiClient) {
@@ -0,0 +1,160 @@
+#ifndef TASK_AFFINITY_H
+#define TASK_AFFINITY_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * TaskAffinity - Core and priority of every long-running gateway task
+ *
+ * v1.3.3: Central task placement table
+ * Previous: each module passed its own core and priority to
+ * xTaskCreatePinnedToCore(). Almost every service task ended up on core 1,
+ * so RTU decoding, MQTT payload building, TCP polling and BLE CRUD competed
+ * for one core while core 0 mostly ran the WiFi/BT and lwIP tasks.
+ * New: modules create their tasks through TaskAffinity::create() and the
+ * placement comes from the profile selected with TASK_AFFINITY_PROFILE.
+ *
+ * Profiles:
+ * - TASK_AFFINITY_LEGACY: placement of v1.3.2 (reference / fallback)
+ * - TASK_AFFINITY_BALANCED (default): the CPU-bound stages that only talk to
+ *   other tasks through queues or mutexes move to core 0 - RTU bus 2, the TCP
+ *   poller with its auto-recovery task, and the MQTT publish task (payload
+ *   build and encoding). BLE, CRUD, RTU bus 1 and the MQTT network task stay
+ *   on core 1. Priorities are unchanged, so the WiFi (23) and lwIP (18) tasks
+ *   on core 0 still preempt them; every moved task blocks on I/O or a delay
+ *   each cycle, so IDLE0 keeps running for the task watchdog.
+ *
+ * Override at build time, e.g. -DTASK_AFFINITY_PROFILE=TASK_AFFINITY_LEGACY.
+ * The TaskProfiler core loads (BLE read "task_profile") show the effect.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+#define TASK_AFFINITY_LEGACY 0
+#define TASK_AFFINITY_BALANCED 1
+
+#ifndef TASK_AFFINITY_PROFILE
+#define TASK_AFFINITY_PROFILE TASK_AFFINITY_BALANCED
+#endif
+
+namespace TaskAffinity {
+
+// Table index (order of the profile tables below)
+enum class Task : uint8_t {
+  BLE_COMMAND = 0,
+  BLE_STREAM,
+  BLE_METRICS,
+  CRUD_PROCESSOR,
+  RTU_BUS1,
+  RTU_BUS2,
+  RTU_AUTO_RECOVERY,
+  TCP_POLL,
+  TCP_AUTO_RECOVERY,
+  MQTT_NETWORK,
+  MQTT_PUBLISH,
+  HTTP,
+  LED_BLINK,
+  BUTTON,
+  NET_FAILOVER,
+  RTC_SYNC,
+  LOG_DRAIN,
+  PROFILER,
+  OTA_CHECK,
+  SD_MONITOR,
+  MODBUS_SERVER,  // v1.3.3: Modbus TCP server (ModbusTcpServer)
+  BOOT_NETWORK,   // v1.3.3: Staged boot - network bring-up (Main.ino)
+  BOOT_RECOVERY,  // v1.3.3: Staged boot - persistent queue recovery
+  COUNT
+};
+
+struct Placement {
+  UBaseType_t priority;
+  BaseType_t core;
+};
+
+// v1.3.2 placement
+constexpr Placement LEGACY_PROFILE[(int)Task::COUNT] = {
+    {1, 1},  // BLE_COMMAND
+    {1, 1},  // BLE_STREAM
+    {0, 1},  // BLE_METRICS
+    {2, 1},  // CRUD_PROCESSOR
+    {2, 1},  // RTU_BUS1
+    {2, 1},  // RTU_BUS2
+    {1, 1},  // RTU_AUTO_RECOVERY
+    {2, 1},  // TCP_POLL
+    {1, 1},  // TCP_AUTO_RECOVERY
+    {2, 1},  // MQTT_NETWORK
+    {1, 1},  // MQTT_PUBLISH
+    {1, 0},  // HTTP
+    {1, 0},  // LED_BLINK
+    {2, 1},  // BUTTON
+    {1, 0},  // NET_FAILOVER
+    {1, 0},  // RTC_SYNC
+    {1, 0},  // LOG_DRAIN
+    {1, 0},  // PROFILER
+    {1, 0},  // OTA_CHECK
+    {1, 0},  // SD_MONITOR
+    {1, 0},  // MODBUS_SERVER (v1.3.3, not in v1.3.2)
+    {1, 0},  // BOOT_NETWORK (v1.3.3, was inline in setup())
+    {1, 0},  // BOOT_RECOVERY (v1.3.3, was inline in setup())
+};
+
+constexpr Placement BALANCED_PROFILE[(int)Task::COUNT] = {
+    {1, 1},  // BLE_COMMAND - BLE tasks share their data structures
+    {1, 1},  // BLE_STREAM
+    {0, 1},  // BLE_METRICS
+    {2, 1},  // CRUD_PROCESSOR - runs the BLE commands
+    {2, 1},  // RTU_BUS1
+    {2, 0},  // RTU_BUS2 - second bus decodes on the other core
+    {1, 1},  // RTU_AUTO_RECOVERY - under vectorMutex, any core
+    {2, 0},  // TCP_POLL - next to lwIP (tcpip_thread, core 0)
+    {1, 0},  // TCP_AUTO_RECOVERY - stays with the TCP poller
+    {2, 1},  // MQTT_NETWORK - keep-alives, writes, PUBACK handling
+    {1, 0},  // MQTT_PUBLISH - payload build / encode (outbound queue)
+    {1, 0},  // HTTP
+    {1, 0},  // LED_BLINK
+    {2, 1},  // BUTTON
+    {1, 0},  // NET_FAILOVER
+    {1, 0},  // RTC_SYNC
+    {1, 0},  // LOG_DRAIN
+    {1, 0},  // PROFILER
+    {1, 0},  // OTA_CHECK
+    {1, 0},  // SD_MONITOR
+    {1, 0},  // MODBUS_SERVER - answers from memory, next to lwIP
+    {1, 0},  // BOOT_NETWORK - one-shot, blocks on DHCP / WiFi association
+    {1, 0},  // BOOT_RECOVERY - one-shot, LittleFS / SD reads
+};
+
+inline const Placement& placement(Task task) {
+#if TASK_AFFINITY_PROFILE == TASK_AFFINITY_LEGACY
+  return LEGACY_PROFILE[(int)task];
+#else
+  return BALANCED_PROFILE[(int)task];
+#endif
+}
+
+inline const char* profileName() {
+#if TASK_AFFINITY_PROFILE == TASK_AFFINITY_LEGACY
+  return "legacy";
+#else
+  return "balanced";
+#endif
+}
+
+/**
+ * xTaskCreatePinnedToCore() with the core and priority of task
+ */
+inline BaseType_t create(TaskFunction_t function, const char* name,
+                         uint32_t stackSize, void* parameter, Task task,
+                         TaskHandle_t* handle) {
+  const Placement& place = placement(task);
+  return xTaskCreatePinnedToCore(function, name, stackSize, parameter,
+                                 place.priority, handle, place.core);
+}
+
+}  // namespace TaskAffinity
+
+#endif  // TASK_AFFINITY_H
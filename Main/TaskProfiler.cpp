@@ -0,0 +1,327 @@
+#include "TaskProfiler.h"
+
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+
+#include "DebugConfig.h"
+#include "QueueManager.h"
+#include "TaskAffinity.h"  // v1.3.3: Task core / priority table
+
+TaskProfiler* TaskProfiler::instance = nullptr;
+TaskProfiler::LockCounters
+    TaskProfiler::lockCounters[(int)ProfiledLock::COUNT];
+
+static const char* const LOCK_NAMES[(int)ProfiledLock::COUNT] = {
+    "plan_registry", "rtu_bus", "tcp_pool"};
+
+TaskProfiler::TaskProfiler()
+    : tasks(nullptr),
+      taskCount(0),
+      scratch(nullptr),
+      lastTotalRunTime(0),
+      queueCount(0),
+      dataQueueDepth(0),
+      dataQueuePeak(0),
+      dataQueueIntervalPeak(0),
+      sampledAtMs(0),
+      sampleCount(0),
+      mutex(nullptr),
+      taskHandle(nullptr) {
+  coreLoad[0] = coreLoad[1] = 0;
+  memset(queues, 0, sizeof(queues));
+  memset(locks, 0, sizeof(locks));
+  mutex = xSemaphoreCreateMutex();
+}
+
+TaskProfiler* TaskProfiler::getInstance() {
+  if (!instance) {
+    instance = new TaskProfiler();
+  }
+  return instance;
+}
+
+bool TaskProfiler::begin() {
+  if (taskHandle) {
+    return true;
+  }
+
+  tasks = (TaskSample*)heap_caps_calloc(MAX_TASKS, sizeof(TaskSample),
+                                        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  scratch = (TaskStatus_t*)heap_caps_calloc(
+      MAX_TASKS, sizeof(TaskStatus_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!tasks || !scratch || !mutex) {
+    LOG_MEM_ERROR("[PROFILER] Buffer allocation failed, profiler disabled\n");
+    return false;
+  }
+
+  BaseType_t result =
+      TaskAffinity::create(samplerTask, "PROFILER_TASK", 3072, this,
+                           TaskAffinity::Task::PROFILER, &taskHandle);
+  if (result != pdPASS) {
+    LOG_MEM_ERROR("[PROFILER] Sampler task creation failed\n");
+    taskHandle = nullptr;
+    return false;
+  }
+
+  LOG_MEM_INFO("[PROFILER] Sampling every %lu ms (run-time stats: %s)\n",
+               (unsigned long)SAMPLE_INTERVAL_MS,
+#if configGENERATE_RUN_TIME_STATS == 1
+               "yes"
+#else
+               "no"
+#endif
+  );
+  return true;
+}
+
+void TaskProfiler::watchQueue(const char* name, QueueHandle_t queue) {
+  if (!queue || !mutex) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (queueCount < MAX_QUEUES) {
+    QueueWatch& watch = queues[queueCount++];
+    watch.name = name;
+    watch.queue = queue;
+    watch.capacity = (uint16_t)(uxQueueMessagesWaiting(queue) +
+                                uxQueueSpacesAvailable(queue));
+  }
+  xSemaphoreGive(mutex);
+}
+
+void TaskProfiler::recordWait(ProfiledLock lock, uint32_t waitUs,
+                              bool taken) {
+  LockCounters& counters = lockCounters[(int)lock];
+  counters.takes.fetch_add(1, std::memory_order_relaxed);
+  if (!taken) {
+    counters.timeouts.fetch_add(1, std::memory_order_relaxed);
+  }
+  counters.totalWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+  uint32_t seen = counters.maxWaitUs.load(std::memory_order_relaxed);
+  while (waitUs > seen &&
+         !counters.maxWaitUs.compare_exchange_weak(
+             seen, waitUs, std::memory_order_relaxed)) {
+  }
+}
+
+void TaskProfiler::samplerTask(void* parameter) {
+  TaskProfiler* profiler = static_cast<TaskProfiler*>(parameter);
+  const uint32_t ticksPerSample = SAMPLE_INTERVAL_MS / QUEUE_SAMPLE_MS;
+  uint32_t tick = 0;
+  while (true) {
+    vTaskDelay(pdMS_TO_TICKS(QUEUE_SAMPLE_MS));
+    if (++tick < ticksPerSample) {
+      xSemaphoreTake(profiler->mutex, portMAX_DELAY);
+      profiler->sampleQueues(false);
+      xSemaphoreGive(profiler->mutex);
+      continue;
+    }
+    tick = 0;
+    profiler->sample();
+  }
+}
+
+void TaskProfiler::sample() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  sampleTasks();
+  sampleQueues(true);
+  sampleLocks();
+  sampledAtMs = millis();
+  sampleCount++;
+  xSemaphoreGive(mutex);
+}
+
+void TaskProfiler::sampleTasks() {
+#if configUSE_TRACE_FACILITY == 1
+  uint32_t totalRunTime = 0;
+  UBaseType_t count = uxTaskGetSystemState(scratch, MAX_TASKS, &totalRunTime);
+  if (count == 0) {
+    return;  // More than MAX_TASKS tasks (keep the previous sample)
+  }
+  uint32_t elapsed = totalRunTime - lastTotalRunTime;
+  bool haveDelta = (sampleCount > 0) && elapsed > 0;
+  lastTotalRunTime = totalRunTime;
+
+  TaskHandle_t idle[2] = {nullptr, nullptr};
+#if ESP_IDF_VERSION_MAJOR >= 5
+  idle[0] = xTaskGetIdleTaskHandleForCore(0);
+  idle[1] = xTaskGetIdleTaskHandleForCore(1);
+#else
+  idle[0] = xTaskGetIdleTaskHandleForCPU(0);
+  idle[1] = xTaskGetIdleTaskHandleForCPU(1);
+#endif
+
+  // Previous counters by task number (tasks is rewritten in place below)
+  uint32_t previousNumber[MAX_TASKS];
+  uint32_t previousRunTime[MAX_TASKS];
+  uint8_t previousCount = taskCount;
+  for (uint8_t i = 0; i < previousCount; i++) {
+    previousNumber[i] = tasks[i].taskNumber;
+    previousRunTime[i] = tasks[i].runTime;
+  }
+
+  for (UBaseType_t i = 0; i < count; i++) {
+    const TaskStatus_t& status = scratch[i];
+    TaskSample& task = tasks[i];
+    strncpy(task.name, status.pcTaskName, sizeof(task.name) - 1);
+    task.name[sizeof(task.name) - 1] = '\0';
+    task.taskNumber = status.xTaskNumber;
+    task.priority = (uint8_t)status.uxCurrentPriority;
+    task.stackFreeMin = status.usStackHighWaterMark;
+#if configTASKLIST_INCLUDE_COREID
+    task.core = (status.xCoreID == tskNO_AFFINITY) ? -1 : (int8_t)status.xCoreID;
+#else
+    task.core = -1;
+#endif
+    static const char STATES[] = {'R', 'r', 'B', 'S', 'D'};
+    task.state = (status.eCurrentState <= eDeleted)
+                     ? STATES[status.eCurrentState]
+                     : '?';
+
+#if configGENERATE_RUN_TIME_STATS == 1
+    task.runTime = status.ulRunTimeCounter;
+    task.cpuPermille = 0;
+    for (uint8_t p = 0; haveDelta && p < previousCount; p++) {
+      if (previousNumber[p] == task.taskNumber) {
+        uint32_t used = task.runTime - previousRunTime[p];
+        uint64_t permille = (uint64_t)used * 1000 / elapsed;
+        task.cpuPermille = (uint16_t)(permille > 1000 ? 1000 : permille);
+        break;
+      }
+    }
+    for (uint8_t core = 0; core < 2; core++) {
+      if (haveDelta && status.xHandle == idle[core]) {
+        coreLoad[core] = (uint8_t)(100 - task.cpuPermille / 10);
+      }
+    }
+#else
+    (void)haveDelta;
+    (void)idle;
+    task.runTime = 0;
+    task.cpuPermille = 0;
+#endif
+  }
+  taskCount = (uint8_t)count;
+#endif
+}
+
+void TaskProfiler::sampleQueues(bool closeInterval) {
+  QueueManager* queueManager = QueueManager::getInstance();
+  dataQueueDepth = queueManager ? (uint16_t)queueManager->size() : 0;
+  if (dataQueueDepth > dataQueueIntervalPeak) {
+    dataQueueIntervalPeak = dataQueueDepth;
+  }
+
+  for (uint8_t i = 0; i < queueCount; i++) {
+    QueueWatch& watch = queues[i];
+    watch.depth = (uint16_t)uxQueueMessagesWaiting(watch.queue);
+    if (watch.depth > watch.intervalPeak) {
+      watch.intervalPeak = watch.depth;
+    }
+    if (closeInterval) {
+      watch.peak = watch.intervalPeak;
+      watch.intervalPeak = watch.depth;
+    }
+  }
+  if (closeInterval) {
+    dataQueuePeak = dataQueueIntervalPeak;
+    dataQueueIntervalPeak = dataQueueDepth;
+  }
+}
+
+void TaskProfiler::sampleLocks() {
+  for (int i = 0; i < (int)ProfiledLock::COUNT; i++) {
+    LockCounters& counters = lockCounters[i];
+    LockSample& lock = locks[i];
+    lock.takes = counters.takes.exchange(0, std::memory_order_relaxed);
+    lock.timeouts = counters.timeouts.exchange(0, std::memory_order_relaxed);
+    uint32_t total = counters.totalWaitUs.exchange(0, std::memory_order_relaxed);
+    lock.maxWaitUs = counters.maxWaitUs.exchange(0, std::memory_order_relaxed);
+    lock.avgWaitUs = lock.takes ? total / lock.takes : 0;
+  }
+}
+
+void TaskProfiler::getStatus(JsonObject& status) {
+  status["sample_interval_ms"] = SAMPLE_INTERVAL_MS;
+  status["sample_count"] = sampleCount;
+  status["run_time_stats"] = (configGENERATE_RUN_TIME_STATS == 1);
+  status["affinity_profile"] = TaskAffinity::profileName();
+  if (!mutex || xSemaphoreTake(mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    status["error"] = "Profiler busy";
+    return;
+  }
+  status["sample_age_ms"] = sampleCount ? millis() - sampledAtMs : 0;
+
+  JsonArray cores = status["core_load_percent"].to<JsonArray>();
+  cores.add(coreLoad[0]);
+  cores.add(coreLoad[1]);
+
+  JsonArray taskArray = status["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const TaskSample& task = tasks[i];
+    JsonObject entry = taskArray.add<JsonObject>();
+    entry["name"] = task.name;
+    entry["priority"] = task.priority;
+    entry["core"] = task.core;
+    char state[2] = {task.state, '\0'};
+    entry["state"] = state;
+    entry["cpu_percent"] = task.cpuPermille / 10.0f;
+    entry["stack_free_min"] = task.stackFreeMin;
+  }
+
+  JsonArray queueArray = status["queues"].to<JsonArray>();
+  JsonObject dataQueue = queueArray.add<JsonObject>();
+  dataQueue["name"] = "data";
+  dataQueue["depth"] = dataQueueDepth;
+  dataQueue["peak"] = dataQueuePeak;
+  for (uint8_t i = 0; i < queueCount; i++) {
+    const QueueWatch& watch = queues[i];
+    JsonObject entry = queueArray.add<JsonObject>();
+    entry["name"] = watch.name;
+    entry["depth"] = watch.depth;
+    entry["capacity"] = watch.capacity;
+    entry["peak"] = watch.peak;
+  }
+
+  JsonArray lockArray = status["locks"].to<JsonArray>();
+  for (int i = 0; i < (int)ProfiledLock::COUNT; i++) {
+    const LockSample& lock = locks[i];
+    JsonObject entry = lockArray.add<JsonObject>();
+    entry["name"] = LOCK_NAMES[i];
+    entry["takes"] = lock.takes;
+    entry["timeouts"] = lock.timeouts;
+    entry["avg_wait_us"] = lock.avgWaitUs;
+    entry["max_wait_us"] = lock.maxWaitUs;
+  }
+  xSemaphoreGive(mutex);
+}
+
+void TaskProfiler::getSummary(Summary& summary) {
+  memset(&summary, 0, sizeof(summary));
+  if (!mutex || xSemaphoreTake(mutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+    return;
+  }
+  summary.valid = sampleCount > 0;
+  summary.runTimeStats = (configGENERATE_RUN_TIME_STATS == 1);
+  summary.coreLoad[0] = coreLoad[0];
+  summary.coreLoad[1] = coreLoad[1];
+  summary.queueDepth = dataQueueDepth;
+
+  uint16_t topCpu = 0;
+  uint32_t lowStack = UINT32_MAX;
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const TaskSample& task = tasks[i];
+    if (strncmp(task.name, "IDLE", 4) != 0 && task.cpuPermille >= topCpu) {
+      topCpu = task.cpuPermille;
+      strncpy(summary.topTask, task.name, sizeof(summary.topTask) - 1);
+    }
+    if (task.stackFreeMin < lowStack) {
+      lowStack = task.stackFreeMin;
+      strncpy(summary.lowStackTask, task.name,
+              sizeof(summary.lowStackTask) - 1);
+    }
+  }
+  summary.topTaskCpu = (uint8_t)(topCpu / 10);
+  summary.lowStackBytes = (lowStack == UINT32_MAX) ? 0 : lowStack;
+  xSemaphoreGive(mutex);
+}
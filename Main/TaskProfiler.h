@@ -0,0 +1,155 @@
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+
+/**
+ * TaskProfiler - On-device view of task CPU, stacks, queues and lock waits
+ *
+ * v1.3.3: Runtime profiling surface
+ * Previous: with 11+ tasks mostly pinned to core 1 there was no way to see
+ * on the device which task uses the CPU or runs close to its stack limit.
+ * New: a low-priority task samples the FreeRTOS run-time counters and stack
+ * high-water marks (uxTaskGetSystemState), the depth of the data queue and
+ * of registered FreeRTOS queues, and the wait times of the profiled locks.
+ * The last sample is read by BLE CRUD (read "task_profile"), the optional
+ * MQTT diagnostics topic and the ProductionLogger heartbeat.
+ *
+ * CPU is the share of one core over the last interval (a task that keeps
+ * one core busy shows 100%). Core load is 100% minus that core's idle task.
+ * Without configGENERATE_RUN_TIME_STATS only stacks, queues and locks are
+ * reported.
+ *
+ * Lock waits: call sites of the hot mutexes take them through
+ * TaskProfiler::take(); each take adds its wait to lock-free counters, which
+ * the sampler turns into per-interval count / average / maximum.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+// Locks whose wait times are profiled (TaskProfiler::take)
+enum class ProfiledLock : uint8_t {
+  PLAN_REGISTRY = 0,  // PollPlanRegistry::mutex (pollers, publishers, BLE)
+  RTU_BUS = 1,        // ModbusRtuService BusWorker::busMutex (poll, writes)
+  TCP_POOL = 2,       // ModbusTcpService::poolMutex (connection pool)
+  COUNT = 3
+};
+
+class TaskProfiler {
+ public:
+  static constexpr uint32_t SAMPLE_INTERVAL_MS = 5000;
+  static constexpr uint32_t QUEUE_SAMPLE_MS = 250;  // Queue peak sampling
+  static constexpr uint8_t MAX_TASKS = 32;
+  static constexpr uint8_t MAX_QUEUES = 8;
+
+  // Compact summary (ProductionLogger heartbeat)
+  struct Summary {
+    bool valid;             // At least one sample taken
+    bool runTimeStats;      // CPU fields are meaningful
+    uint8_t coreLoad[2];    // %
+    char topTask[16];       // Highest CPU (idle tasks excluded)
+    uint8_t topTaskCpu;     // %
+    char lowStackTask[16];  // Smallest stack high-water mark
+    uint32_t lowStackBytes;
+    uint16_t queueDepth;    // Data queue (QueueManager)
+  };
+
+  static TaskProfiler* getInstance();
+
+  bool begin();  // Start the sampler task
+
+  /**
+   * Watch a FreeRTOS queue (depth, capacity and peak per interval)
+   * @param name String literal (stored by pointer)
+   */
+  void watchQueue(const char* name, QueueHandle_t queue);
+
+  /**
+   * xSemaphoreTake() that records its wait time for lock
+   */
+  static BaseType_t take(SemaphoreHandle_t mutex, TickType_t timeout,
+                         ProfiledLock lock) {
+    int64_t start = esp_timer_get_time();
+    BaseType_t result = xSemaphoreTake(mutex, timeout);
+    recordWait(lock, (uint32_t)(esp_timer_get_time() - start),
+               result == pdTRUE);
+    return result;
+  }
+
+  void getStatus(JsonObject& status);  // Last sample, full detail
+  void getSummary(Summary& summary);
+
+ private:
+  struct TaskSample {
+    char name[16];
+    uint32_t taskNumber;
+    uint32_t runTime;        // Counter at the sample (delta source)
+    uint16_t cpuPermille;    // Of one core, last interval
+    uint32_t stackFreeMin;   // High-water mark (bytes, ESP-IDF)
+    uint8_t priority;
+    int8_t core;             // -1 = not pinned
+    char state;              // R(unning) r(eady) B(locked) S(uspended) D
+  };
+
+  struct QueueWatch {
+    const char* name;
+    QueueHandle_t queue;
+    uint16_t depth;
+    uint16_t capacity;
+    uint16_t peak;          // Highest depth seen in the last interval
+    uint16_t intervalPeak;  // Running peak of the current interval
+  };
+
+  struct LockCounters {
+    std::atomic<uint32_t> takes{0};
+    std::atomic<uint32_t> timeouts{0};
+    std::atomic<uint32_t> totalWaitUs{0};
+    std::atomic<uint32_t> maxWaitUs{0};
+  };
+
+  struct LockSample {
+    uint32_t takes;
+    uint32_t timeouts;
+    uint32_t avgWaitUs;
+    uint32_t maxWaitUs;
+  };
+
+  static TaskProfiler* instance;
+  static LockCounters lockCounters[(int)ProfiledLock::COUNT];
+
+  TaskSample* tasks;  // MAX_TASKS (PSRAM), guarded by mutex
+  uint8_t taskCount;
+  TaskStatus_t* scratch;  // uxTaskGetSystemState() buffer (sampler only)
+  uint32_t lastTotalRunTime;
+  uint8_t coreLoad[2];
+  QueueWatch queues[MAX_QUEUES];
+  uint8_t queueCount;
+  uint16_t dataQueueDepth;
+  uint16_t dataQueuePeak;
+  uint16_t dataQueueIntervalPeak;
+  LockSample locks[(int)ProfiledLock::COUNT];
+  uint32_t sampledAtMs;
+  uint32_t sampleCount;
+  SemaphoreHandle_t mutex;
+  TaskHandle_t taskHandle;
+
+  TaskProfiler();
+
+  static void recordWait(ProfiledLock lock, uint32_t waitUs, bool taken);
+  static void samplerTask(void* parameter);
+  void sample();
+  void sampleTasks();
+  void sampleQueues(bool closeInterval);
+  void sampleLocks();
+};
+
+#endif  // TASK_PROFILER_H
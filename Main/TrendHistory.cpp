@@ -0,0 +1,282 @@
+#include "TrendHistory.h"
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "DebugConfig.h"
+#include "ServerConfig.h"
+
+TrendHistory* TrendHistory::instance = nullptr;
+
+TrendHistory::TrendHistory()
+    : pool(nullptr),
+      blockCount(0),
+      nextBlock(0),
+      columns(nullptr),
+      producerMutex(nullptr),
+      retentionS(HistoryConfig::DEFAULT_RETENTION_MIN * 60),
+      intervalS(HistoryConfig::DEFAULT_INTERVAL_S),
+      droppedReads(0) {}
+
+TrendHistory* TrendHistory::getInstance() {
+  if (!instance) {
+    instance = new TrendHistory();
+  }
+  return instance;
+}
+
+bool TrendHistory::init(ServerConfig* serverConfig) {
+  if (pool) return true;
+
+  JsonDocument doc;
+  JsonObject settings = doc.to<JsonObject>();
+  if (serverConfig) {
+    serverConfig->getHistoryConfig(settings);  // Defaults if missing
+  }
+  if (!(settings["enabled"] | true)) {
+    LOG_DATA_INFO("[HISTORY] Register history disabled\n");
+    return false;
+  }
+
+  // Ranges checked by ServerConfig validation
+  auto setting = [&settings](const char* key, uint32_t fallback,
+                             uint32_t low, uint32_t high) {
+    uint32_t value = settings[key] | fallback;
+    return std::max(low, std::min(value, high));
+  };
+  uint32_t memoryKb =
+      setting("memory_kb", HistoryConfig::DEFAULT_MEMORY_KB,
+              HistoryConfig::MIN_MEMORY_KB, HistoryConfig::MAX_MEMORY_KB);
+  uint32_t retentionMin =
+      setting("retention", HistoryConfig::DEFAULT_RETENTION_MIN, 1,
+              HistoryConfig::MAX_RETENTION_MIN);
+  retentionS = retentionMin * 60;
+  intervalS = setting("interval", HistoryConfig::DEFAULT_INTERVAL_S, 1,
+                      HistoryConfig::MAX_INTERVAL_S);
+
+  // PSRAM only: history is optional and must not take internal RAM
+  blockCount = memoryKb * 1024 / sizeof(Block);
+  pool = (Block*)heap_caps_calloc(blockCount, sizeof(Block),
+                                  MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  columns = (Column*)heap_caps_calloc(HistoryConfig::MAX_COLUMNS,
+                                      sizeof(Column),
+                                      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  producerMutex = xSemaphoreCreateMutex();
+  if (!pool || !columns || !producerMutex) {
+    LOG_DATA_ERROR("[HISTORY] Failed to allocate %lu KB history pool\n",
+                   (unsigned long)memoryKb);
+    if (pool) heap_caps_free(pool);
+    if (columns) heap_caps_free(columns);
+    if (producerMutex) vSemaphoreDelete(producerMutex);
+    pool = nullptr;
+    columns = nullptr;
+    producerMutex = nullptr;
+    blockCount = 0;
+    return false;
+  }
+
+  LOG_DATA_INFO(
+      "[HISTORY] %lu blocks (%lu samples), retention %lu min, interval %lu "
+      "s\n",
+      (unsigned long)blockCount,
+      (unsigned long)(blockCount * HistoryConfig::SAMPLES_PER_BLOCK),
+      (unsigned long)retentionMin, (unsigned long)intervalS);
+  return true;
+}
+
+uint32_t TrendHistory::nowSeconds() {
+  return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+void TrendHistory::record(uint8_t slot, uint16_t generation,
+                          uint16_t registerSlot, double value) {
+  if (!pool || std::isnan(value)) return;
+  float sample = (float)std::max(-(double)FLT_MAX,
+                                 std::min(value, (double)FLT_MAX));
+  uint32_t now = nowSeconds();
+
+  xSemaphoreTake(producerMutex, portMAX_DELAY);
+  Column* column = findColumn(slot, generation, registerSlot);
+  if (!column) {
+    droppedReads++;
+    xSemaphoreGive(producerMutex);
+    return;
+  }
+
+  // Interval over: the mean of its reads becomes one sample
+  if (column->reads > 0 && (now - column->windowStart >= intervalS ||
+                            column->reads == UINT16_MAX)) {
+    appendSample((uint16_t)(column - columns), column->windowEnd,
+                 column->sum / column->reads);
+    column->reads = 0;
+  }
+  if (column->reads == 0) {
+    column->windowStart = now;
+    column->sum = 0;
+  }
+  column->sum += sample;
+  column->reads++;
+  column->windowEnd = now;
+  xSemaphoreGive(producerMutex);
+}
+
+TrendHistory::Column* TrendHistory::findColumn(uint8_t slot,
+                                               uint16_t generation,
+                                               uint16_t registerSlot) {
+  // Open addressing on (slot, register); entries are never removed, a
+  // reused device slot takes its columns over
+  uint32_t key = ((uint32_t)slot << 16) | registerSlot;
+  uint32_t index = (key * 2654435761u) % HistoryConfig::MAX_COLUMNS;
+  for (uint16_t probe = 0; probe < HistoryConfig::MAX_COLUMNS; probe++) {
+    Column& column = columns[index];
+    if (!column.used) {
+      memset(&column, 0, sizeof(column));
+      column.used = true;
+      column.slot = slot;
+      column.generation = generation;
+      column.registerSlot = registerSlot;
+      column.block = -1;
+      return &column;
+    }
+    if (column.slot == slot && column.registerSlot == registerSlot) {
+      if (column.generation != generation) {
+        // New register layout: old blocks stay under the old generation
+        column.generation = generation;
+        column.block = -1;
+        column.reads = 0;
+      }
+      return &column;
+    }
+    index = (index + 1) % HistoryConfig::MAX_COLUMNS;
+  }
+  return nullptr;
+}
+
+void TrendHistory::appendSample(uint16_t columnIndex, uint32_t time,
+                                float value) {
+  Column& column = columns[columnIndex];
+  Block* block = (column.block >= 0) ? &pool[column.block] : nullptr;
+  uint32_t delta = time - column.lastTime;
+  if (!block || block->data.count >= HistoryConfig::SAMPLES_PER_BLOCK ||
+      delta > UINT16_MAX) {
+    column.block = allocateBlock(columnIndex, time);
+    block = &pool[column.block];
+    delta = 0;  // Sample 0 is at firstTime
+  }
+
+  uint32_t version = block->version.load(std::memory_order_relaxed);
+  block->version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  BlockData& data = block->data;
+  data.delta[data.count] = (uint16_t)delta;
+  data.value[data.count] = value;
+  data.count++;
+  block->version.store(version + 2, std::memory_order_release);
+  column.lastTime = time;
+}
+
+int32_t TrendHistory::allocateBlock(uint16_t columnIndex, uint32_t time) {
+  uint32_t index = nextBlock;
+  nextBlock = (nextBlock + 1) % blockCount;
+  Block& block = pool[index];
+
+  // Recycling the oldest block: the column still writing it moves on
+  uint32_t version = block.version.load(std::memory_order_relaxed);
+  if (version != 0) {
+    Column& owner = columns[block.data.column];
+    if (owner.block == (int32_t)index) {
+      owner.block = -1;
+    }
+  }
+
+  const Column& column = columns[columnIndex];
+  block.version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  block.data.slot = column.slot;
+  block.data.count = 0;
+  block.data.generation = column.generation;
+  block.data.registerSlot = column.registerSlot;
+  block.data.column = columnIndex;
+  block.data.firstTime = time;
+  block.version.store(version + 2, std::memory_order_release);
+  return (int32_t)index;
+}
+
+bool TrendHistory::copyBlock(const Block& block, BlockData& copy) const {
+  for (uint8_t attempt = 0; attempt < 3; attempt++) {
+    uint32_t before = block.version.load(std::memory_order_acquire);
+    if (before == 0) return false;  // Never used
+    if (before & 1) continue;       // Being written
+    memcpy(&copy, &block.data, sizeof(copy));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (block.version.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+  return false;  // Busy block: its samples are skipped this query
+}
+
+uint32_t TrendHistory::query(uint8_t slot, uint16_t generation,
+                             const uint16_t* registerSlots,
+                             size_t registerCount, uint32_t fromS,
+                             uint32_t bucketS, uint16_t points,
+                             Cell* cells) const {
+  if (!pool || registerCount == 0 || points == 0 || bucketS == 0) return 0;
+
+  uint32_t now = nowSeconds();
+  uint32_t oldest = (now > retentionS) ? now - retentionS : 0;
+  const uint16_t* registersEnd = registerSlots + registerCount;
+  uint32_t samples = 0;
+  BlockData data;
+  for (uint32_t i = 0; i < blockCount; i++) {
+    // Cheap filter on the live block, confirmed on the copy
+    const Block& block = pool[i];
+    if (block.data.slot != slot || block.data.generation != generation) {
+      continue;
+    }
+    if (!copyBlock(block, data) || data.slot != slot ||
+        data.generation != generation) {
+      continue;
+    }
+    const uint16_t* found =
+        std::lower_bound(registerSlots, registersEnd, data.registerSlot);
+    if (found == registersEnd || *found != data.registerSlot) continue;
+    size_t index = found - registerSlots;
+
+    uint32_t time = data.firstTime;
+    for (uint8_t s = 0; s < data.count; s++) {
+      time += data.delta[s];
+      if (time < fromS || time < oldest) continue;
+      uint32_t point = (time - fromS) / bucketS;
+      if (point >= points) break;  // Samples are in time order
+
+      Cell& cell = cells[point * registerCount + index];
+      float value = data.value[s];
+      if (cell.count == 0) {
+        cell.min = value;
+        cell.max = value;
+        cell.sum = 0;
+      } else {
+        cell.min = std::min(cell.min, value);
+        cell.max = std::max(cell.max, value);
+      }
+      cell.sum += value;
+      cell.count++;
+      samples++;
+    }
+  }
+  return samples;
+}
+
+void TrendHistory::getStatus(JsonObject& status) const {
+  status["enabled"] = enabled();
+  status["retention_s"] = retentionS;
+  status["interval_s"] = intervalS;
+  status["memory_kb"] = (uint32_t)(blockCount * sizeof(Block) / 1024);
+  status["blocks"] = blockCount;
+  status["dropped_reads"] = droppedReads;
+}
@@ -0,0 +1,153 @@
+#ifndef TREND_HISTORY_H
+#define TREND_HISTORY_H
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
+#include <cstdint>
+
+class ServerConfig;
+
+/**
+ * TrendHistory - Short-term register history in PSRAM (BLE trend query)
+ *
+ * v1.3.3: On-device history
+ * Previous: the app only saw live values (BLE stream); what a register did
+ * in the last hour needed the cloud.
+ * New: every polled value is folded into one sample per register and
+ * "history.interval" seconds (mean of the reads), kept for
+ * "history.retention" minutes in a fixed PSRAM pool ("history.memory_kb").
+ * "read history" returns the range downsampled to at most MAX_POINTS
+ * buckets in the binary stream frame format (CRUDHandler::readHistory).
+ *
+ * Storage: a FIFO of fixed-size blocks. A block holds the samples of one
+ * register column: the time of its first sample, then per sample the
+ * seconds since the previous one (uint16) and the value (float32). Blocks
+ * are handed out round-robin, so the block being reused is always the
+ * oldest one - memory stays bounded and the oldest history goes first.
+ * Time is uptime seconds (esp_timer), converted to unix time on output
+ * when the clock is set.
+ *
+ * Concurrency: producers (RTU / TCP polling tasks) share a short mutex
+ * among themselves. Readers take no lock: blocks carry a seqlock version
+ * (odd while written) and a block changed during the copy is read again,
+ * so a query never delays a poll cycle. Only plain 32-bit atomic loads and
+ * stores are used on PSRAM (no read-modify-write).
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+namespace HistoryConfig {
+constexpr uint32_t DEFAULT_MEMORY_KB = 256;
+constexpr uint32_t MIN_MEMORY_KB = 32;
+constexpr uint32_t MAX_MEMORY_KB = 2048;
+constexpr uint32_t DEFAULT_RETENTION_MIN = 60;
+constexpr uint32_t MAX_RETENTION_MIN = 1440;  // 24 hours
+constexpr uint32_t DEFAULT_INTERVAL_S = 10;   // One sample per register
+constexpr uint32_t MAX_INTERVAL_S = 600;
+constexpr uint16_t MAX_COLUMNS = 1024;      // Registers tracked at once
+constexpr uint8_t SAMPLES_PER_BLOCK = 20;   // 136-byte blocks
+constexpr uint16_t MAX_POINTS = 240;        // Buckets per query
+constexpr uint32_t MAX_CELLS = 4096;        // Buckets x registers per query
+}  // namespace HistoryConfig
+
+class TrendHistory {
+ public:
+  // Aggregate of one register in one query bucket
+  struct Cell {
+    float min;
+    float max;
+    float sum;
+    uint32_t count;  // 0 = no sample in the bucket
+  };
+
+  static TrendHistory* getInstance();
+
+  TrendHistory(const TrendHistory&) = delete;
+  TrendHistory& operator=(const TrendHistory&) = delete;
+
+  /**
+   * Read "history" from the server config and allocate the block pool
+   * @return false if disabled or out of memory (record() is then a no-op)
+   */
+  bool init(ServerConfig* serverConfig);
+  bool enabled() const { return pool != nullptr; }
+
+  /**
+   * Fold one polled value into its register column (polling tasks)
+   */
+  void record(uint8_t slot, uint16_t generation, uint16_t registerSlot,
+              double value);
+
+  /**
+   * Aggregate the samples of registerSlots[] (ascending) of one device into
+   * points buckets of bucketS seconds starting at uptime fromS.
+   * cells[point * registerCount + index] must hold points * registerCount
+   * entries. Never blocks the producers.
+   * @return Number of samples aggregated
+   */
+  uint32_t query(uint8_t slot, uint16_t generation,
+                 const uint16_t* registerSlots, size_t registerCount,
+                 uint32_t fromS, uint32_t bucketS, uint16_t points,
+                 Cell* cells) const;
+
+  static uint32_t nowSeconds();  // Uptime seconds (history time base)
+  uint32_t retentionSeconds() const { return retentionS; }
+  uint32_t intervalSeconds() const { return intervalS; }
+  void getStatus(JsonObject& status) const;
+
+ private:
+  struct BlockData {
+    uint8_t slot;
+    uint8_t count;
+    uint16_t generation;
+    uint16_t registerSlot;
+    uint16_t column;     // Column that writes this block
+    uint32_t firstTime;  // Uptime s of sample 0
+    uint16_t delta[HistoryConfig::SAMPLES_PER_BLOCK];  // s since previous
+    float value[HistoryConfig::SAMPLES_PER_BLOCK];
+  };
+  struct Block {
+    std::atomic<uint32_t> version;  // Seqlock: odd while written, 0 = unused
+    BlockData data;
+  };
+
+  // Producer state of one register (under producerMutex)
+  struct Column {
+    bool used;
+    uint8_t slot;
+    uint16_t generation;
+    uint16_t registerSlot;
+    int32_t block;         // Open block (-1 = none)
+    uint32_t lastTime;     // Uptime s of the newest stored sample
+    uint32_t windowStart;  // Accumulated reads since (uptime s)
+    uint32_t windowEnd;    // Time of the newest accumulated read
+    float sum;
+    uint16_t reads;
+  };
+
+  static TrendHistory* instance;
+
+  Block* pool;
+  uint32_t blockCount;
+  uint32_t nextBlock;  // Round-robin allocation (oldest block)
+  Column* columns;
+  SemaphoreHandle_t producerMutex;
+  uint32_t retentionS;
+  uint32_t intervalS;
+  uint32_t droppedReads;  // Column table full
+
+  TrendHistory();
+
+  Column* findColumn(uint8_t slot, uint16_t generation, uint16_t registerSlot);
+  void appendSample(uint16_t columnIndex, uint32_t time, float value);
+  int32_t allocateBlock(uint16_t columnIndex, uint32_t time);
+  bool copyBlock(const Block& block, BlockData& copy) const;
+};
+
+#endif  // TREND_HISTORY_H
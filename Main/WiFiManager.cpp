@@ -1,8 +1,11 @@
 #include "WiFiManager.h"
 
+#include <Preferences.h>
+
 #include "DebugConfig.h"  // MUST BE FIRST for LOG_* macros
 
 WiFiManager* WiFiManager::instance = nullptr;
+TaskHandle_t WiFiManager::linkEventTask = nullptr;
 
 WiFiManager::WiFiManager()
     : initialized(false),
@@ -10,7 +13,10 @@ WiFiManager::WiFiManager()
       referenceCount(0),
       refCountMutex(nullptr),
       lastReconnectAttempt(0),
-      reconnectCount(0) {
+      reconnectCount(0),
+      eventsRegistered(false),
+      directedConnects(0),
+      scanConnects(0) {
   // FIXED: Create mutex for thread-safe referenceCount operations
   refCountMutex = xSemaphoreCreateMutex();
   if (!refCountMutex) {
@@ -41,6 +47,7 @@ bool WiFiManager::init(const String& ssidParam, const String& passwordParam) {
   ssid = ssidParam;
   password = passwordParam;
   configStored = true;  // v2.5.33: Mark credentials as stored for reconnect
+  loadApCache();        // v1.3.3
 
   // Check if already connected to same network
   if (WiFi.status() == WL_CONNECTED && WiFi.SSID() == ssid) {
@@ -57,18 +64,11 @@ bool WiFiManager::init(const String& ssidParam, const String& passwordParam) {
   }
 
   LOG_NET_INFO("[WiFi] Connecting to: %s\n", ssid.c_str());
-  WiFi.begin(ssid.c_str(), password.c_str());
-
-  // Wait for connection with timeout
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    // v2.5.35: Use DEV_MODE check to prevent log leak in production
-    DEV_SERIAL_PRINT(".");
-    attempts++;
-  }
+  // v1.3.3: Stay associated while Ethernet is active (warm standby)
+  WiFi.setAutoReconnect(true);
 
-  if (WiFi.status() == WL_CONNECTED) {
+  // v1.3.3: Directed connect to the cached AP, else full scan (10 s)
+  if (connect(10000)) {
     initialized = true;
     referenceCount = 1;
     LOG_NET_INFO("\n[WiFi] Connected | IP: %s\n",
@@ -163,6 +163,135 @@ void WiFiManager::getStatus(JsonObject& status) {
     }
     status["connection_status"] = statusStr;
   }
+
+  // v1.3.3: Directed connect
+  JsonObject fast = status["fast_connect"].to<JsonObject>();
+  fast["cached"] = apCache.valid;
+  if (apCache.valid) {
+    char bssidText[18];
+    snprintf(bssidText, sizeof(bssidText), "%02X:%02X:%02X:%02X:%02X:%02X",
+             apCache.bssid[0], apCache.bssid[1], apCache.bssid[2],
+             apCache.bssid[3], apCache.bssid[4], apCache.bssid[5]);
+    fast["bssid"] = bssidText;
+    fast["channel"] = apCache.channel;
+  }
+  fast["directed_connects"] = directedConnects;
+  fast["scan_connects"] = scanConnects;
+}
+
+// ============================================
+// v1.3.3: DIRECTED CONNECT
+// ============================================
+
+bool WiFiManager::waitConnected(uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if ((millis() - start) >= timeoutMs) {
+      return false;
+    }
+    delay(WiFiFastConnectConfig::POLL_MS);
+  }
+  return true;
+}
+
+bool WiFiManager::connect(uint32_t timeoutMs) {
+  if (apCache.valid) {
+    unsigned long start = millis();
+    WiFi.begin(ssid.c_str(), password.c_str(), apCache.channel,
+               apCache.bssid);
+    if (waitConnected(WiFiFastConnectConfig::DIRECTED_TIMEOUT_MS)) {
+      directedConnects++;
+      LOG_NET_INFO("[WiFi] Directed connect (channel %u) in %lu ms\n",
+                   apCache.channel, millis() - start);
+      saveApCache();  // Same AP: no NVS write
+      return true;
+    }
+    // AP replaced or moved to another channel
+    LOG_NET_INFO("[WiFi] Directed connect failed, scanning all channels\n");
+    WiFi.disconnect();
+    clearApCache();
+  }
+
+  WiFi.begin(ssid.c_str(), password.c_str());
+  if (!waitConnected(timeoutMs)) {
+    return false;
+  }
+  scanConnects++;
+  saveApCache();
+  return true;
+}
+
+void WiFiManager::loadApCache() {
+  apCache = ApCache();
+  Preferences prefs;
+  if (!prefs.begin(WiFiFastConnectConfig::NVS_NAMESPACE, true)) {
+    return;  // Nothing stored yet
+  }
+  // Only for the configured network
+  if (prefs.getString("ssid", "") == ssid &&
+      prefs.getBytes("bssid", apCache.bssid, sizeof(apCache.bssid)) ==
+          sizeof(apCache.bssid)) {
+    apCache.channel = prefs.getUChar("channel", 0);
+    apCache.valid = apCache.channel >= 1 && apCache.channel <= 14;
+  }
+  prefs.end();
+}
+
+void WiFiManager::saveApCache() {
+  const uint8_t* bssid = WiFi.BSSID();
+  int32_t channel = WiFi.channel();
+  if (!bssid || channel < 1 || channel > 14) {
+    return;
+  }
+  if (apCache.valid && apCache.channel == channel &&
+      memcmp(apCache.bssid, bssid, sizeof(apCache.bssid)) == 0) {
+    return;  // Unchanged (flash wear)
+  }
+
+  Preferences prefs;
+  if (!prefs.begin(WiFiFastConnectConfig::NVS_NAMESPACE, false)) {
+    return;
+  }
+  prefs.putString("ssid", ssid);
+  prefs.putBytes("bssid", bssid, sizeof(apCache.bssid));
+  prefs.putUChar("channel", (uint8_t)channel);
+  prefs.end();
+
+  memcpy(apCache.bssid, bssid, sizeof(apCache.bssid));
+  apCache.channel = (uint8_t)channel;
+  apCache.valid = true;
+  LOG_NET_INFO("[WiFi] AP cached for directed connect (channel %u)\n",
+               apCache.channel);
+}
+
+void WiFiManager::clearApCache() {
+  apCache = ApCache();
+  Preferences prefs;
+  if (prefs.begin(WiFiFastConnectConfig::NVS_NAMESPACE, false)) {
+    prefs.clear();
+    prefs.end();
+  }
+}
+
+// v1.3.3: Link events for event-driven failover
+// Previous: NetworkMgr noticed a lost WiFi link on its next periodic check
+// (failoverCheckInterval). New: the disconnect / got-IP events notify the
+// failover task directly.
+void WiFiManager::setLinkEventTask(TaskHandle_t task) {
+  linkEventTask = task;
+  if (!eventsRegistered) {
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent(onWiFiEvent, ARDUINO_EVENT_WIFI_STA_LOST_IP);
+    eventsRegistered = true;
+  }
+}
+
+void WiFiManager::onWiFiEvent(arduino_event_id_t) {
+  // Runs in the WiFi event task (not an ISR)
+  if (linkEventTask) {
+    xTaskNotifyGive(linkEventTask);
+  }
 }
 
 // v2.5.33: Check if credentials are stored for reconnect
@@ -192,17 +321,9 @@ bool WiFiManager::tryReconnect() {
     delay(100);
   }
 
-  // Attempt connection
-  WiFi.begin(ssid.c_str(), password.c_str());
-
-  // Wait for connection with shorter timeout (5 seconds for reconnect)
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-    delay(500);
-    attempts++;
-  }
-
-  if (WiFi.status() == WL_CONNECTED) {
+  // Attempt connection with shorter timeout (5 seconds for reconnect)
+  // v1.3.3: Directed connect to the cached AP first
+  if (connect(5000)) {
     initialized = true;
     referenceCount = 1;
     LOG_NET_INFO("[WiFi] Reconnected successfully | IP: %s (attempt #%lu)\n",
@@ -8,6 +8,23 @@
 
 #include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
 
+/**
+ * v1.3.3: Directed (fast) connect
+ * Previous: every boot and every tryReconnect() called WiFi.begin(ssid,
+ * password), which scans all channels (~2-3 s) before associating.
+ * New: the BSSID and channel of the last successful connection are kept in
+ * NVS (per SSID) and passed to WiFi.begin(), so the station joins that AP
+ * on its channel without a scan. If the directed connect fails within
+ * DIRECTED_TIMEOUT_MS (AP replaced, channel changed) the cache is dropped
+ * and the usual full-scan connect follows. Connection state is polled every
+ * POLL_MS (was 500 ms). NVS is only written when the AP changes.
+ */
+namespace WiFiFastConnectConfig {
+constexpr const char* NVS_NAMESPACE = "wifi_ap";
+constexpr uint32_t DIRECTED_TIMEOUT_MS = 3000;
+constexpr uint32_t POLL_MS = 100;
+}  // namespace WiFiFastConnectConfig
+
 class WiFiManager {
  private:
   static WiFiManager* instance;
@@ -22,6 +39,25 @@ class WiFiManager {
   unsigned long lastReconnectAttempt;
   uint32_t reconnectCount;
 
+  // v1.3.3: Task notified on STA disconnect / got IP (NetworkMgr failover)
+  static TaskHandle_t linkEventTask;
+  bool eventsRegistered;
+  static void onWiFiEvent(arduino_event_id_t event);
+
+  // v1.3.3: AP of the last connection to ssid (directed connect)
+  struct ApCache {
+    bool valid = false;
+    uint8_t bssid[6] = {0};
+    uint8_t channel = 0;
+  } apCache;
+  uint32_t directedConnects;
+  uint32_t scanConnects;
+  void loadApCache();
+  void saveApCache();
+  void clearApCache();
+  bool connect(uint32_t timeoutMs);  // Directed, then full scan
+  bool waitConnected(uint32_t timeoutMs);
+
   WiFiManager();
 
  public:
@@ -44,6 +80,9 @@ class WiFiManager {
   bool isInitialized() const { return initialized; }
   uint32_t getReconnectCount() const { return reconnectCount; }
 
+  // v1.3.3: Wake task (xTaskNotifyGive) when the WiFi link goes down or up
+  void setLinkEventTask(TaskHandle_t task);
+
   ~WiFiManager();
 };
 
@@ -0,0 +1,738 @@
+#!/usr/bin/env python3
+"""
+=============================================================================
+SRT-MGATE-1210 Acquisition Benchmark - Modbus Slaves -> Gateway -> MQTT
+=============================================================================
+
+End-to-end throughput benchmark:
+  1. Starts N simulated Modbus slaves with M input registers each
+     (TCP: one server per slave on consecutive ports, RTU: N slave IDs on
+     one serial port)
+  2. Creates one gateway device per slave over BLE (ble_common.py)
+  3. Subscribes to the gateway's MQTT publish topic
+  4. Reports registers/second, value-to-broker latency percentiles and drop
+     rate, plus the gateway's own per-device response times
+
+Latency: register 0 of every slave ("SEQ") is a counter that the simulator
+advances every --stamp-ms and whose set time it remembers. When a SEQ value
+arrives over MQTT, latency = arrival time - time the slave started serving
+that value. Both timestamps come from this host's clock, so no clock sync is
+needed. Latency includes the poll interval wait, the Modbus transaction, the
+publish interval wait and the broker hop.
+
+Drop rate: a register can reach the broker at most once per
+max(refresh_rate_ms, publish interval). Drop rate = 1 - received values /
+that ideal count, over the measurement window.
+
+Version: 1.0.0
+Created: October 14, 2026
+Author: SURIOTA R&D Team
+
+Dependencies:
+  pip install -r requirements.txt   (bleak rich pymodbus pyserial paho-mqtt)
+
+Usage:
+  python acquisition_benchmark.py --protocol tcp --slaves 4 --registers 20
+  python acquisition_benchmark.py --protocol rtu --serial COM5 --slaves 2
+  python acquisition_benchmark.py --help
+
+=============================================================================
+"""
+
+import argparse
+import asyncio
+import json
+import os
+import random
+import socket
+import sys
+import threading
+import time
+
+# Add parent directory to path for shared module
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+from ble_common import (
+    BLEDeviceClient,
+    print_header,
+    print_section,
+    print_success,
+    print_error,
+    print_warning,
+    print_info,
+    print_table,
+    print_summary,
+    format_duration,
+)
+
+# =============================================================================
+# pymodbus Import (3.x async API; 3.10+ renamed slave -> device)
+# =============================================================================
+try:
+    from pymodbus.datastore import ModbusSequentialDataBlock, ModbusServerContext
+
+    try:
+        from pymodbus.datastore import ModbusDeviceContext as ModbusSlaveContext
+    except ImportError:
+        from pymodbus.datastore import ModbusSlaveContext
+
+    from pymodbus.server import StartAsyncSerialServer, StartAsyncTcpServer
+
+    try:
+        from pymodbus import FramerType
+
+        RTU_FRAMER = FramerType.RTU
+    except ImportError:
+        from pymodbus.transaction import ModbusRtuFramer
+
+        RTU_FRAMER = ModbusRtuFramer
+except ImportError as e:
+    print_error(f"pymodbus 3.x not installed: {e}")
+    print_info("Install with: pip install -r requirements.txt")
+    sys.exit(1)
+
+try:
+    import paho.mqtt.client as mqtt
+except ImportError:
+    print_error("paho-mqtt not installed. Run: pip install paho-mqtt")
+    sys.exit(1)
+
+
+# =============================================================================
+# Configuration
+# =============================================================================
+VERSION = "1.0.0"
+DEVICE_NAME_PREFIX = "BENCH"  # Gateway device names: BENCH_TCP_00, ...
+SEQ_REGISTER_NAME = "SEQ"  # Register 0 of every slave
+INPUT_REGISTERS_FC = 4
+SEQ_HISTORY = 65536  # Stamp values remembered per slave (counter range)
+
+
+def get_local_ip():
+    """Auto-detect the local IP the gateway can reach (same as simulators)"""
+    try:
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.connect(("8.8.8.8", 80))
+        local_ip = s.getsockname()[0]
+        s.close()
+        return local_ip
+    except OSError:
+        return "127.0.0.1"
+
+
+def percentile(sorted_values, fraction):
+    """Nearest-rank percentile of an already sorted list"""
+    if not sorted_values:
+        return None
+    rank = max(0, min(len(sorted_values) - 1, int(fraction * len(sorted_values) + 0.5) - 1))
+    return sorted_values[rank]
+
+
+def interval_to_seconds(value, unit):
+    """Gateway interval + interval_unit ("ms", "s", "m") to seconds"""
+    unit = (unit or "s").lower()
+    if unit == "ms":
+        return value / 1000.0
+    if unit == "m":
+        return value * 60.0
+    return float(value)
+
+
+# =============================================================================
+# Simulated Slaves
+# =============================================================================
+class SimulatedSlave:
+    """One Modbus slave: SEQ stamp register + M-1 random-walk registers"""
+
+    def __init__(self, index, protocol, slave_id, num_registers, port=None):
+        self.index = index
+        self.protocol = protocol
+        self.slave_id = slave_id
+        self.num_registers = num_registers
+        self.port = port
+        self.name = f"{DEVICE_NAME_PREFIX}_{protocol.upper()}_{index:02d}"
+        self.seq = 0
+        self.seq_times = [None] * SEQ_HISTORY  # seq -> time.monotonic()
+        self.seq_times[0] = time.monotonic()
+        self.values = [random.randint(100, 1000) for _ in range(num_registers)]
+        self.values[0] = 0
+
+        # One extra register: pymodbus versions differ in the datastore
+        # address offset, setValues()/getValues() apply the same one
+        block = ModbusSequentialDataBlock(0, [0] * (num_registers + 1))
+        self.context = make_slave_context(block)
+        self.context.setValues(INPUT_REGISTERS_FC, 0, self.values)
+
+    def advance(self, now):
+        """Next SEQ value, walk the other registers"""
+        self.seq = (self.seq + 1) % SEQ_HISTORY
+        self.values[0] = self.seq
+        for i in range(1, self.num_registers):
+            self.values[i] = max(0, min(32767, self.values[i] + random.choice([-2, -1, 0, 1, 2])))
+        self.context.setValues(INPUT_REGISTERS_FC, 0, self.values)
+        self.seq_times[self.seq] = now
+
+    def seq_time(self, seq):
+        if not isinstance(seq, (int, float)) or not 0 <= seq < SEQ_HISTORY:
+            return None
+        return self.seq_times[int(seq)]
+
+
+def make_slave_context(block):
+    empty = lambda: ModbusSequentialDataBlock(0, [0] * 10)
+    try:
+        return ModbusSlaveContext(di=empty(), co=empty(), hr=empty(), ir=block, zero_mode=True)
+    except TypeError:
+        return ModbusSlaveContext(di=empty(), co=empty(), hr=empty(), ir=block)
+
+
+def make_server_context(slaves):
+    try:
+        return ModbusServerContext(devices=slaves, single=False)
+    except TypeError:
+        return ModbusServerContext(slaves=slaves, single=False)
+
+
+class SlaveFarm:
+    """Runs the simulated slaves and their SEQ updater on an asyncio loop"""
+
+    def __init__(self, args):
+        self.args = args
+        self.slaves = []
+        self.tasks = []
+        if args.protocol == "tcp":
+            for i in range(args.slaves):
+                self.slaves.append(
+                    SimulatedSlave(i, "tcp", 1, args.registers, port=args.base_port + i)
+                )
+        else:
+            for i in range(args.slaves):
+                self.slaves.append(
+                    SimulatedSlave(i, "rtu", args.first_slave_id + i, args.registers)
+                )
+        self.by_name = {s.name: s for s in self.slaves}
+
+    async def start(self):
+        args = self.args
+        if args.protocol == "tcp":
+            for slave in self.slaves:
+                context = make_server_context({slave.slave_id: slave.context})
+                self.tasks.append(
+                    asyncio.create_task(
+                        StartAsyncTcpServer(context=context, address=(args.bind, slave.port))
+                    )
+                )
+            print_success(
+                f"{len(self.slaves)} TCP slaves on {args.host_ip}:"
+                f"{args.base_port}-{args.base_port + len(self.slaves) - 1}"
+            )
+        else:
+            context = make_server_context({s.slave_id: s.context for s in self.slaves})
+            self.tasks.append(
+                asyncio.create_task(
+                    StartAsyncSerialServer(
+                        context=context,
+                        framer=RTU_FRAMER,
+                        port=args.serial,
+                        baudrate=args.baud,
+                        bytesize=8,
+                        parity="N",
+                        stopbits=1,
+                    )
+                )
+            )
+            print_success(
+                f"{len(self.slaves)} RTU slaves (IDs {args.first_slave_id}-"
+                f"{args.first_slave_id + len(self.slaves) - 1}) on {args.serial} @ {args.baud}"
+            )
+        self.tasks.append(asyncio.create_task(self._updater()))
+        await asyncio.sleep(0.5)  # Let the servers bind
+        for task in self.tasks:
+            if task.done() and task.exception():
+                raise task.exception()
+
+    async def _updater(self):
+        period = self.args.stamp_ms / 1000.0
+        next_tick = time.monotonic()
+        while True:
+            next_tick += period
+            await asyncio.sleep(max(0.0, next_tick - time.monotonic()))
+            now = time.monotonic()
+            for slave in self.slaves:
+                slave.advance(now)
+
+    async def stop(self):
+        for task in self.tasks:
+            task.cancel()
+        await asyncio.gather(*self.tasks, return_exceptions=True)
+
+
+# =============================================================================
+# MQTT Collector
+# =============================================================================
+class MqttCollector:
+    """Counts benchmark register values and SEQ latencies from the broker"""
+
+    def __init__(self, farm, topic):
+        self.farm = farm
+        self.topic = topic
+        self.lock = threading.Lock()
+        self.measuring = False
+        self.schema = {}  # schema_id -> [(device_name, [register names])]
+        self.schema_devices = []  # Latest schema (retained)
+        self.reset()
+
+    def reset(self):
+        with self.lock:
+            self.messages = 0
+            self.payload_bytes = 0
+            self.undecodable = 0
+            self.values = {s.name: 0 for s in self.farm.slaves}
+            self.latencies = []
+            self.seen_seq = {s.name: set() for s in self.farm.slaves}
+            self.first_seen = {}  # Device name -> monotonic (warm-up)
+
+    # -- paho callbacks (network thread) --------------------------------------
+    def on_connect(self, client, userdata, flags, rc, properties=None):
+        client.subscribe(self.topic, qos=1)
+        client.subscribe(self.topic + "/schema", qos=1)
+
+    def on_message(self, client, userdata, message):
+        received = time.monotonic()
+        try:
+            payload = json.loads(message.payload.decode("utf-8"))
+        except (UnicodeDecodeError, ValueError):
+            with self.lock:
+                self.undecodable += 1
+            return
+
+        if message.topic.endswith("/schema"):
+            with self.lock:
+                self.schema_devices = [
+                    (d.get("device_name", ""), [r.get("name", "") for r in d.get("registers", [])])
+                    for d in payload.get("devices", [])
+                ]
+                if "schema_id" in payload:
+                    self.schema[payload["schema_id"]] = self.schema_devices
+            return
+
+        with self.lock:
+            self.messages += 1
+            self.payload_bytes += len(message.payload)
+            for name, registers in self._iterate(payload):
+                slave = self.farm.by_name.get(name)
+                if slave is None:
+                    continue  # Not a benchmark device
+                self.first_seen.setdefault(name, received)
+                if not self.measuring:
+                    continue
+                self.values[name] += sum(1 for v in registers.values() if v is not None)
+                seq = registers.get(SEQ_REGISTER_NAME)
+                if seq is None or seq in self.seen_seq[name]:
+                    continue  # Same value as before (not a new sample)
+                self.seen_seq[name].add(seq)
+                stamped = slave.seq_time(seq)
+                if stamped is not None and received >= stamped:
+                    self.latencies.append((received - stamped) * 1000.0)
+
+    def _iterate(self, payload):
+        """Yield (device_name, {register_name: value}) of one publish"""
+        devices = payload.get("devices")
+        if isinstance(devices, dict):
+            # Default layout: devices.{device_id}.{register_name}.value
+            for device in devices.values():
+                if not isinstance(device, dict):
+                    continue
+                registers = {
+                    k: v.get("value") for k, v in device.items() if isinstance(v, dict)
+                }
+                yield device.get("device_name", ""), registers
+            return
+        values = payload.get("values")
+        if isinstance(values, list):
+            # v1.3.3 compact layout: values[device][register] in schema order
+            schema = self.schema.get(payload.get("schema_id"), self.schema_devices)
+            for (name, names), row in zip(schema, values):
+                if isinstance(row, list):
+                    yield name, dict(zip(names, row))
+
+    def snapshot(self):
+        with self.lock:
+            return {
+                "messages": self.messages,
+                "payload_bytes": self.payload_bytes,
+                "undecodable": self.undecodable,
+                "values": dict(self.values),
+                "latencies": sorted(self.latencies),
+            }
+
+
+def start_mqtt(collector, args):
+    try:
+        client = mqtt.Client(
+            mqtt.CallbackAPIVersion.VERSION2, client_id=f"mgate_bench_{random.randint(0, 99999)}"
+        )
+    except AttributeError:  # paho-mqtt 1.x
+        client = mqtt.Client(client_id=f"mgate_bench_{random.randint(0, 99999)}")
+    if args.mqtt_user:
+        client.username_pw_set(args.mqtt_user, args.mqtt_password)
+    client.on_connect = collector.on_connect
+    client.on_message = collector.on_message
+    client.connect(args.broker, args.broker_port, keepalive=60)
+    client.loop_start()
+    return client
+
+
+# =============================================================================
+# Gateway (BLE)
+# =============================================================================
+async def read_server_config(ble):
+    response = await ble.send_command(
+        json.dumps({"op": "read", "type": "server_config"}, separators=(",", ":"))
+    )
+    if response and response.get("status") == "ok":
+        return response.get("config", {})
+    return {}
+
+
+def apply_server_config(args, config):
+    """Fill broker / topic / publish interval the user did not pass"""
+    mqtt_config = config.get("mqtt_config", {})
+    default_mode = mqtt_config.get("default_mode", {})
+    if args.broker is None:
+        args.broker = mqtt_config.get("broker_address")
+        args.broker_port = mqtt_config.get("broker_port", args.broker_port)
+        if args.mqtt_user is None and mqtt_config.get("username"):
+            args.mqtt_user = mqtt_config.get("username")
+            args.mqtt_password = mqtt_config.get("password")
+    if args.topic is None:
+        args.topic = default_mode.get("topic_publish")
+    if args.publish_interval is None and "interval" in default_mode:
+        args.publish_interval = interval_to_seconds(
+            default_mode["interval"], default_mode.get("interval_unit", "s")
+        )
+    if config.get("protocol", "mqtt") != "mqtt" or not mqtt_config.get("enabled", True):
+        print_warning("Gateway protocol is not MQTT - nothing will reach the broker")
+    if mqtt_config.get("publish_mode", "default") != "default":
+        print_warning("Gateway uses customize mode - only default mode is measured")
+
+
+def device_config(slave, args):
+    config = {
+        "device_name": slave.name,
+        "protocol": slave.protocol.upper(),
+        "slave_id": slave.slave_id,
+        "timeout": args.device_timeout,
+        "retry_count": 1,
+        "refresh_rate_ms": args.refresh_ms,
+    }
+    if slave.protocol == "tcp":
+        config.update({"ip": args.host_ip, "port": slave.port})
+    else:
+        config.update(
+            {
+                "serial_port": args.rtu_bus,
+                "baud_rate": args.baud,
+                "data_bits": 8,
+                "parity": "None",
+                "stop_bits": 1,
+            }
+        )
+    return config
+
+
+def register_config(address):
+    return {
+        "address": address,
+        "register_name": SEQ_REGISTER_NAME if address == 0 else f"R{address:03d}",
+        "type": "Input Registers",
+        "function_code": INPUT_REGISTERS_FC,
+        "data_type": "UINT16",
+        "description": "Benchmark sequence stamp" if address == 0 else "Benchmark value",
+        "unit": "",
+        "scale": 1.0,
+        "offset": 0.0,
+    }
+
+
+async def create_devices(ble, farm):
+    """One gateway device per slave; returns the created device IDs"""
+    device_ids = []
+    for slave in farm.slaves:
+        device_id = await ble.create_device(device_config(slave, farm.args), slave.name)
+        if not device_id:
+            raise RuntimeError(f"Device creation failed for {slave.name}")
+        device_ids.append(device_id)
+        for address in range(slave.num_registers):
+            if not await ble.create_register(device_id, register_config(address)):
+                raise RuntimeError(f"Register {address} creation failed for {slave.name}")
+            await asyncio.sleep(0.2)
+        print_success(f"{slave.name}: {device_id} with {slave.num_registers} registers")
+    return device_ids
+
+
+async def delete_devices(ble, device_ids):
+    for device_id in device_ids:
+        response = await ble.send_command(
+            json.dumps(
+                {"op": "delete", "type": "device", "device_id": device_id},
+                separators=(",", ":"),
+            ),
+            timeout=15,
+        )
+        if not response or response.get("status") != "ok":
+            print_warning(f"Could not delete {device_id}")
+
+
+async def gateway_statistics(ble):
+    """Gateway-side view after the run (device response times, task profile)"""
+    result = {}
+    for key, command in (
+        ("device_status", {"op": "control", "type": "get_all_device_status"}),
+        ("task_profile", {"op": "read", "type": "task_profile"}),
+    ):
+        response = await ble.send_command(json.dumps(command, separators=(",", ":")))
+        if response and response.get("status") == "ok":
+            result[key] = response
+    return result
+
+
+# =============================================================================
+# Benchmark
+# =============================================================================
+async def wait_for_devices(collector, farm, timeout):
+    """Warm-up: until every benchmark device reached the broker once"""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        with collector.lock:
+            seen = len(collector.first_seen)
+        if seen == len(farm.slaves):
+            return True
+        await asyncio.sleep(0.5)
+    with collector.lock:
+        missing = [s.name for s in farm.slaves if s.name not in collector.first_seen]
+    print_warning(f"Not seen on the broker after {timeout}s: {', '.join(missing)}")
+    return False
+
+
+def build_report(args, farm, snapshot, duration, gateway):
+    total_values = sum(snapshot["values"].values())
+    slot_seconds = max(args.refresh_ms / 1000.0, args.publish_interval)
+    expected = len(farm.slaves) * args.registers * (duration / slot_seconds)
+    latencies = snapshot["latencies"]
+    report = {
+        "benchmark_version": VERSION,
+        "protocol": args.protocol,
+        "slaves": len(farm.slaves),
+        "registers_per_slave": args.registers,
+        "refresh_rate_ms": args.refresh_ms,
+        "publish_interval_s": args.publish_interval,
+        "duration_s": round(duration, 1),
+        "messages": snapshot["messages"],
+        "avg_payload_bytes": (
+            round(snapshot["payload_bytes"] / snapshot["messages"]) if snapshot["messages"] else 0
+        ),
+        "undecodable_messages": snapshot["undecodable"],
+        "register_values": total_values,
+        "registers_per_second": round(total_values / duration, 1) if duration > 0 else 0,
+        "expected_values": round(expected),
+        "drop_rate": round(max(0.0, 1.0 - total_values / expected), 4) if expected else None,
+        "latency_samples": len(latencies),
+        "latency_ms": {
+            "p50": percentile(latencies, 0.50),
+            "p95": percentile(latencies, 0.95),
+            "p99": percentile(latencies, 0.99),
+            "max": latencies[-1] if latencies else None,
+        },
+        "per_device_values": snapshot["values"],
+    }
+    if gateway:
+        report["gateway"] = gateway
+    return report
+
+
+def print_report(report):
+    print_section("Results", "[RES]")
+    latency = report["latency_ms"]
+    fmt = lambda v: f"{v:.0f} ms" if v is not None else "-"
+    drop = report["drop_rate"]
+    print_summary(
+        "Acquisition Benchmark",
+        {
+            "Setup": f"{report['slaves']} x {report['registers_per_slave']} registers "
+            f"({report['protocol'].upper()})",
+            "Poll / publish": f"{report['refresh_rate_ms']} ms / {report['publish_interval_s']} s",
+            "Duration": format_duration(report["duration_s"]),
+            "MQTT messages": f"{report['messages']} (avg {report['avg_payload_bytes']} bytes)",
+            "Registers/second": report["registers_per_second"],
+            "Values received": f"{report['register_values']} of {report['expected_values']}",
+            "Drop rate": f"{drop * 100:.2f}%" if drop is not None else "-",
+            "Latency p50/p95/p99": f"{fmt(latency['p50'])} / {fmt(latency['p95'])} / "
+            f"{fmt(latency['p99'])}",
+            "Latency max": fmt(latency["max"]),
+        },
+        success=(drop is not None and drop < 0.01),
+    )
+
+    rows = [[name, count] for name, count in sorted(report["per_device_values"].items())]
+    print_table(["Device", "Values"], rows, title="Per device")
+
+    status = report.get("gateway", {}).get("device_status", {})
+    rows = []
+    for group in ("rtu_devices", "tcp_devices"):
+        for device in status.get(group, {}).get("devices", []):
+            metrics = device.get("metrics", {})
+            rows.append(
+                [
+                    device.get("device_id", ""),
+                    metrics.get("success_rate", "-"),
+                    metrics.get("p50_response_time_ms", "-"),
+                    metrics.get("p95_response_time_ms", "-"),
+                    metrics.get("p99_response_time_ms", "-"),
+                ]
+            )
+    if rows:
+        print_table(
+            ["Device", "Success %", "p50 ms", "p95 ms", "p99 ms"],
+            rows,
+            title="Gateway Modbus response times",
+        )
+
+
+async def run(args):
+    print_header(
+        "ACQUISITION BENCHMARK",
+        f"{args.slaves} {args.protocol.upper()} slaves x {args.registers} registers",
+        VERSION,
+    )
+
+    farm = SlaveFarm(args)
+    print_section("Simulated Slaves", "[SIM]")
+    await farm.start()
+
+    ble = None
+    device_ids = []
+    try:
+        if not args.no_ble:
+            print_section("Gateway Configuration (BLE)", "[BLE]")
+            ble = BLEDeviceClient()
+            if not await ble.connect(auto_select=args.auto_select):
+                return 1
+            apply_server_config(args, await read_server_config(ble))
+            if not args.skip_create:
+                device_ids = await create_devices(ble, farm)
+
+        if args.broker is None or args.topic is None or args.publish_interval is None:
+            print_error("Broker, topic and publish interval are unknown - pass "
+                        "--broker / --topic / --publish-interval")
+            return 1
+
+        print_section("MQTT", "[MQT]")
+        collector = MqttCollector(farm, args.topic)
+        client = start_mqtt(collector, args)
+        print_info(f"Subscribed to {args.topic} on {args.broker}:{args.broker_port}")
+
+        print_section("Warm-up", "[WUP]")
+        await wait_for_devices(collector, farm, args.warmup)
+
+        print_section("Measurement", "[RUN]")
+        collector.reset()
+        collector.measuring = True
+        started = time.monotonic()
+        print_info(f"Measuring for {format_duration(args.duration)}...")
+        await asyncio.sleep(args.duration)
+        collector.measuring = False
+        duration = time.monotonic() - started
+        snapshot = collector.snapshot()
+        client.loop_stop()
+        client.disconnect()
+
+        gateway = await gateway_statistics(ble) if ble else {}
+        report = build_report(args, farm, snapshot, duration, gateway)
+        print_report(report)
+        if args.json_out:
+            with open(args.json_out, "w") as f:
+                json.dump(report, f, indent=2)
+            print_success(f"Report written to {args.json_out}")
+        return 0
+    finally:
+        if ble:
+            if device_ids and not args.keep_devices:
+                print_info("Deleting benchmark devices...")
+                await delete_devices(ble, device_ids)
+            await ble.disconnect()
+        await farm.stop()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="End-to-end Modbus -> gateway -> MQTT acquisition benchmark"
+    )
+    parser.add_argument("--protocol", choices=["tcp", "rtu"], default="tcp")
+    parser.add_argument("--slaves", type=int, default=1, help="Simulated slaves (N)")
+    parser.add_argument("--registers", type=int, default=10,
+                        help="Input registers per slave (M, register 0 is SEQ)")
+    parser.add_argument("--refresh-ms", type=int, default=1000,
+                        help="Gateway refresh_rate_ms of every benchmark device")
+    parser.add_argument("--device-timeout", type=int, default=1000,
+                        help="Gateway device timeout (ms)")
+    parser.add_argument("--stamp-ms", type=int, default=100,
+                        help="SEQ register update period (latency resolution)")
+    parser.add_argument("--duration", type=float, default=120, help="Measurement seconds")
+    parser.add_argument("--warmup", type=float, default=60,
+                        help="Max seconds to wait for every device on the broker")
+    # TCP slaves
+    parser.add_argument("--host-ip", default=get_local_ip(),
+                        help="IP the gateway uses to reach this host")
+    parser.add_argument("--bind", default="0.0.0.0", help="TCP slave bind address")
+    parser.add_argument("--base-port", type=int, default=5020,
+                        help="First TCP slave port (slave i on base + i)")
+    # RTU slaves
+    parser.add_argument("--serial", help="RS485 adapter port (e.g. COM5, /dev/ttyUSB0)")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--rtu-bus", type=int, choices=[1, 2], default=1,
+                        help="Gateway serial_port the adapter is wired to")
+    parser.add_argument("--first-slave-id", type=int, default=1)
+    # MQTT (defaults read from the gateway server_config over BLE)
+    parser.add_argument("--broker")
+    parser.add_argument("--broker-port", type=int, default=1883)
+    parser.add_argument("--mqtt-user")
+    parser.add_argument("--mqtt-password")
+    parser.add_argument("--topic", help="Default mode topic_publish")
+    parser.add_argument("--publish-interval", type=float,
+                        help="Default mode publish interval (seconds)")
+    # BLE
+    parser.add_argument("--no-ble", action="store_true",
+                        help="Gateway already configured; no BLE at all")
+    parser.add_argument("--skip-create", action="store_true",
+                        help="Use BLE only for server_config and statistics")
+    parser.add_argument("--keep-devices", action="store_true",
+                        help="Do not delete the benchmark devices afterwards")
+    parser.add_argument("--auto-select", action="store_true",
+                        help="Connect to the first gateway found")
+    parser.add_argument("--json-out", help="Write the report as JSON")
+    args = parser.parse_args()
+
+    if args.protocol == "rtu" and not args.serial:
+        parser.error("--protocol rtu needs --serial")
+    if args.registers < 1:
+        parser.error("--registers must be at least 1 (SEQ)")
+    if args.slaves < 1:
+        parser.error("--slaves must be at least 1")
+    return args
+
+
+def main():
+    args = parse_args()
+    try:
+        return asyncio.run(run(args))
+    except KeyboardInterrupt:
+        print_warning("Interrupted")
+        return 130
+    except Exception as e:
+        print_error(f"Benchmark failed: {e}")
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,105 @@
+#include "BenchFixtures.h"
+
+namespace BenchFixtures {
+
+namespace {
+
+const char* const DATA_TYPES[] = {
+    "INT16",       "UINT16",      "FLOAT32_BE",  "FLOAT32_LE",
+    "FLOAT32_BE_BS", "FLOAT32_LE_BS", "INT32_BE",  "UINT32_LE_BS",
+    "INT64_BE",    "UINT64_LE",   "DOUBLE64_BE", "DOUBLE64_LE_BS"};
+const size_t DATA_TYPE_COUNT = sizeof(DATA_TYPES) / sizeof(DATA_TYPES[0]);
+
+const char* const UNITS[] = {"V", "A", "kW", "degC", "%", "Hz"};
+
+}  // namespace
+
+void fillDevice(JsonObject device, const char* deviceId,
+                uint16_t registerCount) {
+  device["device_id"] = deviceId;
+  device["device_name"] = String("Bench ") + deviceId;
+  device["protocol"] = "TCP";
+  device["ip"] = "192.168.1.100";
+  device["port"] = 502;
+  device["slave_id"] = 1;
+  device["timeout"] = 3000;
+  device["retry_count"] = 3;
+  device["refresh_rate_ms"] = 1000;
+  device["enabled"] = true;
+
+  JsonArray registers = device["registers"].to<JsonArray>();
+  uint16_t address = 0;
+  for (uint16_t i = 0; i < registerCount; i++) {
+    const char* dataType = DATA_TYPES[i % DATA_TYPE_COUNT];
+    char text[32];
+
+    JsonObject reg = registers.add<JsonObject>();
+    snprintf(text, sizeof(text), "R%05u", (unsigned)i);
+    reg["register_id"] = text;
+    reg["register_index"] = i + 1;
+    snprintf(text, sizeof(text), "Value_%03u", (unsigned)i);
+    reg["register_name"] = text;
+    reg["address"] = address;
+    reg["function_code"] = 3;
+    reg["data_type"] = dataType;
+    reg["scale"] = 1.0;
+    reg["offset"] = 0.0;
+    reg["decimals"] = 2;
+    reg["unit"] = UNITS[i % (sizeof(UNITS) / sizeof(UNITS[0]))];
+    reg["description"] = "Host benchmark register";
+
+    ModbusDataType type;
+    ModbusEndianness endianness;
+    ModbusUtils::parseDataType(dataType, type, endianness);
+    address += ModbusUtils::getWordCount(type);
+  }
+}
+
+PlanSet::PlanSet(const char* idPrefix, uint16_t deviceCount,
+                 uint16_t registerCount) {
+  JsonObject devices = configs.to<JsonObject>();
+  for (uint16_t d = 0; d < deviceCount; d++) {
+    char deviceId[24];
+    snprintf(deviceId, sizeof(deviceId), "%s_%03u", idPrefix, (unsigned)d);
+    fillDevice(devices[deviceId].to<JsonObject>(), deviceId, registerCount);
+  }
+
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  uint32_t epoch = registry->beginRefresh();
+  for (JsonPair pair : devices) {
+    std::unique_ptr<CompiledDevicePlan> plan(new CompiledDevicePlan());
+    JsonObject device = pair.value().as<JsonObject>();
+    if (!ModbusPollPlan::compile(device, *plan,
+                                 ModbusSpanConfig::MAX_SPAN_REGISTERS,
+                                 ModbusSpanConfig::MAX_SPAN_BITS)) {
+      continue;
+    }
+    registry->attach(PollPlanRegistry::OWNER_TCP, epoch, *plan);
+    devicePlans.push_back(std::move(plan));
+  }
+  registry->endRefresh(PollPlanRegistry::OWNER_TCP, epoch);
+}
+
+PlanSet::~PlanSet() {
+  // A refresh without devices releases every TCP slot
+  PollPlanRegistry* registry = PollPlanRegistry::getInstance();
+  registry->endRefresh(PollPlanRegistry::OWNER_TCP, registry->beginRefresh());
+}
+
+void PlanSet::storeAllLatest(double base) {
+  for (auto& plan : devicePlans) {
+    for (uint16_t r = 0; r < plan->registers.size(); r++) {
+      ModbusPollPlan::storeLatest(*plan, r, base + r, 1760400000);
+    }
+  }
+}
+
+uint32_t PlanSet::registerTotal() const {
+  uint32_t total = 0;
+  for (const auto& plan : devicePlans) {
+    total += plan->registers.size();
+  }
+  return total;
+}
+
+}  // namespace BenchFixtures
@@ -0,0 +1,53 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+/**
+ * Shared benchmark inputs: gateway device configs and compiled poll plans
+ * bound to PollPlanRegistry (same objects the RTU/TCP services build).
+ */
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <ArduinoJson.h>
+
+#include <memory>
+#include <vector>
+
+#include "ModbusPollPlan.h"
+
+namespace BenchFixtures {
+
+/**
+ * Fill device with a TCP device config of registerCount holding registers.
+ * Data types cycle through 16/32/64-bit types and all byte orders; register
+ * addresses are contiguous (one read span per 125 words).
+ */
+void fillDevice(JsonObject device, const char* deviceId,
+                uint16_t registerCount);
+
+/**
+ * deviceCount compiled device plans attached to PollPlanRegistry
+ * (released again by the destructor)
+ */
+class PlanSet {
+ public:
+  PlanSet(const char* idPrefix, uint16_t deviceCount, uint16_t registerCount);
+  ~PlanSet();
+
+  PlanSet(const PlanSet&) = delete;
+  PlanSet& operator=(const PlanSet&) = delete;
+
+  // Store a new latest value for every register (one simulated poll cycle)
+  void storeAllLatest(double base);
+
+  std::vector<std::unique_ptr<CompiledDevicePlan>>& plans() { return devicePlans; }
+  uint32_t registerTotal() const;
+
+ private:
+  SpiRamJsonDocument configs;  // Owns the strings the plans point to
+  std::vector<std::unique_ptr<CompiledDevicePlan>> devicePlans;
+};
+
+}  // namespace BenchFixtures
+
+#endif  // BENCH_FIXTURES_H
@@ -0,0 +1,61 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+/**
+ * HostBench - Minimal micro-benchmark runner for the host build
+ *
+ * Each benchmark is one operation (a lambda). The runner repeats it until the
+ * sample takes at least minSampleMs, takes `repeat` samples and reports the
+ * median ns/op. Results can be written as JSON and compared against a
+ * previous run (--baseline / --max-regression) to catch regressions.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace HostBench {
+
+using Operation = std::function<void()>;
+
+struct Benchmark {
+  std::string name;     // "group/case", filtered with --filter
+  Operation run;        // One operation
+  uint32_t itemsPerOp;  // Items handled per operation (items/s column)
+  Operation setup;      // Optional, before the first sample (not timed)
+  Operation teardown;   // Optional, after the last sample (not timed)
+};
+
+struct Result {
+  std::string name;
+  double nsPerOp;
+  double itemsPerSec;
+  uint64_t iterations;  // Per sample
+};
+
+// Register a benchmark (called by the register*Benchmarks() functions)
+void add(const std::string& name, Operation run, uint32_t itemsPerOp = 1,
+         Operation setup = nullptr, Operation teardown = nullptr);
+
+// Keep value alive so the compiler cannot drop the measured work
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Benchmark groups (one per bench_*.cpp)
+void registerModbusUtilsBenchmarks();
+void registerQueueManagerBenchmarks();
+void registerPayloadBenchmarks();
+void registerConfigManagerBenchmarks();
+
+const std::vector<Benchmark>& all();
+
+}  // namespace HostBench
+
+#endif  // HOST_BENCH_H
@@ -0,0 +1,81 @@
+/**
+ * ConfigManager load benchmarks (10 devices x 50 registers on a host
+ * directory standing in for LittleFS)
+ * - load_snapshot: refreshCache() from the binary devices snapshot (boot
+ *   path while the snapshot matches the manifest)
+ * - load_records: refreshCache() after the snapshot was removed (manifest +
+ *   one JSON record per device, then the snapshot is rewritten)
+ * Both include the load migrations and publishing the devices generation.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "BenchFixtures.h"
+#include "ConfigManager.h"
+#include "HostBench.h"
+
+namespace HostBench {
+
+namespace {
+
+const uint16_t DEVICES = 10;
+const uint16_t REGISTERS = 50;
+const char* const SNAPSHOT_FILE = "/devices.snap";  // DEVICES_SNAPSHOT_FILE
+
+ConfigManager* config = nullptr;
+std::string rootDir;
+
+void createStore() {
+  char pattern[] = "/tmp/gateway-host-bench-XXXXXX";
+  if (!mkdtemp(pattern)) {
+    fprintf(stderr, "mkdtemp failed, config benchmarks will fail\n");
+    return;
+  }
+  rootDir = pattern;
+  LittleFS.setHostRoot(rootDir.c_str());
+
+  config = new ConfigManager();
+  if (!config->begin()) {
+    fprintf(stderr, "ConfigManager begin failed\n");
+    return;
+  }
+
+  // Restore path of createDevice(): device object with its registers
+  for (uint16_t d = 0; d < DEVICES; d++) {
+    JsonDocument device;
+    char deviceId[16];
+    snprintf(deviceId, sizeof(deviceId), "BC_%03u", (unsigned)d);
+    BenchFixtures::fillDevice(device.to<JsonObject>(), deviceId, REGISTERS);
+    config->createDevice(device.as<JsonObjectConst>());
+  }
+  config->refreshCache();  // Writes the snapshot
+}
+
+void removeStore() {
+  delete config;
+  config = nullptr;
+  LittleFS.format();
+  rmdir(rootDir.c_str());
+}
+
+}  // namespace
+
+void registerConfigManagerBenchmarks() {
+  add("config_manager/load_snapshot/10x50",
+      []() {
+        config->refreshCache();
+        doNotOptimize(config);
+      },
+      DEVICES * REGISTERS, createStore, removeStore);
+
+  add("config_manager/load_records/10x50",
+      []() {
+        LittleFS.remove(SNAPSHOT_FILE);
+        config->refreshCache();
+        doNotOptimize(config);
+      },
+      DEVICES * REGISTERS, createStore, removeStore);
+}
+
+}  // namespace HostBench
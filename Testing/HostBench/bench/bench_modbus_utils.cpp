@@ -0,0 +1,94 @@
+/**
+ * ModbusUtils decode benchmarks
+ * - processRegisterValue / processMultiRegisterValue: string front-end used
+ *   by write paths and older callers, every type x byte order
+ * - decodeValue: enum path of the compiled poll plans
+ * - decodeSpan: batch decode + calibration of one poll cycle
+ */
+
+#include "BenchFixtures.h"
+#include "HostBench.h"
+#include "ModbusPollPlan.h"
+#include "ModbusUtils.h"
+
+namespace HostBench {
+
+namespace {
+
+struct TypeCase {
+  const char* baseType;
+  int wordCount;
+};
+
+const TypeCase MULTI_TYPES[] = {{"INT32", 2},  {"UINT32", 2}, {"FLOAT32", 2},
+                                {"INT64", 4},  {"UINT64", 4}, {"DOUBLE64", 4}};
+const char* const ENDIANNESS[] = {"BE", "LE", "BE_BS", "LE_BS"};
+const char* const SINGLE_TYPES[] = {"INT16", "UINT16", "BOOL", "BINARY"};
+
+// Raw words shared by every case (FLOAT32 BE = 123.456, rest arbitrary)
+uint16_t words[4] = {0x42F6, 0xE979, 0x1234, 0x5678};
+
+}  // namespace
+
+void registerModbusUtilsBenchmarks() {
+  // Register config objects must outlive the benchmarks
+  static JsonDocument registerConfigs;
+  JsonArray configs = registerConfigs.to<JsonArray>();
+
+  for (const char* type : SINGLE_TYPES) {
+    JsonObject reg = configs.add<JsonObject>();
+    reg["data_type"] = type;
+    add(std::string("modbus_utils/processRegisterValue/") + type, [reg]() {
+      double value = ModbusUtils::processRegisterValue(reg, words[0]);
+      doNotOptimize(value);
+    });
+  }
+
+  for (const TypeCase& typeCase : MULTI_TYPES) {
+    for (const char* endianness : ENDIANNESS) {
+      std::string dataType = std::string(typeCase.baseType) + "_" + endianness;
+      JsonObject reg = configs.add<JsonObject>();
+      reg["data_type"] = dataType.c_str();
+      add("modbus_utils/processMultiRegisterValue/" + dataType,
+          [reg, typeCase, endianness]() {
+            double value = ModbusUtils::processMultiRegisterValue(
+                reg, words, typeCase.wordCount, typeCase.baseType, endianness);
+            doNotOptimize(value);
+          });
+    }
+  }
+
+  for (const TypeCase& typeCase : MULTI_TYPES) {
+    for (const char* endianness : ENDIANNESS) {
+      std::string dataType = std::string(typeCase.baseType) + "_" + endianness;
+      ModbusDataType type;
+      ModbusEndianness order;
+      ModbusUtils::parseDataType(dataType.c_str(), type, order);
+      add("modbus_utils/decodeValue/" + dataType, [type, order]() {
+        double value = ModbusUtils::decodeValue(words, type, order);
+        doNotOptimize(value);
+      });
+    }
+  }
+
+  // One device cycle: decode + calibrate the slot words of 100 mixed
+  // registers (plan not bound to PollPlanRegistry)
+  static JsonDocument spanConfig;
+  static CompiledDevicePlan spanPlan;
+  BenchFixtures::fillDevice(spanConfig.to<JsonObject>(), "BU_000", 100);
+  ModbusPollPlan::compile(spanConfig.as<JsonObject>(), spanPlan,
+                          ModbusSpanConfig::MAX_SPAN_REGISTERS,
+                          ModbusSpanConfig::MAX_SPAN_BITS);
+  CompiledDevicePlan* plan = &spanPlan;
+  for (size_t i = 0; i < plan->slotWords.size(); i++) {
+    plan->slotWords[i] = (uint16_t)(0x4000 + i * 37);
+  }
+  add("modbus_utils/decodeSpan/100_registers",
+      [plan]() {
+        ModbusPollPlan::decodeSlots(*plan);
+        doNotOptimize(plan->slotValues[0]);
+      },
+      (uint32_t)plan->decoders.size());
+}
+
+}  // namespace HostBench
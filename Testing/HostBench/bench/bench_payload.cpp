@@ -0,0 +1,158 @@
+/**
+ * MQTT payload builder benchmarks (10 devices x 50 registers)
+ * - default layout: drainLatest() + MqttPayloadBuilder::addLatestRegister
+ *   (devices.{device_id}.{name}), the successor of validateAndGroupRegisters
+ * - compact layout: MqttPayloadBuilder::buildCompactValues
+ * - encoding of the default document: json / msgpack / cbor (PayloadFormat)
+ * - build + JSON encode with double vs fixed-decimal values (NumberFormat)
+ * Every build operation stores a new value for all registers first (one
+ * poll cycle), then builds the payload in a cycle arena like the publish task.
+ */
+
+#include "BenchFixtures.h"
+#include "HostBench.h"
+#include "MqttPayloadBuilder.h"
+#include "NumberFormat.h"
+#include "PayloadFormat.h"
+
+namespace HostBench {
+
+namespace {
+
+const uint16_t DEVICES = 10;
+const uint16_t REGISTERS = 50;
+const uint32_t REGISTER_TOTAL = DEVICES * REGISTERS;
+const size_t ARENA_SIZE = 65536;  // MqttConfig::PUBLISH_ARENA_SIZE
+const size_t PAYLOAD_BUFFER_SIZE = 64 * 1024;
+const char* const TIMESTAMP = "14/10/2026 12:00:00";
+
+// Bound only while a payload benchmark runs (setup / teardown)
+std::unique_ptr<BenchFixtures::PlanSet> payloadPlans;
+ArduinoJson::ArenaAllocator arena(ARENA_SIZE);
+double cycle = 0;
+
+// Compact layout schema, as MqttManager::publishSchema() builds it
+std::vector<PollPlanRegistry::LayoutEntry> layout(PollPlanRegistry::MAX_SLOTS);
+std::vector<uint16_t> registerCounts;
+
+// Encoding input
+std::unique_ptr<JsonDocument> defaultDoc;
+std::vector<uint8_t> buffer;
+
+void bindPlans() {
+  payloadPlans.reset(new BenchFixtures::PlanSet("BP", DEVICES, REGISTERS));
+}
+
+void releasePlans() { payloadPlans.reset(); }
+
+void describeLayout() {
+  bindPlans();
+  JsonDocument schemaDoc;
+  JsonArray devices = schemaDoc["devices"].to<JsonArray>();
+  PollPlanRegistry::getInstance()->describeLayout(devices, layout.data());
+  registerCounts.clear();
+  for (JsonObject device : devices) {
+    registerCounts.push_back(device["registers"].size());
+  }
+}
+
+// Default layout document of the current latest values
+void buildDefault(JsonDocument& doc, bool fixedText = false) {
+  doc["timestamp"] = TIMESTAMP;
+  MqttPayloadBuilder::DeviceGrouping grouping;
+  grouping.devices = doc["devices"].to<JsonObject>();
+  grouping.fixedText = fixedText;
+  PollPlanRegistry::getInstance()->drainLatest(
+      [&](const CompiledDevicePlan& plan, const CompiledRegister& reg,
+          double value, uint32_t timestamp) {
+        MqttPayloadBuilder::addLatestRegister(grouping, plan, reg, value);
+      });
+  doNotOptimize(grouping.registerCount);
+}
+
+void buildEncodeInput() {
+  bindPlans();
+  payloadPlans->storeAllLatest(cycle++);
+  defaultDoc.reset(new JsonDocument());
+  buildDefault(*defaultDoc);
+  buffer.resize(PAYLOAD_BUFFER_SIZE);
+}
+
+void releaseEncodeInput() {
+  defaultDoc.reset();
+  releasePlans();
+}
+
+}  // namespace
+
+void registerPayloadBenchmarks() {
+  add("payload/default_layout_build/10x50",
+      []() {
+        payloadPlans->storeAllLatest(cycle++);
+        {
+          SpiRamJsonDocument doc(&arena);
+          buildDefault(doc);
+        }
+        arena.reset();
+      },
+      REGISTER_TOTAL, bindPlans, releasePlans);
+
+  add("payload/compact_layout_build/10x50",
+      []() {
+        payloadPlans->storeAllLatest(cycle++);
+        {
+          SpiRamJsonDocument doc(&arena);
+          doc["timestamp"] = TIMESTAMP;
+          int registerCount = 0;
+          int deviceCount = 0;
+          bool current = MqttPayloadBuilder::buildCompactValues(
+              doc, 0x12345678, layout.data(), registerCounts, registerCount,
+              deviceCount);
+          doNotOptimize(current);
+        }
+        arena.reset();
+      },
+      REGISTER_TOTAL, describeLayout, releasePlans);
+
+  const PayloadFormat formats[] = {PayloadFormat::JSON, PayloadFormat::MSGPACK,
+                                   PayloadFormat::CBOR};
+  for (PayloadFormat format : formats) {
+    add(std::string("payload/encode/") + payloadFormatName(format) + "/10x50",
+        [format]() {
+          size_t size = serializePayload(*defaultDoc, format, buffer.data(),
+                                         buffer.size());
+          doNotOptimize(size);
+        },
+        REGISTER_TOTAL, buildEncodeInput, releaseEncodeInput);
+  }
+
+  // JSON publish as MqttManager sends it: build + encode. Fixture registers
+  // have 2 decimals; values with a fraction (x.37) like real readings.
+  const bool fixedTexts[] = {false, true};
+  for (bool fixedText : fixedTexts) {
+    add(std::string("payload/build_encode/") +
+            (fixedText ? "json_fixed" : "json") + "/10x50",
+        [fixedText]() {
+          payloadPlans->storeAllLatest(cycle++ + 0.37);
+          {
+            SpiRamJsonDocument doc(&arena);
+            buildDefault(doc, fixedText);
+            size_t size = serializePayload(doc, PayloadFormat::JSON,
+                                           buffer.data(), buffer.size());
+            doNotOptimize(size);
+          }
+          arena.reset();
+        },
+        REGISTER_TOTAL, buildEncodeInput, releaseEncodeInput);
+  }
+
+  add("payload/number_format/fixed2",
+      []() {
+        char text[NumberFormat::MAX_TEXT];
+        size_t length =
+            NumberFormat::formatFixed(cycle++ * 0.01 + 231.45, 2, text);
+        doNotOptimize(length);
+      });
+}
+
+}  // namespace HostBench
@@ -0,0 +1,115 @@
+/**
+ * QueueManager ring benchmarks (binary records, per-consumer cursors)
+ * - enqueueRegister: producer cost (RTU/TCP polling task)
+ * - enqueue + dequeue: one record through the HTTP consumer, expanded to a
+ *   JSON data point via PollPlanRegistry
+ * - peekBatch / commitBatch: HTTP batch read of 50 records
+ * - dequeueStreamRecord: BLE stream consumer (device filter, no JSON)
+ */
+
+#include "BenchFixtures.h"
+#include "HostBench.h"
+#include "QueueManager.h"
+
+namespace HostBench {
+
+namespace {
+
+const uint16_t BATCH_SIZE = 50;
+
+// Bound only while a queue benchmark runs (setup / teardown)
+std::unique_ptr<BenchFixtures::PlanSet> queuePlans;
+CompiledDevicePlan* plan = nullptr;
+uint16_t nextRegister = 0;
+JsonDocument pointDoc;
+
+void bindPlans() {
+  queuePlans.reset(new BenchFixtures::PlanSet("BQ", 1, BATCH_SIZE));
+  plan = queuePlans->plans().front().get();
+  nextRegister = 0;
+}
+
+void releasePlans() {
+  plan = nullptr;
+  queuePlans.reset();
+}
+
+void enqueueOne() {
+  uint16_t slot = nextRegister;
+  nextRegister = (nextRegister + 1) % plan->registers.size();
+  QueueManager::getInstance()->enqueueRegister(
+      plan->registrySlot, plan->registryGeneration, slot, 230.5 + slot,
+      1760400000);
+}
+
+}  // namespace
+
+void registerQueueManagerBenchmarks() {
+  QueueManager* queue = QueueManager::getInstance();
+  if (!queue->init()) {
+    fprintf(stderr, "QueueManager init failed, queue benchmarks skipped\n");
+    return;
+  }
+
+  add("queue_manager/enqueueRegister", enqueueOne, 1, bindPlans, releasePlans);
+
+  add("queue_manager/enqueue_dequeue",
+      [queue]() {
+        enqueueOne();
+        pointDoc.clear();
+        JsonObject dataPoint = pointDoc.to<JsonObject>();
+        bool ok = queue->dequeue(QueueConsumer::HTTP, dataPoint);
+        doNotOptimize(ok);
+      },
+      1,
+      [queue]() {
+        bindPlans();
+        queue->attachConsumer(QueueConsumer::HTTP);
+      },
+      [queue]() {
+        queue->detachConsumer(QueueConsumer::HTTP);
+        releasePlans();
+      });
+
+  add("queue_manager/peekBatch_commitBatch/50",
+      [queue]() {
+        for (uint16_t i = 0; i < BATCH_SIZE; i++) {
+          enqueueOne();
+        }
+        pointDoc.clear();
+        JsonArray dataPoints = pointDoc.to<JsonArray>();
+        QueueBatch batch;
+        int count = queue->peekBatch(QueueConsumer::HTTP, dataPoints,
+                                     BATCH_SIZE, batch);
+        queue->commitBatch(QueueConsumer::HTTP, batch);
+        doNotOptimize(count);
+      },
+      BATCH_SIZE,
+      [queue]() {
+        bindPlans();
+        queue->attachConsumer(QueueConsumer::HTTP);
+      },
+      [queue]() {
+        queue->detachConsumer(QueueConsumer::HTTP);
+        releasePlans();
+      });
+
+  add("queue_manager/enqueue_dequeueStreamRecord",
+      [queue]() {
+        enqueueOne();
+        QueueRecord record;
+        bool ok = queue->dequeueStreamRecord(record);
+        doNotOptimize(ok);
+      },
+      1,
+      [queue]() {
+        bindPlans();
+        queue->beginStream(plan->deviceId);
+      },
+      [queue]() {
+        queue->clearStream();
+        releasePlans();
+      });
+}
+
+}  // namespace HostBench
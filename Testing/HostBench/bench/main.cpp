@@ -0,0 +1,235 @@
+/**
+ * gateway_host_bench - Host micro-benchmarks of the Main/ data path
+ *
+ * Usage: gateway_host_bench [--filter TEXT] [--min-time-ms N] [--repeat N]
+ *                           [--json FILE] [--baseline FILE]
+ *                           [--max-regression PCT] [--quick] [--list]
+ *                           [--verbose]
+ *
+ * Exit codes: 0 = ok, 1 = usage / file error, 2 = a benchmark is slower than
+ * the baseline by more than --max-regression percent.
+ */
+
+#include "JsonDocumentPSRAM.h"  // BUG #31: MUST BE BEFORE ArduinoJson.h
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "DebugConfig.h"
+#include "HostBench.h"
+
+namespace HostBench {
+
+namespace {
+
+std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+struct Options {
+  std::string filter;
+  uint32_t minSampleMs = 200;
+  uint32_t repeat = 5;
+  std::string jsonPath;
+  std::string baselinePath;
+  double maxRegressionPct = 10.0;
+  bool list = false;
+  bool verbose = false;
+};
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Result measure(const Benchmark& benchmark, const Options& options) {
+  // Calibrate: double the iterations until one sample takes minSampleMs
+  const uint64_t minSampleNs = (uint64_t)options.minSampleMs * 1000000ULL;
+  uint64_t iterations = 1;
+  uint64_t elapsed = 0;
+  while (true) {
+    uint64_t start = nowNs();
+    for (uint64_t i = 0; i < iterations; i++) benchmark.run();
+    elapsed = nowNs() - start;
+    if (elapsed >= minSampleNs || iterations >= (1ULL << 40)) break;
+    // Aim slightly above the target from the measured rate
+    uint64_t scaled =
+        elapsed > 0 ? iterations * minSampleNs * 11 / 10 / elapsed : 0;
+    iterations = std::max(iterations * 2, std::min(scaled, iterations * 100));
+  }
+
+  std::vector<double> samples;
+  samples.push_back((double)elapsed / iterations);
+  for (uint32_t r = 1; r < options.repeat; r++) {
+    uint64_t start = nowNs();
+    for (uint64_t i = 0; i < iterations; i++) benchmark.run();
+    samples.push_back((double)(nowNs() - start) / iterations);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  Result result;
+  result.name = benchmark.name;
+  result.nsPerOp = samples[samples.size() / 2];
+  result.itemsPerSec =
+      result.nsPerOp > 0 ? benchmark.itemsPerOp * 1e9 / result.nsPerOp : 0;
+  result.iterations = iterations;
+  return result;
+}
+
+bool writeJson(const std::string& path, const std::vector<Result>& results) {
+  JsonDocument doc;
+  doc["format"] = 1;
+  JsonArray benchmarks = doc["benchmarks"].to<JsonArray>();
+  for (const Result& result : results) {
+    JsonObject entry = benchmarks.add<JsonObject>();
+    entry["name"] = result.name.c_str();
+    entry["ns_per_op"] = result.nsPerOp;
+    entry["items_per_sec"] = result.itemsPerSec;
+    entry["iterations"] = result.iterations;
+  }
+  std::string text;
+  serializeJsonPretty(doc, text);
+  std::ofstream out(path);
+  out << text << "\n";
+  return (bool)out;
+}
+
+// @return Number of regressions, -1 if the baseline cannot be read
+int compareBaseline(const std::string& path, const std::vector<Result>& results,
+                    double maxRegressionPct) {
+  std::ifstream in(path);
+  if (!in) return -1;
+  std::stringstream text;
+  text << in.rdbuf();
+  JsonDocument baseline;
+  if (deserializeJson(baseline, text.str()) != DeserializationError::Ok) {
+    return -1;
+  }
+
+  printf("\n%-58s %12s %12s %8s\n", "vs baseline", "base ns/op", "ns/op",
+         "delta");
+  int regressions = 0;
+  for (const Result& result : results) {
+    for (JsonObjectConst entry : baseline["benchmarks"].as<JsonArrayConst>()) {
+      if (result.name != (entry["name"] | "")) continue;
+      double base = entry["ns_per_op"] | 0.0;
+      if (base <= 0) break;
+      double delta = (result.nsPerOp - base) * 100.0 / base;
+      bool regressed = delta > maxRegressionPct;
+      regressions += regressed ? 1 : 0;
+      printf("%-58s %12.1f %12.1f %+7.1f%%%s\n", result.name.c_str(), base,
+             result.nsPerOp, delta, regressed ? "  REGRESSION" : "");
+      break;
+    }
+  }
+  return regressions;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--filter" && hasValue) {
+      options.filter = argv[++i];
+    } else if (arg == "--min-time-ms" && hasValue) {
+      options.minSampleMs = (uint32_t)atoi(argv[++i]);
+    } else if (arg == "--repeat" && hasValue) {
+      options.repeat = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--json" && hasValue) {
+      options.jsonPath = argv[++i];
+    } else if (arg == "--baseline" && hasValue) {
+      options.baselinePath = argv[++i];
+    } else if (arg == "--max-regression" && hasValue) {
+      options.maxRegressionPct = atof(argv[++i]);
+    } else if (arg == "--quick") {
+      options.minSampleMs = 10;
+      options.repeat = 1;
+    } else if (arg == "--list") {
+      options.list = true;
+    } else if (arg == "--verbose") {
+      options.verbose = true;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--filter TEXT] [--min-time-ms N] [--repeat N] "
+              "[--json FILE] [--baseline FILE] [--max-regression PCT] "
+              "[--quick] [--list] [--verbose]\n",
+              argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void add(const std::string& name, Operation run, uint32_t itemsPerOp,
+         Operation setup, Operation teardown) {
+  registry().push_back({name, run, itemsPerOp, setup, teardown});
+}
+
+const std::vector<Benchmark>& all() { return registry(); }
+
+}  // namespace HostBench
+
+int main(int argc, char** argv) {
+  using namespace HostBench;
+
+  Options options;
+  if (!parseOptions(argc, argv, options)) return 1;
+  if (options.verbose) {
+    hostSerialEcho(true);
+    setLogLevel(LOG_INFO);
+  }
+  randomSeed(1);
+
+  registerModbusUtilsBenchmarks();
+  registerQueueManagerBenchmarks();
+  registerPayloadBenchmarks();
+  registerConfigManagerBenchmarks();
+
+  if (options.list) {
+    for (const Benchmark& benchmark : all()) printf("%s\n", benchmark.name.c_str());
+    return 0;
+  }
+
+  printf("%-58s %12s %14s %12s\n", "benchmark", "ns/op", "items/s", "iterations");
+  std::vector<Result> results;
+  for (const Benchmark& benchmark : all()) {
+    if (!options.filter.empty() &&
+        benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    if (benchmark.setup) benchmark.setup();
+    Result result = measure(benchmark, options);
+    if (benchmark.teardown) benchmark.teardown();
+
+    printf("%-58s %12.1f %14.0f %12llu\n", result.name.c_str(), result.nsPerOp,
+           result.itemsPerSec, (unsigned long long)result.iterations);
+    fflush(stdout);
+    results.push_back(result);
+  }
+
+  if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results)) {
+    fprintf(stderr, "Cannot write %s\n", options.jsonPath.c_str());
+    return 1;
+  }
+  if (!options.baselinePath.empty()) {
+    int regressions =
+        compareBaseline(options.baselinePath, results, options.maxRegressionPct);
+    if (regressions < 0) {
+      fprintf(stderr, "Cannot read baseline %s\n", options.baselinePath.c_str());
+      return 1;
+    }
+    if (regressions > 0) {
+      printf("%d benchmark(s) regressed by more than %.1f%%\n", regressions,
+             options.maxRegressionPct);
+      return 2;
+    }
+  }
+  return 0;
+}
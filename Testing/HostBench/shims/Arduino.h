@@ -0,0 +1,290 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * Host shim of the Arduino-ESP32 core (Testing/HostBench only)
+ *
+ * Just enough of Arduino.h for the Main/ sources linked into the host
+ * micro-benchmarks: String (std::string backed), Print / Stream, millis(),
+ * Serial (silent unless hostSerialEcho(true)) and ESP heap queries.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define F(text) (text)
+#define PSTR(text) (text)
+
+// ============================================================================
+// TIME / RANDOM
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+class String {
+ public:
+  String() {}
+  String(const char* text) : value(text ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  String(char c) : value(1, c) {}
+  String(int number, unsigned char base = DEC);
+  String(unsigned int number, unsigned char base = DEC);
+  String(long number, unsigned char base = DEC);
+  String(unsigned long number, unsigned char base = DEC);
+  String(long long number, unsigned char base = DEC);
+  String(unsigned long long number, unsigned char base = DEC);
+  String(float number, unsigned int decimals = 2);
+  String(double number, unsigned int decimals = 2);
+
+  const char* c_str() const { return value.c_str(); }
+  const char* begin() const { return value.data(); }
+  const char* end() const { return value.data() + value.size(); }
+  unsigned int length() const { return (unsigned int)value.size(); }
+  bool isEmpty() const { return value.empty(); }
+  bool reserve(unsigned int size) {
+    value.reserve(size);
+    return true;
+  }
+
+  bool concat(const String& text) {
+    value += text.value;
+    return true;
+  }
+  bool concat(const char* text) {
+    if (text) value += text;
+    return text != nullptr;
+  }
+  bool concat(const char* text, unsigned int length) {
+    if (text) value.append(text, length);
+    return text != nullptr;
+  }
+  bool concat(char c) {
+    value += c;
+    return true;
+  }
+  template <typename T>
+  bool concat(T number) {
+    return concat(String(number));
+  }
+
+  template <typename T>
+  String& operator+=(const T& rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  char operator[](unsigned int index) const {
+    return index < value.size() ? value[index] : '\0';
+  }
+  char& operator[](unsigned int index) { return value[index]; }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+
+  bool equals(const String& other) const { return value == other.value; }
+  bool equals(const char* other) const { return value == (other ? other : ""); }
+  bool equalsIgnoreCase(const String& other) const {
+    return strcasecmp(c_str(), other.c_str()) == 0;
+  }
+  int compareTo(const String& other) const { return value.compare(other.value); }
+  bool startsWith(const String& prefix) const {
+    return value.compare(0, prefix.value.size(), prefix.value) == 0;
+  }
+  bool endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(),
+                         suffix.value.size(), suffix.value) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String& text, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  String substring(unsigned int from) const;
+  String substring(unsigned int from, unsigned int to) const;
+
+  void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+  void remove(unsigned int index, unsigned int count);
+  void replace(const String& find, const String& with);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const { return strtol(c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(c_str(), nullptr); }
+  double toDouble() const { return strtod(c_str(), nullptr); }
+
+  void toCharArray(char* buffer, unsigned int size,
+                   unsigned int index = 0) const;
+
+  friend bool operator==(const String& a, const String& b) {
+    return a.value == b.value;
+  }
+  friend bool operator==(const String& a, const char* b) {
+    return a.equals(b);
+  }
+  friend bool operator==(const char* a, const String& b) {
+    return b.equals(a);
+  }
+  friend bool operator!=(const String& a, const String& b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const String& a, const char* b) { return !(a == b); }
+  friend bool operator!=(const char* a, const String& b) { return !(b == a); }
+  friend bool operator<(const String& a, const String& b) {
+    return a.value < b.value;
+  }
+
+  template <typename T>
+  friend String operator+(const String& lhs, const T& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+  }
+  friend String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+  }
+
+ private:
+  std::string value;
+};
+
+// ============================================================================
+// PRINT / STREAM
+// ============================================================================
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) {
+    return text ? write((const uint8_t*)text, strlen(text)) : 0;
+  }
+  size_t write(const char* buffer, size_t size) {
+    return write((const uint8_t*)buffer, size);
+  }
+  virtual void flush() {}
+
+  size_t printf(const char* format, ...)
+      __attribute__((format(printf, 2, 3)));
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int number, int base = DEC) { return print(String(number, base)); }
+  size_t print(unsigned int number, int base = DEC) {
+    return print(String(number, base));
+  }
+  size_t print(long number, int base = DEC) { return print(String(number, base)); }
+  size_t print(unsigned long number, int base = DEC) {
+    return print(String(number, base));
+  }
+  size_t print(double number, int decimals = 2) {
+    return print(String(number, decimals));
+  }
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& value) {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T& value, int format) {
+    size_t n = print(value, format);
+    return n + println();
+  }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) {
+    return readBytes((char*)buffer, length);
+  }
+  String readString();
+  void setTimeout(unsigned long timeout) { timeoutMs = timeout; }
+
+ protected:
+  unsigned long timeoutMs = 1000;
+};
+
+// Serial: stdout sink, silent by default so benchmark output stays readable
+class HostSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  void end() {}
+  explicit operator bool() const { return true; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override;
+};
+extern HostSerial Serial;
+
+// Enable / disable Serial output on stdout (host only)
+void hostSerialEcho(bool enabled);
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap() { return 256 * 1024; }
+  uint32_t getHeapSize() { return 320 * 1024; }
+  uint32_t getMinFreeHeap() { return 200 * 1024; }
+  uint32_t getMaxAllocHeap() { return 110 * 1024; }
+  uint32_t getFreePsram() { return 7 * 1024 * 1024; }
+  uint32_t getPsramSize() { return 8 * 1024 * 1024; }
+  uint32_t getMinFreePsram() { return 7 * 1024 * 1024; }
+  uint32_t getMaxAllocPsram() { return 4 * 1024 * 1024; }
+  void restart();
+};
+extern EspClass ESP;
+
+#endif  // HOST_ARDUINO_H
@@ -0,0 +1,86 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+/**
+ * Host shim of the Arduino-ESP32 FS API (Testing/HostBench only)
+ * Paths are mapped below a host directory (LittleFS.setHostRoot()).
+ */
+
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FileImpl;
+
+class File : public Stream {
+ public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t* buffer, size_t size);
+  size_t readBytes(char* buffer, size_t length) override {
+    return read((uint8_t*)buffer, length);
+  }
+  void flush() override;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  explicit operator bool() const;
+  const char* path() const;
+  const char* name() const;  // Last path component (like Arduino-ESP32 2.x)
+  bool isDirectory() const;
+  File openNextFile(const char* mode = "r");
+  void rewindDirectory();
+
+ private:
+  std::shared_ptr<FileImpl> impl;
+};
+
+class FS {
+ public:
+  File open(const char* path, const char* mode = "r", bool create = false);
+  File open(const String& path, const char* mode = "r", bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) {
+    return rename(from.c_str(), to.c_str());
+  }
+  bool mkdir(const char* path);
+  bool mkdir(const String& path) { return mkdir(path.c_str()); }
+  bool rmdir(const char* path);
+  bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+  // Host only: directory that holds "/" (created if missing)
+  void setHostRoot(const char* directory);
+  std::string hostPath(const char* path) const;
+
+ protected:
+  std::string root = "./littlefs";
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekSet;
+
+#endif  // HOST_FS_H
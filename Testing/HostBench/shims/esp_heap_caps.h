@@ -0,0 +1,44 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+// Host shim: every capability maps to the C heap (Testing/HostBench only)
+
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_EXEC (1 << 0)
+#define MALLOC_CAP_32BIT (1 << 1)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+inline void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void* heap_caps_calloc(size_t n, size_t size, uint32_t) {
+  return calloc(n, size);
+}
+inline void* heap_caps_realloc(void* ptr, size_t size, uint32_t) {
+  return realloc(ptr, size);
+}
+inline void heap_caps_free(void* ptr) { free(ptr); }
+inline size_t heap_caps_get_allocated_size(void* ptr) {
+  return malloc_usable_size(ptr);
+}
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? 7 * 1024 * 1024 : 256 * 1024;
+}
+inline size_t heap_caps_get_total_size(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? 8 * 1024 * 1024 : 320 * 1024;
+}
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? 4 * 1024 * 1024 : 110 * 1024;
+}
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+#endif  // HOST_ESP_HEAP_CAPS_H
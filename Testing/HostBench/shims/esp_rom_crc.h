@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_ROM_CRC_H
+#define HOST_ESP_ROM_CRC_H
+
+// Host shim of the ROM CRC32 (same result as esp_rom_crc32_le on the chip)
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif  // HOST_ESP_ROM_CRC_H
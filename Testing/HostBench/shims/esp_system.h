@@ -0,0 +1,16 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef void (*shutdown_handler_t)(void);
+
+// Host: handlers run at exit()
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler);
+void esp_restart();
+
+#endif  // HOST_ESP_SYSTEM_H
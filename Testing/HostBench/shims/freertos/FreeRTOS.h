@@ -0,0 +1,41 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/**
+ * Host shim of the FreeRTOS types used by Main/ (Testing/HostBench only)
+ * 1 tick = 1 ms, tasks are std::threads, semaphores are mutex + condition
+ * variable (see host_freertos.cpp).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS ((TickType_t)1)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+struct HostCriticalSection;
+typedef struct {
+  HostCriticalSection* lock;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED \
+  { nullptr }
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vPortExitCritical(mux)
+
+BaseType_t xPortGetCoreID();
+
+#endif  // HOST_FREERTOS_H
@@ -0,0 +1,51 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Types only (TaskProfiler.h); the host has no uxTaskGetSystemState()
+typedef enum {
+  eRunning = 0,
+  eReady,
+  eBlocked,
+  eSuspended,
+  eDeleted,
+  eInvalid
+} eTaskState;
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char* pcTaskName;
+  UBaseType_t xTaskNumber;
+  eTaskState eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter;
+  void* pxStackBase;
+  uint32_t usStackHighWaterMark;
+  BaseType_t xCoreID;
+} TaskStatus_t;
+
+// Runs function on a detached std::thread (priority / core ignored)
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name,
+                                   uint32_t stackSize, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char* name,
+                              uint32_t stackSize, void* parameter,
+                              UBaseType_t priority, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(function, name, stackSize, parameter,
+                                 priority, handle, tskNO_AFFINITY);
+}
+void vTaskDelete(TaskHandle_t task);  // nullptr = calling task (exits it)
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+#define taskYIELD() vTaskDelay(0)
+
+#endif  // HOST_FREERTOS_TASK_H
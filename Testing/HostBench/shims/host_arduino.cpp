@@ -0,0 +1,261 @@
+/**
+ * Host shim: Arduino core, ESP timer / ROM CRC / system (Testing/HostBench)
+ */
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+HostSerial Serial;
+EspClass ESP;
+
+namespace {
+
+const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();
+bool serialEcho = false;
+std::mt19937 randomEngine(12345);
+
+String formatNumber(unsigned long long number, unsigned char base,
+                    bool negative) {
+  if (base < 2 || base > 36) base = DEC;
+  char buffer[66];
+  char* p = buffer + sizeof(buffer) - 1;
+  *p = '\0';
+  do {
+    unsigned digit = (unsigned)(number % base);
+    *--p = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    number /= base;
+  } while (number > 0);
+  if (negative) *--p = '-';
+  return String(p);
+}
+
+String formatSigned(long long number, unsigned char base) {
+  if (base == DEC && number < 0) {
+    return formatNumber((unsigned long long)(-(number + 1)) + 1, base, true);
+  }
+  // Arduino prints negative non-decimal values as unsigned 32-bit
+  return formatNumber(number < 0 ? (unsigned long long)(uint32_t)number
+                                 : (unsigned long long)number,
+                      base, false);
+}
+
+}  // namespace
+
+// ============================================================================
+// TIME / RANDOM
+// ============================================================================
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() { return (unsigned long)(uint32_t)esp_timer_get_time(); }
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() { std::this_thread::yield(); }
+
+long random(long howBig) { return howBig <= 0 ? 0 : random(0, howBig); }
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  std::uniform_int_distribution<long> distribution(howSmall, howBig - 1);
+  return distribution(randomEngine);
+}
+
+void randomSeed(unsigned long seed) { randomEngine.seed(seed); }
+
+int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - startTime)
+      .count();
+}
+
+// ============================================================================
+// ROM CRC32 / SYSTEM
+// ============================================================================
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) {
+  return atexit(handler) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+void esp_restart() {
+  fprintf(stderr, "[HOST] esp_restart() called\n");
+  exit(1);
+}
+
+void EspClass::restart() { esp_restart(); }
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+String::String(int number, unsigned char base)
+    : String(formatSigned(number, base)) {}
+String::String(unsigned int number, unsigned char base)
+    : String(formatNumber(number, base, false)) {}
+String::String(long number, unsigned char base)
+    : String(formatSigned(number, base)) {}
+String::String(unsigned long number, unsigned char base)
+    : String(formatNumber(number, base, false)) {}
+String::String(long long number, unsigned char base)
+    : String(formatSigned(number, base)) {}
+String::String(unsigned long long number, unsigned char base)
+    : String(formatNumber(number, base, false)) {}
+String::String(float number, unsigned int decimals)
+    : String((double)number, decimals) {}
+
+String::String(double number, unsigned int decimals) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, number);
+  value = buffer;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t pos = value.find(c, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& text, unsigned int from) const {
+  size_t pos = value.find(text.value, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t pos = value.rfind(c);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+  return from >= value.size() ? String() : String(value.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= value.size()) return String();
+  return String(value.substr(from, to - from));
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < value.size()) value.erase(index, count);
+}
+
+void String::replace(const String& find, const String& with) {
+  if (find.value.empty()) return;
+  size_t pos = 0;
+  while ((pos = value.find(find.value, pos)) != std::string::npos) {
+    value.replace(pos, find.value.size(), with.value);
+    pos += with.value.size();
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : value) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : value) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+  size_t first = value.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos) {
+    value.clear();
+    return;
+  }
+  size_t last = value.find_last_not_of(" \t\r\n");
+  value = value.substr(first, last - first + 1);
+}
+
+void String::toCharArray(char* buffer, unsigned int size,
+                         unsigned int index) const {
+  if (!buffer || size == 0) return;
+  size_t n = index < value.size() ? value.size() - index : 0;
+  if (n > size - 1) n = size - 1;
+  if (n > 0) memcpy(buffer, value.data() + index, n);
+  buffer[n] = '\0';
+}
+
+// ============================================================================
+// PRINT / STREAM / SERIAL
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (n < size && write(buffer[n])) n++;
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char stackBuffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+  va_end(args);
+  if (length < 0) return 0;
+  if ((size_t)length < sizeof(stackBuffer)) {
+    return write((const uint8_t*)stackBuffer, length);
+  }
+  std::string heapBuffer(length + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&heapBuffer[0], heapBuffer.size(), format, args);
+  va_end(args);
+  return write((const uint8_t*)heapBuffer.data(), length);
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t n = 0;
+  while (n < length) {
+    int c = read();
+    if (c < 0) break;
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+String Stream::readString() {
+  String result;
+  int c;
+  while ((c = read()) >= 0) result.concat((char)c);
+  return result;
+}
+
+size_t HostSerial::write(uint8_t c) {
+  if (serialEcho) fputc(c, stdout);
+  return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size) {
+  if (serialEcho) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+void HostSerial::flush() {
+  if (serialEcho) fflush(stdout);
+}
+
+void hostSerialEcho(bool enabled) { serialEcho = enabled; }
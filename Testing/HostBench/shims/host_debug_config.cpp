@@ -0,0 +1,57 @@
+/**
+ * Host shim: DebugConfig.cpp globals and the TaskProfiler lock hook
+ * (Testing/HostBench)
+ *
+ * Main/DebugConfig.cpp needs RTCManager (I2C, NTP), so its log level state
+ * and timestamp helpers (plus g_productionMode of Main.ino) are defined here
+ * instead; timestamps are uptime.
+ * Main/TaskProfiler.cpp is not linked: lock waits are not recorded.
+ */
+
+#include "DebugConfig.h"
+#include "TaskProfiler.h"
+
+uint8_t g_productionMode = PRODUCTION_MODE;
+LogLevel currentLogLevel = LOG_ERROR;  // Benchmarks: errors only
+bool logTimestampsEnabled = false;
+
+void setLogLevel(LogLevel level) { currentLogLevel = level; }
+
+LogLevel getLogLevel() { return currentLogLevel; }
+
+const char* getLogLevelName(LogLevel level) {
+  switch (level) {
+    case LOG_NONE:
+      return "NONE";
+    case LOG_ERROR:
+      return "ERROR";
+    case LOG_WARN:
+      return "WARN";
+    case LOG_INFO:
+      return "INFO";
+    case LOG_DEBUG:
+      return "DEBUG";
+    case LOG_VERBOSE:
+      return "VERBOSE";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void printLogLevelStatus() {
+  Serial.printf("[LOG] Level: %s\n", getLogLevelName(currentLogLevel));
+}
+
+const char* getLogTimestamp() {
+  static char timestamp[22];
+  formatLogTimestamp(timestamp, sizeof(timestamp), millis());
+  return timestamp;
+}
+
+void formatLogTimestamp(char* out, size_t size, uint32_t capturedMs) {
+  snprintf(out, size, "[%010lu]", (unsigned long)(capturedMs / 1000));
+}
+
+void setLogTimestamps(bool enabled) { logTimestampsEnabled = enabled; }
+
+void TaskProfiler::recordWait(ProfiledLock, uint32_t, bool) {}
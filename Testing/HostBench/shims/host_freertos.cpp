@@ -0,0 +1,212 @@
+/**
+ * Host shim: FreeRTOS tasks, semaphores and critical sections on
+ * std::thread / std::mutex (Testing/HostBench). 1 tick = 1 ms.
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+struct HostCriticalSection {
+  std::recursive_mutex mutex;
+};
+
+struct HostTask {
+  TaskFunction_t function;
+  void* parameter;
+};
+
+struct HostSemaphore {
+  std::mutex mutex;
+  std::condition_variable changed;
+  UBaseType_t count;
+  UBaseType_t maxCount;
+  bool recursive;
+  std::thread::id owner;
+  UBaseType_t depth;
+};
+
+namespace {
+
+std::mutex criticalInitMutex;
+thread_local HostTask* currentTask = nullptr;
+HostTask mainTask{nullptr, nullptr};
+
+// Wait on cv until ready() or timeout ticks (portMAX_DELAY = forever)
+template <typename Ready>
+bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+             TickType_t timeout, Ready ready) {
+  if (timeout == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(timeout), ready);
+}
+
+struct ThreadExit {};  // Thrown by vTaskDelete(nullptr)
+
+}  // namespace
+
+// ============================================================================
+// CRITICAL SECTIONS / CORE
+// ============================================================================
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+  {
+    std::lock_guard<std::mutex> guard(criticalInitMutex);
+    if (!mux->lock) mux->lock = new HostCriticalSection();
+  }
+  mux->lock->mutex.lock();
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) { mux->lock->mutex.unlock(); }
+
+BaseType_t xPortGetCoreID() { return 1; }
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name,
+                                   uint32_t stackSize, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+  HostTask* task = new HostTask{function, parameter};
+  if (handle) *handle = task;
+  std::thread([task]() {
+    currentTask = task;
+    try {
+      task->function(task->parameter);
+    } catch (const ThreadExit&) {
+    }
+  }).detach();
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == currentTask) {
+    if (currentTask != &mainTask && currentTask != nullptr) {
+      throw ThreadExit();
+    }
+  }
+  // Host: other tasks are not stopped (detached threads end with the process)
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+  }
+}
+
+TickType_t xTaskGetTickCount() {
+  static const auto start = std::chrono::steady_clock::now();
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return currentTask ? currentTask : &mainTask;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 4096; }
+
+// ============================================================================
+// SEMAPHORES
+// ============================================================================
+
+static SemaphoreHandle_t createSemaphore(UBaseType_t maxCount,
+                                         UBaseType_t initialCount,
+                                         bool recursive) {
+  HostSemaphore* semaphore = new HostSemaphore();
+  semaphore->count = initialCount;
+  semaphore->maxCount = maxCount;
+  semaphore->recursive = recursive;
+  semaphore->depth = 0;
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return createSemaphore(1, 1, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return createSemaphore(1, 1, true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return createSemaphore(1, 0, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount,
+                                           UBaseType_t initialCount) {
+  return createSemaphore(maxCount, initialCount, false);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout) {
+  if (!semaphore) return pdFALSE;
+  std::unique_lock<std::mutex> lock(semaphore->mutex);
+  if (!waitFor(semaphore->changed, lock, timeout,
+               [semaphore]() { return semaphore->count > 0; })) {
+    return pdFALSE;
+  }
+  semaphore->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  if (!semaphore) return pdFALSE;
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  if (semaphore->count >= semaphore->maxCount) return pdFALSE;
+  semaphore->count++;
+  semaphore->changed.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore,
+                                   TickType_t timeout) {
+  if (!semaphore) return pdFALSE;
+  std::thread::id self = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lock(semaphore->mutex);
+  if (semaphore->depth > 0 && semaphore->owner == self) {
+    semaphore->depth++;
+    return pdTRUE;
+  }
+  if (!waitFor(semaphore->changed, lock, timeout,
+               [semaphore]() { return semaphore->count > 0; })) {
+    return pdFALSE;
+  }
+  semaphore->count--;
+  semaphore->owner = self;
+  semaphore->depth = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+  if (!semaphore) return pdFALSE;
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  if (semaphore->depth == 0 || semaphore->owner != std::this_thread::get_id()) {
+    return pdFALSE;
+  }
+  if (--semaphore->depth == 0) {
+    semaphore->owner = std::thread::id();
+    semaphore->count++;
+    semaphore->changed.notify_one();
+  }
+  return pdTRUE;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  return semaphore->count;
+}
@@ -0,0 +1,222 @@
+/**
+ * Host shim: LittleFS on a host directory (Testing/HostBench)
+ */
+
+#include <LittleFS.h>
+#include <dirent.h>
+#include <errno.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+fs::LittleFSFS LittleFS;
+
+namespace fs {
+
+class FileImpl {
+ public:
+  std::string path;  // Gateway path ("/devcfg/x.json")
+  std::string name;  // Last component
+  FILE* handle = nullptr;
+  bool directory = false;
+  std::vector<std::string> entries;  // Directory listing
+  size_t nextEntry = 0;
+  FS* owner = nullptr;
+
+  ~FileImpl() {
+    if (handle) fclose(handle);
+  }
+};
+
+namespace {
+
+bool makeParents(const std::string& hostPath) {
+  for (size_t pos = hostPath.find('/', 1); pos != std::string::npos;
+       pos = hostPath.find('/', pos + 1)) {
+    std::string parent = hostPath.substr(0, pos);
+    if (::mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string lastComponent(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace
+
+// ============================================================================
+// FILE
+// ============================================================================
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!impl || !impl->handle) return 0;
+  return fwrite(buffer, 1, size, impl->handle);
+}
+
+int File::available() {
+  if (!impl || !impl->handle) return 0;
+  return (int)(size() - position());
+}
+
+int File::read() {
+  if (!impl || !impl->handle) return -1;
+  return fgetc(impl->handle);
+}
+
+int File::peek() {
+  if (!impl || !impl->handle) return -1;
+  int c = fgetc(impl->handle);
+  if (c >= 0) ungetc(c, impl->handle);
+  return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  if (!impl || !impl->handle) return 0;
+  return fread(buffer, 1, size, impl->handle);
+}
+
+void File::flush() {
+  if (impl && impl->handle) fflush(impl->handle);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl || !impl->handle) return false;
+  int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+  return fseek(impl->handle, pos, whence) == 0;
+}
+
+size_t File::position() const {
+  if (!impl || !impl->handle) return 0;
+  long pos = ftell(impl->handle);
+  return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+  if (!impl || !impl->handle) return 0;
+  struct stat info;
+  fflush(impl->handle);
+  return fstat(fileno(impl->handle), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+void File::close() { impl.reset(); }
+
+File::operator bool() const { return impl != nullptr; }
+
+const char* File::path() const { return impl ? impl->path.c_str() : ""; }
+
+const char* File::name() const { return impl ? impl->name.c_str() : ""; }
+
+bool File::isDirectory() const { return impl && impl->directory; }
+
+File File::openNextFile(const char* mode) {
+  if (!impl || !impl->directory || impl->nextEntry >= impl->entries.size()) {
+    return File();
+  }
+  std::string child = impl->path;
+  if (child.empty() || child.back() != '/') child += '/';
+  child += impl->entries[impl->nextEntry++];
+  return impl->owner->open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+  if (impl) impl->nextEntry = 0;
+}
+
+// ============================================================================
+// FS
+// ============================================================================
+
+void FS::setHostRoot(const char* directory) {
+  root = directory;
+  while (root.size() > 1 && root.back() == '/') root.pop_back();
+  makeParents(root + "/");
+}
+
+std::string FS::hostPath(const char* path) const {
+  std::string result = root;
+  if (!path || path[0] != '/') result += '/';
+  if (path) result += path;
+  return result;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+  std::string host = hostPath(path);
+  std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+  impl->path = path;
+  impl->name = lastComponent(impl->path);
+  impl->owner = this;
+
+  struct stat info;
+  if (stat(host.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+    DIR* dir = opendir(host.c_str());
+    if (!dir) return File();
+    while (struct dirent* entry = readdir(dir)) {
+      if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+        impl->entries.push_back(entry->d_name);
+      }
+    }
+    closedir(dir);
+    impl->directory = true;
+    return File(impl);
+  }
+
+  bool writing = mode && (mode[0] == 'w' || mode[0] == 'a');
+  if (writing && !makeParents(host)) return File();
+  std::string hostMode = mode ? mode : "r";
+  if (hostMode.find('b') == std::string::npos) hostMode += 'b';
+  impl->handle = fopen(host.c_str(), hostMode.c_str());
+  if (!impl->handle) return File();
+  return File(impl);
+}
+
+bool FS::exists(const char* path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+  return ::unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+  std::string host = hostPath(path);
+  return makeParents(host) &&
+         (::mkdir(host.c_str(), 0755) == 0 || errno == EEXIST);
+}
+
+bool FS::rmdir(const char* path) {
+  return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+// ============================================================================
+// LITTLEFS
+// ============================================================================
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+  return makeParents(root + "/");
+}
+
+bool LittleFSFS::format() {
+  // Remove everything below the root (depth first), keep the root itself
+  auto removeEntry = [](const char* path, const struct stat*, int,
+                        struct FTW* ftw) -> int {
+    return ftw->level == 0 ? 0 : ::remove(path);
+  };
+  return nftw(root.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS) == 0;
+}
+
+size_t LittleFSFS::usedBytes() { return 0; }
+
+}  // namespace fs
@@ -0,0 +1,157 @@
+/**
+ * Host tests - MbapFrameAssembler (ModbusTcpServer request framing)
+ *
+ * Each segment is what one client->available() / read() pass sees. The
+ * read loop below is the one in ModbusTcpServer::serviceClient(): read at
+ * most wanted() bytes, commit(), answer a COMPLETE frame and go on with the
+ * rest of the segment.
+ *
+ * Version: 1.0.0
+ * Created: October 14, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "MbapFrame.h"
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+int failures = 0;
+
+#define CHECK(condition)                                            \
+  do {                                                              \
+    if (!(condition)) {                                             \
+      printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                   \
+    }                                                               \
+  } while (0)
+
+// FC3 read: transaction id, unit 1, address, quantity (12 bytes)
+Bytes readRequest(uint16_t transaction, uint16_t address, uint16_t quantity) {
+  return {(uint8_t)(transaction >> 8), (uint8_t)transaction, 0, 0, 0, 6, 1, 3,
+          (uint8_t)(address >> 8),     (uint8_t)address,
+          (uint8_t)(quantity >> 8),    (uint8_t)quantity};
+}
+
+struct FeedResult {
+  std::vector<Bytes> frames;  // Completed requests, in order
+  bool invalid = false;
+};
+
+FeedResult feed(const std::vector<Bytes>& segments) {
+  MbapFrameAssembler request;
+  memset(&request, 0, sizeof(request));  // calloc'd client slot
+  FeedResult result;
+
+  for (const Bytes& segment : segments) {
+    size_t offset = 0;
+    size_t available = segment.size();
+    while (available > 0) {
+      size_t wanted = request.wanted();
+      if (available < wanted) {
+        wanted = available;
+      }
+      memcpy(request.writePointer(), segment.data() + offset, wanted);
+      offset += wanted;
+      available -= wanted;
+
+      MbapFrameAssembler::Result state = request.commit((uint16_t)wanted);
+      if (state == MbapFrameAssembler::Result::INVALID) {
+        result.invalid = true;
+        return result;
+      }
+      if (state == MbapFrameAssembler::Result::COMPLETE) {
+        result.frames.emplace_back(request.frame,
+                                   request.frame + request.received);
+        request.reset();
+      }
+    }
+  }
+  return result;
+}
+
+Bytes concat(const Bytes& a, const Bytes& b) {
+  Bytes out(a);
+  out.insert(out.end(), b.begin(), b.end());
+  return out;
+}
+
+void testSingleSegment() {
+  Bytes request = readRequest(1, 100, 10);
+  FeedResult result = feed({request});
+  CHECK(!result.invalid);
+  CHECK(result.frames.size() == 1);
+  CHECK(result.frames.size() == 1 && result.frames[0] == request);
+}
+
+void testSplitAcrossReads() {
+  Bytes request = readRequest(2, 200, 4);
+  // Every split point, including inside the header and after it
+  for (size_t split = 1; split < request.size(); split++) {
+    Bytes first(request.begin(), request.begin() + split);
+    Bytes second(request.begin() + split, request.end());
+    FeedResult result = feed({first, second});
+    CHECK(!result.invalid);
+    CHECK(result.frames.size() == 1 && result.frames[0] == request);
+  }
+
+  // One byte per read
+  std::vector<Bytes> bytes;
+  for (uint8_t b : request) {
+    bytes.push_back({b});
+  }
+  FeedResult result = feed(bytes);
+  CHECK(result.frames.size() == 1 && result.frames[0] == request);
+}
+
+void testPipelinedInOneRead() {
+  Bytes first = readRequest(3, 0, 1);
+  Bytes second = readRequest(4, 10, 2);
+  FeedResult result = feed({concat(first, second)});
+  CHECK(!result.invalid);
+  CHECK(result.frames.size() == 2);
+  CHECK(result.frames.size() == 2 && result.frames[0] == first &&
+        result.frames[1] == second);
+
+  // Second request split across the next read
+  Bytes both = concat(first, second);
+  Bytes head(both.begin(), both.begin() + 15);
+  Bytes tail(both.begin() + 15, both.end());
+  result = feed({head, tail});
+  CHECK(result.frames.size() == 2 && result.frames[1] == second);
+}
+
+void testInvalidHeader() {
+  Bytes request = readRequest(5, 0, 1);
+  request[2] = 1;  // Protocol ID != 0
+  CHECK(feed({request}).invalid);
+
+  request = readRequest(5, 0, 1);
+  request[5] = 1;  // Length below unit ID + function code
+  CHECK(feed({request}).invalid);
+
+  request = readRequest(5, 0, 1);
+  request[4] = 0x01;  // Length 262: beyond MAX_ADU_SIZE
+  CHECK(feed({request}).invalid);
+}
+
+}  // namespace
+
+int main() {
+  testSingleSegment();
+  testSplitAcrossReads();
+  testPipelinedInOneRead();
+  testInvalidHeader();
+
+  if (failures > 0) {
+    printf("mbap_frame: %d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("mbap_frame: all checks passed\n");
+  return 0;
+}
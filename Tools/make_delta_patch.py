@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""
+OTA Delta Patch Tool for SRT-MGATE-1210
+Builds a delta patch that rebuilds a new firmware image from the previous one
+
+The gateway applies the patch against its RUNNING partition while streaming
+it from GitHub (OTADeltaPatch.cpp), so only the changed bytes cross the
+network. The rebuilt image is verified with the full image SHA-256 and
+signature from the manifest; any mismatch makes the gateway download the full
+image instead.
+
+================================================================================
+PATCH FORMAT ("OTD1")
+================================================================================
+
+Integers are unsigned LEB128.
+  header:  "OTD1", target size, source size
+  COPY   (0x01): source offset, length         - source bytes as is
+  ADD    (0x02): source offset, length, runs   - source bytes + diff, runs =
+                 (zero count, literal count, literal bytes) until length is
+                 covered (diff bytes added mod 256)
+  INSERT (0x03): length, bytes                 - new bytes
+  END    (0x00)
+
+================================================================================
+
+Usage:
+    python make_delta_patch.py <base.bin> <base_version> <new.bin> [manifest.json]
+
+Example:
+    python make_delta_patch.py MGATE-1210_P_v1.3.2.bin 1.3.2 MGATE-1210_P_v1.3.3.bin firmware_manifest.json
+
+Output:
+    - {new}_from_v{base_version}.otd (patch, next to new.bin)
+    - manifest.json firmware.delta entry added/replaced (if given; run
+      sign_firmware.py for the new image first)
+
+Copyright (c) 2026 Suriota IoT Solutions
+"""
+
+import hashlib
+import json
+import os
+import sys
+
+MAGIC = b"OTD1"
+OP_END, OP_COPY, OP_ADD, OP_INSERT = 0x00, 0x01, 0x02, 0x03
+
+GRAM = 16  # Bytes hashed per index entry
+INDEX_STEP = 4  # Source positions indexed (every 4th)
+MAX_CANDIDATES = 8  # Source positions kept per gram
+MIN_COPY = 32  # Shorter matches stay in the gap (ADD/INSERT)
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def match_forward(a, ai, b, bi, limit):
+    """Length of the common run of a[ai:] and b[bi:] (at most limit)"""
+    length = 0
+    while length < limit:
+        step = min(256, limit - length)
+        if a[ai + length : ai + length + step] == b[bi + length : bi + length + step]:
+            length += step
+            continue
+        while length < limit and a[ai + length] == b[bi + length]:
+            length += 1
+        break
+    return length
+
+
+def encode_add(source, src_offset, target, start, end):
+    """ADD op for target[start:end] against source[src_offset:]"""
+    length = end - start
+    body = bytearray()
+    i = 0
+    while i < length:
+        zeros = 0
+        while i + zeros < length and target[start + i + zeros] == source[src_offset + i + zeros]:
+            zeros += 1
+        i += zeros
+        literals = bytearray()
+        # A literal run absorbs zero gaps shorter than a new run header
+        while i < length:
+            d = (target[start + i] - source[src_offset + i]) & 0xFF
+            if d == 0:
+                ahead = 0
+                while (
+                    i + ahead < length
+                    and ahead < 3
+                    and target[start + i + ahead] == source[src_offset + i + ahead]
+                ):
+                    ahead += 1
+                if ahead >= 3 or i + ahead >= length:
+                    break
+            literals.append(d)
+            i += 1
+        body += varint(zeros) + varint(len(literals)) + literals
+    return bytes([OP_ADD]) + varint(src_offset) + varint(length) + bytes(body)
+
+
+def encode_gap(source, src_hint, target, start, end):
+    """Cheapest encoding of unmatched target[start:end]"""
+    if end <= start:
+        return b""
+    insert = bytes([OP_INSERT]) + varint(end - start) + target[start:end]
+    if src_hint is not None and src_hint + (end - start) <= len(source):
+        add = encode_add(source, src_hint, target, start, end)
+        if len(add) < len(insert):
+            return add
+    return insert
+
+
+def make_patch(source, target):
+    index = {}
+    for pos in range(0, len(source) - GRAM + 1, INDEX_STEP):
+        entry = index.setdefault(source[pos : pos + GRAM], [])
+        if len(entry) < MAX_CANDIDATES:
+            entry.append(pos)
+
+    out = bytearray(MAGIC + varint(len(target)) + varint(len(source)))
+    gap_start = 0
+    src_hint = 0  # Gap bytes likely line up after the previous copy
+    t = 0
+    while t + GRAM <= len(target):
+        candidates = index.get(target[t : t + GRAM])
+        best_len, best_src = 0, 0
+        for s in candidates or ():
+            length = match_forward(source, s, target, t, min(len(source) - s, len(target) - t))
+            if length > best_len:
+                best_len, best_src = length, s
+        if best_len == 0:
+            t += 1
+            continue
+
+        # Grow the match backwards into the gap
+        back = 0
+        while (
+            t - back > gap_start
+            and best_src - back > 0
+            and source[best_src - back - 1] == target[t - back - 1]
+        ):
+            back += 1
+        start, src = t - back, best_src - back
+        length = best_len + back
+        if length < MIN_COPY:
+            t += 1
+            continue
+
+        gap_hint = src_hint
+        if gap_start < start and src - (start - gap_start) >= 0:
+            gap_hint = src - (start - gap_start)  # Same shift as this match
+        out += encode_gap(source, gap_hint, target, gap_start, start)
+        out += bytes([OP_COPY]) + varint(src) + varint(length)
+        t = gap_start = start + length
+        src_hint = src + length
+
+    out += encode_gap(source, src_hint, target, gap_start, len(target))
+    out.append(OP_END)
+    return bytes(out)
+
+
+def apply_patch(source, patch):
+    """Reference decoder (verifies the patch before it is published)"""
+    pos = 0
+
+    def read_varint():
+        nonlocal pos
+        value, shift = 0, 0
+        while True:
+            byte = patch[pos]
+            pos += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    assert patch[:4] == MAGIC
+    pos = 4
+    target_size = read_varint()
+    assert read_varint() == len(source)
+    out = bytearray()
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        if op == OP_COPY:
+            src, length = read_varint(), read_varint()
+            out += source[src : src + length]
+        elif op == OP_ADD:
+            src, length = read_varint(), read_varint()
+            done = 0
+            while done < length:
+                zeros = read_varint()
+                out += source[src + done : src + done + zeros]
+                done += zeros
+                literals = read_varint()
+                for i in range(literals):
+                    out.append((source[src + done + i] + patch[pos + i]) & 0xFF)
+                pos += literals
+                done += literals
+        elif op == OP_INSERT:
+            length = read_varint()
+            out += patch[pos : pos + length]
+            pos += length
+        else:
+            raise ValueError(f"Unknown op {op}")
+    assert len(out) == target_size
+    return bytes(out)
+
+
+def build_delta(base_path, base_version, new_path, manifest_path=None):
+    print("=" * 60)
+    print("OTA Delta Patch Tool")
+    print("=" * 60)
+
+    for path in (base_path, new_path):
+        if not os.path.exists(path):
+            print(f"Error: Firmware file not found: {path}")
+            sys.exit(1)
+
+    with open(base_path, "rb") as f:
+        source = f.read()
+    with open(new_path, "rb") as f:
+        target = f.read()
+    print(f"\n[1/3] Base v{base_version}: {len(source):,} bytes")
+    print(f"       New image: {len(target):,} bytes")
+
+    print("[2/3] Building patch...")
+    patch = make_patch(source, target)
+    if apply_patch(source, patch) != target:
+        print("Error: Patch does not rebuild the new image")
+        sys.exit(1)
+    ratio = 100.0 * len(patch) / len(target)
+    print(f"       Patch: {len(patch):,} bytes ({ratio:.1f}% of full image)")
+    if ratio > 80:
+        print("       Warning: patch saves little, consider full image only")
+
+    base_name = os.path.splitext(os.path.basename(new_path))[0]
+    patch_name = f"{base_name}_from_v{base_version}.otd"
+    patch_path = os.path.join(os.path.dirname(new_path), patch_name)
+    with open(patch_path, "wb") as f:
+        f.write(patch)
+    print(f"[3/3] Saved: {patch_path}")
+
+    entry = {
+        "base_version": base_version,
+        "base_size": len(source),
+        "base_sha256": hashlib.sha256(source).hexdigest(),
+        "filename": patch_name,
+        "size": len(patch),
+    }
+
+    if manifest_path:
+        with open(manifest_path) as f:
+            manifest = json.load(f)
+        firmware = manifest.setdefault("firmware", {})
+        if firmware.get("sha256") and firmware["sha256"] != hashlib.sha256(target).hexdigest():
+            print("Error: manifest firmware.sha256 is not the new image")
+            sys.exit(1)
+        deltas = [d for d in firmware.get("delta", []) if d.get("base_version") != base_version]
+        deltas.append(entry)
+        firmware["delta"] = deltas
+        with open(manifest_path, "w") as f:
+            json.dump(manifest, f, indent=2)
+        print(f"       Manifest updated: {manifest_path}")
+
+    print("\nManifest firmware.delta entry:")
+    print(json.dumps(entry, indent=2))
+    print(f"\nUpload {patch_name} next to the full image (same release/folder).")
+    return entry, patch_path
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 4:
+        print(__doc__)
+        sys.exit(1)
+
+    build_delta(
+        sys.argv[1], sys.argv[2], sys.argv[3], sys.argv[4] if len(sys.argv) > 4 else None
+    )